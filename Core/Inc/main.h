@@ -87,6 +87,10 @@ void Error_Handler(void);
 #define E2A_GPIO_Port GPIOB
 #define E2B_Pin GPIO_PIN_5
 #define E2B_GPIO_Port GPIOB
+#define TRIG_Pin GPIO_PIN_6
+#define TRIG_GPIO_Port GPIOB
+#define ECHO_Pin GPIO_PIN_7
+#define ECHO_GPIO_Port GPIOB
 
 /* USER CODE BEGIN Private defines */
 
@@ -28,6 +28,13 @@
 /* USER CODE BEGIN Includes */
 #include "car.h"
 #include "communication.h"
+#include "flash_dev.h"
+#include "hcsr04.h"
+#include "i2c_bus.h"
+#include "param.h"
+#include "telemetry.h"
+#include "sensor_log.h"
+#include "micro_bench.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -37,6 +44,8 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+// 刹车保持这么多个控制周期后才擦除参数扇区 | Control periods the brake must hold before a parameter sector is erased
+#define PARAM_ERASE_BRAKE_TICKS 100
 
 /* USER CODE END PD */
 
@@ -48,7 +57,15 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-extern Car car;
+// 小车实例；控制模块本身不引用它 | The car instance; the control modules never refer to it
+Car car;
+extern ParamStore paramStore;
+
+// 控制周期到达标志，由 TIM9 中断置位 | Control period flag, set by the TIM9 interrupt
+static volatile bool_t controlTick = FALSE;
+
+// 连续刹车的控制周期数 | Consecutive control periods with the brake on
+static uint16_t brakeTicks = 0;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -98,8 +115,21 @@ int main(void)
   MX_TIM3_Init();
   MX_TIM9_Init();
   MX_I2C1_Init();
+  MX_TIM4_Init();
   /* USER CODE BEGIN 2 */
+  ParamStore_Init(&paramStore, newFlashDev());
+  I2C_Bus_Init();
   car = newCar();
+  Param_Load();
+  uart_Init();
+  HC_Init();
+#if MICRO_BENCH
+  while (car.imu.init_result == MPU6500_INIT_BUSY) {  // dmp_decode 用例需要 DMP | The dmp_decode case needs the DMP
+    car.imu.Get_Data(&car.imu);
+    HAL_Delay(10);
+  }
+  MicroBench_Target(31);
+#endif
   HAL_TIM_Base_Start_IT(&htim9);
 
   /* USER CODE END 2 */
@@ -111,11 +141,32 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-    car.motor_l.Move(&car.motor_l,0,50);
-    car.motor_r.Move(&car.motor_r,0,50);
-    car.imu.Get_Data(&car.imu);
-//    uart_printf(&huart2,"%d,%f,%f\n",car.encoder_l.rpm,car.motor_l.setRPM,car.motor_r.pid.out);
-    uart_printf(&huart2,"%f,%d\n",car.imu.roll,car.encoder_l.count);
+    Param_ApplyPending();
+    uint8_t cmd;
+    while (uart_PollCommand(&cmd)) {
+      car.cmd = cmd;
+      Motion_Dispatch(&car.control.motion, cmd);
+      SensorLog_Command(cmd);
+    }
+    if (controlTick) {
+      controlTick = FALSE;
+      car.imu.Get_Data(&car.imu);
+      car.CarMove(&car, 0);
+      HC_trig();
+      Telemetry_Publish();
+      SensorLog_Capture();
+      if (!car.control.brake) {
+        brakeTicks = 0;
+      } else if (brakeTicks < PARAM_ERASE_BRAKE_TICKS) {
+        brakeTicks++;
+      }
+    }
+    // 擦除扇区 1~2 s 取指停顿，控制环停转：只在刹车保持 1 s 后进行 | A sector erase stalls instruction fetch for 1-2 s and the control loop with it: only after the brake has held for 1 s
+    if (brakeTicks >= PARAM_ERASE_BRAKE_TICKS && ParamStore_ErasePending(&paramStore)) {
+      ParamStore_Maintain(&paramStore);
+    }
+    Telemetry_Flush();
+    SensorLog_Flush();
   }
   /* USER CODE END 3 */
 }
@@ -168,6 +219,16 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
+/**
+  * @brief  定时器周期回调：TIM9 给出控制周期 | Timer period callback: TIM9 paces the control loop
+  */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+  if (htim == &htim9)
+  {
+    controlTick = TRUE;
+  }
+}
 
 /* USER CODE END 4 */
 
@@ -0,0 +1,34 @@
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <stdio.h>
+
+/**
+  * @file    check.h
+  * @brief   主机自检程序的断言与退出码（仅头文件） | Assertions and exit code for the host self-checks (header-only)
+  *
+  * @note    每个自检程序只有一个源文件包含本头文件。CHECK 失败时打印原因并计数，不中止，其余检查照常运行；
+  *          Check_Exit 打印 OK 或 FAILED，任何失败都会使程序以非零状态退出，ctest 据此判定。
+  *          Each self-check program includes this header from a single source file. A failed
+  *          CHECK prints its reason and is counted without aborting, so the remaining checks
+  *          still run; Check_Exit prints OK or FAILED, and any failure makes the program exit
+  *          non-zero, which is what ctest goes by.
+  */
+
+static int failures = 0;     /**< 失败的检查数 | Failed checks */
+
+/**
+  * @brief   检查条件，失败时按 printf 格式打印原因 | Check a condition and print the printf-style reason when it fails
+  */
+#define CHECK(cond, ...) do { if (!(cond)) { failures++; printf("  FAIL: " __VA_ARGS__); printf("\n"); } } while (0)
+
+/**
+  * @brief   打印结果并给出退出码 | Print the verdict and give the exit code
+  * @return  0 全部通过，1 有失败 | 0 if everything passed, 1 on any failure
+  */
+static inline int Check_Exit(void) {
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
+
+#endif /* CHECK_H_ */
@@ -0,0 +1,214 @@
+#ifndef COLLOG_H_
+#define COLLOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    collog.h
+  * @brief   分块列式日志：只追加写入，mmap 零拷贝读取 | Chunked columnar log: append-only writes, zero-copy mmap reads
+  *
+  * @note    文件由自描述的头（流名称、记录长度、各通道的名称/类型/在记录中的偏移）和一串块组成。
+  *          每块最多 COLLOG_CHUNK_RECORDS 条记录，按通道分列存放：每个值与前一个值之差（浮点按位
+  *          模式相减）经 zigzag 后写成 varint，每块从 0 开始，可独立解码；块头记下各列的字节数，
+  *          读取一个通道只触及该通道的字节。块尾有 CRC32，写入端每块 fflush 一次，掉电只会损坏
+  *          最后一块：读取端在第一个不完整或校验失败的块处停下并报告，写入端重新打开时截掉它继续追加。
+  *          所有整数小端。
+  *          A file is a self-describing header (stream name, record size, and each channel's
+  *          name, type and offset in the record) followed by chunks. A chunk holds up to
+  *          COLLOG_CHUNK_RECORDS records stored column by column: each value minus the previous
+  *          one (floats subtract their bit patterns), zigzagged and written as a varint, starting
+  *          from 0 in every chunk so chunks decode independently. The chunk header lists the byte
+  *          length of each column, so reading one channel touches only that channel's bytes.
+  *          A CRC32 closes each chunk and the writer flushes once per chunk, so a power cut can
+  *          only damage the last chunk: the reader stops at the first incomplete or corrupt chunk
+  *          and reports it, and the writer cuts it off when reopening and keeps appending.
+  *          All integers are little-endian.
+  */
+
+#define COLLOG_MAGIC            "DNBC"  /**< 文件头魔数 | File magic */
+#define COLLOG_CHUNK_MAGIC      "CHNK"  /**< 块魔数 | Chunk magic */
+#define COLLOG_VERSION          1
+#define COLLOG_NAME_LEN         16      /**< 名称长度（含结尾 0） | Name length including the terminating 0 */
+#define COLLOG_MAX_CHANNELS     64
+#define COLLOG_CHUNK_RECORDS    4096    /**< 每块的记录数 | Records per chunk */
+
+/* 返回值 | Return codes */
+#define COLLOG_OK               0
+#define COLLOG_ERR_IO           -1      /**< 系统调用失败，errno 有效 | A system call failed, errno set */
+#define COLLOG_ERR_FORMAT       -2      /**< 不是列式日志或文件头损坏 | Not a columnar log, or a damaged header */
+#define COLLOG_ERR_SCHEMA       -3      /**< 追加时与已有文件的结构不同 | Schema differs from the existing file on append */
+#define COLLOG_ERR_CHANNEL      -4      /**< 通道不存在 | No such channel */
+
+/**
+  * @enum    ColLogType
+  * @brief   通道类型，均不超过 32 位 | Channel type, all 32 bits or less
+  */
+typedef enum {
+    COLLOG_U8 = 0,
+    COLLOG_I8,
+    COLLOG_U16,
+    COLLOG_I16,
+    COLLOG_U32,
+    COLLOG_I32,
+    COLLOG_F32,
+} ColLogType;
+
+/**
+  * @brief   C 类型对应的 ColLogType，可用于静态初始化 | ColLogType of a C type, usable in static initialisers
+  */
+#define COLLOG_TYPE_OF(type) _Generic((type)0,                          \
+        uint8_t: COLLOG_U8, int8_t: COLLOG_I8, uint16_t: COLLOG_U16,    \
+        int16_t: COLLOG_I16, uint32_t: COLLOG_U32, int32_t: COLLOG_I32, \
+        float: COLLOG_F32)
+
+/**
+  * @struct  ColLogChannel
+  * @brief   通道 | Channel
+  */
+typedef struct {
+    char name[COLLOG_NAME_LEN];     /**< 名称 | Name */
+    uint8_t type;                   /**< ColLogType */
+    uint16_t offset;                /**< 在记录中的字节偏移 | Byte offset in the record */
+} ColLogChannel;
+
+/**
+  * @struct  ColLogSchema
+  * @brief   日志结构：一种定长记录拆成的通道 | Log schema: the channels one fixed-size record splits into
+  */
+typedef struct {
+    char stream[COLLOG_NAME_LEN];   /**< 流名称，如 "sensor_log" | Stream name, e.g. "sensor_log" */
+    uint16_t recordSize;            /**< 记录长度 | Record size */
+    uint8_t count;                  /**< 通道数 | Channel count */
+    ColLogChannel channels[COLLOG_MAX_CHANNELS];
+} ColLogSchema;
+
+/**
+  * @struct  ColLogWriter
+  * @brief   写入端：按行收集一块，满块时转成列写出 | Writer: gathers a chunk row by row and writes it out as columns when full
+  */
+typedef struct {
+    FILE *file;
+    ColLogSchema schema;
+    uint8_t *rows;                  /**< 本块的记录 | This chunk's records */
+    uint8_t *column;                /**< 本块编码后的各列 | This chunk's encoded columns */
+    uint32_t pending;               /**< 本块已有的记录数 | Records in this chunk so far */
+    uint64_t records;               /**< 写出的记录总数（含已有的） | Records written, including existing ones */
+    uint64_t bytes;                 /**< 文件长度 | File length */
+} ColLogWriter;
+
+/**
+  * @struct  ColLogChunk
+  * @brief   块索引 | Chunk index entry
+  */
+typedef struct {
+    uint64_t offset;                        /**< 块在文件中的偏移 | File offset of the chunk */
+    uint64_t size;                          /**< 块的字节数（含 CRC） | Chunk size including the CRC */
+    uint64_t first;                         /**< 第一条记录的序号 | Index of the first record */
+    uint32_t records;                       /**< 记录数 | Record count */
+    uint64_t column[COLLOG_MAX_CHANNELS];   /**< 各列在文件中的偏移 | File offset of each column */
+    uint32_t length[COLLOG_MAX_CHANNELS];   /**< 各列的字节数 | Byte length of each column */
+} ColLogChunk;
+
+/**
+  * @struct  ColLogReader
+  * @brief   读取端：整个文件 mmap 进来，解码直接从映射读取 | Reader: the whole file is mmapped and decoding reads straight from the mapping
+  */
+typedef struct {
+    const uint8_t *map;             /**< 文件映射 | File mapping */
+    size_t size;                    /**< 文件长度 | File length */
+    ColLogSchema schema;
+    ColLogChunk *chunks;            /**< 完好的块 | Intact chunks */
+    uint32_t chunkCount;
+    uint64_t records;               /**< 完好的记录数 | Intact records */
+    size_t validBytes;              /**< 最后一个完好块的结尾 | End of the last intact chunk */
+} ColLogReader;
+
+/**
+  * @brief   打开日志准备追加；文件不存在或为空时新建 | Open a log for appending; create it when missing or empty
+  * @param   self    写入端 | Writer
+  * @param   path    文件 | File
+  * @param   schema  结构，已有文件必须与之相同 | Schema; an existing file must match it
+  * @return  COLLOG_OK 或 COLLOG_ERR_* | COLLOG_OK or COLLOG_ERR_*
+  * @note    已有文件末尾损坏的块会被截掉 | A damaged chunk at the end of an existing file is cut off
+  */
+int ColLogWriter_Open(ColLogWriter *self, const char *path, const ColLogSchema *schema);
+
+/**
+  * @brief   追加一条记录 | Append one record
+  * @param   self    写入端 | Writer
+  * @param   record  schema.recordSize 字节的记录 | Record of schema.recordSize bytes
+  * @return  COLLOG_OK 或 COLLOG_ERR_IO | COLLOG_OK or COLLOG_ERR_IO
+  */
+int ColLogWriter_Append(ColLogWriter *self, const void *record);
+
+/**
+  * @brief   把未满的块写出 | Write out the partial chunk
+  * @note    之后的记录进入新块；频繁调用会降低压缩率 | Later records start a new chunk; calling it often costs compression
+  */
+int ColLogWriter_Flush(ColLogWriter *self);
+
+/**
+  * @brief   写出剩余记录并关闭 | Write the remaining records and close
+  */
+int ColLogWriter_Close(ColLogWriter *self);
+
+/**
+  * @brief   映射日志并建立块索引 | Map a log and index its chunks
+  * @param   self  读取端 | Reader
+  * @param   path  文件 | File
+  * @return  COLLOG_OK、COLLOG_ERR_IO 或 COLLOG_ERR_FORMAT | COLLOG_OK, COLLOG_ERR_IO or COLLOG_ERR_FORMAT
+  * @note    末尾损坏的块不计入，validBytes < size 时说明有损坏 | Damaged trailing chunks are left out; validBytes < size reports them
+  */
+int ColLog_Open(ColLogReader *self, const char *path);
+
+/**
+  * @brief   校验所有块的 CRC | Check the CRC of every chunk
+  * @return  第一个损坏的块号，全部完好时为 chunkCount | Index of the first damaged chunk, chunkCount when all are intact
+  * @note    ColLog_Open 只校验最后一块（只追加的文件只有它可能写了一半），其余块的校验要读遍整个文件，
+  *          按需调用 | ColLog_Open checks only the last chunk (the only one an append-only file can
+  *          leave half-written); checking the rest reads the whole file, so it is on request
+  */
+uint32_t ColLog_Verify(const ColLogReader *self);
+
+/**
+  * @brief   按名称查找通道 | Find a channel by name
+  * @return  通道号，COLLOG_ERR_CHANNEL 表示不存在 | Channel index, or COLLOG_ERR_CHANNEL
+  */
+int ColLog_Find(const ColLogReader *self, const char *name);
+
+/**
+  * @brief   解码一个通道的全部记录 | Decode every record of one channel
+  * @param   self     读取端 | Reader
+  * @param   channel  通道号 | Channel index
+  * @param   out      输出，按通道类型的宽度写入 | Output, written at the channel type's width
+  * @param   stride   相邻两个值的字节间距：取类型宽度得到紧凑数组，取 recordSize 并指向记录数组中的
+  *                   字段则还原记录 | Byte distance between values: the type width gives a dense array;
+  *                   recordSize with out pointing at the field in a record array rebuilds records
+  * @return  COLLOG_OK 或 COLLOG_ERR_CHANNEL | COLLOG_OK or COLLOG_ERR_CHANNEL
+  */
+int ColLog_ReadColumn(const ColLogReader *self, uint8_t channel, void *out, size_t stride);
+
+/**
+  * @brief   解除映射并释放索引 | Unmap and free the index
+  */
+void ColLog_Close(ColLogReader *self);
+
+/**
+  * @brief   类型宽度 (字节) | Type width in bytes
+  */
+uint8_t ColLog_TypeSize(uint8_t type);
+
+/**
+  * @brief   类型名 "u8".."f32" | Type name "u8".."f32"
+  */
+const char *ColLog_TypeName(uint8_t type);
+
+/**
+  * @brief   把一个该类型的值转成 double | Convert one value of the type to double
+  */
+double ColLog_ToDouble(uint8_t type, const void *value);
+
+#endif /* COLLOG_H_ */
@@ -0,0 +1,117 @@
+#ifndef DC_MOTOR_H_
+#define DC_MOTOR_H_
+
+#include <stdint.h>
+
+/**
+  * @file    dc_motor.h
+  * @brief   高保真直流减速电机模型：TB6612 H 桥、电枢电路、减速箱间隙与摩擦 | High-fidelity DC gear motor: TB6612 H-bridge, armature circuit, gearbox backlash and friction
+  *
+  * @note    H 桥按 Move() 的接法驱动：TIM1 CH1/CH2（PWM1 模式、边沿对齐、同一计数器）分别接
+  *          IN1/IN2。每个 PWM 周期开头两路都为高，先是 min(d1, d2) 的短路制动，然后 |d1 − d2|
+  *          的驱动，剩下的时间两路都为低，TB6612 输出关断（滑行）：电流经体二极管回流到电源，
+  *          端电压被钳在 ∓(V + 2·V_D)，降到零后开路。所以 Move() 的刹车 (ARR, ARR) 是整周期短路
+  *          制动，PID 输出为 0 的 (0, 0) 是滑行，PWM 关断段也是滑行而不是制动。
+  *          电枢电路 L·di/dt = V − R·i − k_e·ω_m 在每段端电压恒定的区间内按指数解析求解，
+  *          区间按真实 PWM 时间线切分，低占空比下的断续电流自然出现。转子惯量、减速箱间隙
+  *          （带刚度和阻尼的死区）、库仑与粘滞摩擦在转子侧，转子与轮子之间只通过齿轮传力。
+  *          编码器装在电机轴上（间隙之前），由 plant.c 按 TIM2/TIM3 的 x4 模式量化。
+  *          除 kt 与 rotorInertia 在电机轴侧外，角度、速度、力矩都折算到轮轴侧。
+  *          The bridge is driven as Move() wires it: TIM1 CH1/CH2 (PWM mode 1, edge-aligned, one
+  *          counter) feed IN1/IN2. Each PWM period starts with both high, so it is min(d1, d2) of
+  *          short brake, then |d1 − d2| of drive, and for the rest both are low and the TB6612
+  *          outputs are off (coast): the current flows back into the supply through the body
+  *          diodes with the terminal clamped at ∓(V + 2·V_D), and the winding is open once it
+  *          reaches zero. Move()'s brake (ARR, ARR) is therefore a whole-period short brake, a
+  *          zero PID output (0, 0) coasts, and the PWM off-time coasts rather than brakes.
+  *          The armature L·di/dt = V − R·i − k_e·ω_m is solved exactly (exponentials) over
+  *          intervals of constant terminal voltage, cut along the real PWM timeline, so
+  *          discontinuous current at low duty comes out by itself. Rotor inertia, gearbox backlash
+  *          (a dead zone with stiffness and damping) and Coulomb plus viscous friction sit on the
+  *          rotor side; rotor and wheel interact only through the gear torque. The encoder is on
+  *          the motor shaft (before the backlash) and is quantised by plant.c in the TIM2/TIM3 x4
+  *          mode. Angles, speeds and torques are referred to the wheel axle, except kt and
+  *          rotorInertia, which are at the motor shaft.
+  */
+
+/**
+  * @struct  HBridge
+  * @brief   一路 H 桥的输入 | Inputs of one H-bridge
+  */
+typedef struct {
+    double in1;             /**< IN1 占空比 0..1（CCR1/ARR） | IN1 duty 0..1 (CCR1/ARR) */
+    double in2;             /**< IN2 占空比 0..1（CCR2/ARR） | IN2 duty 0..1 (CCR2/ARR) */
+} HBridge;
+
+/**
+  * @struct  DcMotorParams
+  * @brief   电机、驱动与减速箱参数 | Motor, driver and gearbox parameters
+  */
+typedef struct {
+    const char *name;       /**< 预设名 | Preset name */
+    double supply;          /**< 电源电压 (V) | Supply voltage */
+    double resistance;      /**< 电枢电阻，含两只导通的 MOSFET (Ω) | Armature resistance including two conducting MOSFETs */
+    double inductance;      /**< 电枢电感 (H) | Armature inductance */
+    double kt;              /**< 力矩常数 = 反电势常数，电机轴 (N·m/A) | Torque constant = back-EMF constant, motor shaft */
+    double gearRatio;       /**< 减速比 | Gear ratio */
+    double rotorInertia;    /**< 转子惯量，电机轴 (kg·m²) | Rotor inertia, motor shaft */
+    double coulomb;         /**< 库仑摩擦 (N·m) | Coulomb friction */
+    double viscous;         /**< 粘滞摩擦 (N·m·s/rad) | Viscous friction */
+    double backlash;        /**< 齿隙全宽 (rad) | Full backlash width */
+    double gearStiffness;   /**< 齿轮啮合刚度 (N·m/rad) | Gear mesh stiffness */
+    double gearDamping;     /**< 齿轮啮合阻尼 (N·m·s/rad) | Gear mesh damping */
+    double diodeDrop;       /**< 体二极管压降 (V) | Body diode drop */
+    double pwmHz;           /**< PWM 频率 (Hz) | PWM frequency */
+    double quadratureError; /**< B 相边沿偏移，占一个计数的比例 0..0.5 | B-phase edge offset as a fraction of one count */
+} DcMotorParams;
+
+/**
+  * @struct  DcMotor
+  * @brief   电机状态 | Motor state
+  */
+typedef struct {
+    DcMotorParams p;
+    double current;         /**< 电枢电流 (A) | Armature current */
+    double rotor;           /**< 转子相对车身的角度 (rad) | Rotor angle relative to the body */
+    double rotorSpeed;      /**< 转子角速度 (rad/s) | Rotor speed */
+    double pwmPhase;        /**< 当前 PWM 周期内的位置 0..1 | Position within the current PWM period */
+    double torque;          /**< 上一步传到轮子的平均力矩 (N·m) | Mean torque delivered to the wheel over the last step */
+    double energy;          /**< 从电源取出的能量，回馈为负 (J) | Energy drawn from the supply, regeneration negative */
+} DcMotor;
+
+/**
+  * @brief   按名称查找预设 | Look up a preset by name
+  * @param   name  预设名 | Preset name
+  * @return  参数，找不到返回 NULL | Parameters, NULL if not found
+  */
+const DcMotorParams *DcMotor_Preset(const char *name);
+
+/**
+  * @brief   按序号取预设，用于列出全部 | Get a preset by index, for listing them all
+  * @param   index  序号 | Index
+  * @return  参数，越界返回 NULL | Parameters, NULL past the end
+  */
+const DcMotorParams *DcMotor_PresetAt(int index);
+
+/**
+  * @brief   初始化：静止、无电流，转子在齿隙中间 | Init at rest with no current, rotor centred in the backlash
+  * @param   self  电机指针 | Pointer to motor
+  * @param   p     参数 | Parameters
+  * @param   wheel 轮子相对车身的角度 (rad) | Wheel angle relative to the body
+  */
+void DcMotor_Init(DcMotor *self, const DcMotorParams *p, double wheel);
+
+/**
+  * @brief   推进 h 秒，返回这段时间传到轮子的平均力矩 | Advance h seconds and return the mean torque delivered to the wheel
+  * @note    h 内轮子按 wheelSpeed 匀速转动；内部按 PWM 段和 50 µs 上限切分
+  *          The wheel turns at wheelSpeed throughout h; internally cut at PWM edges and at most 50 µs
+  * @param   self        电机指针 | Pointer to motor
+  * @param   cmd         H 桥输入 | Bridge inputs
+  * @param   wheel       轮子相对车身的角度 (rad) | Wheel angle relative to the body
+  * @param   wheelSpeed  轮子相对车身的角速度 (rad/s) | Wheel speed relative to the body
+  * @param   h           时长 (s) | Duration
+  * @return  平均轮端力矩 (N·m) | Mean wheel torque
+  */
+double DcMotor_Step(DcMotor *self, HBridge cmd, double wheel, double wheelSpeed, double h);
+
+#endif /* DC_MOTOR_H_ */
@@ -0,0 +1,29 @@
+#ifndef I2C_BUS_H_HOST_
+#define I2C_BUS_H_HOST_
+
+/**
+  * @file    i2c_bus.h
+  * @brief   主机端替身：MPU 驱动的总线与时钟接到寄存器级模拟器 | Host stand-in: the MPU driver's bus and clock go to the register-level emulator
+  *
+  * @note    固件中的 i2c_bus.h 引入 HAL 与仲裁器；主机构建 inv_mpu*.c 与 MPU6500.c 时用此文件代替，
+  *          函数由 mpu6500_emu.c 实现
+  *          The firmware i2c_bus.h pulls in the HAL and the arbiter; host builds of inv_mpu*.c
+  *          and MPU6500.c use this instead, implemented by mpu6500_emu.c
+  */
+#include <stdint.h>
+#include "i2c_arbiter.h"
+#include "mpu6500_emu.h"
+
+int I2C_Bus_Write(uint8_t addr, uint8_t reg, uint16_t len, uint8_t *data);
+
+int I2C_Bus_Read(uint8_t addr, uint8_t reg, uint16_t len, uint8_t *data);
+
+uint32_t I2C_Bus_Errors(uint8_t client);
+
+void HAL_Delay(uint32_t ms);
+
+uint32_t HAL_GetTick(void);
+
+#define __NOP()     ((void)0)
+
+#endif /* I2C_BUS_H_HOST_ */
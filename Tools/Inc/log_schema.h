@@ -0,0 +1,18 @@
+#ifndef LOG_SCHEMA_H_
+#define LOG_SCHEMA_H_
+
+#include "collog.h"
+
+/**
+  * @file    log_schema.h
+  * @brief   固件记录的列式日志结构 | Columnar log schemas of the firmware records
+  *
+  * @note    通道偏移取自固件头文件中的结构体，记录追加字段时这里跟着追加通道
+  *          Channel offsets come from the structs in the firmware headers; when a record gains a
+  *          field, append a channel here too
+  */
+
+extern const ColLogSchema telemetryLogSchema;   /**< TelemetryRecord，流 "telemetry" | TelemetryRecord, stream "telemetry" */
+extern const ColLogSchema sensorLogSchema;      /**< SensorLogRecord，流 "sensor_log" | SensorLogRecord, stream "sensor_log" */
+
+#endif /* LOG_SCHEMA_H_ */
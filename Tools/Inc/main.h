@@ -0,0 +1,28 @@
+#ifndef MAIN_H_HOST_
+#define MAIN_H_HOST_
+
+/**
+  * @file    main.h
+  * @brief   主机端替身：可移植的控制器模块只需要标准头 | Host stand-in: the portable controller modules only need standard headers
+  *
+  * @note    固件中的 main.h 由 CubeMX 生成并引入 HAL；主机构建用此文件代替
+  *          The firmware main.h is generated by CubeMX and pulls in the HAL; host builds use this instead
+  */
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+/* CubeMX 在 main.h 中给出的引脚名；主机上没有 GPIO，只需能编译 | Pin names CubeMX puts in main.h; there is no GPIO on the host, they only need to compile */
+typedef struct {
+    uint32_t ODR;
+} GPIO_TypeDef;
+
+#define AIN1_Pin        0x0100U
+#define AIN1_GPIO_Port  ((GPIO_TypeDef *)NULL)
+#define AIN2_Pin        0x0200U
+#define AIN2_GPIO_Port  ((GPIO_TypeDef *)NULL)
+
+/* 由链接进来的时钟实现（如 mpu6500_emu.c） | Implemented by whichever clock is linked in (e.g. mpu6500_emu.c) */
+uint32_t HAL_GetTick(void);
+
+#endif /* MAIN_H_HOST_ */
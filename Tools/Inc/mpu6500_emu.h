@@ -0,0 +1,138 @@
+#ifndef MPU6500_EMU_H_
+#define MPU6500_EMU_H_
+
+/**
+  * @file    mpu6500_emu.h
+  * @brief   MPU6500 寄存器级模拟器 | Register-level MPU6500 emulator
+  *
+  * @note    模拟 I2C 看到的芯片：寄存器文件（突发访问自动递增）、经 BANK_SEL/MEM_START_ADDR/MEM_R_W 访问的
+  *          DMP 存储器、程序起始地址、器件复位、FIFO 计数与溢出（满时覆盖最旧数据并置 INT_STATUS 溢出位），
+  *          以及 DMP 开启后按 D_0_22 分频写入 FIFO 的数据包。包的组成取自驱动写进 DMP 存储器的特性配置，
+  *          内容来自脚本化的运动轨迹（分段恒定的机体角速度）。
+  *          时间为虚拟时钟：每次传输按总线速率计入线上时间，HAL_Delay 直接推进时钟。
+  *          Models the chip as seen over I2C: the register file (bursts auto-increment), DMP
+  *          memory through BANK_SEL/MEM_START_ADDR/MEM_R_W, the program start address, device
+  *          reset, the FIFO count and overflow (a full FIFO overwrites its oldest bytes and sets
+  *          the INT_STATUS overflow bit), and DMP packets pushed into the FIFO at the D_0_22
+  *          divider once the DMP runs. The packet layout follows the feature configuration the
+  *          driver wrote into DMP memory; the contents come from a scripted motion trajectory
+  *          (piecewise-constant body rates). Time is a virtual clock: each transfer adds its
+  *          wire time at the bus rate and HAL_Delay advances the clock directly.
+  */
+#include <stdint.h>
+
+#define MPU6500_EMU_ADDR        0x68    /**< 7 位从机地址 | 7-bit slave address */
+#define MPU6500_EMU_REGS        128     /**< 寄存器数 | Register count */
+#define MPU6500_EMU_MEM         4096    /**< DMP 存储器字节数 | DMP memory bytes */
+#define MPU6500_EMU_FIFO        1024    /**< FIFO 字节数 | FIFO bytes */
+#define MPU6500_EMU_DMP_HZ      200     /**< DMP 内部采样率 | DMP internal sample rate */
+#define MPU6500_EMU_PACKET_MAX  32      /**< 最长 DMP 数据包 | Longest DMP packet */
+#define MPU6500_EMU_SCRIPT      16      /**< 轨迹最多段数 | Most trajectory segments */
+
+/**
+  * @struct  Mpu6500EmuSegment
+  * @brief   轨迹的一段：机体角速度恒定 | One trajectory segment at constant body rates
+  */
+typedef struct {
+    uint32_t ms;                /**< 持续时间 | Duration */
+    float rate[3];              /**< 绕 x/y/z 的角速度 (°/s)：横滚、俯仰、偏航 | Rates about x/y/z: roll, pitch, yaw */
+} Mpu6500EmuSegment;
+
+typedef struct Mpu6500Emu Mpu6500Emu;
+
+/**
+  * @struct  Mpu6500Emu
+  * @brief   模拟器状态（纯数据，可放在共享内存里跨 fork 保留） | Emulator state (plain data, may live in shared memory across fork)
+  */
+struct Mpu6500Emu {
+    uint64_t now;                           /**< 虚拟时间 (ns) | Virtual time (ns) */
+    uint32_t busHz;                         /**< I2C 速率 | I2C rate */
+
+    uint8_t reg[MPU6500_EMU_REGS];          /**< 寄存器文件 | Register file */
+    uint8_t mem[MPU6500_EMU_MEM];           /**< DMP 存储器 | DMP memory */
+    uint8_t fifo[MPU6500_EMU_FIFO];         /**< FIFO 环形缓冲 | FIFO ring */
+    uint16_t fifoHead;                      /**< 最旧字节位置 | Oldest byte */
+    uint16_t fifoCount;                     /**< FIFO 字节数 | Bytes in the FIFO */
+    uint64_t nextPacket;                    /**< 下一包时间 (ns) | Time of the next packet (ns) */
+
+    Mpu6500EmuSegment script[MPU6500_EMU_SCRIPT];   /**< 运动轨迹，走完后保持静止 | Motion script, at rest once it ends */
+    uint8_t scriptLen;                      /**< 段数 | Segment count */
+    uint8_t segment;                        /**< 当前段 | Current segment */
+    uint64_t segmentStart;                  /**< 当前段开始 (ns) | Current segment start (ns) */
+    uint64_t motionNow;                     /**< 姿态已积分到的时刻 (ns) | Time the attitude is integrated to (ns) */
+    double q[4];                            /**< 机体姿态四元数 w, x, y, z | Body attitude quaternion w, x, y, z */
+    uint8_t external;                       /**< 1 = 数据包只来自 Mpu6500Emu_Inject，不按轨迹生成 | 1 = packets come only from Mpu6500Emu_Inject, none from the script */
+
+    uint32_t failAt;                        /**< 从第几次传输开始无应答（0 = 不注入） | Transfer number that starts NACKing (0 = off) */
+    uint32_t failCount;                     /**< 连续无应答次数 | Consecutive NACKs to inject */
+    uint32_t nacks;                         /**< 已注入的无应答 | NACKs injected */
+
+    uint32_t resets;                        /**< 器件复位次数 | Device resets */
+    uint32_t packets;                       /**< 写入的数据包 | Packets pushed */
+    uint32_t overflows;                     /**< FIFO 溢出次数 | FIFO overflows */
+    uint32_t transfers;                     /**< I2C 传输次数 | I2C transfers */
+    uint32_t memWritten;                    /**< 写入 DMP 存储器的字节 | Bytes written to DMP memory */
+};
+
+/**
+  * @brief   上电：寄存器恢复默认，DMP 存储器与 FIFO 清空，姿态水平 | Power on: registers to defaults, DMP memory and FIFO cleared, attitude level
+  * @param   emu    模拟器 | Emulator
+  * @param   busHz  I2C 速率 | I2C rate
+  */
+void Mpu6500Emu_PowerOn(Mpu6500Emu *emu, uint32_t busHz);
+
+/**
+  * @brief   从当前时刻开始执行运动轨迹 | Start a motion script at the current time
+  * @param   emu       模拟器 | Emulator
+  * @param   segments  各段 | Segments
+  * @param   n         段数（最多 MPU6500_EMU_SCRIPT） | Segment count (at most MPU6500_EMU_SCRIPT)
+  */
+void Mpu6500Emu_Script(Mpu6500Emu *emu, const Mpu6500EmuSegment *segments, uint8_t n);
+
+/**
+  * @brief   推进虚拟时间，按时写入 DMP 数据包 | Advance virtual time, pushing DMP packets when due
+  */
+void Mpu6500Emu_Advance(Mpu6500Emu *emu, uint64_t ns);
+
+/**
+  * @brief   当前姿态的欧拉角（与 MPU6500_DMP_Get_Data 的公式相同） | Euler angles of the current attitude (same formulas as MPU6500_DMP_Get_Data)
+  * @param   emu  模拟器 | Emulator
+  * @param   rpy  横滚、俯仰、偏航 (°) | Roll, pitch, yaw
+  */
+void Mpu6500Emu_Euler(const Mpu6500Emu *emu, float rpy[3]);
+
+/**
+  * @brief   当前配置下一个 DMP 数据包的长度 | Length of one DMP packet under the current configuration
+  */
+uint8_t Mpu6500Emu_PacketLength(const Mpu6500Emu *emu);
+
+/**
+  * @brief   把一个外部数据包写入 FIFO，用于重放记录的数据 | Push an external packet into the FIFO, for replaying recorded data
+  * @note    与生成的包一样受 FIFO 容量和溢出规则约束；通常配合 external = 1 使用
+  *          Subject to the same FIFO capacity and overflow rules as generated packets; usually used with external = 1
+  * @param   emu     模拟器 | Emulator
+  * @param   packet  数据包，长度应为 Mpu6500Emu_PacketLength | Packet, normally Mpu6500Emu_PacketLength bytes
+  * @param   len     长度 | Length
+  * @return  0，DMP 未运行时 -1 | 0, or -1 while the DMP is not running
+  */
+int Mpu6500Emu_Inject(Mpu6500Emu *emu, const uint8_t *packet, uint8_t len);
+
+/**
+  * @brief   寄存器写传输 | Register write transfer
+  * @return  0，或注入无应答时 -1 | 0, or -1 when a NACK is injected
+  */
+int Mpu6500Emu_Write(Mpu6500Emu *emu, uint8_t reg, uint16_t len, const uint8_t *data);
+
+/**
+  * @brief   寄存器读传输 | Register read transfer
+  * @return  0，或注入无应答时 -1 | 0, or -1 when a NACK is injected
+  */
+int Mpu6500Emu_Read(Mpu6500Emu *emu, uint8_t reg, uint16_t len, uint8_t *data);
+
+/**
+  * @brief   挂在主机端 I2C_Bus_* / HAL_Delay / HAL_GetTick 上的芯片 | The chip behind the host I2C_Bus_*, HAL_Delay and HAL_GetTick
+  * @note    I2C_Bus_Errors 返回注入的无应答次数 | I2C_Bus_Errors returns the injected NACK count
+  */
+extern Mpu6500Emu *mpuEmu;
+
+#endif /* MPU6500_EMU_H_ */
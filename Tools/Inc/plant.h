@@ -0,0 +1,130 @@
+#ifndef PLANT_H_
+#define PLANT_H_
+
+#include <stdint.h>
+#include "dc_motor.h"
+
+/**
+  * @file    plant.h
+  * @brief   两轮自平衡小车的主机端仿真模型 | Host-side simulation model of the two-wheeled balancing car
+  *
+  * @note    非线性轮式倒立摆（车身倾角 + 前进）加偏航，每个轮子由一个简化直流减速电机驱动：
+  *          τ = τ_stall·(u − ω/ω_0)。传感器输出与固件一致：倾角/角速度为 °、°/s，编码器为量化后的计数。
+  *          Nonlinear wheeled inverted pendulum (body tilt + forward travel) plus yaw; each wheel is
+  *          driven by a simplified DC gear motor τ = τ_stall·(u − ω/ω_0). Sensor outputs match the
+  *          firmware: pitch/rates in degrees and deg/s, encoders as quantized counts.
+  *          PlantParams.motor 非空时换成 dc_motor.h 的高保真电机：H 桥的刹车与滑行、电枢电路、
+  *          齿隙和摩擦，编码器装在电机轴上并按 x4 模式量化。
+  *          With PlantParams.motor set, the wheels use the high-fidelity motor of dc_motor.h
+  *          instead: bridge brake vs coast, armature circuit, backlash and friction, with the
+  *          encoder on the motor shaft and quantized in x4 mode.
+  *          倾角以重力为基准；坡度、质心前移和外力为 0 时方程与平地模型逐项相同。
+  *          Pitch is measured from gravity; with zero slope, COM offset and push the equations are
+  *          term for term those of the level-ground model.
+  */
+
+/**
+  * @struct  PlantParams
+  * @brief   物理参数（国际单位） | Physical parameters (SI)
+  */
+typedef struct {
+    double bodyMass;        /**< 车身质量 (kg) | Body mass */
+    double comHeight;       /**< 质心到轮轴距离 (m) | Axle to centre of mass */
+    double bodyInertia;     /**< 车身绕质心的俯仰惯量 (kg·m²) | Body pitch inertia about the COM */
+    double yawInertia;      /**< 车身偏航惯量 (kg·m²) | Body yaw inertia */
+    double wheelMass;       /**< 单轮质量 (kg) | Mass of one wheel */
+    double wheelRadius;     /**< 轮半径 (m) | Wheel radius */
+    double track;           /**< 轮距 (m) | Track width */
+    double stallTorque;     /**< 轮端堵转力矩 (N·m) | Stall torque at the wheel */
+    double noLoadSpeed;     /**< 轮端空载转速 (rad/s) | No-load speed at the wheel */
+    double encoderCpr;      /**< 编码器每转计数 | Encoder counts per wheel revolution */
+    double pitchNoise;      /**< 倾角噪声标准差 (°) | Pitch noise std-dev */
+    double gyroNoise;       /**< 角速度噪声标准差 (°/s) | Gyro noise std-dev */
+    double yawRateBias;     /**< gyroz 零偏 (°/s) | gyroz bias */
+    double dmpYawDrift;     /**< DMP 航向漂移 (°/s) | DMP yaw drift */
+    double encoderScaleR;   /**< 右编码器比例误差（轮径公差），0.01 = 少计 1% | Right encoder scale error (wheel tolerance), 0.01 = 1% under-count */
+    double slope;           /**< 地面坡度，前方上坡为正 (rad) | Ground slope, uphill ahead positive */
+    double comOffset;       /**< 质心相对车身轴线前移 (m)，如偏放的负载 | Centre of mass forward of the body axis, e.g. an off-centre payload */
+    const DcMotorParams *motor; /**< 高保真电机，NULL 为线性模型 | High-fidelity motor, NULL for the linear model */
+} PlantParams;
+
+/**
+  * @struct  Plant
+  * @brief   仿真状态 | Simulation state
+  */
+typedef struct {
+    PlantParams p;
+
+    double x, xd;           /**< 轮轴位置和速度 (m, m/s) | Axle position and velocity */
+    double theta, thetad;   /**< 倾角，前倾为正 (rad, rad/s) | Pitch, forward positive */
+    double psi, psid;       /**< 偏航角，左转为正 (rad, rad/s) | Yaw, left positive */
+    double px, py;          /**< 平面位置 (m) | Planar position */
+    double time;            /**< 仿真时间 (s) | Simulated time */
+    double push;            /**< 沿坡面向前作用在质心上的外力 (N)，由调用者设置 | External force on the COM, forward along the ground, set by the caller */
+    double wheel[2];        /**< 左右轮相对车身转角 (rad) | Left/right wheel angle relative to the body */
+    int32_t count[2];       /**< 上次读取的编码器计数 | Encoder counts at the last read */
+    double duty[2];         /**< 当前占空比 −1..1 | Current duty −1..1 */
+    uint32_t rng;           /**< 噪声随机数状态 | Noise RNG state */
+    DcMotor motor[2];       /**< 左右高保真电机，仅 p.motor 非空时使用 | Left/right high-fidelity motors, used only when p.motor is set */
+} Plant;
+
+/**
+  * @brief   默认参数（与实车量级一致） | Default parameters (same order of magnitude as the real car)
+  * @return  参数 | Parameters
+  */
+PlantParams Plant_DefaultParams(void);
+
+/**
+  * @brief   初始化仿真 | Init simulation
+  * @param   self   仿真指针 | Pointer to simulation
+  * @param   p      参数 | Parameters
+  * @param   theta  初始倾角 (rad) | Initial pitch
+  * @param   seed   噪声种子 | Noise seed
+  */
+void Plant_Init(Plant *self, const PlantParams *p, double theta, uint32_t seed);
+
+/**
+  * @brief   以恒定的 H 桥输入推进（Move() 的 IN1/IN2 占空比） | Advance with constant bridge inputs (Move()'s IN1/IN2 duties)
+  * @note    线性模型把它当作占空比 in1 − in2，短路制动与滑行没有区别
+  *          The linear model takes it as duty in1 − in2, with no difference between short brake and coast
+  * @param   self   仿真指针 | Pointer to simulation
+  * @param   cmd    左右 H 桥输入 | Left/right bridge inputs
+  * @param   dt     时长 (s) | Duration
+  */
+void Plant_Drive(Plant *self, const HBridge cmd[2], double dt);
+
+/**
+  * @brief   以恒定占空比推进；高保真电机按 Move() 的接法换成 H 桥输入（正：IN1，负：IN2，零：滑行）
+  *          Advance with constant duty; the high-fidelity motor gets bridge inputs as Move() sets them (positive: IN1, negative: IN2, zero: coast)
+  * @param   self   仿真指针 | Pointer to simulation
+  * @param   dutyL  左轮占空比 −1..1 | Left duty
+  * @param   dutyR  右轮占空比 −1..1 | Right duty
+  * @param   dt     时长 (s) | Duration
+  */
+void Plant_Step(Plant *self, double dutyL, double dutyR, double dt);
+
+/**
+  * @brief   读取 IMU（°、°/s） | Read the IMU (degrees, deg/s)
+  * @param   self       仿真指针 | Pointer to simulation
+  * @param   pitch      倾角 | Pitch
+  * @param   pitchRate  倾角速度 | Pitch rate
+  * @param   yawRate    偏航角速度 | Yaw rate
+  */
+void Plant_ReadImu(Plant *self, float *pitch, float *pitchRate, float *yawRate);
+
+/**
+  * @brief   读取 DMP 航向（°，±180，带漂移） | Read the DMP yaw (degrees, ±180, with drift)
+  * @param   self  仿真指针 | Pointer to simulation
+  * @return  航向 | Yaw
+  */
+float Plant_ReadYaw(Plant *self);
+
+/**
+  * @brief   读取编码器自上次读取以来的增量（与固件读后清零一致） | Read encoder deltas since the last read (matches the firmware read-and-clear)
+  * @param   self  仿真指针 | Pointer to simulation
+  * @param   left  左轮计数 | Left counts
+  * @param   right 右轮计数 | Right counts
+  */
+void Plant_ReadEncoders(Plant *self, int16_t *left, int16_t *right);
+
+#endif /* PLANT_H_ */
@@ -0,0 +1,118 @@
+#ifndef PLANT_BATCH_H_
+#define PLANT_BATCH_H_
+
+#include <stdint.h>
+#include "plant.h"
+
+/**
+  * @file    plant_batch.h
+  * @brief   批量模型：N 台小车的状态按结构数组存放，一次推进全部 | Batched plant: the state of N cars stored as structure-of-arrays and stepped together
+  *
+  * @note    每个量一个数组，同一个积分子步对所有车做同样的运算，最内层循环沿车的编号走，
+  *          编译器可以把它向量化（SSE2 每次 2 台，AVX2 4 台，AVX-512 8 台）。车按
+  *          PLANT_BATCH_BLOCK 台一组推进完整个周期再换下一组，一组的状态留在 L1 里。
+  *          运算与 plant.c 一一对应、次序相同，sin/cos 与噪声来自 plant_math.h，所以每台车的
+  *          结果与标量 Plant_Step 逐位相同。
+  *          One array per quantity; every integration substep does the same arithmetic for all
+  *          cars and the innermost loop runs over the car index, so the compiler can vectorise
+  *          it (2 cars per instruction with SSE2, 4 with AVX2, 8 with AVX-512). Cars are stepped
+  *          through a whole period PLANT_BATCH_BLOCK at a time, so a block's state stays in L1.
+  *          The arithmetic matches plant.c operation for operation and in the same order, and
+  *          sin/cos and the noise come from plant_math.h, so every car's result is bit-identical
+  *          to the scalar Plant_Step.
+  *          只支持线性电机模型：PlantParams.motor 必须为 NULL。
+  *          Only the linear motor model is supported: PlantParams.motor must be NULL.
+  *          坡度、质心前移和外力不在批量模型中，按平地、无外力计算。
+  *          Slope, COM offset and push are not in the batched plant; it runs level ground with no push.
+  */
+
+#define PLANT_BATCH_BLOCK   64      /**< 每组车数 | Cars per block */
+
+/**
+  * @struct  PlantBatch
+  * @brief   N 台车的模型 | Plant of N cars
+  */
+typedef struct {
+    uint32_t n;                     /**< 车数 | Car count */
+    uint32_t stride;                /**< 数组长度（n 向上取整到 8） | Array length (n rounded up to 8) */
+    void *mem;                      /**< 所有数组所在的内存块 | Block holding all arrays */
+
+    /* 参数 | Parameters */
+    double *bodyMass, *comHeight, *bodyInertia, *wheelRadius;
+    double *half;                   /**< 半轮距 (m) | Half track */
+    double *mw;                     /**< 轮子等效平动质量 (kg) | Wheels' equivalent mass */
+    double *iz;                     /**< 偏航总惯量 (kg·m²) | Total yaw inertia */
+    double *stallTorque, *noLoadSpeed;
+    double *encoderCpr, *encoderScaleR;
+    double *pitchNoise, *gyroNoise, *yawRateBias, *dmpYawDrift;
+
+    /* 状态，含义同 Plant | State, as in Plant */
+    double *x, *xd, *theta, *thetad, *psi, *psid, *px, *py, *time;
+    double *wheel[2];
+    int32_t *count[2];
+    uint32_t *rng;
+    double *duty[2];                /**< 由调用者在 PlantBatch_Step 前写入 | Written by the caller before PlantBatch_Step */
+} PlantBatch;
+
+/**
+  * @brief   分配 n 台车的数组，状态清零 | Allocate the arrays for n cars, state zeroed
+  * @param   self  批量模型指针 | Pointer to batch
+  * @param   n     车数 | Car count
+  * @return  0 成功，-1 内存不足 | 0 on success, -1 when out of memory
+  */
+int PlantBatch_Init(PlantBatch *self, uint32_t n);
+
+/**
+  * @brief   释放数组 | Free the arrays
+  * @param   self  批量模型指针 | Pointer to batch
+  */
+void PlantBatch_Free(PlantBatch *self);
+
+/**
+  * @brief   用一个标量模型的参数和状态设置第 i 台 | Set car i from the parameters and state of a scalar plant
+  * @param   self  批量模型指针 | Pointer to batch
+  * @param   i     车号 | Car index
+  * @param   p     标量模型 | Scalar plant
+  */
+void PlantBatch_Set(PlantBatch *self, uint32_t i, const Plant *p);
+
+/**
+  * @brief   把第 i 台的状态写回标量模型（参数不变） | Write car i's state back into a scalar plant (parameters untouched)
+  * @param   self  批量模型指针 | Pointer to batch
+  * @param   i     车号 | Car index
+  * @param   p     标量模型 | Scalar plant
+  */
+void PlantBatch_Get(const PlantBatch *self, uint32_t i, Plant *p);
+
+/**
+  * @brief   以 duty 数组中的占空比推进全部车 | Advance every car with the duty in the duty arrays
+  * @param   self  批量模型指针 | Pointer to batch
+  * @param   dt    时长 (s) | Duration
+  */
+void PlantBatch_Step(PlantBatch *self, double dt);
+
+/**
+  * @brief   读取全部车的 IMU，同 Plant_ReadImu | Read every car's IMU, as Plant_ReadImu
+  * @param   self       批量模型指针 | Pointer to batch
+  * @param   pitch      n 个倾角 | n pitches
+  * @param   pitchRate  n 个倾角速度 | n pitch rates
+  * @param   yawRate    n 个偏航角速度 | n yaw rates
+  */
+void PlantBatch_ReadImu(PlantBatch *self, float *pitch, float *pitchRate, float *yawRate);
+
+/**
+  * @brief   读取全部车的 DMP 航向，同 Plant_ReadYaw | Read every car's DMP yaw, as Plant_ReadYaw
+  * @param   self  批量模型指针 | Pointer to batch
+  * @param   yaw   n 个航向 | n yaws
+  */
+void PlantBatch_ReadYaw(PlantBatch *self, float *yaw);
+
+/**
+  * @brief   读取全部车的编码器增量，同 Plant_ReadEncoders | Read every car's encoder deltas, as Plant_ReadEncoders
+  * @param   self   批量模型指针 | Pointer to batch
+  * @param   left   n 个左轮计数 | n left counts
+  * @param   right  n 个右轮计数 | n right counts
+  */
+void PlantBatch_ReadEncoders(PlantBatch *self, int16_t *left, int16_t *right);
+
+#endif /* PLANT_BATCH_H_ */
@@ -0,0 +1,69 @@
+#ifndef PLANT_MATH_H_
+#define PLANT_MATH_H_
+
+#include <stdint.h>
+
+/**
+  * @file    plant_math.h
+  * @brief   标量模型与批量模型共用的数学函数 | Math shared by the scalar and the batched plant
+  *
+  * @note    两条路径必须逐位相同，所以 sin/cos 和噪声都在这里定义一次，并且只用 +、−、×、÷ 和比较
+  *          （没有查表、没有整数转换、没有 libm），编译器能把调用它们的循环向量化。
+  *          sin/cos 取 fdlibm 的多项式核，误差 < 1 ulp；按 π/2 的 Cody-Waite 三段约简，对 |x| < 1e5
+  *          有效（偏航角跑几千圈也远小于这个值）。两个文件都以 -ffp-contract=off 编译，不会被
+  *          合并成 FMA。
+  *          Both paths must be bit-identical, so sin/cos and the noise are defined once here and
+  *          use only +, −, ×, ÷ and compares (no tables, no integer conversions, no libm), which
+  *          lets the compiler vectorise the loops that call them. sin/cos use the fdlibm
+  *          polynomial kernels (< 1 ulp) after a three-part Cody-Waite reduction by π/2, valid for
+  *          |x| < 1e5 (yaw after thousands of turns is still far below that). Both files are built
+  *          with -ffp-contract=off so nothing is fused into an FMA.
+  */
+
+#define PLANT_ROUND_MAGIC   6755399441055744.0      /**< 1.5·2^52：加上再减去即舍入到整数 | 1.5·2^52: add and subtract to round to an integer */
+
+/**
+  * @brief   同时求 sin 和 cos | sin and cos together
+  * @param   x  弧度 | Radians
+  * @param   s  sin(x)
+  * @param   c  cos(x)
+  */
+static inline void plantSinCos(double x, double *s, double *c) {
+    const double pio2_1 = 1.57079632673412561417e+00;
+    const double pio2_2 = 6.07710050630396597660e-11;
+    const double pio2_3 = 2.02226624879595063154e-21;
+    double k = (x * 6.36619772367581382433e-01 + PLANT_ROUND_MAGIC) - PLANT_ROUND_MAGIC;
+    double r = ((x - k * pio2_1) - k * pio2_2) - k * pio2_3;
+
+    double z = r * r;
+    double ps = -1.98412698298579493134e-04 + z * (2.75573137070700676789e-06
+                + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10));
+    double sinr = r + z * r * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03 + z * ps));
+    double pc = z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 + z * (2.48015872894767294178e-05
+                + z * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+    double hz = 0.5 * z, w = 1.0 - hz;
+    double cosr = w + (((1.0 - w) - hz) + z * pc);
+
+    // 象限 q = k mod 4，取值 −2..2 | Quadrant q = k mod 4, in −2..2
+    double q = k - 4.0 * ((k * 0.25 + PLANT_ROUND_MAGIC) - PLANT_ROUND_MAGIC);
+    double odd = (q == 1.0 || q == -1.0) ? 1.0 : 0.0;
+    double a = odd != 0.0 ? cosr : sinr;
+    double b = odd != 0.0 ? sinr : cosr;
+    *s = (q == 2.0 || q == -2.0 || q == -1.0) ? -a : a;
+    *c = (q == 1.0 || q == 2.0 || q == -2.0) ? -b : b;
+}
+
+/**
+  * @brief   均值 0、方差 1 的近似高斯噪声 | Approximately Gaussian noise, zero mean, unit variance
+  * @param   rng  随机数状态 | RNG state
+  */
+static inline double plantNoise(uint32_t *rng) {
+    double s = 0.0;
+    for (int i = 0; i < 4; i++) {
+        *rng = *rng * 1664525u + 1013904223u;
+        s += (double)(*rng >> 8) / 16777216.0;
+    }
+    return (s - 2.0) * 1.7320508;   // 4 个均匀分布之和的标准化 | Normalized sum of 4 uniforms
+}
+
+#endif /* PLANT_MATH_H_ */
@@ -0,0 +1,124 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "struct_typedef.h"
+#include "sensor_log.h"
+
+/**
+  * @file    replay.h
+  * @brief   传感器日志重放：固件的 Imu/Encoder/CarMove 原样运行在记录的输入上 | Sensor log replay: the firmware's Imu/Encoder/CarMove run unchanged on recorded inputs
+  *
+  * @note    car.c、imu.c、encoder.c、motor.c、MPU6500.c 与 InvenSense 驱动原样编译，只换掉最底层：
+  *          记录的 DMP 数据包写进寄存器级模拟器的 FIFO，由 Get_Data 经 I2C 读出并解包；记录的
+  *          计数器值写进 TIM2/TIM3 的 CNT，由 GetCountAndRpm 读出并清零；超声波读数由 HC_Read
+  *          返回；PWM 比较值从 TIM1 的 CCR 读回。命令按固件主循环的顺序在该周期之前执行。
+  *          全程没有墙钟和随机数，同一份日志在同一份代码上的输出逐位相同。
+  *          car.c, imu.c, encoder.c, motor.c, MPU6500.c and the InvenSense driver are compiled
+  *          unchanged; only the lowest layer is replaced: recorded DMP packets go into the FIFO of
+  *          the register-level emulator, where Get_Data reads and unpacks them over I2C; recorded
+  *          counter values go into TIM2/TIM3 CNT, where GetCountAndRpm reads and clears them;
+  *          HC_Read returns the recorded ultrasonic reading; the PWM compares are read back from
+  *          the TIM1 CCRs. Commands run before their period, in the firmware main-loop order.
+  *          There is no wall clock and no randomness anywhere, so one log on one build gives
+  *          bit-identical outputs.
+  */
+
+/**
+  * @brief   输出字段表：X(类型, 名称, 类型标记) | Output field table: X(type, name, type tag)
+  */
+#define REPLAY_FIELDS(X)                                                                \
+    X(uint32_t, tick_ms,  "u32")    /* 记录的 HAL 节拍 | Recorded HAL tick */             \
+    X(uint32_t, pwm_l1,   "u32")    /* TIM1 CCR1 */                                     \
+    X(uint32_t, pwm_l2,   "u32")    /* TIM1 CCR2 */                                     \
+    X(uint32_t, pwm_r1,   "u32")    /* TIM1 CCR3 */                                     \
+    X(uint32_t, pwm_r2,   "u32")    /* TIM1 CCR4 */                                     \
+    X(fp32,     out_l,    "f32")    /* 左电机 PID 输出 | Left motor PID output */         \
+    X(fp32,     out_r,    "f32")    /* 右电机 PID 输出 | Right motor PID output */        \
+    X(fp32,     set_l,    "f32")    /* 左电机目标 (计数/周期) | Left motor setpoint */      \
+    X(fp32,     set_r,    "f32")    /* 右电机目标 (计数/周期) | Right motor setpoint */     \
+    X(fp32,     pitch,    "f32")    /* 去偏置倾角 (°) | Pitch without bias */             \
+    X(fp32,     speed,    "f32")    /* 实测速度 (cm/s) | Measured speed */                \
+    X(fp32,     wheel_l,  "f32")    /* 左轮速度指令 (cm/s) | Left wheel command */         \
+    X(fp32,     wheel_r,  "f32")    /* 右轮速度指令 (cm/s) | Right wheel command */        \
+    X(fp32,     pose_x,   "f32")    /* 里程计 X (cm) | Odometry X */                      \
+    X(fp32,     pose_y,   "f32")    /* 里程计 Y (cm) | Odometry Y */                      \
+    X(fp32,     heading,  "f32")    /* 里程计航向 (°) | Odometry heading */               \
+    X(uint8_t,  brake,    "u8")     /* 刹车 | Brake */                                   \
+    X(uint8_t,  motion,   "u8")     /* 运动状态 | Motion state */
+
+/**
+  * @struct  ReplayOutput
+  * @brief   一个周期的控制器输出（小端，无填充） | Controller outputs of one period (little-endian, no padding)
+  */
+typedef struct __attribute__((packed)) {
+#define REPLAY_MEMBER(type, name, tag) type name;
+    REPLAY_FIELDS(REPLAY_MEMBER)
+#undef REPLAY_MEMBER
+} ReplayOutput;
+
+#define REPLAY_OUTPUT_MAGIC     "DNBR"  /**< 输出文件头：魔数 + u16 记录长度 | Output file header: magic + u16 record size */
+
+/**
+  * @struct  ReplayLog
+  * @brief   从抓包中取出的传感器日志 | Sensor log taken from a capture
+  */
+typedef struct {
+    SensorLogRecord *records;   /**< 记录 | Records */
+    size_t count;               /**< 记录数 | Record count */
+    unsigned long lost;         /**< 帧序号间隙中丢失的记录 | Records lost in frame sequence gaps */
+    unsigned long gaps;         /**< 间隙数 | Gap count */
+    unsigned long shortRecords; /**< 旧固件的短记录（缺失字段补零） | Short records from older firmware (missing fields zero) */
+    unsigned long crcErrors;    /**< CRC/COBS 错误 | CRC or COBS errors */
+} ReplayLog;
+
+/**
+  * @brief   读入抓包中的 MSG_SENSOR_LOG 帧，或 sensor_log 流的列式日志 | Load the MSG_SENSOR_LOG frames of a capture, or a columnar log of the sensor_log stream
+  * @param   self  日志 | Log
+  * @param   path  抓包文件（dnb_telemetry -r 的原始字节）或 dnb_collog 写出的日志 | Capture file (raw bytes from dnb_telemetry -r) or a log written by dnb_collog
+  * @return  0 成功，-1 无法读取（errno 有效） | 0 on success, -1 if unreadable (errno set)
+  */
+int ReplayLog_Load(ReplayLog *self, const char *path);
+
+/**
+  * @brief   把记录编码成 MSG_SENSOR_LOG 帧追加到文件，格式与固件发出的相同 | Append records as MSG_SENSOR_LOG frames, as the firmware sends them
+  * @param   out      输出文件 | Output file
+  * @param   records  记录 | Records
+  * @param   count    记录数 | Record count
+  * @param   seq      起始帧序号 | First frame sequence number
+  * @return  0 成功，-1 写入失败 | 0 on success, -1 on a write error
+  */
+int ReplayLog_Write(FILE *out, const SensorLogRecord *records, size_t count, uint8_t seq);
+
+/**
+  * @brief   释放 | Free
+  */
+void ReplayLog_Free(ReplayLog *self);
+
+/**
+  * @brief   按固件的上电顺序重建小车：参数存储、newCar、Param_Load，再完成 IMU 初始化
+  *          Rebuild the car in the firmware's power-up order: parameter store, newCar,
+  *          Param_Load, then the IMU init
+  * @note    可重复调用，每次都从上电状态开始 | May be called again; each call starts from power-up
+  * @return  0 成功，或 IMU 初始化的错误码 | 0 on success, or the IMU init error
+  */
+int Replay_Begin(void);
+
+/**
+  * @brief   按名称改一个参数，与上位机写入的路径相同（暂存后应用） | Change a parameter by name, the same path a host write takes (staged, then applied)
+  * @param   name   参数名 | Parameter name
+  * @param   value  数值 | Value
+  * @return  PARAM_OK，或 PARAM_ERR_* | PARAM_OK or PARAM_ERR_*
+  */
+int Replay_Set(const char *name, fp32 value);
+
+/**
+  * @brief   重放一个控制周期 | Replay one control period
+  * @param   rec  记录 | Record
+  * @param   out  输出 | Outputs
+  */
+void Replay_Step(const SensorLogRecord *rec, ReplayOutput *out);
+
+#endif /* REPLAY_H_ */
@@ -0,0 +1,77 @@
+#ifndef ROBOT_H_
+#define ROBOT_H_
+
+#include "plant.h"
+#include "control.h"
+#include "pid.h"
+
+/**
+  * @file    robot.h
+  * @brief   一台仿真小车：模型、固件控制栈与电机内环 | One simulated car: the plant, the firmware control stack and the motor loops
+  *
+  * @note    固件的 CarMove 读取硬件后调用 Control_Step，再把轮速指令交给 Move() 的 PID；
+  *          Robot 做同样的事，只是传感器和电机换成 plant.c。所有状态都在结构体里，
+  *          任意多个实例可以在不同线程中同时推进。
+  *          The firmware CarMove reads the hardware, calls Control_Step and hands the wheel
+  *          commands to the PID in Move(); Robot does the same with plant.c in place of the
+  *          sensors and motors. All state is in the struct, so any number of instances can be
+  *          stepped at once on different threads.
+  */
+
+#define ROBOT_TICK          0.01            /**< 控制周期，等于 TIM9 周期 (s) | Control period, equals the TIM9 period */
+#define ROBOT_MOTOR_ARR     60000.0f        /**< PWM 满量程 | PWM full scale */
+
+/* 与 motor.h 的 MOTOR_PID_* 相同 | Same as MOTOR_PID_* in motor.h */
+#define ROBOT_MOTOR_KP      800.0f
+#define ROBOT_MOTOR_KI      20.0f
+#define ROBOT_MOTOR_KD      0.0f
+#define ROBOT_MOTOR_MAX_IOUT 30000.0f
+
+/**
+  * @struct  Robot
+  * @brief   仿真小车 | Simulated car
+  */
+typedef struct {
+    Plant plant;                /**< 物理模型 | Physical model */
+    Control control;            /**< 固件控制栈 | Firmware control stack */
+    pid_type_def motor[2];      /**< 左右电机内环（计数/周期 → PWM） | Left/right motor loops (counts/period → PWM) */
+    double cmPerCount;          /**< 每个编码器计数对应的轮子行程 (cm) | Wheel travel per encoder count */
+    int16_t counts[2];          /**< 本周期编码器计数 | Encoder counts this period */
+    double duty[2];             /**< 本周期占空比 −1..1 | Duty this period */
+    bool_t dutySaturated;       /**< 本周期占空比饱和 | Duty saturated this period */
+} Robot;
+
+/**
+  * @brief   初始化 | Init
+  * @param   self   小车指针 | Pointer to car
+  * @param   p      模型参数 | Plant parameters
+  * @param   theta  初始倾角 (rad) | Initial pitch
+  * @param   seed   噪声种子 | Noise seed
+  */
+void Robot_Init(Robot *self, const PlantParams *p, double theta, uint32_t seed);
+
+/**
+  * @brief   读取传感器（无超声波，rangeValid 为 FALSE） | Read the sensors (no sonar, rangeValid is FALSE)
+  * @param   self  小车指针 | Pointer to car
+  * @param   in    控制输入 | Control input
+  */
+void Robot_Sense(Robot *self, ControlInput *in);
+
+/**
+  * @brief   电机内环处理轮速指令并推进模型一个周期 | Run the motor loops on the wheel commands and advance the plant one period
+  * @note    与 Move() 一样：刹车时清除积分并两路拉满（短路制动），否则输出按符号接 IN1 或 IN2。
+  *          线性模型把两者都当作占空比 in1 − in2，只有高保真电机区分短路制动和滑行
+  *          As Move(): a brake clears the integrators and drives both inputs full (short brake),
+  *          otherwise the output goes to IN1 or IN2 by sign. The linear model takes either as
+  *          duty in1 − in2; only the high-fidelity motor tells short brake from coast
+  * @param   self  小车指针 | Pointer to car
+  */
+void Robot_Actuate(Robot *self);
+
+/**
+  * @brief   一个完整周期：Robot_Sense、Control_Step、Robot_Actuate | One full period: Robot_Sense, Control_Step, Robot_Actuate
+  * @param   self  小车指针 | Pointer to car
+  */
+void Robot_Step(Robot *self);
+
+#endif /* ROBOT_H_ */
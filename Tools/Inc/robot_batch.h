@@ -0,0 +1,75 @@
+#ifndef ROBOT_BATCH_H_
+#define ROBOT_BATCH_H_
+
+#include "robot.h"
+#include "plant_batch.h"
+
+/**
+  * @file    robot_batch.h
+  * @brief   批量小车：N 台 Robot 一起推进 | Batched cars: N Robots stepped together
+  *
+  * @note    模型是 PlantBatch；电机内环（位置式 PI，与 PID_calc 的运算逐条相同）也按结构数组
+  *          存放并批量计算。固件控制栈 Control_Step 是被测代码，原样编译，按车逐台调用。
+  *          每台车的结果与同样初始化的 Robot 逐条调用 Robot_Step 逐位相同。
+  *          The plant is a PlantBatch; the motor loops (position PI, the same arithmetic as
+  *          PID_calc line by line) are also stored as structure-of-arrays and computed as a
+  *          batch. The firmware control stack Control_Step is the code under test, compiled
+  *          unchanged and called car by car. Every car's result is bit-identical to an equally
+  *          initialised Robot stepped with Robot_Step.
+  */
+
+/**
+  * @struct  RobotBatch
+  * @brief   N 台仿真小车 | N simulated cars
+  */
+typedef struct {
+    uint32_t n;
+    PlantBatch plant;               /**< 物理模型 | Physical model */
+    Control *control;               /**< 各车固件控制栈 | Firmware control stack per car */
+    void *mem;                      /**< 其余数组所在的内存块 | Block holding the other arrays */
+
+    /* 左右电机内环，下标 [轮][车] | Left/right motor loops, indexed [wheel][car] */
+    fp32 *kp[2], *ki[2], *kd[2];
+    fp32 *set[2];                   /**< 本周期目标（计数/周期） | Target this period (counts/period) */
+    fp32 *error[2];                 /**< 上周期误差 | Error of the last period */
+    fp32 *iout[2];
+    fp32 *out[2];
+    fp32 maxOut, maxIout;
+
+    double *cmPerCount;             /**< 每个编码器计数对应的轮子行程 (cm) | Wheel travel per encoder count */
+    int16_t *counts[2];             /**< 本周期编码器计数 | Encoder counts this period */
+    float *pitch, *pitchRate, *yawRate, *yaw;   /**< 本周期传感器读数 | Sensor readings this period */
+    bool_t *brake;                  /**< 本周期刹车 | Braking this period */
+    bool_t *dutySaturated;          /**< 本周期占空比饱和 | Duty saturated this period */
+} RobotBatch;
+
+/**
+  * @brief   分配 n 台车 | Allocate n cars
+  * @param   self  批量小车指针 | Pointer to batch
+  * @param   n     车数 | Car count
+  * @return  0 成功，-1 内存不足 | 0 on success, -1 when out of memory
+  */
+int RobotBatch_Init(RobotBatch *self, uint32_t n);
+
+/**
+  * @brief   释放 | Free
+  * @param   self  批量小车指针 | Pointer to batch
+  */
+void RobotBatch_Free(RobotBatch *self);
+
+/**
+  * @brief   用一台 Robot 设置第 i 台（模型、控制栈、电机内环增益与状态） | Set car i from a Robot (plant, control stack, motor loop gains and state)
+  * @note    电机内环必须是位置式、限幅与 Robot_Init 相同 | The motor loops must be position mode with Robot_Init's limits
+  * @param   self   批量小车指针 | Pointer to batch
+  * @param   i      车号 | Car index
+  * @param   robot  小车 | Car
+  */
+void RobotBatch_Set(RobotBatch *self, uint32_t i, const Robot *robot);
+
+/**
+  * @brief   一个完整周期，全部车 | One full period for every car
+  * @param   self  批量小车指针 | Pointer to batch
+  */
+void RobotBatch_Step(RobotBatch *self);
+
+#endif /* ROBOT_BATCH_H_ */
@@ -0,0 +1,41 @@
+#ifndef SERIAL_PORT_H_
+#define SERIAL_PORT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+  * @file    serial_port.h
+  * @brief   主机端串口 / pty 访问 | Host-side serial port / pty access
+  */
+
+/**
+  * @brief   打开串口并设置为原始模式 | Open a serial device in raw mode
+  * @param   path  设备路径（/dev/ttyACM0、/dev/pts/N 等） | Device path (/dev/ttyACM0, /dev/pts/N, ...)
+  * @param   baud  波特率 | Baud rate
+  * @return  文件描述符，失败返回 -1 | File descriptor, -1 on failure
+  */
+int Serial_Open(const char *path, uint32_t baud);
+
+/**
+  * @brief   带超时读取 | Read with timeout
+  * @param   fd          文件描述符 | File descriptor
+  * @param   buf         缓冲区 | Buffer
+  * @param   len         最大长度 | Max length
+  * @param   timeout_ms  超时（毫秒） | Timeout in ms
+  * @return  读取字节数，超时返回 0，出错返回 -1 | Bytes read, 0 on timeout, -1 on error
+  */
+int Serial_Read(int fd, uint8_t *buf, size_t len, int timeout_ms);
+
+/**
+  * @brief   写入全部数据 | Write all data
+  * @return  0 成功，-1 失败 | 0 on success, -1 on failure
+  */
+int Serial_Write(int fd, const uint8_t *buf, size_t len);
+
+/**
+  * @brief   关闭串口 | Close serial port
+  */
+void Serial_Close(int fd);
+
+#endif /* SERIAL_PORT_H_ */
@@ -0,0 +1,111 @@
+#ifndef SIM_LINK_H_
+#define SIM_LINK_H_
+
+#include <stdint.h>
+#include "protocol.h"
+#include "uart_rx.h"
+#include "spsc_ring.h"
+#include "path.h"
+
+/**
+  * @file    sim_link.h
+  * @brief   仿真器的 USART2：pty 上与固件逐字节相同的上位机链路 | The simulator's USART2: a pty carrying byte for byte the firmware's PC link
+  *
+  * @note    打开一个 pty，上位机工具（dnb_param、dnb_telemetry 等）连接其从端，和连接真实小车
+  *          的串口没有区别。接收走固件同一份 UartRx 代码（循环 DMA 缓冲区、同样长度），帧的分发
+  *          也是固件同一份 Link_HandleFrame（link_dispatch.c）。
+  *          pty 本身没有波特率，这里按 115200 8N1 的字节时间放行两个方向的字节：工具看到的应答
+  *          延迟和遥测带宽与真实链路一致。发送队列与固件一样是 2 × 256 字节，放不下的帧整帧丢弃。
+  *          Opens a pty whose slave side host tools (dnb_param, dnb_telemetry, ...) use exactly
+  *          like the serial port of a real car. Reception runs the firmware's own UartRx code
+  *          (circular DMA buffer of the same size), and frames go through the firmware's own
+  *          Link_HandleFrame (link_dispatch.c).
+  *          A pty has no baud rate of its own, so bytes are let through in both directions at
+  *          the 115200 8N1 byte time: the ack latency and telemetry bandwidth a tool sees match
+  *          the real link. The transmit queue is 2 x 256 bytes as in the firmware, and a frame
+  *          that does not fit is dropped whole.
+  */
+
+#define SIM_LINK_BAUD       115200      /**< 与 huart2 相同 | Same as huart2 */
+#define SIM_LINK_RX_SIZE    256         /**< 与 RX_DMA_SIZE 相同 | Same as RX_DMA_SIZE */
+#define SIM_LINK_TX_SIZE    512         /**< 与 2 × TX_QUEUE_SIZE 相同 | Same as 2 x TX_QUEUE_SIZE */
+#define SIM_LINK_CMD_QUEUE  8           /**< 与 CMD_QUEUE_SIZE 相同 | Same as CMD_QUEUE_SIZE */
+
+/**
+  * @struct  SimLink
+  * @brief   pty 链路 | Pty link
+  */
+typedef struct {
+    int master;                             /**< pty 主端 | Pty master */
+    char slave[64];                         /**< 从端路径，交给上位机工具 | Slave path, for the host tools */
+    PathFollower *path;                     /**< 路径帧的目标，可为 NULL | Target of path frames, may be NULL */
+    double byteTime;                        /**< 一个字节的线路时间 (s) | Line time of one byte */
+
+    /* 接收：pty → 线路 → 循环 DMA → UartRx | Receive: pty → line → circular DMA → UartRx */
+    UartRx rx;
+    uint8_t dma[SIM_LINK_RX_SIZE];
+    uint16_t head;                          /**< DMA 写位置 | DMA write position */
+    uint8_t wire[SIM_LINK_RX_SIZE];         /**< 已从 pty 读出、尚在线路上的字节 | Read from the pty, still on the line */
+    uint16_t wireLen;
+    double rxClock;                         /**< 上一个接收字节到达的时刻 | Arrival of the last received byte */
+
+    /* 发送：帧 → 发送队列 → 线路 → pty | Transmit: frames → TX queue → line → pty */
+    uint8_t tx[SIM_LINK_TX_SIZE];
+    uint16_t txLen;
+    double txClock;                         /**< 上一个发送字节离开的时刻 | Departure of the last sent byte */
+
+    SpscRing cmds;                          /**< 运动命令，链路 → 控制周期 | Motion commands, link → control period */
+    uint8_t cmdBuf[SIM_LINK_CMD_QUEUE];
+
+    uint32_t txFrames;                      /**< 已排队的帧 | Frames queued */
+    uint32_t txDropped;                     /**< 队列满丢弃的帧 | Frames dropped on a full queue */
+    uint32_t txUnread;                      /**< 工具没有读走、pty 写不进去的字节 | Bytes the pty would not take because no tool was reading */
+} SimLink;
+
+/**
+  * @brief   打开 pty | Open the pty
+  * @param   self  链路指针 | Pointer to link
+  * @param   path  路径帧的目标，可为 NULL | Target of path frames, may be NULL
+  * @return  0 成功，-1 失败（errno 有效） | 0 on success, -1 on failure (errno set)
+  */
+int SimLink_Open(SimLink *self, PathFollower *path);
+
+/**
+  * @brief   关闭 | Close
+  * @param   self  链路指针 | Pointer to link
+  */
+void SimLink_Close(SimLink *self);
+
+/**
+  * @brief   服务链路直到给定时刻：按字节时间收发，收到的帧立即处理 | Service the link until a given time: bytes move at the line rate and frames are handled as they complete
+  * @param   self      链路指针 | Pointer to link
+  * @param   deadline  CLOCK_MONOTONIC 时刻 (s) | CLOCK_MONOTONIC time
+  */
+void SimLink_RunUntil(SimLink *self, double deadline);
+
+/**
+  * @brief   取出一条运动命令 | Take one motion command
+  * @param   self  链路指针 | Pointer to link
+  * @param   cmd   输出命令 CMD_* | Output command CMD_*
+  * @return  TRUE 取到命令，FALSE 队列为空 | TRUE if a command was taken, FALSE if empty
+  */
+bool_t SimLink_PollCommand(SimLink *self, uint8_t *cmd);
+
+/**
+  * @brief   编码一帧放入发送队列 | Encode a frame onto the transmit queue
+  * @param   self     链路指针 | Pointer to link
+  * @param   type     消息类型 | Message type
+  * @param   seq      序号 | Sequence number
+  * @param   payload  负载 | Payload
+  * @param   len      负载长度 | Payload length
+  * @return  0 成功，-1 队列已满（整帧丢弃并计数） | 0 on success, -1 if full (dropped whole and counted)
+  */
+int SimLink_SendFrame(SimLink *self, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len);
+
+/**
+  * @brief   CLOCK_MONOTONIC 当前时刻 | Current CLOCK_MONOTONIC time
+  * @return  秒 | Seconds
+  */
+double SimLink_Now(void);
+
+#endif /* SIM_LINK_H_ */
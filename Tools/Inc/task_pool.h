@@ -0,0 +1,54 @@
+#ifndef TASK_POOL_H_
+#define TASK_POOL_H_
+
+#include <stdint.h>
+
+/**
+  * @file    task_pool.h
+  * @brief   工作窃取线程池：把 0..n-1 的任务编号分给多个线程 | Work-stealing thread pool over the task indices 0..n-1
+  *
+  * @note    编号区间先平均分给各线程。每个线程从自己区间的低端逐个取任务；取空后随机挑一个线程，
+  *          偷走它剩余区间的上半段。区间 [lo, hi) 打包成一个 64 位字，取任务和窃取都是一次 CAS，
+  *          没有锁。任务耗时差别很大时（倒地的仿真提前结束）各线程仍然同时完成。
+  *          每个编号恰好执行一次；结果写在按编号索引的数组里即与线程数无关。
+  *          The index range is first split evenly across the threads. Each thread takes tasks one
+  *          by one from the low end of its own range; once that is empty it picks a random thread
+  *          and steals the upper half of what it has left. A range [lo, hi) is packed into one
+  *          64-bit word, so taking and stealing are each a single CAS, with no locks. When task
+  *          costs vary a lot (a simulation that falls over ends early) the threads still finish
+  *          together. Every index runs exactly once; results stored by index do not depend on
+  *          the thread count.
+  */
+
+#define TASK_POOL_MAX_THREADS   256
+
+/**
+  * @brief   任务函数 | Task function
+  * @param   ctx     调用者上下文 | Caller context
+  * @param   index   任务编号 | Task index
+  * @param   worker  执行的线程 0..threads-1 | Executing thread 0..threads-1
+  */
+typedef void (*TaskFn)(void *ctx, uint32_t index, int worker);
+
+/**
+  * @struct  TaskPoolStats
+  * @brief   运行统计 | Run statistics
+  */
+typedef struct {
+    uint32_t tasks[TASK_POOL_MAX_THREADS];      /**< 各线程执行的任务数 | Tasks run per thread */
+    uint32_t steals[TASK_POOL_MAX_THREADS];     /**< 各线程成功窃取的次数 | Successful steals per thread */
+} TaskPoolStats;
+
+/**
+  * @brief   在 threads 个线程上执行 fn(ctx, 0..n-1, worker)，全部完成后返回 | Run fn(ctx, 0..n-1, worker) on threads threads and return when all are done
+  * @param   n        任务数 | Task count
+  * @param   threads  线程数 1..TASK_POOL_MAX_THREADS | Thread count
+  * @param   fn       任务函数 | Task function
+  * @param   ctx      传给 fn 的上下文 | Context passed to fn
+  * @param   stats    统计，可为 NULL | Statistics, may be NULL
+  * @return  0 成功，-1 参数错误或一个线程都没能创建 | 0 on success, -1 on bad arguments or when no thread could be created
+  * @note    部分线程创建失败时，其余线程会偷走它们的区间 | If some threads fail to start, the others steal their ranges
+  */
+int TaskPool_Run(uint32_t n, int threads, TaskFn fn, void *ctx, TaskPoolStats *stats);
+
+#endif /* TASK_POOL_H_ */
@@ -0,0 +1,57 @@
+#ifndef TIM_H_HOST_
+#define TIM_H_HOST_
+
+/**
+  * @file    tim.h
+  * @brief   主机端替身：定时器只是一组寄存器 | Host stand-in: a timer is just its registers
+  *
+  * @note    固件中的 tim.h 由 CubeMX 生成并引入 HAL；主机上编译 car.c、motor.c、encoder.c 时用此文件
+  *          代替。驱动读写的寄存器（CNT、ARR、CCR1..4）由调用者直接设置和检查，例如重放工具在
+  *          CarMove 之前写入记录的编码器计数，之后读出 PWM 比较值
+  *          The firmware tim.h is generated by CubeMX and pulls in the HAL; host builds of car.c,
+  *          motor.c and encoder.c use this instead. The registers the drivers touch (CNT, ARR,
+  *          CCR1..4) are set and checked directly by the caller, e.g. the replay tool writes the
+  *          recorded encoder counts before CarMove and reads the PWM compares after it
+  */
+#include <stdint.h>
+
+typedef struct {
+    uint32_t CNT;
+    uint32_t ARR;
+    uint32_t CCR[4];
+} TIM_TypeDef;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+} TIM_HandleTypeDef;
+
+#define TIM_CHANNEL_1       0x00000000U
+#define TIM_CHANNEL_2       0x00000004U
+#define TIM_CHANNEL_3       0x00000008U
+#define TIM_CHANNEL_4       0x0000000CU
+#define TIM_CHANNEL_ALL     0x0000003CU
+
+#define __HAL_TIM_GET_COUNTER(h)            ((h)->Instance->CNT)
+#define __HAL_TIM_SetCounter(h, v)          ((h)->Instance->CNT = (uint32_t)(v))
+#define __HAL_TIM_SET_COUNTER(h, v)         __HAL_TIM_SetCounter(h, v)
+#define __HAL_TIM_GET_AUTORELOAD(h)         ((h)->Instance->ARR)
+#define __HAL_TIM_SET_AUTORELOAD(h, v)      ((h)->Instance->ARR = (uint32_t)(v))
+#define __HAL_TIM_SET_COMPARE(h, ch, v)     ((h)->Instance->CCR[(ch) >> 2] = (uint32_t)(v))
+#define __HAL_TIM_GET_COMPARE(h, ch)        ((h)->Instance->CCR[(ch) >> 2])
+
+static inline int HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel) {
+    (void)htim;
+    (void)channel;
+    return 0;
+}
+
+static inline int HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t channel) {
+    (void)htim;
+    (void)channel;
+    return 0;
+}
+
+/* 由使用者定义 | Defined by the user */
+extern TIM_HandleTypeDef htim1, htim2, htim3, htim4, htim9;
+
+#endif /* TIM_H_HOST_ */
@@ -0,0 +1,12 @@
+#ifndef USART_H_HOST_
+#define USART_H_HOST_
+
+/**
+  * @file    usart.h
+  * @brief   主机端替身：communication.h 只需要句柄类型 | Host stand-in: communication.h only needs the handle type
+  */
+typedef struct {
+    int unused;
+} UART_HandleTypeDef;
+
+#endif /* USART_H_HOST_ */
@@ -0,0 +1,223 @@
+/**
+  * @file    batch_bench.c
+  * @brief   批量模型与标量模型的吞吐量对比及逐位一致性检查 | Throughput of the batched vs the scalar plant, with a bit-identity check
+  *
+  * @note    用法 | Usage: dnb_batch_bench [-n robots] [-t seconds]
+  *          两项测试，各自先用标量代码、再用批量代码推进同样初始化的 n 台车：
+  *          1. 只有模型：开环占空比按车号和周期变化，Plant_Step 对比 PlantBatch_Step；
+  *          2. 完整小车：模型、固件控制栈与电机内环运行起步、加速、转弯、停车的脚本，直立环增益
+  *             按车号取 0.5..1.3 倍，Robot_Step 对比 RobotBatch_Step。
+  *          报告每秒推进的车·周期数，并逐台比较最终状态；任何一位不同都会使程序以非零状态退出。
+  *          Two tests, each stepping n equally initialised cars first with the scalar code and
+  *          then with the batched code:
+  *          1. Plant only: open-loop duty varying with car index and period, Plant_Step vs
+  *             PlantBatch_Step;
+  *          2. Whole car: plant, firmware control stack and motor loops running a launch,
+  *             speed-up, turn and stop script with an upright gain of 0.5..1.3x by car index,
+  *             Robot_Step vs RobotBatch_Step.
+  *          Reports car-periods per second and compares every car's final state; any differing
+  *          bit makes the program exit non-zero.
+  *          -n  小车数量（默认 1024） | Number of cars (default 1024)
+  *          -t  仿真时长（默认 4 s） | Simulated time (default 4 s)
+  */
+#include <math.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "robot_batch.h"
+#include "command.h"
+
+#define GAIN_STEPS      9
+
+typedef struct {
+    double time;
+    uint8_t cmd;
+} Event;
+
+/* 起步、加速、转弯、停车 | Launch, speed up, turn, stop */
+static const Event script[] = {
+        {0.5, CMD_FORWARD},
+        {0.5, CMD_SPEED_UP}, {0.5, CMD_SPEED_UP}, {0.5, CMD_SPEED_UP}, {0.5, CMD_SPEED_UP},
+        {1.5, CMD_LEFT},
+        {2.5, CMD_TURN_CLEAR},
+        {3.0, CMD_STOP},
+};
+
+#define SCRIPT_LEN (sizeof(script) / sizeof(script[0]))
+
+static int failures = 0;
+
+static double nowSec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+  * @brief   第 i 台车的模型参数：质量与质心高度按车号变化 | Plant parameters of car i: mass and COM height vary with the index
+  */
+static PlantParams carParams(uint32_t i) {
+    PlantParams pp = Plant_DefaultParams();
+    pp.bodyMass *= 0.9 + 0.02 * (double)(i % 11);
+    pp.comHeight *= 0.9 + 0.025 * (double)(i % 7);
+    return pp;
+}
+
+/* 开环占空比，只取决于车号和周期 | Open-loop duty, a function of car index and period only */
+static double openDuty(uint32_t i, unsigned long tick, int side) {
+    return 0.15 * (double)((int)((i * 7u + tick * (side ? 3u : 5u)) % 11u) - 5) / 5.0;
+}
+
+/**
+  * @brief   比较两个模型的状态，逐位 | Compare the state of two plants bit by bit
+  */
+static int samePlant(const Plant *a, const Plant *b) {
+    return memcmp(&a->x, &b->x, sizeof(double) * 9) == 0
+           && memcmp(a->wheel, b->wheel, sizeof(a->wheel)) == 0
+           && memcmp(a->count, b->count, sizeof(a->count)) == 0
+           && memcmp(a->duty, b->duty, sizeof(a->duty)) == 0
+           && a->rng == b->rng;
+}
+
+static void report(const char *name, uint32_t n, unsigned long ticks, double scalar, double batch, uint32_t differ) {
+    double steps = (double)n * (double)ticks;
+    printf("  %-12s scalar %7.3f M/s   batch %7.3f M/s   %5.2fx   %u of %u cars differ\n",
+           name, steps / scalar * 1e-6, steps / batch * 1e-6, scalar / batch, differ, n);
+    if (differ) failures++;
+}
+
+static void benchPlant(uint32_t n, double duration) {
+    Plant *plants = malloc(n * sizeof(Plant));
+    PlantBatch batch;
+    if (!plants || PlantBatch_Init(&batch, n) != 0) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        PlantParams pp = carParams(i);
+        Plant_Init(&plants[i], &pp, 0.01 * (double)(i % 5), 1000u + i);
+        PlantBatch_Set(&batch, i, &plants[i]);
+    }
+    unsigned long ticks = (unsigned long)(duration / ROBOT_TICK + 0.5);
+
+    double t0 = nowSec();
+    for (unsigned long k = 0; k < ticks; k++) {
+        for (uint32_t i = 0; i < n; i++) {
+            Plant_Step(&plants[i], openDuty(i, k, 0), openDuty(i, k, 1), ROBOT_TICK);
+        }
+    }
+    double scalar = nowSec() - t0;
+
+    t0 = nowSec();
+    for (unsigned long k = 0; k < ticks; k++) {
+        for (uint32_t i = 0; i < n; i++) {
+            batch.duty[0][i] = openDuty(i, k, 0);
+            batch.duty[1][i] = openDuty(i, k, 1);
+        }
+        PlantBatch_Step(&batch, ROBOT_TICK);
+    }
+    double batched = nowSec() - t0;
+
+    uint32_t differ = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        Plant p = plants[i];
+        PlantBatch_Get(&batch, i, &p);
+        differ += !samePlant(&p, &plants[i]);
+    }
+    report("plant", n, ticks, scalar, batched, differ);
+    PlantBatch_Free(&batch);
+    free(plants);
+}
+
+static void benchRobot(uint32_t n, double duration) {
+    Robot *robots = malloc(n * sizeof(Robot));
+    RobotBatch batch;
+    if (!robots || RobotBatch_Init(&batch, n) != 0) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        PlantParams pp = carParams(i);
+        Robot_Init(&robots[i], &pp, 0.02, 1000u + i);
+        robots[i].control.balance.angleKp *= (fp32)(0.5 + 0.1 * (double)(i % GAIN_STEPS));
+        RobotBatch_Set(&batch, i, &robots[i]);
+    }
+    unsigned long ticks = (unsigned long)(duration / ROBOT_TICK + 0.5);
+
+    double t0 = nowSec();
+    size_t next = 0;
+    for (unsigned long k = 0; k < ticks; k++) {
+        double t = (double)k * ROBOT_TICK;
+        for (; next < SCRIPT_LEN && script[next].time <= t + 1e-9; next++) {
+            for (uint32_t i = 0; i < n; i++) {
+                Motion_Dispatch(&robots[i].control.motion, script[next].cmd);
+            }
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            Robot_Step(&robots[i]);
+        }
+    }
+    double scalar = nowSec() - t0;
+
+    t0 = nowSec();
+    next = 0;
+    for (unsigned long k = 0; k < ticks; k++) {
+        double t = (double)k * ROBOT_TICK;
+        for (; next < SCRIPT_LEN && script[next].time <= t + 1e-9; next++) {
+            for (uint32_t i = 0; i < n; i++) {
+                Motion_Dispatch(&batch.control[i].motion, script[next].cmd);
+            }
+        }
+        RobotBatch_Step(&batch);
+    }
+    double batched = nowSec() - t0;
+
+    uint32_t differ = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        const Robot *r = &robots[i];
+        const Control *c = &batch.control[i];
+        Plant p = r->plant;
+        PlantBatch_Get(&batch.plant, i, &p);
+        int same = samePlant(&p, &r->plant)
+                   && memcmp(&c->speed, &r->control.speed, sizeof(c->speed)) == 0
+                   && memcmp(&c->pitch, &r->control.pitch, sizeof(c->pitch)) == 0
+                   && c->brake == r->control.brake
+                   && batch.dutySaturated[i] == r->dutySaturated;
+        for (int k = 0; k < 2; k++) {
+            same = same && memcmp(&batch.out[k][i], &r->motor[k].out, sizeof(fp32)) == 0
+                   && memcmp(&batch.iout[k][i], &r->motor[k].Iout, sizeof(fp32)) == 0
+                   && batch.counts[k][i] == r->counts[k];
+        }
+        differ += !same;
+    }
+    report("whole car", n, ticks, scalar, batched, differ);
+    RobotBatch_Free(&batch);
+    free(robots);
+}
+
+int main(int argc, char **argv) {
+    uint32_t n = 1024;
+    double duration = 4.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            n = (uint32_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [-n robots] [-t seconds]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n == 0 || duration <= 0.0) {
+        fprintf(stderr, "need at least one robot and a positive duration\n");
+        return 2;
+    }
+
+    printf("%u cars x %.1f s, car-periods per second (one thread, %d cars per block)\n",
+           n, duration, PLANT_BATCH_BLOCK);
+    benchPlant(n, duration);
+    benchRobot(n, duration);
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
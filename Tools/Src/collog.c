@@ -0,0 +1,404 @@
+/**
+  * @file    collog.c
+  * @brief   分块列式日志 | Chunked columnar log
+  */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "collog.h"
+#include "crc.h"
+
+#define CHANNEL_BYTES   (COLLOG_NAME_LEN + 1 + 2)   /**< 文件头中每个通道的字节数 | Bytes per channel in the header */
+#define VARINT_MAX      5                           /**< 32 位值最长的 varint | Longest varint of a 32-bit value */
+
+static size_t headerSize(uint8_t count) {
+    return 4 + 2 + 2 + 1 + COLLOG_NAME_LEN + (size_t)count * CHANNEL_BYTES + 4;
+}
+
+uint8_t ColLog_TypeSize(uint8_t type) {
+    switch (type) {
+        case COLLOG_U8:
+        case COLLOG_I8:  return 1;
+        case COLLOG_U16:
+        case COLLOG_I16: return 2;
+        default:         return 4;
+    }
+}
+
+const char *ColLog_TypeName(uint8_t type) {
+    static const char *const names[] = {"u8", "i8", "u16", "i16", "u32", "i32", "f32"};
+    return type <= COLLOG_F32 ? names[type] : "?";
+}
+
+/**
+  * @brief   取一个值并扩展到 32 位，有符号类型做符号扩展 | Load one value widened to 32 bits, sign-extending signed types
+  */
+static uint32_t load(uint8_t type, const uint8_t *p) {
+    switch (type) {
+        case COLLOG_U8:  return p[0];
+        case COLLOG_I8:  return (uint32_t)(int32_t)(int8_t)p[0];
+        case COLLOG_U16: { uint16_t v; memcpy(&v, p, 2); return v; }
+        case COLLOG_I16: { int16_t v; memcpy(&v, p, 2); return (uint32_t)(int32_t)v; }
+        default:         { uint32_t v; memcpy(&v, p, 4); return v; }
+    }
+}
+
+double ColLog_ToDouble(uint8_t type, const void *value) {
+    uint32_t v = load(type, value);
+    switch (type) {
+        case COLLOG_I8:
+        case COLLOG_I16:
+        case COLLOG_I32: return (int32_t)v;
+        case COLLOG_F32: { fp32 f; memcpy(&f, &v, 4); return f; }
+        default:         return v;
+    }
+}
+
+static uint8_t *putU16(uint8_t *p, uint16_t v) { memcpy(p, &v, 2); return p + 2; }
+static uint8_t *putU32(uint8_t *p, uint32_t v) { memcpy(p, &v, 4); return p + 4; }
+static uint16_t getU16(const uint8_t *p) { uint16_t v; memcpy(&v, p, 2); return v; }
+static uint32_t getU32(const uint8_t *p) { uint32_t v; memcpy(&v, p, 4); return v; }
+
+/**
+  * @brief   编码一列：差分、zigzag、varint | Encode one column: delta, zigzag, varint
+  * @return  字节数 | Byte count
+  */
+static uint32_t encodeColumn(const ColLogChannel *ch, const uint8_t *rows, uint16_t recordSize, uint32_t n, uint8_t *out) {
+    uint8_t *p = out;
+    uint32_t prev = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = load(ch->type, rows + (size_t)i * recordSize + ch->offset);
+        uint32_t d = v - prev;
+        uint32_t z = (d << 1) ^ (uint32_t)((int32_t)d >> 31);
+        prev = v;
+        while (z >= 0x80) {
+            *p++ = (uint8_t)(z | 0x80);
+            z >>= 7;
+        }
+        *p++ = (uint8_t)z;
+    }
+    return (uint32_t)(p - out);
+}
+
+/**
+  * @brief   解码一列 | Decode one column
+  * @note    字节不够时其余差分为 0，即重复最后一个解出的值；CRC 通过的块不会发生
+  *          Past the end of the bytes the remaining deltas are 0, so the last decoded value repeats;
+  *          never happens in a chunk that passed its CRC
+  */
+static void decodeColumn(uint8_t type, const uint8_t *p, uint32_t len, uint32_t n, uint8_t *out, size_t stride) {
+    const uint8_t *end = p + len;
+    uint8_t size = ColLog_TypeSize(type);
+    uint32_t prev = 0;
+    for (uint32_t i = 0; i < n; i++, out += stride) {
+        uint32_t z = 0;
+        uint8_t shift = 0;
+        while (p < end && shift < 7 * VARINT_MAX) {
+            uint8_t b = *p++;
+            z |= (uint32_t)(b & 0x7F) << shift;
+            shift += 7;
+            if (!(b & 0x80)) break;
+        }
+        prev += (z >> 1) ^ (0U - (z & 1));
+        // 小端：低位字节即窄类型的值 | Little-endian: the low bytes are the narrow value
+        memcpy(out, &prev, size);
+    }
+}
+
+/* 写入端 | Writer ---------------------------------------------------------*/
+
+static int sameSchema(const ColLogSchema *a, const ColLogSchema *b) {
+    if (strncmp(a->stream, b->stream, COLLOG_NAME_LEN) != 0 || a->recordSize != b->recordSize || a->count != b->count) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < a->count; i++) {
+        const ColLogChannel *x = &a->channels[i], *y = &b->channels[i];
+        if (strncmp(x->name, y->name, COLLOG_NAME_LEN) != 0 || x->type != y->type || x->offset != y->offset) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int writeHeader(ColLogWriter *self) {
+    const ColLogSchema *s = &self->schema;
+    uint8_t buf[4 + 2 + 2 + 1 + COLLOG_NAME_LEN + COLLOG_MAX_CHANNELS * CHANNEL_BYTES + 4] = {0};
+    uint8_t *p = buf;
+    memcpy(p, COLLOG_MAGIC, 4);
+    p = putU16(p + 4, COLLOG_VERSION);
+    p = putU16(p, s->recordSize);
+    *p++ = s->count;
+    // 名称定长、以 0 结尾；buf 已清零，只复制字符 | Names are fixed-size and NUL-terminated; buf is zeroed, so copy only the characters
+    memcpy(p, s->stream, strnlen(s->stream, COLLOG_NAME_LEN - 1));
+    p += COLLOG_NAME_LEN;
+    for (uint8_t i = 0; i < s->count; i++) {
+        memcpy(p, s->channels[i].name, strnlen(s->channels[i].name, COLLOG_NAME_LEN - 1));
+        p += COLLOG_NAME_LEN;
+        *p++ = s->channels[i].type;
+        p = putU16(p, s->channels[i].offset);
+    }
+    p = putU32(p, CRC32_Calc(buf, (uint32_t)(p - buf)));
+    size_t n = (size_t)(p - buf);
+    if (fwrite(buf, 1, n, self->file) != n || fflush(self->file) != 0) {
+        return COLLOG_ERR_IO;
+    }
+    self->bytes = n;
+    return COLLOG_OK;
+}
+
+int ColLogWriter_Open(ColLogWriter *self, const char *path, const ColLogSchema *schema) {
+    memset(self, 0, sizeof(*self));
+    if (schema->count == 0 || schema->count > COLLOG_MAX_CHANNELS) {
+        return COLLOG_ERR_FORMAT;
+    }
+    self->schema = *schema;
+
+    struct stat st;
+    int append = stat(path, &st) == 0 && st.st_size > 0;
+    if (append) {
+        ColLogReader existing;
+        int ret = ColLog_Open(&existing, path);
+        if (ret != COLLOG_OK) {
+            return ret;
+        }
+        int same = sameSchema(&existing.schema, schema);
+        self->records = existing.records;
+        self->bytes = existing.validBytes;
+        ColLog_Close(&existing);
+        if (!same) {
+            return COLLOG_ERR_SCHEMA;
+        }
+        // 截掉写了一半的块 | Cut off a half-written chunk
+        if ((uint64_t)st.st_size != self->bytes && truncate(path, (off_t)self->bytes) != 0) {
+            return COLLOG_ERR_IO;
+        }
+    }
+
+    self->file = fopen(path, append ? "ab" : "wb");
+    self->rows = malloc((size_t)COLLOG_CHUNK_RECORDS * schema->recordSize);
+    self->column = malloc((size_t)COLLOG_CHUNK_RECORDS * VARINT_MAX * schema->count);
+    if (self->file == NULL || self->rows == NULL || self->column == NULL) {
+        int err = errno;
+        if (self->file != NULL) fclose(self->file);
+        free(self->rows);
+        free(self->column);
+        errno = err;
+        return COLLOG_ERR_IO;
+    }
+    return append ? COLLOG_OK : writeHeader(self);
+}
+
+int ColLogWriter_Flush(ColLogWriter *self) {
+    if (self->pending == 0) {
+        return COLLOG_OK;
+    }
+    const ColLogSchema *s = &self->schema;
+    uint8_t head[4 + 4 + 4 * COLLOG_MAX_CHANNELS];
+    memcpy(head, COLLOG_CHUNK_MAGIC, 4);
+    uint8_t *p = putU32(head + 4, self->pending);
+    uint8_t *column = self->column;
+    for (uint8_t i = 0; i < s->count; i++) {
+        uint32_t len = encodeColumn(&s->channels[i], self->rows, s->recordSize, self->pending, column);
+        p = putU32(p, len);
+        column += len;
+    }
+    size_t headLen = (size_t)(p - head);
+    size_t bodyLen = (size_t)(column - self->column);
+    uint32_t crc = CRC32_Update(CRC32_INIT, head + 4, (uint32_t)(headLen - 4));
+    crc = CRC32_Update(crc, self->column, (uint32_t)bodyLen);
+    uint8_t tail[4];
+    putU32(tail, crc ^ 0xFFFFFFFFU);
+    if (fwrite(head, 1, headLen, self->file) != headLen || fwrite(self->column, 1, bodyLen, self->file) != bodyLen ||
+        fwrite(tail, 1, 4, self->file) != 4 || fflush(self->file) != 0) {
+        return COLLOG_ERR_IO;
+    }
+    self->records += self->pending;
+    self->bytes += headLen + bodyLen + 4;
+    self->pending = 0;
+    return COLLOG_OK;
+}
+
+int ColLogWriter_Append(ColLogWriter *self, const void *record) {
+    memcpy(self->rows + (size_t)self->pending * self->schema.recordSize, record, self->schema.recordSize);
+    if (++self->pending == COLLOG_CHUNK_RECORDS) {
+        return ColLogWriter_Flush(self);
+    }
+    return COLLOG_OK;
+}
+
+int ColLogWriter_Close(ColLogWriter *self) {
+    int ret = ColLogWriter_Flush(self);
+    if (fclose(self->file) != 0 && ret == COLLOG_OK) {
+        ret = COLLOG_ERR_IO;
+    }
+    free(self->rows);
+    free(self->column);
+    self->file = NULL;
+    self->rows = self->column = NULL;
+    return ret;
+}
+
+/* 读取端 | Reader ---------------------------------------------------------*/
+
+static int parseHeader(ColLogReader *self) {
+    const uint8_t *p = self->map;
+    if (self->size < headerSize(1) || memcmp(p, COLLOG_MAGIC, 4) != 0 || getU16(p + 4) != COLLOG_VERSION) {
+        return COLLOG_ERR_FORMAT;
+    }
+    ColLogSchema *s = &self->schema;
+    s->recordSize = getU16(p + 6);
+    s->count = p[8];
+    size_t len = headerSize(s->count);
+    if (s->count == 0 || s->count > COLLOG_MAX_CHANNELS || self->size < len ||
+        CRC32_Calc(p, (uint32_t)(len - 4)) != getU32(p + len - 4)) {
+        return COLLOG_ERR_FORMAT;
+    }
+    memcpy(s->stream, p + 9, COLLOG_NAME_LEN);
+    s->stream[COLLOG_NAME_LEN - 1] = '\0';
+    p += 9 + COLLOG_NAME_LEN;
+    for (uint8_t i = 0; i < s->count; i++, p += CHANNEL_BYTES) {
+        ColLogChannel *ch = &s->channels[i];
+        memcpy(ch->name, p, COLLOG_NAME_LEN);
+        ch->name[COLLOG_NAME_LEN - 1] = '\0';
+        ch->type = p[COLLOG_NAME_LEN];
+        ch->offset = getU16(p + COLLOG_NAME_LEN + 1);
+        if (ch->type > COLLOG_F32 || ch->offset + ColLog_TypeSize(ch->type) > s->recordSize) {
+            return COLLOG_ERR_FORMAT;
+        }
+    }
+    self->validBytes = len;
+    return COLLOG_OK;
+}
+
+static uint32_t chunkCrc(const ColLogReader *self, const ColLogChunk *c) {
+    return CRC32_Calc(self->map + c->offset + 4, (uint32_t)(c->size - 8));
+}
+
+/**
+  * @brief   只读块头建立索引，不触及列数据 | Index chunks from their headers alone, without touching column data
+  */
+static int indexChunks(ColLogReader *self) {
+    uint8_t n = self->schema.count;
+    size_t pos = self->validBytes;
+    uint32_t capacity = 0;
+    while (pos + 8 + 4 * (size_t)n + 4 <= self->size && memcmp(self->map + pos, COLLOG_CHUNK_MAGIC, 4) == 0) {
+        const uint8_t *lengths = self->map + pos + 8;
+        uint32_t records = getU32(self->map + pos + 4);
+        uint64_t column = pos + 8 + 4 * (uint64_t)n;
+        if (records == 0 || records > COLLOG_CHUNK_RECORDS) {
+            break;
+        }
+        if (self->chunkCount == capacity) {
+            capacity = capacity ? 2 * capacity : 64;
+            ColLogChunk *grown = realloc(self->chunks, capacity * sizeof(ColLogChunk));
+            if (grown == NULL) {
+                return COLLOG_ERR_IO;
+            }
+            self->chunks = grown;
+        }
+        ColLogChunk *c = &self->chunks[self->chunkCount];
+        c->offset = pos;
+        c->first = self->records;
+        c->records = records;
+        for (uint8_t i = 0; i < n; i++) {
+            c->column[i] = column;
+            c->length[i] = getU32(lengths + 4 * i);
+            column += c->length[i];
+        }
+        c->size = column + 4 - pos;
+        if (column + 4 > self->size) {
+            break;
+        }
+        self->chunkCount++;
+        self->records += records;
+        pos = (size_t)column + 4;
+    }
+    // 只追加的文件只有最后一块可能写了一半 | In an append-only file only the last chunk can be half-written
+    if (self->chunkCount > 0) {
+        ColLogChunk *last = &self->chunks[self->chunkCount - 1];
+        if (chunkCrc(self, last) != getU32(self->map + last->offset + last->size - 4)) {
+            self->chunkCount--;
+            self->records -= last->records;
+            pos = (size_t)last->offset;
+        }
+    }
+    self->validBytes = pos;
+    return COLLOG_OK;
+}
+
+int ColLog_Open(ColLogReader *self, const char *path) {
+    memset(self, 0, sizeof(*self));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return COLLOG_ERR_IO;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return COLLOG_ERR_IO;
+    }
+    self->size = (size_t)st.st_size;
+    if (self->size == 0) {
+        close(fd);
+        return COLLOG_ERR_FORMAT;
+    }
+    void *map = mmap(NULL, self->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return COLLOG_ERR_IO;
+    }
+    self->map = map;
+
+    int ret = parseHeader(self);
+    if (ret == COLLOG_OK) {
+        ret = indexChunks(self);
+    }
+    if (ret != COLLOG_OK) {
+        ColLog_Close(self);
+    }
+    return ret;
+}
+
+uint32_t ColLog_Verify(const ColLogReader *self) {
+    for (uint32_t i = 0; i < self->chunkCount; i++) {
+        const ColLogChunk *c = &self->chunks[i];
+        if (chunkCrc(self, c) != getU32(self->map + c->offset + c->size - 4)) {
+            return i;
+        }
+    }
+    return self->chunkCount;
+}
+
+int ColLog_Find(const ColLogReader *self, const char *name) {
+    for (uint8_t i = 0; i < self->schema.count; i++) {
+        if (strcmp(self->schema.channels[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return COLLOG_ERR_CHANNEL;
+}
+
+int ColLog_ReadColumn(const ColLogReader *self, uint8_t channel, void *out, size_t stride) {
+    if (channel >= self->schema.count) {
+        return COLLOG_ERR_CHANNEL;
+    }
+    uint8_t type = self->schema.channels[channel].type;
+    for (uint32_t i = 0; i < self->chunkCount; i++) {
+        const ColLogChunk *c = &self->chunks[i];
+        decodeColumn(type, self->map + c->column[channel], c->length[channel], c->records,
+                     (uint8_t *)out + c->first * stride, stride);
+    }
+    return COLLOG_OK;
+}
+
+void ColLog_Close(ColLogReader *self) {
+    if (self->map != NULL) {
+        munmap((void *)self->map, self->size);
+    }
+    free(self->chunks);
+    memset(self, 0, sizeof(*self));
+}
@@ -0,0 +1,292 @@
+/**
+  * @file    collog_bench.c
+  * @brief   列式日志与 CSV 的转换基准 | Conversion benchmark of the columnar log against CSV
+  *
+  * @note    用法 | Usage: dnb_collog_bench [-n records]
+  *          生成一份合成传感器日志（默认 360000 条，即 100 Hz 下一小时），分别写成 CSV 与列式日志，
+  *          比较文件大小、写入时间、读回全部字段的时间，以及只取一个通道（gyro_x 求和）的时间。
+  *          读回的记录必须与原始记录逐位相同，否则以非零状态退出。
+  *          两种格式都在刚写完、位于页缓存中时读取，比较的是解析成本而不是磁盘。
+  *          Builds a synthetic sensor log (360000 records by default, one hour at 100 Hz), writes
+  *          it as CSV and as a columnar log, and compares the file sizes, the write times, the
+  *          time to read back every field, and the time to take one channel (the gyro_x sum).
+  *          Records read back must be bit-identical to the originals, or the program exits
+  *          non-zero. Both formats are read right after writing, from the page cache, so this
+  *          compares parsing cost rather than the disk.
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "collog.h"
+#include "log_schema.h"
+#include "sensor_log.h"
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rngState = 12345;
+
+static uint32_t rng(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static int noise(int amplitude) {
+    return (int)(rng() % (2 * (uint32_t)amplitude + 1)) - amplitude;
+}
+
+/**
+  * @brief   合成日志：缓慢摆动的姿态加噪声，编码器随速度变化，偶尔有命令与超声波丢失
+  *          Synthetic log: a slowly swaying attitude plus noise, encoders following the speed,
+  *          occasional commands and ultrasonic dropouts
+  */
+static void makeLog(SensorLogRecord *recs, size_t n) {
+    memset(recs, 0, n * sizeof(*recs));
+    for (size_t i = 0; i < n; i++) {
+        SensorLogRecord *r = &recs[i];
+        double t = (double)i * 0.01;
+        double half = (2.0 * sin(0.7 * t) + 0.05 * noise(10)) / 57.3 / 2.0;
+        double yaw = 0.1 * t;
+        int speed = (int)(20.0 * sin(0.05 * t));
+        r->tick_ms = 1000 + 10 * (uint32_t)i;
+        r->loop_us = 10000;
+        r->enc[0] = (uint16_t)(int16_t)(speed + noise(2));
+        r->enc[1] = (uint16_t)(int16_t)(-speed + noise(2));
+        r->quat[0] = (int32_t)lrint(cos(half) * cos(yaw / 2) * 1073741824.0);
+        r->quat[1] = (int32_t)lrint(sin(half) * cos(yaw / 2) * 1073741824.0);
+        r->quat[2] = (int32_t)lrint(-sin(half) * sin(yaw / 2) * 1073741824.0);
+        r->quat[3] = (int32_t)lrint(cos(half) * sin(yaw / 2) * 1073741824.0);
+        r->accel[0] = (int16_t)(noise(200));
+        r->accel[1] = (int16_t)(560.0 * sin(0.7 * t) + noise(200));
+        r->accel[2] = (int16_t)(16384 + noise(200));
+        r->gyro[0] = (int16_t)(91.7 * cos(0.7 * t) + noise(30));
+        r->gyro[1] = (int16_t)noise(30);
+        r->gyro[2] = (int16_t)(6.55 * 5.73 + noise(30));
+        bool_t rangeValid = (i / 600) % 5 != 4;
+        r->range = rangeValid ? (fp32)(60.0 + 40.0 * sin(0.02 * t)) : 0.0f;
+        r->range_age_ms = (uint32_t)(i % 6) * 10;
+        r->flags = SENSOR_LOG_IMU | (rangeValid ? SENSOR_LOG_RANGE_VALID : 0);
+        if (i % 1000 == 0) {
+            r->ncmd = 1;
+            r->cmd[0] = (uint8_t)(0xC1 + (i / 1000) % 5);
+        }
+    }
+}
+
+/* CSV ---------------------------------------------------------------------*/
+
+static void writeCsv(const char *path, const SensorLogRecord *recs, size_t n) {
+    const ColLogSchema *s = &sensorLogSchema;
+    FILE *f = fopen(path, "w");
+    for (uint8_t c = 0; c < s->count; c++) {
+        fprintf(f, c ? ",%s" : "%s", s->channels[c].name);
+    }
+    fputc('\n', f);
+    for (size_t i = 0; i < n; i++) {
+        const SensorLogRecord *r = &recs[i];
+        fprintf(f, "%lu,%u,%u,%u,%ld,%ld,%ld,%ld,%d,%d,%d,%d,%d,%d,%.9g,%lu,%u,%u,%u,%u,%u,%u\n",
+                (unsigned long)r->tick_ms, r->loop_us, r->enc[0], r->enc[1],
+                (long)r->quat[0], (long)r->quat[1], (long)r->quat[2], (long)r->quat[3],
+                r->accel[0], r->accel[1], r->accel[2], r->gyro[0], r->gyro[1], r->gyro[2],
+                r->range, (unsigned long)r->range_age_ms, r->flags, r->ncmd,
+                r->cmd[0], r->cmd[1], r->cmd[2], r->cmd[3]);
+    }
+    fclose(f);
+}
+
+/**
+  * @brief   解析 CSV 还原记录 | Parse the CSV back into records
+  */
+static size_t readCsv(const char *path, SensorLogRecord *recs, size_t max) {
+    const ColLogSchema *s = &sensorLogSchema;
+    FILE *f = fopen(path, "r");
+    char line[512];
+    size_t n = 0;
+    if (fgets(line, sizeof(line), f) == NULL) {
+        fclose(f);
+        return 0;
+    }
+    while (n < max && fgets(line, sizeof(line), f) != NULL) {
+        uint8_t *rec = (uint8_t *)&recs[n++];
+        memset(rec, 0, sizeof(SensorLogRecord));
+        char *p = line;
+        for (uint8_t c = 0; c < s->count; c++) {
+            const ColLogChannel *ch = &s->channels[c];
+            if (ch->type == COLLOG_F32) {
+                fp32 v = strtof(p, &p);
+                memcpy(rec + ch->offset, &v, 4);
+            } else {
+                long v = strtol(p, &p, 10);
+                memcpy(rec + ch->offset, &v, ColLog_TypeSize(ch->type));
+            }
+            p++;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+/**
+  * @brief   只取 CSV 中的一列求和：每行仍要扫到该列 | Sum one CSV column: every line is still scanned up to it
+  */
+static long sumCsvColumn(const char *path, int column) {
+    FILE *f = fopen(path, "r");
+    char line[512];
+    long sum = 0;
+    if (fgets(line, sizeof(line), f) != NULL) {
+        while (fgets(line, sizeof(line), f) != NULL) {
+            char *p = line;
+            for (int c = 0; c < column; c++) {
+                p = strchr(p, ',') + 1;
+            }
+            sum += strtol(p, NULL, 10);
+        }
+    }
+    fclose(f);
+    return sum;
+}
+
+/* 列式日志 | Columnar log --------------------------------------------------*/
+
+static int writeLog(const char *path, const SensorLogRecord *recs, size_t n) {
+    ColLogWriter w;
+    if (ColLogWriter_Open(&w, path, &sensorLogSchema) != COLLOG_OK) {
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        ColLogWriter_Append(&w, &recs[i]);
+    }
+    return ColLogWriter_Close(&w);
+}
+
+static size_t readLog(const char *path, SensorLogRecord *recs) {
+    ColLogReader log;
+    if (ColLog_Open(&log, path) != COLLOG_OK) {
+        return 0;
+    }
+    memset(recs, 0, log.records * sizeof(*recs));
+    for (uint8_t c = 0; c < log.schema.count; c++) {
+        ColLog_ReadColumn(&log, c, (uint8_t *)recs + log.schema.channels[c].offset, sizeof(SensorLogRecord));
+    }
+    size_t n = (size_t)log.records;
+    ColLog_Close(&log);
+    return n;
+}
+
+static long sumLogChannel(const char *path, const char *name, int16_t *buf) {
+    ColLogReader log;
+    long sum = 0;
+    if (ColLog_Open(&log, path) != COLLOG_OK) {
+        return 0;
+    }
+    int id = ColLog_Find(&log, name);
+    if (id >= 0) {
+        ColLog_ReadColumn(&log, (uint8_t)id, buf, sizeof(int16_t));
+        for (uint64_t i = 0; i < log.records; i++) {
+            sum += buf[i];
+        }
+    }
+    ColLog_Close(&log);
+    return sum;
+}
+
+static long fileSize(const char *path) {
+    FILE *f = fopen(path, "rb");
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+int main(int argc, char **argv) {
+    size_t n = 360000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            n = (size_t)atol(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [-n records]\n", argv[0]);
+            return 2;
+        }
+    }
+    SensorLogRecord *recs = malloc(n * sizeof(*recs));
+    SensorLogRecord *back = malloc(n * sizeof(*recs));
+    int16_t *column = malloc(n * sizeof(int16_t));
+    if (recs == NULL || back == NULL || column == NULL) {
+        perror("malloc");
+        return 1;
+    }
+    makeLog(recs, n);
+    long expected = 0;
+    for (size_t i = 0; i < n; i++) {
+        expected += recs[i].gyro[0];
+    }
+
+    char csvPath[] = "/tmp/dnb_collog_XXXXXX";
+    char logPath[] = "/tmp/dnb_collog_XXXXXX";
+    close(mkstemp(csvPath));
+    close(mkstemp(logPath));
+    remove(logPath);
+    int failures = 0;
+
+    double t0 = now();
+    writeCsv(csvPath, recs, n);
+    double csvWrite = now() - t0;
+    t0 = now();
+    int ret = writeLog(logPath, recs, n);
+    double logWrite = now() - t0;
+
+    t0 = now();
+    size_t csvCount = readCsv(csvPath, back, n);
+    double csvRead = now() - t0;
+    if (csvCount != n || memcmp(back, recs, n * sizeof(*recs)) != 0) {
+        printf("FAIL: CSV round trip\n");
+        failures++;
+    }
+    t0 = now();
+    size_t logCount = ret == COLLOG_OK ? readLog(logPath, back) : 0;
+    double logRead = now() - t0;
+    if (logCount != n || memcmp(back, recs, n * sizeof(*recs)) != 0) {
+        printf("FAIL: columnar round trip\n");
+        failures++;
+    }
+
+    int gyroColumn = 0;
+    while (strcmp(sensorLogSchema.channels[gyroColumn].name, "gyro_x") != 0) gyroColumn++;
+    t0 = now();
+    long csvSum = sumCsvColumn(csvPath, gyroColumn);
+    double csvOne = now() - t0;
+    t0 = now();
+    long logSum = sumLogChannel(logPath, "gyro_x", column);
+    double logOne = now() - t0;
+    if (csvSum != expected || logSum != expected) {
+        printf("FAIL: gyro_x sum %ld / %ld, expected %ld\n", csvSum, logSum, expected);
+        failures++;
+    }
+
+    long csvSize = fileSize(csvPath), logSize = fileSize(logPath);
+    double raw = (double)n * sizeof(SensorLogRecord);
+    printf("%zu records, %.1f MB as raw structs\n", n, raw / 1e6);
+    printf("%-10s %12s %10s %12s %12s %12s\n", "format", "size (MB)", "B/record", "write (ms)", "read (ms)", "gyro_x (ms)");
+    printf("%-10s %12.2f %10.1f %12.1f %12.1f %12.1f\n", "csv", csvSize / 1e6, (double)csvSize / (double)n,
+           csvWrite * 1e3, csvRead * 1e3, csvOne * 1e3);
+    printf("%-10s %12.2f %10.1f %12.1f %12.1f %12.1f\n", "columnar", logSize / 1e6, (double)logSize / (double)n,
+           logWrite * 1e3, logRead * 1e3, logOne * 1e3);
+    printf("columnar vs csv: %.1fx smaller, write %.1fx, read %.1fx, one channel %.1fx faster\n",
+           (double)csvSize / (double)logSize, csvWrite / logWrite, csvRead / logRead, csvOne / logOne);
+
+    remove(csvPath);
+    remove(logPath);
+    free(recs);
+    free(back);
+    free(column);
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
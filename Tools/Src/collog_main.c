@@ -0,0 +1,242 @@
+/**
+  * @file    collog_main.c
+  * @brief   列式日志工具 | Columnar log tool
+  *
+  * @note    用法 | Usage:
+  *          dnb_collog <capture> -o <log.dnbc> [-s sensor_log|telemetry]
+  *          dnb_collog --info <log.dnbc>
+  *          dnb_collog --csv <log.dnbc> [channel,channel,...]
+  *          dnb_collog --stats <log.dnbc> [channel,channel,...]
+  *          第一种形式把抓包（dnb_telemetry -r 的原始字节）中的一种记录追加到列式日志，默认传感器日志
+  *          The first form appends one record kind from a capture (raw bytes from dnb_telemetry -r)
+  *          to a columnar log, the sensor log by default
+  *          --info   结构、块数、各通道的字节数与每个值的平均字节数，并校验所有块
+  *                   Schema, chunk count, bytes per channel and average bytes per value; checks every chunk
+  *          --csv    按 CSV 输出所选通道（默认全部） | Print the chosen channels (all by default) as CSV
+  *          --stats  所选通道的最小值、最大值、均值与标准差 | Min, max, mean and standard deviation of the chosen channels
+  *          --csv 与 --stats 只解码所选通道 | --csv and --stats decode only the chosen channels
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "collog.h"
+#include "log_schema.h"
+#include "protocol.h"
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s <capture> -o <log.dnbc> [-s sensor_log|telemetry]\n"
+                    "       %s --info <log.dnbc>\n"
+                    "       %s --csv <log.dnbc> [channel,...]\n"
+                    "       %s --stats <log.dnbc> [channel,...]\n", prog, prog, prog, prog);
+    exit(2);
+}
+
+static int convert(const char *capture, const char *path, const char *stream) {
+    const ColLogSchema *schema;
+    uint8_t type;
+    if (strcmp(stream, "telemetry") == 0) {
+        schema = &telemetryLogSchema;
+        type = MSG_TELEMETRY;
+    } else if (strcmp(stream, "sensor_log") == 0) {
+        schema = &sensorLogSchema;
+        type = MSG_SENSOR_LOG;
+    } else {
+        fprintf(stderr, "unknown stream '%s'\n", stream);
+        return 2;
+    }
+
+    FILE *in = fopen(capture, "rb");
+    if (in == NULL) {
+        perror(capture);
+        return 1;
+    }
+    ColLogWriter w;
+    int ret = ColLogWriter_Open(&w, path, schema);
+    if (ret != COLLOG_OK) {
+        fprintf(stderr, "%s: %s\n", path, ret == COLLOG_ERR_SCHEMA ? "holds a different stream" : "cannot open");
+        fclose(in);
+        return 1;
+    }
+    uint64_t before = w.records;
+
+    FrameParser parser;
+    FrameParser_Init(&parser);
+    Frame frame;
+    uint8_t buf[4096];
+    uint8_t rec[PROTOCOL_MAX_PAYLOAD];
+    unsigned long lost = 0, shortRecords = 0;
+    int lastSeq = -1;
+    size_t n;
+    while (ret == COLLOG_OK && (n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        for (size_t i = 0; i < n && ret == COLLOG_OK; i++) {
+            if (!FrameParser_Feed(&parser, buf[i], &frame) || frame.type != type) {
+                continue;
+            }
+            if (lastSeq >= 0) {
+                lost += (uint8_t)(frame.seq - lastSeq - 1);
+            }
+            lastSeq = frame.seq;
+            // 旧固件的记录可能更短，缺失字段补零 | Records from older firmware may be shorter; missing fields are zero
+            memset(rec, 0, schema->recordSize);
+            if (frame.len < schema->recordSize) shortRecords++;
+            memcpy(rec, frame.payload, frame.len < schema->recordSize ? frame.len : schema->recordSize);
+            ret = ColLogWriter_Append(&w, rec);
+        }
+    }
+    fclose(in);
+    uint64_t added = w.records + w.pending - before;
+    if (ColLogWriter_Close(&w) != COLLOG_OK || ret != COLLOG_OK) {
+        perror(path);
+        return 1;
+    }
+    printf("%llu %s records appended (%lu lost, %lu short, %lu crc errors), %llu in the log\n",
+           (unsigned long long)added, stream, lost, shortRecords, (unsigned long)parser.crcErrors,
+           (unsigned long long)w.records);
+    return 0;
+}
+
+static int info(const ColLogReader *log) {
+    const ColLogSchema *s = &log->schema;
+    printf("stream %s, %u-byte records, %u channels\n", s->stream, s->recordSize, s->count);
+    printf("%llu records in %u chunks, %zu bytes (%.2f bytes/record)\n", (unsigned long long)log->records,
+           log->chunkCount, log->size, log->records ? (double)log->size / (double)log->records : 0.0);
+    if (log->validBytes < log->size) {
+        printf("damaged tail: %zu bytes after the last intact chunk\n", log->size - log->validBytes);
+    }
+    uint32_t bad = ColLog_Verify(log);
+    if (bad < log->chunkCount) {
+        printf("chunk %u fails its CRC\n", bad);
+    }
+    printf("%-16s %-4s %12s %10s\n", "channel", "type", "bytes", "B/value");
+    for (uint8_t c = 0; c < s->count; c++) {
+        uint64_t bytes = 0;
+        for (uint32_t i = 0; i < log->chunkCount; i++) {
+            bytes += log->chunks[i].length[c];
+        }
+        printf("%-16s %-4s %12llu %10.2f\n", s->channels[c].name, ColLog_TypeName(s->channels[c].type),
+               (unsigned long long)bytes, log->records ? (double)bytes / (double)log->records : 0.0);
+    }
+    return bad < log->chunkCount ? 1 : 0;
+}
+
+/**
+  * @brief   解析通道列表并解码这些通道 | Parse a channel list and decode those channels
+  * @return  通道数，出错返回 -1 | Channel count, -1 on error
+  */
+static int selectChannels(const ColLogReader *log, const char *list, uint8_t *ids, uint32_t **values) {
+    int n = 0;
+    if (list == NULL) {
+        for (uint8_t c = 0; c < log->schema.count; c++) {
+            if (n >= COLLOG_MAX_CHANNELS) {
+                fprintf(stderr, "more than %d channels\n", COLLOG_MAX_CHANNELS);
+                return -1;
+            }
+            ids[n++] = c;
+        }
+    } else {
+        char buf[1024];
+        snprintf(buf, sizeof(buf), "%s", list);
+        for (char *name = strtok(buf, ","); name != NULL; name = strtok(NULL, ",")) {
+            int id = ColLog_Find(log, name);
+            if (id < 0 || n >= COLLOG_MAX_CHANNELS) {
+                fprintf(stderr, "no channel '%s'\n", name);
+                return -1;
+            }
+            ids[n++] = (uint8_t)id;
+        }
+    }
+    // 每个值按 4 字节存放，窄类型只用低位 | Every value gets 4 bytes; narrow types use the low ones
+    for (int i = 0; i < n; i++) {
+        values[i] = calloc(log->records ? log->records : 1, sizeof(uint32_t));
+        if (values[i] == NULL) return -1;
+        ColLog_ReadColumn(log, ids[i], values[i], sizeof(uint32_t));
+    }
+    return n;
+}
+
+static void printValue(uint8_t type, const uint32_t *v) {
+    double d = ColLog_ToDouble(type, v);
+    if (type == COLLOG_F32) {
+        printf("%.9g", d);
+    } else {
+        printf("%.0f", d);
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *mode = NULL, *input = NULL, *outPath = NULL, *channels = NULL;
+    const char *stream = "sensor_log";
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--info") == 0 || strcmp(argv[i], "--csv") == 0 || strcmp(argv[i], "--stats") == 0) &&
+            i + 1 < argc) {
+            mode = argv[i];
+            input = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') channels = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            stream = argv[++i];
+        } else if (argv[i][0] != '-' && input == NULL) {
+            input = argv[i];
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (input == NULL || (mode == NULL && outPath == NULL)) {
+        usage(argv[0]);
+    }
+    if (mode == NULL) {
+        return convert(input, outPath, stream);
+    }
+
+    ColLogReader log;
+    int ret = ColLog_Open(&log, input);
+    if (ret != COLLOG_OK) {
+        if (ret == COLLOG_ERR_IO) perror(input);
+        else fprintf(stderr, "%s: not a columnar log\n", input);
+        return 1;
+    }
+    if (strcmp(mode, "--info") == 0) {
+        ret = info(&log);
+        ColLog_Close(&log);
+        return ret;
+    }
+
+    uint8_t ids[COLLOG_MAX_CHANNELS];
+    uint32_t *values[COLLOG_MAX_CHANNELS] = {0};
+    int n = selectChannels(&log, channels, ids, values);
+    if (n > 0 && strcmp(mode, "--csv") == 0) {
+        for (int c = 0; c < n; c++) {
+            printf(c > 0 ? ",%s" : "%s", log.schema.channels[ids[c]].name);
+        }
+        putchar('\n');
+        for (uint64_t r = 0; r < log.records; r++) {
+            for (int c = 0; c < n; c++) {
+                if (c > 0) putchar(',');
+                printValue(log.schema.channels[ids[c]].type, &values[c][r]);
+            }
+            putchar('\n');
+        }
+    } else if (n > 0) {
+        printf("%-16s %14s %14s %14s %14s\n", "channel", "min", "max", "mean", "std");
+        for (int c = 0; c < n; c++) {
+            uint8_t type = log.schema.channels[ids[c]].type;
+            double lo = INFINITY, hi = -INFINITY, sum = 0.0, sumSq = 0.0;
+            for (uint64_t r = 0; r < log.records; r++) {
+                double v = ColLog_ToDouble(type, &values[c][r]);
+                lo = fmin(lo, v);
+                hi = fmax(hi, v);
+                sum += v;
+                sumSq += v * v;
+            }
+            double mean = log.records ? sum / (double)log.records : 0.0;
+            double var = log.records ? sumSq / (double)log.records - mean * mean : 0.0;
+            printf("%-16s %14.6g %14.6g %14.6g %14.6g\n", log.schema.channels[ids[c]].name, lo, hi, mean,
+                   sqrt(var > 0.0 ? var : 0.0));
+        }
+    }
+    for (int c = 0; c < n; c++) free(values[c]);
+    ColLog_Close(&log);
+    return n > 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/**
+  * @file    collog_test.c
+  * @brief   列式日志的自检 | Self-check of the columnar log
+  *
+  * @note    用法 | Usage: dnb_collog_test
+  *          检查：
+  *          1. 跨多个块、含极值（整型边界、NaN、u32 回绕）的记录逐位还原，单通道可读成紧凑数组；
+  *          2. 关闭后重新打开继续追加，结构不同的流被拒绝，非日志文件报格式错误；
+  *          3. 最后一块写了一半或校验失败时被丢弃，写入端重新打开时截掉它继续追加；
+  *          4. 中间块损坏由 ColLog_Verify 报告。
+  *          Checks:
+  *          1. records spanning several chunks, extremes included (integer limits, NaN, u32
+  *             wrap-around), come back bit-identical, and one channel reads into a dense array;
+  *          2. a closed log reopens for appending, a different stream is refused, and a file that
+  *             is not a log reports a format error;
+  *          3. a half-written or corrupt last chunk is dropped, and the writer cuts it off when
+  *             reopening and keeps appending;
+  *          4. a damaged middle chunk is reported by ColLog_Verify.
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "collog.h"
+#include "log_schema.h"
+#include "sensor_log.h"
+#include "telemetry.h"
+#include "check.h"
+
+#define RECORDS     (2 * COLLOG_CHUNK_RECORDS + 123)
+
+static char path[] = "/tmp/dnb_collog_test_XXXXXX";
+
+static SensorLogRecord source[2 * RECORDS];
+static SensorLogRecord back[2 * RECORDS];
+
+static void makeRecords(SensorLogRecord *recs, size_t n, uint32_t seed) {
+    memset(recs, 0, n * sizeof(*recs));
+    for (size_t i = 0; i < n; i++) {
+        SensorLogRecord *r = &recs[i];
+        seed = seed * 1664525u + 1013904223u;
+        r->tick_ms = 0xFFFFFF00u + 10 * (uint32_t)i;     // 中途回绕 | Wraps part-way
+        r->loop_us = 10000;
+        r->enc[0] = (uint16_t)(seed >> 20);
+        r->enc[1] = (uint16_t)(0 - (i & 3));
+        r->quat[0] = (i & 1) ? INT32_MIN : INT32_MAX;       // 最大的差值 | Largest possible deltas
+        r->quat[1] = (int32_t)seed;
+        r->accel[2] = (int16_t)(i % 3 == 0 ? INT16_MIN : INT16_MAX);
+        r->gyro[0] = (int16_t)(seed >> 16);
+        r->range = (i % 97 == 0) ? NAN : (fp32)i * 0.37f;
+        r->range_age_ms = (uint32_t)i;
+        r->flags = (uint8_t)seed;
+        r->ncmd = (uint8_t)(i % 5);
+        r->cmd[3] = 0xFF;
+    }
+}
+
+static size_t readAll(ColLogReader *log, SensorLogRecord *recs) {
+    memset(recs, 0, (size_t)log->records * sizeof(*recs));
+    for (uint8_t c = 0; c < log->schema.count; c++) {
+        ColLog_ReadColumn(log, c, (uint8_t *)recs + log->schema.channels[c].offset, sizeof(SensorLogRecord));
+    }
+    return (size_t)log->records;
+}
+
+static int writeRecords(const SensorLogRecord *recs, size_t n) {
+    ColLogWriter w;
+    int ret = ColLogWriter_Open(&w, path, &sensorLogSchema);
+    if (ret != COLLOG_OK) return ret;
+    for (size_t i = 0; i < n; i++) {
+        ColLogWriter_Append(&w, &recs[i]);
+    }
+    return ColLogWriter_Close(&w);
+}
+
+static void testRoundTrip(void) {
+    printf("round trip\n");
+    remove(path);
+    makeRecords(source, RECORDS, 1);
+    CHECK(writeRecords(source, RECORDS) == COLLOG_OK, "write failed");
+
+    ColLogReader log;
+    CHECK(ColLog_Open(&log, path) == COLLOG_OK, "open failed");
+    printf("  %llu records in %u chunks, %zu bytes\n", (unsigned long long)log.records, log.chunkCount, log.size);
+    CHECK(log.records == RECORDS && log.chunkCount == 3, "%llu records in %u chunks", (unsigned long long)log.records, log.chunkCount);
+    CHECK(strcmp(log.schema.stream, "sensor_log") == 0 && log.schema.count == sensorLogSchema.count, "schema not restored");
+    CHECK(log.validBytes == log.size && ColLog_Verify(&log) == log.chunkCount, "intact log reported damaged");
+    CHECK(readAll(&log, back) == RECORDS && memcmp(back, source, RECORDS * sizeof(*source)) == 0, "records differ");
+
+    int id = ColLog_Find(&log, "gyro_x");
+    int16_t *gyro = malloc(RECORDS * sizeof(int16_t));
+    CHECK(id >= 0 && ColLog_ReadColumn(&log, (uint8_t)id, gyro, sizeof(int16_t)) == COLLOG_OK, "gyro_x not readable");
+    int same = 1;
+    for (size_t i = 0; i < RECORDS; i++) same &= gyro[i] == source[i].gyro[0];
+    CHECK(same, "dense gyro_x differs");
+    CHECK(ColLog_Find(&log, "nope") == COLLOG_ERR_CHANNEL, "unknown channel found");
+    CHECK(ColLog_ReadColumn(&log, log.schema.count, gyro, 2) == COLLOG_ERR_CHANNEL, "channel index not checked");
+    free(gyro);
+    ColLog_Close(&log);
+}
+
+static void testAppend(void) {
+    printf("append\n");
+    makeRecords(source + RECORDS, RECORDS, 2);
+    CHECK(writeRecords(source + RECORDS, RECORDS) == COLLOG_OK, "reopen for append failed");
+
+    ColLogReader log;
+    CHECK(ColLog_Open(&log, path) == COLLOG_OK, "open failed");
+    printf("  %llu records in %u chunks\n", (unsigned long long)log.records, log.chunkCount);
+    CHECK(readAll(&log, back) == 2 * RECORDS && memcmp(back, source, sizeof(source)) == 0, "appended records differ");
+    ColLog_Close(&log);
+
+    ColLogWriter w;
+    CHECK(ColLogWriter_Open(&w, path, &telemetryLogSchema) == COLLOG_ERR_SCHEMA, "different stream accepted");
+
+    char other[] = "/tmp/dnb_collog_test_XXXXXX";
+    int fd = mkstemp(other);
+    CHECK(write(fd, "not a log at all, just text\n", 28) == 28, "write failed");
+    close(fd);
+    CHECK(ColLog_Open(&log, other) == COLLOG_ERR_FORMAT, "text file opened as a log");
+    CHECK(ColLogWriter_Open(&w, other, &sensorLogSchema) == COLLOG_ERR_FORMAT, "text file appended to");
+    remove(other);
+}
+
+static void corrupt(long offset) {
+    FILE *f = fopen(path, "r+b");
+    fseek(f, offset, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, offset, SEEK_SET);
+    fputc(c ^ 0x40, f);
+    fclose(f);
+}
+
+static void testDamage(void) {
+    printf("damaged tail\n");
+    ColLogReader log;
+    CHECK(ColLog_Open(&log, path) == COLLOG_OK, "open failed");
+    ColLogChunk last = log.chunks[log.chunkCount - 1];
+    ColLogChunk middle = log.chunks[1];
+    uint64_t records = log.records;
+    size_t size = log.size;
+    ColLog_Close(&log);
+
+    // 掉电：最后一块只写了一半 | Power cut: the last chunk is half-written
+    CHECK(truncate(path, (off_t)(last.offset + last.size / 2)) == 0, "truncate failed");
+    CHECK(ColLog_Open(&log, path) == COLLOG_OK, "open failed");
+    printf("  half chunk: %llu records, %zu of %zu bytes valid\n", (unsigned long long)log.records, log.validBytes, log.size);
+    CHECK(log.records == records - last.records && log.validBytes == last.offset, "half chunk not dropped");
+    ColLog_Close(&log);
+
+    // 长度完整但内容是零（有些文件系统掉电后如此） | Full length but zeros, as some filesystems leave it
+    CHECK(truncate(path, (off_t)size) == 0, "extend failed");
+    CHECK(ColLog_Open(&log, path) == COLLOG_OK && log.records == records - last.records, "zeroed chunk not dropped");
+    ColLog_Close(&log);
+
+    // 写入端截掉它再追加 | The writer cuts it off and appends
+    CHECK(writeRecords(source + 2 * RECORDS - last.records, last.records) == COLLOG_OK, "append after damage failed");
+    CHECK(ColLog_Open(&log, path) == COLLOG_OK, "open failed");
+    CHECK(log.size == size && readAll(&log, back) == 2 * RECORDS && memcmp(back, source, sizeof(source)) == 0,
+          "log not restored after append");
+    ColLog_Close(&log);
+
+    // 最后一块的一个位错 | One flipped bit in the last chunk
+    corrupt((long)(last.offset + last.size - 10));
+    CHECK(ColLog_Open(&log, path) == COLLOG_OK && log.records == records - last.records, "corrupt last chunk kept");
+    ColLog_Close(&log);
+
+    printf("damaged middle\n");
+    corrupt((long)(middle.column[3] + 1));
+    CHECK(ColLog_Open(&log, path) == COLLOG_OK, "open failed");
+    uint32_t bad = ColLog_Verify(&log);
+    printf("  first damaged chunk %u of %u\n", bad, log.chunkCount);
+    CHECK(bad == 1, "Verify reported chunk %u", bad);
+    ColLog_Close(&log);
+}
+
+int main(void) {
+    close(mkstemp(path));
+    remove(path);
+    testRoundTrip();
+    testAppend();
+    testDamage();
+    remove(path);
+    return Check_Exit();
+}
@@ -0,0 +1,182 @@
+/**
+  * @file    dc_motor.c
+  * @brief   高保真直流减速电机模型 | High-fidelity DC gear motor model
+  */
+#include <math.h>
+#include <string.h>
+#include "dc_motor.h"
+
+#define MAX_STEP        5e-5        /**< 机械积分步长上限 (s) | Mechanical integration step limit */
+#define STICK_SPEED     1e-3        /**< 低于该转速可被静摩擦粘住 (rad/s) | Below this speed static friction can hold the rotor */
+
+enum { PHASE_BRAKE, PHASE_DRIVE, PHASE_COAST };
+
+/*
+ * 预设来自 JGB37-520（330 rpm、1:30、13 线霍尔编码器）的数据手册和 TB6612 的典型值，
+ * 是拟合台架数据的起点：空载转速、堵转电流和自由停转时间测出来后改这里即可。
+ * "ideal" 的堵转力矩和空载转速与线性模型相同，没有摩擦和间隙，只用来单独看 H 桥的影响。
+ * The presets come from the JGB37-520 datasheet (330 rpm, 1:30, 13-line hall encoder) and
+ * TB6612 typical values, as a starting point for fitting bench data: measure the no-load
+ * speed, stall current and coast-down time and adjust them here. "ideal" has the linear
+ * model's stall torque and no-load speed with no friction or backlash, to isolate the bridge.
+ * 转子惯量手册上没有，是最不确定的一项，而默认增益对它很敏感：折算到轮轴约 900 倍，
+ * 超过约 4e-7 kg·m² 后直立环进入明显的极限环，所以先取 2e-7，台架测出自由停转时间后再定。
+ * The rotor inertia is not in the datasheet and is the least certain value, and the default
+ * gains are sensitive to it: reflected to the axle it grows about 900x, and above about
+ * 4e-7 kg·m² the upright loop settles into a visible limit cycle, so 2e-7 stands in until a
+ * coast-down measurement pins it.
+ */
+static const DcMotorParams presets[] = {
+        {
+                .name = "ideal", .supply = 12.0, .resistance = 6.936, .inductance = 1e-4,
+                .kt = 0.01156, .gearRatio = 30.0, .rotorInertia = 1e-8,
+                .coulomb = 0.0, .viscous = 0.0, .backlash = 0.0, .gearStiffness = 100.0, .gearDamping = 0.01,
+                .diodeDrop = 0.7, .pwmHz = 1400.0, .quadratureError = 0.0
+        },
+        {
+                .name = "jgb37-520-330", .supply = 12.0, .resistance = 5.0, .inductance = 1.6e-3,
+                .kt = 0.0108, .gearRatio = 30.0, .rotorInertia = 2e-7,
+                .coulomb = 0.015, .viscous = 2e-4, .backlash = 0.035, .gearStiffness = 150.0, .gearDamping = 0.15,
+                .diodeDrop = 1.0, .pwmHz = 1400.0, .quadratureError = 0.1
+        },
+        {
+                .name = "jgb37-520-330-2s", .supply = 7.4, .resistance = 5.0, .inductance = 1.6e-3,
+                .kt = 0.0108, .gearRatio = 30.0, .rotorInertia = 2e-7,
+                .coulomb = 0.015, .viscous = 2e-4, .backlash = 0.035, .gearStiffness = 150.0, .gearDamping = 0.15,
+                .diodeDrop = 1.0, .pwmHz = 1400.0, .quadratureError = 0.1
+        },
+        {
+                .name = "jgb37-520-330-worn", .supply = 12.0, .resistance = 5.0, .inductance = 1.6e-3,
+                .kt = 0.0108, .gearRatio = 30.0, .rotorInertia = 2e-7,
+                .coulomb = 0.04, .viscous = 4e-4, .backlash = 0.09, .gearStiffness = 120.0, .gearDamping = 0.15,
+                .diodeDrop = 1.0, .pwmHz = 1400.0, .quadratureError = 0.2
+        },
+};
+
+#define PRESET_COUNT ((int)(sizeof(presets) / sizeof(presets[0])))
+
+const DcMotorParams *DcMotor_Preset(const char *name) {
+    for (int i = 0; i < PRESET_COUNT; i++) {
+        if (strcmp(presets[i].name, name) == 0) {
+            return &presets[i];
+        }
+    }
+    return NULL;
+}
+
+const DcMotorParams *DcMotor_PresetAt(int index) {
+    return index >= 0 && index < PRESET_COUNT ? &presets[index] : NULL;
+}
+
+void DcMotor_Init(DcMotor *self, const DcMotorParams *p, double wheel) {
+    *self = (DcMotor){.p = *p, .rotor = wheel};
+}
+
+static double clamp01(double x) {
+    return x < 0.0 ? 0.0 : (x > 1.0 ? 1.0 : x);
+}
+
+/**
+  * @brief   齿轮传递的力矩：齿隙内为零，啮合后为弹簧加阻尼，且不会把齿拉开 | Gear torque: zero inside the backlash, spring plus damper in mesh, never pulling the teeth apart
+  */
+static double gearTorque(const DcMotorParams *p, double delta, double rel) {
+    double gap = 0.5 * p->backlash;
+    if (delta > gap) {
+        double t = p->gearStiffness * (delta - gap) + p->gearDamping * rel;
+        return t > 0.0 ? t : 0.0;
+    }
+    if (delta < -gap) {
+        double t = p->gearStiffness * (delta + gap) + p->gearDamping * rel;
+        return t < 0.0 ? t : 0.0;
+    }
+    return 0.0;
+}
+
+double DcMotor_Step(DcMotor *self, HBridge cmd, double wheel, double wheelSpeed, double h) {
+    const DcMotorParams *p = &self->p;
+    const double period = 1.0 / p->pwmHz;
+    const double in1 = clamp01(cmd.in1), in2 = clamp01(cmd.in2);
+    const double brakeEnd = fmin(in1, in2), driveEnd = fmax(in1, in2);
+    const double driveV = in1 > in2 ? p->supply : -p->supply;
+    const double clampV = p->supply + 2.0 * p->diodeDrop;
+    const double ke = p->kt * p->gearRatio;             // 轮轴侧：V/(rad/s) = N·m/A | Wheel side
+    const double tauE = p->inductance / p->resistance;
+    const double jr = p->rotorInertia * p->gearRatio * p->gearRatio;
+    double t = 0.0, impulse = 0.0;
+
+    while (t < h - 1e-12) {
+        double ph = self->pwmPhase, end;
+        int phase;
+        if (ph < brakeEnd) {
+            phase = PHASE_BRAKE;
+            end = brakeEnd;
+        } else if (ph < driveEnd) {
+            phase = PHASE_DRIVE;
+            end = driveEnd;
+        } else {
+            phase = PHASE_COAST;
+            end = 1.0;
+        }
+        double toEdge = (end - ph) * period;
+        double seg = fmin(fmin(toEdge, h - t), MAX_STEP);
+
+        // 端电压 | Terminal voltage
+        double emf = ke * self->rotorSpeed, vt;
+        if (phase == PHASE_BRAKE) {
+            vt = 0.0;
+        } else if (phase == PHASE_DRIVE) {
+            vt = driveV;
+        } else if (self->current != 0.0) {
+            vt = self->current > 0.0 ? -clampV : clampV;
+        } else if (fabs(emf) > clampV) {
+            vt = emf > 0.0 ? clampV : -clampV;      // 超速时反电势经二极管向电源充电 | Overspeed: the back-EMF charges the supply through the diodes
+        } else {
+            vt = emf;                               // 开路，电流保持为零 | Open circuit, the current stays zero
+        }
+
+        // 电流的解析解；滑行时电流过零即截止 | Exact current; a coasting current stops at zero
+        double iss = (vt - emf) / p->resistance, i0 = self->current;
+        int cutoff = 0;
+        if (phase == PHASE_COAST && i0 != 0.0 && (iss > 0.0) != (i0 > 0.0)) {
+            double tz = tauE * log((i0 - iss) / -iss);
+            if (tz < seg) {
+                seg = tz;
+                cutoff = 1;
+            }
+        }
+        double decay = exp(-seg / tauE);
+        double mean = seg > 0.0 ? iss + (i0 - iss) * tauE / seg * (1.0 - decay) : i0;
+        self->current = cutoff ? 0.0 : iss + (i0 - iss) * decay;
+        if (phase == PHASE_DRIVE) {
+            self->energy += driveV * mean * seg;
+        } else if (phase == PHASE_COAST) {
+            self->energy -= p->supply * fabs(mean) * seg;
+        }
+
+        // 转子：电磁力矩、齿轮力矩、摩擦 | Rotor: electromagnetic torque, gear torque, friction
+        double tg = gearTorque(p, self->rotor - (wheel + wheelSpeed * t), self->rotorSpeed - wheelSpeed);
+        double net = ke * mean - tg - p->viscous * self->rotorSpeed;
+        if (fabs(self->rotorSpeed) < STICK_SPEED && fabs(net) <= p->coulomb) {
+            self->rotorSpeed = 0.0;
+        } else {
+            double dir = self->rotorSpeed != 0.0 ? self->rotorSpeed : net;
+            double w = self->rotorSpeed + (net - copysign(p->coulomb, dir)) / jr * seg;
+            // 摩擦只能让转子停下，不能让它反转 | Friction can stop the rotor but not reverse it
+            if (self->rotorSpeed != 0.0 && (w > 0.0) != (self->rotorSpeed > 0.0) && fabs(net) <= p->coulomb) {
+                w = 0.0;
+            }
+            self->rotorSpeed = w;
+        }
+        self->rotor += self->rotorSpeed * seg;
+        impulse += tg * seg;
+
+        t += seg;
+        // 到达 PWM 边沿时直接落在边沿上，避免舍入留下极短的段 | Land exactly on a PWM edge so rounding leaves no sliver segments
+        self->pwmPhase = seg == toEdge ? end : ph + seg / period;
+        if (self->pwmPhase >= 1.0) {
+            self->pwmPhase = 0.0;
+        }
+    }
+    self->torque = impulse / h;
+    return self->torque;
+}
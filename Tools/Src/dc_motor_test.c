@@ -0,0 +1,220 @@
+/**
+  * @file    dc_motor_test.c
+  * @brief   高保真电机模型的自检 | Self-check of the high-fidelity motor model
+  *
+  * @note    用法 | Usage: dnb_dc_motor_test
+  *          电机带一个只有惯量的轮子（或把轮子固定住）单独运行，检查：
+  *          1. 满占空比下的空载转速与堵转力矩符合 V/k_e 与 V·k_e/R；
+  *          2. 短路制动比滑行停得快；
+  *          3. 反向时转子先走过齿隙，期间轮子不受力；
+  *          4. 低占空比空转时电流断续且从不反向，转速高于占空比乘空载转速；
+  *          5. 编码器在电机轴上按 x4 计数，每圈 encoderCpr 个，B 相边沿偏移按奇数计数生效；
+  *          6. 每个预设下完整的小车都不会倒。
+  *          Runs the motor on its own against an inertia-only wheel (or with the wheel held) and
+  *          checks:
+  *          1. no-load speed and stall torque at full duty match V/k_e and V·k_e/R;
+  *          2. a short brake stops faster than coasting;
+  *          3. on reversal the rotor crosses the backlash first, with no torque on the wheel;
+  *          4. idling at low duty the current is discontinuous and never reverses, and the
+  *             speed is above duty times the no-load speed;
+  *          5. the encoder counts x4 on the motor shaft, encoderCpr per turn, with the B-phase
+  *             edge offset applying on odd counts;
+  *          6. the whole car stays up with every preset.
+  */
+#include <math.h>
+#include <stdio.h>
+#include "robot.h"
+#include "dc_motor.h"
+#include "check.h"
+
+#define PI          3.14159265358979
+#define WHEEL_J     2e-4            /**< 试验轮惯量，轮轴侧 (kg·m²) | Test wheel inertia at the axle */
+#define H           1e-4            /**< 试验步长 (s) | Test step */
+
+/**
+  * @brief   电机带惯量轮运行 | Motor driving an inertia-only wheel
+  */
+typedef struct {
+    DcMotor m;
+    double wheel, speed;
+} Rig;
+
+static void rigStep(Rig *r, HBridge cmd, double seconds) {
+    for (double t = 0.0; t < seconds - 1e-9; t += H) {
+        double tq = DcMotor_Step(&r->m, cmd, r->wheel, r->speed, H);
+        r->wheel += r->speed * H;
+        r->speed += tq / WHEEL_J * H;
+    }
+}
+
+static const DcMotorParams *preset(const char *name) {
+    const DcMotorParams *p = DcMotor_Preset(name);
+    if (!p) {
+        printf("  missing preset %s\n", name);
+        failures++;
+    }
+    return p;
+}
+
+static void testSpeedAndStall(const char *name, double tolerance) {
+    const DcMotorParams *p = preset(name);
+    if (!p) return;
+    const double ke = p->kt * p->gearRatio;
+
+    Rig r = {0};
+    DcMotor_Init(&r.m, p, 0.0);
+    rigStep(&r, (HBridge){1.0, 0.0}, 2.0);
+    double noLoad = p->supply / ke;
+    printf("  %-20s no-load %6.2f rad/s (V/k_e %6.2f)", name, r.speed, noLoad);
+    CHECK(fabs(r.speed - noLoad) < tolerance * noLoad, "%s no-load speed %.2f vs %.2f", name, r.speed, noLoad);
+
+    // 轮子固定 | Wheel held
+    DcMotor m;
+    DcMotor_Init(&m, p, 0.0);
+    double tq = 0.0;
+    for (int k = 0; k < 5000; k++) {
+        tq = DcMotor_Step(&m, (HBridge){1.0, 0.0}, 0.0, 0.0, H);
+    }
+    double stall = p->supply * ke / p->resistance;
+    printf("   stall %5.3f N·m (V·k_e/R %5.3f)\n", tq, stall);
+    CHECK(fabs(tq - stall) < tolerance * stall, "%s stall torque %.3f vs %.3f", name, tq, stall);
+}
+
+static void testBrakeVsCoast(void) {
+    const DcMotorParams *p = preset("jgb37-520-330");
+    if (!p) return;
+    double stop[2];
+    const HBridge cmd[2] = {{1.0, 1.0}, {0.0, 0.0}};
+    for (int k = 0; k < 2; k++) {
+        Rig r = {0};
+        DcMotor_Init(&r.m, p, 0.0);
+        rigStep(&r, (HBridge){1.0, 0.0}, 1.0);
+        double v0 = r.speed, t = 0.0;
+        while (r.speed > 0.1 * v0 && t < 5.0) {
+            rigStep(&r, cmd[k], 0.001);
+            t += 0.001;
+        }
+        stop[k] = t;
+    }
+    printf("  90%% stop from full speed: brake %.3f s, coast %.3f s\n", stop[0], stop[1]);
+    CHECK(stop[0] * 3.0 < stop[1], "brake %.3f s is not well ahead of coast %.3f s", stop[0], stop[1]);
+}
+
+static void testBacklash(void) {
+    const DcMotorParams *p = preset("jgb37-520-330");
+    if (!p) return;
+    const double gap = 0.5 * p->backlash;
+    DcMotor m;
+    DcMotor_Init(&m, p, 0.0);
+    for (int k = 0; k < 2000; k++) {
+        DcMotor_Step(&m, (HBridge){0.3, 0.0}, 0.0, 0.0, H);
+    }
+    CHECK(m.rotor > gap && m.torque > 0.0, "forward drive did not mesh: rotor %.4f torque %.4f", m.rotor, m.torque);
+
+    // 反向：轮子固定，转子先空走过齿隙 | Reverse with the wheel held: the rotor first crosses the backlash freely
+    double start = m.rotor, lastFree = start;
+    int freeSteps = 0;
+    for (int k = 0; k < 5000 && m.torque >= 0.0; k++) {
+        DcMotor_Step(&m, (HBridge){0.0, 0.3}, 0.0, 0.0, H);
+        if (m.torque == 0.0) {
+            freeSteps++;
+            lastFree = m.rotor;
+        }
+    }
+    printf("  reversal: %d free steps, rotor %.4f -> %.4f rad (backlash %.4f)\n",
+           freeSteps, start, lastFree, p->backlash);
+    CHECK(freeSteps > 0 && start - lastFree > 0.9 * p->backlash - (start - gap),
+          "no dead zone on reversal (%d free steps, travel %.4f)", freeSteps, start - lastFree);
+    CHECK(m.torque < 0.0, "reverse drive never meshed");
+}
+
+static void testDiscontinuous(void) {
+    const DcMotorParams *p = preset("jgb37-520-330");
+    if (!p) return;
+    const double duty = 0.15;
+    Rig r = {0};
+    DcMotor_Init(&r.m, p, 0.0);
+    rigStep(&r, (HBridge){duty, 0.0}, 3.0);
+
+    // 再走 10 个 PWM 周期，细步长采样电流 | Ten more PWM periods, sampling the current finely
+    double minI = 1e9, maxI = -1e9;
+    int zero = 0, samples = 0;
+    for (double t = 0.0; t < 10.0 / p->pwmHz; t += 1e-5) {
+        DcMotor_Step(&r.m, (HBridge){duty, 0.0}, r.wheel, r.speed, 1e-5);
+        minI = fmin(minI, r.m.current);
+        maxI = fmax(maxI, r.m.current);
+        zero += r.m.current == 0.0;
+        samples++;
+    }
+    double noLoad = p->supply / (p->kt * p->gearRatio);
+    printf("  %.0f%% duty idle: %.2f rad/s (%.0f%% of no-load), current %.3f..%.3f A, zero %d%% of the time\n",
+           duty * 100.0, r.speed, r.speed / noLoad * 100.0, minI, maxI, zero * 100 / samples);
+    CHECK(minI >= 0.0, "coasting current reversed (%.4f A)", minI);
+    CHECK(zero > 0, "current never reached zero at %.0f%% duty", duty * 100.0);
+    CHECK(r.speed > 1.2 * duty * noLoad, "idle speed %.2f is not well above duty x no-load %.2f", r.speed, duty * noLoad);
+}
+
+static void testEncoder(void) {
+    const DcMotorParams *p = preset("jgb37-520-330");
+    if (!p) return;
+    PlantParams pp = Plant_DefaultParams();
+    pp.motor = p;
+    pp.encoderScaleR = 0.0;
+    Plant plant;
+    Plant_Init(&plant, &pp, 0.0, 1);
+    int16_t left, right;
+
+    const double perCount = 2.0 * PI / pp.encoderCpr;
+    plant.motor[0].rotor = 2.0 * PI + 0.5 * perCount;
+    plant.motor[1].rotor = -2.0 * PI + 0.5 * perCount;
+    Plant_ReadEncoders(&plant, &left, &right);
+    printf("  one turn: %d and %d counts (cpr %.0f)\n", left, right, pp.encoderCpr);
+    CHECK(left == (int16_t)pp.encoderCpr && right == -(int16_t)pp.encoderCpr,
+          "one turn gave %d/%d counts", left, right);
+
+    // 奇数计数的边沿晚 quadratureError 个计数，偶数的不受影响 | Odd-count edges come quadratureError counts late, even ones are unaffected
+    const double e = p->quadratureError;
+    const double f[4] = {3.0 + 0.5 * e, 3.0 + 2.0 * e, 4.0 + 0.5 * e, 5.0 + 0.5 * e};
+    const int32_t expect[4] = {2, 3, 4, 4};
+    plant.motor[0].rotor = 0.0;
+    Plant_ReadEncoders(&plant, &left, &right);
+    for (int k = 0; k < 4; k++) {
+        plant.motor[0].rotor = f[k] * perCount;
+        Plant_ReadEncoders(&plant, &left, &right);
+        CHECK(plant.count[0] == expect[k], "%.3f counts read as %d, expected %d", f[k], plant.count[0], expect[k]);
+    }
+}
+
+static void testStanding(void) {
+    for (int k = 0; DcMotor_PresetAt(k); k++) {
+        PlantParams pp = Plant_DefaultParams();
+        pp.motor = DcMotor_PresetAt(k);
+        static Robot robot;
+        Robot_Init(&robot, &pp, 0.02, 7u);
+        double worst = 0.0;
+        for (int t = 0; t < (int)(5.0 / ROBOT_TICK); t++) {
+            Robot_Step(&robot);
+            worst = fmax(worst, fabs(robot.plant.theta));
+        }
+        printf("  %-20s standing 5 s: max pitch %.2f deg, drift %.1f cm\n",
+               pp.motor->name, worst * 180.0 / PI, robot.plant.x * 100.0);
+        CHECK(worst < 20.0 * PI / 180.0, "%s fell or nearly fell (%.1f deg)", pp.motor->name, worst * 180.0 / PI);
+    }
+}
+
+int main(void) {
+    printf("no-load speed and stall torque\n");
+    testSpeedAndStall("ideal", 0.01);
+    testSpeedAndStall("jgb37-520-330", 0.05);
+    printf("brake vs coast\n");
+    testBrakeVsCoast();
+    printf("backlash\n");
+    testBacklash();
+    printf("discontinuous current\n");
+    testDiscontinuous();
+    printf("encoder\n");
+    testEncoder();
+    printf("closed loop\n");
+    testStanding();
+    return Check_Exit();
+}
@@ -0,0 +1,208 @@
+/**
+  * @file    fleet_sim.c
+  * @brief   多实例闭环仿真：一个进程里并行推进成千上万台小车 | Multi-instance closed-loop simulation: thousands of cars in one process, in parallel
+  *
+  * @note    用法 | Usage:
+  *          dnb_fleet [-n robots] [-j threads] [-t seconds] [--check]
+  *          每台小车是一个独立的 Robot（模型 + 固件控制栈 + 电机内环），直立环增益按编号取
+  *          0.5..1.3 倍、噪声种子各不相同，运行同一段命令脚本。小车按编号平均分给各线程，
+  *          线程之间除只读的脚本外不共享任何数据。
+  *          Each car is an independent Robot (plant + firmware control stack + motor loops) with
+  *          an upright-loop gain of 0.5..1.3x picked by its index and its own noise seed, all
+  *          running the same command script. Cars are split evenly across the threads by index;
+  *          threads share nothing but the read-only script.
+  *          -n  小车数量（默认 4096） | Number of cars (default 4096)
+  *          -j  线程数（默认为 CPU 核数） | Threads (default: CPU cores)
+  *          -t  每台仿真时长（默认 8 s） | Simulated time per car (default 8 s)
+  *          --check  再用单线程跑一遍，结果必须逐位相同 | Run again on one thread; the results must be bit-identical
+  */
+#include <math.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "robot.h"
+#include "command.h"
+
+#define GAIN_STEPS      9               /**< 直立环增益档数 | Upright gain steps */
+
+typedef struct {
+    double time;
+    uint8_t cmd;
+} Event;
+
+/* 起步、加速、转弯、停车 | Launch, speed up, turn, stop */
+static const Event script[] = {
+        {0.5, CMD_FORWARD},
+        {0.5, CMD_SPEED_UP}, {0.5, CMD_SPEED_UP}, {0.5, CMD_SPEED_UP}, {0.5, CMD_SPEED_UP},
+        {3.0, CMD_LEFT},
+        {4.0, CMD_TURN_CLEAR},
+        {5.0, CMD_STOP},
+};
+
+#define SCRIPT_LEN (sizeof(script) / sizeof(script[0]))
+
+/**
+  * @struct  Episode
+  * @brief   一台小车的结果 | Result of one car
+  */
+typedef struct {
+    double rmsPitch;        /**< 倾角均方根 (°) | RMS pitch */
+    double maxPitch;        /**< 最大倾角 (°) | Max pitch */
+    double fellAt;          /**< 倒地时间 (s)，未倒地为 -1 | Time of the fall, -1 if it stayed up */
+    double x, y;            /**< 最终位置 (cm) | Final position */
+    unsigned long steps;    /**< 控制周期数 | Control periods run */
+} Episode;
+
+typedef struct {
+    Robot *robots;
+    Episode *episodes;
+    size_t first, count;
+    double duration;
+} Work;
+
+static double gainScale(size_t i) {
+    return 0.5 + 0.1 * (double)(i % GAIN_STEPS);
+}
+
+/**
+  * @brief   运行一台小车的整段仿真 | Run one car for the whole duration
+  */
+static void runEpisode(Robot *robot, size_t index, double duration, Episode *ep) {
+    PlantParams pp = Plant_DefaultParams();
+    Robot_Init(robot, &pp, 0.02, 1000u + (uint32_t)index);
+    robot->control.balance.angleKp *= (fp32)gainScale(index);
+
+    size_t next = 0;
+    double pitchSq = 0.0, maxPitch = 0.0;
+    unsigned long ticks = 0;
+    *ep = (Episode){.fellAt = -1.0};
+    for (double t = 0.0; t < duration; t += ROBOT_TICK) {
+        while (next < SCRIPT_LEN && script[next].time <= t + 1e-9) {
+            Motion_Dispatch(&robot->control.motion, script[next++].cmd);
+        }
+        Robot_Step(robot);
+        double pitch = robot->plant.theta * 180.0 / 3.14159265358979;
+        pitchSq += pitch * pitch;
+        if (fabs(pitch) > maxPitch) maxPitch = fabs(pitch);
+        ticks++;
+        if (fabs(pitch) > BALANCE_FALL_ANGLE) {
+            ep->fellAt = t;
+            break;
+        }
+    }
+    ep->rmsPitch = sqrt(pitchSq / (double)(ticks ? ticks : 1));
+    ep->maxPitch = maxPitch;
+    ep->x = robot->plant.px * 100.0;
+    ep->y = robot->plant.py * 100.0;
+    ep->steps = ticks;
+}
+
+static void *worker(void *arg) {
+    Work *w = arg;
+    for (size_t i = w->first; i < w->first + w->count; i++) {
+        runEpisode(&w->robots[i], i, w->duration, &w->episodes[i]);
+    }
+    return NULL;
+}
+
+static double nowSec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+  * @brief   把 n 台小车平均分给 threads 个线程运行 | Run n cars split evenly across threads
+  * @return  墙钟时间 (s)，失败返回负数 | Wall time, negative on failure
+  */
+static double runFleet(Robot *robots, Episode *episodes, size_t n, int threads, double duration) {
+    pthread_t tid[threads];
+    Work work[threads];
+    double t0 = nowSec();
+    for (int k = 0; k < threads; k++) {
+        size_t first = n * (size_t)k / (size_t)threads, last = n * (size_t)(k + 1) / (size_t)threads;
+        work[k] = (Work){robots, episodes, first, last - first, duration};
+        if (pthread_create(&tid[k], NULL, worker, &work[k]) != 0) {
+            perror("pthread_create");
+            return -1.0;
+        }
+    }
+    for (int k = 0; k < threads; k++) {
+        pthread_join(tid[k], NULL);
+    }
+    return nowSec() - t0;
+}
+
+int main(int argc, char **argv) {
+    size_t n = 4096;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = cores > 0 ? (int)cores : 1;
+    double duration = 8.0;
+    int check = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            n = (size_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = 1;
+        } else {
+            fprintf(stderr, "usage: %s [-n robots] [-j threads] [-t seconds] [--check]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n == 0 || threads < 1 || threads > 256) {
+        fprintf(stderr, "need at least one robot and 1..256 threads\n");
+        return 2;
+    }
+
+    Robot *robots = malloc(n * sizeof(Robot));
+    Episode *episodes = malloc(n * sizeof(Episode));
+    if (!robots || !episodes) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    double wall = runFleet(robots, episodes, n, threads, duration);
+    if (wall < 0.0) return 1;
+
+    unsigned long steps = 0;
+    printf("gain  robots  fell  rms pitch  max pitch\n");
+    for (size_t g = 0; g < GAIN_STEPS && g < n; g++) {
+        size_t count = 0, fell = 0;
+        double rms = 0.0, peak = 0.0;
+        for (size_t i = g; i < n; i += GAIN_STEPS) {
+            const Episode *ep = &episodes[i];
+            count++;
+            fell += ep->fellAt >= 0.0;
+            rms += ep->rmsPitch;
+            if (ep->maxPitch > peak) peak = ep->maxPitch;
+        }
+        printf("%4.1fx %6zu %5zu %7.2f deg %7.2f deg\n", gainScale(g), count, fell, rms / (double)count, peak);
+    }
+    for (size_t i = 0; i < n; i++) {
+        steps += episodes[i].steps;
+    }
+    printf("%zu robots x %.1f s on %d threads: %.2f s wall, %.2f M robot-steps/s, %zu bytes per robot\n",
+           n, duration, threads, wall, (double)steps / wall * 1e-6, sizeof(Robot));
+
+    int ret = 0;
+    if (check) {
+        Episode *single = malloc(n * sizeof(Episode));
+        if (!single) return 1;
+        double wall1 = runFleet(robots, single, n, 1, duration);
+        int same = memcmp(single, episodes, n * sizeof(Episode)) == 0;
+        printf("1 thread: %.2f s wall (%.2fx); results %s\n", wall1, wall1 / wall,
+               same ? "bit-identical" : "DIFFER");
+        ret = same ? 0 : 1;
+        free(single);
+    }
+    free(robots);
+    free(episodes);
+    return ret;
+}
@@ -0,0 +1,328 @@
+/**
+  * @file    i2c_arbiter_test.c
+  * @brief   I2C 仲裁器的模拟总线测试 | Simulated-bus test of the I2C arbiter
+  *
+  * @note    用法 | Usage: dnb_i2c_arbiter_test
+  *          i2c_arbiter.c 原样编译，总线后端换成事件驱动的模拟时钟（每字节 9 个时钟）。
+  *          IMU 每 10 ms 读一次 DMP 采样（FIFO 计数 2 字节，再读 28 字节），OLED 每 200 ms 整屏刷新
+  *          （最坏情况）。对比无仲裁（共用一个先进先出队列、不分段）与按优先级分段两种方式下 IMU 的
+  *          最长等待，并检查两边收到的数据完整且有序。
+  *          i2c_arbiter.c is compiled unchanged with an event-driven simulated clock as the bus
+  *          backend (9 clocks a byte). The IMU reads a DMP sample every 10 ms (2-byte FIFO count,
+  *          then 28 bytes) while the OLED refreshes the whole screen every 200 ms (worst case).
+  *          The IMU's worst wait is compared between no arbitration (one shared FIFO queue, no
+  *          segmentation) and prioritised segmentation, and the data on both sides is checked
+  *          to arrive complete and in order.
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "i2c_arbiter.h"
+#include "check.h"
+
+#define IMU_ADDR        0xD0
+#define OLED_ADDR       0x78
+#define REG_FIFO_COUNT  0x72
+#define REG_FIFO_RW     0x74
+#define SAMPLE_BYTES    28
+#define TICK_US         10000
+#define FRAME_US        200000
+#define RUN_US          2000000
+
+/* 模拟总线 | Simulated bus --------------------------------------------------*/
+
+static struct {
+    uint64_t now;               /* 仿真时间 (µs) | Simulated time */
+    uint32_t byteUs;
+    bool_t busy;
+    uint64_t end;               /* 当前段结束时刻 | End of the current segment */
+    uint8_t addr, reg;
+    bool_t read;
+    uint8_t *data;
+    uint16_t len;
+    int failAt;                 /* 第几段出错，-1 不出错 | Segment to fail, -1 for none */
+    int segments;
+    uint16_t longest;           /* 最长一段 | Longest segment */
+
+    uint8_t sample;             /* IMU 数据序号 | IMU data sequence */
+    uint8_t ram[8][128];        /* OLED 显存 | OLED RAM */
+    uint8_t col, page;
+    uint8_t cmd[6], cmdLen;
+} sim;
+
+static I2CArbiter arb;
+
+static void simStart(I2CBus *self, uint8_t addr, uint8_t reg, bool_t read, uint8_t *data, uint16_t len) {
+    (void)self;
+    CHECK(!sim.busy, "segment started while the bus is busy");
+    sim.busy = TRUE;
+    sim.addr = addr;
+    sim.reg = reg;
+    sim.read = read;
+    sim.data = data;
+    sim.len = len;
+    // 地址 + 寄存器 + 数据，读操作还有一次重复起始地址 | Address + register + data, plus a repeated-start address for reads
+    sim.end = sim.now + (uint64_t)(len + (read ? 3 : 2)) * sim.byteUs;
+    if (len > sim.longest) sim.longest = len;
+}
+
+static uint32_t simNow(I2CBus *self) {
+    (void)self;
+    return (uint32_t)sim.now;
+}
+
+static uint32_t simLock(I2CBus *self) {
+    (void)self;
+    return 0;
+}
+
+static void simUnlock(I2CBus *self, uint32_t state) {
+    (void)self;
+    (void)state;
+}
+
+/**
+  * @brief   设备端：执行当前段 | Device side: carry out the current segment
+  */
+static void deviceApply(void) {
+    if (sim.addr == IMU_ADDR) {
+        for (uint16_t i = 0; i < sim.len; i++) {
+            sim.data[i] = (sim.reg == REG_FIFO_COUNT) ? (i ? SAMPLE_BYTES : 0) : (uint8_t)(sim.sample + i);
+        }
+        if (sim.reg == REG_FIFO_RW) sim.sample++;
+        return;
+    }
+    for (uint16_t i = 0; i < sim.len; i++) {
+        if (sim.reg == 0x00) {
+            sim.cmd[sim.cmdLen++] = sim.data[i];
+            if (sim.cmdLen == 6) {          // 0x21 c0 c1 0x22 p0 p1
+                sim.col = sim.cmd[1];
+                sim.page = sim.cmd[4];
+                sim.cmdLen = 0;
+            }
+        } else {
+            sim.ram[sim.page][sim.col++ & 127] = sim.data[i];
+        }
+    }
+}
+
+static void simFinish(void) {
+    sim.now = sim.end;
+    sim.busy = FALSE;
+    bool_t ok = (sim.segments++ != sim.failAt);
+    if (ok) deviceApply();
+    I2CArb_Complete(&arb, ok);
+}
+
+static void simReset(uint32_t hz, uint16_t segmentMax) {
+    memset(&sim, 0, sizeof(sim));
+    sim.byteUs = 9000000U / hz;
+    sim.failAt = -1;
+    I2CBus bus = {.ctx = &sim, .ticksPerUs = 1, .Start = simStart, .Now = simNow, .Lock = simLock, .Unlock = simUnlock};
+    arb = newI2CArbiter(bus, segmentMax);
+}
+
+/* 负载 | Workload -----------------------------------------------------------*/
+
+typedef struct {
+    uint8_t imuClient, oledClient;
+    uint16_t segmentMax;        /* 0 不分段 | 0: no segmentation */
+    uint16_t oledChunk;         /* OLED 驱动一次提交的数据长度 | Data bytes per OLED driver submission */
+} Config;
+
+typedef struct {
+    uint32_t imuMaxWait, imuMaxLatency, frameMax;
+    fp32 imuUtil, oledUtil;
+    uint16_t longest;
+} Result;
+
+static void run(const char *name, uint32_t hz, const Config *cfg, Result *res) {
+    simReset(hz, cfg->segmentMax);
+    memset(res, 0, sizeof(*res));
+
+    I2CRequest imuReq, oledReq = {.status = I2C_ARB_DONE};
+    uint8_t count[2], sample[SAMPLE_BYTES];
+    uint8_t frame[8][128], cmd[6];
+    int imuStep = 0;                /* 0 空闲，1 读计数，2 读数据 | 0 idle, 1 count, 2 data */
+    uint64_t tickAt = 0, nextTick = 0, nextFrame = 0, frameAt = 0;
+    int page = -1;                  /* 正在发送的页，-1 空闲 | Page being sent, -1 when idle */
+    bool_t sendCmd = FALSE;
+    uint16_t col = 0;
+    uint8_t expect = 0;
+    int frames = 0;
+
+    while (sim.now < RUN_US) {
+        // IMU：每个控制周期开始时阻塞读取一次采样 | IMU: one blocking sample read at the start of each tick
+        if (imuStep == 0 && sim.now >= nextTick) {
+            tickAt = nextTick;
+            nextTick += TICK_US;
+            imuReq = (I2CRequest){.addr = IMU_ADDR, .reg = REG_FIFO_COUNT, .read = TRUE, .data = count, .len = 2};
+            I2CArb_Submit(&arb, cfg->imuClient, &imuReq);
+            imuStep = 1;
+        } else if (imuStep == 1 && imuReq.status != I2C_ARB_PENDING) {
+            CHECK(imuReq.status == I2C_ARB_DONE && count[1] == SAMPLE_BYTES, "%s: FIFO count read failed", name);
+            imuReq = (I2CRequest){.addr = IMU_ADDR, .reg = REG_FIFO_RW, .read = TRUE, .data = sample, .len = SAMPLE_BYTES};
+            I2CArb_Submit(&arb, cfg->imuClient, &imuReq);
+            imuStep = 2;
+        } else if (imuStep == 2 && imuReq.status != I2C_ARB_PENDING) {
+            CHECK(imuReq.status == I2C_ARB_DONE && sample[0] == expect && sample[SAMPLE_BYTES - 1] == (uint8_t)(expect + SAMPLE_BYTES - 1),
+                  "%s: sample %u corrupted", name, expect);
+            expect++;
+            uint32_t latency = (uint32_t)(sim.now - tickAt);
+            if (latency > res->imuMaxLatency) res->imuMaxLatency = latency;
+            imuStep = 0;
+        }
+
+        // OLED：整屏刷新，每页一条窗口命令加若干数据块，一次只提交一个 | OLED: full refresh, a window command plus data chunks per page, one submission at a time
+        if (page < 0 && sim.now >= nextFrame) {
+            frameAt = nextFrame;
+            nextFrame += FRAME_US;
+            for (int p = 0; p < 8; p++) {
+                for (int x = 0; x < 128; x++) frame[p][x] = (uint8_t)rand();
+            }
+            page = 0;
+            sendCmd = TRUE;
+        }
+        if (page >= 0 && oledReq.status != I2C_ARB_PENDING) {
+            CHECK(oledReq.status == I2C_ARB_DONE, "%s: OLED transfer failed", name);
+            if (page == 8) {
+                CHECK(memcmp(sim.ram, frame, sizeof(frame)) == 0, "%s: frame %d arrived corrupted", name, frames);
+                uint32_t t = (uint32_t)(sim.now - frameAt);
+                if (t > res->frameMax) res->frameMax = t;
+                frames++;
+                page = -1;
+            } else if (sendCmd) {
+                uint8_t window[6] = {0x21, 0, 127, 0x22, (uint8_t)page, (uint8_t)page};
+                memcpy(cmd, window, sizeof(cmd));
+                oledReq = (I2CRequest){.addr = OLED_ADDR, .reg = 0x00, .data = cmd, .len = 6};
+                I2CArb_Submit(&arb, cfg->oledClient, &oledReq);
+                sendCmd = FALSE;
+                col = 0;
+            } else {
+                uint16_t n = (uint16_t)(128 - col < cfg->oledChunk ? 128 - col : cfg->oledChunk);
+                oledReq = (I2CRequest){.addr = OLED_ADDR, .reg = 0x40, .split = TRUE, .data = &frame[page][col], .len = n};
+                I2CArb_Submit(&arb, cfg->oledClient, &oledReq);
+                col += n;
+                if (col == 128) {
+                    page++;
+                    sendCmd = TRUE;
+                }
+            }
+        }
+
+        // 推进到下一个事件 | Advance to the next event
+        uint64_t next = UINT64_MAX;
+        if (imuStep == 0) next = nextTick;
+        if (page < 0 && nextFrame < next) next = nextFrame;
+        if (next < sim.now) continue;   // 已到期的事件下一轮处理 | Events already due are handled next round
+        if (sim.busy && sim.end <= next) {
+            simFinish();
+        } else if (next != UINT64_MAX) {
+            sim.now = next;
+        }
+    }
+
+    res->imuMaxWait = I2CArb_MaxWaitUs(&arb, cfg->imuClient);
+    res->imuUtil = I2CArb_Utilization(&arb, cfg->imuClient);
+    res->oledUtil = I2CArb_Utilization(&arb, cfg->oledClient);
+    res->longest = sim.longest;
+    CHECK(frames >= RUN_US / FRAME_US - 1, "%s: only %d frames sent", name, frames);
+    CHECK(expect >= RUN_US / TICK_US - 1, "%s: only %u samples read", name, expect);
+
+    printf("  %-28s %10u %12u %10.1f %8.1f%% %8.1f%% %8u\n", name, res->imuMaxWait, res->imuMaxLatency,
+           res->frameMax / 1000.0, res->imuUtil * 100, res->oledUtil * 100, res->longest);
+}
+
+/* 单元检查 | Unit checks -----------------------------------------------------*/
+
+static void unitChecks(void) {
+    uint8_t buf[64];
+    I2CRequest low = {.addr = OLED_ADDR, .reg = 0x40, .split = TRUE, .data = buf, .len = 40};
+    I2CRequest high = {.addr = IMU_ADDR, .reg = REG_FIFO_RW, .read = TRUE, .data = buf + 48, .len = 4};
+
+    printf("preemption\n");
+    simReset(100000, 16);
+    I2CArb_Submit(&arb, I2C_CLIENT_OLED, &low);
+    CHECK(sim.busy && sim.len == 16, "first segment is %u bytes, want 16", sim.len);
+    I2CArb_Submit(&arb, I2C_CLIENT_IMU, &high);
+    simFinish();
+    CHECK(sim.addr == IMU_ADDR, "IMU did not preempt the queued OLED segments");
+    simFinish();
+    CHECK(high.status == I2C_ARB_DONE, "IMU request not done");
+    CHECK(sim.addr == OLED_ADDR && sim.data == buf + 16 && sim.len == 16, "OLED did not resume at byte 16");
+    simFinish();
+    CHECK(sim.len == 8, "last segment is %u bytes, want 8", sim.len);
+    simFinish();
+    CHECK(low.status == I2C_ARB_DONE && !sim.busy, "OLED request not done");
+    CHECK(arb.stats[I2C_CLIENT_OLED].segments == 3 && arb.stats[I2C_CLIENT_OLED].requests == 1,
+          "OLED stats: %u segments, %u requests", arb.stats[I2C_CLIENT_OLED].segments, arb.stats[I2C_CLIENT_OLED].requests);
+
+    printf("unsplittable\n");
+    simReset(100000, 16);
+    I2CRequest cmd = {.addr = OLED_ADDR, .reg = 0x00, .data = buf, .len = 28};
+    I2CArb_Submit(&arb, I2C_CLIENT_OLED, &cmd);
+    CHECK(sim.len == 28, "command write was split into %u bytes", sim.len);
+    simFinish();
+
+    printf("error\n");
+    simReset(100000, 16);
+    sim.failAt = 1;
+    I2CRequest other = {.addr = OLED_ADDR, .reg = 0x40, .split = TRUE, .data = buf, .len = 8};
+    I2CArb_Submit(&arb, I2C_CLIENT_OLED, &low);
+    I2CArb_Submit(&arb, I2C_CLIENT_OLED, &other);
+    simFinish();
+    simFinish();
+    CHECK(low.status == I2C_ARB_ERR_BUS, "failed segment did not fail its request");
+    CHECK(!sim.busy && arb.faulted, "dispatch went on before the bus was recovered");
+    I2CArb_Service(&arb);
+    CHECK(arb.recoveries == 1 && !arb.faulted, "bus not recovered");
+    CHECK(sim.busy && sim.len == 8 && sim.data == buf, "next request did not start from its first byte");
+    simFinish();
+    CHECK(other.status == I2C_ARB_DONE, "request after the error not done");
+    CHECK(arb.stats[I2C_CLIENT_OLED].errors == 1, "%u errors, want 1", arb.stats[I2C_CLIENT_OLED].errors);
+
+    printf("queue full\n");
+    simReset(100000, 16);
+    I2CRequest many[I2C_ARB_QUEUE + 1];
+    for (int i = 0; i <= I2C_ARB_QUEUE; i++) {
+        many[i] = (I2CRequest){.addr = IMU_ADDR, .reg = 0, .read = TRUE, .data = buf, .len = 1};
+        int r = I2CArb_Submit(&arb, I2C_CLIENT_IMU, &many[i]);
+        CHECK((i < I2C_ARB_QUEUE) == (r == I2C_ARB_PENDING), "submit %d returned %d", i, r);
+    }
+    while (sim.busy) simFinish();
+    for (int i = 0; i < I2C_ARB_QUEUE; i++) CHECK(many[i].status == I2C_ARB_DONE, "request %d not done", i);
+
+    I2CRequest empty = {.addr = IMU_ADDR, .data = buf, .len = 0};
+    CHECK(I2CArb_Submit(&arb, I2C_CLIENT_IMU, &empty) == I2C_ARB_DONE && !sim.busy, "empty request touched the bus");
+}
+
+int main(void) {
+    unitChecks();
+
+    const uint32_t hz = 100000;
+    const Config fifo = {.imuClient = 0, .oledClient = 0, .segmentMax = 0, .oledChunk = 128};
+    const Config seg32 = {.imuClient = I2C_CLIENT_IMU, .oledClient = I2C_CLIENT_OLED, .segmentMax = 32, .oledChunk = 32};
+    const Config seg16 = {.imuClient = I2C_CLIENT_IMU, .oledClient = I2C_CLIENT_OLED, .segmentMax = 16, .oledChunk = 32};
+    Result r;
+
+    printf("IMU sample every %d ms vs. full OLED refresh every %d ms, I2C %u kHz\n", TICK_US / 1000, FRAME_US / 1000, hz / 1000);
+    printf("  %-28s %10s %12s %10s %9s %9s %8s\n", "", "IMU wait", "IMU latency", "frame ms", "IMU bus", "OLED bus", "longest");
+    printf("  %-28s %10s %12s\n", "", "(us)", "(us)");
+
+    run("shared FIFO, 128-byte pages", hz, &fifo, &r);
+    uint32_t fifoWait = r.imuMaxWait;
+
+    run("priority, 32-byte segments", hz, &seg32, &r);
+    CHECK(r.imuMaxWait <= (32 + 2) * (9000000U / hz), "32-byte segments: IMU waited %u us", r.imuMaxWait);
+
+    run("priority, 16-byte segments", hz, &seg16, &r);
+    CHECK(r.imuMaxWait <= (16 + 2) * (9000000U / hz), "16-byte segments: IMU waited %u us", r.imuMaxWait);
+    CHECK(r.imuMaxWait * 4 < fifoWait, "segmentation did not cut the IMU wait (%u vs %u us)", r.imuMaxWait, fifoWait);
+    CHECK(r.imuUtil + r.oledUtil <= 1.0f, "utilisation above 100%%");
+
+    // 固件实际运行在 400 kHz | The firmware actually runs at 400 kHz
+    run("16-byte segments, 400 kHz", 400000, &seg16, &r);
+    CHECK(r.imuMaxWait <= (16 + 2) * (9000000U / 400000), "400 kHz: IMU waited %u us", r.imuMaxWait);
+
+    return Check_Exit();
+}
@@ -0,0 +1,508 @@
+/**
+  * @file    i2c_recovery_test.c
+  * @brief   I2C 卡死恢复的故障注入测试 | Fault-injection test of I2C stuck-bus recovery
+  *
+  * @note    用法 | Usage: dnb_i2c_recovery_test [seed]
+  *          i2c_recover.c 与 i2c_arbiter.c 原样编译。第一部分用逐位的从机模型检查时钟输出：从机停在任意字节的
+  *          任意一位都能在 9 个时钟内释放，拉长时钟、SCL 或 SDA 一直被拉住时在有限时间内报错。
+  *          第二部分在 400 kHz 模拟总线上运行 IMU 与 OLED 负载，随机注入 NACK、传输中止（从机卡在字节中间）、
+  *          传输挂起（超时）和传输后 SDA 被拉住（下次启动前发现）；检查每次故障只让一个请求失败、
+  *          恢复一次且耗时有界，IMU FIFO 重新对齐后不会收下错位的采样。
+  *          i2c_recover.c and i2c_arbiter.c are compiled unchanged. Part one checks the clock-out
+  *          against a bit-level slave model: a slave stopped at any bit of any byte is freed
+  *          within nine clocks, and clock stretching, SCL held low or SDA held low end in bounded
+  *          time. Part two runs the IMU and OLED workload on a simulated 400 kHz bus and injects
+  *          NACKs, aborted transfers (slave left mid-byte), hung transfers (timeout) and SDA held
+  *          after a transfer (found before the next start). It checks that every fault fails
+  *          exactly one request and costs one bounded recovery, and that after the FIFO resync no
+  *          misaligned IMU sample is accepted.
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "i2c_arbiter.h"
+#include "i2c_recover.h"
+#include "check.h"
+
+#define TICKS_PER_US    10                      /* 仿真时间 0.1 µs | Simulated time in 0.1 µs */
+#define BYTE_TICKS      225                     /* 400 kHz 下 9 个时钟 | Nine clocks at 400 kHz */
+#define HALF_TICKS      (5 * TICKS_PER_US)      /* 恢复时钟半周期 | Recovery clock half period */
+#define INIT_TICKS      (20 * TICKS_PER_US)     /* 外设 DeInit + Init */
+#define TIMEOUT_TICKS   (5000 * TICKS_PER_US)   /* I2C_BUS_TIMEOUT_MS */
+#define RESET_TICKS     (50000 * TICKS_PER_US)  /* mpu_reset_fifo 的延时 | mpu_reset_fifo delay */
+#define TICK_TICKS      (10000 * TICKS_PER_US)
+#define FRAME_TICKS     (200000 * TICKS_PER_US)
+#define RUN_TICKS       (60000000ULL * TICKS_PER_US)
+#define FAULT_EVERY     200                     /* 平均每 200 段一次故障 | One fault per 200 segments on average */
+
+#define IMU_ADDR        0xD0
+#define OLED_ADDR       0x78
+#define REG_USER_CTRL   0x6A
+#define REG_FIFO_COUNT  0x72
+#define REG_FIFO_RW     0x74
+#define PACKET          28
+#define OLED_CHUNK      32
+
+/* 逐位从机模型 | Bit-level slave model ---------------------------------------*/
+
+typedef enum {
+    SLAVE_IDLE,
+    SLAVE_TX,       /* 正在移出一个字节 | Shifting out a byte */
+    SLAVE_SHORT,    /* SDA 被一直拉低（短路） | SDA held low for good (short) */
+} SlaveState;
+
+static struct {
+    SlaveState state;
+    uint8_t byte, bit;          /* bit 8：释放 SDA 等应答 | bit 8: SDA released for the ACK */
+    int stretch;                /* 每个时钟拉长的半周期 | Half periods each clock is stretched */
+    int sclHeld;                /* SCL 还要被拉住的读取次数 | Reads SCL stays held for */
+    bool_t scl, sda;            /* 主机驱动 | Master drive */
+    int stops;
+    int delays;
+    uint64_t *clock;            /* 推进的仿真时间，可为 NULL | Simulated time to advance, may be NULL */
+} slave;
+
+static bool_t slaveSda(void) {
+    if (slave.state == SLAVE_SHORT) return FALSE;
+    if (slave.state == SLAVE_TX && slave.bit < 8) return (slave.byte >> (7 - slave.bit)) & 1;
+    return TRUE;
+}
+
+static bool_t lineScl(void) {
+    return slave.scl && slave.sclHeld == 0;
+}
+
+static bool_t lineSda(void) {
+    return slave.sda && slaveSda();
+}
+
+static void pinScl(I2CPins *self, bool_t high) {
+    (void)self;
+    if (!high && slave.scl) {
+        // 下降沿：从机移出下一位，无应答后回到空闲 | Falling edge: next bit, idle after the NACK
+        if (slave.state == SLAVE_TX) {
+            if (slave.bit < 8) {
+                slave.bit++;
+            } else {
+                slave.state = SLAVE_IDLE;
+            }
+        }
+        slave.sclHeld = slave.stretch;
+    }
+    slave.scl = high;
+}
+
+static void pinSda(I2CPins *self, bool_t high) {
+    (void)self;
+    if (high && !slave.sda && lineScl()) {
+        slave.stops++;
+        if (slave.state == SLAVE_TX) slave.state = SLAVE_IDLE;
+    }
+    slave.sda = high;
+}
+
+static bool_t pinReadScl(I2CPins *self) {
+    (void)self;
+    if (slave.scl && slave.sclHeld > 0) {
+        slave.sclHeld--;
+        return FALSE;
+    }
+    return slave.scl;
+}
+
+static bool_t pinReadSda(I2CPins *self) {
+    (void)self;
+    return lineSda();
+}
+
+static void pinDelay(I2CPins *self) {
+    (void)self;
+    slave.delays++;
+    if (slave.clock) *slave.clock += HALF_TICKS;
+}
+
+static I2CPins pins = {.Scl = pinScl, .Sda = pinSda, .ReadScl = pinReadScl, .ReadSda = pinReadSda, .Delay = pinDelay};
+
+/**
+  * @brief   让从机停在一个会拉低 SDA 的位上 | Leave the slave on a bit that pulls SDA low
+  */
+static void slaveStick(void) {
+    slave.state = SLAVE_TX;
+    do {
+        slave.byte = (uint8_t)rand();
+        slave.bit = (uint8_t)(rand() % 8);
+    } while (slaveSda());
+}
+
+static void slaveReset(void) {
+    uint64_t *clock = slave.clock;
+    memset(&slave, 0, sizeof(slave));
+    slave.scl = slave.sda = TRUE;
+    slave.clock = clock;
+}
+
+/* 第一部分：时钟输出 | Part one: clock-out ----------------------------------*/
+
+static void clockOutChecks(void) {
+    const int bound = 2 * I2C_RECOVER_CLOCKS + 5 + I2C_RECOVER_STRETCH;
+    int worst = 0;
+
+    printf("clock-out\n");
+    for (int b = 0; b < 256; b++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            slaveReset();
+            slave.state = SLAVE_TX;
+            slave.byte = (uint8_t)b;
+            slave.bit = bit;
+            int rc = I2C_ClockOut(&pins);
+            CHECK(rc >= 0 && rc <= I2C_RECOVER_CLOCKS, "byte %02X bit %u: returned %d", b, bit, rc);
+            CHECK(slave.state == SLAVE_IDLE && slave.stops == 1 && lineSda() && lineScl(),
+                  "byte %02X bit %u: bus not released", b, bit);
+            if (slave.delays > worst) worst = slave.delays;
+        }
+    }
+    printf("  stuck slave freed from any bit of any byte, worst %d half periods\n", worst);
+
+    slaveReset();
+    CHECK(I2C_ClockOut(&pins) == 0 && slave.stops == 1, "idle bus: clocks sent or no STOP");
+
+    slaveReset();
+    slaveStick();
+    slave.stretch = 3;
+    CHECK(I2C_ClockOut(&pins) >= 0 && slave.state == SLAVE_IDLE, "stretched clocks not followed");
+
+    slaveReset();
+    slave.sclHeld = 1000000;
+    CHECK(I2C_ClockOut(&pins) == I2C_RECOVER_ERR_SCL, "SCL held low not reported");
+    CHECK(slave.delays <= bound, "SCL held low: %d half periods, bound %d", slave.delays, bound);
+
+    slaveReset();
+    slave.state = SLAVE_SHORT;
+    CHECK(I2C_ClockOut(&pins) == I2C_RECOVER_ERR_SDA, "SDA held low not reported");
+    CHECK(slave.delays <= bound, "SDA held low: %d half periods, bound %d", slave.delays, bound);
+}
+
+/* 第二部分：故障注入总线 | Part two: fault-injecting bus ----------------------*/
+
+typedef enum {
+    FAULT_NONE,
+    FAULT_NACK,     /* 地址无应答 | Address NACK */
+    FAULT_ABORT,    /* 传到一半出错，从机卡在字节中间 | Error mid-transfer, slave left mid-byte */
+    FAULT_HANG,     /* 没有完成中断（超时） | No completion interrupt (timeout) */
+    FAULT_GLITCH,   /* 传输成功但随后 SDA 被拉住 | Transfer done but SDA held afterwards */
+    FAULT_KINDS,
+} Fault;
+
+static const char *faultNames[FAULT_KINDS] = {"none", "NACK", "abort", "hang", "SDA held"};
+
+static struct {
+    uint64_t now;
+    bool_t busy;
+    uint64_t end;
+    Fault fault;
+    uint8_t addr, reg;
+    bool_t read;
+    uint8_t *data;
+    uint16_t len;
+
+    uint32_t rd;                /* IMU FIFO 已读字节 | IMU FIFO bytes consumed */
+    uint8_t ram[8][128];        /* OLED 显存 | OLED RAM */
+    uint8_t col, page;
+    uint8_t cmd[6], cmdLen;
+
+    uint32_t injected[FAULT_KINDS];
+    uint32_t stuckStarts;
+    uint32_t timeouts;
+} sim;
+
+static I2CArbiter arb;
+
+/* DMP 每 10 ms 在周期中点放入一个包 | The DMP queues one packet every 10 ms, mid-period */
+static uint32_t fifoProduced(void) {
+    return (uint32_t)((sim.now + TICK_TICKS / 2) / TICK_TICKS) * PACKET;
+}
+
+/* FIFO 字节流中第 p 个字节：包序号加包内偏移 | Byte p of the FIFO stream: packet number plus offset */
+static uint8_t fifoByte(uint32_t p) {
+    return (uint8_t)(p / PACKET + p % PACKET);
+}
+
+static void deviceApply(uint16_t n) {
+    if (sim.addr == IMU_ADDR) {
+        if (sim.reg == REG_FIFO_COUNT) {
+            uint32_t count = fifoProduced() - sim.rd;
+            uint8_t be[2] = {(uint8_t)(count >> 8), (uint8_t)count};
+            memcpy(sim.data, be, n < 2 ? n : 2);
+        } else if (sim.reg == REG_FIFO_RW) {
+            for (uint16_t i = 0; i < n; i++) sim.data[i] = fifoByte(sim.rd++);
+        } else if (sim.reg == REG_USER_CTRL && n > 0) {
+            sim.rd = fifoProduced();
+        }
+        return;
+    }
+    if (sim.reg == 0x00) sim.cmdLen = 0;    // 每次传输重新开始解析命令 | Command parsing restarts with every transfer
+    for (uint16_t i = 0; i < n; i++) {
+        if (sim.reg == 0x00) {
+            sim.cmd[sim.cmdLen++] = sim.data[i];
+            if (sim.cmdLen == 6) {
+                sim.col = sim.cmd[1];
+                sim.page = sim.cmd[4];
+                sim.cmdLen = 0;
+            }
+        } else {
+            sim.ram[sim.page][sim.col++ & 127] = sim.data[i];
+        }
+    }
+}
+
+static void simStart(I2CBus *self, uint8_t addr, uint8_t reg, bool_t read, uint8_t *data, uint16_t len) {
+    (void)self;
+    CHECK(!sim.busy, "segment started while the bus is busy");
+    // 与 busIdle 相同：总线线路不空闲就不启动 | As busIdle: no start unless both lines are idle
+    if (!lineSda() || !lineScl()) {
+        sim.stuckStarts++;
+        I2CArb_Complete(&arb, FALSE);
+        return;
+    }
+    sim.busy = TRUE;
+    sim.addr = addr;
+    sim.reg = reg;
+    sim.read = read;
+    sim.data = data;
+    sim.len = len;
+    sim.end = sim.now + (uint64_t)(len + (read ? 3 : 2)) * BYTE_TICKS;
+    sim.fault = (rand() % FAULT_EVERY == 0) ? (Fault)(1 + rand() % (FAULT_KINDS - 1)) : FAULT_NONE;
+    sim.injected[sim.fault]++;
+    if (sim.fault == FAULT_HANG) sim.end = UINT64_MAX;
+}
+
+static void simFinish(void) {
+    sim.now = sim.end;
+    sim.busy = FALSE;
+    switch (sim.fault) {
+    case FAULT_NONE:
+        deviceApply(sim.len);
+        I2CArb_Complete(&arb, TRUE);
+        break;
+    case FAULT_NACK:
+        I2CArb_Complete(&arb, FALSE);
+        break;
+    case FAULT_ABORT:
+        deviceApply((uint16_t)(rand() % sim.len));
+        slaveStick();
+        I2CArb_Complete(&arb, FALSE);
+        break;
+    case FAULT_GLITCH:
+        deviceApply(sim.len);
+        slaveStick();
+        I2CArb_Complete(&arb, TRUE);
+        break;
+    default:
+        break;
+    }
+}
+
+/* I2C_Bus_Transfer 的超时分支 | The timeout branch of I2C_Bus_Transfer */
+static void simTimeout(void) {
+    sim.now = (uint64_t)arb.activeSince + TIMEOUT_TICKS;
+    sim.busy = FALSE;
+    sim.timeouts++;
+    I2CArb_Complete(&arb, FALSE);
+}
+
+static uint32_t simNow(I2CBus *self) {
+    (void)self;
+    return (uint32_t)sim.now;
+}
+
+static uint32_t simLock(I2CBus *self) {
+    (void)self;
+    return 0;
+}
+
+static void simUnlock(I2CBus *self, uint32_t state) {
+    (void)self;
+    (void)state;
+}
+
+/* 与 busRecover 相同：复位外设，再打时钟 | As busRecover: reset the peripheral, then clock out */
+static bool_t simRecover(I2CBus *self) {
+    (void)self;
+    sim.now += INIT_TICKS;
+    return I2C_ClockOut(&pins) >= 0;
+}
+
+typedef struct {
+    uint32_t accepted, corrupt, resyncs, frames, resends;
+    uint64_t worstGap;
+} Result;
+
+typedef enum { IMU_IDLE, IMU_RESET, IMU_RESET_WAIT, IMU_COUNT, IMU_DATA } ImuStep;
+
+/**
+  * @brief   运行负载 | Run the workload
+  * @param   resync  出错后复位 FIFO（MPU6500.c 的 resync_fifo） | Reset the FIFO after errors (resync_fifo in MPU6500.c)
+  */
+static void run(bool_t resync, unsigned seed, Result *res) {
+    srand(seed);
+    memset(&sim, 0, sizeof(sim));
+    memset(res, 0, sizeof(*res));
+    slave.clock = &sim.now;
+    slaveReset();
+    I2CBus bus = {.ctx = &sim, .ticksPerUs = TICKS_PER_US, .Start = simStart, .Now = simNow,
+                  .Lock = simLock, .Unlock = simUnlock, .Recover = simRecover};
+    arb = newI2CArbiter(bus, 16);
+
+    I2CRequest imuReq = {.status = I2C_ARB_DONE}, oledReq = {.status = I2C_ARB_DONE};
+    uint8_t count[2], sample[PACKET], userCtrl = 0x0C;
+    ImuStep imu = IMU_IDLE;
+    uint32_t seenErrors = 0;
+    uint64_t nextTick = 0, resetUntil = 0, lastSample = 0;
+
+    static uint8_t frame[8][128];
+    uint8_t cmd[6];
+    uint64_t nextFrame = 0;
+    int page = -1;
+    bool_t sendCmd = FALSE;
+    uint16_t col = 0;
+
+    while (sim.now < RUN_TICKS) {
+        I2CArb_Service(&arb);
+
+        // IMU：MPU6500_DMP_Get_Data，每个控制周期一次 | IMU: MPU6500_DMP_Get_Data once per tick
+        if (imu == IMU_IDLE && sim.now >= nextTick) {
+            nextTick += TICK_TICKS;
+            if (resync && arb.stats[I2C_CLIENT_IMU].errors != seenErrors) {
+                imuReq = (I2CRequest){.addr = IMU_ADDR, .reg = REG_USER_CTRL, .data = &userCtrl, .len = 1};
+                imu = IMU_RESET;
+            } else {
+                imuReq = (I2CRequest){.addr = IMU_ADDR, .reg = REG_FIFO_COUNT, .read = TRUE, .data = count, .len = 2};
+                imu = IMU_COUNT;
+            }
+            I2CArb_Submit(&arb, I2C_CLIENT_IMU, &imuReq);
+        } else if (imu == IMU_RESET && imuReq.status != I2C_ARB_PENDING) {
+            if (imuReq.status == I2C_ARB_DONE) {
+                resetUntil = sim.now + RESET_TICKS;
+                imu = IMU_RESET_WAIT;
+            } else {
+                imu = IMU_IDLE;
+            }
+        } else if (imu == IMU_RESET_WAIT && sim.now >= resetUntil) {
+            seenErrors = arb.stats[I2C_CLIENT_IMU].errors;
+            res->resyncs++;
+            imu = IMU_IDLE;
+        } else if (imu == IMU_COUNT && imuReq.status != I2C_ARB_PENDING) {
+            imu = IMU_IDLE;
+            if (imuReq.status == I2C_ARB_DONE && ((count[0] << 8) | count[1]) >= PACKET) {
+                imuReq = (I2CRequest){.addr = IMU_ADDR, .reg = REG_FIFO_RW, .read = TRUE, .data = sample, .len = PACKET};
+                I2CArb_Submit(&arb, I2C_CLIENT_IMU, &imuReq);
+                imu = IMU_DATA;
+            }
+        } else if (imu == IMU_DATA && imuReq.status != I2C_ARB_PENDING) {
+            imu = IMU_IDLE;
+            if (imuReq.status == I2C_ARB_DONE) {
+                bool_t aligned = TRUE;
+                for (int i = 1; i < PACKET; i++) aligned &= (sample[i] == (uint8_t)(sample[0] + i));
+                res->accepted++;
+                res->corrupt += !aligned;
+                if (sim.now - lastSample > res->worstGap) res->worstGap = sim.now - lastSample;
+                lastSample = sim.now;
+            }
+        }
+
+        // OLED：整屏刷新，失败后整屏重发（与 OLED.c 相同） | OLED: full refresh, resent whole after a failure (as OLED.c)
+        if (page < 0 && sim.now >= nextFrame) {
+            nextFrame += FRAME_TICKS;
+            for (int p = 0; p < 8; p++) {
+                for (int x = 0; x < 128; x++) frame[p][x] = (uint8_t)rand();
+            }
+            page = 0;
+            sendCmd = TRUE;
+        }
+        if (page >= 0 && oledReq.status != I2C_ARB_PENDING) {
+            if (oledReq.status != I2C_ARB_DONE) {
+                oledReq.status = I2C_ARB_DONE;
+                res->resends++;
+                page = 0;
+                sendCmd = TRUE;
+            }
+            if (page == 8) {
+                CHECK(memcmp(sim.ram, frame, sizeof(frame)) == 0, "frame %u arrived corrupted", res->frames);
+                res->frames++;
+                page = -1;
+            } else if (sendCmd) {
+                uint8_t window[6] = {0x21, 0, 127, 0x22, (uint8_t)page, (uint8_t)page};
+                memcpy(cmd, window, sizeof(cmd));
+                oledReq = (I2CRequest){.addr = OLED_ADDR, .reg = 0x00, .data = cmd, .len = 6};
+                I2CArb_Submit(&arb, I2C_CLIENT_OLED, &oledReq);
+                sendCmd = FALSE;
+                col = 0;
+            } else {
+                oledReq = (I2CRequest){.addr = OLED_ADDR, .reg = 0x40, .split = TRUE, .data = &frame[page][col], .len = OLED_CHUNK};
+                I2CArb_Submit(&arb, I2C_CLIENT_OLED, &oledReq);
+                col += OLED_CHUNK;
+                if (col == 128) {
+                    page++;
+                    sendCmd = TRUE;
+                }
+            }
+        }
+
+        // 推进到下一个事件 | Advance to the next event
+        uint64_t next = UINT64_MAX;
+        if (imu == IMU_IDLE) next = nextTick;
+        if (imu == IMU_RESET_WAIT && resetUntil < next) next = resetUntil;
+        if (page < 0 && nextFrame < next) next = nextFrame;
+        if (next < sim.now || arb.faulted) continue;
+        if (sim.busy && sim.fault == FAULT_HANG && arb.activeSince + TIMEOUT_TICKS <= next) {
+            simTimeout();
+        } else if (sim.busy && sim.end <= next) {
+            simFinish();
+        } else if (next != UINT64_MAX) {
+            sim.now = next;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned seed = (argc > 1) ? (unsigned)strtoul(argv[1], NULL, 0) : 1;
+
+    clockOutChecks();
+
+    printf("fault injection, 400 kHz, one fault per %d segments, %llu s, seed %u\n",
+           FAULT_EVERY, (unsigned long long)(RUN_TICKS / TICKS_PER_US / 1000000), seed);
+    Result r, raw;
+    run(FALSE, seed, &raw);
+    run(TRUE, seed, &r);
+
+    uint32_t faults = 0;
+    for (int f = FAULT_NACK; f < FAULT_KINDS; f++) {
+        printf("  %-10s %6u\n", faultNames[f], sim.injected[f]);
+        faults += sim.injected[f];
+    }
+    uint32_t errors = arb.stats[I2C_CLIENT_IMU].errors + arb.stats[I2C_CLIENT_OLED].errors;
+    fp32 recoverUs = (fp32)arb.maxRecoverTicks / TICKS_PER_US;
+    printf("  failed requests %u, recoveries %u (%u failed), worst recovery %.1f us, stuck starts %u, timeouts %u\n",
+           errors, arb.recoveries, arb.recoverFails, recoverUs, sim.stuckStarts, sim.timeouts);
+    printf("  IMU: %u samples, %u FIFO resyncs, worst gap %.1f ms; OLED: %u frames, %u resends\n",
+           r.accepted, r.resyncs, r.worstGap / (TICKS_PER_US * 1000.0), r.frames, r.resends);
+    printf("  misaligned samples accepted: %u with resync, %u without\n", r.corrupt, raw.corrupt);
+
+    CHECK(faults > 20, "only %u faults injected", faults);
+    CHECK(errors + 1 >= faults && errors <= faults, "%u failed requests for %u faults", errors, faults);
+    CHECK(arb.recoveries == errors && arb.recoverFails == 0, "%u recoveries (%u failed) for %u errors",
+          arb.recoveries, arb.recoverFails, errors);
+    CHECK(sim.stuckStarts + 1 >= sim.injected[FAULT_GLITCH] && sim.stuckStarts <= sim.injected[FAULT_GLITCH],
+          "held SDA found %u times for %u glitches", sim.stuckStarts, sim.injected[FAULT_GLITCH]);
+    CHECK(sim.timeouts + 1 >= sim.injected[FAULT_HANG], "%u timeouts for %u hangs", sim.timeouts, sim.injected[FAULT_HANG]);
+    CHECK(arb.maxRecoverTicks <= INIT_TICKS + (2 * I2C_RECOVER_CLOCKS + 5) * HALF_TICKS,
+          "recovery took %.1f us", recoverUs);
+    CHECK(r.corrupt == 0, "%u misaligned samples accepted", r.corrupt);
+    CHECK(raw.corrupt > 0, "no misaligned samples without resync: the test injects nothing that needs it");
+    CHECK(r.worstGap <= TIMEOUT_TICKS + RESET_TICKS + 3 * TICK_TICKS, "IMU gap of %.1f ms",
+          r.worstGap / (TICKS_PER_US * 1000.0));
+    CHECK(r.accepted >= RUN_TICKS / TICK_TICKS * 9 / 10, "only %u IMU samples", r.accepted);
+    CHECK(r.frames >= RUN_TICKS / FRAME_TICKS - 2, "only %u frames", r.frames);
+
+    return Check_Exit();
+}
@@ -0,0 +1,144 @@
+/**
+  * @file    imu_boot_bench.c
+  * @brief   IMU 冷/热启动到首帧数据的时间 | IMU time to first sample, cold vs warm boot
+  *
+  * @note    MPU6500.c 与 InvenSense 驱动原样编译，芯片由寄存器级模拟器代替（400 kHz，虚拟时钟）。
+  *          每次 MCU 启动在 fork 出的子进程中运行，驱动的静态状态随之从零开始；模拟器放在共享内存中，
+  *          相当于传感器在 MCU 复位期间保持供电。子进程按 10 ms 控制周期推进分步初始化，之后每周期读一帧。
+  *          MPU6500.c and the InvenSense driver are compiled unchanged; the chip is the
+  *          register-level emulator (400 kHz, virtual clock). Each MCU boot runs in a forked
+  *          child so the driver's static state starts from zero, while the emulator lives in
+  *          shared memory, as if the sensor kept power through the MCU reset. The child runs the
+  *          staged init on the 10 ms control tick, then reads one sample per tick.
+  */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "MPU6500.h"
+#include "inv_mpu.h"
+#include "mpu6500_emu.h"
+
+#define BUS_HZ          400000U
+#define TICK_NS         10000000ULL     /**< 控制周期 | Control tick */
+#define RUN_NS          1000000000ULL   /**< 每次启动运行 1 s | Each boot runs for 1 s */
+#define RESET_GAP_NS    300000000ULL    /**< MCU 复位到重新运行 | MCU reset until running again */
+
+typedef struct {
+    int result;                 /**< 初始化结果 | Init result */
+    int warm;                   /**< 热启动 | Warm boot */
+    uint64_t initNs;            /**< 初始化完成时间 | Init finished */
+    uint64_t firstNs;           /**< 首帧时间 | First sample */
+    uint32_t loadMs;            /**< DMP 固件上传耗时 | DMP upload time */
+    uint32_t samples;           /**< 读到的帧数 | Samples read */
+    uint32_t memWritten;        /**< 写入 DMP 存储器的字节 | Bytes written to DMP memory */
+    uint32_t transfers;         /**< I2C 传输次数 | I2C transfers */
+    float pitch;                /**< 最后一帧俯仰角 | Pitch of the last sample */
+} BootReport;
+
+static BootReport *report;
+
+/**
+  * @brief   一次 MCU 启动（子进程） | One MCU boot (child process)
+  */
+static void mcuBoot(void) {
+    uint64_t t0 = mpuEmu->now;
+    uint64_t tick = t0;
+    uint32_t memWritten = mpuEmu->memWritten;
+    uint32_t transfers = mpuEmu->transfers;
+    memset(report, 0, sizeof(*report));
+
+    MPU6500_Init_Start();
+    int result = MPU6500_INIT_BUSY;
+    while (mpuEmu->now - t0 < RUN_NS) {
+        if (result == MPU6500_INIT_BUSY) {
+            result = MPU6500_Init_Poll();
+            if (result == 0) {
+                report->initNs = mpuEmu->now - t0;
+            } else if (result != MPU6500_INIT_BUSY) {
+                break;
+            }
+        } else {
+            float pitch, roll, yaw, ax, ay, az, gx, gy, gz;
+            if (MPU6500_DMP_Get_Data(&pitch, &roll, &yaw, &ax, &ay, &az, &gx, &gy, &gz) == 0) {
+                if (report->samples++ == 0) {
+                    report->firstNs = mpuEmu->now - t0;
+                }
+                report->pitch = pitch;
+            }
+        }
+        // 下一个控制周期；超时的一步会错过若干周期 | Next control tick; an overrunning stage skips ticks
+        while (tick <= mpuEmu->now) {
+            tick += TICK_NS;
+        }
+        Mpu6500Emu_Advance(mpuEmu, tick - mpuEmu->now);
+    }
+    report->result = result;
+    report->warm = MPU6500_Warm_Boot();
+    report->loadMs = MPU6500_DMP_Load_Ms();
+    report->memWritten = mpuEmu->memWritten - memWritten;
+    report->transfers = mpuEmu->transfers - transfers;
+}
+
+static int boot(const char *name, int expectWarm) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        mcuBoot();
+        _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+
+    int ok = WIFEXITED(status) && report->result == 0 && report->warm == expectWarm && report->samples > 0
+             && (expectWarm ? report->memWritten == 0 : report->memWritten > 0);
+    printf("%-24s %-5s %9.1f %11.1f %8u %9u %9u %8u  %s\n", name, report->warm ? "warm" : "cold",
+           report->initNs / 1e6, report->firstNs / 1e6, report->loadMs, report->memWritten, report->transfers,
+           report->samples, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main(void) {
+    void *shared = mmap(NULL, sizeof(Mpu6500Emu) + sizeof(BootReport), PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    mpuEmu = shared;
+    report = (BootReport *)(mpuEmu + 1);
+    memset(mpuEmu, 0, sizeof(*mpuEmu));
+
+    printf("IMU boot at %u kHz, %llu ms control tick, DMP verify %s\n", BUS_HZ / 1000U, TICK_NS / 1000000ULL,
+           MPU_DMP_VERIFY ? "on" : "off");
+    printf("%-24s %-5s %9s %11s %8s %9s %9s %8s\n", "scenario", "path", "init ms", "first ms", "load ms",
+           "DMP bytes", "transfers", "samples");
+
+    int ok = 1;
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+    ok &= boot("power on", 0);
+    uint64_t coldFirst = report->firstNs;
+
+    // MCU 复位，传感器保持供电：FIFO 在此期间溢出 | MCU reset with the sensor powered: the FIFO overflows meanwhile
+    Mpu6500Emu_Advance(mpuEmu, RESET_GAP_NS);
+    ok &= boot("MCU reset", 1);
+    uint64_t warmFirst = report->firstNs;
+
+    Mpu6500Emu_Advance(mpuEmu, RESET_GAP_NS);
+    ok &= boot("MCU reset again", 1);
+
+    // DMP 代码被改动：签名不符，必须重新上传 | DMP code altered: the signature no longer matches and the image is reloaded
+    mpuEmu->mem[0x0A80] ^= 0x01;
+    Mpu6500Emu_Advance(mpuEmu, RESET_GAP_NS);
+    ok &= boot("MCU reset, DMP altered", 0);
+
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+    ok &= boot("power cycle", 0);
+
+    ok &= warmFirst < coldFirst;
+    printf("time to first sample: cold %.1f ms, warm %.1f ms (%.1fx)\n", coldFirst / 1e6, warmFirst / 1e6,
+           (double)coldFirst / (double)warmFirst);
+    printf("%s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
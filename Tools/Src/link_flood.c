@@ -0,0 +1,357 @@
+/**
+  * @file    link_flood.c
+  * @brief   串口接收泛洪测试：pty 上的固件接收通道替身 | UART receive flood test against a pty stand-in for the firmware
+  *
+  * @note    用法 | Usage: dnb_link_flood [-n commands] [-b baud] [-w window] [-g gap_us] [--legacy] [--restart-us us]
+  *          设备线程在 pty 从端按波特率取字节，模拟循环 DMA（HT/TC/IDLE 事件）并运行固件同一份 UartRx 代码；
+  *          主线程作为上位机连续发送运动命令，测量应答延迟和字节丢失。
+  *          --legacy 模拟旧的处理方式：64 字节缓冲区，空闲中断里停止 DMA、解析、清零、重启，
+  *          重启期间到达的字节丢失。
+  *          A device thread drains the pty slave at the line rate, emulates circular DMA (HT/TC/IDLE
+  *          events) and runs the firmware's own UartRx code; the main thread acts as the host,
+  *          streaming motion commands and measuring ack latency and byte loss.
+  *          --legacy emulates the old handler: a 64-byte buffer that is stopped, parsed, cleared and
+  *          restarted on every idle interrupt, losing bytes that arrive during the restart.
+  */
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "protocol.h"
+#include "uart_rx.h"
+#include "command.h"
+
+/* 与 communication.h 保持一致 | Kept in sync with communication.h */
+#define RX_DMA_SIZE         256
+#define LEGACY_BUF_SIZE     64
+
+#define LOST_TIMEOUT_S      0.2     /**< 超过此时间未应答视为丢失 | Unacked for longer than this counts as lost */
+
+typedef struct {
+    /* 配置 | Configuration */
+    uint32_t baud;
+    int legacy;
+    double restartS;
+
+    /* pty */
+    int master;
+    int slave;
+    volatile int running;
+
+    /* 设备端 | Device side */
+    uint8_t dma[RX_DMA_SIZE];
+    uint16_t dmaSize;
+    uint16_t head;
+    UartRx rx;
+    uint32_t droppedBytes;  // 重启期间丢失（仅 legacy） | Lost during restarts (legacy only)
+
+    /* 上位机端 | Host side */
+    pthread_mutex_t lock;
+    double sendTime[256];
+    uint8_t outstanding[256];
+    uint32_t inFlight;
+    uint32_t acked;
+    uint32_t lost;
+    double *latency;
+    UartRxStats stats;
+    volatile int statsReady;
+} Link;
+
+static Link ln;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ------------------------------ 设备替身 | Device stand-in ------------------------------ */
+
+static void deviceSend(uint8_t type, uint8_t seq, const void *payload, uint8_t len) {
+    uint8_t buf[PROTOCOL_MAX_FRAME];
+    uint16_t n = Frame_Encode(type, seq, (const uint8_t *)payload, len, buf);
+    if (write(ln.slave, buf, n) < 0) {
+        perror("write");
+    }
+}
+
+/**
+  * @brief   固件 Link_HandleFrame 的命令应答部分；命令不入队，没有消费者也不会因队列满而停止应答
+  *          The command-ack part of the firmware's Link_HandleFrame; commands are not queued, so
+  *          with no consumer the acks never stop on a full queue
+  */
+static void deviceOnFrame(UartRx *rx, const Frame *frame) {
+    if (frame->type >= CMD_LEFT && frame->type <= CMD_STOP) {
+        UartRx_AcceptCommand(rx, frame);
+        deviceSend(frame->type, frame->seq, NULL, 0);
+    } else if (frame->type == MSG_LINK_STATS) {
+        deviceSend(MSG_LINK_STATS, frame->seq, &rx->stats, sizeof(rx->stats));
+    }
+}
+
+/**
+  * @brief   DMA 写入一个字节 | DMA writes one byte
+  */
+static void dmaWrite(uint8_t byte) {
+    ln.dma[ln.head++] = byte;
+    if (ln.legacy) {
+        if (ln.head == ln.dmaSize) ln.head = 0;  // 旧代码未处理 TC，数据被覆盖 | Old code ignored TC; data is overwritten
+        return;
+    }
+    if (ln.head == ln.dmaSize / 2) {
+        UartRx_Process(&ln.rx, ln.head);            // HT 事件 | HT event
+    } else if (ln.head == ln.dmaSize) {
+        ln.head = 0;
+        UartRx_Process(&ln.rx, ln.dmaSize);         // TC 事件 | TC event
+    }
+}
+
+/**
+  * @brief   空闲事件 | Idle-line event
+  * @return  legacy 模式下重启结束的时间 | End of the restart window in legacy mode
+  */
+static double idleEvent(double t) {
+    if (!ln.legacy) {
+        UartRx_Process(&ln.rx, ln.head);
+        return t;
+    }
+    // 旧流程：按线性缓冲区解析 [0, head)，清零并重启 DMA | Old flow: parse [0, head) as linear, clear, restart DMA
+    ln.rx.tail = 0;
+    UartRx_Process(&ln.rx, ln.head);
+    memset(ln.dma, 0, ln.dmaSize);
+    ln.head = 0;
+    ln.rx.tail = 0;
+    return t + ln.restartS;
+}
+
+static void *deviceThread(void *arg) {
+    (void)arg;
+    uint8_t tmp[64];
+    double t0 = now();
+    double charTime = 10.0 / ln.baud;
+    double lastByte = t0;
+    double deafUntil = 0;
+    uint64_t consumed = 0;
+    int pending = 0;
+
+    while (ln.running) {
+        double t = now();
+        uint64_t allowed = (uint64_t)((t - t0) / charTime);
+        uint64_t budget = allowed - consumed;
+        if (budget > sizeof(tmp)) budget = sizeof(tmp);
+
+        ssize_t n = (budget > 0) ? read(ln.slave, tmp, budget) : 0;
+        if (n > 0) {
+            for (ssize_t i = 0; i < n; i++) {
+                if (t < deafUntil) {
+                    ln.droppedBytes++;  // DMA 未运行 | DMA not running
+                } else {
+                    dmaWrite(tmp[i]);
+                }
+            }
+            consumed += (uint64_t)n;
+            lastByte = t;
+            pending = 1;
+        } else {
+            consumed = allowed;  // 线路空闲不积累额度 | An idle line accrues no credit
+            if (pending && t - lastByte > charTime) {
+                deafUntil = idleEvent(t);
+                pending = 0;
+            }
+            usleep(20);
+        }
+    }
+    return NULL;
+}
+
+/* ------------------------------ 上位机 | Host ------------------------------ */
+
+static void *hostReader(void *arg) {
+    (void)arg;
+    FrameParser parser;
+    Frame frame;
+    uint8_t buf[256];
+    FrameParser_Init(&parser);
+
+    while (ln.running) {
+        struct pollfd pfd = {.fd = ln.master, .events = POLLIN};
+        if (poll(&pfd, 1, 10) <= 0) continue;
+        ssize_t n = read(ln.master, buf, sizeof(buf));
+        double t = now();
+        for (ssize_t i = 0; i < n; i++) {
+            if (!FrameParser_Feed(&parser, buf[i], &frame)) continue;
+            if (frame.type == MSG_LINK_STATS) {
+                memcpy(&ln.stats, frame.payload, sizeof(ln.stats));
+                ln.statsReady = 1;
+                continue;
+            }
+            pthread_mutex_lock(&ln.lock);
+            if (ln.outstanding[frame.seq]) {
+                ln.outstanding[frame.seq] = 0;
+                ln.latency[ln.acked++] = t - ln.sendTime[frame.seq];
+                ln.inFlight--;
+            }
+            pthread_mutex_unlock(&ln.lock);
+        }
+    }
+    return NULL;
+}
+
+/**
+  * @brief   回收超时未应答的命令 | Retire commands that timed out
+  */
+static void expire(double t) {
+    for (int s = 0; s < 256; s++) {
+        if (ln.outstanding[s] && t - ln.sendTime[s] > LOST_TIMEOUT_S) {
+            ln.outstanding[s] = 0;
+            ln.lost++;
+            ln.inFlight--;
+        }
+    }
+}
+
+static int cmpDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static int openPty(void) {
+    ln.master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (ln.master < 0 || grantpt(ln.master) != 0 || unlockpt(ln.master) != 0) {
+        return -1;
+    }
+    ln.slave = open(ptsname(ln.master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (ln.slave < 0) {
+        return -1;
+    }
+    struct termios tio;
+    tcgetattr(ln.slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(ln.slave, TCSANOW, &tio);
+    tcgetattr(ln.master, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(ln.master, TCSANOW, &tio);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    uint32_t commands = 20000;
+    uint32_t window = 64;
+    double gapS = 0;
+
+    ln.baud = 115200;
+    ln.restartS = 20e-6;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            commands = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            ln.baud = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            window = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            gapS = atof(argv[++i]) * 1e-6;
+        } else if (strcmp(argv[i], "--legacy") == 0) {
+            ln.legacy = 1;
+        } else if (strcmp(argv[i], "--restart-us") == 0 && i + 1 < argc) {
+            ln.restartS = atof(argv[++i]) * 1e-6;
+        } else {
+            fprintf(stderr, "usage: %s [-n commands] [-b baud] [-w window] [-g gap_us] [--legacy] [--restart-us us]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (window > 128) window = 128;  // 保证 8 位序号无歧义 | Keeps 8-bit sequence numbers unambiguous
+
+    if (openPty() != 0) {
+        perror("pty");
+        return 1;
+    }
+    ln.dmaSize = ln.legacy ? LEGACY_BUF_SIZE : RX_DMA_SIZE;
+    ln.rx = newUartRx(ln.dma, ln.dmaSize, deviceOnFrame);
+    ln.latency = calloc(commands, sizeof(double));
+    ln.running = 1;
+    pthread_mutex_init(&ln.lock, NULL);
+
+    pthread_t dev, reader;
+    pthread_create(&dev, NULL, deviceThread, NULL);
+    pthread_create(&reader, NULL, hostReader, NULL);
+
+    // 连续发送，最多 window 条未应答 | Stream commands with at most `window` unacked
+    uint8_t buf[PROTOCOL_MAX_FRAME];
+    uint64_t bytesSent = 0;
+    double t0 = now();
+    for (uint32_t i = 0; i < commands; i++) {
+        for (;;) {
+            pthread_mutex_lock(&ln.lock);
+            expire(now());
+            int ok = ln.inFlight < window && !ln.outstanding[i & 0xFF];
+            pthread_mutex_unlock(&ln.lock);
+            if (ok) break;
+            usleep(50);
+        }
+        uint8_t type = (uint8_t)(CMD_LEFT + i % (CMD_STOP - CMD_LEFT + 1));
+        uint16_t n = Frame_Encode(type, (uint8_t)i, NULL, 0, buf);
+
+        pthread_mutex_lock(&ln.lock);
+        ln.sendTime[i & 0xFF] = now();
+        ln.outstanding[i & 0xFF] = 1;
+        ln.inFlight++;
+        pthread_mutex_unlock(&ln.lock);
+
+        if (write(ln.master, buf, n) != n) {
+            perror("write");
+            return 1;
+        }
+        bytesSent += n;
+        if (gapS > 0) usleep((useconds_t)(gapS * 1e6));
+    }
+
+    // 等待剩余应答 | Wait for the remaining acks
+    for (;;) {
+        pthread_mutex_lock(&ln.lock);
+        expire(now());
+        uint32_t left = ln.inFlight;
+        pthread_mutex_unlock(&ln.lock);
+        if (left == 0) break;
+        usleep(1000);
+    }
+    double elapsed = now() - t0;
+
+    // 读取设备统计 | Fetch device statistics
+    for (int attempt = 0; attempt < 5 && !ln.statsReady; attempt++) {
+        uint16_t n = Frame_Encode(MSG_LINK_STATS, 0, NULL, 0, buf);
+        if (write(ln.master, buf, n) != n) break;
+        usleep(100000);
+    }
+    ln.running = 0;
+    pthread_join(dev, NULL);
+    pthread_join(reader, NULL);
+
+    qsort(ln.latency, ln.acked, sizeof(double), cmpDouble);
+    double p50 = ln.acked ? ln.latency[ln.acked / 2] : 0;
+    double p99 = ln.acked ? ln.latency[(size_t)(ln.acked * 0.99)] : 0;
+    double max = ln.acked ? ln.latency[ln.acked - 1] : 0;
+
+    printf("mode          %s (baud %u, window %u)\n", ln.legacy ? "legacy stop/restart" : "circular DMA", ln.baud, window);
+    printf("commands      %u sent, %u acked, %u lost (%.2f%%)\n", commands, ln.acked, ln.lost,
+           100.0 * ln.lost / commands);
+    printf("throughput    %.0f cmd/s, line utilisation %.1f%%\n", ln.acked / elapsed,
+           100.0 * bytesSent * 10 / ln.baud / elapsed);
+    printf("ack latency   p50 %.2f ms, p99 %.2f ms, max %.2f ms\n", p50 * 1e3, p99 * 1e3, max * 1e3);
+    if (ln.statsReady) {
+        printf("device        %u/%llu bytes parsed (%.2f%% lost), %u frames, %u crc errors, %u cmd gaps, %u duplicates\n",
+               ln.stats.rxBytes, (unsigned long long)bytesSent,
+               100.0 * (1.0 - (double)ln.stats.rxBytes / bytesSent), ln.stats.frames, ln.stats.crcErrors,
+               ln.stats.cmdGaps, ln.stats.cmdDuplicates);
+    } else {
+        printf("device        no stats reply\n");
+    }
+    free(ln.latency);
+    return (ln.legacy || ln.lost == 0) ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+/**
+  * @file    log_schema.c
+  * @brief   固件记录的列式日志结构 | Columnar log schemas of the firmware records
+  */
+#include <stddef.h>
+#include "log_schema.h"
+#include "telemetry.h"
+#include "sensor_log.h"
+
+#define TELEMETRY_CHANNEL(type, name, tag) {#name, COLLOG_TYPE_OF(type), offsetof(TelemetryRecord, name)},
+
+const ColLogSchema telemetryLogSchema = {
+        .stream = "telemetry",
+        .recordSize = sizeof(TelemetryRecord),
+        .count = (uint8_t)(sizeof((ColLogChannel[]){TELEMETRY_FIELDS(TELEMETRY_CHANNEL)}) / sizeof(ColLogChannel)),
+        .channels = {TELEMETRY_FIELDS(TELEMETRY_CHANNEL)},
+};
+
+#define SENSOR_CHANNEL(name, field, type) {name, type, offsetof(SensorLogRecord, field)}
+
+/* 数组字段拆成单独的通道 | Array fields split into one channel per element */
+#define SENSOR_CHANNELS                                         \
+        SENSOR_CHANNEL("tick_ms",      tick_ms,      COLLOG_U32), \
+        SENSOR_CHANNEL("loop_us",      loop_us,      COLLOG_U16), \
+        SENSOR_CHANNEL("enc_l",        enc[0],       COLLOG_U16), \
+        SENSOR_CHANNEL("enc_r",        enc[1],       COLLOG_U16), \
+        SENSOR_CHANNEL("quat_w",       quat[0],      COLLOG_I32), \
+        SENSOR_CHANNEL("quat_x",       quat[1],      COLLOG_I32), \
+        SENSOR_CHANNEL("quat_y",       quat[2],      COLLOG_I32), \
+        SENSOR_CHANNEL("quat_z",       quat[3],      COLLOG_I32), \
+        SENSOR_CHANNEL("accel_x",      accel[0],     COLLOG_I16), \
+        SENSOR_CHANNEL("accel_y",      accel[1],     COLLOG_I16), \
+        SENSOR_CHANNEL("accel_z",      accel[2],     COLLOG_I16), \
+        SENSOR_CHANNEL("gyro_x",       gyro[0],      COLLOG_I16), \
+        SENSOR_CHANNEL("gyro_y",       gyro[1],      COLLOG_I16), \
+        SENSOR_CHANNEL("gyro_z",       gyro[2],      COLLOG_I16), \
+        SENSOR_CHANNEL("range",        range,        COLLOG_F32), \
+        SENSOR_CHANNEL("range_age_ms", range_age_ms, COLLOG_U32), \
+        SENSOR_CHANNEL("flags",        flags,        COLLOG_U8),  \
+        SENSOR_CHANNEL("ncmd",         ncmd,         COLLOG_U8),  \
+        SENSOR_CHANNEL("cmd0",         cmd[0],       COLLOG_U8),  \
+        SENSOR_CHANNEL("cmd1",         cmd[1],       COLLOG_U8),  \
+        SENSOR_CHANNEL("cmd2",         cmd[2],       COLLOG_U8),  \
+        SENSOR_CHANNEL("cmd3",         cmd[3],       COLLOG_U8)
+
+const ColLogSchema sensorLogSchema = {
+        .stream = "sensor_log",
+        .recordSize = sizeof(SensorLogRecord),
+        .count = (uint8_t)(sizeof((ColLogChannel[]){SENSOR_CHANNELS}) / sizeof(ColLogChannel)),
+        .channels = {SENSOR_CHANNELS},
+};
+
+_Static_assert(SENSOR_LOG_CMDS == 4, "add cmd channels to sensorLogSchema");
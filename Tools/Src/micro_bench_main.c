@@ -0,0 +1,222 @@
+/**
+  * @file    micro_bench_main.c
+  * @brief   热点函数微基准（主机） | Hot-function micro-benchmarks (host)
+  *
+  * @note    用法 | Usage: dnb_micro [-r repeats] [-o out.json]
+  *                        dnb_micro --compare a.json b.json
+  *          用例与输入见 micro_bench.c，与固件 MICRO_BENCH=1 时完全相同。被测源文件以 -O2 编译，
+  *          DMP 由寄存器级模拟器初始化，dmp_decode 解析的数据包布局与实机一致。每个样本计时若干批，
+  *          批数按约 1 ms 校准；各用例轮流重复，报告中位数及其 95% 置信区间（次序统计量）与扣除
+  *          空循环后的净值。主机给出的是 ns，不换算为 M4 周期：两种核心的流水线与浮点单元差别太大，
+  *          周期数以目标板的 DWT 测量为准。--compare 比较两份 JSON（主机或目标板输出）：同单位时
+  *          报告 b/a 与置信区间是否重叠，主机对目标板时报告每个函数的“周期/ns”换算系数。
+  *          The cases and inputs are in micro_bench.c, identical to the firmware built with
+  *          MICRO_BENCH=1. The sources under test are compiled at -O2 and the DMP is initialised
+  *          on the register-level emulator, so dmp_decode parses the real packet layout. Each
+  *          sample times a number of batches calibrated to about 1 ms; the cases repeat
+  *          round-robin and report the median with its 95% confidence interval (order
+  *          statistics) and the net value after the empty loop. The host reports ns and does not
+  *          convert them to M4 cycles: the pipelines and FPUs differ too much, and cycle counts
+  *          come from the target's DWT measurement. --compare compares two JSON files (host or
+  *          target output): with the same unit it reports b/a and whether the intervals overlap;
+  *          host against target gives each function's cycles-per-ns factor.
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "micro_bench.h"
+#include "MPU6500.h"
+#include "mpu6500_emu.h"
+
+#define BUS_HZ          400000U
+#define SAMPLE_NS       1000000.0       /**< 每个样本的目标时长 | Target duration of one sample */
+#define MAX_CASES       16
+#define DEFAULT_REPEATS 31
+
+static Mpu6500Emu emu;
+static fp32 samples[MAX_CASES][MICRO_BENCH_MAX_REPEATS];
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+  * @brief   一个样本：连续跑 batches 批，返回每次调用的 ns | One sample: run batches back to back, ns per call
+  */
+static fp32 timeCase(const MicroBenchCase *c, uint32_t batches) {
+    double t0 = nowNs();
+    for (uint32_t b = 0; b < batches; b++) {
+        c->Run();
+    }
+    return (fp32)((nowNs() - t0) / ((double)batches * MICRO_BENCH_BATCH));
+}
+
+static int bench(uint16_t repeats, FILE *out) {
+    uint8_t cases = microBenchCaseCount < MAX_CASES ? microBenchCaseCount : MAX_CASES;
+    uint32_t batches[MAX_CASES];
+
+    memset(&emu, 0, sizeof(emu));
+    mpuEmu = &emu;
+    Mpu6500Emu_PowerOn(&emu, BUS_HZ);
+    if (MPU_6500_Init() != 0) {
+        fprintf(stderr, "DMP init failed on the emulator\n");
+        return 1;
+    }
+
+    // 预热并校准批数 | Warm up and calibrate the batch count
+    for (uint8_t c = 0; c < cases; c++) {
+        microBenchCases[c].Setup();
+        batches[c] = 1;
+        while (timeCase(&microBenchCases[c], batches[c]) * (fp32)batches[c] * MICRO_BENCH_BATCH < SAMPLE_NS &&
+               batches[c] < (1u << 20)) {
+            batches[c] *= 2;
+        }
+    }
+    // 轮流执行，频率调节与其他进程的干扰平均分到每个用例 | Round-robin, so frequency scaling and other processes hit every case alike
+    for (uint16_t r = 0; r < repeats; r++) {
+        for (uint8_t c = 0; c < cases; c++) {
+            samples[c][r] = timeCase(&microBenchCases[c], batches[c]);
+        }
+    }
+
+    MicroBenchStats stats[MAX_CASES];
+    for (uint8_t c = 0; c < cases; c++) {
+        MicroBench_Summarise(samples[c], repeats, &stats[c]);
+    }
+    fprintf(out, "{\"target\":\"host\",\"unit\":\"ns\",\"compiler\":\"%s\",\"batch\":%u,\"cases\":[\n",
+            __VERSION__, MICRO_BENCH_BATCH);
+    for (uint8_t c = 0; c < cases; c++) {
+        const MicroBenchStats *s = &stats[c];
+        fprintf(out, "{\"name\":\"%s\",\"function\":\"%s\",\"n\":%u,\"median\":%.3f,\"ci_low\":%.3f,\"ci_high\":%.3f,"
+                     "\"min\":%.3f,\"mean\":%.3f,\"stddev\":%.3f,\"mad\":%.3f,\"net\":%.3f}%s\n",
+                microBenchCases[c].name, microBenchCases[c].function, s->n, s->median, s->ciLow, s->ciHigh,
+                s->min, s->mean, s->stddev, s->mad, s->median - stats[0].median, c + 1 < cases ? "," : "");
+    }
+    fprintf(out, "]}\n");
+    return 0;
+}
+
+/* --compare ------------------------------------------------------------------------------------*/
+
+typedef struct {
+    char name[32];
+    double median, ciLow, ciHigh;
+} CaseResult;
+
+typedef struct {
+    char target[32];
+    char unit[16];
+    uint8_t count;
+    CaseResult cases[MAX_CASES];
+} BenchFile;
+
+static int textField(const char *line, const char *key, char *value, size_t size) {
+    char pattern[40];
+    snprintf(pattern, sizeof(pattern), "\"%s\":\"", key);
+    const char *p = strstr(line, pattern);
+    if (p == NULL) return 0;
+    p += strlen(pattern);
+    size_t n = strcspn(p, "\"");
+    if (n >= size) n = size - 1;
+    memcpy(value, p, n);
+    value[n] = '\0';
+    return 1;
+}
+
+static int numberField(const char *line, const char *key, double *value) {
+    char pattern[40];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *p = strstr(line, pattern);
+    if (p == NULL) return 0;
+    *value = strtod(p + strlen(pattern), NULL);
+    return 1;
+}
+
+/**
+  * @brief   读取本工具或目标板打印的 JSON，每个用例一行 | Read JSON as printed by this tool or the target, one case per line
+  */
+static int loadBench(const char *path, BenchFile *file) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    memset(file, 0, sizeof(*file));
+    char line[512];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        textField(line, "target", file->target, sizeof(file->target));
+        textField(line, "unit", file->unit, sizeof(file->unit));
+        CaseResult r;
+        if (file->count < MAX_CASES && textField(line, "name", r.name, sizeof(r.name)) &&
+            numberField(line, "median", &r.median) && numberField(line, "ci_low", &r.ciLow) &&
+            numberField(line, "ci_high", &r.ciHigh)) {
+            file->cases[file->count++] = r;
+        }
+    }
+    fclose(f);
+    if (file->count == 0 || file->unit[0] == '\0') {
+        fprintf(stderr, "%s: no benchmark results\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static int compare(const char *pathA, const char *pathB) {
+    static BenchFile a, b;
+    if (loadBench(pathA, &a) != 0 || loadBench(pathB, &b) != 0) {
+        return 1;
+    }
+    int sameUnit = strcmp(a.unit, b.unit) == 0;
+    printf("a: %s (%s, %s)\nb: %s (%s, %s)\n", pathA, a.target, a.unit, pathB, b.target, b.unit);
+    printf("%-16s %12s %12s %10s  %s\n", "case", a.unit, b.unit, sameUnit ? "b/a" : "b per a", sameUnit ? "95% CI" : "");
+    for (uint8_t i = 0; i < a.count; i++) {
+        const CaseResult *ra = &a.cases[i], *rb = NULL;
+        for (uint8_t j = 0; j < b.count; j++) {
+            if (strcmp(b.cases[j].name, ra->name) == 0) rb = &b.cases[j];
+        }
+        if (rb == NULL) {
+            printf("%-16s %12.2f %12s\n", ra->name, ra->median, "-");
+            continue;
+        }
+        const char *verdict = "";
+        if (sameUnit) {
+            verdict = rb->ciLow > ra->ciHigh ? "slower" : rb->ciHigh < ra->ciLow ? "faster" : "overlap";
+        }
+        printf("%-16s %12.2f %12.2f %10.3f  %s\n", ra->name, ra->median, rb->median,
+               ra->median > 0.0 ? rb->median / ra->median : 0.0, verdict);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    uint16_t repeats = DEFAULT_REPEATS;
+    const char *outPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc) {
+            return compare(argv[i + 1], argv[i + 2]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            int r = atoi(argv[++i]);
+            repeats = (uint16_t)(r < 3 ? 3 : r > MICRO_BENCH_MAX_REPEATS ? MICRO_BENCH_MAX_REPEATS : r);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [-r repeats] [-o out.json]\n       %s --compare a.json b.json\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *out = stdout;
+    if (outPath != NULL && (out = fopen(outPath, "w")) == NULL) {
+        perror(outPath);
+        return 1;
+    }
+    int ret = bench(repeats, out);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return ret;
+}
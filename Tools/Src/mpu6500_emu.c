@@ -0,0 +1,374 @@
+#include "mpu6500_emu.h"
+#include "i2c_bus.h"
+#include <math.h>
+#include <string.h>
+
+/* 寄存器地址与位 | Register addresses and bits */
+#define REG_GYRO_CONFIG     0x1B
+#define REG_ACCEL_CONFIG    0x1C
+#define REG_INT_STATUS      0x3A
+#define REG_USER_CTRL       0x6A
+#define REG_PWR_MGMT_1      0x6B
+#define REG_BANK_SEL        0x6D
+#define REG_MEM_START_ADDR  0x6E
+#define REG_MEM_R_W         0x6F
+#define REG_PRGM_START_H    0x70
+#define REG_PRGM_START_L    0x71
+#define REG_FIFO_COUNT_H    0x72
+#define REG_FIFO_COUNT_L    0x73
+#define REG_FIFO_R_W        0x74
+#define REG_WHO_AM_I        0x75
+
+#define BIT_FIFO_OVERFLOW   0x10
+#define BIT_DMP_EN          0x80
+#define BIT_FIFO_EN         0x40
+#define BIT_DMP_RST         0x08
+#define BIT_FIFO_RST        0x04
+#define BIT_RESET           0x80
+#define BIT_SLEEP           0x40
+
+#define DMP_START_ADDR      0x0400      /**< 运动驱动固件的程序入口 | Motion driver program entry */
+#define DMP_RATE_DIV        (22 + 512)  /**< D_0_22：FIFO 输出分频 | D_0_22: FIFO output divider */
+
+/* 驱动写入的特性配置（见 inv_mpu_dmp_motion_driver.c） | Feature configuration written by the driver (see inv_mpu_dmp_motion_driver.c) */
+#define CFG_LP_QUAT         2712        /**< DINBC0 起：3 轴四元数 | DINBC0...: 3-axis quaternion */
+#define CFG_8               2718        /**< DINA20 起：6 轴四元数 | DINA20...: 6-axis quaternion */
+#define CFG_15              2727        /**< [1] = 0xC0 原始加速度，[4] = 0xC4 陀螺 | [1] = 0xC0 raw accel, [4] = 0xC4 gyro */
+#define CFG_27              2742        /**< DINA20：手势字 | DINA20: gesture word */
+#define DINA20              0x20
+#define DINBC0              0xC0
+
+Mpu6500Emu *mpuEmu;
+
+static void deviceReset(Mpu6500Emu *emu) {
+    memset(emu->reg, 0, sizeof(emu->reg));
+    memset(emu->mem, 0, sizeof(emu->mem));
+    emu->reg[REG_PWR_MGMT_1] = 0x01;
+    emu->reg[REG_WHO_AM_I] = 0x70;
+    emu->fifoHead = 0;
+    emu->fifoCount = 0;
+    emu->resets++;
+}
+
+void Mpu6500Emu_PowerOn(Mpu6500Emu *emu, uint32_t busHz) {
+    emu->busHz = busHz;
+    deviceReset(emu);
+    Mpu6500Emu_Script(emu, NULL, 0);
+    emu->q[0] = 1.0;
+    emu->q[1] = emu->q[2] = emu->q[3] = 0.0;
+}
+
+void Mpu6500Emu_Script(Mpu6500Emu *emu, const Mpu6500EmuSegment *segments, uint8_t n) {
+    if (n > MPU6500_EMU_SCRIPT) n = MPU6500_EMU_SCRIPT;
+    if (n > 0) memcpy(emu->script, segments, n * sizeof(Mpu6500EmuSegment));
+    emu->scriptLen = n;
+    emu->segment = 0;
+    emu->segmentStart = emu->now;
+    emu->motionNow = emu->now;
+}
+
+/* 运动轨迹 | Motion script ---------------------------------------------------*/
+
+static const float *segmentRate(const Mpu6500Emu *emu) {
+    static const float rest[3] = {0.0f, 0.0f, 0.0f};
+    return (emu->segment < emu->scriptLen) ? emu->script[emu->segment].rate : rest;
+}
+
+/**
+  * @brief   以恒定机体角速度转动 dt：右乘旋转四元数（精确解） | Rotate at constant body rates for dt: right-multiply by the rotation quaternion (exact)
+  */
+static void rotate(double q[4], const float rate[3], double dt) {
+    double w[3] = {rate[0] * M_PI / 180.0, rate[1] * M_PI / 180.0, rate[2] * M_PI / 180.0};
+    double norm = sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+    if (norm == 0.0) return;
+    double half = 0.5 * norm * dt;
+    double s = sin(half) / norm;
+    double d[4] = {cos(half), w[0] * s, w[1] * s, w[2] * s};
+    double r[4] = {
+        q[0] * d[0] - q[1] * d[1] - q[2] * d[2] - q[3] * d[3],
+        q[0] * d[1] + q[1] * d[0] + q[2] * d[3] - q[3] * d[2],
+        q[0] * d[2] - q[1] * d[3] + q[2] * d[0] + q[3] * d[1],
+        q[0] * d[3] + q[1] * d[2] - q[2] * d[1] + q[3] * d[0],
+    };
+    double n = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+    for (uint8_t i = 0; i < 4; i++) q[i] = r[i] / n;
+}
+
+/**
+  * @brief   把姿态积分到时刻 t，按段边界分步 | Integrate the attitude up to time t, stepping at segment boundaries
+  */
+static void moveTo(Mpu6500Emu *emu, uint64_t t) {
+    while (emu->motionNow < t) {
+        uint64_t end = t;
+        bool_t segmentEnds = FALSE;
+        if (emu->segment < emu->scriptLen) {
+            uint64_t segmentEnd = emu->segmentStart + (uint64_t)emu->script[emu->segment].ms * 1000000ULL;
+            if (segmentEnd <= end) {
+                end = segmentEnd;
+                segmentEnds = TRUE;
+            }
+        }
+        rotate(emu->q, segmentRate(emu), (double)(end - emu->motionNow) * 1e-9);
+        emu->motionNow = end;
+        if (segmentEnds) {
+            emu->segment++;
+            emu->segmentStart = end;
+        }
+    }
+}
+
+void Mpu6500Emu_Euler(const Mpu6500Emu *emu, float rpy[3]) {
+    const double *q = emu->q;
+    rpy[0] = (float)(atan2(2 * q[2] * q[3] + 2 * q[0] * q[1], -2 * q[1] * q[1] - 2 * q[2] * q[2] + 1) * 57.3);
+    rpy[1] = (float)(asin(-2 * q[1] * q[3] + 2 * q[0] * q[2]) * 57.3);
+    rpy[2] = (float)(atan2(2 * (q[1] * q[2] + q[0] * q[3]), q[0] * q[0] + q[1] * q[1] - q[2] * q[2] - q[3] * q[3]) * 57.3);
+}
+
+/* DMP 数据包 | DMP packets ---------------------------------------------------*/
+
+static bool_t quatEnabled(const Mpu6500Emu *emu) {
+    return emu->mem[CFG_LP_QUAT] == DINBC0 || emu->mem[CFG_8] == DINA20;
+}
+
+uint8_t Mpu6500Emu_PacketLength(const Mpu6500Emu *emu) {
+    uint8_t len = 0;
+    if (quatEnabled(emu)) len += 16;
+    if (emu->mem[CFG_15 + 1] == 0xC0) len += 6;
+    if (emu->mem[CFG_15 + 4] == 0xC4) len += 6;
+    if (emu->mem[CFG_27] == DINA20) len += 4;
+    return len;
+}
+
+static uint8_t *putBig(uint8_t *p, int32_t value, uint8_t bytes) {
+    for (uint8_t i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)((uint32_t)value >> (8 * (bytes - 1 - i)));
+    }
+    return p + bytes;
+}
+
+static int16_t saturate16(double v) {
+    if (v > 32767.0) return 32767;
+    if (v < -32768.0) return -32768;
+    return (int16_t)lrint(v);
+}
+
+static bool_t dmpRunning(const Mpu6500Emu *emu) {
+    uint16_t start = (uint16_t)((emu->reg[REG_PRGM_START_H] << 8) | emu->reg[REG_PRGM_START_L]);
+    return (emu->reg[REG_USER_CTRL] & (BIT_DMP_EN | BIT_FIFO_EN)) == (BIT_DMP_EN | BIT_FIFO_EN)
+           && !(emu->reg[REG_PWR_MGMT_1] & BIT_SLEEP)
+           && start == DMP_START_ADDR && emu->mem[DMP_START_ADDR] != 0;
+}
+
+static uint64_t dmpPeriod(const Mpu6500Emu *emu) {
+    uint16_t div = (uint16_t)((emu->mem[DMP_RATE_DIV] << 8) | emu->mem[DMP_RATE_DIV + 1]);
+    return 1000000000ULL * (div + 1U) / MPU6500_EMU_DMP_HZ;
+}
+
+/**
+  * @brief   写入 FIFO：满时覆盖最旧数据并置溢出位，与芯片默认的 FIFO 模式相同
+  *          Write into the FIFO: a full FIFO overwrites its oldest bytes and flags the overflow,
+  *          as in the chip's default FIFO mode
+  */
+static void fifoPush(Mpu6500Emu *emu, const uint8_t *packet, uint8_t len) {
+    if (emu->fifoCount + len > MPU6500_EMU_FIFO) {
+        uint16_t drop = (uint16_t)(emu->fifoCount + len - MPU6500_EMU_FIFO);
+        emu->fifoHead = (uint16_t)((emu->fifoHead + drop) % MPU6500_EMU_FIFO);
+        emu->fifoCount -= drop;
+        emu->reg[REG_INT_STATUS] |= BIT_FIFO_OVERFLOW;
+        emu->overflows++;
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        emu->fifo[(emu->fifoHead + emu->fifoCount + i) % MPU6500_EMU_FIFO] = packet[i];
+    }
+    emu->fifoCount += len;
+    emu->packets++;
+}
+
+/**
+  * @brief   按当前姿态写入一包：四元数 (Q30)、机体系重力、机体角速度、手势字（空）
+  *          Push one packet for the current attitude: quaternion (Q30), gravity in the body frame,
+  *          body rates and an empty gesture word
+  * @note    数据已是 DMP 按安装方向换算后的机体系；量程取自 GYRO_CONFIG/ACCEL_CONFIG
+  *          Data is already in the body frame the DMP outputs after orientation; full scales
+  *          come from GYRO_CONFIG/ACCEL_CONFIG
+  */
+static void pushPacket(Mpu6500Emu *emu) {
+    uint8_t packet[MPU6500_EMU_PACKET_MAX] = {0};
+    uint8_t *p = packet;
+    const double *q = emu->q;
+    if (quatEnabled(emu)) {
+        for (uint8_t i = 0; i < 4; i++) {
+            p = putBig(p, (int32_t)lrint(q[i] * 1073741824.0), 4);
+        }
+    }
+    if (emu->mem[CFG_15 + 1] == 0xC0) {
+        double lsb = 16384.0 / (1 << ((emu->reg[REG_ACCEL_CONFIG] >> 3) & 3));
+        double g[3] = {2 * (q[1] * q[3] - q[0] * q[2]), 2 * (q[0] * q[1] + q[2] * q[3]),
+                       1 - 2 * (q[1] * q[1] + q[2] * q[2])};
+        for (uint8_t i = 0; i < 3; i++) {
+            p = putBig(p, saturate16(g[i] * lsb), 2);
+        }
+    }
+    if (emu->mem[CFG_15 + 4] == 0xC4) {
+        double lsb = 32768.0 / (250 << ((emu->reg[REG_GYRO_CONFIG] >> 3) & 3));
+        const float *rate = segmentRate(emu);
+        for (uint8_t i = 0; i < 3; i++) {
+            p = putBig(p, saturate16(rate[i] * lsb), 2);
+        }
+    }
+    fifoPush(emu, packet, Mpu6500Emu_PacketLength(emu));
+}
+
+int Mpu6500Emu_Inject(Mpu6500Emu *emu, const uint8_t *packet, uint8_t len) {
+    if (!dmpRunning(emu)) {
+        return -1;
+    }
+    fifoPush(emu, packet, len);
+    return 0;
+}
+
+void Mpu6500Emu_Advance(Mpu6500Emu *emu, uint64_t ns) {
+    uint64_t end = emu->now + ns;
+    if (!dmpRunning(emu) || emu->external) {
+        emu->nextPacket = end + dmpPeriod(emu);
+    } else {
+        while (emu->nextPacket <= end) {
+            emu->now = emu->nextPacket;
+            moveTo(emu, emu->now);
+            pushPacket(emu);
+            emu->nextPacket += dmpPeriod(emu);
+        }
+    }
+    emu->now = end;
+    moveTo(emu, end);
+}
+
+/**
+  * @brief   线上时间：每字节 9 位，另加起始/重复起始/停止 | Wire time: nine bits per byte plus start, repeated start and stop
+  */
+static void wireTime(Mpu6500Emu *emu, uint32_t bytes, uint32_t conditions) {
+    emu->transfers++;
+    Mpu6500Emu_Advance(emu, (uint64_t)(bytes * 9U + conditions) * 1000000000ULL / emu->busHz);
+}
+
+static uint8_t *memByte(Mpu6500Emu *emu) {
+    uint16_t addr = (uint16_t)((emu->reg[REG_BANK_SEL] << 8) | emu->reg[REG_MEM_START_ADDR]);
+    emu->reg[REG_MEM_START_ADDR]++;
+    return &emu->mem[addr % MPU6500_EMU_MEM];
+}
+
+static void writeReg(Mpu6500Emu *emu, uint8_t reg, uint8_t value) {
+    switch (reg) {
+        case REG_PWR_MGMT_1:
+            if (value & BIT_RESET) {
+                deviceReset(emu);
+                return;
+            }
+            break;
+        case REG_USER_CTRL:
+            if (value & BIT_FIFO_RST) {
+                emu->fifoHead = 0;
+                emu->fifoCount = 0;
+            }
+            if ((value & BIT_DMP_RST) || ((value & BIT_DMP_EN) && !(emu->reg[reg] & BIT_DMP_EN))) {
+                emu->nextPacket = emu->now + dmpPeriod(emu);
+            }
+            value &= (uint8_t)~(BIT_DMP_RST | BIT_FIFO_RST);   // 自清零 | Self-clearing
+            break;
+        case REG_MEM_R_W:
+            *memByte(emu) = value;
+            emu->memWritten++;
+            return;
+        case REG_FIFO_R_W:
+        case REG_FIFO_COUNT_H:
+        case REG_FIFO_COUNT_L:
+        case REG_WHO_AM_I:
+            return;
+        default:
+            break;
+    }
+    emu->reg[reg] = value;
+}
+
+static uint8_t readReg(Mpu6500Emu *emu, uint8_t reg) {
+    uint8_t value;
+    switch (reg) {
+        case REG_INT_STATUS:
+            value = emu->reg[reg];
+            emu->reg[reg] = 0;      // 读清零 | Cleared on read
+            return value;
+        case REG_MEM_R_W:
+            return *memByte(emu);
+        case REG_FIFO_COUNT_H:
+            return (uint8_t)(emu->fifoCount >> 8);
+        case REG_FIFO_COUNT_L:
+            return (uint8_t)emu->fifoCount;
+        case REG_FIFO_R_W:
+            if (emu->fifoCount == 0) return 0;
+            value = emu->fifo[emu->fifoHead];
+            emu->fifoHead = (uint16_t)((emu->fifoHead + 1) % MPU6500_EMU_FIFO);
+            emu->fifoCount--;
+            return value;
+        default:
+            return emu->reg[reg];
+    }
+}
+
+/* MEM_R_W 与 FIFO_R_W 突发访问时地址不递增 | MEM_R_W and FIFO_R_W do not auto-increment in a burst */
+static uint8_t burstReg(uint8_t reg, uint16_t i) {
+    if (reg == REG_MEM_R_W || reg == REG_FIFO_R_W) return reg;
+    return (uint8_t)((reg + i) % MPU6500_EMU_REGS);
+}
+
+/**
+  * @brief   注入的无应答：地址字节后即停止 | Injected NACK: the transfer stops after the address byte
+  */
+static bool_t nack(Mpu6500Emu *emu) {
+    if (emu->failCount == 0 || emu->failAt == 0 || emu->transfers + 1 < emu->failAt) return FALSE;
+    emu->failCount--;
+    emu->nacks++;
+    wireTime(emu, 1U, 2U);
+    return TRUE;
+}
+
+int Mpu6500Emu_Write(Mpu6500Emu *emu, uint8_t reg, uint16_t len, const uint8_t *data) {
+    if (nack(emu)) return -1;
+    wireTime(emu, 2U + len, 2U);
+    for (uint16_t i = 0; i < len; i++) {
+        writeReg(emu, burstReg(reg, i), data[i]);
+    }
+    return 0;
+}
+
+int Mpu6500Emu_Read(Mpu6500Emu *emu, uint8_t reg, uint16_t len, uint8_t *data) {
+    if (nack(emu)) return -1;
+    wireTime(emu, 3U + len, 3U);
+    for (uint16_t i = 0; i < len; i++) {
+        data[i] = readReg(emu, burstReg(reg, i));
+    }
+    return 0;
+}
+
+/* 主机端 i2c_bus.h | Host i2c_bus.h ----------------------------------------*/
+
+int I2C_Bus_Write(uint8_t addr, uint8_t reg, uint16_t len, uint8_t *data) {
+    if (addr != MPU6500_EMU_ADDR) return -1;
+    return Mpu6500Emu_Write(mpuEmu, reg, len, data);
+}
+
+int I2C_Bus_Read(uint8_t addr, uint8_t reg, uint16_t len, uint8_t *data) {
+    if (addr != MPU6500_EMU_ADDR) return -1;
+    return Mpu6500Emu_Read(mpuEmu, reg, len, data);
+}
+
+uint32_t I2C_Bus_Errors(uint8_t client) {
+    return (client == I2C_CLIENT_IMU) ? mpuEmu->nacks : 0;
+}
+
+void HAL_Delay(uint32_t ms) {
+    Mpu6500Emu_Advance(mpuEmu, (uint64_t)ms * 1000000ULL);
+}
+
+uint32_t HAL_GetTick(void) {
+    return (uint32_t)(mpuEmu->now / 1000000ULL);
+}
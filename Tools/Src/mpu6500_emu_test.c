@@ -0,0 +1,414 @@
+/**
+  * @file    mpu6500_emu_test.c
+  * @brief   MPU6500 模拟器与驱动栈的主机测试 | Host test of the MPU6500 emulator and the driver stack
+  *
+  * @note    MPU6500.c 与 InvenSense 驱动原样编译，经 i2c_read/i2c_write 宏接到寄存器级模拟器。
+  *          检查寄存器文件与分 bank 的 DMP 存储器、初始化后的数据包布局与速率、DMP 输出跟随脚本轨迹、
+  *          FIFO 溢出的检测与复位、读 FIFO 失败后的重新对齐，并在冷/热初始化的每一次传输上注入 NACK：
+  *          初始化要么报错，要么得到可用的数据，报错后重试必须成功；最后检查 Imu 在初始化失败后
+  *          按退避间隔自行重试，以及保存的零偏在重启后写入 DMP。
+  *          每个需要全新驱动状态的用例在 fork 出的子进程中运行。
+  *          MPU6500.c and the InvenSense driver are compiled unchanged and reach the
+  *          register-level emulator through the i2c_read/i2c_write macros. Checks the register
+  *          file and banked DMP memory, the packet layout and rate after init, DMP output
+  *          following a scripted trajectory, FIFO overflow detection and reset, and realignment
+  *          after a failed FIFO read; then a NACK is injected at every transfer of the cold and
+  *          warm init: the init must either report an error or deliver usable data, and a retry
+  *          after an error must succeed. Last, the Imu must retry a failed init by itself after
+  *          its backoff, and biases saved to the store must reach the DMP after a reboot. Cases that need fresh driver state run in a forked
+  *          child.
+  */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "MPU6500.h"
+#include "inv_mpu.h"
+#include "imu.h"
+#include "param_store.h"
+#include "mpu6500_emu.h"
+#include "check.h"
+
+#define BUS_HZ          400000U
+#define TICK_NS         10000000ULL     /**< 控制周期 | Control tick */
+#define FIFO_HZ         100             /**< MPU6500.c 设定的 DMP 输出率 | DMP output rate set by MPU6500.c */
+#define PACKET_LEN      32              /**< 6 轴四元数 + 加速度 + 陀螺 + 手势 | 6-axis quaternion + accel + gyro + gesture */
+#define SETTLE_MS       300             /**< 注入故障后检查数据的时间 | Time data is checked after an injected fault */
+
+extern ParamStore paramStore;
+static uint8_t flash[2 * 16384];
+
+typedef struct {
+    float pitch, roll, yaw, ax, ay, az, gx, gy, gz;
+} Sample;
+
+static int readSample(Sample *s) {
+    return MPU6500_DMP_Get_Data(&s->pitch, &s->roll, &s->yaw, &s->ax, &s->ay, &s->az, &s->gx, &s->gy, &s->gz);
+}
+
+/**
+  * @brief   推进到下一个控制周期 | Advance to the next control tick
+  */
+static void nextTick(void) {
+    Mpu6500Emu_Advance(mpuEmu, TICK_NS - mpuEmu->now % TICK_NS);
+}
+
+/**
+  * @brief   在子进程中运行（驱动静态状态从零开始），返回其失败数 | Run in a child (driver statics start from zero) and return its failure count
+  */
+static int inChild(int (*fn)(void)) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        int result = fn();
+        fflush(stdout);
+        _exit(result);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+/* 寄存器文件与 DMP 存储器 | Register file and DMP memory -------------------*/
+
+static void testRegisters(void) {
+    printf("registers and DMP memory\n");
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+    uint8_t v[16];
+
+    Mpu6500Emu_Read(mpuEmu, 0x75, 1, v);
+    CHECK(v[0] == 0x70, "WHO_AM_I %02X", v[0]);
+
+    uint64_t t0 = mpuEmu->now;
+    uint8_t scratch[4] = {0x12, 0x34, 0x56, 0x78};
+    Mpu6500Emu_Write(mpuEmu, 0x63, 4, scratch);
+    CHECK(mpuEmu->now - t0 == (6U * 9U + 2U) * 2500ULL, "4-byte write took %llu ns", (unsigned long long)(mpuEmu->now - t0));
+    Mpu6500Emu_Read(mpuEmu, 0x63, 4, v);
+    CHECK(memcmp(v, scratch, 4) == 0, "burst write/read does not auto-increment");
+
+    // bank 3 末尾：MEM_R_W 突发不递增寄存器地址，存储器地址递增 | End of bank 3: a MEM_R_W burst keeps the register, the memory address increments
+    uint8_t sel[2] = {3, 0xF0}, pattern[16];
+    for (uint8_t i = 0; i < 16; i++) pattern[i] = (uint8_t)(0xA0 + i);
+    Mpu6500Emu_Write(mpuEmu, 0x6D, 2, sel);
+    Mpu6500Emu_Write(mpuEmu, 0x6F, 16, pattern);
+    Mpu6500Emu_Write(mpuEmu, 0x6D, 2, sel);
+    Mpu6500Emu_Read(mpuEmu, 0x6F, 16, v);
+    CHECK(memcmp(v, pattern, 16) == 0 && memcmp(&mpuEmu->mem[0x3F0], pattern, 16) == 0, "bank memory readback differs");
+    CHECK(mpuEmu->reg[0x70] == 0, "MEM_R_W burst spilled into PRGM_START");
+
+    uint8_t reset = 0x80;
+    Mpu6500Emu_Write(mpuEmu, 0x6B, 1, &reset);
+    Mpu6500Emu_Read(mpuEmu, 0x63, 4, v);
+    CHECK(v[0] == 0 && v[3] == 0 && mpuEmu->mem[0x3F0] == 0, "device reset kept registers or memory");
+}
+
+/* 初始化与轨迹 | Init and trajectory -----------------------------------------*/
+
+static const Mpu6500EmuSegment trajectory[] = {
+    {500,  {0.0f, 0.0f, 0.0f}},
+    {1000, {0.0f, 30.0f, 0.0f}},    // 俯仰到 +30° | Pitch to +30°
+    {500,  {0.0f, 0.0f, 0.0f}},
+    {2000, {0.0f, -30.0f, 0.0f}},   // 俯仰到 -30°（四元数分量为负） | Pitch to -30° (negative quaternion components)
+    {500,  {0.0f, 0.0f, 0.0f}},
+    {1000, {0.0f, 30.0f, 0.0f}},    // 回到水平 | Back to level
+    {1000, {20.0f, 0.0f, 0.0f}},    // 横滚 | Roll
+    {1000, {-20.0f, 0.0f, 20.0f}},  // 横滚回正并偏航 | Roll back while yawing
+    {1000, {0.0f, 0.0f, 25.0f}},    // 纯偏航 | Pure yaw
+};
+
+static float wrap180(float a) {
+    return remainderf(a, 360.0f);
+}
+
+static int childTrajectory(void) {
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+    CHECK(MPU_6500_Init() == 0, "cold init failed");
+    CHECK(Mpu6500Emu_PacketLength(mpuEmu) == PACKET_LEN, "packet length %u", Mpu6500Emu_PacketLength(mpuEmu));
+
+    uint32_t packets = mpuEmu->packets;
+    Mpu6500Emu_Advance(mpuEmu, 1000000000ULL);
+    CHECK(mpuEmu->packets - packets == FIFO_HZ, "%u packets in 1 s", mpuEmu->packets - packets);
+    uint8_t user = 0x04 | 0x08 | 0x80 | 0x40;   // FIFO_RST | DMP_RST | DMP_EN | FIFO_EN
+    Mpu6500Emu_Write(mpuEmu, 0x6A, 1, &user);
+
+    Mpu6500Emu_Script(mpuEmu, trajectory, sizeof(trajectory) / sizeof(trajectory[0]));
+    uint32_t ms = 0;
+    for (uint8_t i = 0; i < sizeof(trajectory) / sizeof(trajectory[0]); i++) ms += trajectory[i].ms;
+
+    float worst[3] = {0}, worstAccel = 0.0f, worstGyro = 0.0f;
+    uint32_t samples = 0;
+    for (uint32_t t = 0; t < ms + 200; t += 10) {
+        nextTick();
+        Sample s;
+        if (readSample(&s) != 0) continue;
+        samples++;
+        // 读到的是最旧的一包，最多晚一个周期 | The oldest packet is read, at most one period old
+        float rpy[3];
+        Mpu6500Emu_Euler(mpuEmu, rpy);
+        float got[3] = {s.roll, s.pitch, s.yaw};
+        for (uint8_t i = 0; i < 3; i++) {
+            float e = fabsf(wrap180(got[i] - rpy[i]));
+            if (e > worst[i]) worst[i] = e;
+        }
+        float e = fabsf(s.ax + sinf(s.pitch / 57.3f));
+        if (fabsf(s.roll) < 0.5f && e > worstAccel) worstAccel = e;
+        // 陀螺按 ±2000 °/s 量程输出，段内（离边界 30 ms 以上）应等于脚本角速度
+        // Gyro output is at the ±2000 °/s range and equals the script rate inside a segment (30 ms from its edges)
+        uint64_t into = mpuEmu->now - mpuEmu->segmentStart;
+        if (mpuEmu->segment < mpuEmu->scriptLen && into > 30000000ULL
+            && into + 30000000ULL < mpuEmu->script[mpuEmu->segment].ms * 1000000ULL) {
+            const float *rate = mpuEmu->script[mpuEmu->segment].rate;
+            float raw[3] = {s.gx * 65.5f, s.gy * 65.5f, s.gz * 65.5f};
+            for (uint8_t i = 0; i < 3; i++) {
+                float g = fabsf(raw[i] - rate[i] * 16.384f);
+                if (g > worstGyro) worstGyro = g;
+            }
+        }
+    }
+    float rpy[3];
+    Mpu6500Emu_Euler(mpuEmu, rpy);
+    printf("  %u samples, worst error roll %.2f pitch %.2f yaw %.2f deg, accel %.4f g, gyro %.1f LSB; final yaw %.1f\n",
+           samples, worst[0], worst[1], worst[2], worstAccel, worstGyro, rpy[2]);
+    CHECK(samples >= (ms + 200) / 10 - 2, "only %u samples", samples);
+    CHECK(worst[0] < 0.5f && worst[1] < 0.5f && worst[2] < 0.7f, "attitude does not follow the trajectory");
+    CHECK(fabsf(rpy[2] - 45.0f) < 0.5f, "final yaw %.2f", rpy[2]);
+    CHECK(worstAccel < 0.01f, "accel does not match gravity: %.4f g", worstAccel);
+    CHECK(worstGyro <= 1.0f, "gyro off by %.1f LSB", worstGyro);
+    return failures;
+}
+
+/* FIFO 溢出与重新对齐 | FIFO overflow and realignment ------------------------*/
+
+static int childFifo(void) {
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+    CHECK(MPU_6500_Init() == 0, "cold init failed");
+
+    // 1 s 不读：FIFO 满后覆盖最旧数据并置溢出位 | No reads for 1 s: the full FIFO overwrites its oldest bytes and flags the overflow
+    Mpu6500Emu_Advance(mpuEmu, 1000000000ULL);
+    CHECK(mpuEmu->fifoCount == MPU6500_EMU_FIFO && mpuEmu->overflows > 0 && (mpuEmu->reg[0x3A] & 0x10),
+          "FIFO %u bytes, %u overflows", mpuEmu->fifoCount, mpuEmu->overflows);
+    Sample s;
+    uint64_t t0 = mpuEmu->now;
+    CHECK(readSample(&s) != 0, "overflow not reported");
+    CHECK(mpuEmu->fifoCount == 0, "FIFO not reset after the overflow (%u bytes)", mpuEmu->fifoCount);
+    CHECK(mpuEmu->now - t0 < TICK_NS, "the overflow reset blocked for %.1f ms", (mpuEmu->now - t0) / 1e6);
+    uint8_t ticks = 0;
+    do {
+        nextTick();
+        ticks++;
+    } while (readSample(&s) != 0 && ticks < 20);
+    CHECK(ticks <= 8 && fabsf(s.pitch) < 0.1f, "no valid sample %u ticks after the overflow reset", ticks);
+
+    // 读 FIFO 时 NACK：下一次读取前重新对齐，复位不阻塞控制周期 | NACK during a FIFO read: realigned before the next read, without blocking the tick
+    printf("  overflow: %u bytes kept, reported and reset, first sample after %u ticks\n", MPU6500_EMU_FIFO, ticks);
+    uint32_t resyncs = MPU6500_FIFO_Resyncs();
+    mpuEmu->failAt = mpuEmu->transfers + 2;     // 计数已读到，数据读取失败 | The count is read, the data read fails
+    mpuEmu->failCount = 1;
+    nextTick();
+    CHECK(readSample(&s) != 0, "failed FIFO read not reported");
+    nextTick();
+    t0 = mpuEmu->now;
+    CHECK(readSample(&s) != 0 && MPU6500_FIFO_Resyncs() == resyncs + 1, "no resync after the failed read");
+    CHECK(mpuEmu->now - t0 < TICK_NS, "the resync blocked for %.1f ms", (mpuEmu->now - t0) / 1e6);
+    uint32_t good = 0;
+    for (uint8_t i = 0; i < 20; i++) {
+        nextTick();
+        if (readSample(&s) == 0 && fabsf(s.pitch) < 0.1f && fabsf(s.az - 1.0f) < 0.01f) good++;
+    }
+    CHECK(good >= 13, "only %u good samples after the resync", good);
+    return failures;
+}
+
+/* 初始化中的故障 | Faults during init ---------------------------------------*/
+
+typedef struct {
+    uint32_t transfers;         /**< 无故障初始化的传输数 | Transfers of a fault-free init */
+    int result;                 /**< 带故障的初始化结果 | Result of the faulted init */
+    int retry;                  /**< 重试结果 | Result of the retry */
+    uint32_t good;              /**< SETTLE_MS 内的好数据 | Good samples within SETTLE_MS */
+} InitRun;
+
+static InitRun *run;
+
+static uint32_t goodSamples(void) {
+    uint32_t good = 0;
+    for (uint32_t t = 0; t < SETTLE_MS; t += 10) {
+        nextTick();
+        Sample s;
+        if (readSample(&s) == 0 && fabsf(s.pitch) < 0.1f && fabsf(s.az - 1.0f) < 0.01f) good++;
+    }
+    return good;
+}
+
+static int childInit(void) {
+    uint32_t start = mpuEmu->transfers;
+    run->result = MPU_6500_Init();
+    run->transfers = mpuEmu->transfers - start;
+    run->retry = (run->result != 0) ? MPU_6500_Init() : 0;
+    run->good = goodSamples();
+    return 0;
+}
+
+/**
+  * @brief   在每一次传输上注入 NACK | Inject a NACK at every transfer
+  * @param   warm  非零：先冷启动一次，再测热启动 | Non-zero: cold boot once, then test the warm boot
+  */
+static void sweepInit(const char *name, int warm) {
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+    if (warm) {
+        inChild(childInit);
+    }
+    Mpu6500Emu saved = *mpuEmu;
+    inChild(childInit);
+    uint32_t total = run->transfers;
+    CHECK(run->result == 0 && run->good >= SETTLE_MS / 10 - 3, "%s: fault-free init failed", name);
+
+    uint32_t reported = 0, absorbed = 0, broken = 0, retryFailed = 0;
+    for (uint32_t i = 1; i <= total; i++) {
+        *mpuEmu = saved;
+        mpuEmu->failAt = mpuEmu->transfers + i;
+        mpuEmu->failCount = 1;
+        inChild(childInit);
+        if (run->result != 0) {
+            reported++;
+            if (run->retry != 0) retryFailed++;
+        } else {
+            absorbed++;
+        }
+        if (run->good < SETTLE_MS / 10 - 8) {
+            broken++;
+            if (broken <= 3) printf("  %s: NACK at transfer %u: init %d, retry %d, %u good samples\n",
+                                    name, i, run->result, run->retry, run->good);
+        }
+    }
+    printf("  %s: %u transfers, %u NACKs reported, %u absorbed, %u left the IMU unusable\n",
+           name, total, reported, absorbed, broken);
+    CHECK(broken == 0, "%s: %u NACKs left the IMU unusable", name, broken);
+    CHECK(retryFailed == 0, "%s: %u retries failed", name, retryFailed);
+}
+
+/* Imu 的初始化重试 | Imu init retries ----------------------------------------*/
+
+/**
+  * @brief   按控制周期运行 Imu，直到 ready 或超时 | Run the Imu tick by tick until ready or a timeout
+  * @return  用去的周期数 | Ticks used
+  */
+static uint32_t runImu(Imu *imu, uint32_t maxTicks) {
+    uint32_t ticks = 0;
+    while (!imu->ready && ticks < maxTicks) {
+        nextTick();
+        imu->Get_Data(imu);
+        ticks++;
+    }
+    return ticks;
+}
+
+static int childRetry(void) {
+    memset(flash, 0xFF, sizeof(flash));     // imu.c 从中读零偏，此处为空 | imu.c reads its biases from it; empty here
+    ParamStore_Init(&paramStore, newRamFlashDev(flash, 16384));
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+
+    // 一次 NACK：报错后退避一次重试即恢复 | One NACK: the init reports it and one retry after the backoff recovers
+    Imu imu = newImu();
+    imu.Enable(&imu);
+    mpuEmu->failAt = mpuEmu->transfers + 3;
+    mpuEmu->failCount = 1;
+    uint32_t ticks = runImu(&imu, 500);
+    printf("  one NACK: ready after %u ticks, %u retries\n", ticks, imu.init_retries);
+    CHECK(imu.ready && imu.init_retries == 1, "ready %d after %u ticks, %u retries", imu.ready, ticks, imu.init_retries);
+
+    // 传感器 10 s 无应答：重试间隔加倍到上限，应答恢复后一个上限间隔内就绪
+    // The sensor silent for 10 s: the retry interval doubles up to its cap, and the IMU is ready within one cap of the bus coming back
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+    imu = newImu();
+    imu.Enable(&imu);
+    mpuEmu->failAt = mpuEmu->transfers + 1;
+    mpuEmu->failCount = 0xFFFFFFFFu;
+    runImu(&imu, 1000);
+    uint16_t retries = imu.init_retries;
+    mpuEmu->failCount = 0;
+    ticks = runImu(&imu, 2 * IMU_RETRY_MAX_TICKS);
+    printf("  10 s silent: %u retries, ready %u ticks after the bus came back\n", retries, ticks);
+    CHECK(retries >= 5 && retries <= 10, "%u retries in 10 s", retries);
+    CHECK(imu.ready && ticks <= IMU_RETRY_MAX_TICKS + 100, "ready %d after %u ticks", imu.ready, ticks);
+    return failures;
+}
+
+/* 零偏的保存与载入 | Bias store and reload ---------------------------------*/
+
+#define BIAS_GYRO_MEM   (61 * 16)   /**< D_EXT_GYRO_BIAS_X..Z，12 字节 | D_EXT_GYRO_BIAS_X..Z, 12 bytes */
+#define BIAS_ACCEL_MEM  660         /**< D_ACCEL_BIAS，12 字节 | D_ACCEL_BIAS, 12 bytes */
+
+static void readBias(uint8_t out[24]) {
+    memcpy(out, &mpuEmu->mem[BIAS_GYRO_MEM], 12);
+    memcpy(out + 12, &mpuEmu->mem[BIAS_ACCEL_MEM], 12);
+}
+
+static int childBias(void) {
+    const int32_t gyro[3] = {65536, -131072, 32768};   // 1、-2、0.5 °/s | 1, -2, 0.5 dps
+    const int32_t accel[3] = {-1311, 655, 3277};       // -0.02、0.01、0.05 g | -0.02, 0.01, 0.05 g
+    uint8_t none[24], expect[24], got[24];
+
+    // 参考：空存储启动，再直接调用 MPU6500_Set_Bias | Reference: boot with an empty store, then call MPU6500_Set_Bias directly
+    memset(flash, 0xFF, sizeof(flash));
+    ParamStore_Init(&paramStore, newRamFlashDev(flash, 16384));
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+    Imu imu = newImu();
+    imu.Enable(&imu);
+    runImu(&imu, 500);
+    CHECK(imu.ready, "not ready with an empty store");
+    readBias(none);
+    long g[3] = {gyro[0], gyro[1], gyro[2]};
+    long a[3] = {accel[0], accel[1], accel[2]};
+    CHECK(MPU6500_Set_Bias(g, a) == 0, "MPU6500_Set_Bias failed");
+    readBias(expect);
+    CHECK(memcmp(none, expect, sizeof(none)) != 0, "MPU6500_Set_Bias left the DMP memory unchanged");
+
+    // 保存六个值，传感器断电，存储从同一块 Flash 重新建立索引 | Store the six values, power the sensor off, and rebuild the store index from the same flash
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK(ParamStore_Set(&paramStore, PARAM_KEY_GYRO_BIAS + i, &gyro[i], sizeof(int32_t)) == PARAM_STORE_OK, "store gyro %u", i);
+        CHECK(ParamStore_Set(&paramStore, PARAM_KEY_ACCEL_BIAS + i, &accel[i], sizeof(int32_t)) == PARAM_STORE_OK, "store accel %u", i);
+    }
+    memset(&paramStore, 0, sizeof(paramStore));
+    ParamStore_Init(&paramStore, newRamFlashDev(flash, 16384));
+    Mpu6500Emu_PowerOn(mpuEmu, BUS_HZ);
+    imu = newImu();
+    imu.Enable(&imu);
+    uint32_t ticks = runImu(&imu, 500);
+    readBias(got);
+    printf("  stored biases in the DMP %u ticks after reboot\n", ticks);
+    CHECK(imu.ready, "not ready after reboot");
+    CHECK(memcmp(imu.gyroBias, gyro, sizeof(gyro)) == 0 && memcmp(imu.accelBias, accel, sizeof(accel)) == 0,
+          "biases not loaded from the store");
+    CHECK(memcmp(got, expect, sizeof(got)) == 0, "DMP bias memory differs from MPU6500_Set_Bias");
+    return failures;
+}
+
+int main(void) {
+    void *shared = mmap(NULL, sizeof(Mpu6500Emu) + sizeof(InitRun), PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    mpuEmu = shared;
+    run = (InitRun *)(mpuEmu + 1);
+    memset(mpuEmu, 0, sizeof(*mpuEmu));
+
+    testRegisters();
+    printf("trajectory\n");
+    failures += inChild(childTrajectory);
+    printf("FIFO\n");
+    failures += inChild(childFifo);
+    printf("NACK at every init transfer\n");
+    sweepInit("cold", 0);
+    sweepInit("warm", 1);
+    printf("init retry\n");
+    failures += inChild(childRetry);
+    printf("bias reload\n");
+    failures += inChild(childBias);
+
+    return Check_Exit();
+}
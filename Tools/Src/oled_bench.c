@@ -0,0 +1,240 @@
+/**
+  * @file    oled_bench.c
+  * @brief   OLED 仪表盘刷新的总线字节数基准 | Bus bytes per OLED dashboard refresh
+  *
+  * @note    用法 | Usage: dnb_oled_bench [-n frames]
+  *          OLED.c 原样编译，oled_port 换成一个按 I2C 时钟计时的模型：上一次传输结束后才开始下一次
+  *          （与固件相同；与 IMU 的仲裁见 dnb_i2c_arbiter_test），数据写进模拟的 SSD1306 显存
+  *          （水平寻址、列/页窗口）。
+  *          仪表盘按常见写法每帧清屏重画、10 Hz 刷新；每帧结束后检查模拟显存与显存一致，
+  *          不一致时以非零状态退出。
+  *          字模是占位数据（OLED_Data.c 为厂商字库，不在仓库中）：只要空白列与真实字库相近，
+  *          字节数只取决于哪些字符变了，与字形无关。
+  *          OLED.c is compiled unchanged; oled_port is replaced by a model timed on the I2C clock:
+  *          a transfer starts once the previous one has ended (as in the firmware; arbitration
+  *          against the IMU is covered by dnb_i2c_arbiter_test) and its data lands in a simulated
+  *          SSD1306 RAM (horizontal addressing, column/page window). The dashboard is redrawn
+  *          from a cleared screen every frame at 10 Hz, as such code usually is; after each frame
+  *          the simulated RAM must match the framebuffer or the program exits non-zero.
+  *          Glyphs are stand-ins (OLED_Data.c is the vendor font and is not in the repository):
+  *          as long as their blank columns resemble the real font, byte counts depend only on
+  *          which characters change, not on their shapes.
+  */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "OLED.h"
+#include "oled_port.h"
+
+#define TICK_US         10000       /* 控制周期 | Control period */
+#define FRAME_TICKS     10          /* 10 Hz 刷新 | 10 Hz refresh */
+
+/* 占位字模：第 0 列（8x16 还有第 7 列）为空，其余由字符码散列得到 | Stand-in glyphs: column 0 (and 7 for 8x16) blank, the rest hashed from the code */
+#define HASH(c, k)      ((uint8_t)((((c) * 0x9E37U + (k) * 0x7F4AU) >> 5) ^ ((c) * (k) * 13U)))
+#define B16(c, k)       ((c) == ' ' || (k) % 8 == 0 || (k) % 8 == 7 ? 0 : HASH(c, k))
+#define B6(c, k)        ((c) == ' ' || (k) == 0 ? 0 : (uint8_t)(HASH(c, k) & 0x7F))
+#define G16(c)          {B16(c, 0), B16(c, 1), B16(c, 2), B16(c, 3), B16(c, 4), B16(c, 5), B16(c, 6), B16(c, 7), \
+                         B16(c, 8), B16(c, 9), B16(c, 10), B16(c, 11), B16(c, 12), B16(c, 13), B16(c, 14), B16(c, 15)}
+#define G6(c)           {B6(c, 0), B6(c, 1), B6(c, 2), B6(c, 3), B6(c, 4), B6(c, 5)}
+#define X5(G, c)        G(c), G((c) + 1), G((c) + 2), G((c) + 3), G((c) + 4)
+#define ASCII(G)        X5(G, 32), X5(G, 37), X5(G, 42), X5(G, 47), X5(G, 52), X5(G, 57), X5(G, 62), \
+                        X5(G, 67), X5(G, 72), X5(G, 77), X5(G, 82), X5(G, 87), X5(G, 92), X5(G, 97), \
+                        X5(G, 102), X5(G, 107), X5(G, 112), X5(G, 117), X5(G, 122)
+
+const uint8_t OLED_F8x16[][16] = {ASCII(G16)};
+const uint8_t OLED_F6x8[][6] = {ASCII(G6)};
+const ChineseCell_t OLED_CF16x16[] = {{"", {0}}};
+const uint8_t Diode[] = {0};
+
+/* 总线与屏幕模型 | Bus and display model ------------------------------------*/
+
+static struct {
+    uint64_t now;               /* 仿真时间 (µs) | Simulated time */
+    uint64_t busyUntil;
+    uint32_t byteUs;            /* 每字节 9 个时钟 | 9 clocks a byte */
+    uint32_t bytes;             /* 线上字节：地址 + 控制 + 负载 | Wire bytes: address + control + payload */
+    uint32_t transfers;
+    uint16_t maxTransfer;
+    uint64_t busUs;
+
+    uint8_t ram[8][128];        /* SSD1306 显存 | SSD1306 RAM */
+    uint8_t col, page, c0, c1, p0, p1;
+    uint8_t cmd[3], cmdLen, cmdNeed;
+} bus;
+
+static uint8_t cmdArgs(uint8_t c) {
+    switch (c) {
+        case 0x21: case 0x22: return 2;
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+        default: return 0;
+    }
+}
+
+static void command(uint8_t c) {
+    if (bus.cmdLen == 0) bus.cmdNeed = cmdArgs(c);
+    bus.cmd[bus.cmdLen++] = c;
+    if (bus.cmdLen <= bus.cmdNeed) return;
+    if (bus.cmd[0] == 0x21) {
+        bus.c0 = bus.col = bus.cmd[1];
+        bus.c1 = bus.cmd[2];
+    } else if (bus.cmd[0] == 0x22) {
+        bus.p0 = bus.page = bus.cmd[1];
+        bus.p1 = bus.cmd[2];
+    }
+    bus.cmdLen = 0;
+}
+
+static void data(uint8_t d) {
+    bus.ram[bus.page][bus.col] = d;
+    if (bus.col++ == bus.c1) {
+        bus.col = bus.c0;
+        bus.page = (bus.page == bus.p1) ? bus.p0 : bus.page + 1;
+    }
+}
+
+static void transfer(uint8_t control, const uint8_t *p, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        if (control == OLED_PORT_COMMAND) command(p[i]);
+        else data(p[i]);
+    }
+    bus.bytes += len + 2U;
+    bus.transfers++;
+    if (len > bus.maxTransfer) bus.maxTransfer = len;
+}
+
+void OLED_Port_WriteBlocking(uint8_t control, const uint8_t *p, uint16_t len) {
+    transfer(control, p, len);
+}
+
+uint8_t OLED_Port_Ready(uint16_t len) {
+    (void)len;
+    return bus.now >= bus.busyUntil;
+}
+
+void OLED_Port_Write(uint8_t control, const uint8_t *p, uint16_t len) {
+    uint32_t us = (len + 2U) * bus.byteUs;
+    bus.busyUntil = bus.now + us;
+    bus.busUs += us;
+    transfer(control, p, len);
+}
+
+uint8_t OLED_Port_TakeError(void) {
+    return 0;
+}
+
+/* 仪表盘 | Dashboard --------------------------------------------------------*/
+
+static void dashboard(int frame) {
+    double t = frame * 0.1;
+    static const char *modes[] = {"BALANCE", "PATH", "STOP"};
+
+    OLED_Clear();
+    OLED_Printf(0, 0, OLED_8X16, "%-7s", modes[(frame / 150) % 3]);
+    OLED_ShowNum(96, 0, (uint32_t)(t / 60) % 100, 2, OLED_6X8);
+    OLED_ShowChar(108, 0, ':', OLED_6X8);
+    OLED_ShowNum(114, 0, (uint32_t)t % 60, 2, OLED_6X8);
+
+    double pitch = 1.5 * sin(t * 2.1) + 0.3 * sin(t * 13.0);
+    double speed = 20.0 * sin(t * 0.2);
+    OLED_ShowString(0, 18, "Pitch", OLED_6X8);
+    OLED_ShowFloatNum(36, 18, pitch, 2, 1, OLED_6X8);
+    OLED_ShowString(0, 27, "Speed", OLED_6X8);
+    OLED_ShowFloatNum(36, 27, speed, 2, 1, OLED_6X8);
+    OLED_ShowString(0, 36, "Sonar", OLED_6X8);
+    OLED_ShowNum(36, 36, (uint32_t)(60 + 40 * cos(t * 0.3)), 3, OLED_6X8);
+    OLED_Printf(0, 45, OLED_6X8, "X%+6.1f Y%+6.1f", 50 * sin(t * 0.05), 30 * cos(t * 0.05));
+
+    // 速度条 | Speed bar
+    OLED_DrawRectangle(76, 18, 52, 8, OLED_UNFILLED);
+    OLED_DrawRectangle(78, 20, (uint8_t)(fabs(speed) / 20.0 * 48), 4, OLED_FILLED);
+
+    // 俯仰指示 | Pitch indicator
+    OLED_DrawCircle(102, 44, 9, OLED_UNFILLED);
+    OLED_DrawLine(102, 44, (uint8_t)lround(102 + 8 * cos(pitch / 10)), (uint8_t)lround(44 + 8 * sin(pitch / 10)));
+    OLED_Update();
+}
+
+/**
+  * @brief   模拟显存与显存是否一致 | Whether the simulated RAM matches the framebuffer
+  */
+static int matches(void) {
+    for (uint8_t y = 0; y < 64; y++) {
+        for (uint8_t x = 0; x < 128; x++) {
+            if (((bus.ram[y / 8][x] >> (y % 8)) & 1U) != OLED_GetPoint(x, y)) return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+  * @brief   以给定 I2C 时钟运行 frames 帧 | Run frames frames at the given I2C clock
+  */
+static int run(uint32_t hz, int frames) {
+    memset(&bus, 0, sizeof(bus));
+    bus.byteUs = 9000000U / hz + 1;
+    OLED_Init();
+
+    uint32_t firstBytes = 0, bytes = 0, transfers = 0;
+    uint64_t worst = 0, busUs = 0;
+    int pagesChanged = 0;
+    uint8_t previous[8][128];
+
+    for (int f = 0; f < frames; f++) {
+        uint64_t start = (uint64_t)f * FRAME_TICKS * TICK_US + 1500;    // 控制任务之后绘制 | Drawn after the control work
+        if (bus.now < start) bus.now = start;
+        uint32_t b0 = bus.bytes, t0 = bus.transfers;
+        uint64_t u0 = bus.busUs;
+        memcpy(previous, bus.ram, sizeof(previous));
+
+        dashboard(f);
+        while (!OLED_IsIdle()) {
+            OLED_Poll();
+            bus.now = bus.busyUntil;
+        }
+        if (!matches()) {
+            printf("frame %d: display does not match the framebuffer\n", f);
+            return 1;
+        }
+        if (bus.now - start > worst && f > 0) worst = bus.now - start;
+
+        if (f == 0) {
+            firstBytes = bus.bytes;
+            continue;
+        }
+        bytes += bus.bytes - b0;
+        transfers += bus.transfers - t0;
+        busUs += bus.busUs - u0;
+        for (int p = 0; p < 8; p++) {
+            pagesChanged += memcmp(previous[p], bus.ram[p], 128) != 0;
+        }
+    }
+
+    int n = frames - 1;
+    uint32_t fullPage = 2 + 3 + 2 + 128;    // 页地址命令 + 整页数据 | Page address commands + a full page
+    printf("I2C %u kHz, %d frames (first full frame %u bytes incl. init)\n", hz / 1000, n, firstBytes);
+    printf("  %-26s %10s %10s %12s\n", "", "bytes/frm", "xfers/frm", "bus ms/frm");
+    printf("  %-26s %10u %10u %12.2f\n", "full frame", 8 * fullPage, 16, 8 * fullPage * bus.byteUs / 1000.0);
+    printf("  %-26s %10.1f %10.1f %12.2f\n", "changed pages only", (double)pagesChanged * fullPage / n,
+           2.0 * pagesChanged / n, (double)pagesChanged * fullPage * bus.byteUs / 1000.0 / n);
+    printf("  %-26s %10.1f %10.1f %12.2f\n", "dirty column runs (DMA)", (double)bytes / n,
+           (double)transfers / n, busUs / 1000.0 / n);
+    printf("  largest transfer %u bytes, worst frame latency %.1f ms\n", bus.maxTransfer, worst / 1000.0);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int frames = 600;
+    if (argc == 3 && strcmp(argv[1], "-n") == 0) {
+        frames = atoi(argv[2]);
+    } else if (argc != 1) {
+        fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+        return 2;
+    }
+    if (frames < 2) frames = 2;
+
+    int failed = run(100000, frames) || run(400000, frames);
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
@@ -0,0 +1,186 @@
+/**
+  * @file    param_cli.c
+  * @brief   参数读写命令行工具 | Parameter read/write command-line tool
+  *
+  * @note    用法 | Usage:
+  *          dnb_param <device> list
+  *          dnb_param <device> get <name>
+  *          dnb_param <device> set <name> <value>
+  *          dnb_param <device> save
+  *          device 可以是真实串口或仿真器的 pty | device is a real serial port or the simulator's pty
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "serial_port.h"
+#include "protocol.h"
+#include "param.h"
+
+#define REPLY_TIMEOUT_MS    200
+#define RETRIES             3
+
+static int port = -1;
+static uint8_t seq = 0;
+static FrameParser parser;
+
+static const char *typeName[] = {"f32", "i32", "u16", "i8", "u8"};
+
+/**
+  * @brief   发送请求并等待对应应答 | Send a request and wait for the matching reply
+  * @return  1 收到应答，0 超时 | 1 on reply, 0 on timeout
+  */
+static int transact(uint8_t type, const uint8_t *payload, uint8_t len, Frame *reply) {
+    uint8_t tx[PROTOCOL_MAX_FRAME];
+    uint8_t rx[256];
+
+    for (int attempt = 0; attempt < RETRIES; attempt++) {
+        uint8_t s = ++seq;
+        uint16_t n = Frame_Encode(type, s, payload, len, tx);
+        Serial_Write(port, tx, n);
+
+        for (;;) {
+            int got = Serial_Read(port, rx, sizeof(rx), REPLY_TIMEOUT_MS);
+            if (got <= 0) break;
+            for (int i = 0; i < got; i++) {
+                // 忽略遥测等其他帧 | Ignore telemetry and other frames
+                if (FrameParser_Feed(&parser, rx[i], reply) && reply->seq == s &&
+                    (reply->type == type || reply->type == MSG_NACK)) {
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static void printValue(uint8_t type, const uint8_t *raw) {
+    ParamValue v;
+    memcpy(&v, raw, sizeof(v));
+    if (type == PARAM_TYPE_F32) {
+        printf("%g", v.f);
+    } else {
+        printf("%d", (int)v.i);
+    }
+}
+
+/**
+  * @brief   查询参数描述 | Query a parameter descriptor
+  * @return  1 存在，0 不存在 | 1 if it exists, 0 otherwise
+  */
+static int queryInfo(uint8_t id, Frame *info) {
+    return transact(MSG_PARAM_INFO, &id, 1, info) && info->type == MSG_PARAM_INFO;
+}
+
+/**
+  * @brief   按名称查找参数编号和类型 | Look up id and type by name
+  */
+static int lookup(const char *name, uint8_t *id, uint8_t *type) {
+    Frame info;
+    for (int i = 0; i < 256 && queryInfo((uint8_t)i, &info); i++) {
+        if ((size_t)(info.len - 15) == strlen(name) && memcmp(&info.payload[15], name, info.len - 15) == 0) {
+            *id = (uint8_t)i;
+            *type = info.payload[1];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int cmdList(void) {
+    Frame info;
+    for (int i = 0; i < 256 && queryInfo((uint8_t)i, &info); i++) {
+        const uint8_t *p = info.payload;
+        fp32 min, max;
+        memcpy(&min, &p[3], 4);
+        memcpy(&max, &p[7], 4);
+        printf("%3d  %-16.*s %-4s [%g, %g]%s  = ", i, info.len - 15, (const char *)&p[15],
+               p[1] < 5 ? typeName[p[1]] : "?", min, max, (p[2] & PARAM_FLAG_PERSIST) ? " persist" : "");
+        printValue(p[1], &p[11]);
+        printf("\n");
+    }
+    return 0;
+}
+
+static int cmdGet(const char *name) {
+    uint8_t id, type;
+    Frame reply;
+    if (!lookup(name, &id, &type)) {
+        fprintf(stderr, "unknown parameter: %s\n", name);
+        return 1;
+    }
+    if (!transact(MSG_PARAM_GET, &id, 1, &reply) || reply.type != MSG_PARAM_GET) {
+        fprintf(stderr, "no reply\n");
+        return 1;
+    }
+    printValue(type, &reply.payload[1]);
+    printf("\n");
+    return 0;
+}
+
+static int cmdSet(const char *name, const char *text) {
+    uint8_t id, type;
+    uint8_t req[5];
+    ParamValue v;
+    Frame reply;
+
+    if (!lookup(name, &id, &type)) {
+        fprintf(stderr, "unknown parameter: %s\n", name);
+        return 1;
+    }
+    if (type == PARAM_TYPE_F32) {
+        v.f = strtof(text, NULL);
+    } else {
+        v.i = (int32_t)strtol(text, NULL, 0);
+    }
+    req[0] = id;
+    memcpy(&req[1], &v, 4);
+
+    if (!transact(MSG_PARAM_SET, req, sizeof(req), &reply) || reply.type != MSG_PARAM_SET) {
+        fprintf(stderr, "no reply\n");
+        return 1;
+    }
+    if ((int8_t)reply.payload[1] != PARAM_OK) {
+        fprintf(stderr, "rejected (%d)\n", (int8_t)reply.payload[1]);
+        return 1;
+    }
+    return 0;
+}
+
+static int cmdSave(void) {
+    Frame reply;
+    if (!transact(MSG_PARAM_SAVE, NULL, 0, &reply) || reply.type != MSG_PARAM_SAVE) {
+        fprintf(stderr, "no reply\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <device> list|get <name>|set <name> <value>|save\n", argv[0]);
+        return 2;
+    }
+
+    port = Serial_Open(argv[1], 115200);
+    if (port < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    FrameParser_Init(&parser);
+
+    int ret = 2;
+    if (strcmp(argv[2], "list") == 0) {
+        ret = cmdList();
+    } else if (strcmp(argv[2], "get") == 0 && argc >= 4) {
+        ret = cmdGet(argv[3]);
+    } else if (strcmp(argv[2], "set") == 0 && argc >= 5) {
+        ret = cmdSet(argv[3], argv[4]);
+    } else if (strcmp(argv[2], "save") == 0) {
+        ret = cmdSave();
+    } else {
+        fprintf(stderr, "unknown command: %s\n", argv[2]);
+    }
+
+    Serial_Close(port);
+    return ret;
+}
@@ -0,0 +1,362 @@
+/**
+  * @file    param_store_test.c
+  * @brief   参数存储的主机自检 | Host self-check of the parameter store
+  *
+  * @note    用法 | Usage: dnb_param_store_test
+  *          在 newRamFlashDev 外包一层可“掉电”的后端：写到第 N 个字时停止，该字可以只写一半
+  *          （NOR 中途掉电时部分位已清零），之后的写入与擦除全部失败，再用完好的后端重新上电。检查：
+  *          1. 读写往返、值不变时不写、长度/键/容量错误，重新上电后值不变；
+  *          2. 日志写满后搬移到事先擦好的扇区，目标未擦除时返回 BUSY 且不写不擦，
+  *             ParamStore_Maintain 擦除后继续，Set 从不擦除；
+  *          3. 追加一条记录时在每个字处掉电（含只写一半的 CRC）：重新上电后为旧值或新值，之后可继续写入；
+  *          4. 搬移过程中在每个字处掉电，包括新扇区已激活、旧扇区尚未废弃的窗口：重新上电后所有键都在，
+  *             选中的扇区与掉电时的标志一致，旧扇区被补写废弃标志；
+  *          5. 上电扫描：128 KB 扇区、1024 条记录写满、32 个键、最后一条写坏，
+  *             按读取次数与字数估算 84 MHz 下的耗时，要求远低于 1 ms。
+  *          A "power-cut" backend wraps newRamFlashDev: programming stops at the N-th word, which
+  *          may be left half-written (a NOR word interrupted mid-program has some bits cleared),
+  *          every later program or erase fails, and the store then boots again on an intact
+  *          backend. Checks:
+  *          1. set/get round trips, unchanged values not written, length/key/capacity errors,
+  *             values unchanged after a reboot;
+  *          2. a full log compacts into a sector erased beforehand; with the target not erased
+  *             Set returns BUSY without programming or erasing, continues after
+  *             ParamStore_Maintain, and never erases by itself;
+  *          3. power lost at every word of one append, a half-written CRC included: after the
+  *             reboot the key has its old or new value and further writes work;
+  *          4. power lost at every word of a compaction, including the window where the new
+  *             sector is active and the old one not yet obsolete: after the reboot every key is
+  *             present, the chosen sector matches the marks left behind, and the old sector gets
+  *             its obsolete mark;
+  *          5. boot scan: 128 KB sectors, a full 1024-record log, 32 keys, the last record
+  *             torn; the time at 84 MHz is estimated from the reads and words and must be well
+  *             under 1 ms.
+  */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "param_store.h"
+#include "check.h"
+
+#define SMALL_SECTOR    1024                /**< 62 条记录的日志窗口 | A log window of 62 records */
+#define BIG_SECTOR      0x20000             /**< 与 PARAM_FLASH_SECTOR_SIZE 相同 | As PARAM_FLASH_SECTOR_SIZE */
+#define TEAR_MASK       0x0F0F0F0Fu         /**< 写一半的字：这些位仍为 1 | A half-written word: these bits stay 1 */
+
+/* 扇区头布局，与 param_store.c 相同 | Sector header layout, as in param_store.c */
+#define HDR_GENERATION  4
+#define HDR_ACTIVE      12
+#define HDR_OBSOLETE    16
+
+/* 上电扫描的目标板代价模型（84 MHz，Flash 直接映射） | Target cost model of the boot scan (84 MHz, memory-mapped flash) */
+#define TARGET_HZ       84e6
+#define CYCLES_PER_CALL 60.0                /**< 每次 Read 调用与 memcpy 开销 | Per Read call and memcpy setup */
+#define CYCLES_PER_WORD 3.0                 /**< 每字一次 2 等待周期的取数，不计 128 位行与预取 | One 2-wait-state fetch per word, ignoring the 128-bit line and prefetch */
+#define CYCLES_PER_CRC  200.0               /**< 12 字节半字节表 CRC32 | 12-byte nibble-table CRC32 */
+#define BOOT_BUDGET_US  500.0               /**< “远低于 1 ms” | "Well under a millisecond" */
+
+/**
+  * @brief   可掉电的测试后端 | Test backend that can lose power
+  */
+typedef struct {
+    FlashDev ram;               /**< 底层 RAM 后端 | Underlying RAM backend */
+    long budget;                /**< 还能写的字数，-1 不限 | Words left to program, -1 = unlimited */
+    bool_t tear;                /**< 掉电的那个字只写一半 | The word at the cut is half-written */
+    bool_t dead;                /**< 已掉电 | Power is gone */
+    uint32_t reads, readWords, recordReads, programs, erases;
+} TestFlash;
+
+static int Test_Read(FlashDev *self, uint8_t sector, uint32_t offset, void *buf, uint32_t len) {
+    TestFlash *t = self->ctx;
+    t->reads++;
+    t->readWords += (len + 3) / 4;
+    t->recordReads += (len == PARAM_STORE_RECORD_SIZE);     // 逐条读记录，随后算 CRC | One record read, followed by a CRC
+    return t->ram.Read(&t->ram, sector, offset, buf, len);
+}
+
+static int Test_Program(FlashDev *self, uint8_t sector, uint32_t offset, const uint32_t *words, uint32_t count) {
+    TestFlash *t = self->ctx;
+    for (uint32_t i = 0; i < count; i++) {
+        if (t->dead) return -1;
+        if (t->budget == 0) {
+            t->dead = TRUE;
+            if (t->tear) {
+                uint32_t half = words[i] | TEAR_MASK;
+                t->ram.Program(&t->ram, sector, offset + 4 * i, &half, 1);
+            }
+            return -1;
+        }
+        if (t->budget > 0) t->budget--;
+        t->ram.Program(&t->ram, sector, offset + 4 * i, &words[i], 1);
+        t->programs++;
+    }
+    return 0;
+}
+
+static int Test_Erase(FlashDev *self, uint8_t sector) {
+    TestFlash *t = self->ctx;
+    if (t->dead) return -1;
+    t->erases++;
+    return t->ram.Erase(&t->ram, sector);
+}
+
+static FlashDev newTestFlash(TestFlash *t, uint8_t *mem, uint32_t sectorSize, long budget, bool_t tear) {
+    memset(t, 0, sizeof(*t));
+    t->ram = newRamFlashDev(mem, sectorSize);
+    t->budget = budget;
+    t->tear = tear;
+    FlashDev d = {t, sectorSize, Test_Read, Test_Program, Test_Erase};
+    return d;
+}
+
+static uint32_t headerWord(const uint8_t *mem, uint32_t sectorSize, uint8_t sector, uint32_t offset) {
+    uint32_t w;
+    memcpy(&w, mem + sector * sectorSize + offset, 4);
+    return w;
+}
+
+static uint8_t small[2 * SMALL_SECTOR];
+static uint8_t snapshot[2 * SMALL_SECTOR];
+static uint8_t big[2 * BIG_SECTOR];
+
+/* 1. 读写往返 | Round trips ------------------------------------------------------------------------*/
+
+static void testRoundTrip(void) {
+    printf("round trip\n");
+    TestFlash t;
+    ParamStore store;
+    memset(small, 0xFF, sizeof(small));
+    CHECK(ParamStore_Init(&store, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE)) == PARAM_STORE_OK, "init failed");
+    CHECK(store.keyCount == 0 && store.head == 0 && store.generation == 1, "first boot not blank");
+
+    uint8_t bytes[PARAM_STORE_VALUE_SIZE] = {1, 2, 3, 4, 5, 6, 7, 8}, back[PARAM_STORE_VALUE_SIZE];
+    CHECK(ParamStore_SetFloat(&store, PARAM_KEY_BALANCE_BIAS, -1.25f) == PARAM_STORE_OK, "set float failed");
+    CHECK(ParamStore_Set(&store, PARAM_KEY_GYRO_BIAS, bytes, sizeof(bytes)) == PARAM_STORE_OK, "set bytes failed");
+    uint16_t head = store.head;
+    uint32_t programs = t.programs;
+    CHECK(ParamStore_SetFloat(&store, PARAM_KEY_BALANCE_BIAS, -1.25f) == PARAM_STORE_OK &&
+          store.head == head && t.programs == programs, "unchanged value written again");
+
+    CHECK(ParamStore_GetFloat(&store, PARAM_KEY_BALANCE_BIAS, 0.0f) == -1.25f, "float differs");
+    CHECK(ParamStore_Get(&store, PARAM_KEY_GYRO_BIAS, back, sizeof(back)) == PARAM_STORE_OK &&
+          memcmp(back, bytes, sizeof(bytes)) == 0, "bytes differ");
+    CHECK(ParamStore_Get(&store, PARAM_KEY_GYRO_BIAS, back, 4) == PARAM_STORE_ERR_NOT_FOUND, "length not checked");
+    CHECK(ParamStore_GetFloat(&store, PARAM_KEY_MOTOR_KP, 7.0f) == 7.0f, "missing key has no default");
+    CHECK(ParamStore_Set(&store, 0xFFFF, bytes, 1) == PARAM_STORE_ERR_ARG, "erased key accepted");
+    CHECK(ParamStore_Set(&store, 0x100, bytes, PARAM_STORE_VALUE_SIZE + 1) == PARAM_STORE_ERR_ARG, "long value accepted");
+
+    for (uint16_t k = 0; store.keyCount < PARAM_STORE_MAX_KEYS; k++) {
+        ParamStore_SetFloat(&store, (uint16_t)(0x100 + k), (fp32)k);
+    }
+    CHECK(ParamStore_SetFloat(&store, 0x200, 1.0f) == PARAM_STORE_ERR_FULL, "index overflow accepted");
+
+    ParamStore again;
+    CHECK(ParamStore_Init(&again, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE)) == PARAM_STORE_OK, "reboot failed");
+    CHECK(again.keyCount == store.keyCount && again.head == store.head, "index differs after reboot");
+    CHECK(ParamStore_GetFloat(&again, PARAM_KEY_BALANCE_BIAS, 0.0f) == -1.25f &&
+          ParamStore_GetFloat(&again, 0x105, 0.0f) == 5.0f, "values differ after reboot");
+}
+
+/* 2. 写满与搬移 | Wrap and compaction --------------------------------------------------------------*/
+
+#define KEYS 8
+
+static uint16_t keyOf(uint8_t i) {
+    return (uint16_t)(0x40 + i);
+}
+
+static void testCompaction(void) {
+    printf("wrap and compaction\n");
+    TestFlash t;
+    ParamStore store;
+    memset(small, 0xFF, sizeof(small));
+    ParamStore_Init(&store, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE));
+
+    fp32 expect[KEYS] = {0};
+    uint32_t value = 0, compactions = 0, busy = 0;
+    for (uint32_t n = 0; n < 5 * store.logRecords; n++) {
+        uint8_t k = (uint8_t)(n % KEYS);
+        uint32_t generation = store.generation, erases = t.erases;
+        int ret = ParamStore_SetFloat(&store, keyOf(k), (fp32)++value);
+        CHECK(t.erases == erases, "Set erased a sector");
+        if (ret == PARAM_STORE_ERR_BUSY) {
+            busy++;
+            uint32_t programs = t.programs;
+            CHECK(ParamStore_SetFloat(&store, keyOf(k), (fp32)value) == PARAM_STORE_ERR_BUSY && t.programs == programs,
+                  "BUSY Set programmed flash");
+            CHECK(ParamStore_ErasePending(&store), "BUSY with no erase pending");
+            CHECK(ParamStore_Maintain(&store) == PARAM_STORE_OK && t.erases == erases + 1, "Maintain did not erase");
+            CHECK(!ParamStore_ErasePending(&store), "erase still pending");
+            ret = ParamStore_SetFloat(&store, keyOf(k), (fp32)value);
+        }
+        CHECK(ret == PARAM_STORE_OK, "set %u returned %d", n, ret);
+        if (ret == PARAM_STORE_OK) expect[k] = (fp32)value;
+        compactions += store.generation != generation;
+    }
+    printf("  %u writes, %u compactions, %u deferred for an erase, %u erases\n",
+           5 * store.logRecords, compactions, busy, t.erases);
+    CHECK(compactions >= 4 && busy == compactions - 1, "%u compactions, %u deferred", compactions, busy);
+
+    ParamStore again;
+    CHECK(ParamStore_Init(&again, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE)) == PARAM_STORE_OK, "reboot failed");
+    CHECK(again.active == store.active && again.generation == store.generation, "reboot chose sector %u gen %u, expected %u gen %u",
+          again.active, again.generation, store.active, store.generation);
+    int same = again.keyCount == KEYS;
+    for (uint8_t k = 0; k < KEYS; k++) same &= ParamStore_GetFloat(&again, keyOf(k), -1.0f) == expect[k];
+    CHECK(same, "values differ after reboot");
+    CHECK(ParamStore_ErasePending(&again), "the superseded sector is not pending erase after reboot");
+}
+
+/* 3. 追加时掉电 | Power loss during an append ------------------------------------------------------*/
+
+/**
+  * @brief   掉电后重新上电：检查值为旧值或新值，再写一次并再次上电 | Reboot after the cut: the value is old or new, then write once more and reboot again
+  */
+static void rebootAndContinue(const char *what, long cut, bool_t tear, uint16_t key, fp32 before, fp32 after,
+                              bool_t completed, const fp32 *others) {
+    TestFlash t;
+    ParamStore store;
+    CHECK(ParamStore_Init(&store, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE)) == PARAM_STORE_OK,
+          "%s cut %ld%s: reboot failed", what, cut, tear ? " torn" : "");
+    fp32 v = ParamStore_GetFloat(&store, key, -1.0f);
+    CHECK(v == after || (!completed && v == before), "%s cut %ld%s: value %g, expected %g or %g",
+          what, cut, tear ? " torn" : "", v, before, after);
+    for (uint8_t k = 0; others != NULL && k < KEYS; k++) {
+        if (keyOf(k) != key) {
+            CHECK(ParamStore_GetFloat(&store, keyOf(k), -1.0f) == others[k], "%s cut %ld%s: key %u lost",
+                  what, cut, tear ? " torn" : "", keyOf(k));
+        }
+    }
+
+    int ret = ParamStore_SetFloat(&store, key, 1234.5f);
+    if (ret == PARAM_STORE_ERR_BUSY && ParamStore_Maintain(&store) == PARAM_STORE_OK) {
+        ret = ParamStore_SetFloat(&store, key, 1234.5f);
+    }
+    CHECK(ret == PARAM_STORE_OK, "%s cut %ld%s: write after reboot returned %d", what, cut, tear ? " torn" : "", ret);
+    CHECK(ParamStore_Init(&store, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE)) == PARAM_STORE_OK &&
+          ParamStore_GetFloat(&store, key, -1.0f) == 1234.5f, "%s cut %ld%s: write after reboot lost",
+          what, cut, tear ? " torn" : "");
+}
+
+static void testTornAppend(void) {
+    printf("power loss during an append\n");
+    TestFlash t;
+    ParamStore store;
+    memset(small, 0xFF, sizeof(small));
+    ParamStore_Init(&store, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE));
+    ParamStore_SetFloat(&store, PARAM_KEY_MOTOR_KP, 800.0f);
+    ParamStore_SetFloat(&store, PARAM_KEY_MOTOR_KI, 20.0f);
+    memcpy(snapshot, small, sizeof(small));
+
+    uint32_t cases = 0;
+    for (long cut = 0; cut <= 4; cut++) {
+        for (int tear = 0; tear < 2; tear++) {
+            memcpy(small, snapshot, sizeof(small));
+            ParamStore_Init(&store, newTestFlash(&t, small, SMALL_SECTOR, cut, (bool_t)tear));
+            bool_t completed = ParamStore_SetFloat(&store, PARAM_KEY_MOTOR_KP, 650.0f) == PARAM_STORE_OK;
+            CHECK(completed == (cut == 4), "append cut %ld returned %s", cut, completed ? "OK" : "an error");
+            rebootAndContinue("append", cut, (bool_t)tear, PARAM_KEY_MOTOR_KP, 800.0f, 650.0f, completed, NULL);
+
+            ParamStore_Init(&store, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE));
+            CHECK(ParamStore_GetFloat(&store, PARAM_KEY_MOTOR_KI, -1.0f) == 20.0f, "append cut %ld: other key lost", cut);
+            cases++;
+        }
+    }
+    printf("  %u cuts, a half-written CRC included\n", cases);
+}
+
+/* 4. 搬移时掉电 | Power loss during a compaction ---------------------------------------------------*/
+
+static void testTornCompaction(void) {
+    printf("power loss during a compaction\n");
+    TestFlash t;
+    ParamStore store;
+    fp32 values[KEYS];
+    memset(small, 0xFF, sizeof(small));
+    ParamStore_Init(&store, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE));
+    for (uint32_t n = 0; store.head < store.logRecords; n++) {
+        values[n % KEYS] = (fp32)n;
+        ParamStore_SetFloat(&store, keyOf((uint8_t)(n % KEYS)), (fp32)n);
+    }
+    uint8_t from = store.active, to = (uint8_t)(from ^ 1u);
+    memcpy(snapshot, small, sizeof(small));
+
+    uint32_t cases = 0, window = 0;
+    for (long cut = 0;; cut++) {
+        bool_t completed = FALSE;
+        for (int tear = 0; tear < 2; tear++) {
+            memcpy(small, snapshot, sizeof(small));
+            ParamStore_Init(&store, newTestFlash(&t, small, SMALL_SECTOR, cut, (bool_t)tear));
+            completed = ParamStore_SetFloat(&store, keyOf(0), -5.0f) == PARAM_STORE_OK;
+
+            bool_t activated = headerWord(small, SMALL_SECTOR, to, HDR_ACTIVE) == 0;
+            bool_t retired = headerWord(small, SMALL_SECTOR, from, HDR_OBSOLETE) == 0;
+            window += activated && !retired;
+
+            ParamStore check;
+            ParamStore_Init(&check, newTestFlash(&t, small, SMALL_SECTOR, -1, FALSE));
+            CHECK(check.active == (activated ? to : from), "compaction cut %ld%s: booted sector %u", cut,
+                  tear ? " torn" : "", check.active);
+            CHECK(!activated || headerWord(small, SMALL_SECTOR, from, HDR_OBSOLETE) == 0,
+                  "compaction cut %ld%s: old sector not retired at boot", cut, tear ? " torn" : "");
+            CHECK(!activated || check.generation == headerWord(small, SMALL_SECTOR, to, HDR_GENERATION),
+                  "compaction cut %ld%s: generation %u", cut, tear ? " torn" : "", check.generation);
+            rebootAndContinue("compaction", cut, (bool_t)tear, keyOf(0), values[0], -5.0f, completed, values);
+            cases++;
+        }
+        if (completed) break;
+    }
+    printf("  %u cuts, %u between the activate and obsolete marks\n", cases, window);
+    CHECK(window >= 2, "the activate/obsolete window was never hit");
+}
+
+/* 5. 上电扫描耗时 | Boot scan time ------------------------------------------------------------------*/
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void testBootScan(void) {
+    printf("boot scan\n");
+    TestFlash t;
+    ParamStore store;
+    memset(big, 0xFF, sizeof(big));
+    ParamStore_Init(&store, newTestFlash(&t, big, BIG_SECTOR, -1, FALSE));
+
+    // 键 0 只写在槽 0，其余 31 个键写满日志，最后一条是键 0 且 CRC 写坏
+    // Key 0 only in slot 0, the other 31 keys fill the log, and the last record is key 0 with a torn CRC
+    ParamStore_SetFloat(&store, 0x100, 42.0f);
+    for (uint32_t n = 0; store.head < store.logRecords - 1; n++) {
+        ParamStore_SetFloat(&store, (uint16_t)(0x101 + n % (PARAM_STORE_MAX_KEYS - 1)), (fp32)n);
+    }
+    ParamStore_Init(&store, newTestFlash(&t, big, BIG_SECTOR, 3, TRUE));
+    ParamStore_SetFloat(&store, 0x100, 43.0f);
+
+    const int runs = 200;
+    double t0 = nowNs();
+    for (int i = 0; i < runs; i++) {
+        ParamStore_Init(&store, newTestFlash(&t, big, BIG_SECTOR, -1, FALSE));
+    }
+    double hostUs = (nowNs() - t0) / runs / 1e3;
+    CHECK(store.head == store.logRecords && store.keyCount == PARAM_STORE_MAX_KEYS, "head %u, %u keys", store.head, store.keyCount);
+    CHECK(ParamStore_GetFloat(&store, 0x100, -1.0f) == 42.0f, "torn last record did not fall back to slot 0");
+    CHECK(t.programs == 0 && t.erases == 0, "boot wrote to flash");
+
+    double cycles = t.reads * CYCLES_PER_CALL + t.readWords * CYCLES_PER_WORD + t.recordReads * CYCLES_PER_CRC;
+    double targetUs = cycles / TARGET_HZ * 1e6;
+    printf("  %u records, %u keys: %u reads, %u words, %u records CRC-checked\n", store.head, store.keyCount, t.reads,
+           t.readWords, t.recordReads);
+    printf("  host %.1f us, target estimate %.0f us at %.0f MHz (budget %.0f us)\n", hostUs, targetUs, TARGET_HZ / 1e6,
+           BOOT_BUDGET_US);
+    CHECK(targetUs < BOOT_BUDGET_US, "boot scan estimate %.0f us", targetUs);
+}
+
+int main(void) {
+    testRoundTrip();
+    testCompaction();
+    testTornAppend();
+    testTornCompaction();
+    testBootScan();
+    return Check_Exit();
+}
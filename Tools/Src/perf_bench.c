@@ -0,0 +1,451 @@
+/**
+  * @file    perf_bench.c
+  * @brief   控制性能回归基准：固件控制栈在仿真模型上跑标准场景，与基线比较 | Control performance regression benchmark: the firmware control stack runs canonical scenarios on the plant and is compared against a baseline
+  *
+  * @note    用法 | Usage:
+  *          dnb_perf [-b baseline.csv] [--update] [-s scenario]... [-P name=value]...
+  *          固件的 CarMove（car.c、motor.c、pid.c、imu.c、MPU6500 解包与整个控制栈）经重放层闭环运行：
+  *          每个周期把模型的倾角、航向和角速度编码成 DMP 数据包，轮子转角编码成 TIM2/TIM3 计数，
+  *          执行 Replay_Step，再把 TIM1 的比较值作为 H 桥输入推进模型 10 ms。模型没有机械偏置，
+  *          bias 置 0。全程没有墙钟，结果逐位可复现。
+  *          The firmware's CarMove (car.c, motor.c, pid.c, imu.c, the MPU6500 unpacking and the
+  *          whole control stack) runs closed-loop through the replay layer: every period the
+  *          plant's pitch, heading and rates are encoded as a DMP packet and the wheel angles as
+  *          TIM2/TIM3 counts, Replay_Step runs, and the TIM1 compares drive the plant's bridges for
+  *          10 ms. The plant has no mechanical bias, so bias is set to 0. There is no wall clock;
+  *          results are bit-for-bit reproducible.
+  *          场景 | Scenarios:
+  *            push         静止时质心受 0.15 N·s 向前冲击 | A 0.15 N·s forward impulse on the COM while standing
+  *            speed_step   起步并加速到 18 cm/s | Launch and speed up to 18 cm/s
+  *            turn_around  原地掉头 180° | Turn 180° in place
+  *            slope        在 5° 上坡上起步 | Launch up a 5° incline
+  *            payload      车身上加 0.3 kg 偏放负载（质心上移、前移 0.5 cm） | A 0.3 kg off-centre payload lands on the body (COM up, 0.5 cm forward)
+  *          指标（越小越好） | Metrics (lower is better):
+  *            settle_s   事件之后响应一直留在容差带内所需时间 (s)；倒地按剩余时长计
+  *                       Time after the event until the response stays inside its band (s); a fall counts the rest of the run
+  *            overshoot  静止类：倾角偏离最终倾角的峰值 (°)；速度类：超过目标的百分比；掉头：超过 180° 的角度 (°)
+  *                       Standing: peak pitch excursion from the final lean (°); speed: % above target; turn: degrees past 180
+  *            rms_pitch  全程倾角均方根 (°) | RMS pitch over the run (°)
+  *            peak_pwm   最大 PWM 占空比 (%)，刹车除外 | Largest PWM duty (%), braking excluded
+  *            energy     电源侧电能，以堵转功率·秒为单位（同 dnb_tune） | Supply-side energy in stall-power seconds (as dnb_tune)
+  *            fell       倒地为 1 | 1 on a fall
+  *          每个指标与基线比较：超出 max(相对容差·|基线|, 绝对容差) 为 REGRESSED，低于同样幅度为 IMPROVED。
+  *          有退化时退出码为 1。
+  *          Each metric is compared with the baseline: more than max(relative tolerance·|baseline|,
+  *          absolute tolerance) above it is REGRESSED, as far below it IMPROVED. Exits 1 on any
+  *          regression.
+  *          -b        基线文件（默认为源码树中的 perf_baseline.csv） | Baseline file (default: perf_baseline.csv in the source tree)
+  *          --update  把本次结果写成基线 | Write this run's results as the baseline
+  *          -s        只跑指定场景，可重复 | Run only the named scenario, repeatable
+  *          -P        每个场景开始前修改参数，可重复；与上位机写入的路径相同 | Change a parameter before every scenario, repeatable; same path as a host write
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+#include "plant.h"
+#include "car.h"
+#include "command.h"
+
+#ifndef DNB_PERF_BASELINE
+#define DNB_PERF_BASELINE   "perf_baseline.csv"
+#endif
+
+#define TICK            0.01            /**< 控制周期 (s) | Control period */
+#define START_MS        5000            /**< 第一个周期的节拍，晚于 IMU 初始化 | Tick of the first period, after the IMU init */
+#define PWM_ARR         60000.0         /**< TIM1 自动重装值 | TIM1 auto-reload */
+#define QUAT_ONE        1073741824.0    /**< DMP 四元数的 1.0 (q30) | 1.0 in DMP quaternion units */
+#define GYRO_LSB        65.5            /**< 每 °/s 的角速度计数 | Gyro counts per deg/s */
+#define FIRMWARE_DEG    57.3            /**< 固件解包用的弧度换算 | Radian factor the firmware unpacks with */
+#define DEG             (180.0 / 3.14159265358979)
+
+#define SETTLE_PITCH    1.0             /**< 静止类容差：偏离最终倾角 (°) | Standing band: pitch off the final lean */
+#define SETTLE_SPEED    2.0             /**< 静止类容差：车速 (cm/s) | Standing band: speed */
+#define SETTLE_TRACK    0.1             /**< 速度类容差：目标的比例，不小于 SETTLE_SPEED | Speed band: fraction of the target, no tighter than SETTLE_SPEED */
+#define SETTLE_HEADING  10.0            /**< 掉头容差：离 180° (°) | Turn band: off 180° */
+#define SETTLE_YAW_RATE 10.0            /**< 掉头容差：偏航角速度 (°/s)，高于电机死区附近的抖动 | Turn band: yaw rate, above the dither near the motor dead band */
+#define FINAL_WINDOW    0.5             /**< 最终倾角取最后这段时间的平均 (s) | The final lean averages this much of the end */
+
+#define MAX_OVERRIDES   16
+#define MAX_TICKS       2000
+
+extern Car car;
+
+/**
+  * @brief   评估哪个响应 | Which response a scenario is judged on
+  */
+typedef enum {
+    RESPONSE_STILL,         /**< 回到静止：倾角与车速 | Back to standing: pitch and speed */
+    RESPONSE_SPEED,         /**< 跟踪目标车速 | Tracking the target speed */
+    RESPONSE_HEADING        /**< 转过 180° | Turning through 180° */
+} Response;
+
+typedef struct {
+    double time;
+    uint8_t cmd;
+} Event;
+
+#define MAX_EVENTS  4
+
+typedef struct {
+    const char *name;
+    double duration;        /**< 仿真时长 (s) | Simulated time */
+    double from;            /**< 从此刻起评估响应 (s) | The response is judged from here */
+    Response response;
+    Event script[MAX_EVENTS];
+    void (*setup)(PlantParams *p);
+    void (*disturb)(Plant *p);
+} Scenario;
+
+enum { M_SETTLE, M_OVERSHOOT, M_RMS_PITCH, M_PEAK_PWM, M_ENERGY, M_FELL, METRIC_COUNT };
+
+/**
+  * @brief   指标与退化阈值 | Metric and its regression threshold
+  */
+typedef struct {
+    const char *name;
+    double relative;        /**< 相对容差 | Relative tolerance */
+    double absolute;        /**< 绝对容差，基线接近 0 时起作用 | Absolute tolerance, for baselines near 0 */
+} Metric;
+
+static const Metric metrics[METRIC_COUNT] = {
+        [M_SETTLE]    = {"settle_s",  0.10, 0.05},
+        [M_OVERSHOOT] = {"overshoot", 0.10, 0.20},
+        [M_RMS_PITCH] = {"rms_pitch", 0.05, 0.02},
+        [M_PEAK_PWM]  = {"peak_pwm",  0.05, 1.00},
+        [M_ENERGY]    = {"energy",    0.05, 0.001},
+        [M_FELL]      = {"fell",      0.00, 0.50},
+};
+
+static void pushPulse(Plant *p) {
+    p->push = (p->time >= 2.0 - 1e-9 && p->time < 2.1 - 1e-9) ? 1.5 : 0.0;
+}
+
+static void onSlope(PlantParams *p) {
+    p->slope = 5.0 / DEG;
+}
+
+static void payloadDrop(Plant *p) {
+    if (p->time >= 2.0 - 1e-9 && p->p.comOffset == 0.0) {
+        // 0.3 kg 放在轮轴上方 12 cm、前方 2 cm：合成质心 | 0.3 kg at 12 cm above and 2 cm ahead of the axle: combined COM
+        const double m = 0.3, h = 0.12, d = 0.02;
+        double M = p->p.bodyMass;
+        p->p.comOffset = m * d / (M + m);
+        p->p.comHeight = (M * p->p.comHeight + m * h) / (M + m);
+        p->p.bodyMass = M + m;
+    }
+}
+
+static const Scenario scenarios[] = {
+        {"push",        12.0, 2.0, RESPONSE_STILL,   {{0, 0}},                  NULL,    pushPulse},
+        {"speed_step",  10.0, 1.0, RESPONSE_SPEED,   {{1.0, CMD_FORWARD}, {1.0, CMD_SPEED_UP}, {1.0, CMD_SPEED_UP}},
+                                                                                NULL,    NULL},
+        {"turn_around", 8.0,  1.0, RESPONSE_HEADING, {{1.0, CMD_TURN_AROUND}},  NULL,    NULL},
+        {"slope",       12.0, 3.0, RESPONSE_SPEED,   {{3.0, CMD_FORWARD}},      onSlope, NULL},
+        {"payload",     12.0, 2.0, RESPONSE_STILL,   {{0, 0}},                  NULL,    payloadDrop},
+};
+
+#define SCENARIO_COUNT  (sizeof(scenarios) / sizeof(scenarios[0]))
+
+/* 每个周期的真值，用于事后评估 | Ground truth of every period, judged afterwards */
+typedef struct {
+    double pitch;           /**< (°) */
+    double speed;           /**< (cm/s) */
+    double heading;         /**< 相对起点 (°) | Relative to the start */
+    double yawRate;         /**< (°/s) */
+} Sample;
+
+/**
+  * @brief   电源侧功率，以堵转功率为单位（同 dnb_tune） | Supply-side power in stall-power units (as dnb_tune)
+  */
+static double supplyPower(const Plant *p, int wheel, double duty) {
+    double half = p->p.track / 2.0;
+    double w = (p->xd + (wheel ? half : -half) * p->psid) / p->p.wheelRadius - p->thetad;
+    double power = duty * (duty - w / p->p.noLoadSpeed);
+    return power > 0.0 ? power : 0.0;
+}
+
+static int16_t gyroCounts(double rate) {
+    double v = rate * GYRO_LSB;
+    return (int16_t)lrint(fmax(fmin(v, 32767.0), -32768.0));
+}
+
+/**
+  * @brief   把模型读数编码成固件的一条传感器日志记录 | Encode the plant readings as one firmware sensor log record
+  * @note    四元数由横滚 θ 与航向 ψ 合成：q = q_z(ψ)·q_x(θ)，固件按 57.3 换算回角度
+  *          The quaternion composes roll θ and yaw ψ: q = q_z(ψ)·q_x(θ); the firmware converts back with 57.3
+  */
+static void sense(Plant *p, uint32_t tick, SensorLogRecord *rec) {
+    float pitch, pitchRate, yawRate;
+    int16_t left, right;
+    Plant_ReadImu(p, &pitch, &pitchRate, &yawRate);
+    float yaw = Plant_ReadYaw(p);
+    Plant_ReadEncoders(p, &left, &right);
+
+    double hx = pitch / FIRMWARE_DEG / 2.0, hz = yaw / FIRMWARE_DEG / 2.0;
+    double cx = cos(hx), sx = sin(hx), cz = cos(hz), sz = sin(hz);
+    memset(rec, 0, sizeof(*rec));
+    rec->tick_ms = tick;
+    rec->loop_us = (uint16_t)lrint(TICK * 1e6);
+    rec->enc[0] = (uint16_t)(WHEEL_L_SIGN * left);
+    rec->enc[1] = (uint16_t)(WHEEL_R_SIGN * right);
+    rec->quat[0] = (int32_t)lrint(cz * cx * QUAT_ONE);
+    rec->quat[1] = (int32_t)lrint(cz * sx * QUAT_ONE);
+    rec->quat[2] = (int32_t)lrint(sz * sx * QUAT_ONE);
+    rec->quat[3] = (int32_t)lrint(sz * cx * QUAT_ONE);
+    rec->accel[2] = 16384;
+    rec->gyro[0] = gyroCounts(pitchRate);
+    rec->gyro[2] = gyroCounts(yawRate);
+    rec->flags = SENSOR_LOG_IMU;
+}
+
+/**
+  * @brief   TIM1 比较值换成 H 桥输入；右电机镜像安装，前进用 CH4 | TIM1 compares to bridge inputs; the right motor is mirrored, so CH4 drives it forward
+  */
+static void actuate(const ReplayOutput *out, HBridge cmd[2]) {
+    cmd[0] = (HBridge){out->pwm_l1 / PWM_ARR, out->pwm_l2 / PWM_ARR};
+    cmd[1] = (HBridge){out->pwm_r2 / PWM_ARR, out->pwm_r1 / PWM_ARR};
+}
+
+static const char *overrides[MAX_OVERRIDES];
+static int overrideCount = 0;
+
+/**
+  * @brief   从上电开始跑一个场景 | Run one scenario from power-up
+  * @return  0 成功，-1 初始化或参数失败 | 0 on success, -1 if the init or a parameter fails
+  */
+static int runScenario(const Scenario *sc, double value[METRIC_COUNT]) {
+    if (Replay_Begin() != 0 || Replay_Set("bias", 0.0f) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < overrideCount; i++) {
+        char name[32];
+        float v;
+        if (sscanf(overrides[i], "%31[^=]=%f", name, &v) != 2 || Replay_Set(name, v) != 0) {
+            fprintf(stderr, "bad parameter '%s'\n", overrides[i]);
+            return -1;
+        }
+    }
+    PlantParams pp = Plant_DefaultParams();
+    if (sc->setup) sc->setup(&pp);
+    Plant plant;
+    Plant_Init(&plant, &pp, 0.0, 1);
+
+    static Sample trace[MAX_TICKS];
+    size_t n = 0, next = 0;
+    double target = 0.0, energy = 0.0, peakPwm = 0.0, pitchSq = 0.0;
+    int fell = 0;
+    for (double t = 0.0; t < sc->duration - 1e-9 && n < MAX_TICKS; t += TICK) {
+        SensorLogRecord rec;
+        sense(&plant, START_MS + (uint32_t)n * (uint32_t)lrint(TICK * 1e3), &rec);
+        while (next < MAX_EVENTS && sc->script[next].cmd != 0 && sc->script[next].time <= t + 1e-9) {
+            rec.cmd[rec.ncmd++] = sc->script[next++].cmd;
+        }
+        ReplayOutput out;
+        Replay_Step(&rec, &out);
+        if (next > 0) {
+            target = car.control.motion.linear.target;
+        }
+
+        if (sc->disturb) sc->disturb(&plant);
+        HBridge cmd[2];
+        actuate(&out, cmd);
+        Plant_Drive(&plant, cmd, TICK);
+
+        Sample *s = &trace[n++];
+        s->pitch = plant.theta * DEG;
+        s->speed = plant.xd * 100.0;
+        s->heading = plant.psi * DEG;
+        s->yawRate = plant.psid * DEG;
+        pitchSq += s->pitch * s->pitch;
+        energy += (supplyPower(&plant, 0, plant.duty[0]) + supplyPower(&plant, 1, plant.duty[1])) * TICK;
+        if (!out.brake) {
+            // 不刹车时每个桥只有一路非零 | Outside braking one input per bridge is zero
+            peakPwm = fmax(peakPwm, fmax(out.pwm_l1 + out.pwm_l2, out.pwm_r1 + out.pwm_r2) / PWM_ARR * 100.0);
+        }
+        if (fabs(s->pitch) > BALANCE_FALL_ANGLE) {
+            fell = 1;
+            break;
+        }
+    }
+
+    // 最终倾角：最后 FINAL_WINDOW 秒的平均 | Final lean: the mean of the last FINAL_WINDOW seconds
+    size_t window = (size_t)lrint(FINAL_WINDOW / TICK), first = (size_t)lrint(sc->from / TICK);
+    double finalPitch = 0.0;
+    for (size_t i = n > window ? n - window : 0; i < n; i++) finalPitch += trace[i].pitch;
+    finalPitch /= (double)(n < window ? (n ? n : 1) : window);
+
+    double overshoot = 0.0, unsettledUntil = sc->from;
+    for (size_t i = first; i < n; i++) {
+        const Sample *s = &trace[i];
+        int settled;
+        switch (sc->response) {
+            case RESPONSE_SPEED:
+                overshoot = fmax(overshoot, target > 0.0 ? (s->speed - target) / target * 100.0 : 0.0);
+                settled = fabs(s->speed - target) < fmax(SETTLE_TRACK * target, SETTLE_SPEED);
+                break;
+            case RESPONSE_HEADING:
+                overshoot = fmax(overshoot, fabs(s->heading) - 180.0);
+                settled = fabs(fabs(s->heading) - 180.0) < SETTLE_HEADING && fabs(s->yawRate) < SETTLE_YAW_RATE;
+                break;
+            default:
+                overshoot = fmax(overshoot, fabs(s->pitch - finalPitch));
+                settled = fabs(s->pitch - finalPitch) < SETTLE_PITCH && fabs(s->speed) < SETTLE_SPEED;
+                break;
+        }
+        if (!settled) {
+            unsettledUntil = (double)(i + 1) * TICK;
+        }
+    }
+    if (fell) {
+        unsettledUntil = sc->duration;
+    }
+
+    value[M_SETTLE] = unsettledUntil - sc->from;
+    value[M_OVERSHOOT] = overshoot;
+    value[M_RMS_PITCH] = sqrt(pitchSq / (double)(n ? n : 1));
+    value[M_PEAK_PWM] = peakPwm;
+    value[M_ENERGY] = energy;
+    value[M_FELL] = fell;
+    return 0;
+}
+
+/* 基线 | Baseline */
+static double baseline[SCENARIO_COUNT][METRIC_COUNT];
+static int hasBaseline[SCENARIO_COUNT][METRIC_COUNT];
+
+static int findScenario(const char *name) {
+    for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+        if (strcmp(scenarios[i].name, name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+static int findMetric(const char *name) {
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        if (strcmp(metrics[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+/**
+  * @brief   读入基线：每行 scenario,metric,value，不认识的行忽略 | Load the baseline: one scenario,metric,value per line, unknown rows ignored
+  * @return  读到的值数，文件不存在返回 -1 | Values read, -1 if the file is missing
+  */
+static int loadBaseline(const char *path) {
+    FILE *in = fopen(path, "r");
+    if (in == NULL) {
+        return -1;
+    }
+    char line[256], sc[64], metric[64];
+    double v;
+    int count = 0;
+    while (fgets(line, sizeof(line), in) != NULL) {
+        if (sscanf(line, "%63[^,],%63[^,],%lf", sc, metric, &v) != 3) continue;
+        int s = findScenario(sc), m = findMetric(metric);
+        if (s < 0 || m < 0) continue;
+        baseline[s][m] = v;
+        hasBaseline[s][m] = 1;
+        count++;
+    }
+    fclose(in);
+    return count;
+}
+
+static int writeBaseline(const char *path, const int *selected, double (*value)[METRIC_COUNT]) {
+    // 没跑的场景保留原值 | Scenarios not run keep their old values
+    for (size_t s = 0; s < SCENARIO_COUNT; s++) {
+        if (!selected[s]) continue;
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            baseline[s][m] = value[s][m];
+            hasBaseline[s][m] = 1;
+        }
+    }
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        return -1;
+    }
+    fprintf(out, "scenario,metric,value\n");
+    for (size_t s = 0; s < SCENARIO_COUNT; s++) {
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            if (hasBaseline[s][m]) fprintf(out, "%s,%s,%.6g\n", scenarios[s].name, metrics[m].name, baseline[s][m]);
+        }
+    }
+    return fclose(out);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-b baseline.csv] [--update] [-s scenario]... [-P name=value]...\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *path = DNB_PERF_BASELINE;
+    int update = 0, any = 0;
+    int selected[SCENARIO_COUNT] = {0};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "--update") == 0) {
+            update = 1;
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            int s = findScenario(argv[++i]);
+            if (s < 0) {
+                fprintf(stderr, "unknown scenario '%s'\n", argv[i]);
+                return 2;
+            }
+            selected[s] = any = 1;
+        } else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc && overrideCount < MAX_OVERRIDES) {
+            overrides[overrideCount++] = argv[++i];
+        } else {
+            usage(argv[0]);
+        }
+    }
+    for (size_t s = 0; s < SCENARIO_COUNT && !any; s++) {
+        selected[s] = 1;
+    }
+    if (loadBaseline(path) < 0 && !update) {
+        fprintf(stderr, "%s: no baseline, every metric is reported as new\n", path);
+    }
+
+    static double value[SCENARIO_COUNT][METRIC_COUNT];
+    int regressed = 0, improved = 0;
+    printf("%-12s %-10s %12s %12s %12s  %s\n", "scenario", "metric", "value", "baseline", "limit", "verdict");
+    for (size_t s = 0; s < SCENARIO_COUNT; s++) {
+        if (!selected[s]) continue;
+        if (runScenario(&scenarios[s], value[s]) != 0) {
+            fprintf(stderr, "%s: setup failed\n", scenarios[s].name);
+            return 1;
+        }
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            double v = value[s][m];
+            if (!hasBaseline[s][m]) {
+                printf("%-12s %-10s %12.4f %12s %12s  %s\n", scenarios[s].name, metrics[m].name, v, "-", "-", "new");
+                continue;
+            }
+            double base = baseline[s][m];
+            double tol = fmax(metrics[m].relative * fabs(base), metrics[m].absolute);
+            const char *verdict = "ok";
+            if (v > base + tol) {
+                verdict = "REGRESSED";
+                regressed++;
+            } else if (v < base - tol) {
+                verdict = "IMPROVED";
+                improved++;
+            }
+            printf("%-12s %-10s %12.4f %12.4f %12.4f  %s\n", scenarios[s].name, metrics[m].name, v, base, base + tol, verdict);
+        }
+    }
+
+    if (update) {
+        if (writeBaseline(path, selected, value) != 0) {
+            perror(path);
+            return 1;
+        }
+        printf("baseline written to %s\n", path);
+        return 0;
+    }
+    printf("%d regressed, %d improved: %s\n", regressed, improved, regressed ? "REGRESSED" : "PASS");
+    return regressed ? 1 : 0;
+}
@@ -0,0 +1,201 @@
+/**
+  * @file    plant.c
+  * @brief   两轮自平衡小车仿真模型 | Two-wheeled balancing car simulation model
+  */
+#include <math.h>
+#include "plant.h"
+#include "plant_math.h"
+
+#define G       9.81
+#define SUBSTEP 0.0005      /**< 积分步长 (s) | Integration step */
+#define MOTOR_SUBSTEP 0.0001    /**< 高保真电机的积分步长，短于 PWM 周期 (s) | Integration step with the high-fidelity motor, shorter than a PWM period */
+#define PI      3.14159265358979
+
+PlantParams Plant_DefaultParams(void) {
+    PlantParams p = {
+            .bodyMass    = 0.9,
+            .comHeight   = 0.08,
+            .bodyInertia = 0.0025,
+            .yawInertia  = 0.0030,
+            .wheelMass   = 0.04,
+            .wheelRadius = 0.0325,
+            .track       = 0.16,
+            .stallTorque = 0.6,
+            .noLoadSpeed = 34.6,
+            .encoderCpr  = 1560.0,
+            .pitchNoise  = 0.05,
+            .gyroNoise   = 0.3,
+            .yawRateBias = 0.5,
+            .dmpYawDrift = 0.05,
+            .encoderScaleR = 0.01
+    };
+    return p;
+}
+
+void Plant_Init(Plant *self, const PlantParams *p, double theta, uint32_t seed) {
+    *self = (Plant){.p = *p, .theta = theta, .rng = seed ? seed : 1};
+    if (p->motor) {
+        DcMotor_Init(&self->motor[0], p->motor, 0.0);
+        DcMotor_Init(&self->motor[1], p->motor, 0.0);
+    }
+}
+
+/**
+  * @brief   电机轮端力矩 | Motor torque at the wheel
+  */
+static double motorTorque(const PlantParams *p, double duty, double omega) {
+    if (duty > 1.0) duty = 1.0;
+    if (duty < -1.0) duty = -1.0;
+    return p->stallTorque * (duty - omega / p->noLoadSpeed);
+}
+
+/**
+  * @brief   给定轮端力矩推进一个子步 | Advance one substep under the given wheel torques
+  */
+static void integrate(Plant *self, double tl, double tr, double wl, double wr, double h) {
+    const PlantParams *p = &self->p;
+    const double M = p->bodyMass, l = p->comHeight, r = p->wheelRadius, half = p->track / 2.0;
+    const double iw = 0.5 * p->wheelMass * r * r;
+    const double mw = 2.0 * (p->wheelMass + iw / (r * r));          // 轮子等效平动质量 | Wheels' equivalent mass
+    const double iz = p->yawInertia + mw * half * half;
+    double tau = tl + tr;
+
+    // 质心前移时，质心在倾角 β = θ + φ0、距轮轴 L 处 | With a forward COM offset the COM sits at angle β = θ + φ0, L from the axle
+    double beta = self->theta, L = l;
+    if (p->comOffset != 0.0) {
+        beta += atan2(p->comOffset, l);
+        L = hypot(p->comOffset, l);
+    }
+    // 耦合项用坡面与质心方向的夹角 γ = β + α | The coupling terms use the angle γ = β + α between the slope and the COM
+    double sb, cb;
+    plantSinCos(beta, &sb, &cb);
+    double s = sb, c = cb;
+    if (p->slope != 0.0) {
+        plantSinCos(beta + p->slope, &s, &c);
+    }
+
+    // 求解 2×2 质量矩阵 | Solve the 2x2 mass matrix
+    double a11 = M + mw, a12 = M * L * c;
+    double a21 = M * L * c, a22 = p->bodyInertia + M * L * L;
+    double b1 = M * L * s * self->thetad * self->thetad + tau / r;
+    double b2 = M * G * L * sb - tau;
+    if (p->slope != 0.0) {
+        b1 -= (M + 2.0 * p->wheelMass) * G * sin(p->slope);
+    }
+    if (self->push != 0.0) {
+        b1 += self->push;
+        b2 += self->push * L * c;
+    }
+    double det = a11 * a22 - a12 * a21;
+    double xdd = (b1 * a22 - a12 * b2) / det;
+    double thdd = (a11 * b2 - a21 * b1) / det;
+    double psidd = (tr - tl) / r * half / iz;
+
+    // 半隐式欧拉 | Semi-implicit Euler
+    self->xd += xdd * h;
+    self->thetad += thdd * h;
+    self->psid += psidd * h;
+    self->x += self->xd * h;
+    self->theta += self->thetad * h;
+    self->psi += self->psid * h;
+    double cp, sp;
+    plantSinCos(self->psi, &sp, &cp);
+    self->px += self->xd * cp * h;
+    self->py += self->xd * sp * h;
+    self->wheel[0] += wl * h;
+    self->wheel[1] += wr * h;
+}
+
+/**
+  * @brief   Move() 对有符号占空比的接法 | How Move() wires a signed duty
+  */
+static HBridge bridgeOf(double duty) {
+    return duty > 0.0 ? (HBridge){duty, 0.0} : (HBridge){0.0, -duty};
+}
+
+void Plant_Drive(Plant *self, const HBridge cmd[2], double dt) {
+    const PlantParams *p = &self->p;
+    if (!p->motor) {
+        Plant_Step(self, cmd[0].in1 - cmd[0].in2, cmd[1].in1 - cmd[1].in2, dt);
+        return;
+    }
+    const double r = p->wheelRadius, half = p->track / 2.0;
+
+    self->duty[0] = cmd[0].in1 - cmd[0].in2;
+    self->duty[1] = cmd[1].in1 - cmd[1].in2;
+
+    for (double t = 0.0; t < dt - 1e-9; t += MOTOR_SUBSTEP) {
+        double h = fmin(MOTOR_SUBSTEP, dt - t);
+        double wl = (self->xd - self->psid * half) / r - self->thetad;
+        double wr = (self->xd + self->psid * half) / r - self->thetad;
+        // 齿轮力矩同时作用在轮子和车身上；忽略的转子自身角动量只有其折算惯量的 1/N
+        // The gear torque acts on both wheel and body; the rotor's own angular momentum, left out, is only 1/N of its reflected inertia
+        double tl = DcMotor_Step(&self->motor[0], cmd[0], self->wheel[0], wl, h);
+        double tr = DcMotor_Step(&self->motor[1], cmd[1], self->wheel[1], wr, h);
+        integrate(self, tl, tr, wl, wr, h);
+    }
+    self->time += dt;
+}
+
+void Plant_Step(Plant *self, double dutyL, double dutyR, double dt) {
+    const PlantParams *p = &self->p;
+    if (p->motor) {
+        const HBridge cmd[2] = {bridgeOf(dutyL), bridgeOf(dutyR)};
+        Plant_Drive(self, cmd, dt);
+        return;
+    }
+    const double r = p->wheelRadius, half = p->track / 2.0;
+
+    self->duty[0] = dutyL;
+    self->duty[1] = dutyR;
+
+    for (double t = 0.0; t < dt - 1e-9; t += SUBSTEP) {
+        double h = fmin(SUBSTEP, dt - t);
+
+        // 轮子相对车身的角速度 | Wheel angular velocity relative to the body
+        double wl = (self->xd - self->psid * half) / r - self->thetad;
+        double wr = (self->xd + self->psid * half) / r - self->thetad;
+        double tl = motorTorque(p, dutyL, wl);
+        double tr = motorTorque(p, dutyR, wr);
+        integrate(self, tl, tr, wl, wr, h);
+    }
+    self->time += dt;
+}
+
+void Plant_ReadImu(Plant *self, float *pitch, float *pitchRate, float *yawRate) {
+    *pitch = (float)(self->theta * 180.0 / PI + self->p.pitchNoise * plantNoise(&self->rng));
+    *pitchRate = (float)(self->thetad * 180.0 / PI + self->p.gyroNoise * plantNoise(&self->rng));
+    *yawRate = (float)(self->psid * 180.0 / PI + self->p.yawRateBias + self->p.gyroNoise * plantNoise(&self->rng));
+}
+
+float Plant_ReadYaw(Plant *self) {
+    double yaw = self->psi * 180.0 / PI + self->p.dmpYawDrift * self->time + 0.02 * plantNoise(&self->rng);
+    return (float)remainder(yaw, 360.0);
+}
+
+/**
+  * @brief   x4 模式的计数：B 相边沿晚 quadratureError 个计数，落在奇数计数上 | x4 count: the B-phase edges, on odd counts, come quadratureError counts late
+  */
+static int32_t quadrature(double f, double error) {
+    double n = floor(f);
+    if (fmod(n, 2.0) != 0.0 && f - n < error) {
+        n -= 1.0;
+    }
+    return (int32_t)n;
+}
+
+void Plant_ReadEncoders(Plant *self, int16_t *left, int16_t *right) {
+    int16_t *out[2] = {left, right};
+    for (int i = 0; i < 2; i++) {
+        double scale = (i == 1) ? 1.0 - self->p.encoderScaleR : 1.0;
+        int32_t now;
+        if (self->p.motor) {
+            // 编码器在电机轴上，看到的是齿隙之前的转子 | The encoder is on the motor shaft and sees the rotor before the backlash
+            now = quadrature(self->motor[i].rotor * scale / (2.0 * PI) * self->p.encoderCpr, self->p.motor->quadratureError);
+        } else {
+            now = (int32_t)floor(self->wheel[i] * scale / (2.0 * PI) * self->p.encoderCpr);
+        }
+        *out[i] = (int16_t)(now - self->count[i]);
+        self->count[i] = now;
+    }
+}
@@ -0,0 +1,217 @@
+/**
+  * @file    plant_batch.c
+  * @brief   批量模型 | Batched plant
+  *
+  * @note    每一行运算都照抄 plant.c 的写法和次序；修改其中一边时必须同时修改另一边，
+  *          dnb_batch_bench 会检查两边逐位相同。
+  *          Every line of arithmetic copies plant.c's expression and order; change one side and
+  *          the other must follow. dnb_batch_bench checks that the two stay bit-identical.
+  */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "plant_batch.h"
+#include "plant_math.h"
+
+#define G       9.81
+#define SUBSTEP 0.0005      /**< 积分步长 (s)，与 plant.c 相同 | Integration step, as in plant.c */
+#define PI      3.14159265358979
+#define ALIGN   64
+
+#define DOUBLE_ARRAYS   28
+#define WORD_ARRAYS     3
+
+static void *carve(char **cursor, size_t bytes) {
+    void *p = *cursor;
+    *cursor += bytes;
+    return p;
+}
+
+int PlantBatch_Init(PlantBatch *self, uint32_t n) {
+    memset(self, 0, sizeof(*self));
+    uint32_t stride = (n + 7u) & ~7u;
+    size_t row = (size_t)stride * sizeof(double);
+    size_t bytes = row * (DOUBLE_ARRAYS + WORD_ARRAYS);
+    char *mem = aligned_alloc(ALIGN, bytes ? bytes : ALIGN);
+    if (!mem) {
+        return -1;
+    }
+    memset(mem, 0, bytes);
+    self->n = n;
+    self->stride = stride;
+    self->mem = mem;
+
+    // 每个数组占 stride 个 double，起点都按 64 字节对齐 | Each array takes stride doubles and starts 64-byte aligned
+    char *c = mem;
+    double **d[DOUBLE_ARRAYS] = {
+            &self->bodyMass, &self->comHeight, &self->bodyInertia, &self->wheelRadius, &self->half, &self->mw,
+            &self->iz, &self->stallTorque, &self->noLoadSpeed, &self->encoderCpr, &self->encoderScaleR,
+            &self->pitchNoise, &self->gyroNoise, &self->yawRateBias, &self->dmpYawDrift,
+            &self->x, &self->xd, &self->theta, &self->thetad, &self->psi, &self->psid, &self->px, &self->py,
+            &self->time, &self->wheel[0], &self->wheel[1], &self->duty[0], &self->duty[1]
+    };
+    for (int k = 0; k < DOUBLE_ARRAYS; k++) {
+        *d[k] = carve(&c, row);
+    }
+    self->count[0] = carve(&c, row);
+    self->count[1] = carve(&c, row);
+    self->rng = carve(&c, row);
+    return 0;
+}
+
+void PlantBatch_Free(PlantBatch *self) {
+    free(self->mem);
+    memset(self, 0, sizeof(*self));
+}
+
+void PlantBatch_Set(PlantBatch *self, uint32_t i, const Plant *p) {
+    const PlantParams *q = &p->p;
+    const double r = q->wheelRadius, half = q->track / 2.0;
+    const double iw = 0.5 * q->wheelMass * r * r;
+    const double mw = 2.0 * (q->wheelMass + iw / (r * r));
+
+    self->bodyMass[i] = q->bodyMass;
+    self->comHeight[i] = q->comHeight;
+    self->bodyInertia[i] = q->bodyInertia;
+    self->wheelRadius[i] = r;
+    self->half[i] = half;
+    self->mw[i] = mw;
+    self->iz[i] = q->yawInertia + mw * half * half;
+    self->stallTorque[i] = q->stallTorque;
+    self->noLoadSpeed[i] = q->noLoadSpeed;
+    self->encoderCpr[i] = q->encoderCpr;
+    self->encoderScaleR[i] = q->encoderScaleR;
+    self->pitchNoise[i] = q->pitchNoise;
+    self->gyroNoise[i] = q->gyroNoise;
+    self->yawRateBias[i] = q->yawRateBias;
+    self->dmpYawDrift[i] = q->dmpYawDrift;
+
+    self->x[i] = p->x;
+    self->xd[i] = p->xd;
+    self->theta[i] = p->theta;
+    self->thetad[i] = p->thetad;
+    self->psi[i] = p->psi;
+    self->psid[i] = p->psid;
+    self->px[i] = p->px;
+    self->py[i] = p->py;
+    self->time[i] = p->time;
+    self->wheel[0][i] = p->wheel[0];
+    self->wheel[1][i] = p->wheel[1];
+    self->count[0][i] = p->count[0];
+    self->count[1][i] = p->count[1];
+    self->duty[0][i] = p->duty[0];
+    self->duty[1][i] = p->duty[1];
+    self->rng[i] = p->rng;
+}
+
+void PlantBatch_Get(const PlantBatch *self, uint32_t i, Plant *p) {
+    p->x = self->x[i];
+    p->xd = self->xd[i];
+    p->theta = self->theta[i];
+    p->thetad = self->thetad[i];
+    p->psi = self->psi[i];
+    p->psid = self->psid[i];
+    p->px = self->px[i];
+    p->py = self->py[i];
+    p->time = self->time[i];
+    p->wheel[0] = self->wheel[0][i];
+    p->wheel[1] = self->wheel[1][i];
+    p->count[0] = self->count[0][i];
+    p->count[1] = self->count[1][i];
+    p->duty[0] = self->duty[0][i];
+    p->duty[1] = self->duty[1][i];
+    p->rng = self->rng[i];
+}
+
+/**
+  * @brief   推进 [lo, hi) 这一组车一个周期 | Advance cars [lo, hi) through one period
+  */
+static void stepBlock(PlantBatch *self, uint32_t lo, uint32_t hi, double dt) {
+    const double *restrict M = self->bodyMass, *restrict l = self->comHeight, *restrict bi = self->bodyInertia;
+    const double *restrict r = self->wheelRadius, *restrict half = self->half, *restrict mw = self->mw;
+    const double *restrict iz = self->iz, *restrict ts = self->stallTorque, *restrict w0 = self->noLoadSpeed;
+    const double *restrict dutyL = self->duty[0], *restrict dutyR = self->duty[1];
+    double *restrict x = self->x, *restrict xd = self->xd, *restrict theta = self->theta;
+    double *restrict thetad = self->thetad, *restrict psi = self->psi, *restrict psid = self->psid;
+    double *restrict px = self->px, *restrict py = self->py;
+    double *restrict wheelL = self->wheel[0], *restrict wheelR = self->wheel[1];
+
+    for (double t = 0.0; t < dt - 1e-9; t += SUBSTEP) {
+        double h = fmin(SUBSTEP, dt - t);
+        // 各车的数组互不重叠 | The cars' arrays never overlap
+#pragma GCC ivdep
+        for (uint32_t i = lo; i < hi; i++) {
+            double uL = dutyL[i] > 1.0 ? 1.0 : dutyL[i];
+            uL = uL < -1.0 ? -1.0 : uL;
+            double uR = dutyR[i] > 1.0 ? 1.0 : dutyR[i];
+            uR = uR < -1.0 ? -1.0 : uR;
+
+            double wl = (xd[i] - psid[i] * half[i]) / r[i] - thetad[i];
+            double wr = (xd[i] + psid[i] * half[i]) / r[i] - thetad[i];
+            double tl = ts[i] * (uL - wl / w0[i]);
+            double tr = ts[i] * (uR - wr / w0[i]);
+            double tau = tl + tr;
+
+            double c, s;
+            plantSinCos(theta[i], &s, &c);
+            double a11 = M[i] + mw[i], a12 = M[i] * l[i] * c;
+            double a21 = M[i] * l[i] * c, a22 = bi[i] + M[i] * l[i] * l[i];
+            double b1 = M[i] * l[i] * s * thetad[i] * thetad[i] + tau / r[i];
+            double b2 = M[i] * G * l[i] * s - tau;
+            double det = a11 * a22 - a12 * a21;
+            double xdd = (b1 * a22 - a12 * b2) / det;
+            double thdd = (a11 * b2 - a21 * b1) / det;
+            double psidd = (tr - tl) / r[i] * half[i] / iz[i];
+
+            xd[i] += xdd * h;
+            thetad[i] += thdd * h;
+            psid[i] += psidd * h;
+            x[i] += xd[i] * h;
+            theta[i] += thetad[i] * h;
+            psi[i] += psid[i] * h;
+            double cp, sp;
+            plantSinCos(psi[i], &sp, &cp);
+            px[i] += xd[i] * cp * h;
+            py[i] += xd[i] * sp * h;
+            wheelL[i] += wl * h;
+            wheelR[i] += wr * h;
+        }
+    }
+}
+
+void PlantBatch_Step(PlantBatch *self, double dt) {
+    for (uint32_t lo = 0; lo < self->n; lo += PLANT_BATCH_BLOCK) {
+        uint32_t hi = self->n - lo < PLANT_BATCH_BLOCK ? self->n : lo + PLANT_BATCH_BLOCK;
+        stepBlock(self, lo, hi, dt);
+    }
+    for (uint32_t i = 0; i < self->n; i++) {
+        self->time[i] += dt;
+    }
+}
+
+void PlantBatch_ReadImu(PlantBatch *self, float *pitch, float *pitchRate, float *yawRate) {
+    for (uint32_t i = 0; i < self->n; i++) {
+        pitch[i] = (float)(self->theta[i] * 180.0 / PI + self->pitchNoise[i] * plantNoise(&self->rng[i]));
+        pitchRate[i] = (float)(self->thetad[i] * 180.0 / PI + self->gyroNoise[i] * plantNoise(&self->rng[i]));
+        yawRate[i] = (float)(self->psid[i] * 180.0 / PI + self->yawRateBias[i] + self->gyroNoise[i] * plantNoise(&self->rng[i]));
+    }
+}
+
+void PlantBatch_ReadYaw(PlantBatch *self, float *yaw) {
+    for (uint32_t i = 0; i < self->n; i++) {
+        double y = self->psi[i] * 180.0 / PI + self->dmpYawDrift[i] * self->time[i] + 0.02 * plantNoise(&self->rng[i]);
+        yaw[i] = (float)remainder(y, 360.0);
+    }
+}
+
+void PlantBatch_ReadEncoders(PlantBatch *self, int16_t *left, int16_t *right) {
+    int16_t *out[2] = {left, right};
+    for (int k = 0; k < 2; k++) {
+        for (uint32_t i = 0; i < self->n; i++) {
+            double scale = (k == 1) ? 1.0 - self->encoderScaleR[i] : 1.0;
+            int32_t now = (int32_t)floor(self->wheel[k][i] * scale / (2.0 * PI) * self->encoderCpr[i]);
+            out[k][i] = (int16_t)(now - self->count[k][i]);
+            self->count[k][i] = now;
+        }
+    }
+}
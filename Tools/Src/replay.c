@@ -0,0 +1,250 @@
+/**
+  * @file    replay.c
+  * @brief   传感器日志重放 | Sensor log replay
+  */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+#include "collog.h"
+#include "log_schema.h"
+#include "car.h"
+#include "hcsr04.h"
+#include "param.h"
+#include "param_store.h"
+#include "protocol.h"
+#include "mpu6500_emu.h"
+
+#define BUS_HZ          400000      /**< 与 hi2c1 相同 | Same as hi2c1 */
+#define INIT_TICKS      1000        /**< IMU 初始化最多的控制周期 | Most control periods for the IMU init */
+
+/* 固件 main.c、tim.c、telemetry.c、sensor_log.c 中的全局量 | Globals from the firmware's main.c, tim.c, telemetry.c and sensor_log.c */
+Car car;
+TIM_HandleTypeDef htim1, htim2, htim3, htim4, htim9;
+uint8_t telemetryPeriodMs = 0;
+uint8_t sensorLogEnabled = 0;
+extern ParamStore paramStore;
+
+static TIM_TypeDef tim1, tim2, tim3, tim4, tim9;
+static Mpu6500Emu emu;
+static uint8_t flash[2 * 16384];
+static const SensorLogRecord *current;
+
+/**
+  * @brief   主机端 HC_Read：返回当前记录的读数 | Host HC_Read: the current record's reading
+  * @note    时间戳按记录的时长相对 HAL_GetTick 还原，CarMove 算出的时长与现场相同
+  *          The timestamp is rebuilt from the recorded age relative to HAL_GetTick, so the age
+  *          CarMove computes matches the field
+  */
+void HC_Read(UltrasonicReading *reading) {
+    reading->distance = current->range;
+    reading->valid = (current->flags & SENSOR_LOG_RANGE_VALID) ? TRUE : FALSE;
+    reading->timestamp = HAL_GetTick() - current->range_age_ms;
+}
+
+/**
+  * @brief   从列式日志还原记录：按名称对应通道，旧日志缺少的通道为 0 | Rebuild records from a columnar log: channels match by name, channels an older log lacks are 0
+  */
+static int loadColumnar(ReplayLog *self, const char *path) {
+    ColLogReader log;
+    int ret = ColLog_Open(&log, path);
+    if (ret != COLLOG_OK) {
+        if (ret != COLLOG_ERR_IO) errno = EINVAL;
+        return -1;
+    }
+    if (strcmp(log.schema.stream, sensorLogSchema.stream) != 0) {
+        ColLog_Close(&log);
+        errno = EINVAL;
+        return -1;
+    }
+    self->records = calloc(log.records ? log.records : 1, sizeof(SensorLogRecord));
+    if (self->records == NULL) {
+        ColLog_Close(&log);
+        return -1;
+    }
+    self->count = log.records;
+    for (uint8_t i = 0; i < sensorLogSchema.count; i++) {
+        const ColLogChannel *ch = &sensorLogSchema.channels[i];
+        int id = ColLog_Find(&log, ch->name);
+        if (id >= 0 && log.schema.channels[id].type == ch->type) {
+            ColLog_ReadColumn(&log, (uint8_t)id, (uint8_t *)self->records + ch->offset, sizeof(SensorLogRecord));
+        } else {
+            self->shortRecords = self->count;
+        }
+    }
+    ColLog_Close(&log);
+    return 0;
+}
+
+int ReplayLog_Load(ReplayLog *self, const char *path) {
+    memset(self, 0, sizeof(*self));
+    FILE *in = fopen(path, "rb");
+    if (in == NULL) {
+        return -1;
+    }
+    char magic[4];
+    if (fread(magic, 1, 4, in) == 4 && memcmp(magic, COLLOG_MAGIC, 4) == 0) {
+        fclose(in);
+        return loadColumnar(self, path);
+    }
+    rewind(in);
+    size_t capacity = 0;
+    int lastSeq = -1;
+    FrameParser parser;
+    FrameParser_Init(&parser);
+    uint8_t buf[4096];
+    size_t n;
+    Frame frame;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (!FrameParser_Feed(&parser, buf[i], &frame) || frame.type != MSG_SENSOR_LOG) {
+                continue;
+            }
+            if (lastSeq >= 0 && (uint8_t)(frame.seq - lastSeq - 1) != 0) {
+                self->lost += (uint8_t)(frame.seq - lastSeq - 1);
+                self->gaps++;
+            }
+            lastSeq = frame.seq;
+            if (self->count == capacity) {
+                capacity = capacity ? 2 * capacity : 4096;
+                SensorLogRecord *grown = realloc(self->records, capacity * sizeof(SensorLogRecord));
+                if (grown == NULL) {
+                    fclose(in);
+                    ReplayLog_Free(self);
+                    errno = ENOMEM;
+                    return -1;
+                }
+                self->records = grown;
+            }
+            // 旧固件的记录可能更短，缺失字段补零 | Records from older firmware may be shorter; missing fields are zero
+            SensorLogRecord *r = &self->records[self->count++];
+            memset(r, 0, sizeof(*r));
+            if (frame.len < sizeof(*r)) self->shortRecords++;
+            memcpy(r, frame.payload, frame.len < sizeof(*r) ? frame.len : sizeof(*r));
+        }
+    }
+    fclose(in);
+    self->crcErrors = parser.crcErrors;
+    return 0;
+}
+
+int ReplayLog_Write(FILE *out, const SensorLogRecord *records, size_t count, uint8_t seq) {
+    uint8_t buf[PROTOCOL_MAX_FRAME];
+    for (size_t i = 0; i < count; i++) {
+        uint16_t n = Frame_Encode(MSG_SENSOR_LOG, seq++, (const uint8_t *)&records[i], sizeof(records[i]), buf);
+        if (fwrite(buf, 1, n, out) != n) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void ReplayLog_Free(ReplayLog *self) {
+    free(self->records);
+    self->records = NULL;
+    self->count = 0;
+}
+
+int Replay_Begin(void) {
+    memset(&emu, 0, sizeof(emu));
+    mpuEmu = &emu;
+    Mpu6500Emu_PowerOn(&emu, BUS_HZ);
+    emu.external = 1;
+
+    tim1 = tim2 = tim3 = tim4 = tim9 = (TIM_TypeDef){0};
+    htim1.Instance = &tim1;
+    htim2.Instance = &tim2;
+    htim3.Instance = &tim3;
+    htim4.Instance = &tim4;
+    htim9.Instance = &tim9;
+    tim9.ARR = 10000 - 1;
+
+    // 与固件 main() 相同的顺序 | Same order as the firmware main()
+    memset(flash, 0xFF, sizeof(flash));
+    ParamStore_Init(&paramStore, newRamFlashDev(flash, 16384));
+    car = newCar();
+    Param_Load();
+
+    // 分步初始化每个控制周期推进一步 | The staged init advances one step per control period
+    for (int i = 0; i < INIT_TICKS && car.imu.init_result == MPU6500_INIT_BUSY; i++) {
+        Mpu6500Emu_Advance(&emu, 10000000ULL);
+        car.imu.Get_Data(&car.imu);
+    }
+    return car.imu.init_result;
+}
+
+int Replay_Set(const char *name, fp32 value) {
+    int id = Param_Find(name);
+    if (id < 0) {
+        return PARAM_ERR_ID;
+    }
+    ParamValue v;
+    if (Param_Def((uint8_t)id)->type == PARAM_TYPE_F32) {
+        v.f = value;
+    } else {
+        v.i = (int32_t)lrintf(value);
+    }
+    int ret = Param_Stage((uint8_t)id, v);
+    Param_ApplyPending();
+    return ret;
+}
+
+static uint8_t *putBig(uint8_t *p, int32_t value, uint8_t bytes) {
+    for (uint8_t i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)((uint32_t)value >> (8 * (bytes - 1 - i)));
+    }
+    return p + bytes;
+}
+
+void Replay_Step(const SensorLogRecord *rec, ReplayOutput *out) {
+    current = rec;
+
+    // 主循环：先执行命令 | Main loop: commands first
+    for (uint8_t i = 0; i < rec->ncmd && i < SENSOR_LOG_CMDS; i++) {
+        car.cmd = rec->cmd[i];
+        Motion_Dispatch(&car.control.motion, rec->cmd[i]);
+    }
+
+    // 虚拟时钟跟上记录的节拍 | The virtual clock catches up with the recorded tick
+    uint64_t due = (uint64_t)rec->tick_ms * 1000000ULL;
+    if (emu.now < due) {
+        Mpu6500Emu_Advance(&emu, due - emu.now);
+    }
+
+    // DMP 数据包：四元数、加速度、角速度（大端），其余为空手势字 | DMP packet: quaternion, acceleration, rate (big-endian), then an empty gesture word
+    if (rec->flags & SENSOR_LOG_IMU) {
+        uint8_t packet[MPU6500_EMU_PACKET_MAX] = {0};
+        uint8_t *p = packet;
+        for (int i = 0; i < 4; i++) p = putBig(p, rec->quat[i], 4);
+        for (int i = 0; i < 3; i++) p = putBig(p, rec->accel[i], 2);
+        for (int i = 0; i < 3; i++) p = putBig(p, rec->gyro[i], 2);
+        Mpu6500Emu_Inject(&emu, packet, Mpu6500Emu_PacketLength(&emu));
+    }
+    car.imu.Get_Data(&car.imu);
+
+    tim2.CNT = rec->enc[0];
+    tim3.CNT = rec->enc[1];
+    tim9.ARR = (uint32_t)(rec->loop_us ? rec->loop_us : 10000) - 1U;
+    car.CarMove(&car, 0);
+
+    Pose pose;
+    Odometry_GetPose(&car.control.odometry, &pose);
+    out->tick_ms = rec->tick_ms;
+    out->pwm_l1  = tim1.CCR[0];
+    out->pwm_l2  = tim1.CCR[1];
+    out->pwm_r1  = tim1.CCR[2];
+    out->pwm_r2  = tim1.CCR[3];
+    out->out_l   = car.motor_l.pid.out;
+    out->out_r   = car.motor_r.pid.out;
+    out->set_l   = car.motor_l.setRPM;
+    out->set_r   = car.motor_r.setRPM;
+    out->pitch   = car.control.pitch;
+    out->speed   = car.control.speed;
+    out->wheel_l = car.control.balance.left;
+    out->wheel_r = car.control.balance.right;
+    out->pose_x  = pose.x;
+    out->pose_y  = pose.y;
+    out->heading = pose.heading;
+    out->brake   = car.isBrake;
+    out->motion  = car.motionState;
+}
@@ -0,0 +1,228 @@
+/**
+  * @file    replay_main.c
+  * @brief   传感器日志重放工具 | Sensor log replay tool
+  *
+  * @note    用法 | Usage:
+  *          dnb_replay <capture|log.dnbc> [-o out.bin] [-P name=value]...
+  *          dnb_replay --diff <a.bin> <b.bin> [-t tolerance]
+  *          第一种形式把抓包或列式日志中的传感器日志送回固件的 CarMove，打印记录数、间隙与相对实时的加速比
+  *          The first form feeds the sensor log of a capture or columnar log back into the
+  *          firmware's CarMove and prints the record count, gaps and the speed-up over real time
+  *          -o  保存每个周期的控制器输出 | Save the controller outputs of every period
+  *          -P  重放前修改参数，可重复；与上位机写入的路径相同 | Change a parameter before replay, repeatable; same path as a host write
+  *          --diff  逐字段比较两份输出：最大 |Δ|、RMS 与首个不同的节拍；有差异时退出码为 1
+  *                  Compare two outputs field by field: max |Δ|, RMS and the first differing tick;
+  *                  exits 1 when they differ
+  *          -t  --diff 的容差（默认 0，即要求逐位相同） | Tolerance for --diff (default 0, i.e. bit-identical)
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "replay.h"
+
+#define MAX_OVERRIDES   16
+
+/* 字段描述，由 REPLAY_FIELDS 生成 | Field descriptors generated from REPLAY_FIELDS */
+typedef struct {
+    const char *name;
+    const char *tag;
+    size_t offset;
+} Field;
+
+static const Field fields[] = {
+#define REPLAY_FIELD(type, name, tag) {#name, tag, offsetof(ReplayOutput, name)},
+    REPLAY_FIELDS(REPLAY_FIELD)
+#undef REPLAY_FIELD
+};
+
+#define FIELD_COUNT (sizeof(fields) / sizeof(fields[0]))
+
+static double fieldValue(const Field *f, const ReplayOutput *rec) {
+    const uint8_t *p = (const uint8_t *)rec + f->offset;
+    if (strcmp(f->tag, "f32") == 0) {
+        fp32 v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    if (strcmp(f->tag, "u32") == 0) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    return *p;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s <capture|log.dnbc> [-o out.bin] [-P name=value]...\n"
+                    "       %s --diff <a.bin> <b.bin> [-t tolerance]\n", prog, prog);
+    exit(2);
+}
+
+/**
+  * @brief   读入一份重放输出 | Load one replay output file
+  * @return  记录，失败返回 NULL | Records, NULL on failure
+  */
+static ReplayOutput *loadOutput(const char *path, size_t *count) {
+    FILE *in = fopen(path, "rb");
+    if (in == NULL) {
+        perror(path);
+        return NULL;
+    }
+    char magic[4];
+    uint16_t size = 0;
+    if (fread(magic, 1, 4, in) != 4 || memcmp(magic, REPLAY_OUTPUT_MAGIC, 4) != 0 ||
+        fread(&size, sizeof(size), 1, in) != 1 || size != sizeof(ReplayOutput)) {
+        fprintf(stderr, "%s: not a replay output of this build\n", path);
+        fclose(in);
+        return NULL;
+    }
+    size_t capacity = 1024;
+    ReplayOutput *recs = malloc(capacity * sizeof(*recs));
+    *count = 0;
+    while (recs != NULL && fread(&recs[*count], sizeof(*recs), 1, in) == 1) {
+        if (++*count == capacity) {
+            capacity *= 2;
+            ReplayOutput *grown = realloc(recs, capacity * sizeof(*recs));
+            if (grown == NULL) {
+                free(recs);
+            }
+            recs = grown;
+        }
+    }
+    fclose(in);
+    return recs;
+}
+
+static int diff(const char *pathA, const char *pathB, double tolerance) {
+    size_t na, nb;
+    ReplayOutput *a = loadOutput(pathA, &na);
+    ReplayOutput *b = loadOutput(pathB, &nb);
+    if (a == NULL || b == NULL) {
+        free(a);
+        free(b);
+        return 2;
+    }
+    size_t n = na < nb ? na : nb;
+    int differs = na != nb;
+    if (na != nb) {
+        printf("record count differs: %zu vs %zu, comparing the first %zu\n", na, nb, n);
+    }
+    printf("%-10s %14s %14s %12s\n", "field", "max |d|", "rms", "first tick");
+    for (size_t f = 0; f < FIELD_COUNT; f++) {
+        double maxAbs = 0.0, sumSq = 0.0;
+        long first = -1;
+        for (size_t i = 0; i < n; i++) {
+            double d = fieldValue(&fields[f], &b[i]) - fieldValue(&fields[f], &a[i]);
+            // NaN 在任一侧都算不同 | A NaN on either side counts as a difference
+            if (d != d) d = INFINITY;
+            maxAbs = fmax(maxAbs, fabs(d));
+            sumSq += d * d;
+            if (first < 0 && fabs(d) > tolerance) first = (long)a[i].tick_ms;
+        }
+        if (first >= 0) {
+            differs = 1;
+            printf("%-10s %14.6g %14.6g %12ld\n", fields[f].name, maxAbs, n ? sqrt(sumSq / n) : 0.0, first);
+        }
+    }
+    printf("%s\n", differs ? "DIFFERENT" : "IDENTICAL");
+    free(a);
+    free(b);
+    return differs ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    const char *capture = NULL, *outPath = NULL;
+    const char *overrides[MAX_OVERRIDES];
+    int overrideCount = 0;
+    const char *diffA = NULL, *diffB = NULL;
+    double tolerance = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--diff") == 0 && i + 2 < argc) {
+            diffA = argv[++i];
+            diffB = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc && overrideCount < MAX_OVERRIDES) {
+            overrides[overrideCount++] = argv[++i];
+        } else if (argv[i][0] != '-' && capture == NULL) {
+            capture = argv[i];
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (diffA != NULL) {
+        return diff(diffA, diffB, tolerance);
+    }
+    if (capture == NULL) {
+        usage(argv[0]);
+    }
+
+    ReplayLog log;
+    if (ReplayLog_Load(&log, capture) != 0) {
+        perror(capture);
+        return 1;
+    }
+    printf("%zu records, %lu gaps (%lu lost), %lu short, %lu crc errors\n",
+           log.count, log.gaps, log.lost, log.shortRecords, log.crcErrors);
+    if (log.count == 0) {
+        ReplayLog_Free(&log);
+        return 1;
+    }
+
+    int ret = Replay_Begin();
+    if (ret != 0) {
+        fprintf(stderr, "IMU init failed (%d)\n", ret);
+        ReplayLog_Free(&log);
+        return 1;
+    }
+    for (int i = 0; i < overrideCount; i++) {
+        char name[32];
+        float value;
+        if (sscanf(overrides[i], "%31[^=]=%f", name, &value) != 2 || Replay_Set(name, value) != 0) {
+            fprintf(stderr, "bad parameter '%s'\n", overrides[i]);
+            ReplayLog_Free(&log);
+            return 1;
+        }
+        printf("  %s = %g\n", name, value);
+    }
+
+    FILE *out = NULL;
+    if (outPath != NULL) {
+        uint16_t size = sizeof(ReplayOutput);
+        out = fopen(outPath, "wb");
+        if (out == NULL || fwrite(REPLAY_OUTPUT_MAGIC, 1, 4, out) != 4 || fwrite(&size, sizeof(size), 1, out) != 1) {
+            perror(outPath);
+            ReplayLog_Free(&log);
+            return 1;
+        }
+    }
+
+    double start = now();
+    for (size_t i = 0; i < log.count; i++) {
+        ReplayOutput rec;
+        Replay_Step(&log.records[i], &rec);
+        if (out != NULL) {
+            fwrite(&rec, sizeof(rec), 1, out);
+        }
+    }
+    double wall = now() - start;
+    double span = (log.records[log.count - 1].tick_ms - log.records[0].tick_ms) * 1e-3;
+    printf("replayed %.1f s of log in %.3f s (%.0fx real time)\n", span, wall, wall > 0.0 ? span / wall : 0.0);
+
+    if (out != NULL) {
+        fclose(out);
+    }
+    ReplayLog_Free(&log);
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+  * @file    replay_test.c
+  * @brief   传感器日志重放的自检 | Self-check of the sensor log replay
+  *
+  * @note    用法 | Usage: dnb_replay_test
+  *          生成一份合成日志（横滚四元数、编码器计数、运动命令），编码成 MSG_SENSOR_LOG 帧再读回，检查：
+  *          1. 帧序号间隙与短记录被统计；
+  *          2. Get_Data 经模拟器解出的横滚角等于日志中的角度；
+  *          3. 两次从上电开始的重放逐位相同；
+  *          4. 修改 motor_kp 后输出不同；
+  *          5. 平衡级联的增益已注册为持久参数，写入后到达控制器，已有参数的编号不变；
+  *             IMU 零偏参数按 imu.c 读取的键保存。
+  *          Builds a synthetic log (roll quaternions, encoder counts, motion commands), encodes it
+  *          as MSG_SENSOR_LOG frames and loads it back, then checks:
+  *          1. frame sequence gaps and short records are counted;
+  *          2. the roll Get_Data decodes through the emulator equals the logged angle;
+  *          3. two replays from power-up are bit-identical;
+  *          4. changing motor_kp changes the outputs;
+  *          5. the balance cascade gains are registered as persistent parameters and a write
+  *             reaches the controller, while the existing ids stay put; the IMU bias
+  *             parameters are saved under the keys imu.c reads.
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+#include "param.h"
+#include "param_store.h"
+#include "car.h"
+#include "command.h"
+#include "protocol.h"
+#include "check.h"
+
+#define RECORDS     600
+#define GAP_AT      300     /**< 在此处留出帧序号间隙 | Leave a frame sequence gap here */
+#define GAP_LOST    5
+#define START_MS    5000    /**< 第一条记录的节拍，晚于 IMU 初始化 | Tick of the first record, after the IMU init */
+
+extern Car car;
+
+static fp32 rollAt(int i) {
+    return 3.0f * sinf(0.02f * (fp32)i);
+}
+
+static void makeLog(SensorLogRecord *recs) {
+    memset(recs, 0, RECORDS * sizeof(*recs));
+    for (int i = 0; i < RECORDS; i++) {
+        SensorLogRecord *r = &recs[i];
+        double half = rollAt(i) / 57.3 / 2.0;
+        r->tick_ms = START_MS + 10 * (uint32_t)i;
+        r->loop_us = 10000;
+        r->enc[0] = (uint16_t)(int16_t)(i / 20);
+        r->enc[1] = (uint16_t)(int16_t)(-i / 20);
+        r->quat[0] = (int32_t)lrint(cos(half) * 1073741824.0);
+        r->quat[1] = (int32_t)lrint(sin(half) * 1073741824.0);
+        r->accel[2] = 16384;
+        r->gyro[0] = (int16_t)(i % 7 - 3);
+        r->range = 80.0f;
+        r->range_age_ms = 20;
+        r->flags = SENSOR_LOG_IMU | SENSOR_LOG_RANGE_VALID;
+    }
+    recs[100].ncmd = 1;
+    recs[100].cmd[0] = CMD_FORWARD;
+    recs[400].ncmd = 2;
+    recs[400].cmd[0] = CMD_LEFT;
+    recs[400].cmd[1] = CMD_STOP_SLOWLY;
+}
+
+/**
+  * @brief   从上电开始重放整份日志 | Replay the whole log from power-up
+  * @return  最大横滚角误差 (°) | Largest roll error
+  */
+static fp32 replay(const ReplayLog *log, ReplayOutput *out, fp32 kpScale) {
+    CHECK(Replay_Begin() == 0, "IMU init failed");
+    if (kpScale != 1.0f) {
+        CHECK(Replay_Set("motor_kp", car.motor_l.pid.Kp * kpScale) == 0, "motor_kp rejected");
+    }
+    fp32 maxErr = 0.0f;
+    for (size_t i = 0; i < log->count; i++) {
+        Replay_Step(&log->records[i], &out[i]);
+        if (i < RECORDS && (log->records[i].flags & SENSOR_LOG_IMU)) {
+            maxErr = fmaxf(maxErr, fabsf(car.imu.roll - rollAt((int)i)));
+        }
+    }
+    return maxErr;
+}
+
+int main(void) {
+    static SensorLogRecord recs[RECORDS];
+    makeLog(recs);
+
+    printf("log round trip\n");
+    char path[] = "/tmp/dnb_replay_XXXXXX";
+    FILE *f = fdopen(mkstemp(path), "wb");
+    CHECK(f != NULL, "cannot create %s", path);
+    if (f == NULL) return 1;
+    ReplayLog_Write(f, recs, GAP_AT, 0);
+    ReplayLog_Write(f, recs + GAP_AT, RECORDS - GAP_AT, (uint8_t)(GAP_AT + GAP_LOST));
+    // 旧固件的短记录：只有前 20 字节 | A short record from older firmware: only the first 20 bytes
+    uint8_t buf[PROTOCOL_MAX_FRAME];
+    SensorLogRecord last = recs[RECORDS - 1];
+    last.tick_ms += 10;
+    fwrite(buf, 1, Frame_Encode(MSG_SENSOR_LOG, (uint8_t)(RECORDS + GAP_LOST), (const uint8_t *)&last, 20, buf), f);
+    fclose(f);
+
+    ReplayLog log;
+    CHECK(ReplayLog_Load(&log, path) == 0, "cannot load %s", path);
+    remove(path);
+    printf("  %zu records, %lu gaps (%lu lost), %lu short\n", log.count, log.gaps, log.lost, log.shortRecords);
+    CHECK(log.count == RECORDS + 1, "%zu records", log.count);
+    CHECK(log.gaps == 1 && log.lost == GAP_LOST, "%lu gaps, %lu lost", log.gaps, log.lost);
+    CHECK(log.shortRecords == 1 && log.records[RECORDS].flags == 0, "short record not zero-filled");
+    CHECK(log.count > 0 && memcmp(log.records, recs, sizeof(recs)) == 0, "records changed in the round trip");
+
+    ReplayOutput *a = calloc(log.count, sizeof(ReplayOutput));
+    ReplayOutput *b = calloc(log.count, sizeof(ReplayOutput));
+    ReplayOutput *c = calloc(log.count, sizeof(ReplayOutput));
+
+    printf("decode\n");
+    fp32 err = replay(&log, a, 1.0f);
+    printf("  roll error %.4f deg\n", err);
+    CHECK(err < 0.01f, "roll error %.4f deg", err);
+    uint32_t active = 0;
+    for (size_t i = 0; i < log.count; i++) {
+        active += a[i].pwm_l1 != 0 || a[i].pwm_l2 != 0;
+    }
+    CHECK(active > 0, "the motors never ran");
+
+    printf("determinism\n");
+    replay(&log, b, 1.0f);
+    int same = memcmp(a, b, log.count * sizeof(ReplayOutput)) == 0;
+    printf("  second replay %s\n", same ? "bit-identical" : "differs");
+    CHECK(same, "two replays from power-up differ");
+
+    printf("parameter change\n");
+    replay(&log, c, 2.0f);
+    size_t first = log.count;
+    for (size_t i = 0; i < log.count && first == log.count; i++) {
+        if (memcmp(&a[i], &c[i], sizeof(ReplayOutput)) != 0) first = i;
+    }
+    printf("  motor_kp x2 first differs at record %zu\n", first);
+    CHECK(first < log.count, "motor_kp change not visible in the outputs");
+
+    printf("balance gains\n");
+    const struct {
+        const char *name;
+        const fp32 *field;
+    } gains[] = {
+            {"angle_kp", &car.control.balance.angleKp},
+            {"angle_kd", &car.control.balance.angleKd},
+            {"vel_kp",   &car.control.balance.velocity.Kp},
+            {"vel_ki",   &car.control.balance.velocity.Ki},
+            {"turn_kp",  &car.control.balance.turn.Kp},
+            {"turn_ki",  &car.control.balance.turn.Ki},
+            {"turn_kd",  &car.control.balance.turn.Kd},
+    };
+    for (size_t i = 0; i < sizeof(gains) / sizeof(gains[0]); i++) {
+        int id = Param_Find(gains[i].name);
+        CHECK(id >= 0 && (Param_Def((uint8_t)id)->flags & PARAM_FLAG_PERSIST), "%s not registered as persistent", gains[i].name);
+        CHECK(Replay_Set(gains[i].name, 0.03f) == PARAM_OK && *gains[i].field == 0.03f, "%s write did not reach the controller",
+              gains[i].name);
+    }
+    // 编号是上位机协议的一部分 | Ids are part of the host protocol
+    CHECK(Param_Find("start_speed") == 7 && Param_Find("sensor_log") == 10, "existing parameter ids moved");
+    printf("  %zu gains at ids %d..%d\n", sizeof(gains) / sizeof(gains[0]), Param_Find("angle_kp"), Param_Find("turn_kd"));
+
+    // imu.c 初始化完成时按这些键读零偏 | imu.c reads the biases under these keys when its init completes
+    static const char *const biases[] = {"gyro_bias_x", "gyro_bias_y", "gyro_bias_z", "accel_bias_x", "accel_bias_y", "accel_bias_z"};
+    for (uint16_t i = 0; i < 6; i++) {
+        int id = Param_Find(biases[i]);
+        uint16_t key = (uint16_t)(i < 3 ? PARAM_KEY_GYRO_BIAS + i : PARAM_KEY_ACCEL_BIAS + i - 3);
+        CHECK(id >= 0 && (Param_Def((uint8_t)id)->flags & PARAM_FLAG_PERSIST) && Param_Def((uint8_t)id)->storeKey == key,
+              "%s not persisted under the key imu.c reads", biases[i]);
+    }
+
+    free(a);
+    free(b);
+    free(c);
+    ReplayLog_Free(&log);
+    return Check_Exit();
+}
@@ -0,0 +1,181 @@
+/**
+  * @file    ring_bench.c
+  * @brief   SPSC 环形队列多线程压力测试与吞吐量基准 | SPSC ring multithreaded stress test and throughput benchmark
+  *
+  * @note    用法 | Usage: dnb_ring_bench [million_items]
+  *          生产者与消费者各占一个线程，混合使用单个/批量/零拷贝接口，消费者逐项校验序号；
+  *          任何乱序、重复或丢失都会使程序以非零状态退出
+  *          Producer and consumer run on separate threads mixing single, batch and zero-copy
+  *          calls; the consumer checks every sequence number, and any reordering, duplicate or
+  *          loss makes the program exit non-zero
+  */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "spsc_ring.h"
+#include "telemetry.h"
+
+typedef enum {
+    MODE_SINGLE = 0,    /**< Push / Pop */
+    MODE_BATCH,         /**< Write / Read */
+    MODE_ZERO_COPY,     /**< Reserve+Commit / Peek+Release */
+    MODE_MIXED          /**< 每次随机选择 | Random choice per call */
+} Mode;
+
+static const char *modeName[] = {"single", "batch", "zero-copy", "mixed"};
+
+typedef struct {
+    SpscRing ring;
+    uint32_t elemSize;
+    uint64_t items;
+    Mode mode;
+    uint64_t errors;
+} Bench;
+
+#define BATCH_MAX 64
+
+/* 元素：首字为序号，其余字节由序号派生，用于检测撕裂读 | Element: seq first, remaining bytes derived from it to catch torn reads */
+static void fill(uint8_t *elem, uint32_t size, uint32_t seq) {
+    memcpy(elem, &seq, size < 4 ? size : 4);  // 1 字节元素只保留序号低位 | 1-byte elements keep the low bits only
+    for (uint32_t i = 4; i < size; i++) {
+        elem[i] = (uint8_t)(seq * 31u + i);
+    }
+}
+
+static int check(const uint8_t *elem, uint32_t size, uint32_t seq) {
+    uint32_t got = 0;
+    uint32_t n = size < 4 ? size : 4;
+    memcpy(&got, elem, n);
+    if (n < 4) seq &= (1u << (8 * n)) - 1;
+    if (got != seq) return 0;
+    for (uint32_t i = 4; i < size; i++) {
+        if (elem[i] != (uint8_t)(seq * 31u + i)) return 0;
+    }
+    return 1;
+}
+
+static uint32_t xorshift(uint32_t *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+static void *producer(void *arg) {
+    Bench *b = (Bench *)arg;
+    uint8_t batch[BATCH_MAX * sizeof(TelemetryRecord)];
+    uint32_t rng = 0x12345678u;
+    uint64_t seq = 0;
+
+    while (seq < b->items) {
+        Mode m = (b->mode == MODE_MIXED) ? (Mode)(xorshift(&rng) % 3) : b->mode;
+        uint32_t want = (m == MODE_SINGLE) ? 1 : 1 + xorshift(&rng) % BATCH_MAX;
+        uint32_t n;
+        if (want > b->items - seq) want = (uint32_t)(b->items - seq);
+
+        if (m == MODE_SINGLE) {
+            fill(batch, b->elemSize, (uint32_t)seq);
+            n = SpscRing_Push(&b->ring, batch) ? 1 : 0;
+        } else if (m == MODE_BATCH) {
+            for (uint32_t i = 0; i < want; i++) {
+                fill(&batch[i * b->elemSize], b->elemSize, (uint32_t)(seq + i));
+            }
+            n = SpscRing_Write(&b->ring, batch, want);
+        } else {
+            uint8_t *dst = (uint8_t *)SpscRing_Reserve(&b->ring, &n);
+            if (n > want) n = want;
+            for (uint32_t i = 0; i < n; i++) {
+                fill(&dst[i * b->elemSize], b->elemSize, (uint32_t)(seq + i));
+            }
+            SpscRing_Commit(&b->ring, n);
+        }
+        seq += n;
+        if (n == 0) sched_yield();  // 单核主机上让出给消费者 | Let the consumer run on single-core hosts
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    Bench *b = (Bench *)arg;
+    uint8_t batch[BATCH_MAX * sizeof(TelemetryRecord)];
+    uint32_t rng = 0x9E3779B9u;
+    uint64_t seq = 0;
+
+    while (seq < b->items) {
+        Mode m = (b->mode == MODE_MIXED) ? (Mode)(xorshift(&rng) % 3) : b->mode;
+        uint32_t n;
+
+        if (m == MODE_SINGLE) {
+            n = SpscRing_Pop(&b->ring, batch) ? 1 : 0;
+        } else if (m == MODE_BATCH) {
+            n = SpscRing_Read(&b->ring, batch, 1 + xorshift(&rng) % BATCH_MAX);
+        } else {
+            const uint8_t *src = (const uint8_t *)SpscRing_Peek(&b->ring, &n);
+            for (uint32_t i = 0; i < n; i++) {
+                if (!check(&src[i * b->elemSize], b->elemSize, (uint32_t)(seq + i))) b->errors++;
+            }
+            SpscRing_Release(&b->ring, n);
+        }
+        if (m != MODE_ZERO_COPY) {
+            for (uint32_t i = 0; i < n; i++) {
+                if (!check(&batch[i * b->elemSize], b->elemSize, (uint32_t)(seq + i))) b->errors++;
+            }
+        }
+        seq += n;
+        if (n == 0) sched_yield();  // 单核主机上让出给生产者 | Let the producer run on single-core hosts
+    }
+    return NULL;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+  * @brief   运行一组配置 | Run one configuration
+  * @return  错误数 | Error count
+  */
+static uint64_t run(uint32_t elemSize, uint32_t capacity, Mode mode, uint64_t items) {
+    Bench b = {.elemSize = elemSize, .items = items, .mode = mode};
+    void *storage = malloc((size_t)elemSize * capacity);
+    SpscRing_Init(&b.ring, storage, elemSize, capacity);
+
+    pthread_t p, c;
+    double t0 = now();
+    pthread_create(&c, NULL, consumer, &b);
+    pthread_create(&p, NULL, producer, &b);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+    double dt = now() - t0;
+
+    printf("%-10s elem %3u  cap %5u  %8.2f Mitems/s  %8.1f MB/s  errors %llu\n",
+           modeName[mode], elemSize, capacity, items / dt * 1e-6, items * elemSize / dt * 1e-6,
+           (unsigned long long)b.errors);
+    free(storage);
+    return b.errors;
+}
+
+int main(int argc, char **argv) {
+    uint64_t items = (uint64_t)((argc > 1) ? atof(argv[1]) : 20.0) * 1000000u;
+    uint64_t errors = 0;
+
+    // 压力：极小容量使两端频繁在满/空边界竞争 | Stress: tiny capacities keep both ends racing at the full/empty edge
+    printf("stress\n");
+    errors += run(4, 2, MODE_MIXED, items / 4);
+    errors += run(sizeof(TelemetryRecord), 4, MODE_MIXED, items / 4);
+    errors += run(sizeof(TelemetryRecord), 64, MODE_MIXED, items / 4);
+
+    // 吞吐量：命令字节与遥测记录 | Throughput: command bytes and telemetry records
+    printf("throughput\n");
+    for (int m = MODE_SINGLE; m <= MODE_ZERO_COPY; m++) {
+        errors += run(1, 1024, (Mode)m, items);
+        errors += run(sizeof(TelemetryRecord), 1024, (Mode)m, items / 4);
+    }
+
+    printf("%s\n", errors ? "FAILED" : "OK");
+    return errors ? 1 : 0;
+}
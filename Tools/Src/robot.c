@@ -0,0 +1,64 @@
+/**
+  * @file    robot.c
+  * @brief   仿真小车 | Simulated car
+  */
+#include <math.h>
+#include "robot.h"
+
+void Robot_Init(Robot *self, const PlantParams *p, double theta, uint32_t seed) {
+    Plant_Init(&self->plant, p, theta, seed);
+    // 模型没有机械偏置 | The plant has no mechanical bias
+    self->control = newControl(8, 0.0f);
+    self->control.lastYaw = Plant_ReadYaw(&self->plant);
+    const fp32 k[3] = {ROBOT_MOTOR_KP, ROBOT_MOTOR_KI, ROBOT_MOTOR_KD};
+    PID_init(&self->motor[0], PID_POSITION, k, ROBOT_MOTOR_ARR, ROBOT_MOTOR_MAX_IOUT);
+    PID_init(&self->motor[1], PID_POSITION, k, ROBOT_MOTOR_ARR, ROBOT_MOTOR_MAX_IOUT);
+    self->cmPerCount = 2.0 * 3.14159265358979 * p->wheelRadius * 100.0 / p->encoderCpr;
+    self->counts[0] = self->counts[1] = 0;
+    self->duty[0] = self->duty[1] = 0.0;
+    self->dutySaturated = FALSE;
+}
+
+void Robot_Sense(Robot *self, ControlInput *in) {
+    float pitch, pitchRate, yawRate;
+    Plant_ReadImu(&self->plant, &pitch, &pitchRate, &yawRate);
+    Plant_ReadEncoders(&self->plant, &self->counts[0], &self->counts[1]);
+    *in = (ControlInput){
+            .dLeft      = (fp32)(self->counts[0] * self->cmPerCount),
+            .dRight     = (fp32)(self->counts[1] * self->cmPerCount),
+            .pitch      = pitch,
+            .pitchRate  = pitchRate,
+            .yawRate    = yawRate,
+            .yaw        = Plant_ReadYaw(&self->plant),
+            .imuReady   = TRUE,
+            .rangeValid = FALSE
+    };
+}
+
+void Robot_Actuate(Robot *self) {
+    const Balance *b = &self->control.balance;
+    fp32 set[2] = {(fp32)(b->left * ROBOT_TICK / self->cmPerCount), (fp32)(b->right * ROBOT_TICK / self->cmPerCount)};
+    HBridge cmd[2];
+    self->dutySaturated = FALSE;
+    for (int i = 0; i < 2; i++) {
+        // 与 Move() 相同：刹车两路拉满（短路制动），正输出接 IN1，负输出接 IN2，零为滑行 | As Move(): brake drives both inputs full (short brake), positive output goes to IN1, negative to IN2, zero coasts
+        if (self->control.brake) {
+            PID_clear(&self->motor[i]);
+            cmd[i] = (HBridge){1.0, 1.0};
+        } else {
+            PID_calc(&self->motor[i], self->counts[i], set[i]);
+            fp32 out = self->motor[i].out;
+            cmd[i] = out > 0.0f ? (HBridge){out / ROBOT_MOTOR_ARR, 0.0} : (HBridge){0.0, -out / ROBOT_MOTOR_ARR};
+        }
+        self->duty[i] = cmd[i].in1 - cmd[i].in2;
+        self->dutySaturated |= fabs(self->duty[i]) >= 0.999;
+    }
+    Plant_Drive(&self->plant, cmd, ROBOT_TICK);
+}
+
+void Robot_Step(Robot *self) {
+    ControlInput in;
+    Robot_Sense(self, &in);
+    Control_Step(&self->control, &in, (fp32)ROBOT_TICK);
+    Robot_Actuate(self);
+}
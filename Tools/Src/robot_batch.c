@@ -0,0 +1,149 @@
+/**
+  * @file    robot_batch.c
+  * @brief   批量小车 | Batched cars
+  *
+  * @note    电机内环照抄 pid.c 位置式 PID_calc 与 robot.c Robot_Actuate 的运算次序；
+  *          修改其中一边时必须同时修改另一边，dnb_batch_bench 会检查两边逐位相同。
+  *          The motor loops copy the arithmetic order of pid.c's position-mode PID_calc and
+  *          robot.c's Robot_Actuate; change one side and the other must follow.
+  *          dnb_batch_bench checks that the two stay bit-identical.
+  */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "robot_batch.h"
+
+#define ALIGN   64
+
+int RobotBatch_Init(RobotBatch *self, uint32_t n) {
+    memset(self, 0, sizeof(*self));
+    if (PlantBatch_Init(&self->plant, n) != 0) {
+        return -1;
+    }
+    // 每个数组占 stride 个 8 字节槽，起点按 64 字节对齐 | Each array takes stride 8-byte slots and starts 64-byte aligned
+    size_t row = (size_t)self->plant.stride * sizeof(double);
+    size_t bytes = row * 23;
+    char *c = aligned_alloc(ALIGN, bytes ? bytes : ALIGN);
+    self->control = malloc((n ? n : 1) * sizeof(Control));
+    if (!c || !self->control) {
+        free(c);
+        free(self->control);
+        PlantBatch_Free(&self->plant);
+        return -1;
+    }
+    memset(c, 0, bytes);
+    self->n = n;
+    self->mem = c;
+    for (int k = 0; k < 2; k++) {
+        self->kp[k] = (fp32 *)c; c += row;
+        self->ki[k] = (fp32 *)c; c += row;
+        self->kd[k] = (fp32 *)c; c += row;
+        self->error[k] = (fp32 *)c; c += row;
+        self->iout[k] = (fp32 *)c; c += row;
+        self->out[k] = (fp32 *)c; c += row;
+        self->counts[k] = (int16_t *)c; c += row;
+        self->set[k] = (fp32 *)c; c += row;
+    }
+    self->cmPerCount = (double *)c; c += row;
+    self->pitch = (float *)c; c += row;
+    self->pitchRate = (float *)c; c += row;
+    self->yawRate = (float *)c; c += row;
+    self->yaw = (float *)c; c += row;
+    self->dutySaturated = (bool_t *)c; c += row;
+    self->brake = (bool_t *)c;
+    self->maxOut = ROBOT_MOTOR_ARR;
+    self->maxIout = ROBOT_MOTOR_MAX_IOUT;
+    return 0;
+}
+
+void RobotBatch_Free(RobotBatch *self) {
+    PlantBatch_Free(&self->plant);
+    free(self->mem);
+    free(self->control);
+    memset(self, 0, sizeof(*self));
+}
+
+void RobotBatch_Set(RobotBatch *self, uint32_t i, const Robot *robot) {
+    PlantBatch_Set(&self->plant, i, &robot->plant);
+    self->control[i] = robot->control;
+    for (int k = 0; k < 2; k++) {
+        const pid_type_def *m = &robot->motor[k];
+        self->kp[k][i] = m->Kp;
+        self->ki[k][i] = m->Ki;
+        self->kd[k][i] = m->Kd;
+        self->error[k][i] = m->error[0];
+        self->iout[k][i] = m->Iout;
+        self->out[k][i] = m->out;
+        self->counts[k][i] = robot->counts[k];
+    }
+    self->cmPerCount[i] = robot->cmPerCount;
+    self->dutySaturated[i] = robot->dutySaturated;
+}
+
+/**
+  * @brief   一侧电机内环，全部车 | Motor loop of one side, every car
+  */
+static void motorLoops(RobotBatch *self, int k) {
+    const uint32_t n = self->n;
+    const fp32 maxOut = self->maxOut, maxIout = self->maxIout;
+    const fp32 *restrict kp = self->kp[k], *restrict ki = self->ki[k], *restrict kd = self->kd[k];
+    const int16_t *restrict counts = self->counts[k];
+    const fp32 *restrict set = self->set[k];
+    const bool_t *restrict brake = self->brake;
+    fp32 *restrict error = self->error[k], *restrict iout = self->iout[k], *restrict out = self->out[k];
+    double *restrict duty = self->plant.duty[k];
+    bool_t *restrict saturated = self->dutySaturated;
+    const bool_t keep = k ? 1 : 0;
+
+#pragma GCC ivdep
+    for (uint32_t i = 0; i < n; i++) {
+        fp32 e0 = set[i] - (fp32)counts[i];
+        fp32 pout = kp[i] * e0;
+        fp32 io = iout[i] + ki[i] * e0;
+        fp32 dout = kd[i] * (e0 - error[i]);
+        io = io > maxIout ? maxIout : (io < -maxIout ? -maxIout : io);
+        fp32 o = pout + io + dout;
+        o = o > maxOut ? maxOut : (o < -maxOut ? -maxOut : o);
+        // 刹车时等同 PID_clear，两路拉满，占空比 in1 − in2 = 0 | A brake acts as PID_clear with both inputs full, duty in1 − in2 = 0
+        error[i] = brake[i] ? 0.0f : e0;
+        iout[i] = brake[i] ? 0.0f : io;
+        out[i] = brake[i] ? 0.0f : o;
+        double u = o / ROBOT_MOTOR_ARR;
+        // in1 − in2 与 Robot_Actuate 相同，+ 0.0 把 −0 变成 +0 | in1 − in2 as in Robot_Actuate; + 0.0 turns −0 into +0
+        duty[i] = brake[i] ? 0.0 : u + 0.0;
+        // 右轮并入左轮的饱和标志 | The right side ORs into the left side's flag
+        bool_t sat = (bool_t)((brake[i] == 0) & (fabs(u) >= 0.999));
+        saturated[i] = (bool_t)((saturated[i] & keep) | sat);
+    }
+}
+
+void RobotBatch_Step(RobotBatch *self) {
+    PlantBatch *p = &self->plant;
+    PlantBatch_ReadImu(p, self->pitch, self->pitchRate, self->yawRate);
+    PlantBatch_ReadEncoders(p, self->counts[0], self->counts[1]);
+    PlantBatch_ReadYaw(p, self->yaw);
+
+    // 固件控制栈逐台运行 | The firmware control stack runs car by car
+    for (uint32_t i = 0; i < self->n; i++) {
+        ControlInput in = {
+                .dLeft      = (fp32)(self->counts[0][i] * self->cmPerCount[i]),
+                .dRight     = (fp32)(self->counts[1][i] * self->cmPerCount[i]),
+                .pitch      = self->pitch[i],
+                .pitchRate  = self->pitchRate[i],
+                .yawRate    = self->yawRate[i],
+                .yaw        = self->yaw[i],
+                .imuReady   = TRUE,
+                .rangeValid = FALSE
+        };
+        Control_Step(&self->control[i], &in, (fp32)ROBOT_TICK);
+        const Balance *b = &self->control[i].balance;
+        self->set[0][i] = (fp32)(b->left * ROBOT_TICK / self->cmPerCount[i]);
+        self->set[1][i] = (fp32)(b->right * ROBOT_TICK / self->cmPerCount[i]);
+        self->brake[i] = self->control[i].brake;
+    }
+
+    // 电机内环批量计算 | The motor loops run as a batch
+    motorLoops(self, 0);
+    motorLoops(self, 1);
+    PlantBatch_Step(p, ROBOT_TICK);
+}
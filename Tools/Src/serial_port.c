@@ -0,0 +1,71 @@
+#include "serial_port.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+static speed_t baudToSpeed(uint32_t baud) {
+    switch (baud) {
+        case 9600:   return B9600;
+        case 57600:  return B57600;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default:     return B115200;
+    }
+}
+
+/**
+  * @brief   打开串口并设置为原始模式 | Open a serial device in raw mode
+  */
+int Serial_Open(const char *path, uint32_t baud) {
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {  // pty 与真实串口都支持 | Works for both pty and real ports
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, baudToSpeed(baud));
+        cfsetospeed(&tio, baudToSpeed(baud));
+        tio.c_cc[VMIN] = 0;
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+/**
+  * @brief   带超时读取 | Read with timeout
+  */
+int Serial_Read(int fd, uint8_t *buf, size_t len, int timeout_ms) {
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+    int ret = poll(&pfd, 1, timeout_ms);
+    if (ret <= 0) {
+        return ret;
+    }
+    return (int)read(fd, buf, len);
+}
+
+/**
+  * @brief   写入全部数据 | Write all data
+  */
+int Serial_Write(int fd, const uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+  * @brief   关闭串口 | Close serial port
+  */
+void Serial_Close(int fd) {
+    close(fd);
+}
@@ -0,0 +1,155 @@
+/**
+  * @file    sim_link.c
+  * @brief   仿真器的 USART2 | The simulator's USART2
+  */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "sim_link.h"
+#include "link_dispatch.h"
+
+double SimLink_Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int linkSend(void *ctx, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len) {
+    return SimLink_SendFrame((SimLink *)ctx, type, seq, payload, len);
+}
+
+/**
+  * @brief   处理一帧，与固件共用 Link_HandleFrame | Handle one frame with the firmware's Link_HandleFrame
+  */
+static void onFrame(UartRx *rx, const Frame *frame) {
+    SimLink *self = (SimLink *)((char *)rx - offsetof(SimLink, rx));
+    LinkDispatch dispatch = {.path = self->path, .cmds = &self->cmds, .send = linkSend, .ctx = self};
+    Link_HandleFrame(&dispatch, rx, frame);
+}
+
+int SimLink_Open(SimLink *self, PathFollower *path) {
+    memset(self, 0, sizeof(*self));
+    self->master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (self->master < 0) {
+        return -1;
+    }
+    if (grantpt(self->master) != 0 || unlockpt(self->master) != 0 ||
+        ptsname_r(self->master, self->slave, sizeof(self->slave)) != 0) {
+        close(self->master);
+        return -1;
+    }
+    struct termios tio;
+    if (tcgetattr(self->master, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(self->master, TCSANOW, &tio);
+    }
+    self->path = path;
+    self->byteTime = 10.0 / SIM_LINK_BAUD;
+    self->rx = newUartRx(self->dma, SIM_LINK_RX_SIZE, onFrame);
+    SpscRing_Init(&self->cmds, self->cmdBuf, 1, SIM_LINK_CMD_QUEUE);
+    return 0;
+}
+
+void SimLink_Close(SimLink *self) {
+    if (self->master >= 0) {
+        close(self->master);
+    }
+    self->master = -1;
+}
+
+bool_t SimLink_PollCommand(SimLink *self, uint8_t *cmd) {
+    return SpscRing_Pop(&self->cmds, cmd);
+}
+
+int SimLink_SendFrame(SimLink *self, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len) {
+    uint8_t buf[PROTOCOL_MAX_FRAME];
+    uint16_t n = Frame_Encode(type, seq, payload, len, buf);
+    if (n == 0 || self->txLen + n > SIM_LINK_TX_SIZE) {
+        self->txDropped++;      // 不拆帧，整块丢弃 | Never split a frame, drop it whole
+        return -1;
+    }
+    if (self->txLen == 0) {
+        // 线路空闲时从现在开始发 | An idle line starts sending now
+        double now = SimLink_Now();
+        if (self->txClock < now) self->txClock = now;
+    }
+    memcpy(&self->tx[self->txLen], buf, n);
+    self->txLen += n;
+    self->txFrames++;
+    return 0;
+}
+
+/**
+  * @brief   按字节时间推进两个方向 | Advance both directions at the byte time
+  */
+static void service(SimLink *self, double now) {
+    // pty → 线路：线路空闲时，新读到的字节从现在开始传 | Pty → line: on an idle line, newly read bytes start now
+    if (self->wireLen < SIM_LINK_RX_SIZE) {
+        ssize_t got = read(self->master, &self->wire[self->wireLen], SIM_LINK_RX_SIZE - self->wireLen);
+        if (got > 0) {
+            if (self->wireLen == 0 && self->rxClock < now) self->rxClock = now;
+            self->wireLen += (uint16_t)got;
+        }
+    }
+
+    // 线路 → 循环 DMA，到达的字节交给 UartRx，相当于 HT/TC/IDLE 事件 | Line → circular DMA; arrived bytes go to UartRx, standing in for the HT/TC/IDLE events
+    uint16_t arrived = 0;
+    while (arrived < self->wireLen && self->rxClock + self->byteTime <= now) {
+        self->rxClock += self->byteTime;
+        self->dma[self->head] = self->wire[arrived++];
+        self->head = (uint16_t)((self->head + 1) % SIM_LINK_RX_SIZE);
+        if (self->head == 0 || self->head == SIM_LINK_RX_SIZE / 2) {
+            UartRx_Process(&self->rx, self->head);
+        }
+    }
+    if (arrived) {
+        memmove(self->wire, &self->wire[arrived], self->wireLen - arrived);
+        self->wireLen -= arrived;
+        UartRx_Process(&self->rx, self->head);
+    }
+
+    // 发送队列 → 线路 → pty | TX queue → line → pty
+    uint16_t sent = 0;
+    while (sent < self->txLen && self->txClock + self->byteTime <= now) {
+        self->txClock += self->byteTime;
+        sent++;
+    }
+    if (sent) {
+        ssize_t put = write(self->master, self->tx, sent);
+        self->txUnread += (uint32_t)(put < 0 ? sent : sent - put);
+        memmove(self->tx, &self->tx[sent], self->txLen - sent);
+        self->txLen -= sent;
+    }
+}
+
+void SimLink_RunUntil(SimLink *self, double deadline) {
+    for (;;) {
+        double now = SimLink_Now();
+        service(self, now);
+        if (now >= deadline) {
+            return;
+        }
+        // 等到下一个字节时刻、pty 可读或截止时刻 | Wait for the next byte time, pty input or the deadline
+        double wake = deadline;
+        if (self->wireLen && self->rxClock + self->byteTime < wake) wake = self->rxClock + self->byteTime;
+        if (self->txLen && self->txClock + self->byteTime < wake) wake = self->txClock + self->byteTime;
+        double wait = wake - now;
+        if (wait < 0.0) wait = 0.0;
+        struct timespec ts = {.tv_sec = (time_t)wait, .tv_nsec = (long)((wait - (double)(time_t)wait) * 1e9)};
+        struct pollfd pfd = {.fd = self->master, .events = self->wireLen < SIM_LINK_RX_SIZE ? POLLIN : 0};
+        if (ppoll(&pfd, 1, &ts, NULL) < 0 && errno != EINTR) {
+            return;
+        }
+        if (pfd.revents & POLLHUP) {
+            // 没有工具连着从端时主端一直 HUP，只按时间等 | With no tool on the slave the master keeps reporting HUP; just wait on time
+            nanosleep(&ts, NULL);
+        }
+    }
+}
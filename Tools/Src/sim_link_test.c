@@ -0,0 +1,127 @@
+/**
+  * @file    sim_link_test.c
+  * @brief   仿真器 pty 链路的自检 | Self-check of the simulator's pty link
+  *
+  * @note    用法 | Usage: dnb_sim_link_test
+  *          像上位机工具一样打开从端，检查：
+  *          1. 运动命令入队并应答，应答延迟等于请求加应答在 115200 8N1 下的线路时间；
+  *          2. 重发的命令只应答不再入队；
+  *          3. 参数帧交给 Param_HandleFrame，MSG_LINK_STATS 返回接收统计；
+  *          4. 发送队列放不下的帧整帧丢弃并计数。
+  *          Opens the slave side as a host tool would and checks:
+  *          1. a motion command is queued and acked, with the ack latency equal to the line time
+  *             of request plus ack at 115200 8N1;
+  *          2. a retransmitted command is acked but not queued again;
+  *          3. parameter frames reach Param_HandleFrame and MSG_LINK_STATS returns the receive statistics;
+  *          4. frames that do not fit the transmit queue are dropped whole and counted.
+  */
+#include <stdio.h>
+#include <string.h>
+#include "sim_link.h"
+#include "serial_port.h"
+#include "param.h"
+#include "param_store.h"
+#include "command.h"
+#include "check.h"
+
+static fp32 gain = 2.5f;
+
+const ParamDef paramTable[] = {
+        {"gain", PARAM_TYPE_F32, 0, 0, 0.0f, 10.0f, &gain, NULL},
+};
+
+const uint8_t paramTableSize = (uint8_t)(sizeof(paramTable) / sizeof(paramTable[0]));
+
+static SimLink link;
+static int port = -1;
+static FrameParser parser;
+
+/**
+  * @brief   发一帧并服务链路直到收到应答 | Send a frame and service the link until the reply arrives
+  * @return  应答延迟 (s)，超时返回 -1 | Reply latency, -1 on timeout
+  */
+static double request(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len, Frame *reply, uint16_t *wireLen) {
+    uint8_t buf[PROTOCOL_MAX_FRAME];
+    uint16_t n = Frame_Encode(type, seq, payload, len, buf);
+    *wireLen = n;
+    double start = SimLink_Now();
+    Serial_Write(port, buf, n);
+    while (SimLink_Now() - start < 0.2) {
+        SimLink_RunUntil(&link, SimLink_Now() + 0.0002);
+        uint8_t in[64];
+        int got = Serial_Read(port, in, sizeof(in), 0);
+        for (int i = 0; i < got; i++) {
+            (*wireLen)++;
+            if (FrameParser_Feed(&parser, in[i], reply) && reply->seq == seq) {
+                return SimLink_Now() - start;
+            }
+        }
+    }
+    return -1.0;
+}
+
+static void testCommand(void) {
+    Frame reply;
+    uint16_t wire;
+    uint8_t cmd;
+    double latency = request(CMD_FORWARD, 1, NULL, 0, &reply, &wire);
+    double line = wire * link.byteTime;
+    printf("  command ack after %.2f ms, line time %.2f ms (%u bytes)\n", latency * 1e3, line * 1e3, wire);
+    CHECK(latency > 0.0 && reply.type == CMD_FORWARD, "no ack for CMD_FORWARD");
+    CHECK(latency > 0.9 * line && latency < line + 0.003, "ack latency %.2f ms vs line time %.2f ms", latency * 1e3, line * 1e3);
+    CHECK(SimLink_PollCommand(&link, &cmd) && cmd == CMD_FORWARD, "CMD_FORWARD not queued");
+
+    latency = request(CMD_FORWARD, 1, NULL, 0, &reply, &wire);
+    CHECK(latency > 0.0 && reply.type == CMD_FORWARD, "no ack for the retransmission");
+    CHECK(!SimLink_PollCommand(&link, &cmd), "retransmission queued again");
+    printf("  retransmission acked, %u duplicate\n", link.rx.stats.cmdDuplicates);
+}
+
+static void testParamAndStats(void) {
+    Frame reply;
+    uint16_t wire;
+    const uint8_t id = 0;
+    fp32 value = 0.0f;
+    CHECK(request(MSG_PARAM_GET, 2, &id, 1, &reply, &wire) > 0.0 && reply.type == MSG_PARAM_GET && reply.len == 5,
+          "no MSG_PARAM_GET reply");
+    memcpy(&value, &reply.payload[1], sizeof(value));
+    printf("  gain = %g\n", value);
+    CHECK(value == gain, "read %g, expected %g", value, gain);
+
+    UartRxStats st;
+    CHECK(request(MSG_LINK_STATS, 3, NULL, 0, &reply, &wire) > 0.0 && reply.len == sizeof(st), "no MSG_LINK_STATS reply");
+    memcpy(&st, reply.payload, sizeof(st));
+    printf("  link stats: %u frames, %u crc errors\n", st.frames, st.crcErrors);
+    // 统计在帧处理完后才计入，不含这一帧本身 | A frame is counted after it is handled, so this one is not included
+    CHECK(st.frames == 3 && st.crcErrors == 0, "stats report %u frames, %u crc errors", st.frames, st.crcErrors);
+}
+
+static void testTxOverflow(void) {
+    uint8_t payload[PROTOCOL_MAX_PAYLOAD] = {0};
+    uint32_t before = link.txDropped;
+    int queued = 0;
+    for (int i = 0; i < 16; i++) {
+        queued += SimLink_SendFrame(&link, MSG_TELEMETRY, (uint8_t)i, payload, sizeof(payload)) == 0;
+    }
+    printf("  16 full frames without servicing: %d queued, %u dropped, %u bytes waiting\n",
+           queued, link.txDropped - before, link.txLen);
+    CHECK(queued > 0 && link.txDropped - before == (uint32_t)(16 - queued), "drops not counted per frame");
+    CHECK(link.txLen <= SIM_LINK_TX_SIZE && link.txLen % (link.txLen / queued) == 0, "a frame was split");
+}
+
+int main(void) {
+    if (SimLink_Open(&link, NULL) != 0 || (port = Serial_Open(link.slave, SIM_LINK_BAUD)) < 0) {
+        perror("pty");
+        return 1;
+    }
+    FrameParser_Init(&parser);
+    printf("command\n");
+    testCommand();
+    printf("parameters and statistics\n");
+    testParamAndStats();
+    printf("transmit queue\n");
+    testTxOverflow();
+    Serial_Close(port);
+    SimLink_Close(&link);
+    return Check_Exit();
+}
@@ -0,0 +1,756 @@
+/**
+  * @file    sim_main.c
+  * @brief   平衡与运动控制的主机端闭环仿真 | Host-side closed-loop simulation of balance and motion control
+  *
+  * @note    用法 | Usage:
+  *          dnb_sim [-s script] [-t seconds] [-o trace.csv] [-g kp,kd,vkp,vki] [--no-shaping]
+  *                  [-p waypoints.txt | --path] [-w wall_cm] [--no-governor] [--brake-sweep]
+  *                  [-m motor] [--realtime] [--pty]
+  *          固件的控制栈 control.c 原样编译进来，经 robot.c 驱动 plant.c 模型；
+  *          电机内环复现 Move() 的 PID（计数/周期 → PWM 比较值）。
+  *          The firmware control stack control.c is compiled in unchanged and drives the plant.c
+  *          model through robot.c; the motor inner loop reproduces the PID in Move() (counts/tick →
+  *          PWM compare).
+  *          -s  命令脚本，每行 "<时间 s> <命令名> [次数]"，# 开头为注释 | Command script, one "<time s> <NAME> [repeat]" per line, # comments
+  *          -t  仿真时长（默认 14 s） | Duration (default 14 s)
+  *          -o  逐周期轨迹 CSV | Per-tick trace CSV
+  *          -g  覆盖直立环/速度环增益 | Override the upright/velocity loop gains
+  *          --no-shaping  跳过 S 曲线，设定值阶跃到目标，用于对比 | Bypass the S-curve; setpoints step to the target, for comparison
+  *          -p  航点文件，每行 "x y" (cm)，经 MSG_PATH_APPEND 帧上传；未给 -s 时脚本为 "0.5 ROAD_PLANNING"
+  *              Waypoint file, one "x y" (cm) per line, uploaded as MSG_PATH_APPEND frames; without -s the
+  *              script is "0.5 ROAD_PLANNING"
+  *          --path  使用内置的跑道形路径 | Use the built-in racetrack path
+  *          -w  前方墙面的 x 坐标 (cm)，超声波按 TIM4 的时序仿真 | x of a wall ahead; the sonar is emulated with TIM4 timing
+  *          --no-governor  关闭避障限速，用于对比 | Disable the obstacle governor, for comparison
+  *          --brake-sweep  各巡航速度驶向墙面，报告制动距离 | Drive at each cruise speed towards a wall and report braking distance
+  *          -m  换成 dc_motor.c 的高保真电机预设（H 桥、齿隙、摩擦），默认为线性模型
+  *              Use a dc_motor.c high-fidelity motor preset (H-bridge, backlash, friction); the default is the linear model
+  *          --realtime  按墙钟节拍运行，用于交互调参；默认不限速全速运行，用于批量仿真
+  *                      Pace to the wall clock, for interactive tuning; the default runs unpaced, for batch runs
+  *          --pty  在 pty 上提供 USART2（隐含 --realtime），协议与固件逐字节相同，dnb_param、
+  *                 dnb_telemetry 等直接连接打印出的从端；未给 -s 时没有脚本，未给 -t 时运行到 Ctrl-C
+  *                 Serve USART2 on a pty (implies --realtime), byte for byte the firmware's protocol, so
+  *                 dnb_param, dnb_telemetry and the rest connect to the printed slave path; without -s
+  *                 there is no script, and without -t it runs until Ctrl-C
+  */
+#include <math.h>
+#include <time.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "robot.h"
+#include "command.h"
+#include "ultrasonic.h"
+#include "sim_link.h"
+#include "param.h"
+#include "param_store.h"
+#include "telemetry.h"
+
+#define TICK            ROBOT_TICK
+#define MAX_EVENTS      256
+
+typedef struct {
+    double time;
+    uint8_t cmd;
+} Event;
+
+/* 默认场景：起步加速到接近最高速、全速换向、边走边转、急停、原地掉头
+ * Default scenario: launch to near top speed, full-speed reversal, turn while driving, hard stop, turn around */
+static const char *defaultScript =
+        "0.5  FORWARD\n"
+        "0.5  SPEED_UP 8\n"
+        "3.0  BACKWARD\n"
+        "3.0  SPEED_UP 8\n"
+        "5.5  FORWARD\n"
+        "5.5  SPEED_UP 4\n"
+        "6.5  LEFT\n"
+        "7.5  TURN_CLEAR\n"
+        "8.5  STOP\n"
+        "10.0 TURN_AROUND\n";
+
+/* 里程计对比：同一组传感器数据喂给不同的航向来源 | Odometry comparison: the same sensor data feeds different heading sources */
+typedef struct {
+    const char *name;
+    fp32 tau;           /**< 融合时间常数，0 为纯编码器 | Fusion time constant, 0 for encoders only */
+    int useDmp;         /**< 1 用 DMP yaw 增量，0 用 gyroz 积分 | 1 uses the DMP yaw increment, 0 integrates gyroz */
+    Odometry odom;
+    double maxErr;      /**< 最大位置误差 (cm) | Max position error */
+} OdomCase;
+
+static OdomCase odomCases[] = {
+        {.name = "encoders",      .tau = 0.0f,                .useDmp = 0},
+        {.name = "gyroz",         .tau = 1e9f,                .useDmp = 0},
+        {.name = "dmp yaw",       .tau = 1e9f,                .useDmp = 1},
+        {.name = "fused gyroz",   .tau = ODOMETRY_FUSION_TAU, .useDmp = 0},
+        {.name = "fused dmp yaw", .tau = ODOMETRY_DMP_FUSION_TAU, .useDmp = 1},
+};
+
+#define ODOM_CASES (sizeof(odomCases) / sizeof(odomCases[0]))
+
+static const char *pathScript = "0.5 ROAD_PLANNING\n";
+
+/* 航点 (cm) | Waypoints */
+static fp32 waypoints[PATH_MAX_WAYPOINTS][2];
+static int waypointCount = 0;
+
+/**
+  * @brief   内置路径：80 cm 直道 + 半径 30 cm 半圆，往返成跑道形 | Built-in path: 80 cm straights and 30 cm radius half circles forming a racetrack
+  */
+static void racetrack(void) {
+    const double r = 30.0, straight = 80.0;
+    waypointCount = 0;
+    for (int i = 0; i <= 4; i++) {
+        waypoints[waypointCount][0] = (fp32)(straight * i / 4);
+        waypoints[waypointCount++][1] = 0.0f;
+    }
+    for (int i = 1; i <= 12; i++) {
+        double a = -M_PI / 2 + M_PI * i / 12;
+        waypoints[waypointCount][0] = (fp32)(straight + r * cos(a));
+        waypoints[waypointCount++][1] = (fp32)(r + r * sin(a));
+    }
+    for (int i = 1; i <= 4; i++) {
+        waypoints[waypointCount][0] = (fp32)(straight - straight * i / 4);
+        waypoints[waypointCount++][1] = (fp32)(2 * r);
+    }
+    for (int i = 1; i <= 6; i++) {
+        double a = M_PI / 2 + M_PI / 2 * i / 6;
+        waypoints[waypointCount][0] = (fp32)(r * cos(a));
+        waypoints[waypointCount++][1] = (fp32)(r + r * sin(a));
+    }
+}
+
+static int loadWaypoints(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    float x, y;
+    waypointCount = 0;
+    while (waypointCount < PATH_MAX_WAYPOINTS && fscanf(f, "%f %f", &x, &y) == 2) {
+        waypoints[waypointCount][0] = x;
+        waypoints[waypointCount++][1] = y;
+    }
+    fclose(f);
+    return waypointCount >= 2 ? 0 : -1;
+}
+
+/**
+  * @brief   按协议分帧上传到跟踪器 | Upload to the follower frame by frame, as over the link
+  */
+static int uploadPath(PathFollower *follower) {
+    uint8_t payload[PROTOCOL_MAX_PAYLOAD], reply[PROTOCOL_MAX_PAYLOAD], len;
+    const int perFrame = (PROTOCOL_MAX_PAYLOAD - 1) / 8;
+    Frame req = {.type = MSG_PATH_CLEAR, .len = 0, .payload = payload};
+    Path_HandleFrame(follower, &req, reply, &len);
+
+    for (int i = 0; i < waypointCount; i += perFrame) {
+        int n = (waypointCount - i < perFrame) ? waypointCount - i : perFrame;
+        payload[0] = (uint8_t)i;
+        memcpy(&payload[1], waypoints[i], (size_t)n * 8);
+        req = (Frame){.type = MSG_PATH_APPEND, .len = (uint8_t)(1 + n * 8), .payload = payload};
+        Path_HandleFrame(follower, &req, reply, &len);
+        if ((int8_t)reply[0] != PATH_OK) return -1;
+    }
+    return 0;
+}
+
+/**
+  * @brief   真实位置到路径折线的距离 | Distance from the true position to the path polyline
+  */
+static double pathDistance(double x, double y) {
+    double best = INFINITY;
+    for (int i = 0; i + 1 < waypointCount; i++) {
+        double ax = waypoints[i][0], ay = waypoints[i][1];
+        double dx = waypoints[i + 1][0] - ax, dy = waypoints[i + 1][1] - ay;
+        double len2 = dx * dx + dy * dy;
+        double u = len2 > 0 ? ((x - ax) * dx + (y - ay) * dy) / len2 : 0.0;
+        u = u < 0 ? 0 : (u > 1 ? 1 : u);
+        double d = hypot(ax + u * dx - x, ay + u * dy - y);
+        if (d < best) best = d;
+    }
+    return best;
+}
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* 与 car.h 相同：右电机镜像安装 | As in car.h: the right motor is mirrored */
+#define WHEEL_L_SIGN    1
+#define WHEEL_R_SIGN    (-1)
+
+static Robot robot;
+static volatile sig_atomic_t running = 1;
+
+extern ParamStore paramStore;
+
+/* 参数表上仿真没有的量 | Table entries the simulation does not model */
+static uint16_t loopPeriodUs = (uint16_t)(ROBOT_TICK * 1e6);
+static uint8_t telemetryPeriodMs = TELEMETRY_PERIOD_MS;
+static uint8_t sensorLogEnabled = 0;
+static fp32 retiredParam = 0.0f;
+static int32_t imuBias[6] = {0};
+
+/**
+  * @brief   左电机增益同步到右电机 | Mirror left motor gains to the right motor
+  */
+static void applyMotorGains(const ParamDef *def) {
+    (void)def;
+    robot.motor[1].Kp = robot.motor[0].Kp;
+    robot.motor[1].Ki = robot.motor[0].Ki;
+    robot.motor[1].Kd = robot.motor[0].Kd;
+    robot.motor[1].max_iout = robot.motor[0].max_iout;
+}
+
+/* 参数表：名称、编号、类型和范围与固件 param_table.c 相同，上位机工具分不出仿真与实车；
+   仿真没有的传感器日志、IMU 零偏和固定的控制周期为只读，退役的占位同固件
+   Parameter table: names, ids, types and ranges as in the firmware's param_table.c, so host tools
+   cannot tell the simulation from the car; the sensor log and IMU biases, which are not
+   simulated, and the fixed loop period are read-only, and the retired placeholders match the firmware */
+const ParamDef paramTable[] = {
+        /* name            type             flags               storeKey                  min       max       ptr                         OnApply */
+        {"bias",           PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_BALANCE_BIAS,   -10.0f,   10.0f,    &robot.control.balanceBias, NULL},
+        {"motor_kp",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_MOTOR_KP,       0.0f,     5000.0f,  &robot.motor[0].Kp,         applyMotorGains},
+        {"motor_ki",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_MOTOR_KI,       0.0f,     500.0f,   &robot.motor[0].Ki,         applyMotorGains},
+        {"motor_kd",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_MOTOR_KD,       0.0f,     500.0f,   &robot.motor[0].Kd,         applyMotorGains},
+        {"motor_max_iout", PARAM_TYPE_F32,  0,                  0,                        0.0f,     60000.0f, &robot.motor[0].max_iout,   applyMotorGains},
+        {"learn_rate",     PARAM_TYPE_F32,  PARAM_FLAG_READONLY, 0,                       0.0f,     0.0f,     &retiredParam,              NULL},  // 已退役 | Retired
+        {"speed_alpha",    PARAM_TYPE_F32,  PARAM_FLAG_READONLY, 0,                       0.0f,     0.0f,     &retiredParam,              NULL},  // 已退役 | Retired
+        {"start_speed",    PARAM_TYPE_I8,   0,                  0,                        0.0f,     100.0f,   &robot.control.motion.startSpeed, NULL},
+        {"loop_us",        PARAM_TYPE_U16,  PARAM_FLAG_READONLY, PARAM_KEY_LOOP_PERIOD,   1000.0f,  50000.0f, &loopPeriodUs,              NULL},
+        {"telem_ms",       PARAM_TYPE_U8,   PARAM_FLAG_PERSIST, PARAM_KEY_TELEMETRY_PERIOD, 0.0f,   255.0f,   &telemetryPeriodMs,         NULL},
+        {"sensor_log",     PARAM_TYPE_U8,   PARAM_FLAG_READONLY, PARAM_KEY_SENSOR_LOG,    0.0f,     1.0f,     &sensorLogEnabled,          NULL},
+        {"angle_kp",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_ANGLE_KP,       0.0f,     500.0f,   &robot.control.balance.angleKp,   NULL},
+        {"angle_kd",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_ANGLE_KD,       0.0f,     50.0f,    &robot.control.balance.angleKd,   NULL},
+        {"vel_kp",         PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_VELOCITY_KP,    0.0f,     1.0f,     &robot.control.balance.velocity.Kp, NULL},
+        {"vel_ki",         PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_VELOCITY_KI,    0.0f,     0.1f,     &robot.control.balance.velocity.Ki, NULL},
+        {"turn_kp",        PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_TURN_KP,        0.0f,     1.0f,     &robot.control.balance.turn.Kp,   NULL},
+        {"turn_ki",        PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_TURN_KI,        0.0f,     0.1f,     &robot.control.balance.turn.Ki,   NULL},
+        {"turn_kd",        PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_TURN_KD,        0.0f,     1.0f,     &robot.control.balance.turn.Kd,   NULL},
+        {"gyro_bias_x",    PARAM_TYPE_I32,  PARAM_FLAG_READONLY, PARAM_KEY_GYRO_BIAS + 0, -16777216.0f, 16777216.0f, &imuBias[0], NULL},
+        {"gyro_bias_y",    PARAM_TYPE_I32,  PARAM_FLAG_READONLY, PARAM_KEY_GYRO_BIAS + 1, -16777216.0f, 16777216.0f, &imuBias[1], NULL},
+        {"gyro_bias_z",    PARAM_TYPE_I32,  PARAM_FLAG_READONLY, PARAM_KEY_GYRO_BIAS + 2, -16777216.0f, 16777216.0f, &imuBias[2], NULL},
+        {"accel_bias_x",   PARAM_TYPE_I32,  PARAM_FLAG_READONLY, PARAM_KEY_ACCEL_BIAS + 0, -16777216.0f, 16777216.0f, &imuBias[3], NULL},
+        {"accel_bias_y",   PARAM_TYPE_I32,  PARAM_FLAG_READONLY, PARAM_KEY_ACCEL_BIAS + 1, -16777216.0f, 16777216.0f, &imuBias[4], NULL},
+        {"accel_bias_z",   PARAM_TYPE_I32,  PARAM_FLAG_READONLY, PARAM_KEY_ACCEL_BIAS + 2, -16777216.0f, 16777216.0f, &imuBias[5], NULL},
+};
+
+const uint8_t paramTableSize = (uint8_t)(sizeof(paramTable) / sizeof(paramTable[0]));
+
+/**
+  * @brief   按 telemetry.c 的字段来源发一条遥测记录 | Send one telemetry record, fields sourced as in telemetry.c
+  * @note    IMU 的横滚轴是车的俯仰轴（见 car.h 的 BALANCE_ANGLE）；电机量按电机自身方向
+  *          The IMU roll axis is the car's pitch axis (see BALANCE_ANGLE in car.h); motor quantities are in motor direction
+  */
+static void publishTelemetry(SimLink *link, const ControlInput *in, uint8_t cmd, double t) {
+    static uint32_t lastTick = 0;
+    static uint8_t seq = 0;
+    uint32_t now = (uint32_t)llround(t * 1000.0);
+    if (telemetryPeriodMs == 0 || (now - lastTick) < telemetryPeriodMs) {
+        return;
+    }
+    lastTick = now;
+
+    Pose pose;
+    Odometry_GetPose(&robot.control.odometry, &pose);
+    TelemetryRecord r = {
+            .tick_ms  = now,
+            .roll     = in->pitch,
+            .yaw      = in->yaw,
+            .gyrox    = in->pitchRate,
+            .gyroz    = in->yawRate,
+            .out_l    = WHEEL_L_SIGN * robot.motor[0].out,
+            .out_r    = WHEEL_R_SIGN * robot.motor[1].out,
+            .pose_x   = pose.x,
+            .pose_y   = pose.y,
+            .heading  = pose.heading,
+            .rpm_l    = (int16_t)(WHEEL_L_SIGN * robot.counts[0]),
+            .rpm_r    = (int16_t)(WHEEL_R_SIGN * robot.counts[1]),
+            .tx_drops = (uint16_t)link->txDropped,
+            .cmd      = cmd,
+            .motion   = (uint8_t)robot.control.motion.state
+    };
+    SimLink_SendFrame(link, MSG_TELEMETRY, seq++, (const uint8_t *)&r, sizeof(r));
+}
+
+static void onSignal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static Event events[MAX_EVENTS];
+static int eventCount = 0;
+
+static int parseScript(const char *text) {
+    char line[128];
+    int lineNo = 0;
+    while (*text) {
+        size_t n = strcspn(text, "\n");
+        if (n >= sizeof(line)) n = sizeof(line) - 1;
+        memcpy(line, text, n);
+        line[n] = '\0';
+        text += strcspn(text, "\n");
+        if (*text) text++;
+        lineNo++;
+
+        double t;
+        char name[32];
+        int repeat = 1;
+        int fields = sscanf(line, "%lf %31s %d", &t, name, &repeat);
+        if (fields < 2 || line[0] == '#') continue;
+        int cmd = Motion_CommandByName(name);
+        if (cmd < 0) {
+            fprintf(stderr, "line %d: unknown command '%s'\n", lineNo, name);
+            return -1;
+        }
+        for (int i = 0; i < repeat && eventCount < MAX_EVENTS; i++) {
+            events[eventCount++] = (Event){t, (uint8_t)cmd};
+        }
+    }
+    return 0;
+}
+
+static char *readFile(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc((size_t)size + 1);
+    size_t got = fread(buf, 1, (size_t)size, f);
+    buf[got] = '\0';
+    fclose(f);
+    return buf;
+}
+
+/* 超声波模型：安装在轮轴正上方，朝前 | Ultrasonic model: mounted above the axle, facing forward */
+#define SONAR_DELAY_US  460             /**< 触发到回波上升沿 | Trigger to echo rise */
+#define SONAR_NOISE_US  15.0            /**< 回波宽度噪声标准差 | Echo width noise std-dev */
+
+typedef struct {
+    Ultrasonic u;
+    double rise, fall, timeout;         /**< 待送达的边沿时刻 (s)，<0 表示无 | Pending edge times, <0 for none */
+    uint32_t rng;
+} Sonar;
+
+static double sonarNoise(Sonar *s) {
+    double sum = 0.0;
+    for (int i = 0; i < 12; i++) {
+        s->rng = s->rng * 1664525u + 1013904223u;
+        sum += (s->rng >> 8) / 16777216.0;
+    }
+    return (sum - 6.0) * SONAR_NOISE_US;
+}
+
+/**
+  * @brief   按 TIM4 的方式推进超声波：触发、边沿和超时在各自时刻送达 | Advance the sonar as TIM4 would: trigger, edges and timeout land at their own times
+  */
+static void sonarStep(Sonar *s, const Plant *plant, double wall, double t) {
+    uint16_t us = (uint16_t)(uint64_t)(t * 1e6);
+    if (s->rise >= 0.0 && s->rise <= t) {
+        Ultrasonic_Edge(&s->u, TRUE, (uint16_t)(uint64_t)(s->rise * 1e6));
+        s->rise = -1.0;
+    }
+    if (s->fall >= 0.0 && s->fall <= t) {
+        Ultrasonic_Edge(&s->u, FALSE, (uint16_t)(uint64_t)(s->fall * 1e6));
+        s->fall = -1.0;
+    }
+    if (s->timeout >= 0.0 && s->timeout <= t) {
+        Ultrasonic_Timeout(&s->u);
+        s->timeout = -1.0;
+    }
+    if (!Ultrasonic_Trigger(&s->u, us, (uint32_t)(t * 1000.0 + 0.5))) return;
+
+    s->timeout = t + ULTRASONIC_TIMEOUT_US * 1e-6;
+    double c = cos(plant->psi);
+    double range = (wall > 0.0 && c > 0.2) ? (wall - plant->px * 100.0) / c : INFINITY;
+    if (range > 0.0 && range < 400.0) {
+        s->rise = t + SONAR_DELAY_US * 1e-6;
+        s->fall = s->rise + (range * ULTRASONIC_US_PER_CM + sonarNoise(s)) * 1e-6;
+    }
+}
+
+/**
+  * @struct  SimOptions
+  * @brief   一次仿真的配置 | Configuration of one run
+  */
+typedef struct {
+    double duration;        /**< 仿真时长 (s) | Duration */
+    int shaping;            /**< 0 跳过 S 曲线 | 0 bypasses the S-curve */
+    const char *gains;      /**< -g 增益覆盖 | -g gain override */
+    FILE *trace;            /**< 逐周期轨迹 | Per-tick trace */
+    double wall;            /**< 前方墙面的 x 坐标 (cm)，≤0 表示无 | x of a wall ahead, ≤0 for none */
+    int governor;           /**< 1 启用避障限速 | 1 enables the obstacle governor */
+    int verbose;            /**< 1 打印完整报告 | 1 prints the full report */
+    const DcMotorParams *motor; /**< 高保真电机，NULL 为线性模型 | High-fidelity motor, NULL for the linear model */
+    int realtime;           /**< 1 按墙钟节拍运行 | 1 paces to the wall clock */
+    SimLink *link;          /**< pty 上的 USART2，NULL 为无 | USART2 on a pty, NULL for none */
+} SimOptions;
+
+/**
+  * @struct  SimResult
+  * @brief   一次仿真的结果 | Result of one run
+  */
+typedef struct {
+    int fell;
+    double maxPitch;        /**< 最大倾角 (°) | Max pitch */
+    double peakSpeed;       /**< 最高车速 (cm/s) | Peak speed */
+    double minGap;          /**< 与墙的最小距离 (cm) | Closest approach to the wall */
+    double brakeAt;         /**< 开始限速时的车速 (cm/s) | Speed when the cap first bit */
+    double brakeDist;       /**< 从开始限速到停下的距离 (cm) | Distance from the first cap to standstill */
+} SimResult;
+
+/**
+  * @brief   运行一次闭环仿真 | Run one closed-loop simulation
+  * @return  0 正常，1 倒地，其他为配置错误 | 0 ok, 1 fell, anything else is a configuration error
+  */
+static int simulate(const SimOptions *o, SimResult *res) {
+    FILE *trace = o->trace;
+    const int shaping = o->shaping;
+    const double duration = o->duration;
+
+    PlantParams pp = Plant_DefaultParams();
+    pp.motor = o->motor;
+    Robot_Init(&robot, &pp, 0.02, 12345);
+    const Plant *plantp = &robot.plant;
+    Control *ctl = &robot.control;
+
+    if (waypointCount && uploadPath(&ctl->path) != 0) {
+        fprintf(stderr, "path upload rejected\n");
+        return 2;
+    }
+    Balance *balance = &ctl->balance;
+    if (o->gains && sscanf(o->gains, "%f,%f,%f,%f", &balance->angleKp, &balance->angleKd,
+                           &balance->velocity.Kp, &balance->velocity.Ki) != 4) {
+        fprintf(stderr, "-g expects kp,kd,vkp,vki\n");
+        return 2;
+    }
+    Sonar sonar = {.u = newUltrasonic(), .rise = -1.0, .fall = -1.0, .timeout = -1.0, .rng = 777};
+
+    for (size_t i = 0; i < ODOM_CASES; i++) {
+        odomCases[i].odom = newOdometry((fp32)(pp.track * 100.0), odomCases[i].tau);
+        odomCases[i].maxErr = 0.0;
+    }
+    float lastYaw = ctl->lastYaw;
+    SimLink *link = o->link;
+    uint8_t lastCmd = CMD_STOP;
+    if (link) {
+        link->path = &ctl->path;
+    }
+
+    /* 统计 | Statistics */
+    double maxPitch = 0.0, speedSq = 0.0, yawSq = 0.0;
+    unsigned long ticks = 0, satTicks = 0, dutySatTicks = 0;
+    int next = 0, fell = 0;
+    double xteSq = 0.0, xteMax = 0.0, followerSq = 0.0, pathCostMax = 0.0, pathCostSum = 0.0, doneAt = -1.0;
+    unsigned long pathTicks = 0, pathUpdates = 0;
+    double peakSpeed = 0.0, minGap = INFINITY, brakeAt = -1.0, brakeFrom = 0.0, brakeDist = -1.0;
+    double wallStart = SimLink_Now(), maxLate = 0.0;
+    unsigned long lateTicks = 0, slips = 0;
+
+    for (double t = 0.0; t < duration && running; t += TICK) {
+        // 实时模式：等到本周期的墙钟时刻，其间服务链路；落后超过 10 个周期就放弃追赶
+        // Real-time mode: wait for this period's wall-clock time, servicing the link meanwhile; more than 10 periods behind, give up catching up
+        if (o->realtime) {
+            double due = wallStart + ticks * TICK, late = SimLink_Now() - due;
+            if (late > 0.0) {
+                lateTicks++;
+                if (late > maxLate) maxLate = late;
+                if (late > 10.0 * TICK) {
+                    wallStart += late;
+                    slips++;
+                }
+            }
+            if (link) {
+                SimLink_RunUntil(link, due);
+            } else {
+                struct timespec ts = {.tv_sec = (time_t)due, .tv_nsec = (long)((due - (double)(time_t)due) * 1e9)};
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+            }
+        }
+
+        ControlInput in;
+        Robot_Sense(&robot, &in);
+        float dYawDmp = remainderf(in.yaw - lastYaw, 360.0f);
+        lastYaw = in.yaw;
+        for (size_t i = 0; i < ODOM_CASES; i++) {
+            OdomCase *c = &odomCases[i];
+            Odometry_Update(&c->odom, in.dLeft, in.dRight, c->useDmp ? dYawDmp : in.yawRate * (fp32)TICK, (fp32)TICK);
+            Pose pose;
+            Odometry_GetPose(&c->odom, &pose);
+            double err = hypot(pose.x - plantp->px * 100.0, pose.y - plantp->py * 100.0);
+            if (err > c->maxErr) c->maxErr = err;
+        }
+        sonarStep(&sonar, plantp, o->wall, t);
+        // 关闭限速器时不给它读数，限速保持 GOVERNOR_NO_LIMIT | With the governor off it gets no readings and the cap stays at GOVERNOR_NO_LIMIT
+        if (o->governor) {
+            UltrasonicReading range;
+            Ultrasonic_Read(&sonar.u, &range);
+            in.range = range.distance;
+            in.rangeValid = range.valid;
+            in.rangeAge = (fp32)(t - range.timestamp * 1e-3);
+        }
+
+        while (next < eventCount && events[next].time <= t + 1e-9) {
+            Motion_Dispatch(&ctl->motion, events[next++].cmd);
+        }
+        // 与固件主循环相同：先应用参数写入，再执行串口命令 | As the firmware main loop: apply parameter writes, then run UART commands
+        if (link) {
+            Param_ApplyPending();
+            // 固件在刹车保持 1 s 后擦除参数扇区；RAM 后端擦除不耗时，刹车即可 | The firmware erases a parameter sector once the brake has held for 1 s; the RAM backend erases instantly, so braking is enough
+            if (ctl->brake && ParamStore_ErasePending(&paramStore)) {
+                ParamStore_Maintain(&paramStore);
+            }
+            uint8_t cmd;
+            while (SimLink_PollCommand(link, &cmd)) {
+                lastCmd = cmd;
+                Motion_Dispatch(&ctl->motion, cmd);
+            }
+        }
+
+        bool_t planning = ctl->motion.roadPlanning;
+        double t0 = nowNs();
+        Control_Setpoints(ctl, &in, (fp32)TICK);
+        double cost = nowNs() - t0;
+        if (ctl->pathUpdated) {
+            pathCostSum += cost;
+            if (cost > pathCostMax) pathCostMax = cost;
+            pathUpdates++;
+            followerSq += ctl->path.crossTrack * ctl->path.crossTrack;
+            if (ctl->path.finished) doneAt = t;
+        }
+        if (planning) {
+            double xte = pathDistance(plantp->px * 100.0, plantp->py * 100.0);
+            xteSq += xte * xte;
+            if (xte > xteMax) xteMax = xte;
+            pathTicks++;
+        }
+        if (!shaping) {
+            SCurve_Reset(&ctl->motion.linear, ctl->motion.linear.target);
+            SCurve_Reset(&ctl->motion.angular, ctl->motion.angular.target);
+        }
+        Control_Balance(ctl, &in, (fp32)TICK);
+        Robot_Actuate(&robot);
+        if (link) {
+            publishTelemetry(link, &in, lastCmd, t);
+        }
+        const double *duty = robot.duty;
+        int dutySat = robot.dutySaturated;
+
+        double truePitch = plantp->theta * 180.0 / 3.14159265358979;
+        double trueSpeed = plantp->xd * 100.0;
+        double trueYaw = plantp->psid * 180.0 / 3.14159265358979;
+        if (fabs(truePitch) > maxPitch) maxPitch = fabs(truePitch);
+        speedSq += (trueSpeed - ctl->motion.linear.vel) * (trueSpeed - ctl->motion.linear.vel);
+        yawSq += (trueYaw - ctl->motion.angular.vel) * (trueYaw - ctl->motion.angular.vel);
+        satTicks += balance->saturated;
+        dutySatTicks += dutySat;
+        ticks++;
+
+        if (trueSpeed > peakSpeed) peakSpeed = trueSpeed;
+        if (o->wall > 0.0) {
+            double gap = o->wall - plantp->px * 100.0;
+            if (gap < minGap) minGap = gap;
+            if (brakeAt < 0.0 && ctl->motion.linear.target > ctl->motion.speedLimit && trueSpeed > 1.0) {
+                brakeAt = trueSpeed;
+                brakeFrom = plantp->px * 100.0;
+            }
+            if (brakeAt >= 0.0 && brakeDist < 0.0 && fabs(trueSpeed) < 0.5) {
+                brakeDist = plantp->px * 100.0 - brakeFrom;
+            }
+        }
+
+        if (trace) {
+            fprintf(trace, "%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%d\n",
+                    t, truePitch, balance->pitchTarget, trueSpeed, ctl->motion.linear.vel, ctl->motion.linear.target,
+                    trueYaw, ctl->motion.angular.vel, balance->left, balance->right, duty[0], duty[1],
+                    balance->saturated | dutySat);
+        }
+        if (fabs(truePitch) > BALANCE_FALL_ANGLE) {
+            fell = 1;
+            if (o->verbose) printf("fell at t=%.2f s\n", t);
+            break;
+        }
+    }
+
+    *res = (SimResult){.fell = fell, .maxPitch = maxPitch, .peakSpeed = peakSpeed, .minGap = minGap,
+                       .brakeAt = brakeAt, .brakeDist = brakeDist};
+    if (!o->verbose) return fell;
+
+    printf("shaping          %s\n", shaping ? "s-curve" : "none (step)");
+    printf("simulated        %.2f s\n", ticks * TICK);
+    printf("max |pitch|      %.2f deg\n", maxPitch);
+    printf("balance sat      %.1f %%\n", 100.0 * satTicks / (ticks ? ticks : 1));
+    printf("pwm sat          %.1f %%\n", 100.0 * dutySatTicks / (ticks ? ticks : 1));
+    printf("speed rms err    %.2f cm/s\n", sqrt(speedSq / (ticks ? ticks : 1)));
+    printf("yaw rate rms err %.2f deg/s\n", sqrt(yawSq / (ticks ? ticks : 1)));
+    printf("final pose       (%.1f, %.1f) cm, heading %.1f deg, path %.1f cm\n", plantp->px * 100.0, plantp->py * 100.0,
+           remainder(plantp->psi * 180.0 / 3.14159265358979, 360.0), plantp->x * 100.0);
+    if (o->realtime) {
+        printf("pacing           real time, %lu of %lu periods late, max %.2f ms, %lu slips\n",
+               lateTicks, ticks, maxLate * 1e3, slips);
+    }
+    if (link) {
+        const UartRxStats *st = &link->rx.stats;
+        printf("usart2           rx %u bytes, %u frames, %u crc errors, %u duplicate and %u missing commands\n",
+               st->rxBytes, st->frames, st->crcErrors, st->cmdDuplicates, st->cmdGaps);
+        printf("                 tx %u frames, %u dropped on a full queue, %u bytes unread\n",
+               link->txFrames, link->txDropped, link->txUnread);
+    }
+
+    if (o->wall > 0.0) {
+        printf("\nwall             x = %.0f cm, governor %s\n", o->wall, o->governor ? "on" : "off");
+        printf("closest gap      %.1f cm%s\n", minGap, minGap <= 0.0 ? " (collision)" : "");
+        printf("sonar            %u triggers, %u echoes, %u timeouts\n", sonar.u.stats.triggers,
+               sonar.u.stats.echoes, sonar.u.stats.timeouts);
+    }
+
+    if (waypointCount) {
+        const fp32 *goal = waypoints[waypointCount - 1];
+        printf("\npath             %d waypoints, %.1f cm\n", waypointCount, ctl->path.points[waypointCount - 1].s);
+        if (doneAt >= 0.0) {
+            printf("finished         %.2f s, goal err %.2f cm\n", doneAt, hypot(plantp->px * 100.0 - goal[0], plantp->py * 100.0 - goal[1]));
+        } else {
+            printf("finished         no\n");
+        }
+        printf("true xte         rms %.2f cm, max %.2f cm\n", sqrt(xteSq / (pathTicks ? pathTicks : 1)), xteMax);
+        printf("follower xte     rms %.2f cm (odometry frame)\n", sqrt(followerSq / (pathUpdates ? pathUpdates : 1)));
+        printf("path updates     %lu, Control_Setpoints mean %.0f ns, max %.0f ns\n", pathUpdates,
+               pathCostSum / (pathUpdates ? pathUpdates : 1), pathCostMax);
+    }
+
+    printf("\nodometry         final pos err  max pos err  heading err\n");
+    for (size_t i = 0; i < ODOM_CASES; i++) {
+        Pose pose;
+        Odometry_GetPose(&odomCases[i].odom, &pose);
+        printf("%-16s %10.2f cm %10.2f cm %9.2f deg\n", odomCases[i].name,
+               hypot(pose.x - plantp->px * 100.0, pose.y - plantp->py * 100.0), odomCases[i].maxErr,
+               remainder(pose.heading - plantp->psi * 180.0 / 3.14159265358979, 360.0));
+    }
+    return fell;
+}
+
+/**
+  * @brief   制动扫描：各巡航速度驶向 2.5 m 外的墙 | Braking sweep: drive at each cruise speed towards a wall 2.5 m away
+  */
+static int brakeSweep(const SimOptions *base) {
+    SimOptions o = *base;
+    o.wall = 250.0;
+    o.verbose = 0;
+    o.trace = NULL;
+    Governor g = newGovernor();
+    int failures = 0;
+
+    printf("cruise  peak     capped at  brake dist  planned  closest gap  max pitch\n");
+    for (int steps = 0; steps <= 8; steps++) {
+        eventCount = 0;
+        events[eventCount++] = (Event){0.5, CMD_FORWARD};
+        for (int i = 0; i < steps; i++) {
+            events[eventCount++] = (Event){0.5, CMD_SPEED_UP};
+        }
+        int cruise = 8 + steps * MOTION_SPEED_STEP;
+        o.duration = 10.0 + o.wall / cruise;
+        SimResult r;
+        simulate(&o, &r);
+        double planned = r.brakeAt * g.latency + r.brakeAt * r.brakeAt / (2.0 * g.decel);
+        int ok = !r.fell && r.minGap > 0.0;
+        failures += !ok;
+        printf("%4d    %5.1f    %5.1f      %6.1f cm   %5.1f cm   %6.1f cm   %5.1f deg%s\n",
+               cruise, r.peakSpeed, r.brakeAt, r.brakeDist, planned, r.minGap, r.maxPitch,
+               r.fell ? "  FELL" : (ok ? "" : "  COLLISION"));
+    }
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    const char *scriptPath = NULL;
+    const char *tracePath = NULL;
+    SimOptions o = {.duration = 14.0, .shaping = 1, .governor = 1, .verbose = 1};
+    int sweep = 0, pty = 0, durationSet = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            scriptPath = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            o.duration = atof(argv[++i]);
+            durationSet = 1;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            o.gains = argv[++i];
+        } else if (strcmp(argv[i], "--no-shaping") == 0) {
+            o.shaping = 0;
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            if (loadWaypoints(argv[++i]) != 0) {
+                fprintf(stderr, "%s: need at least 2 waypoints\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--path") == 0) {
+            racetrack();
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            o.wall = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--no-governor") == 0) {
+            o.governor = 0;
+        } else if (strcmp(argv[i], "--brake-sweep") == 0) {
+            sweep = 1;
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc && (o.motor = DcMotor_Preset(argv[i + 1]))) {
+            i++;
+        } else if (strcmp(argv[i], "--realtime") == 0) {
+            o.realtime = 1;
+        } else if (strcmp(argv[i], "--pty") == 0) {
+            pty = o.realtime = 1;
+        } else {
+            fprintf(stderr, "usage: %s [-s script] [-t seconds] [-o trace.csv] [-g kp,kd,vkp,vki] [--no-shaping]"
+                            " [-p waypoints.txt | --path] [-w wall_cm] [--no-governor] [--brake-sweep] [-m motor]"
+                            " [--realtime] [--pty]\n"
+                            "motors:", argv[0]);
+            for (int k = 0; DcMotor_PresetAt(k); k++) {
+                fprintf(stderr, " %s", DcMotor_PresetAt(k)->name);
+            }
+            fprintf(stderr, "\n");
+            return 2;
+        }
+    }
+    if (sweep) return brakeSweep(&o);
+
+    char *script = scriptPath ? readFile(scriptPath) : NULL;
+    if (scriptPath && !script) {
+        perror(scriptPath);
+        return 1;
+    }
+    const char *builtin = pty ? "" : (waypointCount ? pathScript : defaultScript);
+    if (parseScript(script ? script : builtin) != 0) return 1;
+    free(script);
+
+    // 参数保存到内存里的两个扇区，重启仿真即丢失 | Parameters are saved to two sectors in memory and lost when the simulation exits
+    static uint8_t flash[2 * 16384];
+    memset(flash, 0xFF, sizeof(flash));
+    ParamStore_Init(&paramStore, newRamFlashDev(flash, 16384));
+
+    static SimLink link;
+    if (pty) {
+        if (SimLink_Open(&link, NULL) != 0) {
+            perror("pty");
+            return 1;
+        }
+        o.link = &link;
+        if (!durationSet) o.duration = INFINITY;
+        printf("USART2 on %s\n", link.slave);
+        fflush(stdout);
+    }
+    if (o.realtime) {
+        signal(SIGINT, onSignal);
+        signal(SIGTERM, onSignal);
+    }
+
+    o.trace = tracePath ? fopen(tracePath, "w") : NULL;
+    if (o.trace) {
+        fprintf(o.trace, "t,pitch,pitch_target,speed,speed_set,speed_target,yaw_rate,yaw_set,wheel_l,wheel_r,duty_l,duty_r,sat\n");
+    }
+    SimResult r;
+    int ret = simulate(&o, &r);
+    if (o.trace) fclose(o.trace);
+    if (o.link) SimLink_Close(o.link);
+    return ret;
+}
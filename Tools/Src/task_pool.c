@@ -0,0 +1,137 @@
+/**
+  * @file    task_pool.c
+  * @brief   工作窃取线程池 | Work-stealing thread pool
+  */
+#include <pthread.h>
+#include <string.h>
+#include "task_pool.h"
+
+#define CACHE_LINE      64
+
+/* 区间打包：低 32 位 lo，高 32 位 hi | Packed range: lo in the low 32 bits, hi in the high 32 bits */
+#define PACK(lo, hi)    (((uint64_t)(hi) << 32) | (uint32_t)(lo))
+#define LO(r)           ((uint32_t)(r))
+#define HI(r)           ((uint32_t)((r) >> 32))
+
+typedef struct {
+    uint64_t range __attribute__((aligned(CACHE_LINE)));   /**< 剩余区间 [lo, hi) | Remaining range */
+    uint32_t tasks;
+    uint32_t steals;
+    uint32_t rng;
+} Deque;
+
+typedef struct Pool Pool;
+
+typedef struct {
+    Pool *pool;
+    int id;
+} Worker;
+
+struct Pool {
+    Deque deque[TASK_POOL_MAX_THREADS];
+    Worker worker[TASK_POOL_MAX_THREADS];
+    int threads;
+    TaskFn fn;
+    void *ctx;
+};
+
+/**
+  * @brief   从自己区间的低端取一个任务 | Take one task from the low end of the own range
+  */
+static int take(Deque *d, uint32_t *index) {
+    uint64_t r = __atomic_load_n(&d->range, __ATOMIC_ACQUIRE);
+    while (LO(r) < HI(r)) {
+        if (__atomic_compare_exchange_n(&d->range, &r, PACK(LO(r) + 1, HI(r)), 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *index = LO(r);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+  * @brief   偷走 victim 剩余区间的上半段（只剩一个时整个拿走） | Steal the upper half of the victim's range (all of it when one is left)
+  * @note    自己的区间此时为空，别的线程不会修改它，直接写入即可；非空区间的值不会重现，CAS 没有 ABA
+  *          The own range is empty at this point and nobody else modifies an empty range, so a
+  *          plain store suffices; a non-empty range value never recurs, so the CAS has no ABA
+  */
+static int steal(Deque *self, Deque *victim) {
+    uint64_t r = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+    while (LO(r) < HI(r)) {
+        uint32_t mid = LO(r) + (HI(r) - LO(r)) / 2;
+        if (__atomic_compare_exchange_n(&victim->range, &r, PACK(LO(r), mid), 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&self->range, PACK(mid, HI(r)), __ATOMIC_RELEASE);
+            self->steals++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void *workerMain(void *arg) {
+    Worker *w = arg;
+    Pool *pool = w->pool;
+    Deque *self = &pool->deque[w->id];
+    for (;;) {
+        uint32_t index;
+        while (take(self, &index)) {
+            pool->fn(pool->ctx, index, w->id);
+            self->tasks++;
+        }
+        // 从随机位置开始扫一圈，全部为空即结束 | Scan once from a random start; done when every range is empty
+        self->rng = self->rng * 1664525u + 1013904223u;
+        int start = (int)((self->rng >> 8) % (uint32_t)pool->threads);
+        int stolen = 0;
+        for (int k = 0; k < pool->threads && !stolen; k++) {
+            int v = (start + k) % pool->threads;
+            stolen = (v != w->id) && steal(self, &pool->deque[v]);
+        }
+        if (!stolen) {
+            return NULL;
+        }
+    }
+}
+
+int TaskPool_Run(uint32_t n, int threads, TaskFn fn, void *ctx, TaskPoolStats *stats) {
+    if (threads < 1 || threads > TASK_POOL_MAX_THREADS || fn == NULL) {
+        return -1;
+    }
+    Pool local;
+    Pool *pool = &local;
+    memset(pool, 0, sizeof(*pool));
+    pool->threads = threads;
+    pool->fn = fn;
+    pool->ctx = ctx;
+    for (int k = 0; k < threads; k++) {
+        uint32_t lo = (uint32_t)((uint64_t)n * (uint64_t)k / (uint64_t)threads);
+        uint32_t hi = (uint32_t)((uint64_t)n * (uint64_t)(k + 1) / (uint64_t)threads);
+        pool->deque[k].range = PACK(lo, hi);
+        pool->deque[k].rng = 0x9E3779B9u * (uint32_t)(k + 1);
+        pool->worker[k] = (Worker){pool, k};
+    }
+
+    pthread_t tid[TASK_POOL_MAX_THREADS];
+    int started = 0;
+    for (; started < threads; started++) {
+        if (pthread_create(&tid[started], NULL, workerMain, &pool->worker[started]) != 0) {
+            break;
+        }
+    }
+    // 没启动的线程的区间会被已启动的线程偷走 | Ranges of threads that failed to start get stolen by the others
+    for (int k = 0; k < started; k++) {
+        pthread_join(tid[k], NULL);
+    }
+    if (started == 0) {
+        return -1;
+    }
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+        for (int k = 0; k < threads; k++) {
+            stats->tasks[k] = pool->deque[k].tasks;
+            stats->steals[k] = pool->deque[k].steals;
+        }
+    }
+    return 0;
+}
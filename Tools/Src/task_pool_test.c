@@ -0,0 +1,83 @@
+/**
+  * @file    task_pool_test.c
+  * @brief   工作窃取线程池的自检 | Self-check of the work-stealing thread pool
+  *
+  * @note    用法 | Usage: dnb_task_pool_test
+  *          对多种任务数和线程数（含任务数少于线程数、0 个任务）运行线程池，任务耗时按编号
+  *          差别很大（前段任务慢，迫使其余线程去偷）。检查每个编号恰好执行一次、worker 编号在
+  *          范围内、统计的任务数之和等于 n。
+  *          Runs the pool over a range of task and thread counts (including fewer tasks than
+  *          threads, and none at all), with task costs that vary a lot by index (the early tasks
+  *          are slow, forcing the other threads to steal). Checks that every index runs exactly
+  *          once, that worker ids are in range and that the per-thread task counts add up to n.
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include "task_pool.h"
+#include "check.h"
+
+typedef struct {
+    uint32_t n;
+    int threads;
+    uint32_t *hits;             /* 各编号执行次数 | Runs per index */
+    uint32_t badWorker;
+    volatile uint32_t sink;
+} Job;
+
+static void task(void *ctx, uint32_t index, int worker) {
+    Job *job = ctx;
+    __atomic_fetch_add(&job->hits[index], 1u, __ATOMIC_RELAXED);
+    if (worker < 0 || worker >= job->threads) {
+        __atomic_fetch_add(&job->badWorker, 1u, __ATOMIC_RELAXED);
+    }
+    // 前 1/8 的任务比其余的慢约 100 倍 | The first eighth of the tasks are ~100x slower than the rest
+    uint32_t spin = index < job->n / 8 ? 20000u : 200u;
+    uint32_t x = index;
+    for (uint32_t i = 0; i < spin; i++) {
+        x = x * 1664525u + 1013904223u;
+    }
+    job->sink = x;
+}
+
+static void runCase(uint32_t n, int threads) {
+    Job job = {.n = n, .threads = threads};
+    job.hits = calloc(n ? n : 1, sizeof(uint32_t));
+    TaskPoolStats stats;
+    int ret = TaskPool_Run(n, threads, task, &job, &stats);
+    CHECK(ret == 0, "n=%u threads=%d returned %d", n, threads, ret);
+
+    uint32_t missing = 0, repeated = 0, total = 0, steals = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        missing += job.hits[i] == 0;
+        repeated += job.hits[i] > 1;
+    }
+    for (int k = 0; k < threads; k++) {
+        total += stats.tasks[k];
+        steals += stats.steals[k];
+    }
+    CHECK(missing == 0 && repeated == 0, "n=%u threads=%d: %u missing, %u repeated", n, threads, missing, repeated);
+    CHECK(job.badWorker == 0, "n=%u threads=%d: %u tasks saw a bad worker id", n, threads, job.badWorker);
+    CHECK(total == n, "n=%u threads=%d: stats count %u tasks", n, threads, total);
+    printf("  n=%-6u threads=%-3d steals %u\n", n, threads, steals);
+    free(job.hits);
+}
+
+int main(void) {
+    static const uint32_t counts[] = {0, 1, 3, 7, 64, 1000, 20000};
+    static const int threads[] = {1, 2, 3, 8, 33};
+
+    printf("exactly-once over task and thread counts\n");
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        for (size_t j = 0; j < sizeof(threads) / sizeof(threads[0]); j++) {
+            runCase(counts[i], threads[j]);
+        }
+    }
+
+    printf("bad arguments\n");
+    Job job = {0};
+    CHECK(TaskPool_Run(1, 0, task, &job, NULL) == -1, "0 threads accepted");
+    CHECK(TaskPool_Run(1, TASK_POOL_MAX_THREADS + 1, task, &job, NULL) == -1, "too many threads accepted");
+    CHECK(TaskPool_Run(1, 1, NULL, &job, NULL) == -1, "NULL task accepted");
+
+    return Check_Exit();
+}
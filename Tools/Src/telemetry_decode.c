@@ -0,0 +1,252 @@
+/**
+  * @file    telemetry_decode.c
+  * @brief   遥测抓包解码工具 | Telemetry capture decoder
+  *
+  * @note    用法 | Usage:
+  *          dnb_telemetry <capture|device> [-o out.csv] [-c column_dir] [-l log.dnbc] [-r raw_capture]
+  *          输入为普通文件时解码整个抓包；为串口/pty 时实时解码直到 Ctrl-C
+  *          A regular file is decoded in full; a serial device or pty is decoded live until Ctrl-C
+  *          -o  CSV 输出（默认标准输出） | CSV output (stdout by default)
+  *          -c  列式输出：每个字段一个小端原始数组 <name>.bin，外加 schema.txt
+  *              Columnar output: one little-endian raw array <name>.bin per field, plus schema.txt
+  *          -l  追加到分块列式日志（见 collog.h），可用 dnb_collog 查看 | Append to a chunked columnar log (see collog.h), viewable with dnb_collog
+  *          -r  实时模式下同时保存原始字节，便于之后重放 | In live mode also save the raw bytes for later replay
+  */
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "serial_port.h"
+#include "protocol.h"
+#include "telemetry.h"
+#include "collog.h"
+#include "log_schema.h"
+
+/* 字段描述，由 TELEMETRY_FIELDS 生成 | Field descriptors generated from TELEMETRY_FIELDS */
+typedef struct {
+    const char *name;
+    const char *tag;
+    size_t offset;
+    size_t size;
+} Field;
+
+static const Field fields[] = {
+#define TELEMETRY_FIELD(type, name, tag) {#name, tag, offsetof(TelemetryRecord, name), sizeof(type)},
+    TELEMETRY_FIELDS(TELEMETRY_FIELD)
+#undef TELEMETRY_FIELD
+};
+
+#define FIELD_COUNT (sizeof(fields) / sizeof(fields[0]))
+
+static volatile sig_atomic_t running = 1;
+
+static FILE *csv = NULL;
+static FILE *columns[FIELD_COUNT];
+static FILE *raw = NULL;
+static ColLogWriter colLog;
+static int colLogOpen = 0;
+
+/* 统计 | Statistics */
+static unsigned long records = 0;
+static unsigned long lost = 0;
+static unsigned long shortRecords = 0;
+static int lastSeq = -1;
+
+static void onSignal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static void printField(const Field *f, const uint8_t *p) {
+    if (strcmp(f->tag, "f32") == 0) {
+        fp32 v;
+        memcpy(&v, p, 4);
+        fprintf(csv, "%.6g", v);
+    } else if (strcmp(f->tag, "u32") == 0) {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        fprintf(csv, "%lu", (unsigned long)v);
+    } else if (strcmp(f->tag, "i16") == 0) {
+        int16_t v;
+        memcpy(&v, p, 2);
+        fprintf(csv, "%d", v);
+    } else if (strcmp(f->tag, "u16") == 0) {
+        uint16_t v;
+        memcpy(&v, p, 2);
+        fprintf(csv, "%u", v);
+    } else {
+        fprintf(csv, "%u", p[0]);
+    }
+}
+
+/**
+  * @brief   处理一帧遥测 | Handle one telemetry frame
+  */
+static void onRecord(const Frame *frame) {
+    // 旧固件的记录可能更短，缺失字段补零 | Records from older firmware may be shorter; missing fields are zero
+    uint8_t rec[sizeof(TelemetryRecord)] = {0};
+    if (frame->len < sizeof(TelemetryRecord)) shortRecords++;
+    memcpy(rec, frame->payload, frame->len < sizeof(rec) ? frame->len : sizeof(rec));
+
+    if (lastSeq >= 0) {
+        lost += (uint8_t)(frame->seq - lastSeq - 1);
+    }
+    lastSeq = frame->seq;
+    records++;
+
+    if (csv != NULL) {
+        for (size_t i = 0; i < FIELD_COUNT; i++) {
+            if (i > 0) fputc(',', csv);
+            printField(&fields[i], &rec[fields[i].offset]);
+        }
+        fputc('\n', csv);
+    }
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (columns[i] != NULL) {
+            fwrite(&rec[fields[i].offset], fields[i].size, 1, columns[i]);
+        }
+    }
+    if (colLogOpen) {
+        ColLogWriter_Append(&colLog, rec);
+    }
+}
+
+static void feed(FrameParser *parser, const uint8_t *buf, size_t len) {
+    Frame frame;
+    for (size_t i = 0; i < len; i++) {
+        if (FrameParser_Feed(parser, buf[i], &frame) && frame.type == MSG_TELEMETRY) {
+            onRecord(&frame);
+        }
+    }
+}
+
+static int openColumns(const char *dir) {
+    char path[512];
+    mkdir(dir, 0755);
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        snprintf(path, sizeof(path), "%s/%s.bin", dir, fields[i].name);
+        columns[i] = fopen(path, "wb");
+        if (columns[i] == NULL) {
+            perror(path);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void closeColumns(const char *dir) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/schema.txt", dir);
+    FILE *schema = fopen(path, "w");
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        fclose(columns[i]);
+        if (schema != NULL) {
+            fprintf(schema, "%s %s %lu\n", fields[i].name, fields[i].tag, records);
+        }
+    }
+    if (schema != NULL) fclose(schema);
+}
+
+int main(int argc, char **argv) {
+    const char *input = NULL;
+    const char *csvPath = NULL;
+    const char *columnDir = NULL;
+    const char *rawPath = NULL;
+    const char *logPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            columnDir = argv[++i];
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            logPath = argv[++i];
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rawPath = argv[++i];
+        } else if (input == NULL) {
+            input = argv[i];
+        } else {
+            input = NULL;
+            break;
+        }
+    }
+    if (input == NULL) {
+        fprintf(stderr, "usage: %s <capture|device> [-o out.csv] [-c column_dir] [-l log.dnbc] [-r raw_capture]\n", argv[0]);
+        return 2;
+    }
+
+    if (csvPath != NULL) {
+        csv = fopen(csvPath, "w");
+        if (csv == NULL) {
+            perror(csvPath);
+            return 1;
+        }
+    } else if (columnDir == NULL && logPath == NULL) {
+        csv = stdout;
+    }
+    if (columnDir != NULL && openColumns(columnDir) != 0) {
+        return 1;
+    }
+    if (logPath != NULL) {
+        int ret = ColLogWriter_Open(&colLog, logPath, &telemetryLogSchema);
+        if (ret != COLLOG_OK) {
+            fprintf(stderr, "%s: %s\n", logPath, ret == COLLOG_ERR_SCHEMA ? "holds a different stream" : "cannot open");
+            return 1;
+        }
+        colLogOpen = 1;
+    }
+    if (csv != NULL) {
+        for (size_t i = 0; i < FIELD_COUNT; i++) {
+            fprintf(csv, i > 0 ? ",%s" : "%s", fields[i].name);
+        }
+        fputc('\n', csv);
+    }
+
+    FrameParser parser;
+    FrameParser_Init(&parser);
+    uint8_t buf[4096];
+
+    struct stat st;
+    if (stat(input, &st) == 0 && S_ISREG(st.st_mode)) {
+        FILE *in = fopen(input, "rb");
+        if (in == NULL) {
+            perror(input);
+            return 1;
+        }
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+            feed(&parser, buf, n);
+        }
+        fclose(in);
+    } else {
+        int port = Serial_Open(input, 115200);
+        if (port < 0) {
+            perror(input);
+            return 1;
+        }
+        if (rawPath != NULL && (raw = fopen(rawPath, "wb")) == NULL) {
+            perror(rawPath);
+            return 1;
+        }
+        signal(SIGINT, onSignal);
+        while (running) {
+            int n = Serial_Read(port, buf, sizeof(buf), 100);
+            if (n < 0) break;
+            if (raw != NULL) fwrite(buf, 1, n, raw);
+            feed(&parser, buf, n);
+            if (csv == stdout) fflush(csv);
+        }
+        Serial_Close(port);
+        if (raw != NULL) fclose(raw);
+    }
+
+    if (csv != NULL && csv != stdout) fclose(csv);
+    if (columnDir != NULL) closeColumns(columnDir);
+    if (colLogOpen && ColLogWriter_Close(&colLog) != COLLOG_OK) perror(logPath);
+
+    fprintf(stderr, "records %lu, lost %lu, crc errors %lu, oversized %lu, short %lu\n",
+            records, lost, (unsigned long)parser.crcErrors, (unsigned long)parser.overflows, shortRecords);
+    return 0;
+}
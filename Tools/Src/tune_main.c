@@ -0,0 +1,537 @@
+/**
+  * @file    tune_main.c
+  * @brief   增益扫描与蒙特卡洛整定：在工作窃取线程池上并行跑成千上万次闭环仿真 | Gain sweep and Monte Carlo tuning: thousands of closed-loop simulations in parallel on a work-stealing pool
+  *
+  * @note    用法 | Usage:
+  *          dnb_tune [-g name=lo:hi]... [-c candidates] [-m episodes] [-r rounds] [-u uncertainty]
+  *                   [-w fall,rms,settle,energy] [-j threads] [-t seconds] [-s seed] [-k top]
+  *                   [-o report.csv] [--check]
+  *          每个候选是一组直立环、速度环和电机内环增益。第 0 个候选是固件默认值（基线），其余在
+  *          给定区间内按对数均匀的拉丁超立方采样。每个候选跑同一组 m 个回合：回合 i 的模型参数按
+  *          ±u 随机扰动（质量、质心高度、惯量、堵转力矩、空载转速），初始倾角和噪声种子也随机，
+  *          但对所有候选相同（公共随机数），候选之间的差别只来自增益。回合运行起步、加速、转弯、
+  *          停车的脚本。第 2 轮起在此前全部候选前 8 名的包络内重新采样（两边各放宽 25%）。
+  *          各轮回合相同，全部候选一起按得分排序：
+  *              score = w_fall·100·倒地率 + w_rms·倾角均方根(°) + w_settle·停车后稳定时间(s) + w_energy·电能
+  *          电能是电源侧功率 u·i 的积分，以堵转功率·秒为单位（i = u − ω/ω_0，回馈不计）。
+  *          停车后稳定时间：停车命令之后，|倾角| < 1° 且 |车速| < 2 cm/s 一直保持到结束所需的时间；
+  *          倒地或一直没稳定按剩余时长计。
+  *          任务编号 = 候选 × m + 回合，结果按编号存放，与线程数和窃取顺序无关。
+  *          Each candidate is one set of upright, velocity and motor loop gains. Candidate 0 is the
+  *          firmware defaults (the baseline); the rest are a log-uniform Latin hypercube over the
+  *          given ranges. Every candidate runs the same m episodes: episode i perturbs the plant by
+  *          ±u (mass, COM height, inertia, stall torque, no-load speed) and randomises the initial
+  *          tilt and noise seed, identically for every candidate (common random numbers), so the
+  *          candidates differ only in their gains. Episodes run a launch, speed-up, turn and stop
+  *          script. From round 2 on, candidates are resampled inside the envelope of the top 8 so
+  *          far (widened by 25% on each side). Every round runs the same episodes, so all
+  *          candidates are ranked together by
+  *              score = w_fall·100·fall rate + w_rms·RMS pitch (°) + w_settle·settling time (s) + w_energy·energy
+  *          Energy integrates the supply-side power u·i in stall-power seconds (i = u − ω/ω_0,
+  *          regeneration not credited). Settling time is how long after the stop command it takes
+  *          until |pitch| < 1° and |speed| < 2 cm/s hold to the end; a fall or never settling
+  *          counts the full remaining time.
+  *          Task index = candidate × m + episode and results are stored by index, so they do not
+  *          depend on the thread count or the steal order.
+  *          -g  增益区间，可重复；名称见下表 | Gain range, repeatable; names in the table below
+  *          -c  每轮候选数（默认 256） | Candidates per round (default 256)
+  *          -m  每个候选的回合数（默认 32） | Episodes per candidate (default 32)
+  *          -r  轮数（默认 2） | Rounds (default 2)
+  *          -u  模型参数扰动比例（默认 0.1） | Plant parameter uncertainty (default 0.1)
+  *          -w  得分权重（默认 1,1,0.5,20） | Score weights (default 1,1,0.5,20)
+  *          -j  线程数（默认为 CPU 核数） | Threads (default: CPU cores)
+  *          -t  每回合仿真时长（默认 10 s） | Simulated time per episode (default 10 s)
+  *          -s  随机种子（默认 1） | Random seed (default 1)
+  *          -k  打印前几名（默认 10） | Rows to print (default 10)
+  *          -o  完整排名写入 CSV | Write the full ranking as CSV
+  *          --check  再用单线程跑第 1 轮，结果必须逐位相同 | Rerun round 1 on one thread; the results must be bit-identical
+  */
+#include <math.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "robot.h"
+#include "command.h"
+#include "task_pool.h"
+
+#define PI              3.14159265358979
+#define REFINE_TOP      8               /**< 细化时参考的前几名 | Top candidates the refinement is built around */
+#define REFINE_WIDEN    0.25            /**< 细化包络两边放宽比例（对数域） | Refinement envelope widening per side (log domain) */
+#define SETTLE_PITCH    1.0             /**< 稳定判据：倾角 (°) | Settled: pitch */
+#define SETTLE_SPEED    0.02            /**< 稳定判据：车速 (m/s) | Settled: speed */
+#define TILT_SPREAD     0.05            /**< 初始倾角 ±(rad) | Initial tilt ± */
+
+typedef struct {
+    double time;
+    uint8_t cmd;
+} Event;
+
+/* 起步、加速、转弯、停车 | Launch, speed up, turn, stop */
+static const Event script[] = {
+        {0.5, CMD_FORWARD},
+        {0.5, CMD_SPEED_UP}, {0.5, CMD_SPEED_UP}, {0.5, CMD_SPEED_UP}, {0.5, CMD_SPEED_UP},
+        {3.0, CMD_LEFT},
+        {4.0, CMD_TURN_CLEAR},
+        {5.0, CMD_STOP},
+};
+
+#define SCRIPT_LEN  (sizeof(script) / sizeof(script[0]))
+#define STOP_TIME   5.0
+
+enum { G_ANGLE_KP, G_ANGLE_KD, G_VEL_KP, G_VEL_KI, G_MOTOR_KP, G_MOTOR_KI, GAIN_COUNT };
+
+/**
+  * @struct  GainRange
+  * @brief   一个增益的搜索区间 | Search range of one gain
+  */
+typedef struct {
+    const char *name;
+    double def;                 /**< 固件默认值 | Firmware default */
+    double lo, hi;
+} GainRange;
+
+static GainRange ranges[GAIN_COUNT] = {
+        {"angle_kp", BALANCE_ANGLE_KP, 30.0, 120.0},
+        {"angle_kd", BALANCE_ANGLE_KD, 1.0, 8.0},
+        {"vel_kp", BALANCE_VELOCITY_KP, 0.01, 0.15},
+        {"vel_ki", BALANCE_VELOCITY_KI, 0.0005, 0.006},
+        {"motor_kp", ROBOT_MOTOR_KP, 300.0, 1500.0},
+        {"motor_ki", ROBOT_MOTOR_KI, 5.0, 60.0},
+};
+
+/**
+  * @struct  Candidate
+  * @brief   一组增益及其汇总得分 | One gain set and its aggregate score
+  */
+typedef struct {
+    double gain[GAIN_COUNT];
+    int round;
+    double fallRate;
+    double rmsPitch;            /**< 各回合均值 (°) | Mean over episodes */
+    double settle;              /**< 各回合均值 (s) | Mean over episodes */
+    double energy;              /**< 各回合均值（堵转功率·秒） | Mean over episodes (stall-power seconds) */
+    double score;
+} Candidate;
+
+/**
+  * @struct  Scenario
+  * @brief   一个回合的随机条件，所有候选共用 | Random conditions of one episode, shared by all candidates
+  */
+typedef struct {
+    PlantParams pp;
+    double theta;
+    uint32_t seed;
+} Scenario;
+
+/**
+  * @struct  Outcome
+  * @brief   一个回合的结果 | Result of one episode
+  */
+typedef struct {
+    double rmsPitch;
+    double settle;
+    double energy;
+    uint32_t fell;
+    uint32_t steps;
+} Outcome;
+
+typedef struct {
+    const Candidate *cand;
+    const Scenario *scen;
+    Outcome *out;
+    uint32_t episodes;
+    double duration;
+} Sweep;
+
+static double weight[4] = {1.0, 1.0, 0.5, 20.0};
+
+/* 随机数 | Random numbers ---------------------------------------------------*/
+
+static uint64_t splitmix(uint64_t *s) {
+    uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/* [0, 1) */
+static double uniform(uint64_t *s) {
+    return (double)(splitmix(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* [-1, 1) */
+static double symmetric(uint64_t *s) {
+    return 2.0 * uniform(s) - 1.0;
+}
+
+/* 仿真 | Simulation ---------------------------------------------------------*/
+
+static void makeScenarios(Scenario *scen, uint32_t m, double uncertainty, uint64_t seed) {
+    uint64_t s = seed ^ 0x5CE7A210ull;
+    for (uint32_t i = 0; i < m; i++) {
+        PlantParams pp = Plant_DefaultParams();
+        double *scaled[] = {&pp.bodyMass, &pp.comHeight, &pp.bodyInertia, &pp.wheelMass, &pp.stallTorque, &pp.noLoadSpeed};
+        for (size_t k = 0; k < sizeof(scaled) / sizeof(scaled[0]); k++) {
+            *scaled[k] *= 1.0 + uncertainty * symmetric(&s);
+        }
+        scen[i] = (Scenario){pp, TILT_SPREAD * symmetric(&s), (uint32_t)splitmix(&s) | 1u};
+    }
+}
+
+/**
+  * @brief   电源侧功率，以堵转功率为单位 | Supply-side power in units of the stall power
+  */
+static double supplyPower(const Plant *p, int wheel, double duty) {
+    double half = p->p.track / 2.0;
+    double w = (p->xd + (wheel ? half : -half) * p->psid) / p->p.wheelRadius - p->thetad;
+    double power = duty * (duty - w / p->p.noLoadSpeed);
+    return power > 0.0 ? power : 0.0;
+}
+
+static void runEpisode(const Candidate *c, const Scenario *sc, double duration, Outcome *out) {
+    Robot robot;
+    Robot_Init(&robot, &sc->pp, sc->theta, sc->seed);
+    robot.control.balance.angleKp = (fp32)c->gain[G_ANGLE_KP];
+    robot.control.balance.angleKd = (fp32)c->gain[G_ANGLE_KD];
+    robot.control.balance.velocity.Kp = (fp32)c->gain[G_VEL_KP];
+    robot.control.balance.velocity.Ki = (fp32)c->gain[G_VEL_KI];
+    for (int i = 0; i < 2; i++) {
+        robot.motor[i].Kp = (fp32)c->gain[G_MOTOR_KP];
+        robot.motor[i].Ki = (fp32)c->gain[G_MOTOR_KI];
+    }
+
+    size_t next = 0;
+    double pitchSq = 0.0, energy = 0.0, unsettledUntil = STOP_TIME;
+    uint32_t ticks = 0;
+    *out = (Outcome){0};
+    for (double t = 0.0; t < duration; t += ROBOT_TICK) {
+        while (next < SCRIPT_LEN && script[next].time <= t + 1e-9) {
+            Motion_Dispatch(&robot.control.motion, script[next++].cmd);
+        }
+        Robot_Step(&robot);
+        ticks++;
+        double pitch = robot.plant.theta * 180.0 / PI;
+        pitchSq += pitch * pitch;
+        energy += (supplyPower(&robot.plant, 0, robot.duty[0]) + supplyPower(&robot.plant, 1, robot.duty[1])) * ROBOT_TICK;
+        if (t + 1e-9 >= STOP_TIME && (fabs(pitch) >= SETTLE_PITCH || fabs(robot.plant.xd) >= SETTLE_SPEED)) {
+            unsettledUntil = t + ROBOT_TICK;
+        }
+        if (fabs(pitch) > BALANCE_FALL_ANGLE) {
+            out->fell = 1;
+            unsettledUntil = duration;
+            break;
+        }
+    }
+    out->rmsPitch = sqrt(pitchSq / (double)(ticks ? ticks : 1));
+    out->settle = fmax(fmin(unsettledUntil, duration) - STOP_TIME, 0.0);
+    out->energy = energy;
+    out->steps = ticks;
+}
+
+static void episodeTask(void *ctx, uint32_t index, int worker) {
+    (void)worker;
+    const Sweep *sw = ctx;
+    uint32_t c = index / sw->episodes, m = index % sw->episodes;
+    runEpisode(&sw->cand[c], &sw->scen[m], sw->duration, &sw->out[index]);
+}
+
+static double nowSec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+  * @brief   把各回合结果汇总到候选上 | Aggregate the episode results into the candidates
+  */
+static void scoreCandidates(Candidate *cand, uint32_t n, const Outcome *out, uint32_t m) {
+    for (uint32_t c = 0; c < n; c++) {
+        double fell = 0.0, rms = 0.0, settle = 0.0, energy = 0.0;
+        for (uint32_t i = 0; i < m; i++) {
+            const Outcome *o = &out[(size_t)c * m + i];
+            fell += o->fell;
+            rms += o->rmsPitch;
+            settle += o->settle;
+            energy += o->energy;
+        }
+        Candidate *k = &cand[c];
+        k->fallRate = fell / m;
+        k->rmsPitch = rms / m;
+        k->settle = settle / m;
+        k->energy = energy / m;
+        k->score = weight[0] * 100.0 * k->fallRate + weight[1] * k->rmsPitch
+                   + weight[2] * k->settle + weight[3] * k->energy;
+    }
+}
+
+static int byScore(const void *a, const void *b) {
+    double sa = ((const Candidate *)a)->score, sb = ((const Candidate *)b)->score;
+    return (sa > sb) - (sa < sb);
+}
+
+/* 采样 | Sampling ------------------------------------------------------------*/
+
+/**
+  * @brief   在 [lo, hi] 的对数域里做拉丁超立方采样，写入 cand[0..n-1] | Log-domain Latin hypercube over [lo, hi] into cand[0..n-1]
+  */
+static void sampleCandidates(Candidate *cand, uint32_t n, const double *lo, const double *hi, int round, uint64_t *s) {
+    uint32_t *perm = malloc((n ? n : 1) * sizeof(uint32_t));
+    for (uint32_t c = 0; c < n; c++) {
+        cand[c] = (Candidate){.round = round};
+    }
+    for (int g = 0; g < GAIN_COUNT; g++) {
+        for (uint32_t c = 0; c < n; c++) {
+            perm[c] = c;
+        }
+        for (uint32_t c = n; c > 1; c--) {
+            uint32_t j = (uint32_t)(splitmix(s) % c);
+            uint32_t tmp = perm[c - 1];
+            perm[c - 1] = perm[j];
+            perm[j] = tmp;
+        }
+        double a = log(lo[g]), b = log(hi[g]);
+        for (uint32_t c = 0; c < n; c++) {
+            double u = (perm[c] + uniform(s)) / n;
+            cand[c].gain[g] = exp(a + (b - a) * u);
+        }
+    }
+    free(perm);
+}
+
+/**
+  * @brief   前几名的对数包络，两边放宽 | Log envelope of the top candidates, widened on both sides
+  */
+static void refineRanges(const Candidate *ranked, uint32_t n, double *lo, double *hi) {
+    uint32_t top = n < REFINE_TOP ? n : REFINE_TOP;
+    for (int g = 0; g < GAIN_COUNT; g++) {
+        double a = log(ranked[0].gain[g]), b = a;
+        for (uint32_t c = 1; c < top; c++) {
+            double v = log(ranked[c].gain[g]);
+            a = fmin(a, v);
+            b = fmax(b, v);
+        }
+        double pad = REFINE_WIDEN * (b - a);
+        lo[g] = exp(a - pad);
+        hi[g] = exp(b + pad);
+    }
+}
+
+/* 命令行与报告 | Command line and report -------------------------------------*/
+
+static int parseRange(const char *arg) {
+    const char *eq = strchr(arg, '=');
+    if (!eq) return -1;
+    for (int g = 0; g < GAIN_COUNT; g++) {
+        if (strlen(ranges[g].name) == (size_t)(eq - arg) && strncmp(arg, ranges[g].name, (size_t)(eq - arg)) == 0) {
+            double lo, hi;
+            if (sscanf(eq + 1, "%lf:%lf", &lo, &hi) != 2 || lo <= 0.0 || hi < lo) return -1;
+            ranges[g].lo = lo;
+            ranges[g].hi = hi;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-g name=lo:hi]... [-c candidates] [-m episodes] [-r rounds] [-u uncertainty]\n"
+                    "       [-w fall,rms,settle,energy] [-j threads] [-t seconds] [-s seed] [-k top]\n"
+                    "       [-o report.csv] [--check]\ngains (lo > 0, sampled log-uniform):\n", prog);
+    for (int g = 0; g < GAIN_COUNT; g++) {
+        fprintf(stderr, "  %-9s default %-8g range %g:%g\n", ranges[g].name, ranges[g].def, ranges[g].lo, ranges[g].hi);
+    }
+}
+
+static void printRow(const char *label, const Candidate *c) {
+    printf("%-6s %3d %8.3f %5.1f%% %6.2f %6.2f %7.4f", label, c->round, c->score, 100.0 * c->fallRate,
+           c->rmsPitch, c->settle, c->energy);
+    for (int g = 0; g < GAIN_COUNT; g++) {
+        printf(" %9.4g", c->gain[g]);
+    }
+    printf("\n");
+}
+
+static int writeCsv(const char *path, const Candidate *ranked, uint32_t n) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "rank,round,score,fall_rate,rms_pitch_deg,settle_s,energy");
+    for (int g = 0; g < GAIN_COUNT; g++) {
+        fprintf(f, ",%s", ranges[g].name);
+    }
+    fprintf(f, "\n");
+    for (uint32_t c = 0; c < n; c++) {
+        const Candidate *k = &ranked[c];
+        fprintf(f, "%u,%d,%.6f,%.6f,%.6f,%.6f,%.6f", c + 1, k->round, k->score, k->fallRate, k->rmsPitch, k->settle, k->energy);
+        for (int g = 0; g < GAIN_COUNT; g++) {
+            fprintf(f, ",%.6g", k->gain[g]);
+        }
+        fprintf(f, "\n");
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    uint32_t candidates = 256, episodes = 32, top = 10;
+    int rounds = 2, check = 0;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = cores > 0 ? (int)cores : 1;
+    double duration = 10.0, uncertainty = 0.1;
+    uint64_t seed = 1;
+    const char *csv = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            if (parseRange(argv[++i]) != 0) {
+                fprintf(stderr, "bad gain range '%s'\n", argv[i]);
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            candidates = (uint32_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            episodes = (uint32_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            uncertainty = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%lf,%lf,%lf,%lf", &weight[0], &weight[1], &weight[2], &weight[3]) != 4) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint64_t)strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            top = (uint32_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            csv = argv[++i];
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (candidates < 2 || episodes == 0 || rounds < 1 || threads < 1 || threads > TASK_POOL_MAX_THREADS
+        || duration <= STOP_TIME || uncertainty < 0.0 || uncertainty >= 1.0
+        || (uint64_t)candidates * episodes > UINT32_MAX) {
+        fprintf(stderr, "need >= 2 candidates, >= 1 episode and round, 1..%d threads, more than %.0f s, 0 <= u < 1\n",
+                TASK_POOL_MAX_THREADS, STOP_TIME);
+        return 2;
+    }
+
+    uint32_t tasks = candidates * episodes;
+    Candidate *all = malloc((size_t)candidates * (size_t)rounds * sizeof(Candidate));
+    Scenario *scen = malloc(episodes * sizeof(Scenario));
+    Outcome *out = malloc((size_t)tasks * sizeof(Outcome));
+    Outcome *single = check ? malloc((size_t)tasks * sizeof(Outcome)) : NULL;
+    if (!all || !scen || !out || (check && !single)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    makeScenarios(scen, episodes, uncertainty, seed);
+
+    double lo[GAIN_COUNT], hi[GAIN_COUNT];
+    for (int g = 0; g < GAIN_COUNT; g++) {
+        lo[g] = ranges[g].lo;
+        hi[g] = ranges[g].hi;
+    }
+
+    printf("%u candidates x %u episodes x %d rounds, %.1f s each, plant uncertainty +-%.0f%%, %d threads\n",
+           candidates, episodes, rounds, duration, 100.0 * uncertainty, threads);
+    uint64_t rs = seed;
+    uint32_t evaluated = 0;
+    Candidate baseline = {0};
+    unsigned long steps = 0;
+    double wallTotal = 0.0;
+    int ret = 0;
+    for (int r = 0; r < rounds; r++) {
+        Candidate *cand = &all[evaluated];
+        // 第 1 轮的第 0 个候选是固件默认值 | Candidate 0 of round 1 is the firmware defaults
+        uint32_t base = r == 0;
+        sampleCandidates(cand + base, candidates - base, lo, hi, r + 1, &rs);
+        if (r == 0) {
+            cand[0] = (Candidate){.round = 0};
+            for (int g = 0; g < GAIN_COUNT; g++) {
+                cand[0].gain[g] = ranges[g].def;
+            }
+        }
+
+        Sweep sw = {cand, scen, out, episodes, duration};
+        TaskPoolStats stats;
+        double t0 = nowSec();
+        if (TaskPool_Run(tasks, threads, episodeTask, &sw, &stats) != 0) {
+            fprintf(stderr, "could not start the thread pool\n");
+            return 1;
+        }
+        double wall = nowSec() - t0;
+        wallTotal += wall;
+
+        uint32_t minTasks = UINT32_MAX, maxTasks = 0, steals = 0;
+        for (int k = 0; k < threads; k++) {
+            minTasks = stats.tasks[k] < minTasks ? stats.tasks[k] : minTasks;
+            maxTasks = stats.tasks[k] > maxTasks ? stats.tasks[k] : maxTasks;
+            steals += stats.steals[k];
+        }
+        for (uint32_t i = 0; i < tasks; i++) {
+            steps += out[i].steps;
+        }
+        printf("round %d: %u episodes in %.2f s (%.0f episodes/s), tasks per thread %u..%u, %u steals\n",
+               r + 1, tasks, wall, tasks / wall, minTasks, maxTasks, steals);
+
+        if (check && r == 0) {
+            double wall1 = nowSec();
+            TaskPool_Run(tasks, 1, episodeTask, &(Sweep){cand, scen, single, episodes, duration}, NULL);
+            wall1 = nowSec() - wall1;
+            int same = memcmp(single, out, (size_t)tasks * sizeof(Outcome)) == 0;
+            printf("round 1 on 1 thread: %.2f s (%.2fx); results %s\n", wall1, wall1 / wall,
+                   same ? "bit-identical" : "DIFFER");
+            ret = same ? 0 : 1;
+        }
+
+        scoreCandidates(cand, candidates, out, episodes);
+        if (r == 0) {
+            baseline = cand[0];
+        }
+        evaluated += candidates;
+        qsort(all, evaluated, sizeof(Candidate), byScore);
+        refineRanges(all, evaluated, lo, hi);
+    }
+
+    printf("\n%-6s %3s %8s %6s %6s %6s %7s", "rank", "rnd", "score", "fall", "rms", "settle", "energy");
+    for (int g = 0; g < GAIN_COUNT; g++) {
+        printf(" %9s", ranges[g].name);
+    }
+    printf("\n%-6s %3s %8s %6s %6s %6s %7s\n", "", "", "", "", "(deg)", "(s)", "(P*s)");
+    for (uint32_t c = 0; c < evaluated && c < top; c++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%u", c + 1);
+        printRow(label, &all[c]);
+    }
+    uint32_t baseRank = 0;
+    while (baseRank < evaluated && all[baseRank].round != 0) {
+        baseRank++;
+    }
+    printRow("base", &baseline);
+    printf("baseline ranks %u of %u; best score %.3f vs %.3f\n", baseRank + 1, evaluated, all[0].score, baseline.score);
+    printf("%lu robot-steps in %.2f s wall: %.2f M robot-steps/s on %d threads\n",
+           steps, wallTotal, (double)steps / wallTotal * 1e-6, threads);
+
+    if (csv && writeCsv(csv, all, evaluated) != 0) {
+        ret = 1;
+    }
+    free(all);
+    free(scen);
+    free(out);
+    free(single);
+    return ret;
+}
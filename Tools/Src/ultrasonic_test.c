@@ -0,0 +1,164 @@
+/**
+  * @file    ultrasonic_test.c
+  * @brief   超声波测距状态机的合成回波测试 | Synthetic-echo test of the ultrasonic ranging state machine
+  *
+  * @note    用法 | Usage: dnb_ultrasonic_test
+  *          按固件的方式驱动 ultrasonic.c：10 ms 控制周期里调用触发，回波边沿和超时按时间顺序
+  *          以 16 位 1 µs 计数喂入（覆盖计数回绕）。每个场景检查发布的距离、有效标志和时间戳
+  *          Drives ultrasonic.c the way the firmware does: the trigger is requested from a 10 ms
+  *          control tick, echo edges and timeouts are fed in time order as 16-bit 1 µs counts
+  *          (so the counter wraps). Each scenario checks the published distance, valid flag and
+  *          timestamp
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "ultrasonic.h"
+#include "check.h"
+
+#define TICK_US         10000       /* 控制周期 | Control period */
+#define SENSOR_DELAY_US 460         /* 触发到回波上升沿（8 个 40 kHz 脉冲） | Trigger to echo rise (eight 40 kHz bursts) */
+#define NO_ECHO         (-1)
+#define CYCLE_US        (ULTRASONIC_PERIOD_MS * 1000)
+
+/* 从 0 开始时第 n 次触发的时刻 | Time of the n-th trigger when starting from 0 */
+#define TRIGGER_AT(n)   (TICK_US + (uint64_t)(n) * CYCLE_US)
+
+/* 回波模型：第 n 次触发的回波宽度 (µs)，NO_ECHO 表示无回波 | Echo model: echo width for the n-th trigger, NO_ECHO for none */
+typedef int (*EchoModel)(int n);
+
+typedef struct {
+    Ultrasonic u;
+    uint64_t now;               /* 仿真时间 (µs) | Simulated time */
+    int n;                      /* 触发次数 | Triggers so far */
+    uint64_t rise, fall, timeout;
+    uint32_t lastTriggerMs;
+} Sim;
+
+static void simInit(Sim *s, uint64_t start) {
+    s->u = newUltrasonic();
+    s->now = start;
+    s->n = 0;
+    s->rise = s->fall = s->timeout = UINT64_MAX;
+}
+
+/**
+  * @brief   推进到 until，按时间顺序处理控制周期、边沿和超时 | Run to until, handling ticks, edges and timeouts in time order
+  */
+static void simRun(Sim *s, EchoModel model, uint64_t until) {
+    uint64_t tick = (s->now / TICK_US + 1) * TICK_US;
+    while (s->now < until) {
+        uint64_t next = tick;
+        if (s->rise < next) next = s->rise;
+        if (s->fall < next) next = s->fall;
+        if (s->timeout < next) next = s->timeout;
+        s->now = next;
+
+        if (next == s->rise) {
+            s->rise = UINT64_MAX;
+            Ultrasonic_Edge(&s->u, TRUE, (uint16_t)next);
+        } else if (next == s->fall) {
+            s->fall = UINT64_MAX;
+            Ultrasonic_Edge(&s->u, FALSE, (uint16_t)next);
+        } else if (next == s->timeout) {
+            s->timeout = UINT64_MAX;
+            Ultrasonic_Timeout(&s->u);
+        } else {
+            tick += TICK_US;
+            if (Ultrasonic_Trigger(&s->u, (uint16_t)next, (uint32_t)(next / 1000))) {
+                int width = model(s->n++);
+                s->lastTriggerMs = (uint32_t)(next / 1000);
+                s->timeout = next + ULTRASONIC_TIMEOUT_US;
+                if (width != NO_ECHO) {
+                    s->rise = next + SENSOR_DELAY_US;
+                    s->fall = s->rise + (uint64_t)width;
+                }
+            }
+        }
+    }
+}
+
+static int cm(double d) { return (int)lround(d * ULTRASONIC_US_PER_CM); }
+
+static int steady(int n) { return cm(50.0) + (n % 3) - 1; }
+static int outliers(int n) { return (n % 4 == 2) ? cm(12.0) : cm(80.0); }
+static int dropouts(int n) { return (n >= 10 && n < 12) || (n >= 20 && n < 23) ? NO_ECHO : cm(35.0); }
+static int farAway(int n) { (void)n; return 36000; }    /* 无障碍时 HC-SR04 给出约 38 ms 的脉冲 | With nothing in range the HC-SR04 outputs a ~38 ms pulse */
+static int stepChange(int n) { return n < 10 ? cm(60.0) : cm(20.0); }
+static int glitch(int n) { return (n % 2) ? 40 : cm(150.0); }
+
+static void expectDistance(const char *name, Sim *s, double want, double tol) {
+    UltrasonicReading r;
+    Ultrasonic_Read(&s->u, &r);
+    CHECK(r.valid, "%s: reading not valid", name);
+    CHECK(fabs(r.distance - want) <= tol, "%s: distance %.2f cm, want %.2f", name, r.distance, want);
+}
+
+int main(void) {
+    Sim s;
+    UltrasonicReading r;
+
+    /* 1. 稳定目标，±1 µs 抖动；起点靠近计数回绕 | Steady target, ±1 µs jitter; start near the counter wrap */
+    printf("steady\n");
+    simInit(&s, 65000);
+    simRun(&s, steady, 2000000);
+    expectDistance("steady", &s, 50.0, 0.1);
+    Ultrasonic_Read(&s.u, &r);
+    CHECK(r.timestamp == s.lastTriggerMs, "steady: timestamp %u, want %u", r.timestamp, s.lastTriggerMs);
+    CHECK(s.u.stats.triggers == (uint32_t)s.n && s.u.stats.echoes == s.u.stats.triggers,
+          "steady: %u triggers, %u echoes", s.u.stats.triggers, s.u.stats.echoes);
+    CHECK(abs(s.n - 2000 / ULTRASONIC_PERIOD_MS) <= 1, "steady: %d triggers in 2 s", s.n);
+
+    /* 2. 每 4 次一个近处假回波，中值滤掉 | A near false echo every 4th cycle is removed by the median */
+    printf("outliers\n");
+    simInit(&s, 0);
+    simRun(&s, outliers, 1000000);
+    expectDistance("outliers", &s, 80.0, 0.1);
+
+    /* 3. 丢 2 次仍有效，丢 3 次报告无障碍，之后恢复 | 2 misses stay valid, 3 report clear, then recover */
+    printf("dropouts\n");
+    simInit(&s, 0);
+    simRun(&s, dropouts, TRIGGER_AT(12) - TICK_US);
+    expectDistance("dropouts (2 missed)", &s, 35.0, 0.1);
+    simRun(&s, dropouts, TRIGGER_AT(23) - TICK_US);
+    Ultrasonic_Read(&s.u, &r);
+    CHECK(!r.valid, "dropouts: still valid after %d misses", ULTRASONIC_MAX_MISSES);
+    simRun(&s, dropouts, 2000000);
+    expectDistance("dropouts (recovered)", &s, 35.0, 0.1);
+    CHECK(s.u.stats.timeouts == 5, "dropouts: %u timeouts, want 5", s.u.stats.timeouts);
+
+    /* 4. 超量程的长回波：超时后到来的下降沿被丢弃 | Out-of-range long echo: the falling edge after the timeout is dropped */
+    printf("far away\n");
+    simInit(&s, 0);
+    simRun(&s, farAway, 1000000);
+    Ultrasonic_Read(&s.u, &r);
+    CHECK(!r.valid, "far away: reported %.1f cm", r.distance);
+    CHECK(s.u.stats.echoes == 0 && s.u.stats.rejected + 1 >= s.u.stats.triggers,
+          "far away: %u echoes, %u rejected", s.u.stats.echoes, s.u.stats.rejected);
+
+    /* 5. 阶跃：中值在 N/2+1 次测量内跟上 | Step: the median follows within N/2+1 measurements */
+    printf("step\n");
+    simInit(&s, 0);
+    simRun(&s, stepChange, TRIGGER_AT(10) - TICK_US);
+    expectDistance("step (before)", &s, 60.0, 0.1);
+    simRun(&s, stepChange, TRIGGER_AT(10 + ULTRASONIC_MEDIAN_N / 2 + 1) - TICK_US);
+    expectDistance("step (after)", &s, 20.0, 0.1);
+
+    /* 6. 过短的干扰脉冲被拒绝 | Too-short glitch pulses are rejected */
+    printf("glitch\n");
+    simInit(&s, 0);
+    simRun(&s, glitch, 1000000);
+    expectDistance("glitch", &s, 150.0, 0.1);
+    CHECK(s.u.stats.rejected == s.u.stats.echoes || s.u.stats.rejected + 1 == s.u.stats.echoes,
+          "glitch: %u rejected, %u echoes", s.u.stats.rejected, s.u.stats.echoes);
+
+    /* 7. 测量进行中再次触发被忽略 | Triggering while a measurement is in flight is ignored */
+    printf("busy\n");
+    Ultrasonic u = newUltrasonic();
+    CHECK(Ultrasonic_Trigger(&u, 100, 0), "busy: first trigger refused");
+    CHECK(!Ultrasonic_Trigger(&u, 200, 100), "busy: trigger accepted while waiting for the echo");
+    Ultrasonic_Timeout(&u);
+    CHECK(Ultrasonic_Trigger(&u, 300, 100), "busy: trigger refused after the timeout");
+
+    return Check_Exit();
+}
@@ -8,12 +8,35 @@
   * @brief   平衡目标角度校准接口 | Interface for balancing target angle update
   */
 
+#define BALANCE_TARGET_LEARNING_RATE  0.00001f  /**< 默认学习率 | Default learning rate */
+#define BALANCE_TARGET_SPEED_ALPHA    0.98f     /**< 默认速度滤波系数 | Default speed filter coefficient */
+#define BALANCE_TARGET_LIMIT          5.0f      /**< 目标角度限幅 (°) | Target angle limit */
+
+/**
+  * @struct  BalanceTarget
+  * @brief   平衡目标角度自学习状态 | Balance target angle self-learning state
+  */
+typedef struct {
+    float angleTarget;      /**< 自学习后目标角度 (°) | Learned target angle */
+    float learningRate;     /**< 学习率，数值越小调整越慢 | Learning rate; smaller value → slower adjustment */
+    float speedFilter;      /**< 一阶滤波后速度 | First-order filtered speed */
+    float speedAlpha;       /**< 滤波系数（越接近 1 越平滑） | Filter coefficient (closer to 1 → smoother) */
+} BalanceTarget;
+
+/**
+  * @brief   创建自学习状态 | Create the self-learning state
+  * @param   bias  初始目标角度（机械平衡偏置） | Initial target angle (mechanical balance bias)
+  * @return  自学习状态 | Self-learning state
+  */
+BalanceTarget newBalanceTarget(float bias);
+
 /**
   * @brief   根据左右轮速度更新平衡目标角度 | Update balance target angle from wheel speeds
+  * @param   self    自学习状态指针 | Pointer to self-learning state
   * @param   speed_l 左轮速度 | Left wheel speed
   * @param   speed_r 右轮速度 | Right wheel speed
   * @return  更新后的目标角度 | Updated target angle
   */
-float update_balance_target(float speed_l, float speed_r);
+float BalanceTarget_Update(BalanceTarget *self, float speed_l, float speed_r);
 
 #endif /* _CALIBRATE_ANGLE_H_ */
@@ -1,10 +1,50 @@
 #ifndef _MPU_H
 #define _MPU_H
 
+#include <stdint.h>
+
+/* MPU6500_Init_Poll 的返回值：尚未完成 | MPU6500_Init_Poll return value: not finished yet */
+#define MPU6500_INIT_BUSY (1)
+
+/* 阻塞初始化，返回 0 或错误码 | Blocking init, returns 0 or an error code */
 int MPU_6500_Init(void);
 
+/* 分步初始化：Start 后反复调用 Poll，每次执行一步，直到返回 0（完成）或负的错误码。
+ * 传感器在 MCU 复位时保持供电且 DMP 签名匹配时走热启动，不再上传 DMP 固件。
+ * Staged init: call Poll repeatedly after Start, one stage per call, until it returns 0 (done)
+ * or a negative error code. When the sensor kept power through the MCU reset and the DMP
+ * signature matches, a warm boot skips the DMP firmware upload. */
+void MPU6500_Init_Start(void);
+
+int MPU6500_Init_Poll(void);
+
+/* 1：上次初始化为热启动 | 1 if the last init was a warm boot */
+int MPU6500_Warm_Boot(void);
+
+/* 上次初始化上传 DMP 固件的耗时 (ms)，热启动为 0 | Time the last init spent uploading the DMP firmware (ms), 0 after a warm boot */
+uint32_t MPU6500_DMP_Load_Ms(void);
+
 int
 MPU6500_DMP_Get_Data(float *pitch, float *roll, float *yaw, float *ax, float *ay, float *az, float *gyrox, float *gyroy,
                      float *gyroz);
 
+/* Q30 四元数换算为欧拉角 (°)，MPU6500_DMP_Get_Data 使用 | Q30 quaternion to Euler angles (degrees), as MPU6500_DMP_Get_Data uses it */
+void MPU6500_Quat_To_Euler(const long *quat, float *pitch, float *roll, float *yaw);
+
+int MPU6500_Set_Bias(long *gyro, long *accel);
+
+uint32_t MPU6500_FIFO_Resyncs(void);
+
+/* 最近一次成功读出的 DMP 数据包的原始值，传感器日志按 count 判断本周期是否读到新包
+ * Raw values of the last DMP packet read successfully; the sensor log uses count to tell
+ * whether this period read a fresh packet */
+typedef struct {
+  uint32_t count;       /* 成功读出的包数 | Packets read so far */
+  int32_t quat[4];      /* Q30 四元数 | Q30 quaternion */
+  int16_t accel[3];     /* 加速度原始值 | Raw acceleration */
+  int16_t gyro[3];      /* 角速度原始值 | Raw angular rate */
+} MPU6500_Raw;
+
+const MPU6500_Raw *MPU6500_DMP_Last_Raw(void);
+
 #endif
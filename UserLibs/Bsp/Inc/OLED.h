@@ -24,10 +24,16 @@
 void OLED_Init(void);
 
 /*更新函数*/
+/*只把显存中变化过的区域排入发送队列，实际传输由 OLED_Poll 在后台完成*/
 void OLED_Update(void);
 
 void OLED_UpdateArea(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height);
 
+/*后台发送函数，在主循环中反复调用，每次最多启动一次 DMA 传输*/
+void OLED_Poll(void);
+
+uint8_t OLED_IsIdle(void);
+
 /*显存控制函数*/
 void OLED_Clear(void);
 
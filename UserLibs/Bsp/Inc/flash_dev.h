@@ -0,0 +1,26 @@
+#ifndef FLASH_DEV_H_
+#define FLASH_DEV_H_
+
+#include "main.h"
+#include "param_store.h"
+
+/**
+  * @file    flash_dev.h
+  * @brief   片上 Flash 参数区后端 | On-chip flash backend for the parameter area
+  */
+
+/* 参数区使用扇区 6、7（各 128 KB），链接脚本中已从 FLASH 区域划出
+   Parameter area uses sectors 6 and 7 (128 KB each), carved out of FLASH in the linker script */
+#define PARAM_FLASH_SECTOR_0     FLASH_SECTOR_6
+#define PARAM_FLASH_SECTOR_1     FLASH_SECTOR_7
+#define PARAM_FLASH_ADDR_0       0x08040000u
+#define PARAM_FLASH_ADDR_1       0x08060000u
+#define PARAM_FLASH_SECTOR_SIZE  0x20000u
+
+/**
+  * @brief   创建片上 Flash 后端 | Create the on-chip flash backend
+  * @return  Flash 后端对象 | Flash backend object
+  */
+FlashDev newFlashDev(void);
+
+#endif /* FLASH_DEV_H_ */
@@ -0,0 +1,38 @@
+#ifndef HCSR04_H_
+#define HCSR04_H_
+
+#include "main.h"
+#include "ultrasonic.h"
+
+/**
+  * @file    hcsr04.h
+  * @brief   HC-SR04 超声波传感器（TIM4，无忙等） | HC-SR04 ultrasonic sensor (TIM4, no busy-waiting)
+  *
+  * @note    TIM4 以 1 MHz 自由运行，从不停止：
+  *          CH1 (PB6, TRIG) 先强制输出高电平，再以"比较匹配变低"模式在 10 µs 后由硬件拉低；
+  *          CH2 (PB7, ECHO) 双沿输入捕获；CH3（无引脚）比较中断作为超时。
+  *          TIM4 free-runs at 1 MHz and is never stopped:
+  *          CH1 (PB6, TRIG) is forced high, then switched to inactive-on-match so hardware drops
+  *          it 10 µs later; CH2 (PB7, ECHO) captures both edges; CH3 (no pin) compare is the timeout.
+  */
+
+#define HCSR04_TIM              htim4
+#define HCSR04_TRIG_US          10      /**< 触发脉宽 (µs) | Trigger pulse width */
+
+/**
+  * @brief   启动定时器和捕获中断 | Start the timer and capture interrupts
+  */
+void HC_Init(void);
+
+/**
+  * @brief   触发一次测量（立即返回，未到周期或测量未结束时忽略） | Trigger a measurement (returns at once; ignored until the cycle has elapsed and the last one finished)
+  */
+void HC_trig(void);
+
+/**
+  * @brief   读取最新障碍距离 | Read the latest obstacle distance
+  * @param   reading  输出读数 | Output reading
+  */
+void HC_Read(UltrasonicReading *reading);
+
+#endif /* HCSR04_H_ */
@@ -0,0 +1,99 @@
+#ifndef I2C_BUS_H_
+#define I2C_BUS_H_
+
+#include "main.h"
+#include "i2c_arbiter.h"
+
+/**
+  * @file    i2c_bus.h
+  * @brief   I2C1 仲裁后端（MPU6500 与 OLED 共用） | I2C1 arbiter backend (shared by the MPU6500 and the OLED)
+  *
+  * @note    写入走 DMA，读取走中断，段结束的回调里直接启动下一段。MPU 驱动仍是阻塞接口：
+  *          请求以最高优先级排队，最多等 OLED 的一段传输。
+  *          Writes use DMA and reads use interrupts; the next segment is started straight from
+  *          the completion callback. The MPU driver keeps its blocking interface: its requests
+  *          queue at top priority and wait for at most one OLED segment.
+  *
+  *          总线运行在 400 kHz。启动前 BUSY 不释放（SDA 或 SCL 被拉住）、传输超时、NACK 或总线错误都会让
+  *          当前请求失败，随后在线程上下文中恢复：复位外设，用 GPIO 打出最多 9 个时钟和一个 STOP，
+  *          再重新初始化，总共不超过约 1 ms。IMU 请求失败后，MPU6500 层在下次读取前复位 DMP FIFO。
+  *          The bus runs at 400 kHz. BUSY not clearing before a start (SDA or SCL held), a segment
+  *          timeout, a NACK or a bus error fails the current request, and the bus is then
+  *          recovered in thread context: the peripheral is reset, up to nine clocks and a STOP
+  *          are toggled out by GPIO and it is initialised again, all within about 1 ms. After a
+  *          failed IMU request the MPU6500 layer resets the DMP FIFO before its next read.
+  */
+
+#define I2C_BUS_HANDLE          hi2c1
+#define I2C_BUS_GPIO            GPIOB
+#define I2C_BUS_SCL_PIN         GPIO_PIN_8
+#define I2C_BUS_SDA_PIN         GPIO_PIN_9
+
+#define I2C_BUS_SEGMENT         16      /**< 段长上限，400 kHz 下约 0.45 ms | Segment limit, ~0.45 ms at 400 kHz */
+#define I2C_BUS_TIMEOUT_MS      5       /**< 一段传输的最长时间（不计数据字节） | Longest time a segment may take, data bytes aside */
+#define I2C_BUS_TIMEOUT_BYTE_US 50      /**< 每个数据字节另加的时间（400 kHz 下 22.5 µs） | Extra time per data byte (22.5 µs at 400 kHz) */
+#define I2C_BUS_IDLE_US         50      /**< 启动前等待上一次 STOP 结束的最长时间 | Longest wait for the previous STOP before a start */
+#define I2C_BUS_RECOVER_HALF_US 5       /**< 恢复时钟半周期（100 kHz） | Recovery clock half period (100 kHz) */
+
+/**
+  * @struct  I2CBusCounters
+  * @brief   按原因统计的总线错误 | Bus errors by cause
+  * @note    失败请求和恢复次数见 i2cArbiter.stats / recoveries | Failed requests and recoveries are in i2cArbiter.stats / recoveries
+  */
+typedef struct {
+    uint32_t nacks;             /**< 从机无应答 | Slave NACKs */
+    uint32_t busErrors;         /**< 总线错误、仲裁丢失、溢出 | Bus errors, arbitration loss, overruns */
+    uint32_t timeouts;          /**< 段超时 | Segment timeouts */
+    uint32_t stuck;             /**< 启动前总线仍忙 | Bus still busy before a start */
+    uint32_t clockOuts;         /**< 需要打时钟才释放的恢复 | Recoveries that needed clock pulses */
+} I2CBusCounters;
+
+extern I2CArbiter i2cArbiter;
+extern I2CBusCounters i2cBusCounters;
+
+/**
+  * @brief   创建仲裁器（在 MX_I2C1_Init 之后、访问 MPU 之前调用） | Create the arbiter (after MX_I2C1_Init, before the MPU is touched)
+  */
+void I2C_Bus_Init(void);
+
+/**
+  * @brief   阻塞执行一次请求 | Run a request and block until it ends
+  * @param   client  客户端编号 | Client number
+  * @param   req     请求 | Request
+  * @return  0 成功，-1 失败 | 0 on success, -1 on failure
+  */
+int I2C_Bus_Transfer(uint8_t client, I2CRequest *req);
+
+/**
+  * @brief   有错误时恢复总线（主循环中轮询） | Recover the bus after an error (polled from the main loop)
+  */
+void I2C_Bus_Poll(void);
+
+/**
+  * @brief   客户端累计失败的请求数 | Failed requests of a client so far
+  * @param   client  客户端编号 | Client number
+  * @return  失败数，变化说明上次查询后出过错 | Failure count; a change means an error since the last look
+  */
+uint32_t I2C_Bus_Errors(uint8_t client);
+
+/**
+  * @brief   以 IMU 优先级阻塞写寄存器（inv_mpu 的 i2c_write） | Blocking register write at IMU priority (inv_mpu's i2c_write)
+  * @param   addr  7 位地址 | 7-bit address
+  * @param   reg   寄存器 | Register
+  * @param   len   字节数 | Byte count
+  * @param   data  数据 | Data
+  * @return  0 成功，-1 失败 | 0 on success, -1 on failure
+  */
+int I2C_Bus_Write(uint8_t addr, uint8_t reg, uint16_t len, uint8_t *data);
+
+/**
+  * @brief   以 IMU 优先级阻塞读寄存器（inv_mpu 的 i2c_read） | Blocking register read at IMU priority (inv_mpu's i2c_read)
+  * @param   addr  7 位地址 | 7-bit address
+  * @param   reg   寄存器 | Register
+  * @param   len   字节数 | Byte count
+  * @param   data  数据 | Data
+  * @return  0 成功，-1 失败 | 0 on success, -1 on failure
+  */
+int I2C_Bus_Read(uint8_t addr, uint8_t reg, uint16_t len, uint8_t *data);
+
+#endif /* I2C_BUS_H_ */
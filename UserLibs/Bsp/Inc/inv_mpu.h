@@ -24,6 +24,11 @@
 #define STM32_MPU6500
 #define MPU6500
 
+/* 1: read the DMP image back after loading and compare its CRC32. */
+#ifndef MPU_DMP_VERIFY
+#define MPU_DMP_VERIFY  (1)
+#endif
+
 #define INV_X_GYRO      (0x40)
 #define INV_Y_GYRO      (0x20)
 #define INV_Z_GYRO      (0x10)
@@ -65,6 +70,8 @@ struct int_param_s {
 /* Set up APIs */
 int mpu_init(struct int_param_s *int_param);
 
+int mpu_init_warm(unsigned short start_addr, unsigned short sample_rate);
+
 int mpu_init_slave(void);
 
 int mpu_set_bypass(unsigned char bypass_on);
@@ -146,6 +153,10 @@ int mpu_read_fifo_stream(unsigned short length, unsigned char *data,
 
 int mpu_reset_fifo(void);
 
+int mpu_reset_fifo_start(void);
+
+int mpu_reset_fifo_finish(void);
+
 int mpu_write_mem(unsigned short mem_addr, unsigned short length,
                   unsigned char *data);
 
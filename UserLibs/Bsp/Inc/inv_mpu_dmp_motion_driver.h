@@ -52,6 +52,8 @@
 /* Set up functions. */
 int dmp_load_motion_driver_firmware(void);
 
+int dmp_init_warm(unsigned short mask, unsigned short rate, unsigned short orient);
+
 int dmp_set_fifo_rate(unsigned short rate);
 
 int dmp_get_fifo_rate(unsigned short *rate);
@@ -112,6 +114,11 @@ int dmp_enable_gyro_cal(unsigned char enable);
  */
 int dmp_read_fifo(short *gyro, short *accel, long *quat,
                   unsigned long *timestamp, short *sensors, unsigned char *more);
+/* Parse one packet already read from the FIFO (the decode half of
+ * dmp_read_fifo).
+ */
+int dmp_parse_packet(unsigned char *fifo_data, short *gyro, short *accel,
+                     long *quat, short *sensors);
 
 #endif  /* #ifndef _INV_MPU_DMP_MOTION_DRIVER_H_ */
 
@@ -0,0 +1,50 @@
+#ifndef OLED_PORT_H_
+#define OLED_PORT_H_
+
+#include <stdint.h>
+
+/**
+  * @file    oled_port.h
+  * @brief   OLED 传输端口 | OLED transport port
+  *
+  * @note    OLED.c 只通过这几个函数访问总线：固件中由 oled_port.c 经 I2C1 仲裁器实现，
+  *          主机端基准用计数实现替换，绘图与脏区代码两边完全相同。
+  *          OLED.c reaches the bus only through these functions: the firmware implements them
+  *          on the I2C1 arbiter in oled_port.c, the host benchmark replaces them with a counting
+  *          implementation, and the drawing and dirty-region code is identical on both.
+  */
+
+#define OLED_ADDRESS        0x78    /**< SSD1306 写地址 | SSD1306 write address */
+#define OLED_PORT_COMMAND   0x00    /**< 控制字节：后续为命令 | Control byte: commands follow */
+#define OLED_PORT_DATA      0x40    /**< 控制字节：后续为显存数据 | Control byte: display data follows */
+
+/**
+  * @brief   阻塞写入（仅初始化时使用） | Blocking write (initialisation only)
+  * @param   control  控制字节 | Control byte
+  * @param   data     数据 | Data
+  * @param   len      字节数 | Byte count
+  */
+void OLED_Port_WriteBlocking(uint8_t control, const uint8_t *data, uint16_t len);
+
+/**
+  * @brief   现在能否开始一次 len 字节的传输 | Whether a len-byte transfer may start now
+  * @param   len  负载字节数 | Payload byte count
+  * @return  1 可以提交（上一次传输已结束） | 1 if a transfer may be submitted (the previous one has ended)
+  */
+uint8_t OLED_Port_Ready(uint16_t len);
+
+/**
+  * @brief   启动一次后台传输，立即返回 | Start a background transfer and return immediately
+  * @param   control  控制字节 | Control byte
+  * @param   data     数据，传输结束前必须保持有效 | Data, must stay valid until the transfer ends
+  * @param   len      字节数 | Byte count
+  */
+void OLED_Port_Write(uint8_t control, const uint8_t *data, uint16_t len);
+
+/**
+  * @brief   取出并清除传输错误标志 | Fetch and clear the transfer error flag
+  * @return  1 上次传输后出过错 | 1 if a transfer failed since the last call
+  */
+uint8_t OLED_Port_TakeError(void);
+
+#endif /* OLED_PORT_H_ */
@@ -1,7 +1,10 @@
 #include "MPU6500.h"
 #include "inv_mpu.h"
 #include "inv_mpu_dmp_motion_driver.h"
+#include "i2c_bus.h"
+#include "crc.h"
 #include <math.h>
+#include <stddef.h>
 
 #define DEFAULT_MPU_HZ (100)
 
@@ -63,94 +66,287 @@ static int run_self_test(void) {
   return 0;
 }
 
-int MPU_6500_Init(void) {
-  int result;
-  struct int_param_s int_param;
+#define DMP_FEATURES (DMP_FEATURE_6X_LP_QUAT | DMP_FEATURE_TAP | DMP_FEATURE_ANDROID_ORIENT | \
+                      DMP_FEATURE_SEND_RAW_ACCEL | DMP_FEATURE_SEND_CAL_GYRO | DMP_FEATURE_GYRO_CAL)
 
-  result = mpu_init(&int_param);
-  if (result != 0) {
-    return -1;
-  }
+#define MPU6500_ADDR (0x68)
 
-  result = mpu_set_sensors(INV_XYZ_GYRO | INV_XYZ_ACCEL);
-  if (result != 0) {
-    return -2;
-  }
+/* Boot signature: CRC32 over the DMP code banks that hold the orientation and feature patch
+ * points, seeded with the configuration above. It is kept in I2C_SLV0_DO..I2C_SLV3_DO, unused
+ * without the auxiliary I2C master. A device reset clears these registers, so a matching
+ * signature means the chip kept power and its configured DMP since the last full init. */
+#define SIG_REG (0x63)
+#define SIG_BANK_SIZE (256)
+static const unsigned short sig_banks[] = {0x0400, 0x0A00};
 
-  result = mpu_configure_fifo(INV_XYZ_GYRO | INV_XYZ_ACCEL);
-  if (result != 0) {
-    return -3;
+static int dmp_signature(uint32_t *sig) {
+  unsigned char bank[SIG_BANK_SIZE];
+  uint16_t config[3] = {DMP_FEATURES, DEFAULT_MPU_HZ, inv_orientation_matrix_to_scalar(gyro_orientation)};
+  uint32_t crc = CRC32_Update(CRC32_INIT, config, sizeof(config));
+  for (uint8_t i = 0; i < sizeof(sig_banks) / sizeof(sig_banks[0]); i++) {
+    if (mpu_read_mem(sig_banks[i], SIG_BANK_SIZE, bank) != 0) {
+      return -1;
+    }
+    crc = CRC32_Update(crc, bank, SIG_BANK_SIZE);
   }
+  *sig = crc ^ 0xFFFFFFFFu;
+  return 0;
+}
 
-  result = mpu_set_sample_rate(DEFAULT_MPU_HZ);
-  if (result != 0) {
-    return -4;
+/* 0 if the chip is still running the DMP set up by an earlier boot. */
+static int probe_warm(void) {
+  uint8_t raw[4];
+  uint32_t sig;
+  if (dmp_init_warm(DMP_FEATURES, DEFAULT_MPU_HZ, inv_orientation_matrix_to_scalar(gyro_orientation)) != 0) {
+    return -1;
+  }
+  if (I2C_Bus_Read(MPU6500_ADDR, SIG_REG, 4, raw) != 0 || dmp_signature(&sig) != 0) {
+    return -1;
   }
+  uint32_t stored = ((uint32_t) raw[0] << 24) | ((uint32_t) raw[1] << 16) | ((uint32_t) raw[2] << 8) | raw[3];
+  return (stored == sig) ? 0 : -1;
+}
 
+static int stage_reset(void) {
+  struct int_param_s int_param;
+  return mpu_init(&int_param);
+}
 
-  result = dmp_load_motion_driver_firmware();
-  if (result != 0) {
-    return -5;
-  }
+static int stage_sensors(void) {
+  return mpu_set_sensors(INV_XYZ_GYRO | INV_XYZ_ACCEL);
+}
 
-  result = dmp_set_orientation(inv_orientation_matrix_to_scalar(gyro_orientation));
-  if (result != 0) {
-    return -6;
-  }
+static int stage_fifo(void) {
+  return mpu_configure_fifo(INV_XYZ_GYRO | INV_XYZ_ACCEL);
+}
 
-  result = dmp_enable_feature(DMP_FEATURE_6X_LP_QUAT | DMP_FEATURE_TAP |
-                              DMP_FEATURE_ANDROID_ORIENT | DMP_FEATURE_SEND_RAW_ACCEL | DMP_FEATURE_SEND_CAL_GYRO |
-                              DMP_FEATURE_GYRO_CAL);
-  if (result != 0) {
-    return -7;
-  }
+static int stage_sample_rate(void) {
+  return mpu_set_sample_rate(DEFAULT_MPU_HZ);
+}
 
-  result = dmp_set_fifo_rate(DEFAULT_MPU_HZ);
-  if (result != 0) {
-    return -8;
+static uint32_t loadMs = 0;
+
+static int stage_load(void) {
+  uint32_t start = HAL_GetTick();
+  int result = dmp_load_motion_driver_firmware();
+  loadMs = HAL_GetTick() - start;
+  return result;
+}
+
+static int stage_orientation(void) {
+  return dmp_set_orientation(inv_orientation_matrix_to_scalar(gyro_orientation));
+}
+
+static int stage_features(void) {
+  return dmp_enable_feature(DMP_FEATURES);
+}
+
+static int stage_fifo_rate(void) {
+  return dmp_set_fifo_rate(DEFAULT_MPU_HZ);
+}
+
+static int stage_dmp_on(void) {
+  return mpu_set_dmp_state(1);
+}
+
+static int stage_sign(void) {
+  uint32_t sig;
+  if (dmp_signature(&sig) != 0) {
+    return -1;
   }
+  uint8_t raw[4] = {(uint8_t) (sig >> 24), (uint8_t) (sig >> 16), (uint8_t) (sig >> 8), (uint8_t) sig};
+  return I2C_Bus_Write(MPU6500_ADDR, SIG_REG, 4, raw);
+}
 
-//	result = run_self_test();
-//	if(result != 0){
-//		return -9;
-//	}
+/* The FIFO kept filling while the MCU was down and has most likely overflowed. */
+static int stage_resume(void) {
+  return mpu_reset_fifo();
+}
 
-  result = mpu_set_dmp_state(1);
-  if (result != 0) {
-    return -10;
+typedef struct {
+  int (*run)(void);
+  int error;
+} InitStage;
+
+static const InitStage cold_stages[] = {
+    {stage_reset,                     -1},
+    {stage_sensors,                   -2},
+    {stage_fifo,                      -3},
+    {stage_sample_rate,               -4},
+    {stage_load,                      -5},
+    {stage_orientation,               -6},
+    {stage_features,                  -7},
+    {stage_fifo_rate,                 -8},
+//  {run_self_test,                   -9},
+    {stage_dmp_on,                    -10},
+    {stage_sign,                      -11},
+};
+
+static const InitStage warm_stages[] = {
+    {stage_resume,                    -12},
+};
+
+static const InitStage *initStages = NULL;
+static uint8_t initCount = 0;
+static uint8_t initStep = 0;
+static int initResult = MPU6500_INIT_BUSY;
+static uint8_t warmBoot = 0;
+
+static uint32_t imuErrors = 0;
+static uint8_t resetPending = 0;       /* FIFO reset started by resync_fifo, not yet finished */
+static uint32_t resetStart = 0;
+
+void MPU6500_Init_Start(void) {
+  initStages = NULL;
+  initStep = 0;
+  initResult = MPU6500_INIT_BUSY;
+  warmBoot = 0;
+  loadMs = 0;
+  resetPending = 0;
+}
+
+/* One stage per call, so the caller's loop keeps running between stages. The vendor delays
+ * inside a stage (up to 100 ms after the device reset) still block. */
+int MPU6500_Init_Poll(void) {
+  if (initResult != MPU6500_INIT_BUSY) {
+    return initResult;
+  }
+  if (initStages == NULL) {
+    warmBoot = (probe_warm() == 0);
+    initStages = warmBoot ? warm_stages : cold_stages;
+    initCount = warmBoot ? sizeof(warm_stages) / sizeof(warm_stages[0])
+                         : sizeof(cold_stages) / sizeof(cold_stages[0]);
+    return initResult;
+  }
+  /* Some vendor calls drop the result of their writes (dmp_enable_feature, set_int_enable), so
+   * a stage also fails if the bus counted an IMU error while it ran. */
+  uint32_t errors = I2C_Bus_Errors(I2C_CLIENT_IMU);
+  if (initStages[initStep].run() != 0 || I2C_Bus_Errors(I2C_CLIENT_IMU) != errors) {
+    initResult = initStages[initStep].error;
+    return initResult;
+  }
+  if (++initStep == initCount) {
+    imuErrors = I2C_Bus_Errors(I2C_CLIENT_IMU);
+    initResult = 0;
   }
+  return initResult;
+}
+
+int MPU6500_Warm_Boot(void) {
+  return warmBoot;
+}
+
+uint32_t MPU6500_DMP_Load_Ms(void) {
+  return loadMs;
+}
+
+int MPU_6500_Init(void) {
+  int result;
+  MPU6500_Init_Start();
+  do {
+    result = MPU6500_Init_Poll();
+  } while (result == MPU6500_INIT_BUSY);
+  return result;
+}
 
+int MPU6500_Set_Bias(long *gyro, long *accel) {
+  if (dmp_set_gyro_bias(gyro) != 0) {
+    return -1;
+  }
+  if (dmp_set_accel_bias(accel) != 0) {
+    return -2;
+  }
   return 0;
 }
 
 #define Q30 (1073741824.0f)
 
+#define FIFO_RESET_MS 50
+
+static uint32_t fifoResyncs = 0;
+
+static void reset_started(void) {
+  resetPending = 1;
+  resetStart = HAL_GetTick();
+  fifoResyncs++;
+}
+
+/* An I2C error while reading the FIFO can leave the next read starting mid-packet, so the
+ * FIFO is reset after any failed IMU request, as well as after an overflow or a bad packet.
+ * The reset is staged across calls instead of waiting the 50 ms inside the control tick: one
+ * call starts it, the calls in the next 50 ms return no data, and the first call after
+ * re-enables the FIFO. A failed step is retried on the next call. */
+static int resync_fifo(void) {
+  if (resetPending) {
+    if (HAL_GetTick() - resetStart < FIFO_RESET_MS || mpu_reset_fifo_finish() != 0) {
+      return 1;
+    }
+    resetPending = 0;
+    imuErrors = I2C_Bus_Errors(I2C_CLIENT_IMU);
+    return 1;
+  }
+  if (I2C_Bus_Errors(I2C_CLIENT_IMU) == imuErrors) {
+    return 0;
+  }
+  if (mpu_reset_fifo_start() != 0) {
+    return -1;
+  }
+  reset_started();
+  return 1;
+}
+
+uint32_t MPU6500_FIFO_Resyncs(void) {
+  return fifoResyncs;
+}
+
+static MPU6500_Raw lastRaw;
+
+const MPU6500_Raw *MPU6500_DMP_Last_Raw(void) {
+  return &lastRaw;
+}
+
+void MPU6500_Quat_To_Euler(const long *quat, float *pitch, float *roll, float *yaw) {
+  float q0 = quat[0] / Q30;
+  float q1 = quat[1] / Q30;
+  float q2 = quat[2] / Q30;
+  float q3 = quat[3] / Q30;
+
+  *pitch = asin(-2 * q1 * q3 + 2 * q0 * q2) * 57.3;
+  *roll = atan2(2 * q2 * q3 + 2 * q0 * q1, -2 * q1 * q1 - 2 * q2 * q2 + 1) * 57.3;
+  *yaw = atan2(2 * (q1 * q2 + q0 * q3), q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * 57.3;
+}
+
 int
 MPU6500_DMP_Get_Data(float *pitch, float *roll, float *yaw, float *ax, float *ay, float *az, float *gyrox, float *gyroy,
                      float *gyroz) {
-  float q0 = 0.0f;
-  float q1 = 0.0f;
-  float q2 = 0.0f;
-  float q3 = 0.0f;
-
   short gyro[3];
   short accel[3];
   long quat[4];
   unsigned long timestamp;
   short sensors;
   unsigned char more;
-  dmp_read_fifo(gyro, accel, quat, &timestamp, &sensors, &more);
+  if (resync_fifo() != 0) {
+    return -1;
+  }
+  int result = dmp_read_fifo(gyro, accel, quat, &timestamp, &sensors, &more);
+  if (result == -2) {
+    reset_started();
+  }
+  if (result != 0) {
+    return -1;
+  }
+  for (int i = 0; i < 4; i++) {
+    lastRaw.quat[i] = (int32_t) quat[i];
+  }
+  for (int i = 0; i < 3; i++) {
+    lastRaw.accel[i] = accel[i];
+    lastRaw.gyro[i] = gyro[i];
+  }
+  lastRaw.count++;
 
 
   if (sensors & INV_WXYZ_QUAT) {
-    q0 = quat[0] / Q30;
-    q1 = quat[1] / Q30;
-    q2 = quat[2] / Q30;
-    q3 = quat[3] / Q30;
-
-    *pitch = asin(-2 * q1 * q3 + 2 * q0 * q2) * 57.3;
-    *roll = atan2(2 * q2 * q3 + 2 * q0 * q1, -2 * q1 * q1 - 2 * q2 * q2 + 1) * 57.3;
-    *yaw = atan2(2 * (q1 * q2 + q0 * q3), q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * 57.3;
+    MPU6500_Quat_To_Euler(quat, pitch, roll, yaw);
   }
   if (sensors & INV_XYZ_ACCEL) {
     *ax = (float) accel[0] / 16384.0f;
@@ -160,7 +356,7 @@ MPU6500_DMP_Get_Data(float *pitch, float *roll, float *yaw, float *ax, float *ay
   if (sensors & INV_XYZ_GYRO) {
     *gyrox = (float) gyro[0] / 65.5f;;
     *gyroy = (float) gyro[1] / 65.5f;;
-    *gyroy = (float) gyro[2] / 65.5f;;
+    *gyroz = (float) gyro[2] / 65.5f;;
   }
 
   return 0;
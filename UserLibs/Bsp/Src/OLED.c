@@ -0,0 +1,638 @@
+#include "OLED.h"
+#include "oled_port.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+  * @file    OLED.c
+  * @brief   SSD1306 128×64 显存驱动：脏区跟踪与后台 DMA 刷新 | SSD1306 128×64 framebuffer driver: dirty-region tracking and background DMA refresh
+  *
+  * @note    所有绘图只改 RAM 中的显存，并且只有字节值真的变化时才把该列标记为脏，
+  *          OLED_Update 再与已发送的内容比较，所以每帧清屏重画整个界面也只发送真正变化的列；
+  *          OLED_Poll 每页把发送集合合并成连续的列段，用 0x21/0x22 设置窗口后经 DMA 发送，
+  *          每次调用最多启动一次传输，上一次未结束时直接返回。
+  *          字符和图片按列字节整体移位写入，不逐点调用。
+  *          Drawing only touches the RAM framebuffer and marks a column dirty only when a byte
+  *          changes; OLED_Update then compares against what was already sent, so clearing and
+  *          redrawing the whole screen every frame still sends only the columns that really
+  *          changed. OLED_Poll merges each page of the send set into column runs, sets the window
+  *          with 0x21/0x22 and sends the run by DMA. Each call starts at most one transfer and
+  *          returns at once while the previous one is still running. Characters and images are
+  *          blitted as shifted column bytes, never point by point.
+  */
+
+#define OLED_WIDTH      128
+#define OLED_HEIGHT     64
+#define OLED_PAGES      (OLED_HEIGHT / 8)
+#define OLED_WORDS      (OLED_WIDTH / 32)
+
+#define OLED_MAX_CHUNK  32      // 单次数据传输上限，100 kHz 下约 3 ms | Max bytes per data transfer, ~3 ms at 100 kHz
+#define OLED_RUN_GAP    10      // 新开一段的代价：命令传输 8 字节 + 数据头 2 字节 | Cost of a new run: 8-byte command transfer + 2-byte data header
+
+static uint8_t OLED_DisplayBuf[OLED_PAGES][OLED_WIDTH];
+static uint8_t OLED_Shown[OLED_PAGES][OLED_WIDTH];      // 已发给屏幕的内容 | What has been sent to the display
+static uint32_t OLED_Dirty[OLED_PAGES][OLED_WORDS];     // 已改动、未提交 | Changed, not yet committed
+static uint32_t OLED_Pending[OLED_PAGES][OLED_WORDS];   // 已提交、待发送 | Committed, waiting to be sent
+
+static struct {
+    uint8_t cmd[6];         // 窗口命令，传输期间必须保持有效 | Window commands, must outlive the transfer
+    uint8_t active;         // 正在发送一段 | Sending a run
+    uint8_t page;
+    uint16_t col, end;      // 下一个要发的列和该段最后一列 | Next column to send and last column of the run
+} tx;
+
+/* 列位图 | Column bitmaps ---------------------------------------------------*/
+
+/**
+  * @brief   置位 [x0, x1] 列 | Set columns [x0, x1]
+  */
+static void setCols(uint32_t *bits, uint8_t x0, uint8_t x1) {
+    for (uint8_t w = x0 / 32; w <= x1 / 32; w++) {
+        uint8_t lo = (w == x0 / 32) ? x0 % 32 : 0;
+        uint8_t hi = (w == x1 / 32) ? x1 % 32 : 31;
+        bits[w] |= (0xFFFFFFFFU >> (31 - hi)) & (0xFFFFFFFFU << lo);
+    }
+}
+
+/**
+  * @brief   清零 [x0, x1] 列 | Clear columns [x0, x1]
+  */
+static void clearCols(uint32_t *bits, uint8_t x0, uint8_t x1) {
+    for (uint8_t w = x0 / 32; w <= x1 / 32; w++) {
+        uint8_t lo = (w == x0 / 32) ? x0 % 32 : 0;
+        uint8_t hi = (w == x1 / 32) ? x1 % 32 : 31;
+        bits[w] &= ~((0xFFFFFFFFU >> (31 - hi)) & (0xFFFFFFFFU << lo));
+    }
+}
+
+static uint8_t testCol(const uint32_t *bits, uint8_t x) {
+    return (bits[x / 32] >> (x % 32)) & 1U;
+}
+
+/* 显存写入 | Framebuffer writes ---------------------------------------------*/
+
+/**
+  * @brief   改写一个字节中 mask 选中的位，值变化时标记脏列 | Rewrite the mask bits of a byte, marking the column dirty on change
+  */
+static void writeBits(uint8_t page, uint8_t x, uint8_t mask, uint8_t bits) {
+    uint8_t *p = &OLED_DisplayBuf[page][x];
+    uint8_t v = (uint8_t)((*p & ~mask) | (bits & mask));
+    if (v != *p) {
+        *p = v;
+        OLED_Dirty[page][x / 32] |= 1U << (x % 32);
+    }
+}
+
+/**
+  * @brief   翻转一个字节中 mask 选中的位 | Invert the mask bits of a byte
+  */
+static void invertBits(uint8_t page, uint8_t x, uint8_t mask) {
+    if (mask) {
+        OLED_DisplayBuf[page][x] ^= mask;
+        OLED_Dirty[page][x / 32] |= 1U << (x % 32);
+    }
+}
+
+/**
+  * @brief   页 page 中落在 [y0, y1] 行内的位 | Bits of page that fall in rows [y0, y1]
+  */
+static uint8_t rowMask(uint8_t page, int16_t y0, int16_t y1) {
+    int16_t top = (int16_t)(page * 8);
+    int16_t lo = (y0 > top) ? y0 - top : 0;
+    int16_t hi = (y1 < top + 7) ? y1 - top : 7;
+    if (lo > hi) return 0;
+    return (uint8_t)((0xFFU >> (7 - hi)) & (0xFFU << lo));
+}
+
+/**
+  * @brief   一列中 [y0, y1] 行置为 value（裁剪到屏幕） | Set rows [y0, y1] of a column to value (clipped)
+  */
+static void fillColumn(int16_t x, int16_t y0, int16_t y1, uint8_t value) {
+    if (x < 0 || x >= OLED_WIDTH) return;
+    if (y0 < 0) y0 = 0;
+    if (y1 >= OLED_HEIGHT) y1 = OLED_HEIGHT - 1;
+    if (y0 > y1) return;
+    for (uint8_t page = (uint8_t)(y0 / 8); page <= y1 / 8; page++) {
+        writeBits(page, (uint8_t)x, rowMask(page, y0, y1), value ? 0xFF : 0x00);
+    }
+}
+
+/**
+  * @brief   画点（裁剪到屏幕） | Draw a point (clipped)
+  */
+static void point(int16_t x, int16_t y) {
+    if (x >= 0 && x < OLED_WIDTH && y >= 0 && y < OLED_HEIGHT) {
+        writeBits((uint8_t)(y / 8), (uint8_t)x, (uint8_t)(1U << (y % 8)), 0xFF);
+    }
+}
+
+/* 初始化与刷新 | Initialisation and refresh ---------------------------------*/
+
+/**
+  * @brief   初始化屏幕 | Initialise the display
+  * @note    使用水平寻址模式，后台刷新才能用列/页窗口命令 | Horizontal addressing mode, so the refresh can use column/page window commands
+  */
+void OLED_Init(void) {
+    static const uint8_t init[] = {
+        0xAE,               // 关显示 | Display off
+        0xD5, 0x80,         // 时钟分频 | Clock divide
+        0xA8, 0x3F,         // 复用率 64 | Multiplex ratio 64
+        0xD3, 0x00,         // 显示偏移 | Display offset
+        0x40,               // 起始行 | Start line
+        0xA1, 0xC8,         // 左右、上下方向 | Segment remap, COM scan direction
+        0xDA, 0x12,         // COM 引脚配置 | COM pins
+        0x81, 0xCF,         // 对比度 | Contrast
+        0xD9, 0xF1,         // 预充电周期 | Pre-charge period
+        0xDB, 0x30,         // VCOMH
+        0x20, 0x00,         // 水平寻址 | Horizontal addressing
+        0xA4, 0xA6,         // 显示显存内容，正常显示 | Follow RAM, normal polarity
+        0x8D, 0x14,         // 电荷泵 | Charge pump
+        0xAF,               // 开显示 | Display on
+    };
+    OLED_Port_WriteBlocking(OLED_PORT_COMMAND, init, sizeof(init));
+
+    // 上电后屏幕 RAM 内容不定，第一次刷新发送整屏 | Display RAM is undefined after power-up, so the first refresh sends everything
+    memset(OLED_DisplayBuf, 0, sizeof(OLED_DisplayBuf));
+    memset(OLED_Shown, 0, sizeof(OLED_Shown));
+    memset(OLED_Dirty, 0, sizeof(OLED_Dirty));
+    memset(OLED_Pending, 0xFF, sizeof(OLED_Pending));
+    tx.active = 0;
+}
+
+/**
+  * @brief   提交真正变化的脏列 | Commit the dirty columns that really changed
+  * @note    脏位只说明改动过，先清屏再重画同样内容也会置位；与已发送内容比较后才进入发送集合
+  *          A dirty bit only says the byte changed at some point, and clearing then redrawing the
+  *          same content sets it too; columns join the send set only if they differ from what was sent
+  */
+void OLED_Update(void) {
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+        for (uint8_t w = 0; w < OLED_WORDS; w++) {
+            uint32_t bits = OLED_Dirty[page][w];
+            OLED_Dirty[page][w] = 0;
+            while (bits) {
+                uint8_t x = (uint8_t)(w * 32 + __builtin_ctz(bits));
+                bits &= bits - 1;
+                if (OLED_DisplayBuf[page][x] != OLED_Shown[page][x]) {
+                    OLED_Pending[page][w] |= 1U << (x % 32);
+                }
+            }
+        }
+    }
+}
+
+/**
+  * @brief   提交指定区域（无论是否改动都会重发） | Commit an area (resent whether or not it changed)
+  */
+void OLED_UpdateArea(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height) {
+    if (X >= OLED_WIDTH || Y >= OLED_HEIGHT || Width == 0 || Height == 0) return;
+    uint8_t x1 = (X + Width > OLED_WIDTH) ? OLED_WIDTH - 1 : (uint8_t)(X + Width - 1);
+    uint8_t y1 = (Y + Height > OLED_HEIGHT) ? OLED_HEIGHT - 1 : (uint8_t)(Y + Height - 1);
+    for (uint8_t page = Y / 8; page <= y1 / 8; page++) {
+        setCols(OLED_Pending[page], X, x1);
+        clearCols(OLED_Dirty[page], X, x1);
+    }
+}
+
+/**
+  * @brief   找到下一段待发送的列 | Find the next run of columns to send
+  * @note    两段之间的间隔不超过 OLED_RUN_GAP 时合并，多发几个未变的字节比再开一段便宜
+  *          Runs closer than OLED_RUN_GAP are merged: sending a few unchanged bytes is cheaper
+  *          than opening another run
+  */
+static uint8_t nextRun(uint8_t *page, uint8_t *x0, uint8_t *x1) {
+    for (uint8_t p = 0; p < OLED_PAGES; p++) {
+        const uint32_t *bits = OLED_Pending[p];
+        if (!(bits[0] | bits[1] | bits[2] | bits[3])) continue;
+
+        int16_t start = -1, last = -1;
+        for (uint8_t x = 0; x < OLED_WIDTH; x++) {
+            if (!bits[x / 32]) {
+                x |= 31;        // 跳过空字 | Skip an empty word
+                continue;
+            }
+            if (!testCol(bits, x)) continue;
+            if (start < 0) {
+                start = x;
+            } else if (x - last - 1 > OLED_RUN_GAP) {
+                break;
+            }
+            last = x;
+        }
+        *page = p;
+        *x0 = (uint8_t)start;
+        *x1 = (uint8_t)last;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+  * @brief   推进后台发送 | Advance the background refresh
+  */
+void OLED_Poll(void) {
+    if (OLED_Port_TakeError()) {
+        // 不知道屏幕收到了多少，整屏重发 | Unknown how much arrived, so resend the whole screen
+        memset(OLED_Pending, 0xFF, sizeof(OLED_Pending));
+        tx.active = 0;
+    }
+
+    if (!tx.active) {
+        uint8_t page, x0, x1;
+        if (!nextRun(&page, &x0, &x1) || !OLED_Port_Ready(sizeof(tx.cmd))) return;
+
+        // 先清位再发送：发送期间的新改动会再次置位，不会丢 | Clear before sending: changes made meanwhile set the bits again and are not lost
+        clearCols(OLED_Pending[page], x0, x1);
+        tx.cmd[0] = 0x21;
+        tx.cmd[1] = x0;
+        tx.cmd[2] = x1;
+        tx.cmd[3] = 0x22;
+        tx.cmd[4] = page;
+        tx.cmd[5] = page;
+        tx.page = page;
+        tx.col = x0;
+        tx.end = x1;
+        tx.active = 1;
+        OLED_Port_Write(OLED_PORT_COMMAND, tx.cmd, sizeof(tx.cmd));
+        return;
+    }
+
+    uint16_t n = tx.end - tx.col + 1;
+    if (n > OLED_MAX_CHUNK) n = OLED_MAX_CHUNK;
+    if (!OLED_Port_Ready(n)) return;
+    const uint8_t *data = &OLED_DisplayBuf[tx.page][tx.col];
+    memcpy(&OLED_Shown[tx.page][tx.col], data, n);
+    tx.col += n;
+    if (tx.col > tx.end) {
+        tx.active = 0;
+    }
+    OLED_Port_Write(OLED_PORT_DATA, data, n);
+}
+
+/**
+  * @brief   发送队列是否为空 | Whether the send queue is empty
+  */
+uint8_t OLED_IsIdle(void) {
+    if (tx.active) return 0;
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+        for (uint8_t w = 0; w < OLED_WORDS; w++) {
+            if (OLED_Pending[page][w]) return 0;
+        }
+    }
+    return 1;
+}
+
+/* 显存控制 | Framebuffer control --------------------------------------------*/
+
+void OLED_Clear(void) {
+    OLED_ClearArea(0, 0, OLED_WIDTH, OLED_HEIGHT);
+}
+
+void OLED_ClearArea(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height) {
+    for (uint16_t x = X; x < X + Width && x < OLED_WIDTH; x++) {
+        fillColumn((int16_t)x, Y, (int16_t)(Y + Height - 1), 0);
+    }
+}
+
+void OLED_Reverse(void) {
+    OLED_ReverseArea(0, 0, OLED_WIDTH, OLED_HEIGHT);
+}
+
+void OLED_ReverseArea(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height) {
+    if (Y >= OLED_HEIGHT || Height == 0) return;
+    int16_t y1 = (Y + Height > OLED_HEIGHT) ? OLED_HEIGHT - 1 : Y + Height - 1;
+    for (uint8_t page = Y / 8; page <= y1 / 8; page++) {
+        uint8_t mask = rowMask(page, Y, y1);
+        for (uint16_t x = X; x < X + Width && x < OLED_WIDTH; x++) {
+            invertBits(page, (uint8_t)x, mask);
+        }
+    }
+}
+
+/* 显示函数 | Text and images ------------------------------------------------*/
+
+/**
+  * @brief   按页格式的图片写入显存 | Blit a page-format image
+  * @note    图片第 j 页第 i 列的字节整体左移 Y%8 位写入两个显存页，区域内原有内容被覆盖
+  *          The byte at column i of image page j is shifted by Y%8 and written into two
+  *          framebuffer pages; whatever was under the area is replaced
+  */
+void OLED_ShowImage(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, const uint8_t *Image) {
+    if (X >= OLED_WIDTH || Y >= OLED_HEIGHT) return;
+    uint8_t shift = Y % 8;
+    uint8_t pages = (uint8_t)((Height + 7) / 8);
+
+    for (uint8_t j = 0; j < pages; j++) {
+        uint8_t page = (uint8_t)(Y / 8 + j);
+        if (page >= OLED_PAGES) break;
+        uint8_t rows = (Height - j * 8 >= 8) ? 0xFF : (uint8_t)(0xFFU >> (8 - (Height - j * 8)));
+        const uint8_t *src = &Image[j * Width];
+
+        for (uint8_t i = 0; i < Width && X + i < OLED_WIDTH; i++) {
+            uint8_t x = (uint8_t)(X + i);
+            writeBits(page, x, (uint8_t)(rows << shift), (uint8_t)(src[i] << shift));
+            if (shift && page + 1 < OLED_PAGES) {
+                writeBits(page + 1, x, (uint8_t)(rows >> (8 - shift)), (uint8_t)(src[i] >> (8 - shift)));
+            }
+        }
+    }
+}
+
+void OLED_ShowChar(uint8_t X, uint8_t Y, char Char, uint8_t FontSize) {
+    if (Char < ' ' || Char > '~') Char = ' ';
+    if (FontSize == OLED_8X16) {
+        OLED_ShowImage(X, Y, 8, 16, OLED_F8x16[Char - ' ']);
+    } else if (FontSize == OLED_6X8) {
+        OLED_ShowImage(X, Y, 6, 8, OLED_F6x8[Char - ' ']);
+    }
+}
+
+void OLED_ShowString(uint8_t X, uint8_t Y, char *String, uint8_t FontSize) {
+    for (uint16_t i = 0; String[i] != '\0' && X + i * FontSize < OLED_WIDTH; i++) {
+        OLED_ShowChar((uint8_t)(X + i * FontSize), Y, String[i], FontSize);
+    }
+}
+
+static uint32_t OLED_Pow(uint32_t X, uint32_t Y) {
+    uint32_t result = 1;
+    while (Y--) result *= X;
+    return result;
+}
+
+void OLED_ShowNum(uint8_t X, uint8_t Y, uint32_t Number, uint8_t Length, uint8_t FontSize) {
+    for (uint8_t i = 0; i < Length; i++) {
+        OLED_ShowChar((uint8_t)(X + i * FontSize), Y, (char)(Number / OLED_Pow(10, Length - i - 1) % 10 + '0'), FontSize);
+    }
+}
+
+void OLED_ShowSignedNum(uint8_t X, uint8_t Y, int32_t Number, uint8_t Length, uint8_t FontSize) {
+    uint32_t magnitude;
+    if (Number >= 0) {
+        OLED_ShowChar(X, Y, '+', FontSize);
+        magnitude = (uint32_t)Number;
+    } else {
+        OLED_ShowChar(X, Y, '-', FontSize);
+        magnitude = 0U - (uint32_t)Number;
+    }
+    OLED_ShowNum((uint8_t)(X + FontSize), Y, magnitude, Length, FontSize);
+}
+
+void OLED_ShowHexNum(uint8_t X, uint8_t Y, uint32_t Number, uint8_t Length, uint8_t FontSize) {
+    for (uint8_t i = 0; i < Length; i++) {
+        uint8_t digit = (uint8_t)(Number >> (4 * (Length - i - 1)) & 0x0F);
+        OLED_ShowChar((uint8_t)(X + i * FontSize), Y, (char)(digit < 10 ? digit + '0' : digit - 10 + 'A'), FontSize);
+    }
+}
+
+void OLED_ShowBinNum(uint8_t X, uint8_t Y, uint32_t Number, uint8_t Length, uint8_t FontSize) {
+    for (uint8_t i = 0; i < Length; i++) {
+        OLED_ShowChar((uint8_t)(X + i * FontSize), Y, (char)(Number >> (Length - i - 1) & 1U ? '1' : '0'), FontSize);
+    }
+}
+
+void OLED_ShowFloatNum(uint8_t X, uint8_t Y, double Number, uint8_t IntLength, uint8_t FraLength, uint8_t FontSize) {
+    if (Number >= 0) {
+        OLED_ShowChar(X, Y, '+', FontSize);
+    } else {
+        OLED_ShowChar(X, Y, '-', FontSize);
+        Number = -Number;
+    }
+
+    // 先整体四舍五入，进位才能传到整数部分 | Round as a whole so a carry reaches the integer part
+    uint32_t pow = OLED_Pow(10, FraLength);
+    uint32_t scaled = (uint32_t)round(Number * pow);
+    OLED_ShowNum((uint8_t)(X + FontSize), Y, scaled / pow, IntLength, FontSize);
+    OLED_ShowChar((uint8_t)(X + (IntLength + 1) * FontSize), Y, '.', FontSize);
+    OLED_ShowNum((uint8_t)(X + (IntLength + 2) * FontSize), Y, scaled % pow, FraLength, FontSize);
+}
+
+/**
+  * @brief   显示汉字串 | Show a Chinese string
+  * @note    字库以 Index 为空的一项结尾，该项的字模用于显示字库中没有的字
+  *          The font ends with an entry whose Index is empty; its glyph stands in for characters
+  *          missing from the font
+  */
+void OLED_ShowChinese(uint8_t X, uint8_t Y, char *Chinese) {
+    char single[OLED_CHN_CHAR_WIDTH + 1];
+    uint16_t n = 0;
+
+    for (size_t i = 0; Chinese[i] != '\0'; n++) {
+        for (uint8_t k = 0; k < OLED_CHN_CHAR_WIDTH && Chinese[i] != '\0'; k++) {
+            single[k] = Chinese[i++];
+            single[k + 1] = '\0';
+        }
+        uint16_t index = 0;
+        while (OLED_CF16x16[index].Index[0] != '\0' && strcmp(OLED_CF16x16[index].Index, single) != 0) {
+            index++;
+        }
+        OLED_ShowImage((uint8_t)(X + n * 16), Y, 16, 16, OLED_CF16x16[index].Data);
+    }
+}
+
+void OLED_Printf(uint8_t X, uint8_t Y, uint8_t FontSize, char *format, ...) {
+    char string[OLED_WIDTH / OLED_6X8 + 1];
+    va_list arg;
+    va_start(arg, format);
+    vsnprintf(string, sizeof(string), format, arg);
+    va_end(arg);
+    OLED_ShowString(X, Y, string, FontSize);
+}
+
+/* 绘图函数 | Drawing --------------------------------------------------------*/
+
+void OLED_DrawPoint(uint8_t X, uint8_t Y) {
+    point(X, Y);
+}
+
+uint8_t OLED_GetPoint(uint8_t X, uint8_t Y) {
+    if (X >= OLED_WIDTH || Y >= OLED_HEIGHT) return 0;
+    return (OLED_DisplayBuf[Y / 8][X] >> (Y % 8)) & 1U;
+}
+
+/**
+  * @brief   画线（Bresenham，竖线按字节填充） | Draw a line (Bresenham, vertical lines filled byte-wise)
+  */
+void OLED_DrawLine(uint8_t X0, uint8_t Y0, uint8_t X1, uint8_t Y1) {
+    if (X0 == X1) {
+        fillColumn(X0, Y0 < Y1 ? Y0 : Y1, Y0 < Y1 ? Y1 : Y0, 1);
+        return;
+    }
+    int16_t dx = (int16_t)abs(X1 - X0), sx = X0 < X1 ? 1 : -1;
+    int16_t dy = (int16_t)-abs(Y1 - Y0), sy = Y0 < Y1 ? 1 : -1;
+    int16_t err = dx + dy, x = X0, y = Y0;
+    while (1) {
+        point(x, y);
+        if (x == X1 && y == Y1) break;
+        int16_t e2 = (int16_t)(2 * err);
+        if (e2 >= dy) { err += dy; x += sx; }
+        if (e2 <= dx) { err += dx; y += sy; }
+    }
+}
+
+void OLED_DrawRectangle(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, uint8_t IsFilled) {
+    if (Width == 0 || Height == 0) return;
+    int16_t x1 = X + Width - 1, y1 = Y + Height - 1;
+    if (IsFilled) {
+        for (int16_t x = X; x <= x1; x++) fillColumn(x, Y, y1, 1);
+        return;
+    }
+    fillColumn(X, Y, y1, 1);
+    fillColumn(x1, Y, y1, 1);
+    for (int16_t x = X + 1; x < x1; x++) {
+        point(x, Y);
+        point(x, y1);
+    }
+}
+
+/**
+  * @brief   P 相对有向边 AB 的位置（叉积） | Side of P relative to edge AB (cross product)
+  */
+static int32_t edge(int16_t ax, int16_t ay, int16_t bx, int16_t by, int16_t px, int16_t py) {
+    return (int32_t)(bx - ax) * (py - ay) - (int32_t)(by - ay) * (px - ax);
+}
+
+void OLED_DrawTriangle(uint8_t X0, uint8_t Y0, uint8_t X1, uint8_t Y1, uint8_t X2, uint8_t Y2, uint8_t IsFilled) {
+    if (!IsFilled) {
+        OLED_DrawLine(X0, Y0, X1, Y1);
+        OLED_DrawLine(X1, Y1, X2, Y2);
+        OLED_DrawLine(X2, Y2, X0, Y0);
+        return;
+    }
+    int16_t minX = X0, maxX = X0, minY = Y0, maxY = Y0;
+    if (X1 < minX) minX = X1;
+    if (X2 < minX) minX = X2;
+    if (X1 > maxX) maxX = X1;
+    if (X2 > maxX) maxX = X2;
+    if (Y1 < minY) minY = Y1;
+    if (Y2 < minY) minY = Y2;
+    if (Y1 > maxY) maxY = Y1;
+    if (Y2 > maxY) maxY = Y2;
+
+    // 三角形是凸的，每列内部是一个连续段 | The triangle is convex, so each column is one span
+    for (int16_t x = minX; x <= maxX; x++) {
+        int16_t top = -1, bottom = -1;
+        for (int16_t y = minY; y <= maxY; y++) {
+            int32_t a = edge(X0, Y0, X1, Y1, x, y);
+            int32_t b = edge(X1, Y1, X2, Y2, x, y);
+            int32_t c = edge(X2, Y2, X0, Y0, x, y);
+            if ((a >= 0 && b >= 0 && c >= 0) || (a <= 0 && b <= 0 && c <= 0)) {
+                if (top < 0) top = y;
+                bottom = y;
+            } else if (top >= 0) {
+                break;
+            }
+        }
+        if (top >= 0) fillColumn(x, top, bottom, 1);
+    }
+}
+
+void OLED_DrawCircle(uint8_t X, uint8_t Y, uint8_t Radius, uint8_t IsFilled) {
+    int16_t x = 0, y = Radius, d = (int16_t)(1 - Radius);
+
+    while (x <= y) {
+        if (IsFilled) {
+            fillColumn(X + x, Y - y, Y + y, 1);
+            fillColumn(X - x, Y - y, Y + y, 1);
+            fillColumn(X + y, Y - x, Y + x, 1);
+            fillColumn(X - y, Y - x, Y + x, 1);
+        } else {
+            point(X + x, Y + y); point(X - x, Y + y);
+            point(X + x, Y - y); point(X - x, Y - y);
+            point(X + y, Y + x); point(X - y, Y + x);
+            point(X + y, Y - x); point(X - y, Y - x);
+        }
+        if (d < 0) {
+            d += 2 * x + 3;
+        } else {
+            d += 2 * (x - y) + 5;
+            y--;
+        }
+        x++;
+    }
+}
+
+/**
+  * @brief   画椭圆（中点算法） | Draw an ellipse (midpoint algorithm)
+  */
+static void ellipsePoints(int16_t X, int16_t Y, int16_t x, int16_t y, uint8_t IsFilled) {
+    if (IsFilled) {
+        fillColumn(X + x, Y - y, Y + y, 1);
+        fillColumn(X - x, Y - y, Y + y, 1);
+    } else {
+        point(X + x, Y + y); point(X - x, Y + y);
+        point(X + x, Y - y); point(X - x, Y - y);
+    }
+}
+
+void OLED_DrawEllipse(uint8_t X, uint8_t Y, uint8_t A, uint8_t B, uint8_t IsFilled) {
+    float a2 = (float)A * A, b2 = (float)B * B;
+    int16_t x = 0, y = B;
+    float d = b2 + a2 * (-B + 0.25f);
+
+    ellipsePoints(X, Y, x, y, IsFilled);
+    while (b2 * (x + 1) < a2 * (y - 0.5f)) {
+        if (d <= 0) {
+            d += b2 * (2 * x + 3);
+        } else {
+            d += b2 * (2 * x + 3) + a2 * (-2 * y + 2);
+            y--;
+        }
+        x++;
+        ellipsePoints(X, Y, x, y, IsFilled);
+    }
+    d = b2 * (x + 0.5f) * (x + 0.5f) + a2 * (y - 1) * (y - 1) - a2 * b2;
+    while (y > 0) {
+        if (d <= 0) {
+            d += b2 * (2 * x + 2) + a2 * (-2 * y + 3);
+            x++;
+        } else {
+            d += a2 * (-2 * y + 3);
+        }
+        y--;
+        ellipsePoints(X, Y, x, y, IsFilled);
+    }
+}
+
+/**
+  * @brief   偏移 (x, y) 是否在角度范围内 | Whether offset (x, y) lies in the angle range
+  * @note    0° 指向右，屏幕 Y 向下，所以正角度顺时针；范围 -180°..180°，Start > End 时跨过 ±180°
+  *          0° points right and screen Y grows downwards, so positive angles run clockwise; range
+  *          -180°..180°, wrapping through ±180° when Start > End
+  */
+static uint8_t inAngle(int16_t x, int16_t y, int16_t start, int16_t end) {
+    int16_t angle = (int16_t)lroundf(atan2f((float)y, (float)x) * 57.29578f);
+    if (start <= end) return angle >= start && angle <= end;
+    return angle >= start || angle <= end;
+}
+
+void OLED_DrawArc(uint8_t X, uint8_t Y, uint8_t Radius, int16_t StartAngle, int16_t EndAngle, uint8_t IsFilled) {
+    if (IsFilled) {
+        int32_t r2 = (int32_t)Radius * Radius;
+        for (int16_t dx = -Radius; dx <= Radius; dx++) {
+            for (int16_t dy = -Radius; dy <= Radius; dy++) {
+                if ((int32_t)dx * dx + (int32_t)dy * dy <= r2 && inAngle(dx, dy, StartAngle, EndAngle)) {
+                    point(X + dx, Y + dy);
+                }
+            }
+        }
+        return;
+    }
+
+    int16_t x = 0, y = Radius, d = (int16_t)(1 - Radius);
+    while (x <= y) {
+        const int16_t o[8][2] = {{x, y}, {-x, y}, {x, -y}, {-x, -y}, {y, x}, {-y, x}, {y, -x}, {-y, -x}};
+        for (uint8_t k = 0; k < 8; k++) {
+            if (inAngle(o[k][0], o[k][1], StartAngle, EndAngle)) point(X + o[k][0], Y + o[k][1]);
+        }
+        if (d < 0) {
+            d += 2 * x + 3;
+        } else {
+            d += 2 * (x - y) + 5;
+            y--;
+        }
+        x++;
+    }
+}
@@ -0,0 +1,61 @@
+#include "flash_dev.h"
+#include <string.h>
+
+static const uint32_t sectorAddr[2] = {PARAM_FLASH_ADDR_0, PARAM_FLASH_ADDR_1};
+static const uint32_t sectorId[2]   = {PARAM_FLASH_SECTOR_0, PARAM_FLASH_SECTOR_1};
+
+/**
+  * @brief   读取 Flash（直接内存映射访问） | Read flash (memory-mapped)
+  */
+static int FlashDev_Read(FlashDev *self, uint8_t sector, uint32_t offset, void *buf, uint32_t len) {
+    memcpy(buf, (const void *)(sectorAddr[sector] + offset), len);
+    return 0;
+}
+
+/**
+  * @brief   按字写入 Flash | Program flash word by word
+  */
+static int FlashDev_Program(FlashDev *self, uint8_t sector, uint32_t offset, const uint32_t *words, uint32_t count) {
+    HAL_StatusTypeDef status = HAL_OK;
+
+    HAL_FLASH_Unlock();
+    for (uint32_t i = 0; i < count && status == HAL_OK; i++) {
+        status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, sectorAddr[sector] + offset + i * 4, words[i]);
+    }
+    HAL_FLASH_Lock();
+
+    return (status == HAL_OK) ? 0 : -1;
+}
+
+/**
+  * @brief   擦除扇区（阻塞，期间 CPU 取指停顿） | Erase sector (blocking; CPU fetch stalls meanwhile)
+  */
+static int FlashDev_Erase(FlashDev *self, uint8_t sector) {
+    FLASH_EraseInitTypeDef erase = {
+            .TypeErase    = FLASH_TYPEERASE_SECTORS,
+            .Sector       = sectorId[sector],
+            .NbSectors    = 1,
+            .VoltageRange = FLASH_VOLTAGE_RANGE_3
+    };
+    uint32_t sectorError = 0;
+
+    HAL_FLASH_Unlock();
+    HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &sectorError);
+    HAL_FLASH_Lock();
+
+    return (status == HAL_OK) ? 0 : -1;
+}
+
+/**
+  * @brief   创建片上 Flash 后端 | Create the on-chip flash backend
+  * @return  Flash 后端对象 | Flash backend object
+  */
+FlashDev newFlashDev(void) {
+    FlashDev d;
+    d.ctx = NULL;
+    d.sectorSize = PARAM_FLASH_SECTOR_SIZE;
+    d.Read = FlashDev_Read;
+    d.Program = FlashDev_Program;
+    d.Erase = FlashDev_Erase;
+    return d;
+}
@@ -0,0 +1,76 @@
+#include "hcsr04.h"
+#include "tim.h"
+
+static Ultrasonic sonar;
+
+/**
+  * @brief   启动定时器和捕获中断 | Start the timer and capture interrupts
+  */
+void HC_Init(void) {
+    sonar = newUltrasonic();
+    HAL_TIM_OC_Start(&HCSR04_TIM, TIM_CHANNEL_1);       // TRIG 输出使能，保持低电平 | TRIG output enabled, held low
+    HAL_TIM_IC_Start_IT(&HCSR04_TIM, TIM_CHANNEL_2);
+}
+
+/**
+  * @brief   发出触发脉冲并设置超时 | Fire the trigger pulse and arm the timeout
+  * @note    两次写 CCMR1 之间不能被打断，否则比较点可能已经过去；关中断只有几个周期
+  *          The two CCMR1 writes must not be split by an interrupt or the match may already be
+  *          past; interrupts are masked for a few cycles only
+  */
+static void fire(void) {
+    TIM_TypeDef *tim = HCSR04_TIM.Instance;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint16_t now = (uint16_t)tim->CNT;
+    MODIFY_REG(tim->CCMR1, TIM_CCMR1_OC1M, TIM_OCMODE_FORCED_ACTIVE);
+    tim->CCR1 = (uint16_t)(now + HCSR04_TRIG_US);
+    MODIFY_REG(tim->CCMR1, TIM_CCMR1_OC1M, TIM_OCMODE_INACTIVE);
+    __set_PRIMASK(primask);
+
+    tim->CCR3 = (uint16_t)(now + ULTRASONIC_TIMEOUT_US);
+    __HAL_TIM_CLEAR_FLAG(&HCSR04_TIM, TIM_FLAG_CC3);
+    __HAL_TIM_ENABLE_IT(&HCSR04_TIM, TIM_IT_CC3);
+}
+
+/**
+  * @brief   触发一次测量 | Trigger a measurement
+  */
+void HC_trig(void) {
+    if (Ultrasonic_Trigger(&sonar, (uint16_t)__HAL_TIM_GET_COUNTER(&HCSR04_TIM), HAL_GetTick())) {
+        fire();
+    }
+}
+
+/**
+  * @brief   读取最新障碍距离 | Read the latest obstacle distance
+  */
+void HC_Read(UltrasonicReading *reading) {
+    Ultrasonic_Read(&sonar, reading);
+}
+
+/**
+  * @brief   输入捕获回调：回波边沿 | Input capture callback: echo edge
+  * @note    双沿捕获，边沿方向由引脚电平判断（回波至少 116 µs，读引脚时电平早已稳定）
+  *          Both edges are captured; the direction comes from the pin level (echoes are at least
+  *          116 µs, so the level is long settled when the pin is read)
+  */
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    if (htim == &HCSR04_TIM && htim->Channel == HAL_TIM_ACTIVE_CHANNEL_2) {
+        bool_t rising = HAL_GPIO_ReadPin(ECHO_GPIO_Port, ECHO_Pin) == GPIO_PIN_SET;
+        Ultrasonic_Edge(&sonar, rising, (uint16_t)HAL_TIM_ReadCapturedValue(htim, TIM_CHANNEL_2));
+        if (sonar.state == ULTRASONIC_IDLE) {
+            __HAL_TIM_DISABLE_IT(htim, TIM_IT_CC3);
+        }
+    }
+}
+
+/**
+  * @brief   比较回调：超时 | Compare callback: timeout
+  */
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim) {
+    if (htim == &HCSR04_TIM && htim->Channel == HAL_TIM_ACTIVE_CHANNEL_3) {
+        __HAL_TIM_DISABLE_IT(htim, TIM_IT_CC3);
+        Ultrasonic_Timeout(&sonar);
+    }
+}
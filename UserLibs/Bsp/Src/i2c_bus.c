@@ -0,0 +1,205 @@
+#include "i2c_bus.h"
+#include "i2c.h"
+#include "i2c_recover.h"
+
+I2CArbiter i2cArbiter;
+I2CBusCounters i2cBusCounters;
+
+/**
+  * @brief   微秒计数：SysTick 毫秒加当前计数值 | Microsecond count: SysTick milliseconds plus the current count
+  * @note    读两次毫秒数，避免在两次读取之间重装载 | The millisecond count is read twice in case SysTick reloads in between
+  */
+static uint32_t busNow(I2CBus *self) {
+    uint32_t ms, val;
+    do {
+        ms = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (ms != HAL_GetTick());
+    uint32_t load = SysTick->LOAD + 1;
+    return ms * 1000U + (load - val) * 1000U / load;
+}
+
+/**
+  * @brief   等上一次 STOP 结束 | Wait for the previous STOP to finish
+  * @note    段在完成中断里接着启动，BUSY 可能还要几微秒才清除；超过 I2C_BUS_IDLE_US 视为总线卡死。
+  *          这里可能在中断中（毫秒计数不走），所以按循环次数计时。
+  *          Segments are chained from the completion interrupt, where BUSY may take a few more
+  *          microseconds to clear; beyond I2C_BUS_IDLE_US the bus is taken as stuck. This may run
+  *          inside an interrupt (the millisecond count is frozen), so time is counted in loops.
+  */
+static bool_t busIdle(I2C_HandleTypeDef *hi2c) {
+    uint32_t spins = I2C_BUS_IDLE_US * (SystemCoreClock / 1000000U) / 4U;
+    while (__HAL_I2C_GET_FLAG(hi2c, I2C_FLAG_BUSY)) {
+        if (spins-- == 0) return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+  * @brief   启动一段传输 | Start a segment
+  */
+static void busStart(I2CBus *self, uint8_t addr, uint8_t reg, bool_t read, uint8_t *data, uint16_t len) {
+    I2C_HandleTypeDef *hi2c = self->ctx;
+    if (!busIdle(hi2c)) {
+        i2cBusCounters.stuck++;
+        I2CArb_Complete(&i2cArbiter, FALSE);
+        return;
+    }
+    HAL_StatusTypeDef status = read
+        ? HAL_I2C_Mem_Read_IT(hi2c, addr, reg, I2C_MEMADD_SIZE_8BIT, data, len)
+        : HAL_I2C_Mem_Write_DMA(hi2c, addr, reg, I2C_MEMADD_SIZE_8BIT, data, len);
+    if (status != HAL_OK) {
+        i2cBusCounters.busErrors++;
+        I2CArb_Complete(&i2cArbiter, FALSE);
+    }
+}
+
+static uint32_t busLock(I2CBus *self) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+static void busUnlock(I2CBus *self, uint32_t state) {
+    __set_PRIMASK(state);
+}
+
+/* 恢复用开漏 GPIO | Open-drain GPIO for recovery ----------------------------*/
+
+static void pinScl(I2CPins *self, bool_t high) {
+    HAL_GPIO_WritePin(I2C_BUS_GPIO, I2C_BUS_SCL_PIN, high ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+static void pinSda(I2CPins *self, bool_t high) {
+    HAL_GPIO_WritePin(I2C_BUS_GPIO, I2C_BUS_SDA_PIN, high ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+static bool_t pinReadScl(I2CPins *self) {
+    return HAL_GPIO_ReadPin(I2C_BUS_GPIO, I2C_BUS_SCL_PIN) == GPIO_PIN_SET;
+}
+
+static bool_t pinReadSda(I2CPins *self) {
+    return HAL_GPIO_ReadPin(I2C_BUS_GPIO, I2C_BUS_SDA_PIN) == GPIO_PIN_SET;
+}
+
+static void pinDelay(I2CPins *self) {
+    uint32_t start = busNow(NULL);
+    while (busNow(NULL) - start <= I2C_BUS_RECOVER_HALF_US) {
+    }
+}
+
+/**
+  * @brief   复位外设并释放总线 | Reset the peripheral and free the bus
+  * @note    DeInit 停掉传输、DMA 和中断；MspInit 会把引脚切回 I2C 复用功能，HAL_I2C_Init 内含 SWRST，
+  *          可清掉卡住的 BUSY 位
+  *          DeInit stops the transfer, DMA and interrupts; MspInit switches the pins back to the
+  *          I2C alternate function and HAL_I2C_Init includes a SWRST, which clears a stuck BUSY bit
+  */
+static bool_t busRecover(I2CBus *self) {
+    I2C_HandleTypeDef *hi2c = self->ctx;
+    if (hi2c->hdmatx != NULL) {
+        HAL_DMA_Abort(hi2c->hdmatx);
+    }
+    HAL_I2C_DeInit(hi2c);
+
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Pin = I2C_BUS_SCL_PIN | I2C_BUS_SDA_PIN;
+    gpio.Mode = GPIO_MODE_OUTPUT_OD;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_WritePin(I2C_BUS_GPIO, I2C_BUS_SCL_PIN | I2C_BUS_SDA_PIN, GPIO_PIN_SET);
+    HAL_GPIO_Init(I2C_BUS_GPIO, &gpio);
+
+    I2CPins pins = {
+        .ctx = hi2c,
+        .Scl = pinScl,
+        .Sda = pinSda,
+        .ReadScl = pinReadScl,
+        .ReadSda = pinReadSda,
+        .Delay = pinDelay,
+    };
+    int clocks = I2C_ClockOut(&pins);
+    if (clocks > 0) {
+        i2cBusCounters.clockOuts++;
+    }
+    return HAL_I2C_Init(hi2c) == HAL_OK && clocks >= 0;
+}
+
+/**
+  * @brief   创建仲裁器 | Create the arbiter
+  */
+void I2C_Bus_Init(void) {
+    I2CBus bus = {
+        .ctx = &I2C_BUS_HANDLE,
+        .ticksPerUs = 1,
+        .Start = busStart,
+        .Now = busNow,
+        .Lock = busLock,
+        .Unlock = busUnlock,
+        .Recover = busRecover,
+    };
+    i2cArbiter = newI2CArbiter(bus, I2C_BUS_SEGMENT);
+}
+
+/**
+  * @brief   阻塞执行一次请求 | Run a request and block until it ends
+  * @note    中断和 DMA 传输没有超时：当前段超过 I2C_BUS_TIMEOUT_MS（加每字节 I2C_BUS_TIMEOUT_BYTE_US）仍未结束时让它失败，恢复时复位外设，
+  *          然后继续等待（自己的请求可能还在队列里）。复位后不会再有完成中断，被放弃的那一段只会由这里结束。
+  *          Interrupt and DMA transfers have no timeout: when the current segment is still
+  *          running after I2C_BUS_TIMEOUT_MS (plus I2C_BUS_TIMEOUT_BYTE_US per byte) it is failed and the recovery resets the peripheral,
+  *          then the wait goes on (this request may still be queued). After the reset no
+  *          completion interrupt can arrive, so the abandoned segment is ended only here.
+  */
+int I2C_Bus_Transfer(uint8_t client, I2CRequest *req) {
+    I2CArb_Service(&i2cArbiter);
+    if (I2CArb_Submit(&i2cArbiter, client, req) == I2C_ARB_ERR_FULL) {
+        return -1;
+    }
+    while (req->status == I2C_ARB_PENDING) {
+        uint32_t since = i2cArbiter.activeSince;
+        int32_t running = (int32_t)(busNow(&i2cArbiter.bus) - since);
+        int32_t limit = I2C_BUS_TIMEOUT_MS * 1000 + i2cArbiter.activeLen * I2C_BUS_TIMEOUT_BYTE_US;
+        if (i2cArbiter.busy && since == i2cArbiter.activeSince && running > limit) {
+            i2cBusCounters.timeouts++;
+            I2CArb_Complete(&i2cArbiter, FALSE);
+        }
+        I2CArb_Service(&i2cArbiter);
+    }
+    return (req->status == I2C_ARB_DONE) ? 0 : -1;
+}
+
+void I2C_Bus_Poll(void) {
+    I2CArb_Service(&i2cArbiter);
+}
+
+uint32_t I2C_Bus_Errors(uint8_t client) {
+    return i2cArbiter.stats[client].errors;
+}
+
+int I2C_Bus_Write(uint8_t addr, uint8_t reg, uint16_t len, uint8_t *data) {
+    I2CRequest req = {.addr = (uint8_t)(addr << 1), .reg = reg, .read = FALSE, .split = FALSE, .data = data, .len = len};
+    return I2C_Bus_Transfer(I2C_CLIENT_IMU, &req);
+}
+
+int I2C_Bus_Read(uint8_t addr, uint8_t reg, uint16_t len, uint8_t *data) {
+    I2CRequest req = {.addr = (uint8_t)(addr << 1), .reg = reg, .read = TRUE, .split = FALSE, .data = data, .len = len};
+    return I2C_Bus_Transfer(I2C_CLIENT_IMU, &req);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c == &I2C_BUS_HANDLE) I2CArb_Complete(&i2cArbiter, TRUE);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c == &I2C_BUS_HANDLE) I2CArb_Complete(&i2cArbiter, TRUE);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c != &I2C_BUS_HANDLE) return;
+    if (hi2c->ErrorCode & HAL_I2C_ERROR_AF) {
+        i2cBusCounters.nacks++;
+    } else {
+        i2cBusCounters.busErrors++;
+    }
+    I2CArb_Complete(&i2cArbiter, FALSE);
+}
@@ -51,11 +51,12 @@
 #define min(a,b) ((a<b)?a:b)
    
 #elif defined STM32_MPU6500
-#include "i2c.h"
+#include "i2c_bus.h"
+#include "crc.h"
 #define i2c_write(addr, reg, size, pdata)   \
-				HAL_I2C_Mem_Write(&hi2c1, (addr<<1), reg, I2C_MEMADD_SIZE_8BIT, pdata, size, 100)
+				I2C_Bus_Write(addr, reg, size, pdata)
 #define i2c_read(addr, reg, size, pdata)    \
-				HAL_I2C_Mem_Read(&hi2c1, (addr<<1), reg, I2C_MEMADD_SIZE_8BIT, pdata, size, 100)
+				I2C_Bus_Read(addr, reg, size, pdata)
 				
 #define delay_ms(ms)    HAL_Delay(ms)
 #define get_ms(p)      do{*p = HAL_GetTick();}while(0)
@@ -787,6 +788,75 @@ int mpu_init(struct int_param_s *int_param)
     return 0;
 }
 
+/**
+ *  @brief      Adopt a chip that is already running the DMP.
+ *  After an MCU-only reset the sensor keeps power, so the DMP image and its
+ *  configuration are still in place. Instead of resetting the chip, the cached
+ *  configuration is rebuilt from the registers. Only the program start address
+ *  and the DMP/FIFO enable bits are checked here; the caller must make sure the
+ *  memory holds the expected image before relying on it.
+ *  \n The FIFO has kept filling while the MCU was down and is likely to have
+ *  overflowed, so mpu_reset_fifo should be called before the first read.
+ *  @param[in]  start_addr  Starting address of DMP code memory.
+ *  @param[in]  sample_rate Fixed sampling rate used when DMP is enabled.
+ *  @return     0 if successful, 1 if the DMP is not running (use mpu_init).
+ */
+int mpu_init_warm(unsigned short start_addr, unsigned short sample_rate)
+{
+    unsigned char ctrl[3], cfg[5], pin[2], prgm[2];
+
+    /* user_ctrl, pwr_mgmt_1, pwr_mgmt_2 are consecutive. */
+    if (i2c_read(st.hw->addr, st.reg->user_ctrl, 3, ctrl))
+        return -1;
+    if ((ctrl[0] & (BIT_DMP_EN | BIT_FIFO_EN)) != (BIT_DMP_EN | BIT_FIFO_EN))
+        return 1;
+    if (ctrl[1] & (BIT_RESET | BIT_SLEEP))
+        return 1;
+    if (i2c_read(st.hw->addr, st.reg->prgm_start_h, 2, prgm))
+        return -1;
+    if (((prgm[0] << 8) | prgm[1]) != start_addr)
+        return 1;
+
+    /* rate_div, lpf, gyro_cfg, accel_cfg, accel_cfg2 are consecutive. */
+    if (i2c_read(st.hw->addr, st.reg->rate_div, 5, cfg))
+        return -1;
+    /* int_pin_cfg, int_enable are consecutive. */
+    if (i2c_read(st.hw->addr, st.reg->int_pin_cfg, 2, pin))
+        return -1;
+
+    st.chip_cfg.sensors = 0;
+    if (!(ctrl[2] & BIT_STBY_XG))
+        st.chip_cfg.sensors |= INV_X_GYRO;
+    if (!(ctrl[2] & BIT_STBY_YG))
+        st.chip_cfg.sensors |= INV_Y_GYRO;
+    if (!(ctrl[2] & BIT_STBY_ZG))
+        st.chip_cfg.sensors |= INV_Z_GYRO;
+    if (!(ctrl[2] & BIT_STBY_XYZA))
+        st.chip_cfg.sensors |= INV_XYZ_ACCEL;
+    if (!st.chip_cfg.sensors)
+        return 1;
+
+    st.chip_cfg.clk_src = ctrl[1] & 0x07;
+    st.chip_cfg.sample_rate = 1000 / (1 + cfg[0]);
+    st.chip_cfg.lpf = cfg[1] & 0x07;
+    st.chip_cfg.gyro_fsr = (cfg[2] >> 3) & 0x03;
+    st.chip_cfg.accel_fsr = (cfg[3] >> 3) & 0x03;
+    st.chip_cfg.accel_half = 0;
+    /* What mpu_configure_fifo recorded before the DMP took over the FIFO. */
+    st.chip_cfg.fifo_enable = st.chip_cfg.sensors;
+    st.chip_cfg.int_enable = pin[1];
+    st.chip_cfg.active_low_int = (pin[0] & BIT_ACTL) ? 1 : 0;
+    st.chip_cfg.latched_int = (pin[0] & BIT_LATCH_EN) ? 1 : 0;
+    st.chip_cfg.bypass_mode = (pin[0] & BIT_BYPASS_EN) ? 1 : 0;
+    st.chip_cfg.int_motion_only = 0;
+    st.chip_cfg.lp_accel_mode = 0;
+    memset(&st.chip_cfg.cache, 0, sizeof(st.chip_cfg.cache));
+    st.chip_cfg.dmp_on = 1;
+    st.chip_cfg.dmp_loaded = 1;
+    st.chip_cfg.dmp_sample_rate = sample_rate;
+    return 0;
+}
+
 /**
  *  @brief      Enter low-power accel-only mode.
  *  In low-power accel mode, the chip goes to sleep and only wakes up to sample
@@ -1116,9 +1186,24 @@ int mpu_set_accel_bias_6500_reg(const long *accel_bias) {
 
 /**
  *  @brief  Reset FIFO read/write pointers.
+ *  Blocks for 50 ms; see mpu_reset_fifo_start for the non-blocking form.
  *  @return 0 if successful.
  */
 int mpu_reset_fifo(void)
+{
+    if (mpu_reset_fifo_start())
+        return -1;
+    delay_ms(50);
+    return mpu_reset_fifo_finish();
+}
+
+/**
+ *  @brief  First half of mpu_reset_fifo: stop the FIFO and start the reset.
+ *  The caller waits 50 ms, without blocking if it likes, and then calls
+ *  mpu_reset_fifo_finish. The FIFO delivers nothing in between.
+ *  @return 0 if successful.
+ */
+int mpu_reset_fifo_start(void)
 {
     unsigned char data;
 
@@ -1137,7 +1222,33 @@ int mpu_reset_fifo(void)
         data = BIT_FIFO_RST | BIT_DMP_RST;
         if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
             return -1;
-        delay_ms(50);
+    } else {
+        data = BIT_FIFO_RST;
+        if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
+            return -1;
+        if (st.chip_cfg.bypass_mode || !(st.chip_cfg.sensors & INV_XYZ_COMPASS))
+            data = BIT_FIFO_EN;
+        else
+            data = BIT_FIFO_EN | BIT_AUX_IF_EN;
+        if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
+            return -1;
+    }
+    return 0;
+}
+
+/**
+ *  @brief  Second half of mpu_reset_fifo: re-enable the FIFO and interrupts.
+ *  Call at least 50 ms after mpu_reset_fifo_start. Safe to repeat if it fails.
+ *  @return 0 if successful.
+ */
+int mpu_reset_fifo_finish(void)
+{
+    unsigned char data;
+
+    if (!(st.chip_cfg.sensors))
+        return -1;
+
+    if (st.chip_cfg.dmp_on) {
         data = BIT_DMP_EN | BIT_FIFO_EN;
         if (st.chip_cfg.sensors & INV_XYZ_COMPASS)
             data |= BIT_AUX_IF_EN;
@@ -1153,16 +1264,6 @@ int mpu_reset_fifo(void)
         if (i2c_write(st.hw->addr, st.reg->fifo_en, 1, &data))
             return -1;
     } else {
-        data = BIT_FIFO_RST;
-        if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
-            return -1;
-        if (st.chip_cfg.bypass_mode || !(st.chip_cfg.sensors & INV_XYZ_COMPASS))
-            data = BIT_FIFO_EN;
-        else
-            data = BIT_FIFO_EN | BIT_AUX_IF_EN;
-        if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
-            return -1;
-        delay_ms(50);
         if (st.chip_cfg.int_enable)
             data = BIT_DATA_RDY_EN;
         else
@@ -1804,6 +1905,8 @@ int mpu_read_fifo(short *gyro, short *accel, unsigned long *timestamp,
  *  @param[in]  length  Length of one FIFO packet.
  *  @param[in]  data    FIFO packet.
  *  @param[in]  more    Number of remaining packets.
+ *  @return     0 if successful, -2 on overflow: the FIFO reset has been
+ *  started and the caller calls mpu_reset_fifo_finish after 50 ms.
  */
 int mpu_read_fifo_stream(unsigned short length, unsigned char *data,
     unsigned char *more)
@@ -1827,7 +1930,8 @@ int mpu_read_fifo_stream(unsigned short length, unsigned char *data,
         if (i2c_read(st.hw->addr, st.reg->int_status, 1, tmp))
             return -1;
         if (tmp[0] & BIT_FIFO_OVERFLOW) {
-            mpu_reset_fifo();
+            /* Only started here: the caller finishes it 50 ms later. */
+            mpu_reset_fifo_start();
             return -2;
         }
     }
@@ -2832,6 +2936,9 @@ int mpu_read_mem(unsigned short mem_addr, unsigned short length,
 
 /**
  *  @brief      Load and verify DMP image.
+ *  The image is written one full bank per transfer (a single DMA write on this
+ *  port). With MPU_DMP_VERIFY it is then read back bank by bank in one pass
+ *  and compared by CRC32, instead of a readback and memcmp after every chunk.
  *  @param[in]  length      Length of DMP image.
  *  @param[in]  firmware    DMP code.
  *  @param[in]  start_addr  Starting address of DMP code memory.
@@ -2844,8 +2951,12 @@ int mpu_load_firmware(unsigned short length, const unsigned char *firmware,
     unsigned short ii;
     unsigned short this_write;
     /* Must divide evenly into st.hw->bank_size to avoid bank crossings. */
-#define LOAD_CHUNK  (16)
-    unsigned char cur[LOAD_CHUNK], tmp[2];
+#define LOAD_CHUNK  (256)
+    unsigned char tmp[2];
+#if MPU_DMP_VERIFY
+    unsigned char cur[LOAD_CHUNK];
+    unsigned long crc;
+#endif
 
     if (st.chip_cfg.dmp_loaded)
         /* DMP should only be loaded once. */
@@ -2857,11 +2968,19 @@ int mpu_load_firmware(unsigned short length, const unsigned char *firmware,
         this_write = min(LOAD_CHUNK, length - ii);
         if (mpu_write_mem(ii, this_write, (unsigned char*)&firmware[ii]))
             return -1;
+    }
+
+#if MPU_DMP_VERIFY
+    crc = CRC32_INIT;
+    for (ii = 0; ii < length; ii += this_write) {
+        this_write = min(LOAD_CHUNK, length - ii);
         if (mpu_read_mem(ii, this_write, cur))
             return -1;
-        if (memcmp(firmware+ii, cur, this_write))
-            return -2;
+        crc = CRC32_Update(crc, cur, this_write);
     }
+    if (crc != CRC32_Update(CRC32_INIT, firmware, length))
+        return -2;
+#endif
 
     /* Set program start address. */
     tmp[0] = start_addr >> 8;
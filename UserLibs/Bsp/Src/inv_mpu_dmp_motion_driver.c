@@ -33,12 +33,12 @@
  * get_ms(unsigned long *count)
  */
 #if defined STM32_MPU6500
-#include "i2c.h"   
+#include "i2c_bus.h"   
    
 #define i2c_write(addr, reg, size, pdata)   \
-				HAL_I2C_Mem_Write(&hi2c1, (addr<<1), reg, I2C_MEMADD_SIZE_8BIT, pdata, size, 100)
+				I2C_Bus_Write(addr, reg, size, pdata)
 #define i2c_read(addr, reg, size, pdata)    \
-				HAL_I2C_Mem_Read(&hi2c1, (addr<<1), reg, I2C_MEMADD_SIZE_8BIT, pdata, size, 100)
+				I2C_Bus_Read(addr, reg, size, pdata)
 				
 #define get_ms(p)      do{*p = HAL_GetTick();}while(0)
 
@@ -473,6 +473,21 @@ static struct dmp_s dmp = {
     .packet_length = 0
 };
 
+/* Bytes per FIFO packet for a feature mask. */
+static unsigned char packet_length(unsigned short mask)
+{
+    unsigned char length = 0;
+    if (mask & DMP_FEATURE_SEND_RAW_ACCEL)
+        length += 6;
+    if (mask & DMP_FEATURE_SEND_ANY_GYRO)
+        length += 6;
+    if (mask & (DMP_FEATURE_LP_QUAT | DMP_FEATURE_6X_LP_QUAT))
+        length += 16;
+    if (mask & (DMP_FEATURE_TAP | DMP_FEATURE_ANDROID_ORIENT))
+        length += 4;
+    return length;
+}
+
 /**
  *  @brief  Load the DMP with this image.
  *  @return 0 if successful.
@@ -483,6 +498,29 @@ int dmp_load_motion_driver_firmware(void)
         DMP_SAMPLE_RATE);
 }
 
+/**
+ *  @brief      Attach to a DMP that is already loaded and running.
+ *  Used after an MCU-only reset, when the image and its configuration are
+ *  still in the chip: only the driver state is rebuilt, nothing is written.
+ *  @e mask, @e rate and @e orient must be the values the DMP was set up with.
+ *  @param[in]  mask    Mask of enabled features.
+ *  @param[in]  rate    FIFO rate.
+ *  @param[in]  orient  Gyro and accel orientation in body frame.
+ *  @return     0 if successful, 1 if the DMP is not running.
+ */
+int dmp_init_warm(unsigned short mask, unsigned short rate, unsigned short orient)
+{
+    int result = mpu_init_warm(sStartAddress, DMP_SAMPLE_RATE);
+    if (result)
+        return result;
+
+    dmp.orient = orient;
+    dmp.feature_mask = mask | DMP_FEATURE_PEDOMETER;
+    dmp.fifo_rate = rate;
+    dmp.packet_length = packet_length(mask);
+    return 0;
+}
+
 /**
  *  @brief      Push gyro and accel orientation to the DMP.
  *  The orientation is represented here as the output of
@@ -1066,15 +1104,7 @@ int dmp_enable_feature(unsigned short mask)
     dmp.feature_mask = mask | DMP_FEATURE_PEDOMETER;
     mpu_reset_fifo();
 
-    dmp.packet_length = 0;
-    if (mask & DMP_FEATURE_SEND_RAW_ACCEL)
-        dmp.packet_length += 6;
-    if (mask & DMP_FEATURE_SEND_ANY_GYRO)
-        dmp.packet_length += 6;
-    if (mask & (DMP_FEATURE_LP_QUAT | DMP_FEATURE_6X_LP_QUAT))
-        dmp.packet_length += 16;
-    if (mask & (DMP_FEATURE_TAP | DMP_FEATURE_ANDROID_ORIENT))
-        dmp.packet_length += 4;
+    dmp.packet_length = packet_length(mask);
 
     return 0;
 }
@@ -1231,12 +1261,45 @@ int dmp_set_interrupt_mode(unsigned char mode)
  *  @param[out] timestamp   Timestamp in milliseconds.
  *  @param[out] sensors     Mask of sensors read from FIFO.
  *  @param[out] more        Number of remaining packets.
- *  @return     0 if successful.
+ *  @return     0 if successful, -2 if the FIFO overflowed or lost packet
+ *  alignment: its reset has been started, see mpu_reset_fifo_start.
  */
 int dmp_read_fifo(short *gyro, short *accel, long *quat,
     unsigned long *timestamp, short *sensors, unsigned char *more)
 {
     unsigned char fifo_data[MAX_PACKET_LENGTH];
+    int result;
+
+    sensors[0] = 0;
+
+    /* Get a packet. */
+    result = mpu_read_fifo_stream(dmp.packet_length, fifo_data, more);
+    if (result)
+        return result;
+
+    if (dmp_parse_packet(fifo_data, gyro, accel, quat, sensors)) {
+        mpu_reset_fifo_start();
+        return -2;
+    }
+
+    get_ms(timestamp);
+    return 0;
+}
+
+/**
+ *  @brief      Parse one DMP packet already read from the FIFO.
+ *  Split from dmp_read_fifo so the decode can be timed without the bus
+ *  transfer; the layout follows the features enabled with dmp_enable_feature.
+ *  @param[in]  fifo_data   One packet, dmp.packet_length bytes.
+ *  @param[out] gyro        Gyro data in hardware units.
+ *  @param[out] accel       Accel data in hardware units.
+ *  @param[out] quat        3-axis quaternion data in hardware units.
+ *  @param[out] sensors     Mask of sensors read from the packet.
+ *  @return     0 if successful, -1 if the quaternion shows a corrupted FIFO.
+ */
+int dmp_parse_packet(unsigned char *fifo_data, short *gyro, short *accel,
+    long *quat, short *sensors)
+{
     unsigned char ii = 0;
 
     /* TODO: sensors[0] only changes when dmp_enable_feature is called. We can
@@ -1244,23 +1307,19 @@ int dmp_read_fifo(short *gyro, short *accel, long *quat,
      */
     sensors[0] = 0;
 
-    /* Get a packet. */
-    if (mpu_read_fifo_stream(dmp.packet_length, fifo_data, more))
-        return -1;
-
-    /* Parse DMP packet. */
     if (dmp.feature_mask & (DMP_FEATURE_LP_QUAT | DMP_FEATURE_6X_LP_QUAT)) {
 #ifdef FIFO_CORRUPTION_CHECK
         long quat_q14[4], quat_mag_sq;
 #endif
-        quat[0] = ((long)fifo_data[0] << 24) | ((long)fifo_data[1] << 16) |
-            ((long)fifo_data[2] << 8) | fifo_data[3];
-        quat[1] = ((long)fifo_data[4] << 24) | ((long)fifo_data[5] << 16) |
-            ((long)fifo_data[6] << 8) | fifo_data[7];
-        quat[2] = ((long)fifo_data[8] << 24) | ((long)fifo_data[9] << 16) |
-            ((long)fifo_data[10] << 8) | fifo_data[11];
-        quat[3] = ((long)fifo_data[12] << 24) | ((long)fifo_data[13] << 16) |
-            ((long)fifo_data[14] << 8) | fifo_data[15];
+        /* Assembled as 32 bits so the sign is right wherever long is wider. */
+        quat[0] = (int32_t)(((uint32_t)fifo_data[0] << 24) | ((uint32_t)fifo_data[1] << 16) |
+            ((uint32_t)fifo_data[2] << 8) | fifo_data[3]);
+        quat[1] = (int32_t)(((uint32_t)fifo_data[4] << 24) | ((uint32_t)fifo_data[5] << 16) |
+            ((uint32_t)fifo_data[6] << 8) | fifo_data[7]);
+        quat[2] = (int32_t)(((uint32_t)fifo_data[8] << 24) | ((uint32_t)fifo_data[9] << 16) |
+            ((uint32_t)fifo_data[10] << 8) | fifo_data[11]);
+        quat[3] = (int32_t)(((uint32_t)fifo_data[12] << 24) | ((uint32_t)fifo_data[13] << 16) |
+            ((uint32_t)fifo_data[14] << 8) | fifo_data[15]);
         ii += 16;
 #ifdef FIFO_CORRUPTION_CHECK
         /* We can detect a corrupted FIFO by monitoring the quaternion data and
@@ -1279,8 +1338,8 @@ int dmp_read_fifo(short *gyro, short *accel, long *quat,
             quat_q14[2] * quat_q14[2] + quat_q14[3] * quat_q14[3];
         if ((quat_mag_sq < QUAT_MAG_SQ_MIN) ||
             (quat_mag_sq > QUAT_MAG_SQ_MAX)) {
-            /* Quaternion is outside of the acceptable threshold. */
-            mpu_reset_fifo();
+            /* Quaternion is outside of the acceptable threshold; the caller
+             * resets the FIFO. */
             sensors[0] = 0;
             return -1;
         }
@@ -1310,7 +1369,6 @@ int dmp_read_fifo(short *gyro, short *accel, long *quat,
     if (dmp.feature_mask & (DMP_FEATURE_TAP | DMP_FEATURE_ANDROID_ORIENT))
         decode_gesture(fifo_data + ii);
 
-    get_ms(timestamp);
     return 0;
 }
 
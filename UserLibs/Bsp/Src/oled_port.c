@@ -0,0 +1,68 @@
+#include "oled_port.h"
+#include "i2c_bus.h"
+
+static I2CRequest request = {.status = I2C_ARB_DONE};
+static uint8_t failed = 0;
+
+/**
+  * @brief   只有显存数据可以分段：控制字节随每段重发，屏幕地址自增；命令可能在参数中间被切开
+  *          Only display data may be segmented: the control byte is resent per segment and the
+  *          display auto-increments, while commands could be cut between a command and its argument
+  */
+static void fill(I2CRequest *req, uint8_t control, const uint8_t *data, uint16_t len) {
+    req->addr = OLED_ADDRESS;
+    req->reg = control;
+    req->read = FALSE;
+    req->split = (control == OLED_PORT_DATA);
+    req->data = (uint8_t *)data;
+    req->len = len;
+}
+
+/**
+  * @brief   阻塞写入 | Blocking write
+  */
+void OLED_Port_WriteBlocking(uint8_t control, const uint8_t *data, uint16_t len) {
+    I2CRequest req;
+    fill(&req, control, data, len);
+    I2C_Bus_Transfer(I2C_CLIENT_OLED, &req);
+}
+
+/**
+  * @brief   现在能否开始传输 | Whether a transfer may start now
+  * @note    I2C1 与 MPU6500 共用。屏幕以最低优先级排队，长写入由仲裁器分段，
+  *          所以这里只需等上一次请求结束；IMU 最多等一段。出错后的总线恢复也在这里轮询，IMU 不读时屏幕照样能恢复总线
+  *          I2C1 is shared with the MPU6500. The display queues at the lowest priority and the
+  *          arbiter segments long writes, so this only waits for the previous request; the IMU
+  *          waits for at most one segment. A failed transfer is recovered here as well, so the
+  *          display keeps the bus alive even while the IMU is not polling it
+  */
+uint8_t OLED_Port_Ready(uint16_t len) {
+    (void)len;
+    I2C_Bus_Poll();
+    if (request.status == I2C_ARB_ERR_BUS) {
+        failed = 1;
+        request.status = I2C_ARB_DONE;
+    }
+    return request.status != I2C_ARB_PENDING;
+}
+
+/**
+  * @brief   以后台优先级提交 | Submit at background priority
+  */
+void OLED_Port_Write(uint8_t control, const uint8_t *data, uint16_t len) {
+    fill(&request, control, data, len);
+    if (I2CArb_Submit(&i2cArbiter, I2C_CLIENT_OLED, &request) == I2C_ARB_ERR_FULL) {
+        request.status = I2C_ARB_DONE;
+        failed = 1;
+    }
+}
+
+/**
+  * @brief   取出并清除错误标志 | Fetch and clear the error flag
+  */
+uint8_t OLED_Port_TakeError(void) {
+    OLED_Port_Ready(0);
+    uint8_t f = failed;
+    failed = 0;
+    return f;
+}
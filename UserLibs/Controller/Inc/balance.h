@@ -0,0 +1,81 @@
+#ifndef BALANCE_H_
+#define BALANCE_H_
+
+#include "struct_typedef.h"
+#include "pid.h"
+#include "motion.h"
+
+/**
+  * @file    balance.h
+  * @brief   平衡串级控制器 | Balance cascade controller
+  *
+  * @note    速度环（PI）给出倾角目标，直立环（PD）给出轮子加速度并积分为轮速指令，
+  *          转向环（PI）给出左右轮差速。运动设定值的加速度同时作为倾角和加速度前馈，
+  *          加速时车身提前前倾，直立环不必等待误差出现。
+  *          The velocity loop (PI) yields a pitch target, the upright loop (PD) yields a wheel
+  *          acceleration that is integrated into the wheel speed command, and the turn loop (PI)
+  *          yields the left/right differential. The setpoint acceleration feeds forward into both
+  *          the pitch target and the wheel acceleration, so the body leans into a speed change
+  *          instead of waiting for an error to build up.
+  *          单位：角度 °，角速度 °/s，速度 cm/s | Units: degrees, deg/s, cm/s
+  */
+
+/* 默认增益 | Default gains */
+#define BALANCE_ANGLE_KP        60.0f   /**< 直立环 Kp (cm/s² per °) | Upright Kp */
+#define BALANCE_ANGLE_KD        4.0f    /**< 直立环 Kd (cm/s² per °/s) | Upright Kd */
+#define BALANCE_VELOCITY_KP     0.05f   /**< 速度环 Kp (° per cm/s) | Velocity Kp */
+#define BALANCE_VELOCITY_KI     0.002f  /**< 速度环 Ki (° per cm/s per tick) | Velocity Ki */
+#define BALANCE_TURN_KP         0.05f   /**< 转向环 Kp (cm/s per °/s) | Turn Kp */
+#define BALANCE_TURN_KI         0.002f  /**< 转向环 Ki (cm/s per °/s per tick) | Turn Ki */
+
+/* 限值 | Limits */
+#define BALANCE_MAX_TILT        10.0f   /**< 速度环倾角输出上限 (°) | Velocity loop tilt limit */
+#define BALANCE_MAX_TURN        20.0f   /**< 转向环差速上限 (cm/s) | Turn loop differential limit */
+#define BALANCE_MAX_WHEEL       110.0f  /**< 轮速指令上限 (cm/s) | Wheel speed command limit */
+#define BALANCE_TRACK_CM        16.0f   /**< 轮距 (cm) | Track width */
+#define BALANCE_FALL_ANGLE      40.0f   /**< 超过该倾角视为倒地 (°) | Tilt treated as a fall */
+
+/**
+  * @struct  Balance
+  * @brief   平衡控制器 | Balance controller
+  */
+typedef struct {
+    fp32 angleKp;               /**< 直立环 Kp | Upright Kp */
+    fp32 angleKd;               /**< 直立环 Kd | Upright Kd */
+    pid_type_def velocity;      /**< 速度环 | Velocity loop */
+    pid_type_def turn;          /**< 转向环 | Turn loop */
+    fp32 maxWheel;              /**< 轮速指令上限 (cm/s) | Wheel speed command limit */
+
+    fp32 pitchTarget;           /**< 倾角目标 (°) | Pitch target */
+    fp32 wheelSpeed;            /**< 共模轮速指令 (cm/s) | Common-mode wheel speed command */
+    fp32 left;                  /**< 左轮速度指令 (cm/s) | Left wheel command */
+    fp32 right;                 /**< 右轮速度指令 (cm/s) | Right wheel command */
+    bool_t saturated;           /**< 本周期倾角或轮速指令被限幅 | Tilt or wheel command was clamped this period */
+} Balance;
+
+/**
+  * @brief   创建平衡控制器 | Create a balance controller
+  * @return  控制器 | Controller
+  */
+Balance newBalance(void);
+
+/**
+  * @brief   清除积分和轮速指令（刹车或倒地后调用） | Clear integrators and the wheel command (after braking or a fall)
+  * @param   self  控制器指针 | Pointer to controller
+  */
+void Balance_Reset(Balance *self);
+
+/**
+  * @brief   运行一个控制周期 | Run one control period
+  * @param   self       控制器指针 | Pointer to controller
+  * @param   motion     运动设定值 | Motion setpoints
+  * @param   pitch      去除机械偏置后的倾角 (°)，前倾为正 | Pitch with the mechanical bias removed, forward positive
+  * @param   pitchRate  倾角速度 (°/s) | Pitch rate
+  * @param   yawRate    偏航角速度 (°/s)，左转为正 | Yaw rate, left positive
+  * @param   speed      实测前进速度 (cm/s) | Measured forward speed
+  * @param   dt         周期 (s) | Period
+  */
+void Balance_Update(Balance *self, const Motion *motion, fp32 pitch, fp32 pitchRate,
+                    fp32 yawRate, fp32 speed, fp32 dt);
+
+#endif /* BALANCE_H_ */
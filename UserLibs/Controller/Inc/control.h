@@ -0,0 +1,102 @@
+#ifndef CONTROL_H_
+#define CONTROL_H_
+
+#include "struct_typedef.h"
+#include "motion.h"
+#include "balance.h"
+#include "odometry.h"
+#include "path.h"
+#include "governor.h"
+
+/**
+  * @file    control.h
+  * @brief   一台小车的完整控制栈 | The complete control stack of one car
+  *
+  * @note    里程计、路径跟踪、避障限速、设定值整形和平衡环的全部状态都在 Control 里，
+  *          模块不读写任何全局变量，也不接触硬件：传感器读数由调用者经 ControlInput 送入，
+  *          结果是左右轮速度指令和刹车标志。固件中 CarMove 负责读取硬件并驱动电机；
+  *          主机仿真可以在一个进程、多个线程中同时推进任意多个实例。
+  *          All state of the odometry, path follower, obstacle governor, setpoint shaping and
+  *          balance loop lives in Control. The module reads and writes no globals and touches no
+  *          hardware: the caller passes the sensor readings in a ControlInput and gets back the
+  *          left/right wheel commands and the brake flag. On the firmware CarMove reads the
+  *          hardware and drives the motors; the host simulation can step any number of
+  *          instances in one process, on several threads at once.
+  *          单位：cm、cm/s、°、°/s、s | Units: cm, cm/s, degrees, deg/s, s
+  */
+
+/**
+  * @struct  ControlInput
+  * @brief   一个周期的传感器读数 | Sensor readings of one period
+  */
+typedef struct {
+    fp32 dLeft;             /**< 左轮本周期前进距离 (cm) | Left wheel travel this period */
+    fp32 dRight;            /**< 右轮本周期前进距离 (cm) | Right wheel travel this period */
+    fp32 pitch;             /**< 倾角 (°)，前倾为正，未去除机械偏置 | Pitch, forward positive, mechanical bias not removed */
+    fp32 pitchRate;         /**< 倾角速度 (°/s) | Pitch rate */
+    fp32 yawRate;           /**< 偏航角速度 (°/s)，左转为正 | Yaw rate, left positive */
+    fp32 yaw;               /**< DMP 航向 (°)，±180 | DMP heading, ±180 */
+    bool_t imuReady;        /**< IMU 已给出首帧 | The IMU has delivered its first sample */
+    fp32 range;             /**< 超声波距离 (cm) | Ultrasonic range */
+    bool_t rangeValid;      /**< 距离有效 | Range is valid */
+    fp32 rangeAge;          /**< 距离读数的时长 (s) | Age of the range reading */
+} ControlInput;
+
+/**
+  * @struct  Control
+  * @brief   控制栈 | Control stack
+  */
+typedef struct {
+    /* 配置 | Configuration */
+    fp32 balanceBias;       /**< 机械平衡偏置 (°) | Mechanical balance bias */
+    bool_t useDmpYaw;       /**< 里程计航向：TRUE = DMP yaw 增量，FALSE = gyroz 积分 | Odometry heading: TRUE = DMP yaw increment, FALSE = integrated gyroz */
+
+    /* 控制器 | Controllers */
+    Motion motion;          /**< 运动状态机 | Motion state machine */
+    Balance balance;        /**< 平衡控制器 | Balance controller */
+    Odometry odometry;      /**< 里程计 | Odometry */
+    PathFollower path;      /**< 路径跟踪（CMD_ROAD_PLANNING） | Path follower (CMD_ROAD_PLANNING) */
+    Governor governor;      /**< 避障限速 | Obstacle speed governor */
+    fp32 lastYaw;           /**< 上周期 DMP 航向 (°) | DMP heading at the last period */
+
+    /* 本周期结果 | Results of this period */
+    fp32 speed;             /**< 实测前进速度 (cm/s) | Measured forward speed */
+    fp32 pitch;             /**< 去除偏置后的倾角 (°) | Pitch with the bias removed */
+    bool_t pathUpdated;     /**< 路径跟踪本周期改写了运动目标 | The path follower rewrote the motion targets */
+    bool_t brake;           /**< 刹车：IMU 未就绪、电源关闭或倒地 | Brake: IMU not ready, power off or fallen */
+} Control;
+
+/**
+  * @brief   创建控制栈 | Create a control stack
+  * @param   startSpeed   起步线速度 (cm/s) | Start speed
+  * @param   balanceBias  机械平衡偏置 (°) | Mechanical balance bias
+  * @return  控制栈 | Control stack
+  */
+Control newControl(int8_t startSpeed, fp32 balanceBias);
+
+/**
+  * @brief   设定值部分：里程计、路径跟踪、避障限速与 S 曲线 | Setpoint part: odometry, path following, obstacle governor and S-curves
+  * @param   self  控制栈指针 | Pointer to control stack
+  * @param   in    传感器读数 | Sensor readings
+  * @param   dt    周期 (s) | Period
+  */
+void Control_Setpoints(Control *self, const ControlInput *in, fp32 dt);
+
+/**
+  * @brief   平衡部分：判断刹车，运行平衡环 | Balance part: decide the brake, run the balance loop
+  * @note    轮速指令在 self->balance.left/right (cm/s)，刹车时为 0
+  *          The wheel commands are in self->balance.left/right (cm/s), 0 while braking
+  * @param   self  控制栈指针 | Pointer to control stack
+  * @param   in    传感器读数（与 Control_Setpoints 相同） | Sensor readings (the same as for Control_Setpoints)
+  * @param   dt    周期 (s) | Period
+  */
+void Control_Balance(Control *self, const ControlInput *in, fp32 dt);
+
+/**
+  * @brief   运行一个控制周期 | Run one control period
+  * @note    等于依次调用 Control_Setpoints 与 Control_Balance
+  *          Same as Control_Setpoints followed by Control_Balance
+  */
+void Control_Step(Control *self, const ControlInput *in, fp32 dt);
+
+#endif /* CONTROL_H_ */
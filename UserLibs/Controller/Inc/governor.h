@@ -0,0 +1,76 @@
+#ifndef GOVERNOR_H_
+#define GOVERNOR_H_
+
+#include "struct_typedef.h"
+
+/**
+  * @file    governor.h
+  * @brief   基于碰撞时间的前向限速器 | Forward speed governor based on time-to-collision
+  *
+  * @note    距离取超声波读数，按读数的时间戳用里程计速度外推到当前；停车需要的距离为
+  *          d = v·t + v²/(2a)，其中反应时间 t 包括固定延迟和车身从前倾转回所需的时间（平衡车
+  *          必须先后仰才能减速）。限速取满足 d ≤ 距离 − 安全距离 的最大 v，是距离的连续函数，
+  *          再经 S 曲线整形，因此是平滑减速而不是急停。
+  *          Range comes from the ultrasonic reading, extrapolated to now with the odometry speed
+  *          and the reading's timestamp. Stopping takes d = v·t + v²/(2a), where the reaction time
+  *          t is a fixed latency plus the time for the body to rotate back out of a forward lean
+  *          (a balancing car has to lean back before it can slow down). The cap is the largest v
+  *          with d ≤ range − standoff: a continuous function of range that then goes through the
+  *          S-curve, so the car eases off instead of stopping hard.
+  *          单位：cm、cm/s、°、s | Units: cm, cm/s, degrees, s
+  */
+
+#define GOVERNOR_PERIOD         0.02f   /**< 外环周期 (s)，50 Hz | Outer loop period, 50 Hz */
+#define GOVERNOR_DECEL          30.0f   /**< 规划减速度 (cm/s²)，低于运动加速度上限 | Planned deceleration, below the motion limit */
+#define GOVERNOR_LATENCY        0.35f   /**< 固定反应时间 (s)：测距周期、加加速度爬升、直立环滞后 | Fixed reaction time: ranging cycle, jerk ramp, upright loop lag */
+#define GOVERNOR_TILT_RATE      30.0f   /**< 车身后仰速度 (°/s)，前倾折算为额外反应时间 | Lean-back rate; a forward lean adds reaction time */
+#define GOVERNOR_STANDOFF       15.0f   /**< 停车时与障碍的距离 (cm) | Distance kept from the obstacle when stopped */
+#define GOVERNOR_TTC_WARN       1.5f    /**< 碰撞时间低于此值视为检测到障碍 (s) | TTC below this counts as an obstacle */
+#define GOVERNOR_MAX_AGE        0.3f    /**< 读数超过该时长视为过期 (s) | Readings older than this are stale */
+#define GOVERNOR_NO_LIMIT       1000.0f /**< 无障碍时的限速 (cm/s) | Cap when nothing is ahead */
+
+/**
+  * @struct  Governor
+  * @brief   限速器 | Speed governor
+  */
+typedef struct {
+    fp32 decel;             /**< 规划减速度 (cm/s²) | Planned deceleration */
+    fp32 latency;           /**< 固定反应时间 (s) | Fixed reaction time */
+    fp32 standoff;          /**< 安全距离 (cm) | Standoff distance */
+    fp32 elapsed;           /**< 距上次更新的时间 (s) | Time since the last update */
+
+    fp32 distance;          /**< 外推到当前的障碍距离 (cm)，无障碍为 GOVERNOR_NO_LIMIT | Range extrapolated to now */
+    fp32 ttc;               /**< 碰撞时间 (s)，远离时为 GOVERNOR_NO_LIMIT | Time to collision */
+    fp32 limit;             /**< 前进限速 (cm/s) | Forward speed cap */
+    bool_t obstacle;        /**< 检测到障碍（TTC 过小或已在安全距离内） | Obstacle detected (TTC too short or inside the standoff) */
+} Governor;
+
+/**
+  * @brief   创建限速器（不限速） | Create a governor (no cap)
+  * @return  限速器 | Governor
+  */
+Governor newGovernor(void);
+
+/**
+  * @brief   推进时间，到达外环周期时更新限速 | Advance time and update the cap when an outer period is due
+  * @param   self    限速器指针 | Pointer to governor
+  * @param   range   超声波距离 (cm) | Ultrasonic range
+  * @param   valid   读数有效 | Reading valid
+  * @param   age     读数年龄 (s) | Reading age
+  * @param   speed   里程计线速度 (cm/s)，前进为正 | Odometry linear speed, forward positive
+  * @param   pitch   车身倾角 (°)，前倾为正 | Body pitch, forward positive
+  * @param   dt      控制周期 (s) | Control period
+  * @return  TRUE 本次更新了限速 | TRUE if the cap was updated
+  */
+bool_t Governor_Update(Governor *self, fp32 range, bool_t valid, fp32 age, fp32 speed, fp32 pitch, fp32 dt);
+
+/**
+  * @brief   给定距离下允许的最大速度 | Largest speed that can still stop within a distance
+  * @param   self      限速器指针 | Pointer to governor
+  * @param   distance  可用距离 (cm) | Available distance
+  * @param   pitch     车身倾角 (°) | Body pitch
+  * @return  速度上限 (cm/s) | Speed cap
+  */
+fp32 Governor_SpeedFor(const Governor *self, fp32 distance, fp32 pitch);
+
+#endif /* GOVERNOR_H_ */
@@ -0,0 +1,99 @@
+#ifndef MOTION_H_
+#define MOTION_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+#include "scurve.h"
+
+/**
+  * @file    motion.h
+  * @brief   运动命令状态机与设定值整形 | Motion command state machine and setpoint shaping
+  *
+  * @note    命令通过查表分发到各处理函数，处理函数只修改目标；线速度和角速度设定值
+  *          由 S 曲线发生器平滑，平衡环得到的是连续、加速度有界的设定值及其加速度前馈
+  *          Commands are dispatched through a table to handlers that only change targets; the
+  *          linear and angular setpoints are smoothed by S-curve generators, so the balance loop
+  *          sees continuous, acceleration-bounded setpoints plus their acceleration feed-forward
+  */
+
+/* 线速度限值 (cm/s) | Linear limits */
+#define MOTION_MAX_LINEAR       50.0f   /**< 最大线速度 | Max linear speed */
+#define MOTION_SPEED_STEP       5       /**< 加减速步长 | Speed up/down step */
+#define MOTION_LINEAR_ACC       40.0f   /**< 常规加速度 (cm/s²) | Normal acceleration */
+#define MOTION_LINEAR_JERK      150.0f  /**< 常规加加速度 (cm/s³) | Normal jerk */
+#define MOTION_SLOW_ACC         15.0f   /**< 缓慢停止加速度 | Stop-slowly acceleration */
+#define MOTION_SLOW_JERK        40.0f   /**< 缓慢停止加加速度 | Stop-slowly jerk */
+#define MOTION_STOP_ACC         80.0f   /**< 急停加速度 | Hard-stop acceleration */
+#define MOTION_STOP_JERK        400.0f  /**< 急停加加速度 | Hard-stop jerk */
+
+/* 角速度限值 (°/s) | Angular limits */
+#define MOTION_TURN_RATE        90.0f   /**< 转向角速度 | Turn rate */
+#define MOTION_MAX_ANGULAR      180.0f  /**< 最大角速度 | Max angular speed */
+#define MOTION_ANGULAR_ACC      360.0f  /**< 角加速度 (°/s²) | Angular acceleration */
+#define MOTION_ANGULAR_JERK     1800.0f /**< 角加加速度 (°/s³) | Angular jerk */
+
+/**
+  * @brief   小车运动状态枚举 | Car motion state enumeration
+  */
+typedef enum {
+    CAR_MOTION_STOP = 0,     /**< 停止 | Stop */
+    CAR_MOTION_FOWARD,       /**< 前进 | Forward */
+    CAR_MOTION_BACKWARD,     /**< 后退 | Backward */
+    CAR_MOTION_LEFT,         /**< 左转 | Left turn */
+    CAR_MOTION_RIGHT         /**< 右转 | Right turn */
+} MotionState;
+
+typedef struct Motion Motion;
+
+/**
+  * @struct  Motion
+  * @brief   运动状态机 | Motion state machine
+  */
+struct Motion {
+    bool_t enabled;             /**< 电源开关（关闭时电机刹车） | Power switch (motors brake when off) */
+    bool_t constantSpeed;       /**< 固定速度模式（忽略加减速） | Constant speed mode (speed up/down ignored) */
+    bool_t roadPlanning;        /**< 路径跟踪模式 | Path following mode */
+    uint8_t state;              /**< 运动状态 MotionState | Motion state */
+    int8_t startSpeed;          /**< 起步线速度 (cm/s) | Start speed */
+    int8_t cruiseSpeed;         /**< 巡航线速度 (cm/s) | Cruise speed */
+    int8_t direction;           /**< 行驶方向 +1/-1/0 | Travel direction +1/-1/0 */
+    fp32 turnRemaining;         /**< 掉头剩余角度 (°)，0 表示不在掉头 | Remaining turn-around angle, 0 when idle */
+    fp32 speedLimit;            /**< 前进限速 (cm/s)，由避障限速器设置 | Forward speed cap, set by the obstacle governor */
+
+    SCurve linear;              /**< 线速度发生器 (cm/s) | Linear speed generator */
+    SCurve angular;             /**< 角速度发生器 (°/s) | Angular speed generator */
+};
+
+/**
+  * @brief   创建运动状态机 | Create a motion state machine
+  * @param   startSpeed  起步线速度 (cm/s) | Start speed
+  * @return  运动状态机 | Motion state machine
+  */
+Motion newMotion(int8_t startSpeed);
+
+/**
+  * @brief   分发一条运动命令 | Dispatch one motion command
+  * @param   self  状态机指针 | Pointer to state machine
+  * @param   cmd   命令 CMD_* | Command CMD_*
+  * @return  TRUE 已处理，FALSE 未知命令 | TRUE if handled, FALSE for an unknown command
+  */
+bool_t Motion_Dispatch(Motion *self, uint8_t cmd);
+
+/**
+  * @brief   推进设定值一个周期 | Advance the setpoints by one period
+  * @note    前进目标超过 speedLimit 时按限速整形，命令目标本身保留，限速解除后恢复
+  *          A forward target above speedLimit is shaped towards the cap; the commanded target
+  *          itself is kept and comes back once the cap lifts
+  * @param   self  状态机指针 | Pointer to state machine
+  * @param   dt    周期 (s) | Period
+  */
+void Motion_Update(Motion *self, fp32 dt);
+
+/**
+  * @brief   按名称查找命令（"FORWARD" 等，用于脚本和工具） | Look up a command by name ("FORWARD", ... for scripts and tools)
+  * @param   name  命令名 | Command name
+  * @return  命令值，未找到返回 -1 | Command value, -1 if not found
+  */
+int Motion_CommandByName(const char *name);
+
+#endif /* MOTION_H_ */
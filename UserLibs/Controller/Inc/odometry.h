@@ -0,0 +1,96 @@
+#ifndef ODOMETRY_H_
+#define ODOMETRY_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    odometry.h
+  * @brief   差速里程计与航向融合 | Differential-drive odometry with heading fusion
+  *
+  * @note    距离来自两侧编码器；航向由互补滤波融合 IMU 航向增量（DMP yaw 或 gyroz 积分）
+  *          和编码器差速航向：IMU 负责高频（打滑、颠簸时不受影响），编码器负责低频（不随零偏漂移）。
+  *          Distance comes from both encoders; heading is a complementary filter between the IMU
+  *          heading increment (DMP yaw or integrated gyroz) and the encoder differential heading:
+  *          the IMU covers high frequencies (immune to slip and bumps), the encoders cover low
+  *          frequencies (no bias drift).
+  *          θ_k = α·(θ_{k−1} + Δθ_imu) + (1 − α)·θ_enc,k,  α = τ / (τ + dt)
+  */
+
+/* 默认融合时间常数 (s)：τ 越大越信任 IMU。DMP 航向的漂移比 gyroz 零偏小一个数量级，τ 也相应取大；
+   τ 过小时编码器的打滑误差会拉偏 DMP 航向
+   Default fusion time constants: larger trusts the IMU more. The DMP yaw drifts an order of
+   magnitude less than the gyroz bias, so its τ is that much longer; too short a τ lets encoder
+   slip pull the DMP heading off */
+#define ODOMETRY_FUSION_TAU     10.0f   /**< gyroz 积分 | Integrated gyroz */
+#define ODOMETRY_DMP_FUSION_TAU 100.0f  /**< DMP yaw 增量 | DMP yaw increment */
+
+/**
+  * @struct  Pose
+  * @brief   位姿快照 | Pose snapshot
+  */
+typedef struct {
+    fp32 x;                 /**< 位置 X (cm) | Position X */
+    fp32 y;                 /**< 位置 Y (cm)，左为正 | Position Y, left positive */
+    fp32 heading;           /**< 航向 (°)，−180..180，逆时针为正 | Heading, counter-clockwise positive */
+    fp32 v;                 /**< 线速度 (cm/s) | Linear speed */
+    fp32 omega;             /**< 角速度 (°/s) | Angular speed */
+    uint32_t tick;          /**< 更新次数 | Update count */
+} Pose;
+
+/**
+  * @struct  Odometry
+  * @brief   里程计 | Odometry
+  */
+typedef struct {
+    fp32 track;             /**< 轮距 (cm) | Track width */
+    fp32 tau;               /**< 融合时间常数 (s)，≤0 只用编码器 | Fusion time constant, ≤0 uses the encoders only */
+
+    fp32 x, y;              /**< 位置 (cm) | Position */
+    fp32 heading;           /**< 融合航向，不回绕 (rad) | Fused heading, unwrapped */
+    fp32 encHeading;        /**< 纯编码器航向，不回绕 (rad) | Encoder-only heading, unwrapped */
+    fp32 v, omega;          /**< 速度 (cm/s, rad/s) | Speeds */
+    uint32_t tick;          /**< 更新次数 | Update count */
+
+    volatile uint32_t seq;  /**< 快照序号，奇数表示正在写 | Snapshot sequence, odd while writing */
+    Pose snapshot;          /**< 已发布的位姿 | Published pose */
+} Odometry;
+
+/**
+  * @brief   创建里程计 | Create odometry
+  * @param   track  轮距 (cm) | Track width
+  * @param   tau    融合时间常数 (s) | Fusion time constant
+  * @return  里程计 | Odometry
+  */
+Odometry newOdometry(fp32 track, fp32 tau);
+
+/**
+  * @brief   位姿清零 | Reset the pose to the origin
+  * @param   self  里程计指针 | Pointer to odometry
+  */
+void Odometry_Reset(Odometry *self);
+
+/**
+  * @brief   积分一个周期 | Integrate one period
+  * @param   self      里程计指针 | Pointer to odometry
+  * @param   dLeft     左轮行程 (cm) | Left wheel travel
+  * @param   dRight    右轮行程 (cm) | Right wheel travel
+  * @param   dYawImu   IMU 航向增量 (°)，逆时针为正 | IMU heading increment, counter-clockwise positive
+  * @param   dt        周期 (s) | Period
+  */
+void Odometry_Update(Odometry *self, fp32 dLeft, fp32 dRight, fp32 dYawImu, fp32 dt);
+
+/**
+  * @brief   读取一致的位姿快照 | Read a consistent pose snapshot
+  * @param   self  里程计指针 | Pointer to odometry
+  * @param   pose  输出位姿 | Output pose
+  * @note    序号锁（seqlock.h）：写者不会被阻塞，读到写了一半的数据时重读。只能在运行 Odometry_Update
+  *          的上下文或可被它打断的低优先级上下文中调用；打断 Odometry_Update 的中断会永远自旋。
+  *          Sequence lock (seqlock.h): the writer is never blocked and a reader that saw a
+  *          half-written pose retries. Call only from the context that runs Odometry_Update or a
+  *          lower-priority one it can preempt; an interrupt that preempts Odometry_Update would
+  *          spin forever.
+  */
+void Odometry_GetPose(const Odometry *self, Pose *pose);
+
+#endif /* ODOMETRY_H_ */
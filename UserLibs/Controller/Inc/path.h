@@ -0,0 +1,123 @@
+#ifndef PATH_H_
+#define PATH_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+#include "odometry.h"
+#include "protocol.h"
+
+/**
+  * @file    path.h
+  * @brief   航点路径跟踪（纯追踪） | Waypoint path following (pure pursuit)
+  *
+  * @note    航点通过串口上传到固定大小的静态缓冲区。每次更新只检查当前线段之后
+  *          PATH_SEARCH_WINDOW 段来寻找最近点和前视点，因此单次开销有上界，与路径长度无关。
+  *          Waypoints are uploaded over UART into a fixed-size static buffer. Each update only
+  *          examines PATH_SEARCH_WINDOW segments past the current one to find the closest point
+  *          and the look-ahead point, so the per-update cost is bounded regardless of path length.
+  *          单位：cm、cm/s、°/s | Units: cm, cm/s, deg/s
+  */
+
+#define PATH_MAX_WAYPOINTS      64      /**< 航点缓冲区容量 | Waypoint buffer capacity */
+#define PATH_SEARCH_WINDOW      4       /**< 每次更新最多检查的线段数 | Segments examined per update */
+#define PATH_PERIOD             0.02f   /**< 外环周期 (s)，50 Hz | Outer loop period, 50 Hz */
+#define PATH_SPEED              25.0f   /**< 巡航速度 (cm/s) | Cruise speed */
+#define PATH_DECEL              20.0f   /**< 终点前减速度 (cm/s²) | Deceleration approaching the goal */
+#define PATH_LOOKAHEAD          12.0f   /**< 最小前视距离 (cm) | Minimum look-ahead distance */
+#define PATH_LOOKAHEAD_TIME     0.4f    /**< 前视时间 (s)，前视距离随速度增加 | Look-ahead time, distance grows with speed */
+#define PATH_MAX_TURN           120.0f  /**< 角速度上限 (°/s) | Angular speed limit */
+#define PATH_GOAL_TOLERANCE     2.0f    /**< 到达终点判定距离 (cm) | Goal reached distance */
+
+/* 协议负载 | Protocol payloads
+ * MSG_PATH_CLEAR  [] → [status]
+ * MSG_PATH_APPEND [index n×(x f32, y f32)] → [status count]，按 index 写入，重发幂等 | written at index, idempotent on retry
+ * MSG_PATH_INFO   [] → [count active finished segment cross_track f32 remaining f32] */
+#define PATH_OK                 0
+#define PATH_ERR_BUSY           (-1)    /**< 正在跟踪时不能修改 | Cannot modify while following */
+#define PATH_ERR_RANGE          (-2)    /**< 索引越界或缓冲区已满 | Index out of range or buffer full */
+#define PATH_ERR_FORMAT         (-3)    /**< 负载长度不对 | Bad payload length */
+
+/**
+  * @struct  Waypoint
+  * @brief   航点 | Waypoint
+  */
+typedef struct {
+    fp32 x;                 /**< X (cm) | X */
+    fp32 y;                 /**< Y (cm) | Y */
+    fp32 s;                 /**< 从起点起的累计弧长 (cm) | Arc length from the start */
+} Waypoint;
+
+/**
+  * @struct  PathFollower
+  * @brief   路径跟踪器 | Path follower
+  */
+typedef struct {
+    Waypoint points[PATH_MAX_WAYPOINTS];    /**< 航点缓冲区 | Waypoint buffer */
+    uint8_t count;                          /**< 有效航点数 | Valid waypoints */
+
+    bool_t active;                          /**< 正在跟踪 | Following */
+    bool_t finished;                        /**< 已到达终点 | Goal reached */
+    uint8_t segment;                        /**< 当前线段（只增不减） | Current segment (never decreases) */
+    fp32 elapsed;                           /**< 距上次外环更新的时间 (s) | Time since the last outer update */
+
+    fp32 crossTrack;                        /**< 横向误差 (cm)，路径左侧为正 | Cross-track error, left of path positive */
+    fp32 remaining;                         /**< 剩余弧长 (cm) | Remaining arc length */
+    fp32 linear;                            /**< 线速度输出 (cm/s) | Linear speed output */
+    fp32 angular;                           /**< 角速度输出 (°/s) | Angular speed output */
+} PathFollower;
+
+/**
+  * @brief   创建跟踪器（空路径） | Create a follower with an empty path
+  * @return  跟踪器 | Follower
+  */
+PathFollower newPathFollower(void);
+
+/**
+  * @brief   清空路径 | Clear the path
+  * @param   self  跟踪器指针 | Pointer to follower
+  * @return  PATH_OK 或 PATH_ERR_BUSY | PATH_OK or PATH_ERR_BUSY
+  */
+int Path_Clear(PathFollower *self);
+
+/**
+  * @brief   在 index 处写入航点（index ≤ count，可覆盖已有航点） | Write waypoints at index (index ≤ count, may overwrite)
+  * @param   self   跟踪器指针 | Pointer to follower
+  * @param   index  起始索引 | Start index
+  * @param   xy     交错的 x,y 坐标 (cm) | Interleaved x,y coordinates
+  * @param   n      航点数 | Waypoint count
+  * @return  PATH_OK 或错误码 | PATH_OK or an error code
+  */
+int Path_Write(PathFollower *self, uint8_t index, const fp32 *xy, uint8_t n);
+
+/**
+  * @brief   开始跟踪（从第一段开始） | Start following from the first segment
+  * @param   self  跟踪器指针 | Pointer to follower
+  */
+void Path_Start(PathFollower *self);
+
+/**
+  * @brief   停止跟踪 | Stop following
+  * @param   self  跟踪器指针 | Pointer to follower
+  */
+void Path_Stop(PathFollower *self);
+
+/**
+  * @brief   推进时间，到达外环周期时更新输出 | Advance time and update the outputs when an outer period is due
+  * @param   self  跟踪器指针 | Pointer to follower
+  * @param   pose  当前位姿 | Current pose
+  * @param   dt    控制周期 (s) | Control period
+  * @return  TRUE 本次更新了输出 | TRUE if the outputs were updated
+  */
+bool_t Path_Update(PathFollower *self, const Pose *pose, fp32 dt);
+
+/**
+  * @brief   处理路径协议帧 | Handle a path protocol frame
+  * @param   self   跟踪器指针 | Pointer to follower
+  * @param   req    请求帧 | Request frame
+  * @param   reply  应答负载缓冲区（≥ PROTOCOL_MAX_PAYLOAD） | Reply payload buffer (≥ PROTOCOL_MAX_PAYLOAD)
+  * @param   len    应答负载长度 | Reply payload length
+  * @return  应答消息类型，非路径消息返回 0 | Reply message type, 0 if not a path message
+  */
+uint8_t Path_HandleFrame(PathFollower *self, const Frame *req, uint8_t *reply, uint8_t *len);
+
+#endif /* PATH_H_ */
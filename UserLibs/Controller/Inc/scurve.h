@@ -0,0 +1,78 @@
+#ifndef SCURVE_H_
+#define SCURVE_H_
+
+#include "struct_typedef.h"
+
+/**
+  * @file    scurve.h
+  * @brief   加加速度受限（S 曲线）设定值发生器 | Jerk-limited (S-curve) setpoint generator
+  *
+  * @note    在线生成：目标可随时改变，每周期计算量固定。速度、加速度、加加速度都受限，
+  *          接近目标时加速度按 a = sqrt(2·J·|e|) 减小，恰好以零加速度到达目标，不会超调。
+  *          Online: the target may change at any time and each step costs the same. Velocity,
+  *          acceleration and jerk are all bounded; near the target acceleration follows
+  *          a = sqrt(2·J·|e|), so the target is reached with zero acceleration and no overshoot.
+  */
+
+/**
+  * @struct  SCurve
+  * @brief   S 曲线发生器 | S-curve generator
+  */
+typedef struct {
+    fp32 maxVel;        /**< 速度上限 | Velocity limit */
+    fp32 maxAcc;        /**< 加速度上限 | Acceleration limit */
+    fp32 maxJerk;       /**< 加加速度上限 | Jerk limit */
+
+    fp32 target;        /**< 目标速度 | Target velocity */
+    fp32 vel;           /**< 当前速度设定值 | Current velocity setpoint */
+    fp32 acc;           /**< 当前加速度 | Current acceleration */
+    fp32 pos;           /**< 设定值积分（距离/角度） | Integrated setpoint (distance/angle) */
+} SCurve;
+
+/**
+  * @brief   初始化发生器 | Init generator
+  * @param   self     发生器指针 | Pointer to generator
+  * @param   maxVel   速度上限 | Velocity limit
+  * @param   maxAcc   加速度上限 | Acceleration limit
+  * @param   maxJerk  加加速度上限 | Jerk limit
+  */
+void SCurve_Init(SCurve *self, fp32 maxVel, fp32 maxAcc, fp32 maxJerk);
+
+/**
+  * @brief   修改加速度和加加速度上限（正在进行的过渡保持连续） | Change acceleration/jerk limits (an ongoing transition stays continuous)
+  * @param   self     发生器指针 | Pointer to generator
+  * @param   maxAcc   加速度上限 | Acceleration limit
+  * @param   maxJerk  加加速度上限 | Jerk limit
+  */
+void SCurve_SetLimits(SCurve *self, fp32 maxAcc, fp32 maxJerk);
+
+/**
+  * @brief   设置目标速度（按速度上限截断） | Set target velocity (clamped to the velocity limit)
+  * @param   self    发生器指针 | Pointer to generator
+  * @param   target  目标速度 | Target velocity
+  */
+void SCurve_SetTarget(SCurve *self, fp32 target);
+
+/**
+  * @brief   立即跳到给定速度，加速度清零 | Jump to a velocity immediately with zero acceleration
+  * @param   self  发生器指针 | Pointer to generator
+  * @param   vel   速度 | Velocity
+  */
+void SCurve_Reset(SCurve *self, fp32 vel);
+
+/**
+  * @brief   前进一个周期 | Advance one period
+  * @param   self  发生器指针 | Pointer to generator
+  * @param   dt    周期 (s) | Period
+  * @return  新的速度设定值 | New velocity setpoint
+  */
+fp32 SCurve_Update(SCurve *self, fp32 dt);
+
+/**
+  * @brief   以当前限值从当前速度减到零所需的距离（带符号） | Signed distance needed to slow from the current velocity to zero
+  * @param   self  发生器指针 | Pointer to generator
+  * @return  停止距离 | Stopping distance
+  */
+fp32 SCurve_StopDistance(const SCurve *self);
+
+#endif /* SCURVE_H_ */
@@ -0,0 +1,69 @@
+#include "balance.h"
+#include <math.h>
+
+#define GRAVITY_CM      981.0f          /**< 重力加速度 (cm/s²) | Gravity */
+#define RAD_TO_DEG      57.29578f
+#define DEG_TO_RAD      0.01745329f
+
+/**
+  * @brief   创建平衡控制器 | Create a balance controller
+  */
+Balance newBalance(void) {
+    Balance b = {
+            .angleKp  = BALANCE_ANGLE_KP,
+            .angleKd  = BALANCE_ANGLE_KD,
+            .maxWheel = BALANCE_MAX_WHEEL
+    };
+    const fp32 velocity_k[3] = {BALANCE_VELOCITY_KP, BALANCE_VELOCITY_KI, 0.0f};
+    const fp32 turn_k[3] = {BALANCE_TURN_KP, BALANCE_TURN_KI, 0.0f};
+    PID_init(&b.velocity, PID_POSITION, velocity_k, BALANCE_MAX_TILT, BALANCE_MAX_TILT / 2.0f);
+    PID_init(&b.turn, PID_POSITION, turn_k, BALANCE_MAX_TURN, BALANCE_MAX_TURN / 2.0f);
+    Balance_Reset(&b);
+    return b;
+}
+
+/**
+  * @brief   清除积分和轮速指令 | Clear integrators and the wheel command
+  */
+void Balance_Reset(Balance *self) {
+    PID_clear(&self->velocity);
+    PID_clear(&self->turn);
+    self->pitchTarget = 0.0f;
+    self->wheelSpeed = 0.0f;
+    self->left = 0.0f;
+    self->right = 0.0f;
+    self->saturated = FALSE;
+}
+
+/**
+  * @brief   运行一个控制周期 | Run one control period
+  * @note    稳态下加速度 a 对应倾角 atan(a/g)；前馈同时给出该倾角和加速度，
+  *          使直立环在跟踪设定值时误差为零
+  *          At steady state an acceleration a needs a lean of atan(a/g); the feed-forward supplies
+  *          both that lean and the acceleration, so the upright loop has zero error while tracking
+  */
+void Balance_Update(Balance *self, const Motion *motion, fp32 pitch, fp32 pitchRate,
+                    fp32 yawRate, fp32 speed, fp32 dt) {
+    fp32 accFf = motion->linear.acc;
+    fp32 tiltFf = atanf(accFf / GRAVITY_CM) * RAD_TO_DEG;
+
+    // 速度环 | Velocity loop
+    self->pitchTarget = tiltFf + PID_calc(&self->velocity, speed, motion->linear.vel);
+
+    // 直立环：积分加速度得到轮速 | Upright loop: integrate acceleration into wheel speed
+    fp32 acc = self->angleKp * (pitch - self->pitchTarget) + self->angleKd * pitchRate + accFf;
+    self->wheelSpeed += acc * dt;
+
+    // 转向环：前馈 ω·B/2 加 PI 修正 | Turn loop: ω·B/2 feed-forward plus PI correction
+    fp32 diff = motion->angular.vel * DEG_TO_RAD * (BALANCE_TRACK_CM / 2.0f)
+              + PID_calc(&self->turn, yawRate, motion->angular.vel);
+
+    // 限幅时保留差速，牺牲共模 | When clamping keep the differential, give up common mode
+    fp32 common = self->maxWheel - fabsf(diff);
+    self->saturated = (fabsf(self->wheelSpeed) > common ||
+                       fabsf(self->velocity.out) >= self->velocity.max_out) ? TRUE : FALSE;
+    self->wheelSpeed = LIMIT(self->wheelSpeed, -common, common);
+
+    self->left = self->wheelSpeed - diff;
+    self->right = self->wheelSpeed + diff;
+}
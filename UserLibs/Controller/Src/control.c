@@ -0,0 +1,87 @@
+#include "control.h"
+#include "command.h"
+#include <math.h>
+
+/**
+  * @brief   创建控制栈 | Create a control stack
+  */
+Control newControl(int8_t startSpeed, fp32 balanceBias) {
+    Control c = {
+            .balanceBias = balanceBias,
+            .useDmpYaw   = TRUE,
+            .motion      = newMotion(startSpeed),
+            .balance     = newBalance(),
+            .odometry    = newOdometry(BALANCE_TRACK_CM, ODOMETRY_DMP_FUSION_TAU),
+            .path        = newPathFollower(),
+            .governor    = newGovernor(),
+            .brake       = TRUE
+    };
+    return c;
+}
+
+/**
+  * @brief   设定值部分 | Setpoint part
+  */
+void Control_Setpoints(Control *self, const ControlInput *in, fp32 dt) {
+    self->speed = 0.5f * (in->dLeft + in->dRight) / dt;
+    self->pitch = in->pitch - self->balanceBias;
+
+    // 里程计；IMU 首帧之前航向无效，不计入 | Odometry; the heading is not valid before the first IMU sample
+    if (!in->imuReady) {
+        self->lastYaw = in->yaw;
+    }
+    fp32 dYaw;
+    if (self->useDmpYaw) {
+        dYaw = remainderf(in->yaw - self->lastYaw, 360.0f);    // 跨 ±180° 回绕 | Across the ±180° wrap
+    } else {
+        dYaw = in->yawRate * dt;
+    }
+    self->lastYaw = in->yaw;
+    Odometry_Update(&self->odometry, in->dLeft, in->dRight, dYaw, dt);
+
+    // 路径跟踪以 50 Hz 改写运动目标 | Path following rewrites the motion targets at 50 Hz
+    self->pathUpdated = FALSE;
+    if (self->motion.roadPlanning) {
+        if (!self->path.active) {
+            Path_Start(&self->path);
+        }
+        Pose pose;
+        Odometry_GetPose(&self->odometry, &pose);
+        if (Path_Update(&self->path, &pose, dt)) {
+            self->pathUpdated = TRUE;
+            SCurve_SetTarget(&self->motion.linear, self->path.linear);
+            SCurve_SetTarget(&self->motion.angular, self->path.angular);
+            if (self->path.finished) {
+                Motion_Dispatch(&self->motion, CMD_ROAD_PLANNING);  // 到达终点，退出并缓停 | Goal reached: leave and stop slowly
+            }
+        }
+    } else if (self->path.active) {
+        Path_Stop(&self->path);
+    }
+
+    // 避障限速，与路径跟踪同为 50 Hz 外环 | Obstacle governor, a 50 Hz outer loop like path following
+    Governor_Update(&self->governor, in->range, in->rangeValid, in->rangeAge, self->odometry.v, self->pitch, dt);
+    self->motion.speedLimit = self->governor.limit;
+
+    Motion_Update(&self->motion, dt);
+}
+
+/**
+  * @brief   平衡部分 | Balance part
+  */
+void Control_Balance(Control *self, const ControlInput *in, fp32 dt) {
+    self->brake = (!in->imuReady || !self->motion.enabled || fabsf(self->pitch) > BALANCE_FALL_ANGLE) ? TRUE : FALSE;
+    if (self->brake) {
+        Balance_Reset(&self->balance);
+    } else {
+        Balance_Update(&self->balance, &self->motion, self->pitch, in->pitchRate, in->yawRate, self->speed, dt);
+    }
+}
+
+/**
+  * @brief   运行一个控制周期 | Run one control period
+  */
+void Control_Step(Control *self, const ControlInput *in, fp32 dt) {
+    Control_Setpoints(self, in, dt);
+    Control_Balance(self, in, dt);
+}
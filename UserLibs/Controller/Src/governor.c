@@ -0,0 +1,54 @@
+#include "governor.h"
+#include <math.h>
+
+/**
+  * @brief   创建限速器 | Create a governor
+  */
+Governor newGovernor(void) {
+    Governor g = {
+            .decel    = GOVERNOR_DECEL,
+            .latency  = GOVERNOR_LATENCY,
+            .standoff = GOVERNOR_STANDOFF,
+            .elapsed  = GOVERNOR_PERIOD,    // 第一次调用立即更新 | Update on the first call
+            .distance = GOVERNOR_NO_LIMIT,
+            .ttc      = GOVERNOR_NO_LIMIT,
+            .limit    = GOVERNOR_NO_LIMIT,
+            .obstacle = FALSE
+    };
+    return g;
+}
+
+/**
+  * @brief   给定距离下允许的最大速度 | Largest speed that can still stop within a distance
+  * @note    解 v·t + v²/(2a) = d：v = a·(√(t² + 2d/a) − t) | Solves v·t + v²/(2a) = d
+  */
+fp32 Governor_SpeedFor(const Governor *self, fp32 distance, fp32 pitch) {
+    if (distance <= 0.0f) return 0.0f;
+    fp32 t = self->latency + fmaxf(pitch, 0.0f) / GOVERNOR_TILT_RATE;
+    fp32 a = self->decel;
+    return a * (sqrtf(t * t + 2.0f * distance / a) - t);
+}
+
+/**
+  * @brief   推进时间并按外环周期更新限速 | Advance time and update the cap on the outer period
+  */
+bool_t Governor_Update(Governor *self, fp32 range, bool_t valid, fp32 age, fp32 speed, fp32 pitch, fp32 dt) {
+    self->elapsed += dt;
+    if (self->elapsed < GOVERNOR_PERIOD * 0.999f) {
+        return FALSE;
+    }
+    self->elapsed = 0.0f;
+
+    if (!valid || age > GOVERNOR_MAX_AGE) {
+        self->distance = self->ttc = self->limit = GOVERNOR_NO_LIMIT;
+        self->obstacle = FALSE;
+        return TRUE;
+    }
+
+    // 读数之后走过的距离 | Distance covered since the reading
+    self->distance = range - speed * age;
+    self->ttc = (speed > 0.0f) ? fmaxf(self->distance, 0.0f) / speed : GOVERNOR_NO_LIMIT;
+    self->limit = Governor_SpeedFor(self, self->distance - self->standoff, pitch);
+    self->obstacle = (self->ttc < GOVERNOR_TTC_WARN || self->distance <= self->standoff) ? TRUE : FALSE;
+    return TRUE;
+}
@@ -0,0 +1,221 @@
+#include "motion.h"
+#include "command.h"
+#include <math.h>
+#include <string.h>
+
+/**
+  * @brief   按当前方向和巡航速度更新线速度目标 | Update the linear target from direction and cruise speed
+  */
+static void applyCruise(Motion *self) {
+    SCurve_SetTarget(&self->linear, (fp32)(self->direction * self->cruiseSpeed));
+}
+
+static void onForward(Motion *self) {
+    if (self->direction <= 0) {
+        self->cruiseSpeed = self->startSpeed;  // 换向时从起步速度开始 | Restart from the start speed on reversal
+    }
+    self->direction = 1;
+    self->state = CAR_MOTION_FOWARD;
+    SCurve_SetLimits(&self->linear, MOTION_LINEAR_ACC, MOTION_LINEAR_JERK);
+    applyCruise(self);
+}
+
+static void onBackward(Motion *self) {
+    if (self->direction >= 0) {
+        self->cruiseSpeed = self->startSpeed;
+    }
+    self->direction = -1;
+    self->state = CAR_MOTION_BACKWARD;
+    SCurve_SetLimits(&self->linear, MOTION_LINEAR_ACC, MOTION_LINEAR_JERK);
+    applyCruise(self);
+}
+
+static void onLeft(Motion *self) {
+    self->turnRemaining = 0.0f;
+    self->state = CAR_MOTION_LEFT;
+    SCurve_SetTarget(&self->angular, MOTION_TURN_RATE);
+}
+
+static void onRight(Motion *self) {
+    self->turnRemaining = 0.0f;
+    self->state = CAR_MOTION_RIGHT;
+    SCurve_SetTarget(&self->angular, -MOTION_TURN_RATE);
+}
+
+/**
+  * @brief   停止转向，恢复直行状态 | Stop turning and fall back to the straight-line state
+  */
+static void onTurnClear(Motion *self) {
+    self->turnRemaining = 0.0f;
+    SCurve_SetTarget(&self->angular, 0.0f);
+    self->state = (self->direction > 0) ? CAR_MOTION_FOWARD :
+                  (self->direction < 0) ? CAR_MOTION_BACKWARD : CAR_MOTION_STOP;
+}
+
+/**
+  * @brief   以给定限值减速到零 | Decelerate to zero with the given limits
+  */
+static void stopWith(Motion *self, fp32 acc, fp32 jerk) {
+    self->roadPlanning = FALSE;     // 停止命令同时退出路径跟踪 | A stop also leaves path following
+    self->direction = 0;
+    self->turnRemaining = 0.0f;
+    self->state = CAR_MOTION_STOP;
+    SCurve_SetLimits(&self->linear, acc, jerk);
+    SCurve_SetTarget(&self->linear, 0.0f);
+    SCurve_SetTarget(&self->angular, 0.0f);
+}
+
+static void onStop(Motion *self) {
+    stopWith(self, MOTION_STOP_ACC, MOTION_STOP_JERK);
+}
+
+static void onStopSlowly(Motion *self) {
+    stopWith(self, MOTION_SLOW_ACC, MOTION_SLOW_JERK);
+}
+
+static void onSpeedUp(Motion *self) {
+    if (self->constantSpeed) return;
+    self->cruiseSpeed = (int8_t)LIMIT(self->cruiseSpeed + MOTION_SPEED_STEP, 0, (int)MOTION_MAX_LINEAR);
+    applyCruise(self);
+}
+
+static void onSpeedDown(Motion *self) {
+    if (self->constantSpeed) return;
+    self->cruiseSpeed = (int8_t)LIMIT(self->cruiseSpeed - MOTION_SPEED_STEP, 0, (int)MOTION_MAX_LINEAR);
+    applyCruise(self);
+}
+
+/**
+  * @brief   原地掉头：按设定值积分计角，剩余角度不足停止距离时开始减速
+  *          Turn around in place: the angle is integrated from the setpoint and the ramp-down
+  *          starts once the remaining angle reaches the stopping distance
+  */
+static void onTurnAround(Motion *self) {
+    stopWith(self, MOTION_LINEAR_ACC, MOTION_LINEAR_JERK);
+    self->state = CAR_MOTION_LEFT;
+    self->turnRemaining = 180.0f;
+    self->angular.pos = 0.0f;
+    SCurve_SetTarget(&self->angular, MOTION_TURN_RATE);
+}
+
+/**
+  * @brief   路径跟踪开关：开启后由路径跟踪器改写线速度/角速度目标 | Path following toggle: when on, the follower rewrites the targets
+  */
+static void onRoadPlanning(Motion *self) {
+    if (self->roadPlanning) {
+        onStopSlowly(self);         // 同时清除 roadPlanning | Also clears roadPlanning
+    } else {
+        self->roadPlanning = TRUE;
+        self->turnRemaining = 0.0f;
+        self->state = CAR_MOTION_FOWARD;
+        SCurve_SetLimits(&self->linear, MOTION_LINEAR_ACC, MOTION_LINEAR_JERK);
+    }
+}
+
+static void onPowerSwitch(Motion *self) {
+    self->enabled = BOOL_TOGGLE(self->enabled);
+    onStop(self);
+    SCurve_Reset(&self->linear, 0.0f);   // 重新上电时从静止开始 | Start from rest when powered back on
+    SCurve_Reset(&self->angular, 0.0f);
+}
+
+static void onSpeedConstant(Motion *self) {
+    self->constantSpeed = BOOL_TOGGLE(self->constantSpeed);
+}
+
+/**
+  * @struct  MotionCommand
+  * @brief   命令表项 | Command table entry
+  */
+typedef struct {
+    uint8_t cmd;                        /**< 命令值 | Command value */
+    const char *name;                   /**< 名称 | Name */
+    void (*Handler)(Motion *self);      /**< 处理函数 | Handler */
+} MotionCommand;
+
+/* 命令表 | Command table */
+static const MotionCommand commandTable[] = {
+        {CMD_LEFT,           "LEFT",           onLeft},
+        {CMD_RIGHT,          "RIGHT",          onRight},
+        {CMD_FORWARD,        "FORWARD",        onForward},
+        {CMD_BACKWARD,       "BACKWARD",       onBackward},
+        {CMD_STOP,           "STOP",           onStop},
+        {CMD_STOP_SLOWLY,    "STOP_SLOWLY",    onStopSlowly},
+        {CMD_SPEED_UP,       "SPEED_UP",       onSpeedUp},
+        {CMD_SPEED_DOWN,     "SPEED_DOWN",     onSpeedDown},
+        {CMD_ROAD_PLANNING,  "ROAD_PLANNING",  onRoadPlanning},
+        {CMD_TURN_AROUND,    "TURN_AROUND",    onTurnAround},
+        {CMD_TURN_CLEAR,     "TURN_CLEAR",     onTurnClear},
+        {CMD_POWER_SWITCH,   "POWER_SWITCH",   onPowerSwitch},
+        {CMD_SPEED_CONSTANT, "SPEED_CONSTANT", onSpeedConstant},
+};
+
+#define COMMAND_COUNT (sizeof(commandTable) / sizeof(commandTable[0]))
+
+/**
+  * @brief   创建运动状态机 | Create a motion state machine
+  */
+Motion newMotion(int8_t startSpeed) {
+    Motion m = {
+            .enabled       = TRUE,
+            .constantSpeed = FALSE,
+            .roadPlanning  = FALSE,
+            .state         = CAR_MOTION_STOP,
+            .startSpeed    = startSpeed,
+            .cruiseSpeed   = startSpeed,
+            .direction     = 0,
+            .turnRemaining = 0.0f,
+            .speedLimit    = MOTION_MAX_LINEAR
+    };
+    SCurve_Init(&m.linear, MOTION_MAX_LINEAR, MOTION_LINEAR_ACC, MOTION_LINEAR_JERK);
+    SCurve_Init(&m.angular, MOTION_MAX_ANGULAR, MOTION_ANGULAR_ACC, MOTION_ANGULAR_JERK);
+    return m;
+}
+
+/**
+  * @brief   分发一条运动命令 | Dispatch one motion command
+  */
+bool_t Motion_Dispatch(Motion *self, uint8_t cmd) {
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+        if (commandTable[i].cmd == cmd) {
+            // 断电状态下只响应电源开关 | Only the power switch is honoured while off
+            if (self->enabled || cmd == CMD_POWER_SWITCH) {
+                commandTable[i].Handler(self);
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+  * @brief   推进设定值一个周期 | Advance the setpoints by one period
+  */
+void Motion_Update(Motion *self, fp32 dt) {
+    if (self->turnRemaining > 0.0f &&
+        self->angular.pos + SCurve_StopDistance(&self->angular) >= self->turnRemaining) {
+        self->turnRemaining = 0.0f;         // 开始减速，恰好转过 180° | Start ramping down to land on 180°
+        self->state = CAR_MOTION_STOP;
+        SCurve_SetTarget(&self->angular, 0.0f);
+    }
+
+    fp32 commanded = self->linear.target;
+    if (commanded > self->speedLimit) {
+        self->linear.target = fmaxf(self->speedLimit, 0.0f);
+    }
+    SCurve_Update(&self->linear, dt);
+    self->linear.target = commanded;
+    SCurve_Update(&self->angular, dt);
+}
+
+/**
+  * @brief   按名称查找命令 | Look up a command by name
+  */
+int Motion_CommandByName(const char *name) {
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+        if (strcmp(commandTable[i].name, name) == 0) {
+            return commandTable[i].cmd;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,76 @@
+#include "odometry.h"
+#include "seqlock.h"
+#include <math.h>
+
+#define PI_F        3.14159265f
+#define RAD_TO_DEG  57.29578f
+#define DEG_TO_RAD  0.01745329f
+
+/**
+  * @brief   创建里程计 | Create odometry
+  */
+Odometry newOdometry(fp32 track, fp32 tau) {
+    Odometry o = {.track = track, .tau = tau};
+    Odometry_Reset(&o);
+    return o;
+}
+
+/**
+  * @brief   发布快照（序号锁） | Publish the snapshot (sequence lock)
+  */
+static void publish(Odometry *self) {
+    fp32 h = remainderf(self->heading, 2.0f * PI_F);    // 回绕到 ±π | Wrap to ±π
+
+    SeqLock_WriteBegin(&self->seq);
+    self->snapshot.x = self->x;
+    self->snapshot.y = self->y;
+    self->snapshot.heading = h * RAD_TO_DEG;
+    self->snapshot.v = self->v;
+    self->snapshot.omega = self->omega * RAD_TO_DEG;
+    self->snapshot.tick = self->tick;
+    SeqLock_WriteEnd(&self->seq);
+}
+
+/**
+  * @brief   位姿清零 | Reset the pose to the origin
+  */
+void Odometry_Reset(Odometry *self) {
+    self->x = self->y = 0.0f;
+    self->heading = self->encHeading = 0.0f;
+    self->v = self->omega = 0.0f;
+    self->tick = 0;
+    publish(self);
+}
+
+/**
+  * @brief   积分一个周期 | Integrate one period
+  * @note    位置按中点航向积分，转弯时没有一阶误差 | Position uses the mid-point heading, so turns carry no first-order error
+  */
+void Odometry_Update(Odometry *self, fp32 dLeft, fp32 dRight, fp32 dYawImu, fp32 dt) {
+    fp32 ds = 0.5f * (dLeft + dRight);
+    fp32 dEnc = (dRight - dLeft) / self->track;
+    fp32 last = self->heading;
+
+    self->encHeading += dEnc;
+    if (self->tau > 0.0f) {
+        fp32 alpha = self->tau / (self->tau + dt);
+        self->heading = alpha * (self->heading + dYawImu * DEG_TO_RAD) + (1.0f - alpha) * self->encHeading;
+    } else {
+        self->heading = self->encHeading;
+    }
+
+    fp32 mid = 0.5f * (last + self->heading);
+    self->x += ds * cosf(mid);
+    self->y += ds * sinf(mid);
+    self->v = ds / dt;
+    self->omega = (self->heading - last) / dt;
+    self->tick++;
+    publish(self);
+}
+
+/**
+  * @brief   读取一致的位姿快照 | Read a consistent pose snapshot
+  */
+void Odometry_GetPose(const Odometry *self, Pose *pose) {
+    SeqLock_Read(&self->seq, pose, &self->snapshot, sizeof(*pose));
+}
@@ -0,0 +1,217 @@
+#include "path.h"
+#include <math.h>
+#include <string.h>
+
+#define RAD_TO_DEG  57.29578f
+#define DEG_TO_RAD  0.01745329f
+
+/**
+  * @brief   创建跟踪器 | Create a follower
+  */
+PathFollower newPathFollower(void) {
+    PathFollower p;
+    memset(&p, 0, sizeof(p));
+    return p;
+}
+
+/**
+  * @brief   清空路径 | Clear the path
+  */
+int Path_Clear(PathFollower *self) {
+    if (self->active) return PATH_ERR_BUSY;
+    __atomic_store_n(&self->count, 0, __ATOMIC_RELEASE);
+    self->finished = FALSE;
+    return PATH_OK;
+}
+
+/**
+  * @brief   写入航点 | Write waypoints
+  * @note    先写数据再发布 count，控制循环不会看到写了一半的航点；弧长从 index 起重算
+  *          Data is written before count is published, so the control loop never sees a
+  *          half-written waypoint; arc lengths are recomputed from index onwards
+  */
+int Path_Write(PathFollower *self, uint8_t index, const fp32 *xy, uint8_t n) {
+    if (self->active) return PATH_ERR_BUSY;
+    if (index > self->count || index + n > PATH_MAX_WAYPOINTS) return PATH_ERR_RANGE;
+
+    for (uint8_t i = 0; i < n; i++) {
+        self->points[index + i].x = xy[2 * i];
+        self->points[index + i].y = xy[2 * i + 1];
+    }
+    uint8_t count = (index + n > self->count) ? (uint8_t)(index + n) : self->count;
+    for (uint8_t i = index; i < count; i++) {
+        Waypoint *w = &self->points[i];
+        w->s = (i == 0) ? 0.0f : self->points[i - 1].s + hypotf(w->x - w[-1].x, w->y - w[-1].y);
+    }
+    __atomic_store_n(&self->count, count, __ATOMIC_RELEASE);
+    return PATH_OK;
+}
+
+/**
+  * @brief   开始跟踪 | Start following
+  */
+void Path_Start(PathFollower *self) {
+    self->segment = 0;
+    self->elapsed = PATH_PERIOD;    // 第一次调用立即更新 | Update on the first call
+    self->finished = FALSE;
+    self->linear = self->angular = 0.0f;
+    self->active = TRUE;
+}
+
+/**
+  * @brief   停止跟踪 | Stop following
+  */
+void Path_Stop(PathFollower *self) {
+    self->active = FALSE;
+    self->linear = self->angular = 0.0f;
+}
+
+/**
+  * @brief   点到线段的投影 | Project a point onto a segment
+  * @return  距离平方 | Squared distance
+  */
+static fp32 project(const Waypoint *a, const Waypoint *b, fp32 px, fp32 py, fp32 *t) {
+    fp32 dx = b->x - a->x, dy = b->y - a->y;
+    fp32 len2 = dx * dx + dy * dy;
+    fp32 u = (len2 > 0.0f) ? ((px - a->x) * dx + (py - a->y) * dy) / len2 : 0.0f;
+    u = LIMIT(u, 0.0f, 1.0f);
+    fp32 ex = a->x + u * dx - px, ey = a->y + u * dy - py;
+    *t = u;
+    return ex * ex + ey * ey;
+}
+
+/**
+  * @brief   推进时间并按外环周期更新输出 | Advance time and update the outputs on the outer period
+  * @note    纯追踪：前视点在车体坐标系中为 (lx, ly)，曲率 κ = 2·ly / (lx² + ly²)，ω = v·κ。
+  *          曲率过大时降低线速度而不是截断角速度，车仍沿同一圆弧行驶。
+  *          Pure pursuit: with the look-ahead point at (lx, ly) in the body frame the curvature is
+  *          κ = 2·ly / (lx² + ly²) and ω = v·κ. When the curvature is too tight the linear speed is
+  *          reduced instead of clipping ω, so the car stays on the same arc.
+  */
+bool_t Path_Update(PathFollower *self, const Pose *pose, fp32 dt) {
+    self->elapsed += dt;
+    if (!self->active || self->elapsed < PATH_PERIOD * 0.999f) {
+        return FALSE;
+    }
+    self->elapsed = 0.0f;
+
+    uint8_t count = __atomic_load_n(&self->count, __ATOMIC_ACQUIRE);
+    if (count < 2) {
+        Path_Stop(self);
+        self->finished = TRUE;
+        return TRUE;
+    }
+    const Waypoint *p = self->points;
+    uint8_t last = (uint8_t)(count - 2);      // 最后一段 | Last segment
+    uint8_t end = (self->segment + PATH_SEARCH_WINDOW < last) ? (uint8_t)(self->segment + PATH_SEARCH_WINDOW) : last;
+
+    // 最近点：只向前搜索有限段 | Closest point: bounded forward search
+    uint8_t best = self->segment;
+    fp32 bestT = 0.0f, bestD = INFINITY;
+    for (uint8_t i = self->segment; i <= end; i++) {
+        fp32 t;
+        fp32 d = project(&p[i], &p[i + 1], pose->x, pose->y, &t);
+        if (d < bestD) {
+            bestD = d;
+            best = i;
+            bestT = t;
+        }
+    }
+    self->segment = best;
+
+    const Waypoint *a = &p[best], *b = &p[best + 1];
+    fp32 segLen = b->s - a->s;
+    fp32 sProj = a->s + bestT * segLen;
+    self->remaining = p[count - 1].s - sProj;
+    fp32 cross = (b->x - a->x) * (pose->y - a->y) - (b->y - a->y) * (pose->x - a->x);
+    self->crossTrack = copysignf(sqrtf(bestD), cross);
+
+    // 到达终点 | Goal reached
+    const Waypoint *goal = &p[count - 1];
+    fp32 goalDist = hypotf(goal->x - pose->x, goal->y - pose->y);
+    if (best == last && (self->remaining < PATH_GOAL_TOLERANCE || goalDist < PATH_GOAL_TOLERANCE)) {
+        Path_Stop(self);
+        self->finished = TRUE;
+        return TRUE;
+    }
+
+    // 前视点：同样只看有限段 | Look-ahead point: also a bounded walk
+    fp32 sTarget = sProj + PATH_LOOKAHEAD + PATH_LOOKAHEAD_TIME * fabsf(pose->v);
+    end = (best + PATH_SEARCH_WINDOW < last) ? (uint8_t)(best + PATH_SEARCH_WINDOW) : last;
+    fp32 tx = p[end + 1].x, ty = p[end + 1].y;
+    for (uint8_t i = best; i <= end; i++) {
+        if (p[i + 1].s >= sTarget) {
+            fp32 len = p[i + 1].s - p[i].s;
+            fp32 u = (len > 0.0f) ? (sTarget - p[i].s) / len : 1.0f;
+            tx = p[i].x + u * (p[i + 1].x - p[i].x);
+            ty = p[i].y + u * (p[i + 1].y - p[i].y);
+            break;
+        }
+    }
+
+    // 转到车体坐标系 | Into the body frame
+    fp32 h = pose->heading * DEG_TO_RAD;
+    fp32 dx = tx - pose->x, dy = ty - pose->y;
+    fp32 lx = cosf(h) * dx + sinf(h) * dy;
+    fp32 ly = -sinf(h) * dx + cosf(h) * dy;
+    fp32 d2 = lx * lx + ly * ly;
+
+    // 终点前按 v = sqrt(2·a·s) 减速 | Slow down as v = sqrt(2·a·s) before the goal
+    fp32 v = fminf(PATH_SPEED, sqrtf(2.0f * PATH_DECEL * self->remaining));
+    fp32 kappa = (d2 > 1e-3f) ? 2.0f * ly / d2 : 0.0f;
+    fp32 maxTurn = PATH_MAX_TURN * DEG_TO_RAD;
+
+    if (lx <= 0.0f) {
+        // 前视点在身后：原地转向 | Look-ahead point behind: turn in place
+        v = 0.0f;
+        self->angular = copysignf(PATH_MAX_TURN, ly);
+    } else {
+        if (fabsf(v * kappa) > maxTurn) {
+            v = maxTurn / fabsf(kappa);
+        }
+        self->angular = v * kappa * RAD_TO_DEG;
+    }
+    self->linear = v;
+    return TRUE;
+}
+
+/**
+  * @brief   处理路径协议帧 | Handle a path protocol frame
+  */
+uint8_t Path_HandleFrame(PathFollower *self, const Frame *req, uint8_t *reply, uint8_t *len) {
+    const uint8_t *p = req->payload;
+
+    switch (req->type) {
+        case MSG_PATH_CLEAR:
+            reply[0] = (uint8_t)(int8_t)Path_Clear(self);
+            *len = 1;
+            return MSG_PATH_CLEAR;
+
+        case MSG_PATH_APPEND: {
+            int ret = PATH_ERR_FORMAT;
+            if (req->len >= 1 && (req->len - 1) % 8 == 0) {
+                fp32 xy[2 * ((PROTOCOL_MAX_PAYLOAD - 1) / 8)];
+                uint8_t n = (uint8_t)((req->len - 1) / 8);
+                memcpy(xy, &p[1], (size_t)n * 8);
+                ret = Path_Write(self, p[0], xy, n);
+            }
+            reply[0] = (uint8_t)(int8_t)ret;
+            reply[1] = self->count;
+            *len = 2;
+            return MSG_PATH_APPEND;
+        }
+
+        case MSG_PATH_INFO:
+            reply[0] = self->count;
+            reply[1] = self->active;
+            reply[2] = self->finished;
+            reply[3] = self->segment;
+            memcpy(&reply[4], &self->crossTrack, 4);
+            memcpy(&reply[8], &self->remaining, 4);
+            *len = 12;
+            return MSG_PATH_INFO;
+
+        default:
+            return 0;
+    }
+}
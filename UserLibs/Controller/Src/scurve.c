@@ -0,0 +1,89 @@
+#include "scurve.h"
+#include <math.h>
+
+/**
+  * @brief   初始化发生器 | Init generator
+  */
+void SCurve_Init(SCurve *self, fp32 maxVel, fp32 maxAcc, fp32 maxJerk) {
+    self->maxVel = maxVel;
+    self->maxAcc = maxAcc;
+    self->maxJerk = maxJerk;
+    self->target = 0.0f;
+    self->vel = 0.0f;
+    self->acc = 0.0f;
+    self->pos = 0.0f;
+}
+
+/**
+  * @brief   修改加速度和加加速度上限 | Change acceleration/jerk limits
+  */
+void SCurve_SetLimits(SCurve *self, fp32 maxAcc, fp32 maxJerk) {
+    self->maxAcc = maxAcc;
+    self->maxJerk = maxJerk;
+}
+
+/**
+  * @brief   设置目标速度 | Set target velocity
+  */
+void SCurve_SetTarget(SCurve *self, fp32 target) {
+    self->target = LIMIT(target, -self->maxVel, self->maxVel);
+}
+
+/**
+  * @brief   立即跳到给定速度 | Jump to a velocity immediately
+  */
+void SCurve_Reset(SCurve *self, fp32 vel) {
+    self->vel = vel;
+    self->target = vel;
+    self->acc = 0.0f;
+}
+
+/**
+  * @brief   前进一个周期 | Advance one period
+  * @note    期望加速度取 sign(e)·sqrt(2·J·|e|)，即以最大加加速度减到零时恰好到达目标的加速度；
+  *          实际加速度以 J·dt 的步长逼近它，因此过渡呈 S 形且不会在切换点抖动
+  *          The desired acceleration is sign(e)·sqrt(2·J·|e|), the acceleration that lands exactly on
+  *          the target when ramped to zero at full jerk; the actual acceleration approaches it in
+  *          steps of J·dt, giving an S-shaped transition without chatter at the switch point
+  */
+fp32 SCurve_Update(SCurve *self, fp32 dt) {
+    fp32 err = self->target - self->vel;
+    fp32 jerkStep = self->maxJerk * dt;
+
+    fp32 accDes = sqrtf(2.0f * self->maxJerk * fabsf(err));
+    if (accDes * dt > fabsf(err)) {
+        accDes = fabsf(err) / dt;   // 最后一步不越过目标 | Do not step past the target
+    }
+    accDes = copysignf(fminf(accDes, self->maxAcc), err);
+
+    self->acc += LIMIT(accDes - self->acc, -jerkStep, jerkStep);
+
+    fp32 prev = self->vel;
+    self->vel += self->acc * dt;
+    if ((self->target - self->vel) * err < 0.0f) {
+        self->vel = self->target;   // 越过目标时停在目标上 | Snap to the target if it was crossed
+        self->acc = 0.0f;
+    }
+    self->pos += 0.5f * (prev + self->vel) * dt;
+    return self->vel;
+}
+
+/**
+  * @brief   停止距离 | Stopping distance
+  * @note    从零加速度开始按梯形/三角形加速度曲线减速，平均速度为 v/2
+  *          Decelerating from zero acceleration along a trapezoidal/triangular acceleration profile,
+  *          the average velocity is v/2
+  */
+fp32 SCurve_StopDistance(const SCurve *self) {
+    fp32 v = fabsf(self->vel);
+    fp32 a = self->maxAcc;
+    fp32 j = self->maxJerk;
+    fp32 t;
+
+    if (v >= a * a / j) {
+        t = v / a + a / j;          // 加速度达到上限 | Acceleration saturates
+    } else {
+        t = 2.0f * sqrtf(v / j);    // 三角形加速度曲线 | Triangular acceleration profile
+    }
+    return copysignf(0.5f * v * t, self->vel);
+}
@@ -5,9 +5,11 @@
 #include "motor.h"
 #include "encoder.h"
 #include "imu.h"
-#include "oled.h"
+#include "OLED.h"
 #include "pid.h"
+#include "control.h"
 #include "filter.h"
+#include "ultrasonic.h"
 #include "struct_typedef.h"
 
 /* 硬件配置宏定义 | Hardware configuration macros */
@@ -33,20 +35,27 @@
 // 右编码器定时器 | Right encoder timer
 #define ENCODER_R_TIM htim3
 
+// 控制周期定时器（1 MHz 计数） | Control period timer (1 MHz count)
+#define CONTROL_TIM htim9
+
+// 车轮与编码器 | Wheel and encoder
+#define WHEEL_RADIUS_CM     3.25f   /**< 轮半径 (cm) | Wheel radius */
+#define ENCODER_CPR         1560.0f /**< 轮子每转编码器计数 | Encoder counts per wheel revolution */
+#define WHEEL_L_SIGN        1       /**< 左轮前进对应的电机方向 | Motor direction for left wheel forward */
+#define WHEEL_R_SIGN        (-1)    /**< 右轮前进对应的电机方向（镜像安装） | Motor direction for right wheel forward (mirrored mount) */
+
+// 姿态轴映射：IMU 安装方向决定哪个轴是俯仰 | Attitude axis mapping: the IMU mounting decides which axis is pitch
+#define BALANCE_ANGLE(imu)  ((imu).roll)    /**< 前倾为正 | Forward positive */
+#define BALANCE_RATE(imu)   ((imu).gyrox)
+#define YAW_RATE(imu)       ((imu).gyroz)   /**< 左转为正 | Left positive */
+#define YAW_ANGLE(imu)      ((imu).yaw)     /**< DMP 航向，逆时针为正 | DMP heading, counter-clockwise positive */
+
+// 里程计航向来源：1 = DMP yaw 增量，0 = gyroz 积分 | Odometry heading source: 1 = DMP yaw increment, 0 = integrated gyroz
+#define ODOMETRY_USE_DMP_YAW 1
+
 // 机械平衡偏置值（单位：度） | Mechanical balance bias (degrees)
 #define MECHANICAL_BALANCE_BIAS (-1.4f)
 
-/**
-  * @brief   小车运动状态枚举 | Car motion state enumeration
-  */
-typedef enum {
-    CAR_MOTION_STOP = 0,     /**< 停止 | Stop */
-    CAR_MOTION_FOWARD,       /**< 前进 | Forward */
-    CAR_MOTION_BACKWARD,     /**< 后退 | Backward */
-    CAR_MOTION_LEFT,         /**< 左转 | Left turn */
-    CAR_MOTION_RIGHT         /**< 右转 | Right turn */
-} MotionState;
-
 typedef struct Car Car;
 
 /**
@@ -59,6 +68,7 @@ typedef struct Car Car;
 struct Car {
     /* 状态标志 | Status flags */
     bool_t isBrake;                 /**< 刹车标志 | Brake flag */
+    bool_t isObstacleDetected;      /**< 前方有障碍（限速器给出） | Obstacle ahead (from the governor) */
 
     /* 运动参数 | Motion parameters */
     uint8_t motionState;            /**< 当前运动状态 | Current motion state */
@@ -66,9 +76,11 @@ struct Car {
     int16_t targetAngularSpeed;     /**< 目标角速度 (°/s) | Target angular speed */
     int8_t targetStartLinearSpeed;  /**< 起始线速度 (cm/s) | Initial start speed */
 
-    fp32 balanceBias;               /**< 平衡偏置 (°) | Balance bias */
     uint8_t cmd;                    /**< 当前命令 | Current command */
 
+    /* 控制器 | Controllers */
+    Control control;                /**< 控制栈（含平衡偏置） | Control stack (holds the balance bias) */
+
     /* 设备实例 | Device instances */
     Motor   motor_l;                /**< 左电机实例 | Left motor instance */
     Motor   motor_r;                /**< 右电机实例 | Right motor instance */
@@ -76,6 +88,10 @@ struct Car {
     Encoder encoder_r;              /**< 右编码器实例 | Right encoder instance */
     Imu     imu;                    /**< IMU 传感器实例 | IMU sensor instance */
 
+    /* 本周期的输入，供传感器日志记录 | This period's inputs, for the sensor log */
+    uint32_t tickMs;                /**< CarMove 开始时的 HAL 节拍 | HAL tick when CarMove started */
+    UltrasonicReading range;        /**< 超声波读数 | Ultrasonic reading */
+
     /* 方法指针 | Method pointer */
     void (*CarMove)(Car *self, int8_t setSpeed);
     /**< 小车移动函数指针 | Pointer to car movement function */
@@ -91,7 +107,9 @@ Car newCar(void);
   * @brief   小车移动控制函数 | Car movement control function
   * @param   self      指向 Car 实例的指针 | Pointer to Car instance
   * @param   setSpeed  未使用参数，可保留 | Unused parameter (can be retained)
-  * @note    调用 PID、判断刹车并设置电机输出 | Run PID, check brake, set motor outputs
+  * @note    每个控制周期调用一次：推进运动设定值、运行平衡环、判断刹车并设置电机输出
+  *          Call once per control period: advance the motion setpoints, run the balance loop,
+  *          check the brake and set motor outputs
   */
 void CarMove(Car *self, int8_t setSpeed);
 
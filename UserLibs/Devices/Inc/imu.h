@@ -3,12 +3,16 @@
 
 #include "main.h"
 #include "MPU6500.h"
+#include "struct_typedef.h"
 
 /**
   * @file    imu.h
   * @brief   IMU（惯性测量单元）接口定义 | IMU (Inertial Measurement Unit) interface definitions
   */
 
+#define IMU_RETRY_FIRST_TICKS   10      /**< 初始化失败后首次重试前等待的控制周期（100 ms） | Control ticks before the first retry after a failed init (100 ms) */
+#define IMU_RETRY_MAX_TICKS     200     /**< 重试间隔逐次加倍的上限（2 s） | Cap of the doubling retry interval (2 s) */
+
 /**
   * @struct  Imu
   * @brief   IMU 数据结构 | IMU data structure
@@ -18,7 +22,13 @@
 typedef struct Imu Imu;
 
 typedef struct Imu {
-    uint8_t init_result;  /**< 初始化状态（0 成功） | Initialization status (0 = success) */
+    uint8_t init_result;  /**< 初始化状态（0 成功，MPU6500_INIT_BUSY 进行中） | Initialization status (0 = success, MPU6500_INIT_BUSY = in progress) */
+    bool_t ready;         /**< 已读到第一帧数据 | First sample has been read */
+    uint16_t init_retries;  /**< 初始化失败后的重试次数 | Init retries after failures */
+    uint16_t retry_wait;    /**< 距下次重试的控制周期 | Control ticks until the next retry */
+    uint16_t retry_backoff; /**< 下一次失败后的等待周期 | Wait after the next failure */
+    int32_t gyroBias[3];    /**< 陀螺仪零偏，q16 °/s，初始化完成时载入 DMP | Gyro bias, q16 dps, loaded into the DMP once the init completes */
+    int32_t accelBias[3];   /**< 加速度计零偏，q16 g | Accel bias, q16 g */
     float pitch;          /**< 俯仰角 | Pitch angle */
     float roll;           /**< 横滚角 | Roll angle */
     float yaw;            /**< 偏航角 | Yaw angle */
@@ -42,16 +52,32 @@ typedef struct Imu {
 Imu newImu(void);
 
 /**
-  * @brief   启用 IMU 并初始化底层 MPU6500 | Enable IMU and initialize underlying MPU6500
+  * @brief   启用 IMU，开始分步初始化 MPU6500 | Enable IMU and start the staged MPU6500 init
   * @param   self  指向 Imu 实例的指针 | Pointer to Imu instance
-  * @return  返回初始化结果（0 = 成功） | Returns init status (0 = success)
+  * @return  MPU6500_INIT_BUSY，后续步骤由 Get_Data 推进 | MPU6500_INIT_BUSY; Get_Data runs the remaining stages
+  * @note    初始化在控制周期中逐步完成，其余模块不必等待；ready 置位前数据无效
+  *          The init completes step by step in the control tick so nothing else waits for it;
+  *          data is not valid until ready is set
   */
 int Enable(Imu *self);
 
 /**
   * @brief   从 MPU6500 获取姿态和传感器数据 | Get attitude and sensor data from MPU6500
   * @param   self  指向 Imu 实例的指针 | Pointer to Imu instance
+  * @note    初始化未完成时只执行下一步初始化；失败后等待 retry_wait 个周期再从头重试，
+  *          间隔从 IMU_RETRY_FIRST_TICKS 起逐次加倍，至多 IMU_RETRY_MAX_TICKS
+  *          While the init is unfinished only its next stage runs; after a failure it restarts
+  *          from the beginning once retry_wait ticks have passed, the interval doubling from
+  *          IMU_RETRY_FIRST_TICKS up to IMU_RETRY_MAX_TICKS
   */
 void Get_Data(Imu *self);
 
+/**
+  * @brief   把 gyroBias/accelBias 写入 DMP | Write gyroBias/accelBias into the DMP
+  * @param   self  指向 Imu 实例的指针 | Pointer to Imu instance
+  * @return  0 成功；初始化未完成时不写，返回 1，完成时自动载入 | 0 on success; 1 while the init is unfinished, which loads them itself when it completes
+  * @note    与 Get_Data 在同一上下文调用（共用 I2C） | Call from the same context as Get_Data (they share the I2C bus)
+  */
+int Imu_ApplyBias(Imu *self);
+
 #endif /* IMU_H_ */
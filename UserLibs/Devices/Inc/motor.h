@@ -9,6 +9,12 @@
 #include "math.h"
 #include "struct_typedef.h"
 
+/* 速度内环默认增益（计数/周期 → PWM 比较值），可被已保存的参数覆盖
+ * Default speed loop gains (counts/period → PWM compare), overridden by stored parameters */
+#define MOTOR_PID_KP    800.0f
+#define MOTOR_PID_KI    20.0f
+#define MOTOR_PID_KD    0.0f
+
 /**
   * @struct  Motor_InitTypeDef
   * @brief   电机初始化配置结构体 | Motor initialization config struct
@@ -41,6 +47,7 @@ typedef struct Motor {
     uint8_t direction;           /**< 当前方向 (BRAKE/ FORWARD/ BACKWARD/ FREE)
                                        Current direction (BRAKE/FORWARD/BACKWARD/FREE) */
     fp32 setRPM;                /**< 当前目标转速 | Current target RPM */
+    int16_t fdbRPM;             /**< 转速反馈（编码器计数/周期），调用 Move 前更新 | Speed feedback (encoder counts/period), updated before Move */
 
     void (*Move)(struct Motor *self, uint8_t isBrake, fp32 setRPM);
     /**< 移动函数 | Move function */
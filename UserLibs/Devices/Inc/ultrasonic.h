@@ -0,0 +1,124 @@
+#ifndef ULTRASONIC_H_
+#define ULTRASONIC_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    ultrasonic.h
+  * @brief   超声波测距状态机与滤波 | Ultrasonic ranging state machine and filtering
+  *
+  * @note    只处理时间戳，不接触硬件：触发、回波边沿和超时都由定时器中断喂入，任何调用都立即返回。
+  *          时间为 16 位、1 µs 的定时器计数，差值按无符号回绕计算（回绕周期 65.5 ms 大于超时）。
+  *          与硬件无关，主机端测试使用同一份代码。
+  *          Works on timestamps only and never touches hardware: trigger, echo edges and timeout
+  *          are fed from timer interrupts and every call returns immediately. Times are 16-bit,
+  *          1 µs timer counts; differences use unsigned wrap-around (the 65.5 ms wrap is longer
+  *          than the timeout). Hardware-independent, so the host test runs the same code.
+  */
+
+#define ULTRASONIC_MEDIAN_N     5       /**< 中值滤波窗口 | Median filter window */
+#define ULTRASONIC_PERIOD_MS    60      /**< 最小测量周期，避免上次余波 | Minimum cycle, lets the last echo die out */
+#define ULTRASONIC_TIMEOUT_US   30000   /**< 触发后等待回波结束的上限 | Max wait from trigger to echo end */
+#define ULTRASONIC_MIN_ECHO_US  116     /**< 2 cm，更短视为干扰 | 2 cm, shorter echoes are glitches */
+#define ULTRASONIC_MAX_ECHO_US  23200   /**< 4 m，更长视为无障碍 | 4 m, longer means nothing in range */
+#define ULTRASONIC_US_PER_CM    58.3f   /**< 往返 1 cm 的时间 (343 m/s) | Round-trip time per cm at 343 m/s */
+#define ULTRASONIC_MAX_MISSES   3       /**< 连续丢失多少次后报告无障碍 | Consecutive misses before reporting clear */
+
+/**
+  * @enum    UltrasonicState
+  * @brief   测量状态 | Measurement state
+  */
+typedef enum {
+    ULTRASONIC_IDLE = 0,        /**< 空闲 | Idle */
+    ULTRASONIC_WAIT_RISE,       /**< 已触发，等待回波上升沿 | Triggered, waiting for the echo rising edge */
+    ULTRASONIC_WAIT_FALL,       /**< 等待回波下降沿 | Waiting for the echo falling edge */
+} UltrasonicState;
+
+/**
+  * @struct  UltrasonicReading
+  * @brief   已发布的障碍距离 | Published obstacle distance
+  */
+typedef struct {
+    fp32 distance;              /**< 中值滤波后的距离 (cm) | Median-filtered distance */
+    uint32_t timestamp;         /**< 最近一次有效回波的触发时刻 (ms) | Trigger time of the latest valid echo */
+    bool_t valid;               /**< FALSE 表示量程内无障碍或尚无数据 | FALSE: nothing in range or no data yet */
+} UltrasonicReading;
+
+/**
+  * @struct  UltrasonicStats
+  * @brief   统计 | Statistics
+  */
+typedef struct {
+    uint32_t triggers;          /**< 触发次数 | Triggers */
+    uint32_t echoes;            /**< 有效回波 | Valid echoes */
+    uint32_t timeouts;          /**< 超时或超量程 | Timeouts or out of range */
+    uint32_t rejected;          /**< 过短的回波或乱序边沿 | Too-short echoes or stray edges */
+} UltrasonicStats;
+
+/**
+  * @struct  Ultrasonic
+  * @brief   测距对象 | Ranging object
+  */
+typedef struct {
+    volatile UltrasonicState state;         /**< 测量状态 | Measurement state */
+    uint16_t triggerAt;                     /**< 触发时刻 (µs) | Trigger time */
+    uint16_t riseAt;                        /**< 回波上升沿 (µs) | Echo rising edge */
+    uint32_t triggerMs;                     /**< 触发时刻 (ms) | Trigger time */
+    uint32_t lastTriggerMs;                 /**< 上次触发 (ms) | Previous trigger */
+    bool_t triggered;                       /**< 曾经触发过 | Triggered at least once */
+
+    uint16_t window[ULTRASONIC_MEDIAN_N];   /**< 最近的回波宽度 (µs) | Recent echo widths */
+    uint8_t head;                           /**< 下一个写入位置 | Next write position */
+    uint8_t filled;                         /**< 窗口中的样本数 | Samples in the window */
+    uint8_t misses;                         /**< 连续丢失次数 | Consecutive misses */
+
+    UltrasonicStats stats;                  /**< 统计 | Statistics */
+    volatile uint32_t seq;                  /**< 读数序号，奇数表示正在写 | Reading sequence, odd while writing */
+    UltrasonicReading reading;              /**< 已发布的读数 | Published reading */
+} Ultrasonic;
+
+/**
+  * @brief   创建测距对象 | Create a ranging object
+  * @return  测距对象 | Ranging object
+  */
+Ultrasonic newUltrasonic(void);
+
+/**
+  * @brief   请求一次测量 | Request a measurement
+  * @param   self   测距对象指针 | Pointer to ranging object
+  * @param   nowUs  定时器计数 (µs) | Timer count
+  * @param   nowMs  系统时间 (ms) | System time
+  * @return  TRUE 调用者应立即发出触发脉冲；测量未结束或未到周期时返回 FALSE
+  *          TRUE if the caller should fire the trigger pulse now; FALSE while a measurement is
+  *          in flight or the cycle has not elapsed
+  */
+bool_t Ultrasonic_Trigger(Ultrasonic *self, uint16_t nowUs, uint32_t nowMs);
+
+/**
+  * @brief   回波边沿（输入捕获中断中调用） | Echo edge (called from the input-capture interrupt)
+  * @param   self     测距对象指针 | Pointer to ranging object
+  * @param   rising   TRUE 上升沿 | TRUE for a rising edge
+  * @param   capture  捕获值 (µs) | Captured count
+  */
+void Ultrasonic_Edge(Ultrasonic *self, bool_t rising, uint16_t capture);
+
+/**
+  * @brief   超时（比较中断中调用） | Timeout (called from the compare interrupt)
+  * @param   self  测距对象指针 | Pointer to ranging object
+  */
+void Ultrasonic_Timeout(Ultrasonic *self);
+
+/**
+  * @brief   读取一致的读数快照 | Read a consistent reading snapshot
+  * @param   self     测距对象指针 | Pointer to ranging object
+  * @param   reading  输出读数 | Output reading
+  * @note    序号锁（seqlock.h），写者是 TIM4 中断：只能在优先级低于 TIM4 的上下文（主循环或更低的中断）中调用，
+  *          能打断 TIM4 的中断会永远自旋。
+  *          Sequence lock (seqlock.h) written from the TIM4 interrupt: call only at a priority
+  *          below TIM4 (the main loop or a lower interrupt); an interrupt that can preempt TIM4
+  *          would spin forever.
+  */
+void Ultrasonic_Read(const Ultrasonic *self, UltrasonicReading *reading);
+
+#endif /* ULTRASONIC_H_ */
@@ -1,13 +1,14 @@
 #include "car.h"
 #include "pid.h"
 #include "communication.h"
+#include "param_store.h"
+#include "hcsr04.h"
 //#include "cmsis_os.h"
 
-// 全局小车对象 | Global car instance
-Car car;
+extern ParamStore paramStore;
 
-// PID 输出变量 | PID output variables
-int Vertical_out, Velocity_out, Turn_out;
+/* 单位换算 | Unit conversion */
+#define CM_PER_COUNT   (2.0f * 3.14159265f * WHEEL_RADIUS_CM / ENCODER_CPR)
 
 /**
   * @brief   创建并初始化小车实例 | Create and initialize a car instance
@@ -16,11 +17,11 @@ int Vertical_out, Velocity_out, Turn_out;
 Car newCar(void) {
     Car c = {
             .isBrake               = FALSE,    // 刹车标志 | Brake flag
+            .isObstacleDetected    = FALSE,    // 障碍标志 | Obstacle flag
             .motionState           = CAR_MOTION_STOP, // 当前运动状态 | Current motion state
             .targetLinearSpeed     = 0,        // 目标线速度 | Target linear speed
             .targetAngularSpeed    = 0,        // 目标角速度 | Target angular speed
             .targetStartLinearSpeed= 8,        // 初始启动速度 | Initial start speed
-            .balanceBias           = MECHANICAL_BALANCE_BIAS, // 平衡偏置 | Balance bias
             .cmd                   = CMD_STOP  // 默认命令 | Default command
     };
 
@@ -54,10 +55,16 @@ Car newCar(void) {
     c.encoder_l = newEncoder(&ENCODER_L_TIM, TIM_CHANNEL_ALL);
     c.encoder_r = newEncoder(&ENCODER_R_TIM, TIM_CHANNEL_ALL);
 
-    // 初始化并启用 IMU | Initialize and enable IMU
+    // 初始化并启用 IMU（分步初始化在控制周期中完成） | Initialize and enable IMU (the staged init finishes in the control tick)
     c.imu = newImu();
     c.imu.Enable(&c.imu);
 
+    // 控制栈；已保存的校准值优先于编译期常量 | Control stack; the stored calibration overrides the compile-time constant
+    c.control = newControl(c.targetStartLinearSpeed,
+                           ParamStore_GetFloat(&paramStore, PARAM_KEY_BALANCE_BIAS, MECHANICAL_BALANCE_BIAS));
+    c.control.useDmpYaw = ODOMETRY_USE_DMP_YAW ? TRUE : FALSE;
+    c.control.odometry.tau = ODOMETRY_USE_DMP_YAW ? ODOMETRY_DMP_FUSION_TAU : ODOMETRY_FUSION_TAU;
+
     // 绑定移动函数 | Bind move function
     c.CarMove = CarMove;
 
@@ -68,14 +75,44 @@ Car newCar(void) {
   * @brief   小车移动控制函数 | Car movement control function
   * @param   self      指向 Car 对象的指针 | Pointer to Car object
   * @param   setSpeed  未使用参数，可保留 | Unused parameter, can be retained
-  * @note    调用 PID 计算，判断刹车条件，并设置左右电机 PWM | Run PID, check brake, set left/right motor PWM
+  * @note    读取编码器、IMU 和超声波，运行控制栈，设置左右电机 | Read the encoders, IMU and sonar, run the control stack, set the left/right motors
   */
 void CarMove(Car *self, int8_t setSpeed) {
-//    int32_t PWM_out, motor_l_pwm, motor_r_pwm;
+    (void)setSpeed;
+    // 周期取自控制定时器，loop_us 参数修改后自动生效 | Period comes from the control timer, so loop_us changes apply directly
+    fp32 dt = (fp32)(__HAL_TIM_GET_AUTORELOAD(&CONTROL_TIM) + 1U) * 1e-6f;
+
+    // 编码器：计数/周期，电机内环使用电机自身方向 | Encoders: counts per period; the motor loops work in motor direction
+    self->encoder_l.GetCountAndRpm(&self->encoder_l);
+    self->encoder_r.GetCountAndRpm(&self->encoder_r);
+    self->motor_l.fdbRPM = self->encoder_l.rpm;
+    self->motor_r.fdbRPM = self->encoder_r.rpm;
+
+    self->tickMs = HAL_GetTick();
+    HC_Read(&self->range);
+    ControlInput in = {
+            .dLeft      = (fp32)(WHEEL_L_SIGN * self->encoder_l.rpm) * CM_PER_COUNT,
+            .dRight     = (fp32)(WHEEL_R_SIGN * self->encoder_r.rpm) * CM_PER_COUNT,
+            .pitch      = BALANCE_ANGLE(self->imu),
+            .pitchRate  = BALANCE_RATE(self->imu),
+            .yawRate    = YAW_RATE(self->imu),
+            .yaw        = YAW_ANGLE(self->imu),
+            .imuReady   = self->imu.ready,
+            .range      = self->range.distance,
+            .rangeValid = self->range.valid,
+            .rangeAge   = (fp32)(self->tickMs - self->range.timestamp) * 1e-3f
+    };
+    self->control.motion.startSpeed = self->targetStartLinearSpeed;
+    Control_Step(&self->control, &in, dt);
 
-//    checkMotionCommand();  // 更新目标速度 | Update target speeds
+    // 轮速 (cm/s) 换算为计数/周期送入电机内环 | Wheel speeds (cm/s) to counts per period for the motor loops
+    self->isBrake = self->control.brake;
+    self->motor_l.Move(&self->motor_l, self->isBrake, WHEEL_L_SIGN * self->control.balance.left * dt / CM_PER_COUNT);
+    self->motor_r.Move(&self->motor_r, self->isBrake, WHEEL_R_SIGN * self->control.balance.right * dt / CM_PER_COUNT);
 
-    // 发送 PWM 给电机并处理刹车 | Send PWM to motors and handle brake
-//    self->motor_l.Move(&self->motor_l, car.isBrake, motor_l_pwm);
-//    self->motor_r.Move(&self->motor_r, car.isBrake, motor_r_pwm);
+    // 对外可见的状态 | Externally visible state
+    self->isObstacleDetected = self->control.governor.obstacle;
+    self->motionState = self->control.motion.state;
+    self->targetLinearSpeed = (int8_t)self->control.motion.linear.target;
+    self->targetAngularSpeed = (int16_t)self->control.motion.angular.target;
 }
@@ -1,7 +1,4 @@
 #include "encoder.h"
-#include "car.h"
-#include "communication.h"
-extern Car car;
 
 /**
   * @brief   创建并初始化编码器实例 | Create and initialize an encoder instance
@@ -31,7 +28,6 @@ Encoder newEncoder(TIM_HandleTypeDef *htim, uint32_t Channel) {
 uint16_t GetCountAndRpm(Encoder *self) {
     self->last_count = self->count;  // 更新上次计数 | Update last count
 
-    static uint16_t cnt = 0;
     self->count =  (uint16_t)__HAL_TIM_GET_COUNTER(self->htim);  // 读取当前计数 | Read current counter
 
     __HAL_TIM_SetCounter(self->htim, 0);  // 计数器清零 | Reset counter
@@ -1,24 +1,60 @@
 #include "imu.h"
+#include "param_store.h"
+#include <string.h>
+
+extern ParamStore paramStore;
 
 /**
   * @brief   创建并初始化 IMU 实例 | Create and initialize IMU instance
   * @return  返回 IMU 结构体 | Returns IMU struct
   */
 Imu newImu(void) {
-    Imu i;
+    Imu i = {0};
     i.Enable   = Enable;    // 绑定启用函数 | Bind enable function
     i.Get_Data = Get_Data;  // 绑定数据获取函数 | Bind data retrieval function
     return i;               // 返回实例 | Return instance
 }
 
 /**
-  * @brief   启用 IMU 并初始化 MPU6500 | Enable IMU and init MPU6500
+  * @brief   载入已保存的零偏（六个值都存在才采用）并写入 DMP | Take the stored biases (only if all six exist) and write them into the DMP
+  */
+static void Load_Bias(Imu *self) {
+    int32_t gyro[3], accel[3];
+    bool_t ok = TRUE;
+    for (uint8_t i = 0; i < 3; i++) {
+        ok &= ParamStore_Get(&paramStore, PARAM_KEY_GYRO_BIAS + i, &gyro[i], sizeof(int32_t)) == PARAM_STORE_OK;
+        ok &= ParamStore_Get(&paramStore, PARAM_KEY_ACCEL_BIAS + i, &accel[i], sizeof(int32_t)) == PARAM_STORE_OK;
+    }
+    if (ok) {
+        memcpy(self->gyroBias, gyro, sizeof(gyro));
+        memcpy(self->accelBias, accel, sizeof(accel));
+    }
+    Imu_ApplyBias(self);
+}
+
+/**
+  * @brief   把零偏写入 DMP | Write the biases into the DMP
+  */
+int Imu_ApplyBias(Imu *self) {
+    if (self->init_result != 0) {
+        return 1;
+    }
+    long g[3] = {self->gyroBias[0], self->gyroBias[1], self->gyroBias[2]};
+    long a[3] = {self->accelBias[0], self->accelBias[1], self->accelBias[2]};
+    return MPU6500_Set_Bias(g, a);
+}
+
+/**
+  * @brief   启用 IMU，开始分步初始化 MPU6500 | Enable IMU and start the staged MPU6500 init
   * @param   self  指向 IMU 实例指针 | Pointer to IMU instance
-  * @return  返回初始化结果（0 成功） | Returns init status (0 = success)
+  * @return  MPU6500_INIT_BUSY
   */
 int Enable(Imu *self) {
-    self->init_result = (uint8_t)MPU_6500_Init();  // 调用底层初始化 | Call low-level init
-    return self->init_result;                      // 返回状态 | Return status
+    MPU6500_Init_Start();
+    self->ready = FALSE;
+    self->init_result = MPU6500_INIT_BUSY;
+    self->retry_backoff = IMU_RETRY_FIRST_TICKS;
+    return self->init_result;
 }
 
 /**
@@ -26,11 +62,39 @@ int Enable(Imu *self) {
   * @param   self  指向 IMU 实例指针 | Pointer to IMU instance
   */
 void Get_Data(Imu *self) {
+    // 初始化未完成：每个控制周期推进一步 | Init unfinished: one stage per control tick
+    if (self->init_result == MPU6500_INIT_BUSY) {
+        int result = MPU6500_Init_Poll();
+        self->init_result = (uint8_t)result;
+        if (result == 0) {
+            Load_Bias(self);
+            self->retry_backoff = IMU_RETRY_FIRST_TICKS;
+        } else if (result != MPU6500_INIT_BUSY) {
+            self->retry_wait = self->retry_backoff;
+            self->retry_backoff = (uint16_t)(2 * self->retry_backoff < IMU_RETRY_MAX_TICKS ? 2 * self->retry_backoff
+                                                                                         : IMU_RETRY_MAX_TICKS);
+        }
+        return;
+    }
+    // 初始化失败：退避后从头重试 | Init failed: start over after the backoff
+    if (self->init_result != 0) {
+        if (self->retry_wait > 0) {
+            self->retry_wait--;
+            return;
+        }
+        MPU6500_Init_Start();
+        self->init_result = MPU6500_INIT_BUSY;
+        self->init_retries++;
+        return;
+    }
+
     // 调用 DMP 获取俯仰、横滚、航向、加速度、陀螺仪数据
     // Call DMP to get pitch, roll, yaw, accel, and gyro data
-    MPU6500_DMP_Get_Data(
+    if (MPU6500_DMP_Get_Data(
             &self->pitch, &self->roll, &self->yaw,
             &self->ax,    &self->ay,   &self->az,
             &self->gyrox, &self->gyroy,&self->gyroz
-    );
+    ) == 0) {
+        self->ready = TRUE;
+    }
 }
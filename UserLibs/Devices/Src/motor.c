@@ -1,7 +1,7 @@
 #include "motor.h"
-#include "car.h"
+#include "param_store.h"
 
-extern Car car;
+extern ParamStore paramStore;
 
 /* 控制模式枚举 | Control modes */
 #define BRAKE     0   /**< 刹车 | Brake */
@@ -18,8 +18,6 @@ extern Car car;
 #define MOTOR_PID_MAX_OUT MOTOR_TIM_ARR
 #define MOTOR_PID_MAX_IOUT 30000.0
 
-fp32 pid_k[3]={800.0,20.0,0.0};
-
 /**
   * @brief   创建并初始化电机实例 | Create and initialize motor instance
   * @param   Init  电机初始化参数 | Motor initialization parameters
@@ -30,9 +28,16 @@ Motor newMotor(Motor_InitTypeDef Init) {
     m.Init = Init;                   // 保存初始化配置 | store Init config
     m.direction = BRAKE;             // 初始方向前进 | default direction FORWARD
     m.setRPM = MOTOR_MIN_RPM;        // 初始转速最小 | default RPM = MOTOR_MIN_RPM
+    m.fdbRPM = 0;                    // 初始反馈为零 | zero feedback
     m.Move = Move;                   // 绑定 Move 函数 | bind Move function
 
-    PID_init(&m.pid,PID_POSITION,pid_k,MOTOR_PID_MAX_OUT,MOTOR_PID_MAX_IOUT);
+    // 已保存的增益优先于默认值 | Stored gains override the defaults
+    fp32 k[3] = {
+            ParamStore_GetFloat(&paramStore, PARAM_KEY_MOTOR_KP, MOTOR_PID_KP),
+            ParamStore_GetFloat(&paramStore, PARAM_KEY_MOTOR_KI, MOTOR_PID_KI),
+            ParamStore_GetFloat(&paramStore, PARAM_KEY_MOTOR_KD, MOTOR_PID_KD)
+    };
+    PID_init(&m.pid,PID_POSITION,k,MOTOR_PID_MAX_OUT,MOTOR_PID_MAX_IOUT);
 
     HAL_TIM_PWM_Start(Init.htim, Init.Channel_1);  // 启动 PWM | start PWM on channel
     HAL_TIM_PWM_Start(Init.htim, Init.Channel_2);  // 启动 PWM | start PWM on channel
@@ -52,15 +57,17 @@ void Move(Motor *self, uint8_t isBrake, fp32 setRPM) {
         __HAL_TIM_SET_COMPARE(self->Init.htim, self->Init.Channel_1, MOTOR_TIM_ARR);
         __HAL_TIM_SET_COMPARE(self->Init.htim, self->Init.Channel_2, MOTOR_TIM_ARR);
         self->direction = BRAKE;     // 方向设为刹车 | set direction BRAKE
+        PID_clear(&self->pid);       // 松开刹车时不带旧积分 | no stale integral when released
     } else {
-      PID_calc(&self->pid,car.encoder_l.rpm,setRPM);
-      fp32 PWM_OUT = fabsf(self->pid.out);
-        if (setRPM > 0) {
+        // 方向取自 PID 输出而非目标，减速时可以反向制动 | Direction follows the PID output, not the target, so slowing down can drive in reverse
+        PID_calc(&self->pid, self->fdbRPM, setRPM);
+        fp32 PWM_OUT = fabsf(self->pid.out);
+        if (self->pid.out > 0) {
             // 正转：IN1 高、IN2 低 | Forward: IN1 high, IN2 low
             __HAL_TIM_SET_COMPARE(self->Init.htim, self->Init.Channel_1, PWM_OUT);
             __HAL_TIM_SET_COMPARE(self->Init.htim, self->Init.Channel_2, 0);
             self->direction = FORWARD; // 设置方向前进 | set direction FORWARD
-        } else if (setRPM < 0) {
+        } else if (self->pid.out < 0) {
             // 反转：IN1 低、IN2 高 | Reverse: IN1 low, IN2 high
             __HAL_TIM_SET_COMPARE(self->Init.htim, self->Init.Channel_1, 0);
             __HAL_TIM_SET_COMPARE(self->Init.htim, self->Init.Channel_2, PWM_OUT);
@@ -0,0 +1,119 @@
+#include "ultrasonic.h"
+#include "seqlock.h"
+#include <string.h>
+
+/**
+  * @brief   创建测距对象 | Create a ranging object
+  */
+Ultrasonic newUltrasonic(void) {
+    Ultrasonic u;
+    memset(&u, 0, sizeof(u));
+    u.state = ULTRASONIC_IDLE;
+    return u;
+}
+
+/**
+  * @brief   发布读数（序号锁） | Publish the reading (sequence lock)
+  */
+static void publish(Ultrasonic *self, fp32 distance, bool_t valid) {
+    SeqLock_WriteBegin(&self->seq);
+    self->reading.distance = distance;
+    self->reading.timestamp = self->triggerMs;
+    self->reading.valid = valid;
+    SeqLock_WriteEnd(&self->seq);
+}
+
+/**
+  * @brief   窗口中值（N 很小，插入排序） | Window median (N is tiny, insertion sort)
+  */
+static uint16_t median(const Ultrasonic *self) {
+    uint16_t v[ULTRASONIC_MEDIAN_N];
+    uint8_t n = self->filled;
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t x = self->window[i];
+        uint8_t j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+    return v[n / 2];
+}
+
+/**
+  * @brief   记录一次丢失；连续丢失后报告无障碍 | Record a miss; report clear after consecutive misses
+  */
+static void miss(Ultrasonic *self) {
+    self->stats.timeouts++;
+    if (self->misses < ULTRASONIC_MAX_MISSES && ++self->misses == ULTRASONIC_MAX_MISSES) {
+        self->filled = 0;
+        self->head = 0;
+        publish(self, 0.0f, FALSE);
+    }
+}
+
+/**
+  * @brief   请求一次测量 | Request a measurement
+  */
+bool_t Ultrasonic_Trigger(Ultrasonic *self, uint16_t nowUs, uint32_t nowMs) {
+    if (self->state != ULTRASONIC_IDLE) return FALSE;
+    if (self->triggered && nowMs - self->lastTriggerMs < ULTRASONIC_PERIOD_MS) return FALSE;
+
+    self->triggered = TRUE;
+    self->lastTriggerMs = nowMs;
+    self->triggerMs = nowMs;
+    self->triggerAt = nowUs;
+    self->stats.triggers++;
+    self->state = ULTRASONIC_WAIT_RISE;
+    return TRUE;
+}
+
+/**
+  * @brief   回波边沿 | Echo edge
+  */
+void Ultrasonic_Edge(Ultrasonic *self, bool_t rising, uint16_t capture) {
+    if (rising && self->state == ULTRASONIC_WAIT_RISE) {
+        self->riseAt = capture;
+        self->state = ULTRASONIC_WAIT_FALL;
+        return;
+    }
+    if (rising || self->state != ULTRASONIC_WAIT_FALL) {
+        self->stats.rejected++;     // 上次余波或干扰 | Tail of an old echo or noise
+        return;
+    }
+
+    uint16_t width = (uint16_t)(capture - self->riseAt);
+    self->state = ULTRASONIC_IDLE;
+    if (width < ULTRASONIC_MIN_ECHO_US) {
+        self->stats.rejected++;
+        return;
+    }
+    if (width > ULTRASONIC_MAX_ECHO_US) {
+        miss(self);
+        return;
+    }
+
+    self->stats.echoes++;
+    self->misses = 0;
+    self->window[self->head] = width;
+    self->head = (uint8_t)((self->head + 1) % ULTRASONIC_MEDIAN_N);
+    if (self->filled < ULTRASONIC_MEDIAN_N) self->filled++;
+    publish(self, median(self) / ULTRASONIC_US_PER_CM, TRUE);
+}
+
+/**
+  * @brief   超时 | Timeout
+  */
+void Ultrasonic_Timeout(Ultrasonic *self) {
+    if (self->state == ULTRASONIC_IDLE) return;
+    self->state = ULTRASONIC_IDLE;
+    miss(self);
+}
+
+/**
+  * @brief   读取一致的读数快照 | Read a consistent reading snapshot
+  */
+void Ultrasonic_Read(const Ultrasonic *self, UltrasonicReading *reading) {
+    SeqLock_Read(&self->seq, reading, &self->reading, sizeof(*reading));
+}
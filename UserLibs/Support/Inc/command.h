@@ -0,0 +1,28 @@
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+/**
+  * @file    command.h
+  * @brief   运动命令编码（与硬件无关，上位机工具共用） | Motion command codes (hardware-independent, shared with host tools)
+  */
+
+/* 控制命令宏定义 | Command macros */
+#define CMD_LEFT            0xC1  /**< 左转命令 | Turn left command */
+#define CMD_RIGHT           0xC2  /**< 右转命令 | Turn right command */
+#define CMD_FORWARD         0xC3  /**< 前进命令 | Move forward command */
+#define CMD_BACKWARD        0xC4  /**< 后退命令 | Move backward command */
+#define CMD_STOP            0xC5  /**< 停止命令 | Stop command */
+
+#define CMD_STOP_SLOWLY     0xC6  /**< 缓慢停止命令 | Stop slowly command */
+#define CMD_SPEED_UP        0xC7  /**< 加速命令 | Speed up command */
+#define CMD_SPEED_DOWN      0xC8  /**< 减速命令 | Slow down command */
+
+#define CMD_ROAD_PLANNING   0xC9  /**< 路径规划模式切换命令 | Toggle road planning mode */
+
+#define CMD_TURN_AROUND     0xCA  /**< 原地掉头命令 | Turn around in place command */
+#define CMD_TURN_CLEAR      0xCB  /**< 清除转向命令 | Clear turning command */
+
+#define CMD_POWER_SWITCH    0xCC  /**< 电源开关命令 | Power switch command */
+#define CMD_SPEED_CONSTANT  0xCD  /**< 固定速度模式命令 | Constant speed mode command */
+
+#endif /* COMMAND_H_ */
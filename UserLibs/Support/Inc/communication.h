@@ -7,6 +7,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "string.h"
+#include "struct_typedef.h"
+#include "uart_rx.h"
+#include "command.h"
 
 /* UART 句柄映射 | UART handle mappings */
 #define huart_pc        huart2    /**< 上位机通信 UART | UART for PC communication */
@@ -14,27 +17,58 @@
 
 /* 缓冲区大小 | Buffer size */
 #define BUF_SIZE        64        /**< 串口收发缓冲区长度 | UART RX/TX buffer length */
+#define TX_QUEUE_SIZE   256       /**< DMA 发送双缓冲单块长度 | Size of each DMA TX double buffer */
+#define CMD_QUEUE_SIZE  8         /**< 运动命令队列长度（2 的幂） | Motion command queue length (power of 2) */
+#define RX_DMA_SIZE     256       /**< 循环 DMA 接收缓冲区长度 | Circular DMA RX buffer length */
 
-/* 控制命令宏定义 | Command macros */
-#define CMD_LEFT            0xC1  /**< 左转命令 | Turn left command */
-#define CMD_RIGHT           0xC2  /**< 右转命令 | Turn right command */
-#define CMD_FORWARD         0xC3  /**< 前进命令 | Move forward command */
-#define CMD_BACKWARD        0xC4  /**< 后退命令 | Move backward command */
-#define CMD_STOP            0xC5  /**< 停止命令 | Stop command */
+void uart_SendMsg(UART_HandleTypeDef *huart, uint8_t *msg);
 
-#define CMD_STOP_SLOWLY     0xC6  /**< 缓慢停止命令 | Stop slowly command */
-#define CMD_SPEED_UP        0xC7  /**< 加速命令 | Speed up command */
-#define CMD_SPEED_DOWN      0xC8  /**< 减速命令 | Slow down command */
+/**
+  * @brief   启动上位机串口接收 | Start PC link reception
+  */
+void uart_Init(void);
 
-#define CMD_ROAD_PLANNING   0xC9  /**< 路径规划模式切换命令 | Toggle road planning mode */
+/**
+  * @brief   上位机接收链路统计 | PC link receive statistics
+  * @return  统计指针 | Pointer to statistics
+  */
+const UartRxStats *uart_RxStats(void);
 
-#define CMD_TURN_AROUND     0xCA  /**< 原地掉头命令 | Turn around in place command */
-#define CMD_TURN_CLEAR      0xCB  /**< 清除转向命令 | Clear turning command */
+/**
+  * @brief   取出一条串口收到的运动命令 | Take one motion command received over UART
+  * @param   cmd  输出命令 CMD_* | Output command CMD_*
+  * @return  TRUE 取到命令，FALSE 队列为空 | TRUE if a command was taken, FALSE if empty
+  *
+  * @note    串口中断只入队，命令在主循环中生效 | The UART IRQ only queues; commands take effect in the main loop
+  */
+bool_t uart_PollCommand(uint8_t *cmd);
 
-#define CMD_POWER_SWITCH    0xCC  /**< 电源开关命令 | Power switch command */
-#define CMD_SPEED_CONSTANT  0xCD  /**< 固定速度模式命令 | Constant speed mode command */
+/**
+  * @brief   写入上位机 DMA 发送队列 | Queue bytes on the PC link DMA TX queue
+  * @param   data  数据指针 | Pointer to data
+  * @param   len   数据长度 | Data length
+  * @return  0 成功，-1 队列已满（整块丢弃并计数） | 0 on success, -1 if full (dropped whole and counted)
+  *
+  * @note    双缓冲：DMA 发送一块的同时另一块继续填充，可在中断和主循环中调用
+  *          Double-buffered: one buffer fills while DMA drains the other; safe from IRQ and main loop
+  */
+int uart_Write(const uint8_t *data, uint16_t len);
 
-void uart_SendMsg(UART_HandleTypeDef *huart, uint8_t *msg);
+/**
+  * @brief   编码并发送一帧 | Encode and queue one frame
+  * @param   type     消息类型 | Message type
+  * @param   seq      序号 | Sequence number
+  * @param   payload  负载 | Payload
+  * @param   len      负载长度 | Payload length
+  * @return  0 成功，-1 失败 | 0 on success, -1 on failure
+  */
+int uart_SendFrame(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len);
+
+/**
+  * @brief   发送队列丢弃计数 | TX queue drop count
+  * @return  因队列满而丢弃的写入次数 | Number of writes dropped because the queue was full
+  */
+uint32_t uart_TxDropped(void);
 
 /**
   * @brief   格式化串口打印 | Formatted UART print
@@ -43,7 +77,8 @@ void uart_SendMsg(UART_HandleTypeDef *huart, uint8_t *msg);
   * @param   ...    可选参数列表 | Variable argument list
   * @return  无 | None
   *
-  * @note    通过 HAL_UART_Transmit 实现可变参数格式输出 | Uses HAL_UART_Transmit to send formatted data
+  * @note    仅用于调试：格式化开销大，控制循环中请使用遥测帧
+  *          Debug only: formatting is expensive, use telemetry frames in the control loop
   */
 void uart_printf(UART_HandleTypeDef *huart, const char *fmt, ...);
 
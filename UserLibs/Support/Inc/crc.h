@@ -0,0 +1,43 @@
+#ifndef CRC_H_
+#define CRC_H_
+
+#include <stdint.h>
+
+/**
+  * @file    crc.h
+  * @brief   通用 CRC 校验接口 | Common CRC checksum interface
+  */
+
+/* CRC16 初始值（CCITT-FALSE，多项式 0x1021） | CRC16 initial value (CCITT-FALSE, poly 0x1021) */
+#define CRC16_INIT      0xFFFFu
+
+/* CRC32 初始值（IEEE 802.3，反射多项式 0xEDB88320） | CRC32 initial value (IEEE 802.3, reflected poly 0xEDB88320) */
+#define CRC32_INIT      0xFFFFFFFFu
+
+/**
+  * @brief   计算 CRC16-CCITT | Compute CRC16-CCITT
+  * @param   crc   上一次的 CRC 值（首次传入 CRC16_INIT） | Running CRC (pass CRC16_INIT first)
+  * @param   data  数据指针 | Pointer to data
+  * @param   len   数据长度 | Data length
+  * @return  更新后的 CRC | Updated CRC
+  */
+uint16_t CRC16_Update(uint16_t crc, const void *data, uint32_t len);
+
+/**
+  * @brief   计算 CRC32 | Compute CRC32
+  * @param   crc   上一次的 CRC 值（首次传入 CRC32_INIT） | Running CRC (pass CRC32_INIT first)
+  * @param   data  数据指针 | Pointer to data
+  * @param   len   数据长度 | Data length
+  * @return  更新后的 CRC（未取反，完成时需 ^ 0xFFFFFFFF） | Updated CRC (not inverted; XOR with 0xFFFFFFFF when done)
+  */
+uint32_t CRC32_Update(uint32_t crc, const void *data, uint32_t len);
+
+/**
+  * @brief   一次性计算数据块的 CRC32 | Compute CRC32 of a block in one call
+  * @param   data  数据指针 | Pointer to data
+  * @param   len   数据长度 | Data length
+  * @return  最终 CRC32 值 | Final CRC32 value
+  */
+uint32_t CRC32_Calc(const void *data, uint32_t len);
+
+#endif /* CRC_H_ */
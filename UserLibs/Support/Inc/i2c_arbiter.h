@@ -0,0 +1,169 @@
+#ifndef I2C_ARBITER_H_
+#define I2C_ARBITER_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    i2c_arbiter.h
+  * @brief   按优先级共享 I2C 总线 | Priority arbitration of a shared I2C bus
+  *
+  * @note    每个客户端一个请求队列，编号越小优先级越高。可拆分的长写入按 segmentMax 字节分段，
+  *          每段结束后重新选择客户端，所以高优先级请求最多等待一段（已开始的传输不能中止）。
+  *          与硬件无关：传输的启动、计时和临界区由 I2CBus 后端提供，主机端测试用模拟时钟驱动同一份代码。
+  *          One request queue per client; lower numbers have higher priority. Splittable long
+  *          writes are cut into segments of at most segmentMax bytes and the next client is chosen
+  *          after every segment, so a high-priority request waits for at most one segment (a
+  *          transfer on the wire cannot be aborted). Hardware-independent: starting transfers,
+  *          timing and critical sections come from the I2CBus backend, and the host test drives
+  *          the same code from a simulated clock.
+  *
+  *          出错后仲裁器暂停派发，由线程上下文中的 I2CArb_Service 调用后端的 Recover 复位总线后再继续，
+  *          错误中断里不做耗时的恢复。
+  *          After an error the arbiter stops dispatching; I2CArb_Service, called from thread
+  *          context, has the backend's Recover reset the bus before carrying on, so no slow
+  *          recovery runs in the error interrupt.
+  */
+
+#define I2C_ARB_CLIENTS         2       /**< 客户端数量 | Number of clients */
+#define I2C_ARB_QUEUE           4       /**< 每个客户端的队列深度 | Queue depth per client */
+
+#define I2C_CLIENT_IMU          0       /**< MPU6500，最高优先级 | MPU6500, highest priority */
+#define I2C_CLIENT_OLED         1       /**< OLED 显示，后台 | OLED display, background */
+
+/* 请求状态 | Request status */
+#define I2C_ARB_DONE            0       /**< 完成 | Completed */
+#define I2C_ARB_PENDING         1       /**< 排队或传输中 | Queued or in flight */
+#define I2C_ARB_ERR_BUS         (-1)    /**< 总线错误或无应答 | Bus error or NACK */
+#define I2C_ARB_ERR_FULL        (-2)    /**< 队列已满 | Queue full */
+
+/**
+  * @struct  I2CRequest
+  * @brief   一次寄存器读写（调用者持有，完成前不能释放） | One register transfer (owned by the caller, kept alive until done)
+  */
+typedef struct {
+    uint8_t addr;               /**< 8 位设备地址 | 8-bit device address */
+    uint8_t reg;                /**< 寄存器地址或控制字节，每段都会重发 | Register address or control byte, resent with every segment */
+    bool_t read;                /**< TRUE 读 | TRUE to read */
+    bool_t split;               /**< 允许分段（设备地址自增或为流式写入） | May be segmented (auto-incrementing or streaming device) */
+    uint8_t *data;              /**< 数据 | Data */
+    uint16_t len;               /**< 字节数 | Byte count */
+    volatile int8_t status;     /**< I2C_ARB_PENDING 直到完成 | I2C_ARB_PENDING until done */
+    uint32_t queuedAt;          /**< 入队时刻（内部使用） | Time queued (internal) */
+} I2CRequest;
+
+typedef struct I2CBus I2CBus;
+
+/**
+  * @struct  I2CBus
+  * @brief   总线后端接口 | Bus backend interface
+  */
+struct I2CBus {
+    void *ctx;                  /**< 后端私有数据 | Backend private data */
+    uint32_t ticksPerUs;        /**< Now 的计数频率 (MHz) | Now tick rate */
+
+    void (*Start)(I2CBus *self, uint8_t addr, uint8_t reg, bool_t read, uint8_t *data, uint16_t len);
+    /**< 启动一段异步传输，结束时调用 I2CArb_Complete | Start an asynchronous segment; I2CArb_Complete is called when it ends */
+    uint32_t (*Now)(I2CBus *self);
+    /**< 自由运行计数 | Free-running tick count */
+    uint32_t (*Lock)(I2CBus *self);
+    /**< 进入临界区（与完成中断互斥），返回恢复用的状态 | Enter a critical section against the completion interrupt, returning the state to restore */
+    void (*Unlock)(I2CBus *self, uint32_t state);
+    /**< 退出临界区 | Leave the critical section */
+    bool_t (*Recover)(I2CBus *self);
+    /**< 复位外设并释放总线（线程上下文，总线空闲时调用，可为 NULL），TRUE 成功 | Reset the peripheral and free the bus (thread context, bus idle, may be NULL); TRUE on success */
+};
+
+/**
+  * @struct  I2CClientStats
+  * @brief   每个客户端的统计 | Per-client statistics
+  */
+typedef struct {
+    uint32_t requests;          /**< 完成的请求 | Completed requests */
+    uint32_t segments;          /**< 传输的段 | Segments transferred */
+    uint32_t errors;            /**< 失败的请求 | Failed requests */
+    uint32_t busyTicks;         /**< 占用总线的时间 | Time holding the bus */
+    uint32_t maxWaitTicks;      /**< 入队到第一段开始的最长等待 | Worst wait from queueing to the first segment */
+} I2CClientStats;
+
+/**
+  * @struct  I2CArbiter
+  * @brief   总线仲裁器 | Bus arbiter
+  */
+typedef struct {
+    I2CBus bus;                                     /**< 总线后端 | Bus backend */
+    uint16_t segmentMax;                            /**< 可拆分请求的段长上限 | Segment limit for splittable requests */
+
+    I2CRequest *queue[I2C_ARB_CLIENTS][I2C_ARB_QUEUE];  /**< 各客户端的请求环 | Per-client request rings */
+    uint8_t head[I2C_ARB_CLIENTS];                  /**< 队首 | Ring head */
+    uint8_t count[I2C_ARB_CLIENTS];                 /**< 排队数 | Queued requests */
+    uint16_t offset[I2C_ARB_CLIENTS];               /**< 队首请求已传输的字节 | Bytes of the head request already sent */
+
+    volatile bool_t busy;                           /**< 有一段在总线上 | A segment is on the wire */
+    uint8_t active;                                 /**< 当前段所属客户端 | Client owning the current segment */
+    uint16_t activeLen;                             /**< 当前段长度 | Current segment length */
+    uint32_t activeSince;                           /**< 当前段开始时刻 | Current segment start */
+
+    volatile bool_t faulted;                        /**< 出错后暂停派发，等待恢复 | Dispatch paused after an error until recovered */
+    uint32_t recoveries;                            /**< 成功的恢复（不随统计清零） | Successful recoveries (kept across stats resets) */
+    uint32_t recoverFails;                          /**< 失败的恢复 | Failed recoveries */
+    uint32_t maxRecoverTicks;                       /**< 最长恢复耗时 | Longest recovery */
+
+    uint32_t statsSince;                            /**< 统计起点 | Statistics start */
+    I2CClientStats stats[I2C_ARB_CLIENTS];          /**< 统计 | Statistics */
+} I2CArbiter;
+
+/**
+  * @brief   创建仲裁器 | Create an arbiter
+  * @param   bus         总线后端 | Bus backend
+  * @param   segmentMax  可拆分请求的段长上限（字节） | Segment limit for splittable requests in bytes
+  * @return  仲裁器 | Arbiter
+  */
+I2CArbiter newI2CArbiter(I2CBus bus, uint16_t segmentMax);
+
+/**
+  * @brief   提交请求（立即返回） | Submit a request (returns at once)
+  * @param   self    仲裁器指针 | Pointer to arbiter
+  * @param   client  客户端编号（优先级） | Client number (priority)
+  * @param   req     请求，status 完成前保持 I2C_ARB_PENDING | Request, status stays I2C_ARB_PENDING until done
+  * @return  I2C_ARB_PENDING 或 I2C_ARB_ERR_FULL | I2C_ARB_PENDING or I2C_ARB_ERR_FULL
+  */
+int I2CArb_Submit(I2CArbiter *self, uint8_t client, I2CRequest *req);
+
+/**
+  * @brief   当前段结束（由后端在完成或错误中断中调用） | The current segment ended (called by the backend from its completion or error interrupt)
+  * @param   self  仲裁器指针 | Pointer to arbiter
+  * @param   ok    TRUE 成功；FALSE 时整个请求失败并暂停派发 | TRUE on success; FALSE fails the whole request and pauses dispatching
+  */
+void I2CArb_Complete(I2CArbiter *self, bool_t ok);
+
+/**
+  * @brief   出错后恢复总线并继续派发（线程上下文中轮询） | Recover the bus after an error and resume dispatching (polled from thread context)
+  * @param   self  仲裁器指针 | Pointer to arbiter
+  * @note    没有错误时立即返回；恢复期间只有调用者在用总线 | Returns at once when nothing failed; during recovery only the caller uses the bus
+  */
+void I2CArb_Service(I2CArbiter *self);
+
+/**
+  * @brief   客户端占用总线的比例（自上次清零起） | Share of time a client held the bus since the last reset
+  * @param   self    仲裁器指针 | Pointer to arbiter
+  * @param   client  客户端编号 | Client number
+  * @return  0..1
+  */
+fp32 I2CArb_Utilization(const I2CArbiter *self, uint8_t client);
+
+/**
+  * @brief   客户端最长等待 (µs) | Worst wait of a client
+  * @param   self    仲裁器指针 | Pointer to arbiter
+  * @param   client  客户端编号 | Client number
+  * @return  最长等待 (µs) | Worst wait
+  */
+uint32_t I2CArb_MaxWaitUs(const I2CArbiter *self, uint8_t client);
+
+/**
+  * @brief   清零统计 | Reset the statistics
+  * @param   self  仲裁器指针 | Pointer to arbiter
+  */
+void I2CArb_ResetStats(I2CArbiter *self);
+
+#endif /* I2C_ARBITER_H_ */
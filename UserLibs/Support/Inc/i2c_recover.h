@@ -0,0 +1,57 @@
+#ifndef I2C_RECOVER_H_
+#define I2C_RECOVER_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    i2c_recover.h
+  * @brief   I2C 总线卡死恢复（GPIO 时钟输出） | I2C stuck-bus recovery by GPIO clock-out
+  *
+  * @note    主机在传输中途复位时，从机可能正把 SDA 拉低输出某一位，总线从此一直忙。
+  *          按 I2C 规范 3.1.16：用 GPIO 在 SCL 上最多打 9 个时钟，直到从机释放 SDA，再发一个 STOP。
+  *          引脚操作由 I2CPins 后端提供，固件用开漏 GPIO，主机端测试用逐位的从机模型。
+  *          When the master resets mid-transfer a slave may be holding SDA low for a bit it is
+  *          still sending, and the bus stays busy from then on. Per I2C spec 3.1.16, up to nine
+  *          clocks are toggled on SCL by GPIO until the slave releases SDA, then a STOP is sent.
+  *          Pin access comes from the I2CPins backend: open-drain GPIO on the firmware, a
+  *          bit-level slave model in the host test.
+  */
+
+#define I2C_RECOVER_CLOCKS      9       /**< 最多时钟数（8 位数据 + 应答） | Most clocks needed (8 data bits + ACK) */
+#define I2C_RECOVER_STRETCH     100     /**< 等待 SCL 释放的最多半周期数 | Half periods to wait for SCL to be released */
+
+/* 返回值 | Return codes */
+#define I2C_RECOVER_ERR_SCL     (-1)    /**< SCL 一直为低 | SCL held low */
+#define I2C_RECOVER_ERR_SDA     (-2)    /**< 9 个时钟后 SDA 仍为低 | SDA still low after nine clocks */
+
+typedef struct I2CPins I2CPins;
+
+/**
+  * @struct  I2CPins
+  * @brief   开漏引脚后端 | Open-drain pin backend
+  */
+struct I2CPins {
+    void *ctx;                  /**< 后端私有数据 | Backend private data */
+
+    void (*Scl)(I2CPins *self, bool_t high);
+    /**< 释放 (TRUE) 或拉低 SCL | Release (TRUE) or pull SCL low */
+    void (*Sda)(I2CPins *self, bool_t high);
+    /**< 释放 (TRUE) 或拉低 SDA | Release (TRUE) or pull SDA low */
+    bool_t (*ReadScl)(I2CPins *self);
+    /**< 读 SCL 线电平 | Read the SCL line */
+    bool_t (*ReadSda)(I2CPins *self);
+    /**< 读 SDA 线电平 | Read the SDA line */
+    void (*Delay)(I2CPins *self);
+    /**< 等待半个时钟周期 | Wait half a clock period */
+};
+
+/**
+  * @brief   打出时钟释放总线并发送 STOP | Clock the bus free and send a STOP
+  * @param   pins  引脚后端（调用前引脚已切换为开漏 GPIO） | Pin backend (pins already switched to open-drain GPIO)
+  * @return  用掉的时钟数 (0..9)，或 I2C_RECOVER_ERR_SCL / I2C_RECOVER_ERR_SDA | Clocks used, or an error code
+  * @note    最长耗时 (2 × 9 + 5 + I2C_RECOVER_STRETCH) 个半周期 | Takes at most (2 × 9 + 5 + I2C_RECOVER_STRETCH) half periods
+  */
+int I2C_ClockOut(I2CPins *pins);
+
+#endif /* I2C_RECOVER_H_ */
@@ -0,0 +1,56 @@
+#ifndef LINK_DISPATCH_H_
+#define LINK_DISPATCH_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+#include "protocol.h"
+#include "uart_rx.h"
+#include "spsc_ring.h"
+#include "path.h"
+
+/**
+  * @file    link_dispatch.h
+  * @brief   上位机链路的帧分发 | Frame dispatch of the PC link
+  *
+  * @note    固件的 USART2（communication.c）与仿真器的 pty（sim_link.c）共用：参数帧交给
+  *          Param_HandleFrame，路径帧交给 Path_HandleFrame，运动命令去重后入队并应答，
+  *          MSG_LINK_STATS 返回接收统计。应答经 send 回调发出，本模块不接触硬件。
+  *          Shared by the firmware's USART2 (communication.c) and the simulator's pty
+  *          (sim_link.c): parameter frames go to Param_HandleFrame, path frames to
+  *          Path_HandleFrame, motion commands are de-duplicated, queued and acked, and
+  *          MSG_LINK_STATS is answered with the receive statistics. Replies go out through the
+  *          send callback, so this module never touches hardware.
+  */
+
+/**
+  * @brief   发送一帧 | Send one frame
+  * @param   ctx      LinkDispatch.ctx
+  * @param   type     消息类型 | Message type
+  * @param   seq      序号 | Sequence number
+  * @param   payload  负载 | Payload
+  * @param   len      负载长度 | Payload length
+  * @return  0 成功，队列满时非零 | 0 on success, non-zero when the queue is full
+  */
+typedef int (*LinkSend)(void *ctx, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len);
+
+/**
+  * @struct  LinkDispatch
+  * @brief   分发目标 | Dispatch targets
+  */
+typedef struct {
+    PathFollower *path;     /**< 路径帧的目标，NULL 时不处理路径帧 | Target of path frames; NULL ignores them */
+    SpscRing *cmds;         /**< 运动命令队列（元素 1 字节） | Motion command queue (1-byte elements) */
+    LinkSend send;          /**< 应答发送 | Reply sender */
+    void *ctx;              /**< send 的上下文 | Context for send */
+} LinkDispatch;
+
+/**
+  * @brief   处理一帧 | Handle one frame
+  * @param   self   分发目标 | Dispatch targets
+  * @param   rx     收到该帧的接收通道（命令去重与统计） | Receive channel the frame came from (command de-duplication and statistics)
+  * @param   frame  解码后的帧 | Decoded frame
+  * @note    在接收通道的上下文中调用（固件为 USART2 中断） | Called in the receive channel's context (the USART2 interrupt on the firmware)
+  */
+void Link_HandleFrame(const LinkDispatch *self, UartRx *rx, const Frame *frame);
+
+#endif /* LINK_DISPATCH_H_ */
@@ -0,0 +1,85 @@
+#ifndef MICRO_BENCH_H_
+#define MICRO_BENCH_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    micro_bench.h
+  * @brief   热点函数微基准：主机与目标板共用的负载与统计 | Hot-function micro-benchmarks: workloads and statistics shared by host and target
+  *
+  * @note    每个用例把被测函数在一张预先生成的输入表上调用 MICRO_BENCH_BATCH 次，输入按固定种子生成，
+  *          主机与目标板完全相同；结果累加进 microBenchSink，编译器不能删掉调用。计时由调用者负责：
+  *          主机工具 dnb_micro 用 CLOCK_MONOTONIC 得到 ns/次，目标板用 DWT CYCCNT 得到周期/次，
+  *          两边都多次重复并轮流执行各用例，报告中位数及其 95% 置信区间，格式相同的 JSON 便于对比。
+  *          dmp_decode 用例要求 DMP 已初始化（数据包格式取决于已开启的功能）。
+  *          Each case calls the function under test MICRO_BENCH_BATCH times over a pre-generated
+  *          input table. The inputs come from a fixed seed, so host and target see exactly the
+  *          same data; results are summed into microBenchSink so the compiler cannot drop the
+  *          calls. Timing is the caller's: the host tool dnb_micro uses CLOCK_MONOTONIC for
+  *          ns per call, the target uses DWT CYCCNT for cycles per call. Both repeat every case
+  *          many times, round-robin over the cases, and report the median with its 95% confidence
+  *          interval, in the same JSON layout so the two can be compared.
+  *          The dmp_decode case needs the DMP initialised (the packet layout follows the enabled
+  *          features).
+  *          固件中以 MICRO_BENCH=1 编译时，上电后先跑一遍基准并从上位机串口打印，再进入控制循环。
+  *          Firmware built with MICRO_BENCH=1 runs the benchmarks once after power-up and prints
+  *          them on the PC link before entering the control loop.
+  */
+
+/* 1：固件上电后运行微基准 | 1: the firmware runs the micro-benchmarks after power-up */
+#ifndef MICRO_BENCH
+#define MICRO_BENCH             0
+#endif
+
+#define MICRO_BENCH_BATCH       256     /**< 每次计时的调用数，也是输入表长度 | Calls per timed batch, also the input table length */
+#define MICRO_BENCH_MAX_REPEATS 101     /**< 最多重复次数 | Most repetitions */
+
+/**
+  * @struct  MicroBenchCase
+  * @brief   一个用例 | One case
+  */
+typedef struct {
+    const char *name;                   /**< 用例名 | Case name */
+    const char *function;               /**< 被测函数 | Function under test */
+    void (*Setup)(void);                /**< 生成输入、复位状态 | Generate the inputs and reset the state */
+    void (*Run)(void);                  /**< 调用 MICRO_BENCH_BATCH 次 | Call MICRO_BENCH_BATCH times */
+} MicroBenchCase;
+
+/**
+  * @struct  MicroBenchStats
+  * @brief   一个用例的统计（单位为每次调用） | Statistics of one case (per call)
+  */
+typedef struct {
+    uint16_t n;                         /**< 样本数 | Sample count */
+    fp32 min;                           /**< 最小值 | Minimum */
+    fp32 median;                        /**< 中位数 | Median */
+    fp32 mean;                          /**< 均值 | Mean */
+    fp32 stddev;                        /**< 标准差 | Standard deviation */
+    fp32 mad;                           /**< 中位数绝对偏差 | Median absolute deviation */
+    fp32 ciLow, ciHigh;                 /**< 中位数的 95% 置信区间（次序统计量） | 95% confidence interval of the median (order statistics) */
+} MicroBenchStats;
+
+extern const MicroBenchCase microBenchCases[];
+extern const uint8_t microBenchCaseCount;
+extern volatile uint32_t microBenchSink;
+
+/**
+  * @brief   汇总样本 | Summarise samples
+  * @note    样本原地排序；置信区间取第 n/2 ∓ 0.98·√n 个次序统计量，不假设分布
+  *          Sorts the samples in place; the interval is the n/2 ∓ 0.98·√n order statistics, with no
+  *          assumption about the distribution
+  * @param   samples  每次调用的时间 | Time per call
+  * @param   n        样本数 | Sample count
+  * @param   out      统计 | Statistics
+  */
+void MicroBench_Summarise(fp32 *samples, uint16_t n, MicroBenchStats *out);
+
+/**
+  * @brief   用 DWT CYCCNT 跑全部用例并从上位机串口打印 JSON | Run every case with DWT CYCCNT and print JSON on the PC link
+  * @note    阻塞执行，期间关中断计时；仅固件实现 | Blocking, with interrupts off while timing; firmware only
+  * @param   repeats  每个用例的重复次数（不超过 MICRO_BENCH_MAX_REPEATS） | Repetitions per case (at most MICRO_BENCH_MAX_REPEATS)
+  */
+void MicroBench_Target(uint16_t repeats);
+
+#endif /* MICRO_BENCH_H_ */
@@ -0,0 +1,133 @@
+#ifndef PARAM_H_
+#define PARAM_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+#include "protocol.h"
+
+/**
+  * @file    param.h
+  * @brief   运行时参数注册表 | Runtime parameter registry
+  *
+  * @note    串口写入先暂存，在控制循环边界由 Param_ApplyPending 统一生效
+  *          UART writes are staged and take effect together in Param_ApplyPending at a loop boundary
+  */
+
+/* 参数类型 | Parameter types */
+typedef enum {
+    PARAM_TYPE_F32 = 0,     /**< fp32 */
+    PARAM_TYPE_I32,         /**< int32_t */
+    PARAM_TYPE_U16,         /**< uint16_t */
+    PARAM_TYPE_I8,          /**< int8_t */
+    PARAM_TYPE_U8           /**< uint8_t */
+} ParamType;
+
+/* 参数标志 | Parameter flags */
+#define PARAM_FLAG_PERSIST      0x01    /**< 保存到 Flash | Saved to flash */
+#define PARAM_FLAG_READONLY     0x02    /**< 只读 | Read-only */
+
+/* 返回值 | Return codes */
+#define PARAM_OK                0       /**< 成功 | Success */
+#define PARAM_ERR_ID            (-1)    /**< 参数编号无效 | Invalid id */
+#define PARAM_ERR_RANGE         (-2)    /**< 超出范围 | Out of range */
+#define PARAM_ERR_READONLY      (-3)    /**< 只读参数 | Read-only parameter */
+#define PARAM_ERR_BUSY          (-4)    /**< 暂存队列已满 | Staging queue full */
+
+#define PARAM_NAME_LEN          16      /**< 名称最大长度 | Max name length */
+#define PARAM_PENDING_SIZE      8       /**< 暂存队列长度（2 的幂） | Staging queue length (power of 2) */
+
+/**
+  * @brief   参数值（浮点类型用 f，整数类型用 i） | Parameter value (f for float types, i for integer types)
+  */
+typedef union {
+    fp32 f;
+    int32_t i;
+} ParamValue;
+
+typedef struct ParamDef ParamDef;
+
+/**
+  * @struct  ParamDef
+  * @brief   参数描述 | Parameter descriptor
+  */
+struct ParamDef {
+    const char *name;           /**< 名称 | Name */
+    uint8_t type;               /**< 类型 ParamType | Type */
+    uint8_t flags;              /**< 标志 | Flags */
+    uint16_t storeKey;          /**< Flash 存储键（PARAM_FLAG_PERSIST 时有效） | Store key (with PARAM_FLAG_PERSIST) */
+    fp32 min;                   /**< 最小值 | Minimum */
+    fp32 max;                   /**< 最大值 | Maximum */
+    void *ptr;                  /**< 变量地址 | Variable address */
+    void (*OnApply)(const ParamDef *def);
+    /**< 生效后回调（可为 NULL） | Called after the value is applied (may be NULL) */
+};
+
+/**
+  * @brief   参数表，由应用定义：固件在 param_table.c，主机仿真器各自提供 | Parameter table, defined by the application: param_table.c in the firmware, its own in each host simulator
+  * @note    注册表代码本身不依赖硬件，主机上可以原样编译 | The registry code itself is hardware-free and compiles unchanged on the host
+  */
+extern const ParamDef paramTable[];
+extern const uint8_t paramTableSize;
+
+/**
+  * @brief   参数数量 | Number of parameters
+  */
+uint8_t Param_Count(void);
+
+/**
+  * @brief   获取参数描述 | Get parameter descriptor
+  * @param   id  参数编号 | Parameter id
+  * @return  描述指针，无效编号返回 NULL | Descriptor, NULL for an invalid id
+  */
+const ParamDef *Param_Def(uint8_t id);
+
+/**
+  * @brief   按名称查找参数 | Find parameter by name
+  * @param   name  名称 | Name
+  * @return  参数编号，未找到返回 -1 | Parameter id, -1 if not found
+  */
+int Param_Find(const char *name);
+
+/**
+  * @brief   读取当前值 | Read current value
+  * @param   id  参数编号 | Parameter id
+  * @return  当前值 | Current value
+  */
+ParamValue Param_Read(uint8_t id);
+
+/**
+  * @brief   暂存一次写入（检查范围，不立即生效） | Stage a write (range-checked, not applied yet)
+  * @param   id     参数编号 | Parameter id
+  * @param   value  新值 | New value
+  * @return  PARAM_OK 或错误码 | PARAM_OK or error code
+  */
+int Param_Stage(uint8_t id, ParamValue value);
+
+/**
+  * @brief   请求在下一个循环边界保存所有持久参数 | Request saving persistent parameters at the next loop boundary
+  */
+void Param_RequestSave(void);
+
+/**
+  * @brief   在控制循环边界应用暂存写入和保存请求 | Apply staged writes and save requests at a loop boundary
+  * @note    保存需要先擦除扇区时（PARAM_STORE_ERR_BUSY）推迟，直到主循环在刹车时调用 ParamStore_Maintain
+  *          A save that needs a sector erased first (PARAM_STORE_ERR_BUSY) is deferred until the
+  *          main loop runs ParamStore_Maintain while braked
+  */
+void Param_ApplyPending(void);
+
+/**
+  * @brief   从 Flash 载入持久参数 | Load persistent parameters from flash
+  */
+void Param_Load(void);
+
+/**
+  * @brief   处理参数协议帧 | Handle a parameter protocol frame
+  * @param   req    请求帧 | Request frame
+  * @param   reply  应答负载缓冲区（≥ PROTOCOL_MAX_PAYLOAD） | Reply payload buffer (≥ PROTOCOL_MAX_PAYLOAD)
+  * @param   len    应答负载长度 | Reply payload length
+  * @return  应答消息类型，非参数消息返回 0 | Reply message type, 0 if not a parameter message
+  */
+uint8_t Param_HandleFrame(const Frame *req, uint8_t *reply, uint8_t *len);
+
+#endif /* PARAM_H_ */
@@ -0,0 +1,181 @@
+#ifndef PARAM_STORE_H_
+#define PARAM_STORE_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    param_store.h
+  * @brief   Flash 日志结构参数存储接口 | Log-structured parameter store in flash
+  *
+  * @note    两个扇区轮流使用（磨损均衡），每条记录带 CRC，单条记录写入为原子操作
+  *          Two sectors are used in turn (wear leveling); every record carries a CRC
+  *          and a single-record update is atomic
+  */
+
+/* 存储布局配置 | Storage layout configuration */
+#define PARAM_STORE_RECORD_SIZE     16      /**< 记录长度（字节） | Record size in bytes */
+#define PARAM_STORE_VALUE_SIZE      8       /**< 单条记录最大数据长度 | Max payload per record */
+#define PARAM_STORE_HEADER_SLOTS    2       /**< 扇区头占用的记录槽数 | Record slots used by the sector header */
+#define PARAM_STORE_LOG_RECORDS     1024    /**< 每个扇区的日志窗口（限制上电扫描时间） | Log window per sector (bounds boot scan) */
+#define PARAM_STORE_MAX_KEYS        32      /**< RAM 索引最大键数 | Max keys in the RAM index */
+
+/* 返回值 | Return codes */
+#define PARAM_STORE_OK              0       /**< 成功 | Success */
+#define PARAM_STORE_ERR_NOT_FOUND   (-1)    /**< 键不存在 | Key not found */
+#define PARAM_STORE_ERR_ARG         (-2)    /**< 参数错误 | Invalid argument */
+#define PARAM_STORE_ERR_FULL        (-3)    /**< 索引已满 | Index full */
+#define PARAM_STORE_ERR_FLASH       (-4)    /**< Flash 操作失败 | Flash operation failed */
+#define PARAM_STORE_ERR_BUSY        (-5)    /**< 需要搬移但另一扇区未擦除，先调用 ParamStore_Maintain | Compaction needed but the other sector is not erased; call ParamStore_Maintain first */
+
+/* 参数键值（0xFFFF 保留为擦除态） | Parameter keys (0xFFFF is reserved for the erased state) */
+#define PARAM_KEY_BALANCE_BIAS      0x0001  /**< 机械平衡偏置 (°) | Mechanical balance bias */
+/* 0x0002、0x0003 曾用于目标角自学习，已停用，旧记录可能仍在 Flash 中，不要复用
+   0x0002 and 0x0003 were the target-angle learner's; retired, old records may still be in flash, do not reuse */
+#define PARAM_KEY_LOOP_PERIOD       0x0004  /**< 控制周期 (us) | Control loop period */
+#define PARAM_KEY_TELEMETRY_PERIOD  0x0005  /**< 遥测周期 (ms) | Telemetry period */
+#define PARAM_KEY_SENSOR_LOG        0x0006  /**< 传感器日志开关 | Sensor log on/off */
+#define PARAM_KEY_MOTOR_KP          0x0010  /**< 电机速度环 Kp | Motor speed loop Kp */
+#define PARAM_KEY_MOTOR_KI          0x0011  /**< 电机速度环 Ki | Motor speed loop Ki */
+#define PARAM_KEY_MOTOR_KD          0x0012  /**< 电机速度环 Kd | Motor speed loop Kd */
+#define PARAM_KEY_GYRO_BIAS         0x0020  /**< 陀螺仪零偏 X/Y/Z（+0/+1/+2） | Gyro bias X/Y/Z (+0/+1/+2) */
+#define PARAM_KEY_ACCEL_BIAS        0x0023  /**< 加速度计零偏 X/Y/Z（+0/+1/+2） | Accel bias X/Y/Z (+0/+1/+2) */
+#define PARAM_KEY_ANGLE_KP          0x0030  /**< 直立环 Kp | Upright Kp */
+#define PARAM_KEY_ANGLE_KD          0x0031  /**< 直立环 Kd | Upright Kd */
+#define PARAM_KEY_VELOCITY_KP       0x0032  /**< 速度环 Kp | Velocity loop Kp */
+#define PARAM_KEY_VELOCITY_KI       0x0033  /**< 速度环 Ki | Velocity loop Ki */
+#define PARAM_KEY_TURN_KP           0x0034  /**< 转向环 Kp | Turn loop Kp */
+#define PARAM_KEY_TURN_KI           0x0035  /**< 转向环 Ki | Turn loop Ki */
+#define PARAM_KEY_TURN_KD           0x0036  /**< 转向环 Kd | Turn loop Kd */
+
+typedef struct FlashDev FlashDev;
+
+/**
+  * @struct  FlashDev
+  * @brief   Flash 后端接口 | Flash backend interface
+  *
+  * @note    扇区号为存储内部的逻辑编号 0/1；写入按字进行，且只能把 1 改为 0（NOR 语义）
+  *          Sector numbers are the store's logical sectors 0/1; programming is word-wise
+  *          and can only clear bits (NOR semantics)
+  */
+struct FlashDev {
+    void *ctx;                  /**< 后端私有数据 | Backend private data */
+    uint32_t sectorSize;        /**< 扇区大小（字节） | Sector size in bytes */
+
+    int (*Read)(FlashDev *self, uint8_t sector, uint32_t offset, void *buf, uint32_t len);
+    /**< 读取数据 | Read data */
+    int (*Program)(FlashDev *self, uint8_t sector, uint32_t offset, const uint32_t *words, uint32_t count);
+    /**< 按字写入 | Program words */
+    int (*Erase)(FlashDev *self, uint8_t sector);
+    /**< 擦除扇区 | Erase sector */
+};
+
+/**
+  * @struct  ParamIndexEntry
+  * @brief   RAM 索引项 | RAM index entry
+  */
+typedef struct {
+    uint16_t key;                           /**< 键 | Key */
+    uint16_t slot;                          /**< 记录所在槽位 | Record slot */
+    uint8_t len;                            /**< 数据长度 | Payload length */
+    uint8_t value[PARAM_STORE_VALUE_SIZE];  /**< 数据副本 | Cached payload */
+} ParamIndexEntry;
+
+/**
+  * @struct  ParamStore
+  * @brief   参数存储对象 | Parameter store object
+  */
+typedef struct {
+    FlashDev dev;                                   /**< Flash 后端 | Flash backend */
+    uint8_t active;                                 /**< 当前活动扇区 | Active sector */
+    uint8_t pendingErase;                           /**< 待擦除扇区位图 | Bitmap of sectors awaiting erase */
+    uint16_t head;                                  /**< 下一个空闲槽位 | Next free slot */
+    uint16_t logRecords;                            /**< 日志窗口长度 | Log window length */
+    uint32_t generation;                            /**< 活动扇区代数 | Active sector generation */
+    uint8_t keyCount;                               /**< 索引中的键数 | Keys in index */
+    ParamIndexEntry index[PARAM_STORE_MAX_KEYS];    /**< RAM 索引 | RAM index */
+} ParamStore;
+
+/**
+  * @brief   初始化参数存储，扫描活动扇区建立索引 | Init the store and build the index from the active sector
+  * @param   self  参数存储指针 | Pointer to store
+  * @param   dev   Flash 后端 | Flash backend
+  * @return  PARAM_STORE_OK 或错误码 | PARAM_STORE_OK or error code
+  *
+  * @note    仅读取记录首字并二分查找写指针，只对每个键的最新记录做 CRC 校验
+  *          Only the first word of each record is read and the write head is found by
+  *          binary search; CRC is checked for the newest record of each key only
+  */
+int ParamStore_Init(ParamStore *self, FlashDev dev);
+
+/**
+  * @brief   读取参数 | Read a parameter
+  * @param   self  参数存储指针 | Pointer to store
+  * @param   key   键 | Key
+  * @param   buf   输出缓冲区 | Output buffer
+  * @param   len   期望长度 | Expected length
+  * @return  PARAM_STORE_OK 或 PARAM_STORE_ERR_NOT_FOUND | PARAM_STORE_OK or PARAM_STORE_ERR_NOT_FOUND
+  */
+int ParamStore_Get(ParamStore *self, uint16_t key, void *buf, uint8_t len);
+
+/**
+  * @brief   写入参数（追加一条记录，值未变化时不写 Flash） | Write a parameter (appends a record; skipped if unchanged)
+  * @param   self  参数存储指针 | Pointer to store
+  * @param   key   键 | Key
+  * @param   data  数据指针 | Pointer to data
+  * @param   len   数据长度（≤ PARAM_STORE_VALUE_SIZE） | Data length (≤ PARAM_STORE_VALUE_SIZE)
+  * @return  PARAM_STORE_OK 或错误码 | PARAM_STORE_OK or error code
+  *
+  * @note    日志窗口写满时搬移到另一扇区，只写不擦（约 2 ms）；该扇区尚未擦除时返回
+  *          PARAM_STORE_ERR_BUSY 且不写入，擦除留给 ParamStore_Maintain
+  *          When the log window is full, live records move to the other sector, programming
+  *          only (about 2 ms); if that sector has not been erased yet, nothing is written and
+  *          PARAM_STORE_ERR_BUSY is returned, leaving the erase to ParamStore_Maintain
+  */
+int ParamStore_Set(ParamStore *self, uint16_t key, const void *data, uint8_t len);
+
+/**
+  * @brief   读取浮点参数 | Read a float parameter
+  * @param   self  参数存储指针 | Pointer to store
+  * @param   key   键 | Key
+  * @param   def   不存在时的默认值 | Default when missing
+  * @return  参数值 | Parameter value
+  */
+fp32 ParamStore_GetFloat(ParamStore *self, uint16_t key, fp32 def);
+
+/**
+  * @brief   写入浮点参数 | Write a float parameter
+  * @param   self   参数存储指针 | Pointer to store
+  * @param   key    键 | Key
+  * @param   value  参数值 | Value
+  * @return  PARAM_STORE_OK 或错误码 | PARAM_STORE_OK or error code
+  */
+int ParamStore_SetFloat(ParamStore *self, uint16_t key, fp32 value);
+
+/**
+  * @brief   是否有扇区等待擦除 | Whether a sector is waiting to be erased
+  * @param   self  参数存储指针 | Pointer to store
+  * @return  TRUE 表示应在合适时机调用 ParamStore_Maintain | TRUE if ParamStore_Maintain should run when convenient
+  */
+bool_t ParamStore_ErasePending(const ParamStore *self);
+
+/**
+  * @brief   后台维护：擦除已废弃扇区 | Background maintenance: erase obsolete sectors
+  * @param   self  参数存储指针 | Pointer to store
+  * @return  PARAM_STORE_OK 或错误码 | PARAM_STORE_OK or error code
+  *
+  * @note    F446 单 bank，擦除 128 KB 扇区约 1~2 s，期间 CPU 取指停顿；只能在电机刹车时从主循环调用
+  *          The F446 has a single bank: erasing a 128 KB sector takes about 1-2 s with
+  *          instruction fetch stalled. Call only from the main loop with the motors braked
+  */
+int ParamStore_Maintain(ParamStore *self);
+
+/**
+  * @brief   创建基于 RAM 的 Flash 后端（用于主机测试） | Create a RAM-backed flash backend (for host tests)
+  * @param   mem         至少 2 * sectorSize 字节的缓冲区 | Buffer of at least 2 * sectorSize bytes
+  * @param   sectorSize  扇区大小 | Sector size
+  * @return  Flash 后端对象 | Flash backend object
+  */
+FlashDev newRamFlashDev(uint8_t *mem, uint32_t sectorSize);
+
+#endif /* PARAM_STORE_H_ */
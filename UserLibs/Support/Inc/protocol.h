@@ -0,0 +1,103 @@
+#ifndef PROTOCOL_H_
+#define PROTOCOL_H_
+
+#include <stdint.h>
+
+/**
+  * @file    protocol.h
+  * @brief   串口二进制帧协议 | Binary UART frame protocol
+  *
+  * @note    帧格式：COBS( type | seq | payload | crc16_le ) 0x00
+  *          0x00 作为帧分隔符，任意位置丢字节后都能在下一个分隔符处重新同步
+  *          Frame: COBS( type | seq | payload | crc16_le ) 0x00
+  *          0x00 delimits frames, so the parser resyncs at the next delimiter after any byte loss
+  */
+
+/* 帧长度 | Frame sizes */
+#define PROTOCOL_MAX_PAYLOAD    64                              /**< 最大负载长度 | Max payload length */
+#define PROTOCOL_MAX_RAW        (PROTOCOL_MAX_PAYLOAD + 4)      /**< 编码前长度（type+seq+crc） | Raw length before COBS (type+seq+crc) */
+#define PROTOCOL_MAX_FRAME      (PROTOCOL_MAX_RAW + PROTOCOL_MAX_RAW / 254 + 2)
+                                                                /**< 编码后最大长度（含分隔符） | Max encoded length incl. delimiter */
+
+/* 消息类型（运动命令直接使用 command.h 中的 CMD_* 值，应答为同类型空负载帧）
+   Message types (motion commands reuse CMD_* from command.h and are acked with an empty frame of the same type) */
+#define MSG_PARAM_INFO          0x10    /**< 查询参数描述 [id] → [id type flags min max value name] | Query descriptor */
+#define MSG_PARAM_GET           0x11    /**< 读参数 [id] → [id value] | Read parameter */
+#define MSG_PARAM_SET           0x12    /**< 写参数 [id value] → [id status value] | Write parameter */
+#define MSG_PARAM_SAVE          0x13    /**< 保存到 Flash [] → [status] | Persist to flash */
+#define MSG_LINK_STATS          0x14    /**< 链路统计 [] → [UartRxStats] | Link statistics */
+#define MSG_TELEMETRY           0x20    /**< 遥测记录 TelemetryRecord（下位机 → 上位机） | Telemetry record (robot → host) */
+#define MSG_SENSOR_LOG          0x21    /**< 传感器日志 SensorLogRecord（下位机 → 上位机） | Sensor log record (robot → host) */
+#define MSG_PATH_CLEAR          0x30    /**< 清空路径 [] → [status] | Clear the path */
+#define MSG_PATH_APPEND         0x31    /**< 写入航点 [index n×(x y)] → [status count] | Write waypoints */
+#define MSG_PATH_INFO           0x32    /**< 跟踪状态 [] → [count active finished segment xte remaining] | Follower state */
+#define MSG_NACK                0x7F    /**< 否定应答 [type err] | Negative acknowledge */
+
+/**
+  * @struct  Frame
+  * @brief   解码后的帧 | Decoded frame
+  */
+typedef struct {
+    uint8_t type;               /**< 消息类型 | Message type */
+    uint8_t seq;                /**< 序号，应答时原样返回 | Sequence number, echoed in replies */
+    uint8_t len;                /**< 负载长度 | Payload length */
+    const uint8_t *payload;     /**< 负载指针（指向解析器缓冲区） | Payload (points into parser buffer) */
+} Frame;
+
+/**
+  * @struct  FrameParser
+  * @brief   增量帧解析器 | Incremental frame parser
+  */
+typedef struct {
+    uint8_t buf[PROTOCOL_MAX_FRAME];    /**< 接收缓冲区 | Receive buffer */
+    uint8_t len;                        /**< 已接收长度 | Bytes received */
+    uint8_t overflow;                   /**< 当前帧溢出标志 | Current frame overflowed */
+    uint32_t frames;                    /**< 有效帧计数 | Valid frames */
+    uint32_t crcErrors;                 /**< CRC/COBS 错误计数 | CRC or COBS errors */
+    uint32_t overflows;                 /**< 超长帧计数 | Oversized frames */
+} FrameParser;
+
+/**
+  * @brief   初始化解析器 | Init parser
+  * @param   self  解析器指针 | Pointer to parser
+  */
+void FrameParser_Init(FrameParser *self);
+
+/**
+  * @brief   输入一个字节 | Feed one byte
+  * @param   self   解析器指针 | Pointer to parser
+  * @param   byte   输入字节 | Input byte
+  * @param   frame  输出帧（返回 1 时有效，直到下一次调用） | Output frame (valid until the next call when 1 is returned)
+  * @return  1 = 收到完整有效帧，0 = 未完成 | 1 = complete valid frame, 0 = not yet
+  */
+uint8_t FrameParser_Feed(FrameParser *self, uint8_t byte, Frame *frame);
+
+/**
+  * @brief   编码一帧 | Encode a frame
+  * @param   type     消息类型 | Message type
+  * @param   seq      序号 | Sequence number
+  * @param   payload  负载 | Payload
+  * @param   len      负载长度 | Payload length
+  * @param   out      输出缓冲区（≥ PROTOCOL_MAX_FRAME） | Output buffer (≥ PROTOCOL_MAX_FRAME)
+  * @return  编码后长度（含分隔符），负载过长返回 0 | Encoded length incl. delimiter, 0 if payload too long
+  */
+uint16_t Frame_Encode(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len, uint8_t *out);
+
+/**
+  * @brief   COBS 编码 | COBS encode
+  * @param   in   输入数据 | Input
+  * @param   len  输入长度 | Input length
+  * @param   out  输出缓冲区（≥ len + len / 254 + 1） | Output (≥ len + len / 254 + 1)
+  * @return  编码后长度（不含分隔符） | Encoded length (without delimiter)
+  */
+uint16_t COBS_Encode(const uint8_t *in, uint16_t len, uint8_t *out);
+
+/**
+  * @brief   COBS 原地解码 | COBS decode in place
+  * @param   buf  编码数据（不含分隔符） | Encoded data (without delimiter)
+  * @param   len  编码长度 | Encoded length
+  * @return  解码后长度，格式错误返回 -1 | Decoded length, -1 if malformed
+  */
+int16_t COBS_Decode(uint8_t *buf, uint16_t len);
+
+#endif /* PROTOCOL_H_ */
@@ -0,0 +1,75 @@
+#ifndef SENSOR_LOG_H_
+#define SENSOR_LOG_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    sensor_log.h
+  * @brief   传感器日志：控制栈每个周期的原始输入 | Sensor log: the control stack's raw inputs, every period
+  *
+  * @note    每个控制周期一条记录，内容是 CarMove 读到的原始数据：DMP 数据包（Q30 四元数与原始
+  *          加速度、角速度）、TIM2/TIM3 计数器值、超声波读数，以及上个周期以来执行的运动命令。
+  *          主机上的重放工具把这些数据原样送回 Imu/Encoder/CarMove，不经过任何换算，所以同一份
+  *          日志在同一份代码上的输出逐位相同。记录经 MSG_SENSOR_LOG 帧发送，抓包即日志。
+  *          每条约 59 字节（含帧开销），100 Hz 时约占 115200 链路的一半，记录期间应把 telem_ms
+  *          调到 50 以上；发不出去的记录在帧序号上留下间隙，重放时会报告。
+  *          One record per control period holding the raw data CarMove read: the DMP packet (Q30
+  *          quaternion plus raw acceleration and rate), the TIM2/TIM3 counter values, the
+  *          ultrasonic reading and the motion commands run since the previous period. The host
+  *          replay tool feeds them back into Imu/Encoder/CarMove untouched, with no unit
+  *          conversion, so one log on one build gives bit-identical outputs. Records travel as
+  *          MSG_SENSOR_LOG frames, so a capture is the log.
+  *          A record is about 59 bytes with framing, half of the 115200 link at 100 Hz, so set
+  *          telem_ms to 50 or more while logging; records that cannot be sent leave a gap in the
+  *          frame sequence, which replay reports.
+  */
+
+#define SENSOR_LOG_CMDS         4       /**< 每条记录最多的命令数 | Most commands per record */
+#define SENSOR_LOG_QUEUE_SIZE   8       /**< 记录队列长度（2 的幂） | Record queue length (power of 2) */
+
+/* 记录标志 | Record flags */
+#define SENSOR_LOG_IMU          0x01    /**< 本周期读到了新的 DMP 数据包 | A fresh DMP packet was read this period */
+#define SENSOR_LOG_RANGE_VALID  0x02    /**< 超声波读数有效 | Ultrasonic reading valid */
+#define SENSOR_LOG_CMD_LOST     0x04    /**< 命令超过 SENSOR_LOG_CMDS 条，其余未记录 | More than SENSOR_LOG_CMDS commands, the rest not recorded */
+
+/**
+  * @struct  SensorLogRecord
+  * @brief   一个控制周期的原始输入（小端，无填充） | Raw inputs of one control period (little-endian, no padding)
+  * @note    只允许在末尾追加字段 | Only append fields
+  */
+typedef struct __attribute__((packed)) {
+    uint32_t tick_ms;                   /**< CarMove 开始时的 HAL 节拍 | HAL tick when CarMove started */
+    uint16_t loop_us;                   /**< 控制周期 (µs) | Control period */
+    uint16_t enc[2];                    /**< TIM2/TIM3 计数器读数（左/右） | TIM2/TIM3 counter reads (left/right) */
+    int32_t quat[4];                    /**< DMP 四元数 (Q30) | DMP quaternion */
+    int16_t accel[3];                   /**< 加速度原始值 | Raw acceleration */
+    int16_t gyro[3];                    /**< 角速度原始值 | Raw angular rate */
+    fp32 range;                         /**< 超声波距离 (cm) | Ultrasonic distance */
+    uint32_t range_age_ms;              /**< 超声波读数的时长 | Age of the ultrasonic reading */
+    uint8_t flags;                      /**< SENSOR_LOG_* 标志 | SENSOR_LOG_* flags */
+    uint8_t ncmd;                       /**< 命令数 | Command count */
+    uint8_t cmd[SENSOR_LOG_CMDS];       /**< 按执行顺序的命令 | Commands in the order they ran */
+} SensorLogRecord;
+
+/**
+  * @brief   记录一条刚执行的运动命令，计入下一条记录 | Note a motion command just run, for the next record
+  * @param   cmd  命令 CMD_* | Command CMD_*
+  * @note    仅固件实现 | Firmware only
+  */
+void SensorLog_Command(uint8_t cmd);
+
+/**
+  * @brief   在 CarMove 之后采样本周期的原始输入 | Sample this period's raw inputs after CarMove
+  * @note    只拷贝字段入队；关闭时只清空命令；仅固件实现
+  *          Only copies fields into a queue; when off it just clears the commands; firmware only
+  */
+void SensorLog_Capture(void);
+
+/**
+  * @brief   将已采样的记录编码并交给 DMA 发送 | Encode queued records and hand them to DMA
+  * @note    在主循环中调用；仅固件实现 | Call from the main loop; firmware only
+  */
+void SensorLog_Flush(void);
+
+#endif /* SENSOR_LOG_H_ */
@@ -0,0 +1,57 @@
+#ifndef SEQLOCK_H_
+#define SEQLOCK_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    seqlock.h
+  * @brief   单写者序号锁（仅头文件） | Single-writer sequence lock (header-only)
+  *
+  * @note    写者从不等待：写前后各把序号加一，写入期间序号为奇数。读者复制数据，序号为奇数或前后不同
+  *          就重读。读者因此必须不能打断写者：在写者的中断里读，或在优先级高于写者的中断里读，
+  *          会看到永远不变的奇数序号而死循环。可用的读者是与写者同一上下文、或被写者打断的低优先级上下文。
+  *          The writer never waits: it bumps the sequence before and after writing, so the
+  *          sequence is odd while a write is in progress. A reader copies the data and retries if
+  *          the sequence was odd or changed. A reader must therefore never preempt the writer: one
+  *          in an interrupt above the writer's priority would see an odd sequence that never
+  *          changes and spin forever. Valid readers run in the writer's context or in a
+  *          lower-priority one that the writer can preempt.
+  */
+
+/**
+  * @brief   开始写：序号变为奇数 | Begin a write: the sequence turns odd
+  * @param   seq  序号 | Sequence
+  */
+static inline void SeqLock_WriteBegin(volatile uint32_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+  * @brief   结束写：序号变回偶数并发布数据 | End a write: the sequence turns even and publishes the data
+  * @param   seq  序号 | Sequence
+  */
+static inline void SeqLock_WriteEnd(volatile uint32_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+  * @brief   读取一致的快照 | Read a consistent snapshot
+  * @param   seq   序号 | Sequence
+  * @param   dst   输出 | Output
+  * @param   src   被保护的数据 | Protected data
+  * @param   size  字节数 | Byte count
+  */
+static inline void SeqLock_Read(const volatile uint32_t *seq, void *dst, const void *src, size_t size) {
+    uint32_t begin, end;
+    do {
+        begin = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        memcpy(dst, src, size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        end = __atomic_load_n(seq, __ATOMIC_RELAXED);
+    } while ((begin & 1U) || begin != end);
+}
+
+#endif /* SEQLOCK_H_ */
@@ -0,0 +1,256 @@
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    spsc_ring.h
+  * @brief   无锁单生产者/单消费者环形队列（仅头文件） | Lock-free single-producer/single-consumer ring (header-only)
+  *
+  * @note    用于中断与主循环之间传递数据：生产者只写 head，消费者只写 tail，
+  *          索引为自由递增的 32 位计数，不需要 LDREX/STREX。
+  *          发布顺序：生产者先写数据再以 release 语义写 head；消费者以 acquire 语义读 head 后再读数据。
+  *          在 Cortex-M4 上 release/acquire 编译为 DMB + 普通 STR/LDR；在主机上同样适用于多线程。
+  *          Hands data from interrupts to the main loop: the producer only writes head, the
+  *          consumer only writes tail, and indices are free-running 32-bit counters, so no
+  *          LDREX/STREX is needed. The producer writes the slot, then publishes head with
+  *          release semantics; the consumer reads head with acquire semantics before reading
+  *          the slot. On Cortex-M4 this compiles to DMB plus plain STR/LDR; on the host the
+  *          same code is correct across threads.
+  *
+  *          每个环只能有一个生产者和一个消费者；多个中断写同一个环需要各自独立的环。
+  *          Exactly one producer and one consumer per ring; several ISRs need separate rings.
+  */
+
+/* 缓存行大小：M4 没有数据缓存，按 32 字节对齐仅为将来的 M7 准备；主机按 64 字节避免伪共享
+   Cache line: the M4 has no data cache, 32 bytes only anticipates an M7; 64 bytes on the host avoids false sharing */
+#ifndef SPSC_RING_CACHE_LINE
+#if defined(__arm__)
+#define SPSC_RING_CACHE_LINE    32
+#else
+#define SPSC_RING_CACHE_LINE    64
+#endif
+#endif
+
+#define SPSC_RING_LOAD_ACQUIRE(p)       __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SPSC_RING_STORE_RELEASE(p, v)   __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define SPSC_RING_LOAD_RELAXED(p)       __atomic_load_n((p), __ATOMIC_RELAXED)
+
+/**
+  * @struct  SpscRing
+  * @brief   环形队列对象 | Ring object
+  *
+  * @note    生产者和消费者的字段分别位于不同缓存行 | Producer and consumer fields live on separate cache lines
+  */
+typedef struct {
+    /* 生产者 | Producer side */
+    uint32_t head __attribute__((aligned(SPSC_RING_CACHE_LINE)));  /**< 写入计数 | Elements written */
+    uint32_t cachedTail;                                           /**< tail 的本地副本 | Producer's copy of tail */
+
+    /* 消费者 | Consumer side */
+    uint32_t tail __attribute__((aligned(SPSC_RING_CACHE_LINE)));  /**< 读取计数 | Elements read */
+    uint32_t cachedHead;                                           /**< head 的本地副本 | Consumer's copy of head */
+
+    /* 只读配置 | Read-only configuration */
+    uint8_t *buf __attribute__((aligned(SPSC_RING_CACHE_LINE)));   /**< 存储区 | Storage */
+    uint32_t elemSize;                                             /**< 元素大小 | Element size */
+    uint32_t mask;                                                 /**< 容量 - 1 | Capacity - 1 */
+} SpscRing;
+
+/**
+  * @brief   定义静态存储并初始化的环 | Define a ring with static storage
+  * @param   name      环变量名 | Ring variable name
+  * @param   type      元素类型 | Element type
+  * @param   capacity  容量（2 的幂） | Capacity (power of 2)
+  */
+#define SPSC_RING_DEFINE(name, type, capacity)                                          \
+    static type name##_storage[(capacity)];                                             \
+    static SpscRing name = {.buf = (uint8_t *)name##_storage,                           \
+                            .elemSize = sizeof(type),                                   \
+                            .mask = (capacity) - 1}
+
+/**
+  * @brief   初始化环 | Init ring
+  * @param   self      环指针 | Pointer to ring
+  * @param   buf       存储区（capacity * elemSize 字节） | Storage (capacity * elemSize bytes)
+  * @param   elemSize  元素大小 | Element size
+  * @param   capacity  容量，必须为 2 的幂 | Capacity, must be a power of 2
+  * @return  0 成功，-1 容量不是 2 的幂 | 0 on success, -1 if capacity is not a power of 2
+  */
+static inline int SpscRing_Init(SpscRing *self, void *buf, uint32_t elemSize, uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return -1;
+    }
+    memset(self, 0, sizeof(*self));
+    self->buf = (uint8_t *)buf;
+    self->elemSize = elemSize;
+    self->mask = capacity - 1;
+    return 0;
+}
+
+/**
+  * @brief   容量 | Capacity
+  */
+static inline uint32_t SpscRing_Capacity(const SpscRing *self) {
+    return self->mask + 1;
+}
+
+/**
+  * @brief   当前元素数（任一侧调用均可，结果可能已过时） | Current element count (either side; may be stale)
+  */
+static inline uint32_t SpscRing_Count(const SpscRing *self) {
+    return SPSC_RING_LOAD_ACQUIRE(&self->head) - SPSC_RING_LOAD_ACQUIRE(&self->tail);
+}
+
+/* ------------------------------ 生产者 | Producer ------------------------------ */
+
+/**
+  * @brief   可写入的元素数（生产者调用） | Free slots (producer only)
+  */
+static inline uint32_t SpscRing_Free(SpscRing *self) {
+    uint32_t head = SPSC_RING_LOAD_RELAXED(&self->head);
+    uint32_t cap = self->mask + 1;
+    if (head - self->cachedTail >= cap) {
+        self->cachedTail = SPSC_RING_LOAD_ACQUIRE(&self->tail);  // 只在看起来满时才读对方的索引 | Read the other side only when it looks full
+    }
+    return cap - (head - self->cachedTail);
+}
+
+/**
+  * @brief   写入一个元素 | Push one element
+  * @param   self  环指针 | Pointer to ring
+  * @param   elem  元素指针 | Pointer to element
+  * @return  TRUE 成功，FALSE 已满 | TRUE on success, FALSE if full
+  */
+static inline bool_t SpscRing_Push(SpscRing *self, const void *elem) {
+    if (SpscRing_Free(self) == 0) {
+        return FALSE;
+    }
+    uint32_t head = SPSC_RING_LOAD_RELAXED(&self->head);
+    memcpy(&self->buf[(head & self->mask) * self->elemSize], elem, self->elemSize);
+    SPSC_RING_STORE_RELEASE(&self->head, head + 1);  // 数据写完后再发布 | Publish only after the slot is written
+    return TRUE;
+}
+
+/**
+  * @brief   批量写入（不足时写入尽可能多的元素） | Write a batch (as many as fit)
+  * @param   self   环指针 | Pointer to ring
+  * @param   elems  元素数组 | Element array
+  * @param   count  元素数 | Element count
+  * @return  实际写入数 | Elements written
+  */
+static inline uint32_t SpscRing_Write(SpscRing *self, const void *elems, uint32_t count) {
+    uint32_t n = SpscRing_Free(self);
+    if (n > count) n = count;
+    if (n == 0) return 0;
+
+    uint32_t head = SPSC_RING_LOAD_RELAXED(&self->head);
+    uint32_t idx = head & self->mask;
+    uint32_t first = self->mask + 1 - idx;  // 到存储区末尾的元素数 | Elements up to the end of storage
+    if (first > n) first = n;
+
+    memcpy(&self->buf[idx * self->elemSize], elems, first * self->elemSize);
+    memcpy(self->buf, (const uint8_t *)elems + first * self->elemSize, (n - first) * self->elemSize);
+    SPSC_RING_STORE_RELEASE(&self->head, head + n);
+    return n;
+}
+
+/**
+  * @brief   零拷贝预留连续写入空间 | Reserve contiguous space for zero-copy writes
+  * @param   self   环指针 | Pointer to ring
+  * @param   count  输出：连续可写元素数 | Output: contiguous free elements
+  * @return  写入位置 | Write position
+  * @note    写完后调用 SpscRing_Commit | Call SpscRing_Commit once written
+  */
+static inline void *SpscRing_Reserve(SpscRing *self, uint32_t *count) {
+    uint32_t free = SpscRing_Free(self);
+    uint32_t idx = SPSC_RING_LOAD_RELAXED(&self->head) & self->mask;
+    uint32_t first = self->mask + 1 - idx;
+    *count = (free < first) ? free : first;
+    return &self->buf[idx * self->elemSize];
+}
+
+/**
+  * @brief   发布已预留空间中写入的元素 | Publish elements written into reserved space
+  */
+static inline void SpscRing_Commit(SpscRing *self, uint32_t count) {
+    SPSC_RING_STORE_RELEASE(&self->head, SPSC_RING_LOAD_RELAXED(&self->head) + count);
+}
+
+/* ------------------------------ 消费者 | Consumer ------------------------------ */
+
+/**
+  * @brief   可读取的元素数（消费者调用） | Available elements (consumer only)
+  */
+static inline uint32_t SpscRing_Available(SpscRing *self) {
+    uint32_t tail = SPSC_RING_LOAD_RELAXED(&self->tail);
+    if (self->cachedHead == tail) {
+        self->cachedHead = SPSC_RING_LOAD_ACQUIRE(&self->head);  // 只在看起来空时才读对方的索引 | Read the other side only when it looks empty
+    }
+    return self->cachedHead - tail;
+}
+
+/**
+  * @brief   读取一个元素 | Pop one element
+  * @param   self  环指针 | Pointer to ring
+  * @param   elem  输出元素 | Output element
+  * @return  TRUE 成功，FALSE 为空 | TRUE on success, FALSE if empty
+  */
+static inline bool_t SpscRing_Pop(SpscRing *self, void *elem) {
+    if (SpscRing_Available(self) == 0) {
+        return FALSE;
+    }
+    uint32_t tail = SPSC_RING_LOAD_RELAXED(&self->tail);
+    memcpy(elem, &self->buf[(tail & self->mask) * self->elemSize], self->elemSize);
+    SPSC_RING_STORE_RELEASE(&self->tail, tail + 1);  // 读完后再归还槽位 | Release the slot only after reading it
+    return TRUE;
+}
+
+/**
+  * @brief   批量读取 | Read a batch
+  * @param   self   环指针 | Pointer to ring
+  * @param   elems  输出数组 | Output array
+  * @param   count  最多读取数 | Max elements
+  * @return  实际读取数 | Elements read
+  */
+static inline uint32_t SpscRing_Read(SpscRing *self, void *elems, uint32_t count) {
+    uint32_t n = SpscRing_Available(self);
+    if (n > count) n = count;
+    if (n == 0) return 0;
+
+    uint32_t tail = SPSC_RING_LOAD_RELAXED(&self->tail);
+    uint32_t idx = tail & self->mask;
+    uint32_t first = self->mask + 1 - idx;
+    if (first > n) first = n;
+
+    memcpy(elems, &self->buf[idx * self->elemSize], first * self->elemSize);
+    memcpy((uint8_t *)elems + first * self->elemSize, self->buf, (n - first) * self->elemSize);
+    SPSC_RING_STORE_RELEASE(&self->tail, tail + n);
+    return n;
+}
+
+/**
+  * @brief   零拷贝查看连续可读元素 | Peek contiguous readable elements without copying
+  * @param   self   环指针 | Pointer to ring
+  * @param   count  输出：连续可读元素数 | Output: contiguous readable elements
+  * @return  读取位置 | Read position
+  * @note    处理完后调用 SpscRing_Release | Call SpscRing_Release when done
+  */
+static inline const void *SpscRing_Peek(SpscRing *self, uint32_t *count) {
+    uint32_t avail = SpscRing_Available(self);
+    uint32_t idx = SPSC_RING_LOAD_RELAXED(&self->tail) & self->mask;
+    uint32_t first = self->mask + 1 - idx;
+    *count = (avail < first) ? avail : first;
+    return &self->buf[idx * self->elemSize];
+}
+
+/**
+  * @brief   归还已处理的元素 | Release consumed elements
+  */
+static inline void SpscRing_Release(SpscRing *self, uint32_t count) {
+    SPSC_RING_STORE_RELEASE(&self->tail, SPSC_RING_LOAD_RELAXED(&self->tail) + count);
+}
+
+#endif /* SPSC_RING_H_ */
@@ -0,0 +1,70 @@
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+
+/**
+  * @file    telemetry.h
+  * @brief   二进制遥测记录 | Binary telemetry record
+  *
+  * @note    记录按固定布局直接拷贝进 MSG_TELEMETRY 帧，控制循环中没有任何格式化开销；
+  *          上位机解码器使用同一张字段表，布局只在此处定义一次
+  *          Records are copied as-is into MSG_TELEMETRY frames, so the control loop pays no
+  *          formatting cost; the host decoder uses the same field table, so the layout is
+  *          defined in exactly one place
+  */
+
+#define TELEMETRY_PERIOD_MS     10      /**< 默认发送周期 (ms)，0 = 关闭 | Default period, 0 = off */
+#define TELEMETRY_QUEUE_SIZE    8       /**< 采样队列长度（2 的幂） | Sample queue length (power of 2) */
+
+/**
+  * @brief   字段表：X(类型, 名称, 类型标记) | Field table: X(type, name, type tag)
+  * @note    只允许在末尾追加字段，保持旧记录可解码 | Only append fields so older captures stay decodable
+  */
+#define TELEMETRY_FIELDS(X)                                                             \
+    X(uint32_t, tick_ms,   "u32")   /* HAL 节拍 | HAL tick */                            \
+    X(fp32,     pitch,     "f32")   /* 俯仰角 (°) | Pitch */                              \
+    X(fp32,     roll,      "f32")   /* 横滚角 (°) | Roll */                               \
+    X(fp32,     yaw,       "f32")   /* 偏航角 (°) | Yaw */                                \
+    X(fp32,     gyrox,     "f32")   /* X 轴角速度 | Gyro rate X */                         \
+    X(fp32,     gyroy,     "f32")   /* Y 轴角速度 | Gyro rate Y */                         \
+    X(fp32,     gyroz,     "f32")   /* Z 轴角速度 | Gyro rate Z */                         \
+    X(fp32,     out_l,     "f32")   /* 左电机 PID 输出 | Left motor PID output */           \
+    X(fp32,     out_r,     "f32")   /* 右电机 PID 输出 | Right motor PID output */          \
+    X(fp32,     pose_x,    "f32")   /* 里程计 X (cm) | Odometry X */                       \
+    X(fp32,     pose_y,    "f32")   /* 里程计 Y (cm) | Odometry Y */                       \
+    X(fp32,     heading,   "f32")   /* 里程计航向 (°) | Odometry heading */                \
+    X(int16_t,  rpm_l,     "i16")   /* 左轮转速 | Left RPM */                              \
+    X(int16_t,  rpm_r,     "i16")   /* 右轮转速 | Right RPM */                             \
+    X(uint16_t, tx_drops,  "u16")   /* 发送队列丢弃计数 | TX queue drop count */            \
+    X(uint8_t,  cmd,       "u8")    /* 当前命令 | Current command */                       \
+    X(uint8_t,  motion,    "u8")    /* 运动状态 | Motion state */                          \
+    X(uint16_t, i2c_err,   "u16")   /* I2C 失败请求累计 | I2C failed requests so far */      \
+    X(uint16_t, i2c_recov, "u16")   /* I2C 总线恢复累计 | I2C bus recoveries so far */      \
+    X(uint16_t, dmp_load,  "u16")   /* DMP 固件上传耗时 (ms)，热启动为 0 | DMP upload time, 0 after a warm boot */
+
+/**
+  * @struct  TelemetryRecord
+  * @brief   遥测记录（小端，无填充） | Telemetry record (little-endian, no padding)
+  */
+typedef struct __attribute__((packed)) {
+#define TELEMETRY_MEMBER(type, name, tag) type name;
+    TELEMETRY_FIELDS(TELEMETRY_MEMBER)
+#undef TELEMETRY_MEMBER
+} TelemetryRecord;
+
+/**
+  * @brief   采样一条遥测记录（按周期抽取） | Sample one telemetry record (decimated by period)
+  * @note    只拷贝字段入队，可在控制中断中调用；仅固件实现
+  *          Only copies fields into a queue, safe from the control ISR; firmware only
+  */
+void Telemetry_Publish(void);
+
+/**
+  * @brief   将已采样的记录编码并交给 DMA 发送 | Encode queued records and hand them to DMA
+  * @note    在主循环中调用；仅固件实现 | Call from the main loop; firmware only
+  */
+void Telemetry_Flush(void);
+
+#endif /* TELEMETRY_H_ */
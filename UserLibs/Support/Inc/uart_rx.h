@@ -0,0 +1,87 @@
+#ifndef UART_RX_H_
+#define UART_RX_H_
+
+#include <stdint.h>
+#include "struct_typedef.h"
+#include "protocol.h"
+
+/**
+  * @file    uart_rx.h
+  * @brief   循环 DMA 串口接收与增量解析 | Circular-DMA UART receive with incremental parsing
+  *
+  * @note    DMA 以循环模式持续写入缓冲区，从不停止；DMA 的写位置即 head，软件只维护 tail，
+  *          每次 HT/TC/IDLE 事件直接在 DMA 缓冲区上解析 tail..head 之间的新字节（不拷贝、不清零）。
+  *          与硬件无关，主机端仿真器使用同一份代码。
+  *          DMA writes the buffer in circular mode and is never stopped; its write position is
+  *          head and software only tracks tail. On every HT/TC/IDLE event the new bytes between
+  *          tail and head are parsed straight out of the DMA buffer (no copy, no clearing).
+  *          Hardware-independent, so the host-side stand-in runs the same code.
+  */
+
+/**
+  * @struct  UartRxStats
+  * @brief   链路统计（MSG_LINK_STATS 按此布局返回） | Link statistics (MSG_LINK_STATS returns this layout)
+  */
+typedef struct {
+    uint32_t rxBytes;           /**< 已解析字节数 | Bytes parsed */
+    uint32_t frames;            /**< 有效帧数 | Valid frames */
+    uint32_t crcErrors;         /**< CRC/COBS 错误 | CRC or COBS errors */
+    uint32_t overflows;         /**< 超长帧 | Oversized frames */
+    uint32_t cmdDuplicates;     /**< 重发的命令（已忽略） | Retransmitted commands (ignored) */
+    uint32_t cmdGaps;           /**< 命令序号缺口（丢失的命令数） | Commands missing from the sequence */
+    uint32_t uartErrors;        /**< 串口错误（溢出/帧错误等） | UART errors (overrun, framing, ...) */
+} UartRxStats;
+
+typedef struct UartRx UartRx;
+
+/**
+  * @struct  UartRx
+  * @brief   接收通道对象 | Receive channel object
+  */
+struct UartRx {
+    const uint8_t *buf;         /**< DMA 缓冲区 | DMA buffer */
+    uint16_t size;              /**< 缓冲区长度 | Buffer length */
+    uint16_t tail;              /**< 下一个待解析位置 | Next position to parse */
+    bool_t hasCmdSeq;           /**< 已收到过命令 | A command has been seen */
+    uint8_t lastCmdSeq;         /**< 上一条命令序号 | Last command sequence number */
+    FrameParser parser;         /**< 帧解析器 | Frame parser */
+    UartRxStats stats;          /**< 统计 | Statistics */
+
+    void (*OnFrame)(UartRx *self, const Frame *frame);
+    /**< 收到有效帧的回调 | Called for every valid frame */
+};
+
+/**
+  * @brief   创建接收通道 | Create a receive channel
+  * @param   buf      DMA 缓冲区 | DMA buffer
+  * @param   size     缓冲区长度 | Buffer length
+  * @param   OnFrame  帧回调 | Frame callback
+  * @return  接收通道对象 | Receive channel object
+  */
+UartRx newUartRx(const uint8_t *buf, uint16_t size, void (*OnFrame)(UartRx *self, const Frame *frame));
+
+/**
+  * @brief   解析 DMA 新写入的字节 | Parse bytes newly written by DMA
+  * @param   self  接收通道指针 | Pointer to channel
+  * @param   head  DMA 当前写位置（0..size，size 视为 0） | Current DMA write position (0..size, size wraps to 0)
+  *
+  * @note    两次调用之间 DMA 写入不得超过一整圈；HT/TC 中断保证至少每半圈调用一次
+  *          DMA must not advance a full lap between calls; HT/TC interrupts guarantee a call every half lap
+  */
+void UartRx_Process(UartRx *self, uint16_t head);
+
+/**
+  * @brief   DMA 重新启动后复位读位置（统计保留） | Reset the read position after DMA restarts (stats kept)
+  * @param   self  接收通道指针 | Pointer to channel
+  */
+void UartRx_Restart(UartRx *self);
+
+/**
+  * @brief   检查命令序号，过滤重发 | Check a command's sequence number and filter retransmissions
+  * @param   self   接收通道指针 | Pointer to channel
+  * @param   frame  命令帧 | Command frame
+  * @return  TRUE 新命令，FALSE 重发（只需再次应答） | TRUE for a new command, FALSE for a retransmission (ack again only)
+  */
+bool_t UartRx_AcceptCommand(UartRx *self, const Frame *frame);
+
+#endif /* UART_RX_H_ */
@@ -1,12 +1,114 @@
 #include "communication.h"
 #include "car.h"
+#include "protocol.h"
+#include "link_dispatch.h"
+#include "spsc_ring.h"
+#include "uart_rx.h"
 
 extern Car car;  // 全局小车实例 | Global car instance
 
 uint8_t tx_buffer[BUF_SIZE];       // 通用发送缓冲区 | General TX buffer
-uint8_t rx_data_buffer2[BUF_SIZE]; // USART2 接收缓冲区 | USART2 RX buffer
 uint8_t rx_data_buffer6[BUF_SIZE]; // USART6 接收缓冲区 | USART6 RX buffer
 
+static uint8_t rx_dma_buffer2[RX_DMA_SIZE];      // USART2 循环 DMA 接收缓冲区 | USART2 circular DMA RX buffer
+static UartRx pc_rx;                             // 上位机接收通道 | PC link receive channel
+SPSC_RING_DEFINE(cmd_ring, uint8_t, CMD_QUEUE_SIZE);  // 中断 → 主循环的运动命令 | Motion commands, IRQ → main loop
+
+/* DMA 发送双缓冲 | DMA TX double buffer */
+static uint8_t tx_queue[2][TX_QUEUE_SIZE];       // 一块由 DMA 发送，另一块填充 | One drained by DMA, one filling
+static uint16_t tx_fill_len = 0;                 // 填充块已用长度 | Bytes in the filling buffer
+static uint8_t tx_fill = 0;                      // 填充块编号 | Index of the filling buffer
+static volatile uint8_t tx_busy = 0;             // DMA 发送中 | DMA transfer in flight
+static volatile uint32_t tx_dropped = 0;         // 丢弃计数 | Drop count
+
+/**
+  * @brief   LinkSend 适配 uart_SendFrame | LinkSend adapter for uart_SendFrame
+  */
+static int PC_Send(void *ctx, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len) {
+    (void)ctx;
+    return uart_SendFrame(type, seq, payload, len);
+}
+
+static const LinkDispatch pc_dispatch = {.path = &car.control.path, .cmds = &cmd_ring, .send = PC_Send};
+
+/**
+  * @brief   处理一帧上位机数据 | Handle one frame from the PC link
+  * @param   frame  解码后的帧 | Decoded frame
+  */
+static void PC_HandleFrame(UartRx *rx, const Frame *frame) {
+    Link_HandleFrame(&pc_dispatch, rx, frame);
+}
+
+/**
+  * @brief   取出一条运动命令 | Take one motion command
+  */
+bool_t uart_PollCommand(uint8_t *cmd) {
+    return SpscRing_Pop(&cmd_ring, cmd);
+}
+
+/**
+  * @brief   空闲时启动下一块 DMA 发送（需在关中断状态下调用） | Start the next DMA block if idle (call with IRQs off)
+  */
+static void uart_Kick(void) {
+    if (!tx_busy && tx_fill_len > 0) {
+        tx_busy = 1;
+        HAL_UART_Transmit_DMA(&huart_pc, tx_queue[tx_fill], tx_fill_len);
+        tx_fill ^= 1;       // 交换缓冲区 | Swap buffers
+        tx_fill_len = 0;
+    }
+}
+
+/**
+  * @brief   写入 DMA 发送队列 | Queue bytes for DMA transmission
+  */
+int uart_Write(const uint8_t *data, uint16_t len) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (tx_fill_len + len > TX_QUEUE_SIZE) {
+        tx_dropped++;       // 不拆帧，整块丢弃 | Never split a frame, drop it whole
+        __set_PRIMASK(primask);
+        return -1;
+    }
+    memcpy(&tx_queue[tx_fill][tx_fill_len], data, len);
+    tx_fill_len += len;
+    uart_Kick();
+
+    __set_PRIMASK(primask);
+    return 0;
+}
+
+/**
+  * @brief   编码并发送一帧 | Encode and queue one frame
+  */
+int uart_SendFrame(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len) {
+    uint8_t buf[PROTOCOL_MAX_FRAME];
+    uint16_t n = Frame_Encode(type, seq, payload, len, buf);
+    return (n > 0) ? uart_Write(buf, n) : -1;
+}
+
+/**
+  * @brief   发送队列丢弃计数 | TX queue drop count
+  */
+uint32_t uart_TxDropped(void) {
+    return tx_dropped;
+}
+
+/**
+  * @brief   UART 发送完成回调 | UART TX complete callback
+  * @param   huart  UART 句柄 | UART handle
+  * @note    DMA 完成一块后立即发送已填充的另一块 | Starts the other buffer as soon as one block completes
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart->Instance == USART2) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        tx_busy = 0;
+        uart_Kick();
+        __set_PRIMASK(primask);
+    }
+}
+
 /**
   * @brief   发送消息（非阻塞中断模式） | Send message (non-blocking IT mode)
   * @param   huart  指定的 UART 句柄 | UART handle
@@ -24,56 +126,70 @@ void uart_SendMsg(UART_HandleTypeDef *huart, uint8_t *msg) {
   * @param   ...    可变参数列表 | Variable arguments
   */
 void uart_printf(UART_HandleTypeDef *huart, const char *fmt, ...) {
-    static uint8_t tx_buf[256] = {0};  // 临时格式化缓冲区 | Temporary format buffer
-    static va_list ap;
-    static uint16_t len;
+    char tx_buf[128];  // 临时格式化缓冲区 | Temporary format buffer
+    va_list ap;
+    int len;
 
     va_start(ap, fmt);
-    len = vsprintf((char *)tx_buf, fmt, ap);  // 格式化字符串 | Format string
+    len = vsnprintf(tx_buf, sizeof(tx_buf), fmt, ap);  // 格式化字符串 | Format string
     va_end(ap);
+    if (len <= 0) return;
+    if (len >= (int)sizeof(tx_buf)) len = sizeof(tx_buf) - 1;  // 截断 | Truncated
 
-    HAL_UART_Transmit_IT(huart, tx_buf, len);  // 发送格式化数据 | Transmit formatted data
+    if (huart == &huart_pc) {
+        uart_Write((const uint8_t *)tx_buf, (uint16_t)len);  // 与遥测共用 DMA 队列 | Shares the DMA queue with telemetry
+    } else {
+        HAL_UART_Transmit(huart, (uint8_t *)tx_buf, (uint16_t)len, 10);
+    }
 }
 
 /**
-  * @brief   UART 空闲中断回调处理 | UART idle interrupt callback
-  * @param   huart  触发空闲中断的 UART 句柄 | UART handle triggering idle interrupt
-  * @note    通过 DMA 模式重新启动接收 | Restart DMA reception
+  * @brief   启动上位机串口接收 | Start PC link reception
+  * @note    循环 DMA + 空闲中断，启动后不再停止 | Circular DMA plus idle-line events, never stopped once started
   */
-void UART_IdleCallback(UART_HandleTypeDef *huart) {
-    if (huart->Instance == USART2) {
-        HAL_UART_DMAStop(huart);  // 停止 DMA 接收 | Stop DMA reception
+void uart_Init(void) {
+    pc_rx = newUartRx(rx_dma_buffer2, RX_DMA_SIZE, PC_HandleFrame);
+    HAL_UARTEx_ReceiveToIdle_DMA(&huart_pc, rx_dma_buffer2, RX_DMA_SIZE);
+}
 
-        uint16_t rx_len = huart->RxXferSize - huart->RxXferCount;  // 本次接收长度 | Received length this time
-        memset(rx_data_buffer2, 0, BUF_SIZE);  // 清空缓冲区 | Clear buffer
+/**
+  * @brief   链路统计 | Link statistics
+  */
+const UartRxStats *uart_RxStats(void) {
+    return &pc_rx.stats;
+}
 
-        HAL_UART_Receive_DMA(&huart_pc, rx_data_buffer2, BUF_SIZE);  // 重启 DMA 接收 | Restart DMA reception
+/**
+  * @brief   UART 接收事件回调（DMA 半满/满/空闲） | UART RX event callback (DMA half/full/idle)
+  * @param   huart  UART 句柄 | UART handle
+  * @param   Size   DMA 当前写位置 | Current DMA write position
+  * @note    直接在 DMA 缓冲区上解析新字节，DMA 继续运行 | Parses new bytes in place while DMA keeps running
+  */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+    if (huart->Instance == USART2) {
+        UartRx_Process(&pc_rx, Size);
+    }
+}
+
+/**
+  * @brief   UART 错误回调 | UART error callback
+  * @param   huart  UART 句柄 | UART handle
+  * @note    溢出/帧错误时 HAL 会中止 DMA 接收，这是唯一需要重新启动的情况
+  *          HAL aborts DMA reception on overrun/framing errors; this is the only restart path
+  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    if (huart->Instance == USART2 && huart->RxState == HAL_UART_STATE_READY) {
+        UartRx_Restart(&pc_rx);
+        HAL_UARTEx_ReceiveToIdle_DMA(&huart_pc, rx_dma_buffer2, RX_DMA_SIZE);
     }
-//    else if (huart->Instance == USART6) {
-//        HAL_UART_DMAStop(huart);  // 停止 DMA 接收 | Stop DMA reception
-//
-//        uint16_t rx_len = huart->RxXferSize - huart->RxXferCount;  // 本次接收长度 | Received length this time
-//
-//        if (!car.isObstacleDetected)  // 若无障碍，则更新命令 | If no obstacle, update command
-//            car.cmd = rx_data_buffer6[0];
-//
-//        memset(rx_data_buffer6, 0, BUF_SIZE);  // 清空缓冲区 | Clear buffer
-//
-//        HAL_UART_Receive_DMA(&huart_bt, rx_data_buffer6, BUF_SIZE);  // 重启 DMA 接收 | Restart DMA reception
-//    }
 }
 
 /**
   * @brief   USART2 中断服务程序 | USART2 IRQ handler
-  * @note    检测 UART 空闲标志并调用回调 | Check UART IDLE flag and invoke callback
+  * @note    空闲检测由 HAL 在 ReceiveToIdle 模式下处理 | Idle detection is handled by HAL in ReceiveToIdle mode
   */
 void USART2_IRQHandler(void) {
     HAL_UART_IRQHandler(&huart2);  // 调用 HAL 库处理 | Call HAL handler
-
-    if (__HAL_UART_GET_FLAG(&huart2, UART_FLAG_IDLE)) {  // 空闲中断 | Idle interrupt
-        __HAL_UART_CLEAR_IDLEFLAG(&huart2);             // 清除空闲标志 | Clear idle flag
-        UART_IdleCallback(&huart2);                     // 调用空闲回调 | Invoke idle callback
-    }
 }
 
 /**
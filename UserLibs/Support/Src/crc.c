@@ -0,0 +1,61 @@
+#include "crc.h"
+
+/* 半字节查表（16 项，兼顾速度与 Flash 占用） | Nibble lookup table (16 entries, balances speed and flash size) */
+static const uint32_t crc32_nibble_table[16] = {
+        0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+        0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+        0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+        0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu
+};
+
+/* CRC16-CCITT 半字节查表 | CRC16-CCITT nibble lookup table */
+static const uint16_t crc16_nibble_table[16] = {
+        0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+        0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu
+};
+
+/**
+  * @brief   计算 CRC16-CCITT | Compute CRC16-CCITT
+  * @param   crc   上一次的 CRC 值 | Running CRC
+  * @param   data  数据指针 | Pointer to data
+  * @param   len   数据长度 | Data length
+  * @return  更新后的 CRC | Updated CRC
+  */
+uint16_t CRC16_Update(uint16_t crc, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (len--) {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble_table[((crc >> 12) ^ (*p >> 4)) & 0x0F]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble_table[((crc >> 12) ^ (*p & 0x0F)) & 0x0F]);
+        p++;
+    }
+    return crc;
+}
+
+/**
+  * @brief   计算 CRC32 | Compute CRC32
+  * @param   crc   上一次的 CRC 值 | Running CRC
+  * @param   data  数据指针 | Pointer to data
+  * @param   len   数据长度 | Data length
+  * @return  更新后的 CRC | Updated CRC
+  */
+uint32_t CRC32_Update(uint32_t crc, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];  // 低半字节 | Low nibble
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];  // 高半字节 | High nibble
+    }
+    return crc;
+}
+
+/**
+  * @brief   一次性计算数据块的 CRC32 | Compute CRC32 of a block in one call
+  * @param   data  数据指针 | Pointer to data
+  * @param   len   数据长度 | Data length
+  * @return  最终 CRC32 值 | Final CRC32 value
+  */
+uint32_t CRC32_Calc(const void *data, uint32_t len) {
+    return CRC32_Update(CRC32_INIT, data, len) ^ 0xFFFFFFFFu;
+}
@@ -0,0 +1,164 @@
+#include "i2c_arbiter.h"
+#include <string.h>
+
+/**
+  * @brief   创建仲裁器 | Create an arbiter
+  */
+I2CArbiter newI2CArbiter(I2CBus bus, uint16_t segmentMax) {
+    I2CArbiter a;
+    memset(&a, 0, sizeof(a));
+    a.bus = bus;
+    a.segmentMax = segmentMax;
+    a.statsSince = bus.Now(&a.bus);
+    return a;
+}
+
+/**
+  * @brief   总线空闲时启动下一段（调用者持有锁） | Start the next segment if the bus is idle (caller holds the lock)
+  * @note    每段都从最高优先级的非空队列中选；被打断的长请求从已发送的位置继续。
+  *          状态在 Start 之前全部写好，Start 中立即报错回调 I2CArb_Complete 也是安全的。
+  *          Every segment comes from the highest-priority non-empty queue; an interrupted long
+  *          request resumes where it stopped. All state is written before Start, so Start may
+  *          report an immediate failure through I2CArb_Complete.
+  */
+static void dispatch(I2CArbiter *self) {
+    if (self->busy || self->faulted) return;
+
+    for (uint8_t c = 0; c < I2C_ARB_CLIENTS; c++) {
+        if (self->count[c] == 0) continue;
+
+        I2CRequest *req = self->queue[c][self->head[c]];
+        uint16_t offset = self->offset[c];
+        uint16_t n = (uint16_t)(req->len - offset);
+        if (req->split && self->segmentMax && n > self->segmentMax) {
+            n = self->segmentMax;
+        }
+
+        uint32_t now = self->bus.Now(&self->bus);
+        if (offset == 0 && now - req->queuedAt > self->stats[c].maxWaitTicks) {
+            self->stats[c].maxWaitTicks = now - req->queuedAt;
+        }
+        self->busy = TRUE;
+        self->active = c;
+        self->activeLen = n;
+        self->activeSince = now;
+        self->bus.Start(&self->bus, req->addr, req->reg, req->read, req->data + offset, n);
+        return;
+    }
+}
+
+/**
+  * @brief   提交请求 | Submit a request
+  */
+int I2CArb_Submit(I2CArbiter *self, uint8_t client, I2CRequest *req) {
+    if (req->len == 0) {
+        req->status = I2C_ARB_DONE;
+        return I2C_ARB_DONE;
+    }
+
+    uint32_t state = self->bus.Lock(&self->bus);
+    if (self->count[client] == I2C_ARB_QUEUE) {
+        self->bus.Unlock(&self->bus, state);
+        return I2C_ARB_ERR_FULL;
+    }
+    req->status = I2C_ARB_PENDING;
+    req->queuedAt = self->bus.Now(&self->bus);
+    self->queue[client][(self->head[client] + self->count[client]) % I2C_ARB_QUEUE] = req;
+    if (self->count[client]++ == 0) {
+        self->offset[client] = 0;
+    }
+    dispatch(self);
+    self->bus.Unlock(&self->bus, state);
+    return I2C_ARB_PENDING;
+}
+
+/**
+  * @brief   当前段结束 | The current segment ended
+  * @note    出错时整个请求失败（不重试），由客户端决定怎么处理；总线可能已卡死，恢复之前不再启动新段
+  *          On error the whole request fails (no retry) and the client decides what to do; the
+  *          bus may be stuck, so no segment starts until it has been recovered
+  */
+void I2CArb_Complete(I2CArbiter *self, bool_t ok) {
+    uint32_t state = self->bus.Lock(&self->bus);
+    if (!self->busy) {
+        self->bus.Unlock(&self->bus, state);
+        return;
+    }
+
+    uint8_t c = self->active;
+    I2CClientStats *s = &self->stats[c];
+    I2CRequest *req = self->queue[c][self->head[c]];
+    s->busyTicks += self->bus.Now(&self->bus) - self->activeSince;
+    s->segments++;
+    self->busy = FALSE;
+
+    self->offset[c] += self->activeLen;
+    if (!ok || self->offset[c] >= req->len) {
+        if (ok) {
+            s->requests++;
+        } else {
+            s->errors++;
+        }
+        self->head[c] = (uint8_t)((self->head[c] + 1) % I2C_ARB_QUEUE);
+        self->count[c]--;
+        self->offset[c] = 0;
+        req->status = ok ? I2C_ARB_DONE : I2C_ARB_ERR_BUS;
+    }
+    if (!ok) {
+        self->faulted = TRUE;
+    }
+    dispatch(self);
+    self->bus.Unlock(&self->bus, state);
+}
+
+/**
+  * @brief   恢复总线 | Recover the bus
+  * @note    faulted 期间不会派发，也就没有完成中断，Recover 可以不加锁独占外设
+  *          Nothing is dispatched while faulted, so no completion interrupt can fire and
+  *          Recover owns the peripheral without holding the lock
+  */
+void I2CArb_Service(I2CArbiter *self) {
+    if (!self->faulted || self->busy) return;
+
+    uint32_t start = self->bus.Now(&self->bus);
+    bool_t ok = self->bus.Recover ? self->bus.Recover(&self->bus) : TRUE;
+    uint32_t took = self->bus.Now(&self->bus) - start;
+
+    uint32_t state = self->bus.Lock(&self->bus);
+    if (ok) {
+        self->recoveries++;
+    } else {
+        self->recoverFails++;
+    }
+    if (took > self->maxRecoverTicks) {
+        self->maxRecoverTicks = took;
+    }
+    self->faulted = FALSE;
+    dispatch(self);
+    self->bus.Unlock(&self->bus, state);
+}
+
+/**
+  * @brief   占用总线的比例 | Share of bus time
+  */
+fp32 I2CArb_Utilization(const I2CArbiter *self, uint8_t client) {
+    uint32_t elapsed = self->bus.Now((I2CBus *)&self->bus) - self->statsSince;
+    return elapsed ? (fp32)self->stats[client].busyTicks / (fp32)elapsed : 0.0f;
+}
+
+/**
+  * @brief   最长等待 (µs) | Worst wait
+  */
+uint32_t I2CArb_MaxWaitUs(const I2CArbiter *self, uint8_t client) {
+    return self->stats[client].maxWaitTicks / self->bus.ticksPerUs;
+}
+
+/**
+  * @brief   清零统计 | Reset the statistics
+  */
+void I2CArb_ResetStats(I2CArbiter *self) {
+    uint32_t state = self->bus.Lock(&self->bus);
+    memset(self->stats, 0, sizeof(self->stats));
+    self->statsSince = self->bus.Now(&self->bus);
+    self->bus.Unlock(&self->bus, state);
+}
@@ -0,0 +1,48 @@
+#include "i2c_recover.h"
+
+/**
+  * @brief   释放 SCL 并等它真正变高（从机可能拉长时钟） | Release SCL and wait until it is actually high (the slave may stretch the clock)
+  * @note    等待次数在整次恢复中共享，保证总耗时有上限 | The wait budget is shared by the whole recovery so the total time stays bounded
+  */
+static bool_t releaseScl(I2CPins *pins, uint16_t *budget) {
+    pins->Scl(pins, TRUE);
+    while (!pins->ReadScl(pins)) {
+        if ((*budget)-- == 0) return FALSE;
+        pins->Delay(pins);
+    }
+    return TRUE;
+}
+
+/**
+  * @brief   打出时钟释放总线并发送 STOP | Clock the bus free and send a STOP
+  */
+int I2C_ClockOut(I2CPins *pins) {
+    uint16_t budget = I2C_RECOVER_STRETCH;
+
+    pins->Sda(pins, TRUE);
+    if (!releaseScl(pins, &budget)) return I2C_RECOVER_ERR_SCL;
+    pins->Delay(pins);
+
+    // 从机每个时钟移出一位，读到 SDA 为高（它在等下一位或等应答）即可停止
+    // The slave shifts out one bit per clock; stop as soon as SDA reads high (it is waiting for the next bit or the ACK)
+    int clocks = 0;
+    while (!pins->ReadSda(pins)) {
+        if (clocks == I2C_RECOVER_CLOCKS) return I2C_RECOVER_ERR_SDA;
+        pins->Scl(pins, FALSE);
+        pins->Delay(pins);
+        if (!releaseScl(pins, &budget)) return I2C_RECOVER_ERR_SCL;
+        pins->Delay(pins);
+        clocks++;
+    }
+
+    // STOP：SCL 为高时 SDA 上升，从机状态机回到空闲 | STOP: SDA rises while SCL is high, returning every slave to idle
+    pins->Scl(pins, FALSE);
+    pins->Delay(pins);
+    pins->Sda(pins, FALSE);
+    pins->Delay(pins);
+    if (!releaseScl(pins, &budget)) return I2C_RECOVER_ERR_SCL;
+    pins->Delay(pins);
+    pins->Sda(pins, TRUE);
+    pins->Delay(pins);
+    return pins->ReadSda(pins) ? clocks : I2C_RECOVER_ERR_SDA;
+}
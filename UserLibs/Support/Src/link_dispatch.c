@@ -0,0 +1,35 @@
+#include "link_dispatch.h"
+#include "param.h"
+#include "command.h"
+
+/**
+  * @brief   处理一帧 | Handle one frame
+  */
+void Link_HandleFrame(const LinkDispatch *self, UartRx *rx, const Frame *frame) {
+    uint8_t payload[PROTOCOL_MAX_PAYLOAD];
+    uint8_t len = 0;
+    uint8_t type = Param_HandleFrame(frame, payload, &len);
+    if (type == 0 && self->path) {
+        type = Path_HandleFrame(self->path, frame, payload, &len);
+    }
+
+    if (type == 0) {
+        if (frame->type >= CMD_LEFT && frame->type <= CMD_SPEED_CONSTANT) {
+            // 重发的命令只应答不执行；队列满时不应答，由上位机重发
+            // Retransmissions are acked but not re-run; if the queue is full no ack is sent and the host retries
+            if (SpscRing_Free(self->cmds) == 0) {
+                return;
+            }
+            if (UartRx_AcceptCommand(rx, frame)) {
+                SpscRing_Push(self->cmds, &frame->type);
+            }
+            self->send(self->ctx, frame->type, frame->seq, NULL, 0);  // 命令应答 | Command ack
+        } else if (frame->type == MSG_LINK_STATS) {
+            self->send(self->ctx, MSG_LINK_STATS, frame->seq, (const uint8_t *)&rx->stats, sizeof(rx->stats));
+        }
+        return;
+    }
+
+    // 队列满时丢弃应答，由上位机超时重发 | If the queue is full the reply is dropped and the host retries
+    self->send(self->ctx, type, frame->seq, payload, len);
+}
@@ -0,0 +1,224 @@
+/**
+  * @file    micro_bench.c
+  * @brief   热点函数微基准的负载与统计 | Workloads and statistics of the hot-function micro-benchmarks
+  */
+#include <math.h>
+#include <string.h>
+#include "micro_bench.h"
+#include "pid.h"
+#include "motor.h"
+#include "filter.h"
+#include "calibrate_angle.h"
+#include "MPU6500.h"
+#include "inv_mpu.h"
+#include "inv_mpu_dmp_motion_driver.h"
+
+#define BATCH           MICRO_BENCH_BATCH
+#define PACKET_MAX      32              /**< 四元数 16 + 加速度 6 + 角速度 6 + 手势 4 | Quaternion 16 + accel 6 + gyro 6 + gesture 4 */
+#define Q30             1073741824.0f
+#define DEG_TO_RAD      0.01745329f
+
+volatile uint32_t microBenchSink;
+
+static uint32_t seed;
+
+/**
+  * @brief   固定种子的线性同余随机数，主机与目标板序列相同 | Fixed-seed LCG, the same sequence on host and target
+  * @return  [-1, 1) 均匀分布 | Uniform in [-1, 1)
+  */
+static fp32 rnd(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return (fp32)(int32_t)seed / 2147483648.0f;
+}
+
+/* PID_calc：电机速度内环，增益与限幅同 motor.c | PID_calc: the motor speed loop, gains and limits as motor.c -------*/
+
+static pid_type_def pid;
+static fp32 pidFdb[BATCH], pidSet[BATCH];
+
+static void pidSetup(void) {
+    const fp32 k[3] = {MOTOR_PID_KP, MOTOR_PID_KI, MOTOR_PID_KD};
+    PID_init(&pid, PID_POSITION, k, 60000.0f, 30000.0f);
+    seed = 1;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        pidSet[i] = roundf(30.0f * rnd());                  // 计数/周期 | Counts per period
+        pidFdb[i] = pidSet[i] + roundf(5.0f * rnd());
+    }
+}
+
+static void pidRun(void) {
+    fp32 acc = 0.0f;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        acc += PID_calc(&pid, pidFdb[i], pidSet[i]);
+    }
+    microBenchSink += (uint32_t)(int32_t)acc;
+}
+
+/* Filter_Process：电压滑动平均，含排序去极值 | Filter_Process: voltage moving average with a sort to drop outliers -*/
+
+static MotorVoltageFilter filter;
+static int16_t filterIn[BATCH];
+
+static void filterSetup(void) {
+    Filter_Init(&filter, 7400);
+    seed = 2;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        filterIn[i] = (int16_t)(7400.0f + 150.0f * rnd() + ((i % 17) == 0 ? 2000.0f * rnd() : 0.0f));
+    }
+}
+
+static void filterRun(void) {
+    int32_t acc = 0;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        acc += Filter_Process(&filter, filterIn[i]);
+    }
+    microBenchSink += (uint32_t)acc;
+}
+
+/* BalanceTarget_Update：平衡目标自学习 | BalanceTarget_Update: balance target self-learning ----------------------*/
+
+static BalanceTarget target;
+static fp32 speedL[BATCH], speedR[BATCH];
+
+static void targetSetup(void) {
+    target = newBalanceTarget(0.0f);
+    seed = 3;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        speedL[i] = 40.0f * rnd();
+        speedR[i] = speedL[i] + 5.0f * rnd();
+    }
+}
+
+static void targetRun(void) {
+    fp32 acc = 0.0f;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        acc += BalanceTarget_Update(&target, speedL[i], speedR[i]);
+    }
+    microBenchSink += (uint32_t)(int32_t)(acc * 1000.0f);
+}
+
+/* 四元数换欧拉角 | Quaternion to Euler ------------------------------------------------------------------*/
+
+static long quat[BATCH][4];
+
+/**
+  * @brief   横滚 ±30°、俯仰 ±10°、航向 ±180° 的 Q30 四元数 q = q_z·q_y·q_x | Q30 quaternions q = q_z·q_y·q_x with roll ±30°, pitch ±10°, yaw ±180°
+  */
+static void quatSetup(void) {
+    seed = 4;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        fp32 hx = 15.0f * DEG_TO_RAD * rnd(), hy = 5.0f * DEG_TO_RAD * rnd(), hz = 90.0f * DEG_TO_RAD * rnd();
+        fp32 cx = cosf(hx), sx = sinf(hx), cy = cosf(hy), sy = sinf(hy), cz = cosf(hz), sz = sinf(hz);
+        quat[i][0] = lrintf((cz * cy * cx + sz * sy * sx) * Q30);
+        quat[i][1] = lrintf((cz * cy * sx - sz * sy * cx) * Q30);
+        quat[i][2] = lrintf((cz * sy * cx + sz * cy * sx) * Q30);
+        quat[i][3] = lrintf((sz * cy * cx - cz * sy * sx) * Q30);
+    }
+}
+
+static void quatRun(void) {
+    fp32 acc = 0.0f;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        float pitch, roll, yaw;
+        MPU6500_Quat_To_Euler(quat[i], &pitch, &roll, &yaw);
+        acc += pitch + roll + yaw;
+    }
+    microBenchSink += (uint32_t)(int32_t)acc;
+}
+
+/* DMP 数据包解码 | DMP packet decode ---------------------------------------------------------------------*/
+
+static unsigned char packet[BATCH][PACKET_MAX];
+
+static void putBig(unsigned char *p, uint32_t value, uint8_t bytes) {
+    for (uint8_t i = 0; i < bytes; i++) {
+        p[i] = (unsigned char)(value >> (8 * (bytes - 1 - i)));
+    }
+}
+
+/**
+  * @brief   四元数取自上一用例的输入，加速度与角速度随机，手势字为空 | Quaternions from the previous case's inputs, random acceleration and rate, empty gesture word
+  */
+static void packetSetup(void) {
+    quatSetup();
+    seed = 5;
+    memset(packet, 0, sizeof(packet));
+    for (uint16_t i = 0; i < BATCH; i++) {
+        unsigned char *p = packet[i];
+        for (uint8_t k = 0; k < 4; k++, p += 4) putBig(p, (uint32_t)quat[i][k], 4);
+        for (uint8_t k = 0; k < 6; k++, p += 2) putBig(p, (uint32_t)(int32_t)(16384.0f * rnd()), 2);
+    }
+}
+
+static void packetRun(void) {
+    int32_t acc = 0;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        short gyro[3], accel[3], sensors;
+        long q[4];
+        dmp_parse_packet(packet[i], gyro, accel, q, &sensors);
+        acc += (int32_t)(q[0] >> 16) + gyro[0] + accel[2] + sensors;
+    }
+    microBenchSink += (uint32_t)acc;
+}
+
+/* 空循环：只读输入表并写 sink，用于扣除测量开销 | Empty loop: reads an input table and writes the sink, for the measurement overhead */
+
+static void overheadRun(void) {
+    fp32 acc = 0.0f;
+    for (uint16_t i = 0; i < BATCH; i++) {
+        acc += pidSet[i];
+        __asm__ volatile("" : "+r"(acc));
+    }
+    microBenchSink += (uint32_t)(int32_t)acc;
+}
+
+const MicroBenchCase microBenchCases[] = {
+        {"overhead",       "(loop only)",           pidSetup,    overheadRun},
+        {"pid_calc",       "PID_calc",              pidSetup,    pidRun},
+        {"filter",         "Filter_Process",        filterSetup, filterRun},
+        {"balance_target", "BalanceTarget_Update",  targetSetup, targetRun},
+        {"quat_to_euler",  "MPU6500_Quat_To_Euler", quatSetup,   quatRun},
+        {"dmp_decode",     "dmp_parse_packet",      packetSetup, packetRun},
+};
+
+const uint8_t microBenchCaseCount = sizeof(microBenchCases) / sizeof(microBenchCases[0]);
+
+void MicroBench_Summarise(fp32 *samples, uint16_t n, MicroBenchStats *out) {
+    memset(out, 0, sizeof(*out));
+    out->n = n;
+    if (n == 0) {
+        return;
+    }
+    // 插入排序，n 不超过 MICRO_BENCH_MAX_REPEATS | Insertion sort; n is at most MICRO_BENCH_MAX_REPEATS
+    for (uint16_t i = 1; i < n; i++) {
+        fp32 v = samples[i];
+        uint16_t j = i;
+        for (; j > 0 && samples[j - 1] > v; j--) samples[j] = samples[j - 1];
+        samples[j] = v;
+    }
+    fp32 sum = 0.0f, sumSq = 0.0f;
+    for (uint16_t i = 0; i < n; i++) sum += samples[i];
+    out->mean = sum / (fp32)n;
+    for (uint16_t i = 0; i < n; i++) sumSq += (samples[i] - out->mean) * (samples[i] - out->mean);
+    out->stddev = n > 1 ? sqrtf(sumSq / (fp32)(n - 1)) : 0.0f;
+    out->min = samples[0];
+    out->median = (n & 1) ? samples[n / 2] : 0.5f * (samples[n / 2 - 1] + samples[n / 2]);
+
+    // 中位数的次序统计量区间：秩 n/2 ∓ 0.98·√n（1.96 倍二项分布标准差） | Order-statistic interval of the median: ranks n/2 ∓ 0.98·√n (1.96 binomial standard deviations)
+    fp32 half = 0.98f * sqrtf((fp32)n);
+    int32_t lo = (int32_t)floorf((fp32)n / 2.0f - half);
+    int32_t hi = (int32_t)ceilf((fp32)n / 2.0f + half);
+    out->ciLow = samples[lo < 0 ? 0 : lo];
+    out->ciHigh = samples[hi > n - 1 ? n - 1 : hi];
+
+    // 绝对偏差的中位数 | Median of absolute deviations
+    static fp32 dev[MICRO_BENCH_MAX_REPEATS];
+    uint16_t m = n < MICRO_BENCH_MAX_REPEATS ? n : MICRO_BENCH_MAX_REPEATS;
+    for (uint16_t i = 0; i < m; i++) {
+        fp32 v = fabsf(samples[i] - out->median);
+        uint16_t j = i;
+        for (; j > 0 && dev[j - 1] > v; j--) dev[j] = dev[j - 1];
+        dev[j] = v;
+    }
+    out->mad = (m & 1) ? dev[m / 2] : 0.5f * (dev[m / 2 - 1] + dev[m / 2]);
+}
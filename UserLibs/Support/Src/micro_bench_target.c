@@ -0,0 +1,80 @@
+/**
+  * @file    micro_bench_target.c
+  * @brief   微基准的目标板计时：DWT CYCCNT 计周期，结果从上位机串口打印 | Target timing of the micro-benchmarks: DWT CYCCNT cycles, printed on the PC link
+  */
+#include <stdio.h>
+#include "main.h"
+#include "micro_bench.h"
+#include "communication.h"
+
+static fp32 samples[MICRO_BENCH_MAX_REPEATS * 8];
+
+/**
+  * @brief   整行写入发送队列，队列满时等待 DMA 腾出空间 | Queue a whole line, waiting for the DMA while the queue is full
+  */
+static void writeLine(const char *line, int len) {
+    if (len <= 0) {
+        return;
+    }
+    while (uart_Write((const uint8_t *)line, (uint16_t)len) != 0) {
+    }
+}
+
+/**
+  * @brief   非负数按两位小数打印；newlib-nano 的 printf 不支持浮点 | Print a non-negative value with two decimals; newlib-nano's printf has no floating point
+  */
+static int fixed(char *buf, size_t size, fp32 value) {
+    uint32_t hundredths = (uint32_t)(value * 100.0f + 0.5f);
+    return snprintf(buf, size, "%lu.%02lu", (unsigned long)(hundredths / 100), (unsigned long)(hundredths % 100));
+}
+
+void MicroBench_Target(uint16_t repeats) {
+    char line[224];
+    char f[7][16];
+    uint8_t cases = microBenchCaseCount < 8 ? microBenchCaseCount : 8;
+    if (repeats > MICRO_BENCH_MAX_REPEATS) {
+        repeats = MICRO_BENCH_MAX_REPEATS;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for (uint8_t c = 0; c < cases; c++) {
+        microBenchCases[c].Setup();
+        microBenchCases[c].Run();                                       // 预热缓存与分支预测 | Warm the cache and branch predictor
+    }
+    // 各用例轮流执行，慢漂移（温度、闪存等待）平均分到每个用例 | Round-robin, so slow drift (temperature, flash wait states) spreads evenly
+    for (uint16_t r = 0; r < repeats; r++) {
+        for (uint8_t c = 0; c < cases; c++) {
+            __disable_irq();
+            uint32_t start = DWT->CYCCNT;
+            microBenchCases[c].Run();
+            uint32_t cycles = DWT->CYCCNT - start;
+            __enable_irq();
+            samples[c * MICRO_BENCH_MAX_REPEATS + r] = (fp32)cycles / (fp32)MICRO_BENCH_BATCH;
+        }
+    }
+
+    int len = snprintf(line, sizeof(line), "{\"target\":\"stm32f446\",\"unit\":\"cycles\",\"clock_hz\":%lu,\"batch\":%u,\"cases\":[\r\n",
+                       (unsigned long)SystemCoreClock, MICRO_BENCH_BATCH);
+    writeLine(line, len);
+    for (uint8_t c = 0; c < cases; c++) {
+        MicroBenchStats s;
+        MicroBench_Summarise(&samples[c * MICRO_BENCH_MAX_REPEATS], repeats, &s);
+        fixed(f[0], sizeof(f[0]), s.median);
+        fixed(f[1], sizeof(f[1]), s.ciLow);
+        fixed(f[2], sizeof(f[2]), s.ciHigh);
+        fixed(f[3], sizeof(f[3]), s.min);
+        fixed(f[4], sizeof(f[4]), s.mean);
+        fixed(f[5], sizeof(f[5]), s.stddev);
+        fixed(f[6], sizeof(f[6]), s.mad);
+        len = snprintf(line, sizeof(line),
+                       "{\"name\":\"%s\",\"function\":\"%s\",\"n\":%u,\"median\":%s,\"ci_low\":%s,\"ci_high\":%s,"
+                       "\"min\":%s,\"mean\":%s,\"stddev\":%s,\"mad\":%s}%s\r\n",
+                       microBenchCases[c].name, microBenchCases[c].function, s.n, f[0], f[1], f[2], f[3], f[4], f[5], f[6],
+                       c + 1 < cases ? "," : "");
+        writeLine(line, len);
+    }
+    writeLine("]}\r\n", 4);
+}
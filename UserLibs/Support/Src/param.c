@@ -0,0 +1,206 @@
+#include "param.h"
+#include "param_store.h"
+#include "spsc_ring.h"
+#include <string.h>
+
+extern ParamStore paramStore;
+
+/* 暂存队列：串口中断写入，主循环读取 | Staging queue: written from UART IRQ, drained by the main loop */
+typedef struct {
+    uint8_t id;
+    ParamValue value;
+} PendingWrite;
+
+SPSC_RING_DEFINE(pendingRing, PendingWrite, PARAM_PENDING_SIZE);
+static volatile uint8_t saveRequested = 0;
+
+/**
+  * @brief   参数数量 | Number of parameters
+  */
+uint8_t Param_Count(void) {
+    return paramTableSize;
+}
+
+/**
+  * @brief   获取参数描述 | Get parameter descriptor
+  */
+const ParamDef *Param_Def(uint8_t id) {
+    return (id < paramTableSize) ? &paramTable[id] : NULL;
+}
+
+/**
+  * @brief   按名称查找参数 | Find parameter by name
+  */
+int Param_Find(const char *name) {
+    for (uint8_t i = 0; i < paramTableSize; i++) {
+        if (strncmp(paramTable[i].name, name, PARAM_NAME_LEN) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+  * @brief   读取当前值 | Read current value
+  */
+ParamValue Param_Read(uint8_t id) {
+    ParamValue v = {.i = 0};
+    const ParamDef *def = Param_Def(id);
+    if (def == NULL) return v;
+
+    switch (def->type) {
+        case PARAM_TYPE_F32: v.f = *(fp32 *)def->ptr;     break;
+        case PARAM_TYPE_I32: v.i = *(int32_t *)def->ptr;  break;
+        case PARAM_TYPE_U16: v.i = *(uint16_t *)def->ptr; break;
+        case PARAM_TYPE_I8:  v.i = *(int8_t *)def->ptr;   break;
+        case PARAM_TYPE_U8:  v.i = *(uint8_t *)def->ptr;  break;
+        default: break;
+    }
+    return v;
+}
+
+/**
+  * @brief   写入变量并调用回调 | Write the variable and run the hook
+  */
+static void applyValue(const ParamDef *def, ParamValue v) {
+    switch (def->type) {
+        case PARAM_TYPE_F32: *(fp32 *)def->ptr = v.f;               break;
+        case PARAM_TYPE_I32: *(int32_t *)def->ptr = v.i;            break;
+        case PARAM_TYPE_U16: *(uint16_t *)def->ptr = (uint16_t)v.i; break;
+        case PARAM_TYPE_I8:  *(int8_t *)def->ptr = (int8_t)v.i;     break;
+        case PARAM_TYPE_U8:  *(uint8_t *)def->ptr = (uint8_t)v.i;   break;
+        default: break;
+    }
+    if (def->OnApply != NULL) {
+        def->OnApply(def);
+    }
+}
+
+/**
+  * @brief   范围检查 | Range check
+  */
+static bool_t inRange(const ParamDef *def, ParamValue v) {
+    fp32 x = (def->type == PARAM_TYPE_F32) ? v.f : (fp32)v.i;
+    return (x >= def->min) && (x <= def->max);  // NaN 不通过 | NaN is rejected
+}
+
+/**
+  * @brief   暂存一次写入 | Stage a write
+  */
+int Param_Stage(uint8_t id, ParamValue value) {
+    const ParamDef *def = Param_Def(id);
+    if (def == NULL) return PARAM_ERR_ID;
+    if (def->flags & PARAM_FLAG_READONLY) return PARAM_ERR_READONLY;
+    if (!inRange(def, value)) return PARAM_ERR_RANGE;
+
+    PendingWrite w = {.id = id, .value = value};
+    return SpscRing_Push(&pendingRing, &w) ? PARAM_OK : PARAM_ERR_BUSY;
+}
+
+/**
+  * @brief   请求保存 | Request save
+  */
+void Param_RequestSave(void) {
+    saveRequested = 1;
+}
+
+/**
+  * @brief   应用暂存写入 | Apply staged writes
+  * @note    在两次控制计算之间调用，一次性应用本周期内收到的所有写入
+  *          Call between two control iterations; all writes received so far are applied together
+  */
+void Param_ApplyPending(void) {
+    PendingWrite w;
+    while (SpscRing_Pop(&pendingRing, &w)) {
+        applyValue(&paramTable[w.id], w.value);
+    }
+
+    if (saveRequested) {
+        saveRequested = 0;
+        for (uint8_t i = 0; i < paramTableSize; i++) {
+            if (paramTable[i].flags & PARAM_FLAG_PERSIST) {
+                ParamValue v = Param_Read(i);
+                if (ParamStore_Set(&paramStore, paramTable[i].storeKey, &v, sizeof(v)) == PARAM_STORE_ERR_BUSY) {
+                    // 需要先擦扇区：推迟到主循环在刹车时完成擦除；已写入的值再写不耗 Flash
+                    // A sector must be erased first: defer until the main loop erases it while braked;
+                    // values already written cost nothing when written again
+                    saveRequested = 1;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+  * @brief   从 Flash 载入持久参数 | Load persistent parameters from flash
+  */
+void Param_Load(void) {
+    for (uint8_t i = 0; i < paramTableSize; i++) {
+        ParamValue v;
+        if ((paramTable[i].flags & PARAM_FLAG_PERSIST) &&
+            ParamStore_Get(&paramStore, paramTable[i].storeKey, &v, sizeof(v)) == PARAM_STORE_OK &&
+            inRange(&paramTable[i], v)) {
+            applyValue(&paramTable[i], v);
+        }
+    }
+}
+
+/**
+  * @brief   处理参数协议帧 | Handle a parameter protocol frame
+  */
+uint8_t Param_HandleFrame(const Frame *req, uint8_t *reply, uint8_t *len) {
+    const uint8_t *p = req->payload;
+    ParamValue v;
+    int ret;
+
+    switch (req->type) {
+        case MSG_PARAM_INFO: {
+            const ParamDef *def = (req->len >= 1) ? Param_Def(p[0]) : NULL;
+            if (def == NULL) break;
+            uint8_t n = (uint8_t)strnlen(def->name, PARAM_NAME_LEN);
+            v = Param_Read(p[0]);
+            reply[0] = p[0];
+            reply[1] = def->type;
+            reply[2] = def->flags;
+            memcpy(&reply[3], &def->min, 4);
+            memcpy(&reply[7], &def->max, 4);
+            memcpy(&reply[11], &v, 4);
+            memcpy(&reply[15], def->name, n);
+            *len = (uint8_t)(15 + n);
+            return MSG_PARAM_INFO;
+        }
+        case MSG_PARAM_GET:
+            if (req->len < 1 || Param_Def(p[0]) == NULL) break;
+            v = Param_Read(p[0]);
+            reply[0] = p[0];
+            memcpy(&reply[1], &v, 4);
+            *len = 5;
+            return MSG_PARAM_GET;
+
+        case MSG_PARAM_SET:
+            if (req->len < 5) break;
+            memcpy(&v, &p[1], 4);
+            ret = Param_Stage(p[0], v);
+            reply[0] = p[0];
+            reply[1] = (uint8_t)(int8_t)ret;
+            memcpy(&reply[2], &v, 4);  // 回显暂存值 | Echo staged value
+            *len = 6;
+            return MSG_PARAM_SET;
+
+        case MSG_PARAM_SAVE:
+            Param_RequestSave();
+            reply[0] = PARAM_OK;
+            *len = 1;
+            return MSG_PARAM_SAVE;
+
+        default:
+            return 0;  // 非参数消息 | Not a parameter message
+    }
+
+    // 请求格式错误或编号无效 | Malformed request or invalid id
+    reply[0] = req->type;
+    reply[1] = (uint8_t)(int8_t)PARAM_ERR_ID;
+    *len = 2;
+    return MSG_NACK;
+}
@@ -0,0 +1,447 @@
+#include "param_store.h"
+#include "crc.h"
+#include <string.h>
+
+// 全局参数存储 | Global parameter store
+ParamStore paramStore;
+
+/* 扇区头字段（按字） | Sector header fields (word offsets) */
+#define HDR_MAGIC       0   /**< 魔数 | Magic */
+#define HDR_GENERATION  1   /**< 代数，每次搬移加一 | Generation, +1 per compaction */
+#define HDR_ERASE_COUNT 2   /**< 擦除次数 | Erase count */
+#define HDR_ACTIVE      3   /**< 写 0 表示搬移完成 | Cleared when compaction completed */
+#define HDR_OBSOLETE    4   /**< 写 0 表示已废弃 | Cleared when superseded */
+#define HDR_WORDS       8
+
+#define PARAM_STORE_MAGIC   0x50426E44u   /**< "DnBP" */
+#define ERASED_WORD         0xFFFFFFFFu
+#define SCAN_CHUNK          16            /**< 扫描时每次读取的记录数 | Records read per scan chunk */
+
+/**
+  * @brief   Flash 中的记录布局 | Record layout in flash
+  * @note    首字最先写入（占用槽位），CRC 最后写入（提交） | Word 0 is programmed first (claims the slot), CRC last (commits)
+  */
+typedef struct {
+    uint16_t key;
+    uint8_t  len;
+    uint8_t  reserved;
+    uint8_t  value[PARAM_STORE_VALUE_SIZE];
+    uint32_t crc;
+} ParamRecord;
+
+static uint32_t slotOffset(uint16_t slot) {
+    return (uint32_t)(PARAM_STORE_HEADER_SLOTS + slot) * PARAM_STORE_RECORD_SIZE;
+}
+
+static uint32_t recordCrc(const ParamRecord *rec) {
+    return CRC32_Calc(rec, PARAM_STORE_RECORD_SIZE - sizeof(uint32_t));
+}
+
+static int readHeader(ParamStore *self, uint8_t sector, uint32_t hdr[HDR_WORDS]) {
+    return self->dev.Read(&self->dev, sector, 0, hdr, HDR_WORDS * sizeof(uint32_t));
+}
+
+static int programWord(ParamStore *self, uint8_t sector, uint32_t offset, uint32_t word) {
+    return self->dev.Program(&self->dev, sector, offset, &word, 1);
+}
+
+/**
+  * @brief   读取记录首字 | Read first word of a record
+  */
+static uint32_t readSlotWord(ParamStore *self, uint8_t sector, uint16_t slot) {
+    uint32_t word = 0;
+    self->dev.Read(&self->dev, sector, slotOffset(slot), &word, sizeof(word));
+    return word;
+}
+
+/**
+  * @brief   读取并校验一条记录 | Read and verify a record
+  * @return  TRUE 表示记录有效 | TRUE if the record is valid
+  */
+static bool_t readRecord(ParamStore *self, uint8_t sector, uint16_t slot, ParamRecord *rec) {
+    if (self->dev.Read(&self->dev, sector, slotOffset(slot), rec, sizeof(*rec)) != 0) {
+        return FALSE;
+    }
+    return (rec->len <= PARAM_STORE_VALUE_SIZE) && (rec->crc == recordCrc(rec));
+}
+
+static ParamIndexEntry *findEntry(ParamStore *self, uint16_t key) {
+    for (uint8_t i = 0; i < self->keyCount; i++) {
+        if (self->index[i].key == key) {
+            return &self->index[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+  * @brief   二分查找第一个空槽位（日志只追加，已用槽位连续） | Binary search for the first free slot (log is append-only)
+  */
+static uint16_t findHead(ParamStore *self, uint8_t sector) {
+    uint16_t lo = 0, hi = self->logRecords;
+
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (readSlotWord(self, sector, mid) == ERASED_WORD) {
+            hi = mid;
+        } else {
+            lo = (uint16_t)(mid + 1);
+        }
+    }
+    return lo;
+}
+
+/**
+  * @brief   扫描活动扇区建立索引 | Scan the active sector and build the index
+  *
+  * @note    先只按首字记录每个键的最新与次新槽位，再仅对这些槽位做 CRC 校验；
+  *          最新记录损坏（写入时掉电，只可能是日志最后一条）时改用次新记录，
+  *          两者都坏时才向前逐条查找，且先比较键再算 CRC
+  *          First pass records only the newest and second-newest slot per key from word 0;
+  *          only those slots are CRC-checked. A torn newest record (power lost while writing,
+  *          which can only be the last one in the log) falls back to the second newest; only
+  *          if both are bad does it search backwards, comparing the key before the CRC
+  */
+static void buildIndex(ParamStore *self) {
+    uint8_t chunk[SCAN_CHUNK * PARAM_STORE_RECORD_SIZE];
+    uint16_t prev[PARAM_STORE_MAX_KEYS];
+    ParamRecord rec;
+
+    self->keyCount = 0;
+    self->head = findHead(self, self->active);
+
+    for (uint16_t base = 0; base < self->head; base += SCAN_CHUNK) {
+        uint16_t n = (uint16_t)(self->head - base);
+        if (n > SCAN_CHUNK) n = SCAN_CHUNK;
+        self->dev.Read(&self->dev, self->active, slotOffset(base), chunk, (uint32_t)n * PARAM_STORE_RECORD_SIZE);
+
+        for (uint16_t i = 0; i < n; i++) {
+            uint16_t key;
+            memcpy(&key, &chunk[i * PARAM_STORE_RECORD_SIZE], sizeof(key));
+            if (key == 0xFFFF) continue;  // 首字写坏 | Torn first word
+
+            ParamIndexEntry *e = findEntry(self, key);
+            if (e == NULL) {
+                if (self->keyCount >= PARAM_STORE_MAX_KEYS) continue;
+                prev[self->keyCount] = 0xFFFF;
+                e = &self->index[self->keyCount++];
+                e->key = key;
+            } else {
+                prev[e - self->index] = e->slot;
+            }
+            e->slot = (uint16_t)(base + i);
+        }
+    }
+
+    // 校验每个键的最新记录 | Verify the newest record of every key
+    for (uint8_t i = 0; i < self->keyCount;) {
+        ParamIndexEntry *e = &self->index[i];
+        int32_t slot = e->slot;
+        bool_t found = readRecord(self, self->active, (uint16_t)slot, &rec) && rec.key == e->key;
+
+        if (!found && prev[i] != 0xFFFF) {
+            slot = prev[i];
+            found = readRecord(self, self->active, (uint16_t)slot, &rec) && rec.key == e->key;
+        }
+        while (!found && --slot >= 0) {
+            found = self->dev.Read(&self->dev, self->active, slotOffset((uint16_t)slot), &rec, sizeof(rec)) == 0 &&
+                    rec.key == e->key && rec.len <= PARAM_STORE_VALUE_SIZE && rec.crc == recordCrc(&rec);
+        }
+
+        if (found) {
+            e->slot = (uint16_t)slot;
+            e->len = rec.len;
+            memcpy(e->value, rec.value, PARAM_STORE_VALUE_SIZE);
+            i++;
+        } else {
+            prev[i] = prev[self->keyCount - 1];
+            *e = self->index[--self->keyCount];  // 无有效记录，移除 | No valid record, drop it
+        }
+    }
+}
+
+/**
+  * @brief   追加一条记录 | Append a record
+  */
+static int appendRecord(ParamStore *self, uint8_t sector, uint16_t slot, uint16_t key,
+                        const uint8_t *value, uint8_t len) {
+    ParamRecord rec;
+    uint32_t words[PARAM_STORE_RECORD_SIZE / sizeof(uint32_t)];
+    uint32_t offset = slotOffset(slot);
+
+    memset(&rec, 0xFF, sizeof(rec));
+    rec.key = key;
+    rec.len = len;
+    memcpy(rec.value, value, len);
+    rec.crc = recordCrc(&rec);
+    memcpy(words, &rec, sizeof(words));
+
+    // 首字 → 数据 → CRC，任一步掉电都会因 CRC 不符被丢弃
+    // Word 0 → payload → CRC; a power loss at any step is rejected by the CRC
+    if (self->dev.Program(&self->dev, sector, offset, &words[0], 1) != 0) return PARAM_STORE_ERR_FLASH;
+    if (self->dev.Program(&self->dev, sector, offset + 4, &words[1], 2) != 0) return PARAM_STORE_ERR_FLASH;
+    if (self->dev.Program(&self->dev, sector, offset + 12, &words[3], 1) != 0) return PARAM_STORE_ERR_FLASH;
+    return PARAM_STORE_OK;
+}
+
+/**
+  * @brief   检查扇区日志窗口是否全为擦除态 | Check that a sector's log window is blank
+  */
+static bool_t isBlank(ParamStore *self, uint8_t sector) {
+    uint32_t buf[SCAN_CHUNK];
+    uint32_t end = slotOffset(self->logRecords);
+
+    for (uint32_t off = 0; off < end; off += sizeof(buf)) {
+        self->dev.Read(&self->dev, sector, off, buf, sizeof(buf));
+        for (uint8_t i = 0; i < SCAN_CHUNK; i++) {
+            if (buf[i] != ERASED_WORD) return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**
+  * @brief   擦除扇区并写入新扇区头（激活标志保持未写） | Erase a sector and write a fresh header (active flag left unset)
+  */
+static int formatSector(ParamStore *self, uint8_t sector, uint32_t generation) {
+    uint32_t hdr[HDR_WORDS];
+    uint32_t eraseCount = 0;
+
+    readHeader(self, sector, hdr);
+    if (hdr[HDR_MAGIC] == PARAM_STORE_MAGIC && hdr[HDR_ERASE_COUNT] != ERASED_WORD) {
+        eraseCount = hdr[HDR_ERASE_COUNT];
+    }
+
+    if (!isBlank(self, sector)) {
+        if (self->dev.Erase(&self->dev, sector) != 0) return PARAM_STORE_ERR_FLASH;
+        eraseCount++;
+    }
+    self->pendingErase &= (uint8_t)~(1u << sector);
+
+    uint32_t init[3] = {PARAM_STORE_MAGIC, generation, eraseCount};
+    if (self->dev.Program(&self->dev, sector, 0, init, 3) != 0) return PARAM_STORE_ERR_FLASH;
+    return PARAM_STORE_OK;
+}
+
+/**
+  * @brief   将索引中的有效记录搬移到另一扇区 | Move live records to the other sector
+  *
+  * @note    新扇区写满后才置激活标志，再废弃旧扇区；任一步掉电，上电时仍能选出完整的扇区。
+  *          目标扇区必须已擦除，否则返回 PARAM_STORE_ERR_BUSY，不在这里阻塞擦除
+  *          The new sector is activated only after all records are copied, then the old
+  *          one is marked obsolete; a power loss at any step still leaves a complete sector.
+  *          The target must already be erased, otherwise PARAM_STORE_ERR_BUSY is returned
+  *          rather than blocking on an erase here
+  */
+static int compact(ParamStore *self) {
+    uint8_t from = self->active;
+    uint8_t to = (uint8_t)(from ^ 1u);
+
+    // 只搬到事先擦好的扇区，擦除留给 ParamStore_Maintain | Only into a sector erased beforehand; erasing is left to ParamStore_Maintain
+    if (self->pendingErase & (1u << to)) return PARAM_STORE_ERR_BUSY;
+    if (!isBlank(self, to)) {
+        self->pendingErase |= (uint8_t)(1u << to);
+        return PARAM_STORE_ERR_BUSY;
+    }
+    int ret = formatSector(self, to, self->generation + 1);
+    if (ret != PARAM_STORE_OK) return ret;
+
+    for (uint8_t i = 0; i < self->keyCount; i++) {
+        ParamIndexEntry *e = &self->index[i];
+        ret = appendRecord(self, to, i, e->key, e->value, e->len);
+        if (ret != PARAM_STORE_OK) return ret;
+        e->slot = i;
+    }
+
+    if (programWord(self, to, HDR_ACTIVE * 4, 0) != 0) return PARAM_STORE_ERR_FLASH;
+    if (programWord(self, from, HDR_OBSOLETE * 4, 0) != 0) return PARAM_STORE_ERR_FLASH;
+
+    self->active = to;
+    self->generation++;
+    self->head = self->keyCount;
+    self->pendingErase |= (uint8_t)(1u << from);
+    return PARAM_STORE_OK;
+}
+
+/**
+  * @brief   初始化参数存储 | Init parameter store
+  * @param   self  参数存储指针 | Pointer to store
+  * @param   dev   Flash 后端 | Flash backend
+  * @return  PARAM_STORE_OK 或错误码 | PARAM_STORE_OK or error code
+  */
+int ParamStore_Init(ParamStore *self, FlashDev dev) {
+    uint32_t hdr[2][HDR_WORDS];
+    bool_t valid[2];
+    int8_t best = -1;
+
+    if (self == NULL || dev.sectorSize < slotOffset(1)) {
+        return PARAM_STORE_ERR_ARG;
+    }
+
+    memset(self, 0, sizeof(*self));
+    self->dev = dev;
+    self->logRecords = (uint16_t)(dev.sectorSize / PARAM_STORE_RECORD_SIZE - PARAM_STORE_HEADER_SLOTS);
+    if (self->logRecords > PARAM_STORE_LOG_RECORDS) self->logRecords = PARAM_STORE_LOG_RECORDS;
+
+    // 选出代数最大的完整扇区 | Pick the complete sector with the highest generation
+    for (uint8_t s = 0; s < 2; s++) {
+        readHeader(self, s, hdr[s]);
+        valid[s] = hdr[s][HDR_MAGIC] == PARAM_STORE_MAGIC &&
+                   hdr[s][HDR_ACTIVE] == 0 && hdr[s][HDR_OBSOLETE] != 0;
+        if (valid[s] && (best < 0 || hdr[s][HDR_GENERATION] > hdr[best][HDR_GENERATION])) {
+            best = (int8_t)s;
+        }
+        if (hdr[s][HDR_MAGIC] != ERASED_WORD) {
+            self->pendingErase |= (uint8_t)(1u << s);
+        }
+    }
+
+    if (best < 0) {
+        // 首次上电：格式化扇区 0 | First boot: format sector 0
+        int ret = formatSector(self, 0, 1);
+        if (ret != PARAM_STORE_OK) return ret;
+        if (programWord(self, 0, HDR_ACTIVE * 4, 0) != 0) return PARAM_STORE_ERR_FLASH;
+        self->active = 0;
+        self->generation = 1;
+        self->head = 0;
+        return PARAM_STORE_OK;
+    }
+
+    self->active = (uint8_t)best;
+    self->generation = hdr[best][HDR_GENERATION];
+    self->pendingErase &= (uint8_t)~(1u << best);
+
+    // 搬移完成但旧扇区未废弃：补写废弃标志 | Compaction finished but old sector not retired yet
+    uint8_t other = (uint8_t)(best ^ 1);
+    if (valid[other]) {
+        programWord(self, other, HDR_OBSOLETE * 4, 0);
+    }
+
+    buildIndex(self);
+    return PARAM_STORE_OK;
+}
+
+/**
+  * @brief   读取参数 | Read a parameter
+  */
+int ParamStore_Get(ParamStore *self, uint16_t key, void *buf, uint8_t len) {
+    ParamIndexEntry *e = findEntry(self, key);
+    if (e == NULL || e->len != len) {
+        return PARAM_STORE_ERR_NOT_FOUND;
+    }
+    memcpy(buf, e->value, len);
+    return PARAM_STORE_OK;
+}
+
+/**
+  * @brief   写入参数 | Write a parameter
+  */
+int ParamStore_Set(ParamStore *self, uint16_t key, const void *data, uint8_t len) {
+    uint8_t value[PARAM_STORE_VALUE_SIZE];
+
+    if (key == 0xFFFF || len > PARAM_STORE_VALUE_SIZE || data == NULL) {
+        return PARAM_STORE_ERR_ARG;
+    }
+    memset(value, 0xFF, sizeof(value));
+    memcpy(value, data, len);
+
+    ParamIndexEntry *e = findEntry(self, key);
+    if (e != NULL && e->len == len && memcmp(e->value, value, len) == 0) {
+        return PARAM_STORE_OK;  // 值未变化，不消耗写入次数 | Unchanged, save a write cycle
+    }
+    if (e == NULL && self->keyCount >= PARAM_STORE_MAX_KEYS) {
+        return PARAM_STORE_ERR_FULL;
+    }
+
+    if (self->head >= self->logRecords) {
+        int ret = compact(self);
+        if (ret != PARAM_STORE_OK) return ret;
+    }
+
+    int ret = appendRecord(self, self->active, self->head, key, value, len);
+    if (ret != PARAM_STORE_OK) {
+        self->head++;  // 槽位已被占用 | Slot is consumed either way
+        return ret;
+    }
+
+    if (e == NULL) {
+        e = &self->index[self->keyCount++];
+        e->key = key;
+    }
+    e->slot = self->head++;
+    e->len = len;
+    memcpy(e->value, value, PARAM_STORE_VALUE_SIZE);
+    return PARAM_STORE_OK;
+}
+
+/**
+  * @brief   读取浮点参数 | Read a float parameter
+  */
+fp32 ParamStore_GetFloat(ParamStore *self, uint16_t key, fp32 def) {
+    fp32 value;
+    return (ParamStore_Get(self, key, &value, sizeof(value)) == PARAM_STORE_OK) ? value : def;
+}
+
+/**
+  * @brief   写入浮点参数 | Write a float parameter
+  */
+int ParamStore_SetFloat(ParamStore *self, uint16_t key, fp32 value) {
+    return ParamStore_Set(self, key, &value, sizeof(value));
+}
+
+/**
+  * @brief   是否有扇区等待擦除 | Whether a sector is waiting to be erased
+  */
+bool_t ParamStore_ErasePending(const ParamStore *self) {
+    return (self->pendingErase & (uint8_t)~(1u << self->active)) ? TRUE : FALSE;
+}
+
+/**
+  * @brief   擦除已废弃扇区 | Erase obsolete sectors
+  */
+int ParamStore_Maintain(ParamStore *self) {
+    for (uint8_t s = 0; s < 2; s++) {
+        if ((self->pendingErase & (1u << s)) && s != self->active) {
+            // 日志窗口已是擦除态时省一次擦写，与 formatSector 相同 | Skip the erase when the log window is already blank, as formatSector does
+            if (!isBlank(self, s) && self->dev.Erase(&self->dev, s) != 0) return PARAM_STORE_ERR_FLASH;
+            self->pendingErase &= (uint8_t)~(1u << s);
+        }
+    }
+    return PARAM_STORE_OK;
+}
+
+/* ---------------- RAM 后端 | RAM backend ---------------- */
+
+static int RamFlash_Read(FlashDev *self, uint8_t sector, uint32_t offset, void *buf, uint32_t len) {
+    memcpy(buf, (uint8_t *)self->ctx + sector * self->sectorSize + offset, len);
+    return 0;
+}
+
+static int RamFlash_Program(FlashDev *self, uint8_t sector, uint32_t offset, const uint32_t *words, uint32_t count) {
+    uint8_t *p = (uint8_t *)self->ctx + sector * self->sectorSize + offset;
+    for (uint32_t i = 0; i < count; i++, p += 4) {
+        uint32_t cur;
+        memcpy(&cur, p, 4);
+        cur &= words[i];  // NOR Flash 只能把 1 改为 0 | NOR flash can only clear bits
+        memcpy(p, &cur, 4);
+    }
+    return 0;
+}
+
+static int RamFlash_Erase(FlashDev *self, uint8_t sector) {
+    memset((uint8_t *)self->ctx + sector * self->sectorSize, 0xFF, self->sectorSize);
+    return 0;
+}
+
+/**
+  * @brief   创建基于 RAM 的 Flash 后端 | Create a RAM-backed flash backend
+  */
+FlashDev newRamFlashDev(uint8_t *mem, uint32_t sectorSize) {
+    FlashDev d;
+    d.ctx = mem;
+    d.sectorSize = sectorSize;
+    d.Read = RamFlash_Read;
+    d.Program = RamFlash_Program;
+    d.Erase = RamFlash_Erase;
+    return d;
+}
@@ -0,0 +1,77 @@
+#include "param.h"
+#include "param_store.h"
+#include "car.h"
+
+extern Car car;
+
+// telemetry.c 中的遥测周期 | Telemetry period in telemetry.c
+extern uint8_t telemetryPeriodMs;
+
+// sensor_log.c 中的日志开关 | Log switch in sensor_log.c
+extern uint8_t sensorLogEnabled;
+
+// 控制周期（TIM9 自动重装载，1 MHz 计数） | Control period (TIM9 auto-reload, 1 MHz tick)
+static uint16_t loopPeriodUs = 10000;
+
+// 退役参数的占位值：编号保留，写入被拒 | Value behind retired entries: their ids stay taken and writes are refused
+static fp32 retiredParam = 0.0f;
+
+/**
+  * @brief   左电机增益同步到右电机 | Mirror left motor gains to the right motor
+  */
+static void applyMotorGains(const ParamDef *def) {
+    (void)def;
+    car.motor_r.pid.Kp = car.motor_l.pid.Kp;
+    car.motor_r.pid.Ki = car.motor_l.pid.Ki;
+    car.motor_r.pid.Kd = car.motor_l.pid.Kd;
+    car.motor_r.pid.max_iout = car.motor_l.pid.max_iout;
+}
+
+/**
+  * @brief   更新 TIM9 周期 | Update TIM9 period
+  */
+static void applyLoopPeriod(const ParamDef *def) {
+    (void)def;
+    __HAL_TIM_SET_AUTORELOAD(&htim9, loopPeriodUs - 1);
+}
+
+/**
+  * @brief   零偏立即写入 DMP；IMU 未就绪时由初始化完成时载入 | Write the biases into the DMP now; if the IMU is not ready the init loads them when it completes
+  */
+static void applyImuBias(const ParamDef *def) {
+    (void)def;
+    Imu_ApplyBias(&car.imu);
+}
+
+/* 参数表：编号即下标，名称和编号都是上位机协议的一部分，只在末尾追加；不再使用的参数改为只读占位，不删除
+   Parameter table: the id is the index; names and ids are part of the host protocol, so only append;
+   a parameter that goes out of use becomes a read-only placeholder and is never removed */
+const ParamDef paramTable[] = {
+        /* name            type             flags               storeKey                  min       max       ptr                         OnApply */
+        {"bias",           PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_BALANCE_BIAS,   -10.0f,   10.0f,    &car.control.balanceBias,   NULL},
+        {"motor_kp",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_MOTOR_KP,       0.0f,     5000.0f,  &car.motor_l.pid.Kp,        applyMotorGains},
+        {"motor_ki",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_MOTOR_KI,       0.0f,     500.0f,   &car.motor_l.pid.Ki,        applyMotorGains},
+        {"motor_kd",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_MOTOR_KD,       0.0f,     500.0f,   &car.motor_l.pid.Kd,        applyMotorGains},
+        {"motor_max_iout", PARAM_TYPE_F32,  0,                  0,                        0.0f,     60000.0f, &car.motor_l.pid.max_iout,  applyMotorGains},
+        {"learn_rate",     PARAM_TYPE_F32,  PARAM_FLAG_READONLY, 0,                       0.0f,     0.0f,     &retiredParam,              NULL},  // 已退役 | Retired
+        {"speed_alpha",    PARAM_TYPE_F32,  PARAM_FLAG_READONLY, 0,                       0.0f,     0.0f,     &retiredParam,              NULL},  // 已退役 | Retired
+        {"start_speed",    PARAM_TYPE_I8,   0,                  0,                        0.0f,     100.0f,   &car.targetStartLinearSpeed, NULL},
+        {"loop_us",        PARAM_TYPE_U16,  PARAM_FLAG_PERSIST, PARAM_KEY_LOOP_PERIOD,    1000.0f,  50000.0f, &loopPeriodUs,              applyLoopPeriod},
+        {"telem_ms",       PARAM_TYPE_U8,   PARAM_FLAG_PERSIST, PARAM_KEY_TELEMETRY_PERIOD, 0.0f,   255.0f,   &telemetryPeriodMs,         NULL},
+        {"sensor_log",     PARAM_TYPE_U8,   PARAM_FLAG_PERSIST, PARAM_KEY_SENSOR_LOG,     0.0f,     1.0f,     &sensorLogEnabled,          NULL},
+        {"angle_kp",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_ANGLE_KP,       0.0f,     500.0f,   &car.control.balance.angleKp,   NULL},
+        {"angle_kd",       PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_ANGLE_KD,       0.0f,     50.0f,    &car.control.balance.angleKd,   NULL},
+        {"vel_kp",         PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_VELOCITY_KP,    0.0f,     1.0f,     &car.control.balance.velocity.Kp, NULL},
+        {"vel_ki",         PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_VELOCITY_KI,    0.0f,     0.1f,     &car.control.balance.velocity.Ki, NULL},
+        {"turn_kp",        PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_TURN_KP,        0.0f,     1.0f,     &car.control.balance.turn.Kp,   NULL},
+        {"turn_ki",        PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_TURN_KI,        0.0f,     0.1f,     &car.control.balance.turn.Ki,   NULL},
+        {"turn_kd",        PARAM_TYPE_F32,  PARAM_FLAG_PERSIST, PARAM_KEY_TURN_KD,        0.0f,     1.0f,     &car.control.balance.turn.Kd,   NULL},
+        {"gyro_bias_x",    PARAM_TYPE_I32,  PARAM_FLAG_PERSIST, PARAM_KEY_GYRO_BIAS + 0,  -16777216.0f, 16777216.0f, &car.imu.gyroBias[0], applyImuBias},
+        {"gyro_bias_y",    PARAM_TYPE_I32,  PARAM_FLAG_PERSIST, PARAM_KEY_GYRO_BIAS + 1,  -16777216.0f, 16777216.0f, &car.imu.gyroBias[1], applyImuBias},
+        {"gyro_bias_z",    PARAM_TYPE_I32,  PARAM_FLAG_PERSIST, PARAM_KEY_GYRO_BIAS + 2,  -16777216.0f, 16777216.0f, &car.imu.gyroBias[2], applyImuBias},
+        {"accel_bias_x",   PARAM_TYPE_I32,  PARAM_FLAG_PERSIST, PARAM_KEY_ACCEL_BIAS + 0, -16777216.0f, 16777216.0f, &car.imu.accelBias[0], applyImuBias},
+        {"accel_bias_y",   PARAM_TYPE_I32,  PARAM_FLAG_PERSIST, PARAM_KEY_ACCEL_BIAS + 1, -16777216.0f, 16777216.0f, &car.imu.accelBias[1], applyImuBias},
+        {"accel_bias_z",   PARAM_TYPE_I32,  PARAM_FLAG_PERSIST, PARAM_KEY_ACCEL_BIAS + 2, -16777216.0f, 16777216.0f, &car.imu.accelBias[2], applyImuBias},
+};
+
+const uint8_t paramTableSize = (uint8_t)(sizeof(paramTable) / sizeof(paramTable[0]));
@@ -0,0 +1,140 @@
+#include "protocol.h"
+#include "crc.h"
+#include <string.h>
+
+/**
+  * @brief   COBS 编码 | COBS encode
+  * @param   in   输入数据 | Input
+  * @param   len  输入长度 | Input length
+  * @param   out  输出缓冲区 | Output buffer
+  * @return  编码后长度（不含分隔符） | Encoded length (without delimiter)
+  */
+uint16_t COBS_Encode(const uint8_t *in, uint16_t len, uint8_t *out) {
+    uint16_t write = 1;     // 下一个写入位置 | Next write position
+    uint16_t codeIdx = 0;   // 当前块长度字节位置 | Position of current block code
+    uint8_t code = 1;
+
+    for (uint16_t read = 0; read < len; read++) {
+        if (in[read] == 0) {
+            out[codeIdx] = code;  // 结束当前块 | Close current block
+            code = 1;
+            codeIdx = write++;
+        } else {
+            out[write++] = in[read];
+            if (++code == 0xFF) {  // 块满 254 字节 | Block full (254 bytes)
+                out[codeIdx] = code;
+                code = 1;
+                codeIdx = write++;
+            }
+        }
+    }
+    out[codeIdx] = code;
+    return write;
+}
+
+/**
+  * @brief   COBS 原地解码 | COBS decode in place
+  * @param   buf  编码数据 | Encoded data
+  * @param   len  编码长度 | Encoded length
+  * @return  解码后长度，格式错误返回 -1 | Decoded length, -1 if malformed
+  */
+int16_t COBS_Decode(uint8_t *buf, uint16_t len) {
+    uint16_t read = 0;
+    uint16_t write = 0;
+
+    while (read < len) {
+        uint8_t code = buf[read];
+        if (code == 0 || read + code > len) {
+            return -1;  // 非法块 | Malformed block
+        }
+        read++;
+        for (uint8_t i = 1; i < code; i++) {
+            buf[write++] = buf[read++];
+        }
+        if (code != 0xFF && read < len) {
+            buf[write++] = 0;  // 块尾隐含的 0 | Implicit zero at block end
+        }
+    }
+    return (int16_t)write;
+}
+
+/**
+  * @brief   编码一帧 | Encode a frame
+  * @param   type     消息类型 | Message type
+  * @param   seq      序号 | Sequence number
+  * @param   payload  负载 | Payload
+  * @param   len      负载长度 | Payload length
+  * @param   out      输出缓冲区 | Output buffer
+  * @return  编码后长度（含分隔符） | Encoded length incl. delimiter
+  */
+uint16_t Frame_Encode(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len, uint8_t *out) {
+    uint8_t raw[PROTOCOL_MAX_RAW];
+
+    if (len > PROTOCOL_MAX_PAYLOAD) {
+        return 0;
+    }
+    raw[0] = type;
+    raw[1] = seq;
+    if (len > 0) {
+        memcpy(&raw[2], payload, len);
+    }
+    uint16_t crc = CRC16_Update(CRC16_INIT, raw, (uint32_t)len + 2);
+    raw[len + 2] = (uint8_t)(crc & 0xFF);
+    raw[len + 3] = (uint8_t)(crc >> 8);
+
+    uint16_t n = COBS_Encode(raw, (uint16_t)(len + 4), out);
+    out[n++] = 0x00;  // 帧分隔符 | Frame delimiter
+    return n;
+}
+
+/**
+  * @brief   初始化解析器 | Init parser
+  * @param   self  解析器指针 | Pointer to parser
+  */
+void FrameParser_Init(FrameParser *self) {
+    memset(self, 0, sizeof(*self));
+}
+
+/**
+  * @brief   输入一个字节 | Feed one byte
+  * @param   self   解析器指针 | Pointer to parser
+  * @param   byte   输入字节 | Input byte
+  * @param   frame  输出帧 | Output frame
+  * @return  1 = 收到完整有效帧，0 = 未完成 | 1 = complete valid frame, 0 = not yet
+  */
+uint8_t FrameParser_Feed(FrameParser *self, uint8_t byte, Frame *frame) {
+    if (byte != 0x00) {
+        if (self->len >= sizeof(self->buf)) {
+            self->overflow = 1;  // 丢弃直到下一个分隔符 | Discard until next delimiter
+        } else {
+            self->buf[self->len++] = byte;
+        }
+        return 0;
+    }
+
+    // 收到分隔符 | Delimiter received
+    uint8_t ok = 0;
+    if (self->overflow) {
+        self->overflows++;
+    } else if (self->len > 0) {
+        int16_t n = COBS_Decode(self->buf, self->len);
+        if (n >= 4) {
+            uint16_t crc = (uint16_t)(self->buf[n - 2] | (self->buf[n - 1] << 8));
+            if (CRC16_Update(CRC16_INIT, self->buf, (uint32_t)n - 2) == crc) {
+                frame->type = self->buf[0];
+                frame->seq = self->buf[1];
+                frame->len = (uint8_t)(n - 4);
+                frame->payload = &self->buf[2];
+                self->frames++;
+                ok = 1;
+            }
+        }
+        if (!ok) {
+            self->crcErrors++;
+        }
+    }
+
+    self->len = 0;
+    self->overflow = 0;
+    return ok;
+}
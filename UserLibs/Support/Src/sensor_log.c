@@ -0,0 +1,74 @@
+#include "sensor_log.h"
+#include "communication.h"
+#include "protocol.h"
+#include "car.h"
+#include "spsc_ring.h"
+
+_Static_assert(sizeof(SensorLogRecord) <= PROTOCOL_MAX_PAYLOAD, "sensor log record exceeds the frame payload");
+
+extern Car car;  // 全局小车实例 | Global car instance
+
+uint8_t sensorLogEnabled = 0;  // 开关，可通过参数表修改 | On/off, tunable via the parameter table
+
+/* 带帧序号的记录 | Record tagged with its frame sequence number */
+typedef struct {
+    uint8_t seq;
+    SensorLogRecord rec;
+} SensorLogSample;
+
+SPSC_RING_DEFINE(logRing, SensorLogSample, SENSOR_LOG_QUEUE_SIZE);  // 采样 → 发送 | Sampling → sending
+
+static uint8_t seq = 0;
+static uint32_t lastImuCount = 0;
+static uint8_t pendingCmd[SENSOR_LOG_CMDS];
+static uint8_t pendingCount = 0;
+static bool_t pendingLost = FALSE;
+
+void SensorLog_Command(uint8_t cmd) {
+    if (pendingCount < SENSOR_LOG_CMDS) {
+        pendingCmd[pendingCount++] = cmd;
+    } else {
+        pendingLost = TRUE;
+    }
+}
+
+/**
+  * @brief   采样一条记录 | Sample one record
+  * @note    队列满时丢弃本条，但 seq 仍递增，重放工具通过 seq 间隙发现丢失
+  *          A record is dropped when the queue is full, but seq still advances so the replay tool
+  *          finds the loss from the gap
+  */
+void SensorLog_Capture(void) {
+    const MPU6500_Raw *raw = MPU6500_DMP_Last_Raw();
+    bool_t freshImu = raw->count != lastImuCount;
+    lastImuCount = raw->count;
+
+    if (sensorLogEnabled) {
+        SensorLogSample sample = {0};
+        SensorLogRecord *r = &sample.rec;
+        sample.seq = seq++;
+        r->tick_ms = car.tickMs;
+        r->loop_us = (uint16_t)(__HAL_TIM_GET_AUTORELOAD(&CONTROL_TIM) + 1U);
+        r->enc[0] = car.encoder_l.count;
+        r->enc[1] = car.encoder_r.count;
+        memcpy(r->quat, raw->quat, sizeof(r->quat));
+        memcpy(r->accel, raw->accel, sizeof(r->accel));
+        memcpy(r->gyro, raw->gyro, sizeof(r->gyro));
+        r->range = car.range.distance;
+        r->range_age_ms = car.tickMs - car.range.timestamp;
+        r->flags = (freshImu ? SENSOR_LOG_IMU : 0) | (car.range.valid ? SENSOR_LOG_RANGE_VALID : 0) |
+                   (pendingLost ? SENSOR_LOG_CMD_LOST : 0);
+        r->ncmd = pendingCount;
+        memcpy(r->cmd, pendingCmd, pendingCount);
+        SpscRing_Push(&logRing, &sample);
+    }
+    pendingCount = 0;
+    pendingLost = FALSE;
+}
+
+void SensorLog_Flush(void) {
+    SensorLogSample sample;
+    while (SpscRing_Pop(&logRing, &sample)) {
+        uart_SendFrame(MSG_SENSOR_LOG, sample.seq, (const uint8_t *)&sample.rec, sizeof(sample.rec));
+    }
+}
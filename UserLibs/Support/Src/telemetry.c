@@ -0,0 +1,76 @@
+#include "telemetry.h"
+#include "communication.h"
+#include "protocol.h"
+#include "car.h"
+#include "i2c_bus.h"
+#include "spsc_ring.h"
+
+_Static_assert(sizeof(TelemetryRecord) <= PROTOCOL_MAX_PAYLOAD, "telemetry record exceeds the frame payload");
+
+extern Car car;  // 全局小车实例 | Global car instance
+
+uint8_t telemetryPeriodMs = TELEMETRY_PERIOD_MS;  // 发送周期，可通过参数表修改 | Period, tunable via the parameter table
+
+/* 带帧序号的采样 | Sample tagged with its frame sequence number */
+typedef struct {
+    uint8_t seq;
+    TelemetryRecord rec;
+} TelemetrySample;
+
+SPSC_RING_DEFINE(sampleRing, TelemetrySample, TELEMETRY_QUEUE_SIZE);  // 采样 → 发送 | Sampling → sending
+
+static uint32_t lastTick = 0;
+static uint8_t seq = 0;
+
+/**
+  * @brief   采样一条遥测记录 | Sample one telemetry record
+  * @note    队列满时丢弃本条，但 seq 仍递增，上位机通过 seq 间隙统计丢失
+  *          A record is dropped when the queue is full, but seq still advances so the host
+  *          counts the loss from the gap
+  */
+void Telemetry_Publish(void) {
+    uint32_t now = HAL_GetTick();
+    if (telemetryPeriodMs == 0 || (now - lastTick) < telemetryPeriodMs) {
+        return;
+    }
+    lastTick = now;
+
+    Pose pose;
+    Odometry_GetPose(&car.control.odometry, &pose);
+
+    TelemetrySample sample;
+    TelemetryRecord *r = &sample.rec;
+    sample.seq = seq++;
+    r->tick_ms  = now;
+    r->pitch    = car.imu.pitch;
+    r->roll     = car.imu.roll;
+    r->yaw      = car.imu.yaw;
+    r->gyrox    = car.imu.gyrox;
+    r->gyroy    = car.imu.gyroy;
+    r->gyroz    = car.imu.gyroz;
+    r->out_l    = car.motor_l.pid.out;
+    r->out_r    = car.motor_r.pid.out;
+    r->pose_x   = pose.x;
+    r->pose_y   = pose.y;
+    r->heading  = pose.heading;
+    r->rpm_l    = car.encoder_l.rpm;
+    r->rpm_r    = car.encoder_r.rpm;
+    r->tx_drops = (uint16_t)uart_TxDropped();
+    r->cmd      = car.cmd;
+    r->motion   = car.motionState;
+    r->i2c_err  = (uint16_t)(I2C_Bus_Errors(I2C_CLIENT_IMU) + I2C_Bus_Errors(I2C_CLIENT_OLED));
+    r->i2c_recov = (uint16_t)i2cArbiter.recoveries;
+    r->dmp_load = (uint16_t)MPU6500_DMP_Load_Ms();
+
+    SpscRing_Push(&sampleRing, &sample);
+}
+
+/**
+  * @brief   编码并发送已采样的记录 | Encode and send queued records
+  */
+void Telemetry_Flush(void) {
+    TelemetrySample sample;
+    while (SpscRing_Pop(&sampleRing, &sample)) {
+        uart_SendFrame(MSG_TELEMETRY, sample.seq, (const uint8_t *)&sample.rec, sizeof(sample.rec));
+    }
+}
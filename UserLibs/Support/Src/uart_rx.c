@@ -0,0 +1,80 @@
+#include "uart_rx.h"
+#include <stddef.h>
+
+/**
+  * @brief   创建接收通道 | Create a receive channel
+  */
+UartRx newUartRx(const uint8_t *buf, uint16_t size, void (*OnFrame)(UartRx *self, const Frame *frame)) {
+    UartRx rx = {
+            .buf       = buf,
+            .size      = size,
+            .tail      = 0,
+            .hasCmdSeq = FALSE,
+            .OnFrame   = OnFrame
+    };
+    FrameParser_Init(&rx.parser);
+    return rx;
+}
+
+/**
+  * @brief   解析一段连续字节 | Parse one contiguous span
+  */
+static void parseSpan(UartRx *self, uint16_t from, uint16_t to) {
+    Frame frame;
+    for (uint16_t i = from; i < to; i++) {
+        if (FrameParser_Feed(&self->parser, self->buf[i], &frame) && self->OnFrame != NULL) {
+            self->OnFrame(self, &frame);
+        }
+    }
+    self->stats.rxBytes += (uint32_t)(to - from);
+}
+
+/**
+  * @brief   解析 DMA 新写入的字节 | Parse bytes newly written by DMA
+  */
+void UartRx_Process(UartRx *self, uint16_t head) {
+    if (head >= self->size) {
+        head = 0;  // TC 事件报告的位置等于缓冲区长度 | TC events report the buffer length
+    }
+
+    if (head > self->tail) {
+        parseSpan(self, self->tail, head);
+    } else if (head < self->tail) {
+        parseSpan(self, self->tail, self->size);  // 先到缓冲区末尾，再从头开始 | Up to the end, then wrap
+        parseSpan(self, 0, head);
+    }
+    self->tail = head;
+
+    self->stats.frames = self->parser.frames;
+    self->stats.crcErrors = self->parser.crcErrors;
+    self->stats.overflows = self->parser.overflows;
+}
+
+/**
+  * @brief   DMA 重新启动后复位读位置 | Reset the read position after DMA restarts
+  */
+void UartRx_Restart(UartRx *self) {
+    self->tail = 0;
+    self->parser.len = 0;       // 丢弃半帧，剩余部分在下一个分隔符处按 CRC 错误丢弃 | Drop the partial frame; its tail fails CRC at the next delimiter
+    self->stats.uartErrors++;
+}
+
+/**
+  * @brief   检查命令序号 | Check a command's sequence number
+  */
+bool_t UartRx_AcceptCommand(UartRx *self, const Frame *frame) {
+    if (self->hasCmdSeq) {
+        uint8_t delta = (uint8_t)(frame->seq - self->lastCmdSeq);
+        if (delta == 0) {
+            self->stats.cmdDuplicates++;
+            return FALSE;
+        }
+        // 序号回退视为上位机重启，不计缺口 | A backwards jump means the host restarted; not counted as a gap
+        if (delta < 128) {
+            self->stats.cmdGaps += (uint32_t)(delta - 1);
+        }
+    }
+    self->hasCmdSeq = TRUE;
+    self->lastCmdSeq = frame->seq;
+    return TRUE;
+}
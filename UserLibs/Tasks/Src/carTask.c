@@ -11,7 +11,7 @@ extern Car car;
   * @note    不断获取 IMU 数据并执行小车移动控制 | Continuously get IMU data and execute car movement control
   */
 void StartCarTask(void const *argument) {
-  car.balanceBias = MECHANICAL_BALANCE_BIAS;  // 设置平衡偏置 | Set balance bias
+  car.control.balanceBias = MECHANICAL_BALANCE_BIAS;  // 设置平衡偏置 | Set balance bias
 
   while (1) {
     car.imu.Get_Data(&car.imu);    // 获取IMU数据 | Get IMU data
@@ -2,6 +2,7 @@
 #include "cmsis_os.h"
 #include "car.h"
 #include "calibrate_angle.h"
+#include "hcsr04.h"
 
 extern Car car;  // 全局小车实例 | Global car instance
 